@@ -0,0 +1,65 @@
+// Copyright 2021 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef VK_SWIFTSHADER_METRICS_H_
+#define VK_SWIFTSHADER_METRICS_H_
+
+#include "vulkan_core.h"
+
+// Entry points exported by the SwiftShader Vulkan library, outside of the
+// Vulkan API, for observing where the driver spends its time compiling
+// shaders and how effective its caches are. They are not reachable through
+// vkGetInstanceProcAddr(), so applications must look them up in the library
+// itself (e.g. with dlsym() or GetProcAddress()).
+//
+// Metrics are collected process-wide, once enabled by
+// swiftshaderSetMetricsEnabled() or by setting the SWIFTSHADER_METRICS
+// environment variable. Its value, if a positive number, is the period in
+// seconds at which queue submissions write a report to stderr.
+//
+// A report consists of one "name value" line per metric, e.g.:
+//   cache.pipeline_spirv.hits 12
+//   time.jit_compile.p99_us 2048
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void(VKAPI_PTR *PFN_swiftshaderSetMetricsEnabled)(VkBool32 enabled);
+typedef void(VKAPI_PTR *PFN_swiftshaderResetMetrics)(void);
+typedef size_t(VKAPI_PTR *PFN_swiftshaderGetMetrics)(char *pReport, size_t reportSize);
+typedef uint64_t(VKAPI_PTR *PFN_swiftshaderGetMetric)(const char *pName);
+
+#ifndef VK_NO_PROTOTYPES
+// Starts or stops collecting metrics. Values collected so far are kept.
+VKAPI_ATTR void VKAPI_CALL swiftshaderSetMetricsEnabled(VkBool32 enabled);
+
+// Zeroes all metrics.
+VKAPI_ATTR void VKAPI_CALL swiftshaderResetMetrics(void);
+
+// Writes the report of all metrics into pReport, truncated to reportSize
+// bytes including the null terminator, and returns its untruncated length.
+// pReport may be NULL to query the length.
+VKAPI_ATTR size_t VKAPI_CALL swiftshaderGetMetrics(char *pReport, size_t reportSize);
+
+// Returns the value of a single metric of the report, or 0 if there is no
+// metric of that name or pName is NULL.
+VKAPI_ATTR uint64_t VKAPI_CALL swiftshaderGetMetric(const char *pName);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // VK_SWIFTSHADER_METRICS_H_
@@ -0,0 +1,55 @@
+// Copyright 2021 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef VK_SWIFTSHADER_TRACE_H_
+#define VK_SWIFTSHADER_TRACE_H_
+
+#include "vulkan_core.h"
+
+// Entry points exported by the SwiftShader Vulkan library, outside of the
+// Vulkan API, for recording a timeline of the driver's work: queue
+// submissions, draw calls, the tasks processing them, and shader
+// compilations. They are not reachable through vkGetInstanceProcAddr(), so
+// applications must look them up in the library itself (e.g. with dlsym() or
+// GetProcAddress()).
+//
+// A trace can also be recorded for the whole lifetime of the process by
+// setting the SWIFTSHADER_TRACE environment variable to the path of the
+// trace file.
+//
+// Paths ending with ".pftrace" or ".perfetto-trace" produce a Perfetto
+// protobuf trace, others a Chrome trace event JSON file. Both can be opened
+// with https://ui.perfetto.dev, and the latter with chrome://tracing.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef VkBool32(VKAPI_PTR *PFN_swiftshaderStartTrace)(const char *pPath);
+typedef void(VKAPI_PTR *PFN_swiftshaderStopTrace)(void);
+
+#ifndef VK_NO_PROTOTYPES
+// Starts writing a trace to the file at pPath. Returns VK_FALSE if a trace
+// is already being written or the file can't be created.
+VKAPI_ATTR VkBool32 VKAPI_CALL swiftshaderStartTrace(const char *pPath);
+
+// Writes the remaining events and closes the trace file.
+VKAPI_ATTR void VKAPI_CALL swiftshaderStopTrace(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // VK_SWIFTSHADER_TRACE_H_
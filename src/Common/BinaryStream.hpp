@@ -0,0 +1,126 @@
+// Copyright 2021 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef sw_BinaryStream_hpp
+#define sw_BinaryStream_hpp
+
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace sw
+{
+	// Serializes values into a growing byte array, in the host's layout.
+	class BinaryOutputStream
+	{
+	public:
+		template<class T>
+		void write(const T &value)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable values can be written as raw bytes");
+
+			const unsigned char *bytes = reinterpret_cast<const unsigned char*>(&value);
+			data.insert(data.end(), bytes, bytes + sizeof(T));
+		}
+
+		void write(const std::string &string)
+		{
+			write<uint32_t>(static_cast<uint32_t>(string.size()));
+			data.insert(data.end(), string.begin(), string.end());
+		}
+
+		const std::vector<unsigned char> &getData() const { return data; }
+
+	private:
+		std::vector<unsigned char> data;
+	};
+
+	// Deserializes values written by a BinaryOutputStream. Reading past the
+	// end of the data returns zero values and flags the stream as failed.
+	class BinaryInputStream
+	{
+	public:
+		BinaryInputStream(const void *data, size_t size) : data(static_cast<const unsigned char*>(data)), size(size), offset(0), failed(false)
+		{
+		}
+
+		template<class T>
+		void read(T &value)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable values can be read as raw bytes");
+
+			if(size - offset >= sizeof(T))
+			{
+				memcpy(&value, data + offset, sizeof(T));
+				offset += sizeof(T);
+			}
+			else
+			{
+				value = T();
+				failed = true;
+			}
+		}
+
+		// Arrays are read element by element, so that each is value-initialized on failure.
+		template<class T, size_t N>
+		void read(T (&array)[N])
+		{
+			for(T &element : array)
+			{
+				read(element);
+			}
+		}
+
+		template<class T>
+		T read()
+		{
+			T value;
+			read(value);
+
+			return value;
+		}
+
+		std::string readString()
+		{
+			size_t length = read<uint32_t>();
+
+			if(size - offset < length)
+			{
+				failed = true;
+				return std::string();
+			}
+
+			std::string string(reinterpret_cast<const char*>(data + offset), length);
+			offset += length;
+
+			return string;
+		}
+
+		// Flags the stream as failed, for values which were read but are invalid.
+		void fail() { failed = true; }
+
+		bool error() const { return failed; }
+		bool endOfStream() const { return offset == size; }
+
+	private:
+		const unsigned char *const data;
+		const size_t size;
+		size_t offset;
+		bool failed;
+	};
+}
+
+#endif   // sw_BinaryStream_hpp
@@ -20,6 +20,7 @@
 #include "System/Debug.hpp"
 #include "System/Half.hpp"
 #include "System/Memory.hpp"
+#include "System/Metrics.hpp"
 #include "Vulkan/VkBuffer.hpp"
 #include "Vulkan/VkImage.hpp"
 #include "Vulkan/VkImageView.hpp"
@@ -1811,8 +1812,16 @@ Blitter::BlitRoutineType Blitter::getBlitRoutine(const State &state)
 
 	if(!blitRoutine)
 	{
+		Metrics::count(Metrics::BlitRoutineCache, Metrics::CacheMiss);
 		blitRoutine = generate(state);
-		blitCache.add(state, blitRoutine);
+		if(blitCache.add(state, blitRoutine))
+		{
+			Metrics::count(Metrics::BlitRoutineCache, Metrics::CacheEviction);
+		}
+	}
+	else
+	{
+		Metrics::count(Metrics::BlitRoutineCache, Metrics::CacheHit);
 	}
 
 	return blitRoutine;
@@ -2093,12 +2102,13 @@ static inline uint32_t averageByte4(uint32_t x, uint32_t y)
 
 bool Blitter::fastResolve(const vk::Image *src, vk::Image *dst, VkImageResolve2KHR region)
 {
-	if(region.dstOffset != VkOffset3D{ 0, 0, 0 })
+	// Full rows of the image can be resolved, such as the bands of a tiled render pass.
+	if(region.dstOffset != region.srcOffset)
 	{
 		return false;
 	}
 
-	if(region.srcOffset != VkOffset3D{ 0, 0, 0 })
+	if(region.srcOffset.x != 0 || region.srcOffset.z != 0)
 	{
 		return false;
 	}
@@ -2108,9 +2118,14 @@ bool Blitter::fastResolve(const vk::Image *src, vk::Image *dst, VkImageResolve2K
 		return false;
 	}
 
-	if(region.extent != src->getExtent() ||
-	   region.extent != dst->getExtent() ||
-	   region.extent.depth != 1)
+	auto extent = src->getExtent();
+
+	if(extent != dst->getExtent() ||
+	   region.extent.width != extent.width ||
+	   region.srcOffset.y < 0 ||
+	   region.srcOffset.y + region.extent.height > extent.height ||
+	   region.extent.depth != 1 ||
+	   extent.depth != 1)
 	{
 		return false;
 	}
@@ -2135,15 +2150,14 @@ bool Blitter::fastResolve(const vk::Image *src, vk::Image *dst, VkImageResolve2K
 		region.dstSubresource.layerCount
 	};
 
-	void *source = src->getTexelPointer({ 0, 0, 0 }, srcSubresource);
-	uint8_t *dest = reinterpret_cast<uint8_t *>(dst->getTexelPointer({ 0, 0, 0 }, dstSubresource));
+	void *source = src->getTexelPointer(region.srcOffset, srcSubresource);
+	uint8_t *dest = reinterpret_cast<uint8_t *>(dst->getTexelPointer(region.dstOffset, dstSubresource));
 
 	auto format = src->getFormat();
 	auto samples = src->getSampleCountFlagBits();
-	auto extent = src->getExtent();
 
 	int width = extent.width;
-	int height = extent.height;
+	int height = region.extent.height;
 	int pitch = src->rowPitchBytes(VK_IMAGE_ASPECT_COLOR_BIT, region.srcSubresource.mipLevel);
 	int slice = src->slicePitchBytes(VK_IMAGE_ASPECT_COLOR_BIT, region.srcSubresource.mipLevel);
 
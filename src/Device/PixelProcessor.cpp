@@ -18,6 +18,7 @@
 #include "Pipeline/Constants.hpp"
 #include "Pipeline/PixelProgram.hpp"
 #include "System/Debug.hpp"
+#include "System/Metrics.hpp"
 #include "Vulkan/VkImageView.hpp"
 #include "Vulkan/VkPipelineLayout.hpp"
 
@@ -48,11 +49,6 @@ bool PixelProcessor::State::operator==(const State &state) const
 	return *static_cast<const States *>(this) == static_cast<const States &>(state);
 }
 
-PixelProcessor::PixelProcessor()
-{
-	setRoutineCacheSize(1024);
-}
-
 void PixelProcessor::setBlendConstant(const float4 &blendConstant)
 {
 	for(int i = 0; i < 4; i++)
@@ -66,12 +62,12 @@ void PixelProcessor::setBlendConstant(const float4 &blendConstant)
 	}
 }
 
-void PixelProcessor::setRoutineCacheSize(int cacheSize)
+void PixelProcessor::setRoutineCache(RoutineCacheType *cache)
 {
-	routineCache = std::make_unique<RoutineCacheType>(clamp(cacheSize, 1, 65536));
+	routineCache = cache;
 }
 
-const PixelProcessor::State PixelProcessor::update(const vk::GraphicsState &pipelineState, const sw::SpirvShader *fragmentShader, const sw::SpirvShader *vertexShader, const vk::Attachments &attachments, bool occlusionEnabled) const
+const PixelProcessor::State PixelProcessor::update(const vk::GraphicsState &pipelineState, const sw::SpirvShader *fragmentShader, const sw::SpirvShader *vertexShader, const vk::Attachments &attachments, bool occlusionEnabled, bool pipelineStatisticsEnabled) const
 {
 	State state;
 
@@ -130,6 +126,7 @@ const PixelProcessor::State PixelProcessor::update(const vk::GraphicsState &pipe
 	}
 
 	state.occlusionEnabled = occlusionEnabled;
+	state.pipelineStatisticsEnabled = pipelineStatisticsEnabled && (fragmentShader != nullptr);
 
 	bool fragmentContainsKill = (fragmentShader && fragmentShader->getAnalysis().ContainsKill);
 	for(int i = 0; i < MAX_COLOR_BUFFERS; i++)
@@ -181,19 +178,17 @@ PixelProcessor::RoutineType PixelProcessor::routine(const State &state,
                                                     const SpirvShader *pixelShader,
                                                     const vk::DescriptorSet::Bindings &descriptorSets)
 {
-	auto routine = routineCache->lookup(state);
-
-	if(!routine)
-	{
+	return routineCache->getOrCreate(state, [&]() -> RoutineType {
 		QuadRasterizer *generator = new PixelProgram(state, pipelineLayout, pixelShader, descriptorSets);
-		generator->generate();
-		routine = (*generator)("PixelRoutine_%0.8X", state.shaderID);
+		{
+			Metrics::ScopedTimer timer(Metrics::ShaderEmitTime);
+			generator->generate();
+		}
+		auto routine = (*generator)("PixelRoutine_%0.8X", state.shaderID);
 		delete generator;
 
-		routineCache->add(state, routine);
-	}
-
-	return routine;
+		return routine;
+	});
 }
 
 }  // namespace sw
@@ -79,6 +79,7 @@ public:
 		bool depthTestActive;
 		bool depthBoundsTestActive;
 		bool occlusionEnabled;
+		bool pipelineStatisticsEnabled;
 		bool perspective;
 
 		vk::BlendState blendState[MAX_COLOR_BUFFERS];
@@ -155,21 +156,20 @@ public:
 public:
 	using RoutineType = RasterizerFunction::RoutineType;
 
-	PixelProcessor();
-
 	void setBlendConstant(const float4 &blendConstant);
 
-	const State update(const vk::GraphicsState &pipelineState, const sw::SpirvShader *fragmentShader, const sw::SpirvShader *vertexShader, const vk::Attachments &attachments, bool occlusionEnabled) const;
+	const State update(const vk::GraphicsState &pipelineState, const sw::SpirvShader *fragmentShader, const sw::SpirvShader *vertexShader, const vk::Attachments &attachments, bool occlusionEnabled, bool pipelineStatisticsEnabled) const;
 	RoutineType routine(const State &state, const vk::PipelineLayout *pipelineLayout,
 	                    const SpirvShader *pixelShader, const vk::DescriptorSet::Bindings &descriptorSets);
-	void setRoutineCacheSize(int routineCacheSize);
+
+	using RoutineCacheType = SharedRoutineCache<State, RasterizerFunction::CFunctionType>;
+	void setRoutineCache(RoutineCacheType *cache);
 
 	// Other semi-constants
 	Factor factor;
 
 private:
-	using RoutineCacheType = RoutineCache<State, RasterizerFunction::CFunctionType>;
-	std::unique_ptr<RoutineCacheType> routineCache;
+	RoutineCacheType *routineCache = nullptr;
 };
 
 }  // namespace sw
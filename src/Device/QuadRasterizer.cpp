@@ -37,6 +37,7 @@ void QuadRasterizer::generate()
 {
 	constants = device + OFFSET(vk::Device, constants);
 	occlusion = 0;
+	fragmentInvocations = 0;
 
 	Do
 	{
@@ -65,6 +66,13 @@ void QuadRasterizer::generate()
 		*Pointer<UInt>(data + OFFSET(DrawData, occlusion) + 4 * cluster) = clusterOcclusion;
 	}
 
+	if(state.pipelineStatisticsEnabled)
+	{
+		UInt clusterInvocations = *Pointer<UInt>(data + OFFSET(DrawData, fragmentInvocations) + 4 * cluster);
+		clusterInvocations += fragmentInvocations;
+		*Pointer<UInt>(data + OFFSET(DrawData, fragmentInvocations) + 4 * cluster) = clusterInvocations;
+	}
+
 	Return();
 }
 
@@ -41,6 +41,7 @@ protected:
 	Float4 DcullDistance[MAX_CULL_DISTANCES];
 
 	UInt occlusion;
+	UInt fragmentInvocations;
 
 	virtual void quad(Pointer<Byte> cBuffer[4], Pointer<Byte> &zBuffer, Pointer<Byte> &sBuffer, Int cMask[4], Int &x, Int &y) = 0;
 
@@ -25,18 +25,21 @@
 #include "System/Half.hpp"
 #include "System/Math.hpp"
 #include "System/Memory.hpp"
+#include "System/Metrics.hpp"
 #include "System/Timer.hpp"
+#include "System/Trace.hpp"
 #include "Vulkan/VkConfig.hpp"
 #include "Vulkan/VkDescriptorSet.hpp"
 #include "Vulkan/VkDevice.hpp"
 #include "Vulkan/VkFence.hpp"
+#include "Vulkan/VkFramebuffer.hpp"
 #include "Vulkan/VkImageView.hpp"
 #include "Vulkan/VkPipelineLayout.hpp"
 #include "Vulkan/VkQueryPool.hpp"
+#include "Vulkan/VkRenderPass.hpp"
 
 #include "marl/containers.h"
 #include "marl/defer.h"
-#include "marl/trace.h"
 
 #undef max
 
@@ -155,12 +158,32 @@ DrawCall::~DrawCall()
 	sw::freeMemory(data);
 }
 
+TileBin::TileBin()
+    : triangles(new Triangle[MaxTiledPrimitiveCount])
+{
+}
+
+DrawRoutineCaches::DrawRoutineCaches(size_t cacheSize)
+    : vertex(cacheSize, Metrics::VertexRoutineCache)
+    , setup(cacheSize, Metrics::SetupRoutineCache)
+    , cull(cacheSize, Metrics::CullRoutineCache)
+    , pixel(cacheSize, Metrics::PixelRoutineCache)
+{
+}
+
 Renderer::Renderer(vk::Device *device)
     : device(device)
 {
-	vertexProcessor.setRoutineCacheSize(1024);
-	pixelProcessor.setRoutineCacheSize(1024);
-	setupProcessor.setRoutineCacheSize(1024);
+	DrawRoutineCaches *routineCaches = device->getDrawRoutineCaches();
+	vertexProcessor.setRoutineCache(&routineCaches->vertex);
+	pixelProcessor.setRoutineCache(&routineCaches->pixel);
+	setupProcessor.setRoutineCaches(&routineCaches->setup, &routineCaches->cull);
+
+	const char *tiledRendering = getenv("SWIFTSHADER_TILED_RENDERING");
+	if(tiledRendering && (atoi(tiledRendering) != 0))
+	{
+		tiling = std::make_unique<Tiling>();
+	}
 }
 
 Renderer::~Renderer()
@@ -187,23 +210,21 @@ void Renderer::draw(const vk::GraphicsPipeline *pipeline, const vk::DynamicState
 	if(count == 0) { return; }
 
 	auto id = nextDrawID++;
-	MARL_SCOPED_EVENT("draw %d", id);
-
-	marl::Pool<sw::DrawCall>::Loan draw;
-	{
-		MARL_SCOPED_EVENT("drawCallPool.borrow()");
-		draw = drawCallPool.borrow();
-	}
-	draw->id = id;
+	SW_SCOPED_EVENT("draw %d", id);
+	Metrics::add(Metrics::Draws);
 
 	const vk::GraphicsState &pipelineState = pipeline->getState(dynamicState);
 	pixelProcessor.setBlendConstant(pipelineState.getBlendConstants());
 
 	const vk::Inputs &inputs = pipeline->getInputs();
 
-	if(update)
+	// Draws of a multi-draw job after the first one reuse its routines and
+	// prepared descriptor sets.
+	const bool firstDraw = !multiDraw.active || !multiDraw.started;
+
+	if(update && firstDraw)
 	{
-		MARL_SCOPED_EVENT("update");
+		SW_SCOPED_EVENT("update");
 
 		const sw::SpirvShader *fragmentShader = pipeline->getShader(VK_SHADER_STAGE_FRAGMENT_BIT).get();
 		const sw::SpirvShader *vertexShader = pipeline->getShader(VK_SHADER_STAGE_VERTEX_BIT).get();
@@ -212,13 +233,38 @@ void Renderer::draw(const vk::GraphicsPipeline *pipeline, const vk::DynamicState
 
 		vertexState = vertexProcessor.update(pipelineState, vertexShader, inputs);
 		setupState = setupProcessor.update(pipelineState, fragmentShader, vertexShader, attachments);
-		pixelState = pixelProcessor.update(pipelineState, fragmentShader, vertexShader, attachments, hasOcclusionQuery());
+		pixelState = pixelProcessor.update(pipelineState, fragmentShader, vertexShader, attachments, hasOcclusionQuery(), hasPipelineStatisticsQuery());
 
 		vertexRoutine = vertexProcessor.routine(vertexState, pipelineState.getPipelineLayout(), vertexShader, inputs.getDescriptorSets());
 		setupRoutine = setupProcessor.routine(setupState);
+		cullRoutine = setupState.isDrawTriangle ? setupProcessor.cullRoutine(setupState) : SetupProcessor::CullRoutineType();
 		pixelRoutine = pixelProcessor.routine(pixelState, pipelineState.getPipelineLayout(), fragmentShader, inputs.getDescriptorSets());
 	}
 
+	// Draws of a tiled subpass are binned, unless a query needs their results
+	// or they don't fit in a bin. Those are rendered immediately instead, after
+	// the draws binned before them.
+	bool binned = false;
+	if(tiling && tiling->framebuffer)
+	{
+		binned = !hasOcclusionQuery() && !hasPipelineStatisticsQuery() && !setupState.rasterizerDiscard &&
+		         (count <= MaxTiledPrimitiveCount);
+
+		if(tiling->binned && (!binned ||
+		                      (tiling->bin->draws.size() == MaxTiledDrawCount) ||
+		                      (tiling->bin->numTriangles + count > MaxTiledPrimitiveCount)))
+		{
+			flushTiles(false);
+		}
+	}
+
+	marl::Pool<sw::DrawCall>::Loan draw;
+	{
+		SW_SCOPED_EVENT("drawCallPool.borrow()");
+		draw = binned ? tiling->drawCallPool.borrow() : drawCallPool.borrow();
+	}
+	draw->id = id;
+
 	draw->containsImageWrite = pipeline->containsImageWrite();
 
 	DrawCall::SetupFunction setupPrimitives = nullptr;
@@ -256,6 +302,9 @@ void Renderer::draw(const vk::GraphicsPipeline *pipeline, const vk::DynamicState
 
 	DrawData *data = draw->data;
 	draw->occlusionQuery = occlusionQuery;
+	draw->pipelineStatisticsQuery = pipelineStatisticsQuery;
+	draw->vertexInvocations = 0;
+	draw->clippingPrimitives = 0;
 	draw->batchDataPool = &batchDataPool;
 	draw->numPrimitives = count;
 	draw->numPrimitivesPerBatch = numPrimitivesPerBatch;
@@ -270,6 +319,7 @@ void Renderer::draw(const vk::GraphicsPipeline *pipeline, const vk::DynamicState
 
 	draw->vertexRoutine = vertexRoutine;
 	draw->setupRoutine = setupRoutine;
+	draw->cullRoutine = cullRoutine;
 	draw->pixelRoutine = pixelRoutine;
 	draw->setupPrimitives = setupPrimitives;
 	draw->setupState = setupState;
@@ -330,6 +380,14 @@ void Renderer::draw(const vk::GraphicsPipeline *pipeline, const vk::DynamicState
 		}
 	}
 
+	if(pipelineStatisticsQuery != nullptr)
+	{
+		for(int cluster = 0; cluster < MaxClusterCount; cluster++)
+		{
+			data->fragmentInvocations[cluster] = 0;
+		}
+	}
+
 	// Viewport
 	{
 		const VkViewport &viewport = pipelineState.getViewport();
@@ -426,9 +484,52 @@ void Renderer::draw(const vk::GraphicsPipeline *pipeline, const vk::DynamicState
 
 	draw->events = events;
 
-	vk::DescriptorSet::PrepareForSampling(draw->descriptorSetObjects, draw->pipelineLayout, device);
+	// The draw's lifetime, from here until its teardown, spans the tasks
+	// processing its batches and clusters.
+	Trace::beginAsync("draw", id);
+
+	if(firstDraw)
+	{
+		vk::DescriptorSet::PrepareForSampling(draw->descriptorSetObjects, draw->pipelineLayout, device);
+		multiDraw.started = multiDraw.active;
+	}
+
+	if(binned)
+	{
+		if(!tiling->binned)
+		{
+			tiling->bin = tiling->binPool.borrow();
+			tiling->bin->width = tiling->framebuffer->getExtent().width;
+			tiling->bin->height = tiling->framebuffer->getExtent().height;
+			tiling->binned = true;
+		}
+
+		DrawCall::bin(device, draw, tiling->bin.get());
+		return;
+	}
+
+	if(multiDraw.active && !multiDraw.ticket)
+	{
+		auto ticket = drawTickets.take();
+		multiDraw.ticket = marl::make_shared_finally([ticket] { ticket.done(); });
+	}
+
+	DrawCall::run(device, draw, &drawTickets, clusterQueues, multiDraw.ticket);
+}
+
+void Renderer::beginMultiDraw()
+{
+	ASSERT(!multiDraw.active);
+	multiDraw.active = true;
+}
+
+void Renderer::endMultiDraw()
+{
+	ASSERT(multiDraw.active);
 
-	DrawCall::run(device, draw, &drawTickets, clusterQueues);
+	// Releasing the job's reference to its ticket lets it complete once all
+	// of its draws have finished.
+	multiDraw = {};
 }
 
 void DrawCall::setup()
@@ -438,6 +539,11 @@ void DrawCall::setup()
 		occlusionQuery->start();
 	}
 
+	if(pipelineStatisticsQuery != nullptr)
+	{
+		pipelineStatisticsQuery->start();
+	}
+
 	if(events)
 	{
 		events->add();
@@ -461,8 +567,26 @@ void DrawCall::teardown(vk::Device *device)
 		occlusionQuery->finish();
 	}
 
+	if(pipelineStatisticsQuery != nullptr)
+	{
+		uint64_t fragmentShaderInvocations = 0;
+		for(int cluster = 0; cluster < MaxClusterCount; cluster++)
+		{
+			fragmentShaderInvocations += data->fragmentInvocations[cluster];
+		}
+
+		pipelineStatisticsQuery->addStatistic(VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT, inputAssemblyVertices());
+		pipelineStatisticsQuery->addStatistic(VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT, numPrimitives);
+		pipelineStatisticsQuery->addStatistic(VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT, vertexInvocations);
+		pipelineStatisticsQuery->addStatistic(VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT, numPrimitives);
+		pipelineStatisticsQuery->addStatistic(VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT, clippingPrimitives);
+		pipelineStatisticsQuery->addStatistic(VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT, fragmentShaderInvocations);
+		pipelineStatisticsQuery->finish();
+	}
+
 	vertexRoutine = {};
 	setupRoutine = {};
+	cullRoutine = {};
 	pixelRoutine = {};
 
 	for(auto *target : colorBuffer)
@@ -477,9 +601,33 @@ void DrawCall::teardown(vk::Device *device)
 	{
 		vk::DescriptorSet::ContentsChanged(descriptorSetObjects, pipelineLayout, device);
 	}
+
+	Trace::endAsync("draw", id);
 }
 
-void DrawCall::run(vk::Device *device, const marl::Loan<DrawCall> &draw, marl::Ticket::Queue *tickets, marl::Ticket::Queue clusterQueues[MaxClusterCount])
+uint64_t DrawCall::inputAssemblyVertices() const
+{
+	switch(topology)
+	{
+	case VK_PRIMITIVE_TOPOLOGY_POINT_LIST:
+		return numPrimitives;
+	case VK_PRIMITIVE_TOPOLOGY_LINE_LIST:
+		return 2 * numPrimitives;
+	case VK_PRIMITIVE_TOPOLOGY_LINE_STRIP:
+		return numPrimitives + 1;
+	case VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST:
+		return 3 * numPrimitives;
+	case VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP:
+	case VK_PRIMITIVE_TOPOLOGY_TRIANGLE_FAN:
+		return numPrimitives + 2;
+	default:
+		UNSUPPORTED("VkPrimitiveTopology %d", int(topology));
+		return 0;
+	}
+}
+
+void DrawCall::run(vk::Device *device, const marl::Loan<DrawCall> &draw, marl::Ticket::Queue *tickets, marl::Ticket::Queue clusterQueues[MaxClusterCount],
+                   const std::shared_ptr<marl::Finally> &multiDraw)
 {
 	draw->setup();
 
@@ -487,12 +635,25 @@ void DrawCall::run(vk::Device *device, const marl::Loan<DrawCall> &draw, marl::T
 	auto const numPrimitivesPerBatch = draw->numPrimitivesPerBatch;
 	auto const numBatches = draw->numBatches;
 
-	auto ticket = tickets->take();
-	auto finally = marl::make_shared_finally([device, draw, ticket] {
-		MARL_SCOPED_EVENT("FINISH draw %d", draw->id);
-		draw->teardown(device);
-		ticket.done();
-	});
+	std::shared_ptr<marl::Finally> finally;
+	if(multiDraw)
+	{
+		// The draw ticket is owned by the multi-draw job, and is done once the
+		// last of its draws releases its reference.
+		finally = marl::make_shared_finally([device, draw, multiDraw] {
+			SW_SCOPED_EVENT("FINISH draw %d", draw->id);
+			draw->teardown(device);
+		});
+	}
+	else
+	{
+		auto ticket = tickets->take();
+		finally = marl::make_shared_finally([device, draw, ticket] {
+			SW_SCOPED_EVENT("FINISH draw %d", draw->id);
+			draw->teardown(device);
+			ticket.done();
+		});
+	}
 
 	for(unsigned int batchId = 0; batchId < numBatches; batchId++)
 	{
@@ -530,11 +691,12 @@ void DrawCall::run(vk::Device *device, const marl::Loan<DrawCall> &draw, marl::T
 
 void DrawCall::processVertices(vk::Device *device, DrawCall *draw, BatchData *batch)
 {
-	MARL_SCOPED_EVENT("VERTEX draw %d, batch %d", draw->id, batch->id);
+	SW_SCOPED_EVENT("VERTEX draw %d, batch %d", draw->id, batch->id);
+	Metrics::ScopedTimer timer(Metrics::VertexTaskTime);
 
 	unsigned int triangleIndices[MaxBatchSize + 1][3];  // One extra for SIMD width overrun. TODO: Adjust to dynamic batch size.
 	{
-		MARL_SCOPED_EVENT("processPrimitiveVertices");
+		SW_SCOPED_EVENT("processPrimitiveVertices");
 		processPrimitiveVertices(
 		    triangleIndices,
 		    draw->data->indices,
@@ -547,6 +709,8 @@ void DrawCall::processVertices(vk::Device *device, DrawCall *draw, BatchData *ba
 
 	auto &vertexTask = batch->vertexTask;
 	vertexTask.primitiveStart = batch->firstPrimitive;
+	vertexTask.invocations = 0;
+	vertexTask.simdGroups = 0;
 	// We're only using batch compaction for points, not lines
 	vertexTask.vertexCount = batch->numPrimitives * ((draw->topology == VK_PRIMITIVE_TOPOLOGY_POINT_LIST) ? 1 : 3);
 	if(vertexTask.vertexCache.drawCall != draw->id)
@@ -556,14 +720,28 @@ void DrawCall::processVertices(vk::Device *device, DrawCall *draw, BatchData *ba
 	}
 
 	draw->vertexRoutine(device, &batch->triangles.front().v0, &triangleIndices[0][0], &vertexTask, draw->data);
+
+	Metrics::add(Metrics::VertexInvocations, vertexTask.invocations);
+	Metrics::add(Metrics::VertexSimdGroups, vertexTask.simdGroups);
+
+	if(draw->pipelineStatisticsQuery != nullptr)
+	{
+		draw->vertexInvocations.fetch_add(vertexTask.invocations, std::memory_order_relaxed);
+	}
 }
 
 void DrawCall::processPrimitives(vk::Device *device, DrawCall *draw, BatchData *batch)
 {
-	MARL_SCOPED_EVENT("PRIMITIVES draw %d batch %d", draw->id, batch->id);
+	SW_SCOPED_EVENT("PRIMITIVES draw %d batch %d", draw->id, batch->id);
+	Metrics::ScopedTimer timer(Metrics::SetupTaskTime);
 	auto triangles = &batch->triangles[0];
 	auto primitives = &batch->primitives[0];
-	batch->numVisible = draw->setupPrimitives(device, triangles, primitives, draw, batch->numPrimitives);
+	batch->numVisible = draw->setupPrimitives(device, triangles, primitives, draw, draw->data, batch->numPrimitives);
+
+	if(draw->pipelineStatisticsQuery != nullptr)
+	{
+		draw->clippingPrimitives.fetch_add(batch->numVisible, std::memory_order_relaxed);
+	}
 }
 
 void DrawCall::processPixels(vk::Device *device, const marl::Loan<DrawCall> &draw, const marl::Loan<BatchData> &batch, const std::shared_ptr<marl::Finally> &finally)
@@ -585,22 +763,309 @@ void DrawCall::processPixels(vk::Device *device, const marl::Loan<DrawCall> &dra
 		batch->clusterTickets[cluster].onCall([device, data, cluster] {
 			auto &draw = data->draw;
 			auto &batch = data->batch;
-			MARL_SCOPED_EVENT("PIXEL draw %d, batch %d, cluster %d", draw->id, batch->id, cluster);
-			draw->pixelRoutine(device, &batch->primitives.front(), batch->numVisible, cluster, MaxClusterCount, draw->data);
+			SW_SCOPED_EVENT("PIXEL draw %d, batch %d, cluster %d", draw->id, batch->id, cluster);
+			{
+				Metrics::ScopedTimer timer(Metrics::PixelTaskTime);
+				draw->pixelRoutine(device, &batch->primitives.front(), batch->numVisible, cluster, MaxClusterCount, draw->data);
+			}
 			batch->clusterTickets[cluster].done();
 		});
 	}
 }
 
+void DrawCall::bin(vk::Device *device, const marl::Loan<DrawCall> &draw, TileBin *tileBin)
+{
+	draw->setup();
+
+	draw->binnedTriangles = &tileBin->triangles[tileBin->numTriangles];
+	draw->batchRows.resize(draw->numBatches);
+	tileBin->numTriangles += draw->numPrimitives;
+	tileBin->draws.push_back(draw);
+
+	auto const numPrimitives = draw->numPrimitives;
+	auto const numPrimitivesPerBatch = draw->numPrimitivesPerBatch;
+	auto const numBatches = draw->numBatches;
+
+	for(unsigned int batchId = 0; batchId < numBatches; batchId++)
+	{
+		auto batch = draw->batchDataPool->borrow();
+		batch->id = batchId;
+		batch->firstPrimitive = batch->id * numPrimitivesPerBatch;
+		batch->numPrimitives = std::min(batch->firstPrimitive + numPrimitivesPerBatch, numPrimitives) - batch->firstPrimitive;
+
+		tileBin->vertexProcessing.add();
+		marl::schedule([device, draw, batch, vertexProcessing = tileBin->vertexProcessing] {
+			processVertices(device, draw.get(), batch.get());
+			binPrimitives(draw.get(), batch.get());
+			vertexProcessing.done();
+		});
+	}
+}
+
+void DrawCall::binPrimitives(DrawCall *draw, BatchData *batch)
+{
+	SW_SCOPED_EVENT("BIN draw %d, batch %d", draw->id, batch->id);
+
+	const Triangle *triangles = &batch->triangles[0];
+	std::copy(triangles, triangles + batch->numPrimitives, draw->binnedTriangles + batch->firstPrimitive);
+
+	// The rows covered by solid triangles which don't need clipping follow from
+	// their projected vertices. Other primitives conservatively cover all rows.
+	RowRange &rows = draw->batchRows[batch->id];
+	rows = { 0, OUTLINE_RESOLUTION };
+
+	if(draw->setupPrimitives == &DrawCall::setupSolidTriangles)
+	{
+		constexpr int subPixB = vk::SUBPIXEL_PRECISION_BITS;
+		int yMin = OUTLINE_RESOLUTION;
+		int yMax = 0;
+
+		for(unsigned int i = 0; i < batch->numPrimitives; i++)
+		{
+			const Vertex *v = &triangles[i].v0;
+
+			if((v[0].clipFlags & v[1].clipFlags & v[2].clipFlags) != Clipper::CLIP_FINITE)
+			{
+				continue;  // Culled
+			}
+
+			if((v[0].clipFlags | v[1].clipFlags | v[2].clipFlags) != Clipper::CLIP_FINITE)
+			{
+				return;  // Clipped
+			}
+
+			for(int j = 0; j < 3; j++)
+			{
+				yMin = std::min(yMin, (v[j].projected.y >> subPixB) - 1);
+				yMax = std::max(yMax, (v[j].projected.y >> subPixB) + 2);
+			}
+		}
+
+		rows = { yMin, yMax };
+	}
+}
+
+void DrawCall::processTiles(vk::Device *device, TileBin *tileBin)
+{
+	SW_SCOPED_EVENT("TILES draws %d", int(tileBin->draws.size()));
+
+	tileBin->vertexProcessing.wait();
+
+	for(auto &ticket : tileBin->clusterTickets)
+	{
+		ticket.wait();
+	}
+
+	// Bands are as tall as fit the attachment rows in cache, but the
+	// framebuffer is split into at least as many bands as there are clusters
+	// to keep all of them busy.
+	int rowBytes = 0;
+	for(auto &draw : tileBin->draws)
+	{
+		int samples = draw->setupState.multiSampleCount;
+		int drawRowBytes = 0;
+
+		for(int index = 0; index < MAX_COLOR_BUFFERS; index++)
+		{
+			if(draw->colorBuffer[index])
+			{
+				drawRowBytes += draw->data->colorPitchB[index] * samples;
+			}
+		}
+
+		if(draw->depthBuffer)
+		{
+			drawRowBytes += draw->data->depthPitchB * samples;
+		}
+
+		if(draw->stencilBuffer)
+		{
+			drawRowBytes += draw->data->stencilPitchB * samples;
+		}
+
+		rowBytes = std::max(rowBytes, drawRowBytes);
+	}
+
+	const int height = tileBin->height;
+	int bandHeight = std::min(TileCacheSize / std::max(rowBytes, 1), (height + MaxClusterCount - 1) / MaxClusterCount);
+	bandHeight = std::max(bandHeight & ~1, 2);  // Quads span two rows
+
+	const int bandCount = (height + bandHeight - 1) / bandHeight;
+	const int taskCount = std::min(bandCount, MaxClusterCount);
+
+	marl::WaitGroup tasks(taskCount);
+	for(int task = 0; task < taskCount; task++)
+	{
+		marl::schedule([device, tileBin, task, taskCount, bandCount, bandHeight, height, tasks] {
+			auto &scratch = tileBin->scratch[task];
+			if(!scratch)
+			{
+				scratch = std::make_unique<TileBin::Scratch>();
+			}
+
+			for(int band = task; band < bandCount; band += taskCount)
+			{
+				int y0 = band * bandHeight;
+				int y1 = std::min(y0 + bandHeight, height);
+
+				processBand(device, tileBin, y0, y1, scratch->primitives, &scratch->data);
+
+				// Resolving the band while its rows are still in cache avoids
+				// reading the multisample attachments from memory again.
+				if(tileBin->framebuffer)
+				{
+					VkRect2D area = { { 0, y0 }, { static_cast<uint32_t>(tileBin->width), static_cast<uint32_t>(y1 - y0) } };
+					tileBin->framebuffer->resolve(tileBin->renderPass, tileBin->subpassIndex, area);
+				}
+			}
+
+			tasks.done();
+		});
+	}
+	tasks.wait();
+
+	for(auto &draw : tileBin->draws)
+	{
+		draw->teardown(device);
+	}
+
+	tileBin->draws.clear();
+	tileBin->numTriangles = 0;
+	tileBin->framebuffer = nullptr;
+
+	for(auto &ticket : tileBin->clusterTickets)
+	{
+		ticket.done();
+	}
+}
+
+void DrawCall::processBand(vk::Device *device, TileBin *tileBin, int y0, int y1, Primitive *primitives, DrawData *data)
+{
+	SW_SCOPED_EVENT("BAND rows %d-%d", y0, y1);
+
+	for(auto &draw : tileBin->draws)
+	{
+		*data = *draw->data;
+		data->scissorY0 = std::max(data->scissorY0, y0);
+		data->scissorY1 = std::min(data->scissorY1, y1);
+
+		if(data->scissorY0 >= data->scissorY1)
+		{
+			continue;
+		}
+
+		// Primitives are set up in chunks which fit the scratch memory, taking
+		// into account the multisample and wireframe expansion of each batch.
+		const unsigned int chunkSize = std::max(draw->numPrimitivesPerBatch * TileBatchSize / MaxBatchSize, 1u);
+
+		for(unsigned int batchId = 0; batchId < draw->numBatches; batchId++)
+		{
+			const RowRange &rows = draw->batchRows[batchId];
+			if(rows.yMax <= data->scissorY0 || rows.yMin >= data->scissorY1)
+			{
+				continue;
+			}
+
+			unsigned int first = batchId * draw->numPrimitivesPerBatch;
+			unsigned int last = std::min(first + draw->numPrimitivesPerBatch, draw->numPrimitives);
+
+			for(unsigned int i = first; i < last; i += chunkSize)
+			{
+				int count = std::min(chunkSize, last - i);
+				int visible = draw->setupPrimitives(device, draw->binnedTriangles + i, primitives, draw.get(), data, count);
+
+				if(visible > 0)
+				{
+					draw->pixelRoutine(device, primitives, visible, 0, 1, data);
+				}
+			}
+		}
+	}
+}
+
+void Renderer::beginTiledSubpass(vk::Framebuffer *framebuffer, const vk::RenderPass *renderPass, uint32_t subpassIndex)
+{
+	// Bands are resolved per view layer and aspect, which is not supported for
+	// multiview and depth/stencil resolves.
+	if(!tiling || renderPass->isMultiView() || renderPass->hasDepthStencilResolve())
+	{
+		return;
+	}
+
+	ASSERT(!tiling->binned);
+	tiling->framebuffer = framebuffer;
+	tiling->renderPass = renderPass;
+	tiling->subpassIndex = subpassIndex;
+}
+
+bool Renderer::endTiledSubpass()
+{
+	if(!tiling || !tiling->framebuffer)
+	{
+		return false;
+	}
+
+	bool resolved = tiling->binned;
+	if(resolved)
+	{
+		flushTiles(true);
+	}
+
+	tiling->framebuffer = nullptr;
+	tiling->renderPass = nullptr;
+
+	return resolved;
+}
+
+void Renderer::flushTiles(bool resolve)
+{
+	if(!tiling || !tiling->binned)
+	{
+		return;
+	}
+
+	SW_SCOPED_EVENT("flushTiles");
+
+	auto tileBin = std::move(tiling->bin);
+	tiling->binned = false;
+
+	if(resolve)
+	{
+		tileBin->framebuffer = tiling->framebuffer;
+		tileBin->renderPass = tiling->renderPass;
+		tileBin->subpassIndex = tiling->subpassIndex;
+	}
+
+	// The bands are rendered after the pixel processing of all prior draws,
+	// and before that of later draws.
+	for(int cluster = 0; cluster < MaxClusterCount; cluster++)
+	{
+		tileBin->clusterTickets[cluster] = clusterQueues[cluster].take();
+	}
+
+	auto ticket = drawTickets.take();
+	marl::schedule([device = device, tileBin, ticket] {
+		DrawCall::processTiles(device, tileBin.get());
+		ticket.done();
+	});
+}
+
 void Renderer::synchronize()
 {
-	MARL_SCOPED_EVENT("synchronize");
+	SW_SCOPED_EVENT("synchronize");
+	flushTiles(false);
 	auto ticket = drawTickets.take();
 	ticket.wait();
 	device->updateSamplingRoutineSnapshotCache();
 	ticket.done();
 }
 
+marl::Ticket Renderer::takeSynchronizationTicket()
+{
+	flushTiles(false);
+	return drawTickets.take();
+}
+
 void DrawCall::processPrimitiveVertices(
     unsigned int triangleIndicesOut[MaxBatchSize + 1][3],
     const void *primitiveIndices,
@@ -655,31 +1120,28 @@ void DrawCall::processPrimitiveVertices(
 	}
 }
 
-int DrawCall::setupSolidTriangles(vk::Device *device, Triangle *triangles, Primitive *primitives, const DrawCall *drawCall, int count)
+int DrawCall::setupSolidTriangles(vk::Device *device, Triangle *triangles, Primitive *primitives, const DrawCall *drawCall, const DrawData *data, int count)
 {
 	auto &state = drawCall->setupState;
 
 	int ms = state.multiSampleCount;
-	const DrawData *data = drawCall->data;
 	int visible = 0;
 
-	for(int i = 0; i < count; i++, triangles++)
-	{
-		Vertex &v0 = triangles->v0;
-		Vertex &v1 = triangles->v1;
-		Vertex &v2 = triangles->v2;
+	// Rejects the triangles which are trivially invisible, back-facing, or too
+	// small, several at a time. Only the survivors get set up individually.
+	ASSERT(count <= MaxBatchSize);
+	int survivors[MaxBatchSize + 1];  // The cull routine may write one past the last survivor
+	int survivorCount = drawCall->cullRoutine(triangles, count, data, survivors);
 
-		Polygon polygon(&v0.position, &v1.position, &v2.position);
+	for(int i = 0; i < survivorCount; i++)
+	{
+		Triangle *triangle = &triangles[survivors[i]];
 
-		if((v0.cullMask | v1.cullMask | v2.cullMask) == 0)
-		{
-			continue;
-		}
+		Vertex &v0 = triangle->v0;
+		Vertex &v1 = triangle->v1;
+		Vertex &v2 = triangle->v2;
 
-		if((v0.clipFlags & v1.clipFlags & v2.clipFlags) != Clipper::CLIP_FINITE)
-		{
-			continue;
-		}
+		Polygon polygon(&v0.position, &v1.position, &v2.position);
 
 		int clipFlagsOr = v0.clipFlags | v1.clipFlags | v2.clipFlags;
 		if(clipFlagsOr != Clipper::CLIP_FINITE)
@@ -690,7 +1152,7 @@ int DrawCall::setupSolidTriangles(vk::Device *device, Triangle *triangles, Primi
 			}
 		}
 
-		if(drawCall->setupRoutine(device, primitives, triangles, &polygon, data))
+		if(drawCall->setupRoutine(device, primitives, triangle, &polygon, data))
 		{
 			primitives += ms;
 			visible++;
@@ -700,7 +1162,7 @@ int DrawCall::setupSolidTriangles(vk::Device *device, Triangle *triangles, Primi
 	return visible;
 }
 
-int DrawCall::setupWireframeTriangles(vk::Device *device, Triangle *triangles, Primitive *primitives, const DrawCall *drawCall, int count)
+int DrawCall::setupWireframeTriangles(vk::Device *device, Triangle *triangles, Primitive *primitives, const DrawCall *drawCall, const DrawData *data, int count)
 {
 	auto &state = drawCall->setupState;
 
@@ -744,7 +1206,7 @@ int DrawCall::setupWireframeTriangles(vk::Device *device, Triangle *triangles, P
 
 		for(int i = 0; i < 3; i++)
 		{
-			if(setupLine(device, *primitives, lines[i], *drawCall))
+			if(setupLine(device, *primitives, lines[i], *drawCall, *data))
 			{
 				primitives += ms;
 				visible++;
@@ -755,7 +1217,7 @@ int DrawCall::setupWireframeTriangles(vk::Device *device, Triangle *triangles, P
 	return visible;
 }
 
-int DrawCall::setupPointTriangles(vk::Device *device, Triangle *triangles, Primitive *primitives, const DrawCall *drawCall, int count)
+int DrawCall::setupPointTriangles(vk::Device *device, Triangle *triangles, Primitive *primitives, const DrawCall *drawCall, const DrawData *data, int count)
 {
 	auto &state = drawCall->setupState;
 
@@ -789,7 +1251,7 @@ int DrawCall::setupPointTriangles(vk::Device *device, Triangle *triangles, Primi
 
 		for(int i = 0; i < 3; i++)
 		{
-			if(setupPoint(device, *primitives, points[i], *drawCall))
+			if(setupPoint(device, *primitives, points[i], *drawCall, *data))
 			{
 				primitives += ms;
 				visible++;
@@ -800,7 +1262,7 @@ int DrawCall::setupPointTriangles(vk::Device *device, Triangle *triangles, Primi
 	return visible;
 }
 
-int DrawCall::setupLines(vk::Device *device, Triangle *triangles, Primitive *primitives, const DrawCall *drawCall, int count)
+int DrawCall::setupLines(vk::Device *device, Triangle *triangles, Primitive *primitives, const DrawCall *drawCall, const DrawData *data, int count)
 {
 	auto &state = drawCall->setupState;
 
@@ -809,7 +1271,7 @@ int DrawCall::setupLines(vk::Device *device, Triangle *triangles, Primitive *pri
 
 	for(int i = 0; i < count; i++)
 	{
-		if(setupLine(device, *primitives, *triangles, *drawCall))
+		if(setupLine(device, *primitives, *triangles, *drawCall, *data))
 		{
 			primitives += ms;
 			visible++;
@@ -821,7 +1283,7 @@ int DrawCall::setupLines(vk::Device *device, Triangle *triangles, Primitive *pri
 	return visible;
 }
 
-int DrawCall::setupPoints(vk::Device *device, Triangle *triangles, Primitive *primitives, const DrawCall *drawCall, int count)
+int DrawCall::setupPoints(vk::Device *device, Triangle *triangles, Primitive *primitives, const DrawCall *drawCall, const DrawData *data, int count)
 {
 	auto &state = drawCall->setupState;
 
@@ -830,7 +1292,7 @@ int DrawCall::setupPoints(vk::Device *device, Triangle *triangles, Primitive *pr
 
 	for(int i = 0; i < count; i++)
 	{
-		if(setupPoint(device, *primitives, *triangles, *drawCall))
+		if(setupPoint(device, *primitives, *triangles, *drawCall, *data))
 		{
 			primitives += ms;
 			visible++;
@@ -842,9 +1304,8 @@ int DrawCall::setupPoints(vk::Device *device, Triangle *triangles, Primitive *pr
 	return visible;
 }
 
-bool DrawCall::setupLine(vk::Device *device, Primitive &primitive, Triangle &triangle, const DrawCall &draw)
+bool DrawCall::setupLine(vk::Device *device, Primitive &primitive, Triangle &triangle, const DrawCall &draw, const DrawData &data)
 {
-	const DrawData &data = *draw.data;
 
 	float lineWidth = data.lineWidth;
 
@@ -1139,9 +1600,8 @@ bool DrawCall::setupLine(vk::Device *device, Primitive &primitive, Triangle &tri
 	return false;
 }
 
-bool DrawCall::setupPoint(vk::Device *device, Primitive &primitive, Triangle &triangle, const DrawCall &draw)
+bool DrawCall::setupPoint(vk::Device *device, Primitive &primitive, Triangle &triangle, const DrawCall &draw, const DrawData &data)
 {
-	const DrawData &data = *draw.data;
 
 	Vertex &v = triangle.v0;
 
@@ -1205,18 +1665,36 @@ bool DrawCall::setupPoint(vk::Device *device, Primitive &primitive, Triangle &tr
 
 void Renderer::addQuery(vk::Query *query)
 {
-	ASSERT(query->getType() == VK_QUERY_TYPE_OCCLUSION);
-	ASSERT(!occlusionQuery);
-
-	occlusionQuery = query;
+	switch(query->getType())
+	{
+	case VK_QUERY_TYPE_OCCLUSION:
+		ASSERT(!occlusionQuery);
+		occlusionQuery = query;
+		break;
+	case VK_QUERY_TYPE_PIPELINE_STATISTICS:
+		ASSERT(!pipelineStatisticsQuery);
+		pipelineStatisticsQuery = query;
+		break;
+	default:
+		UNSUPPORTED("VkQueryType %d", int(query->getType()));
+	}
 }
 
 void Renderer::removeQuery(vk::Query *query)
 {
-	ASSERT(query->getType() == VK_QUERY_TYPE_OCCLUSION);
-	ASSERT(occlusionQuery == query);
-
-	occlusionQuery = nullptr;
+	switch(query->getType())
+	{
+	case VK_QUERY_TYPE_OCCLUSION:
+		ASSERT(occlusionQuery == query);
+		occlusionQuery = nullptr;
+		break;
+	case VK_QUERY_TYPE_PIPELINE_STATISTICS:
+		ASSERT(pipelineStatisticsQuery == query);
+		pipelineStatisticsQuery = nullptr;
+		break;
+	default:
+		UNSUPPORTED("VkQueryType %d", int(query->getType()));
+	}
 }
 
 }  // namespace sw
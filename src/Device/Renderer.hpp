@@ -26,18 +26,23 @@
 #include "marl/finally.h"
 #include "marl/pool.h"
 #include "marl/ticket.h"
+#include "marl/waitgroup.h"
 
 #include <atomic>
 #include <list>
+#include <memory>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 namespace vk {
 
 class DescriptorSet;
 class Device;
+class Framebuffer;
 class Query;
 class PipelineLayout;
+class RenderPass;
 
 }  // namespace vk
 
@@ -50,12 +55,18 @@ class VertexShader;
 struct Task;
 class Resource;
 struct Constants;
+struct TileBin;
 
 static constexpr int MaxBatchSize = 128;
 static constexpr int MaxBatchCount = 16;
 static constexpr int MaxClusterCount = 16;
 static constexpr int MaxDrawCount = 16;
 
+static constexpr int MaxTiledDrawCount = 64;         // Draws binned before a tiled subpass is flushed
+static constexpr int MaxTiledPrimitiveCount = 4096;  // Primitives binned before a tiled subpass is flushed
+static constexpr int TileBatchSize = 16;             // Primitives set up at once when rendering a band
+static constexpr int TileCacheSize = 512 * 1024;     // Bytes of attachment rows per band, about the size of an L2 cache
+
 using TriangleBatch = std::array<Triangle, MaxBatchSize>;
 using PrimitiveBatch = std::array<Primitive, MaxBatchSize>;
 
@@ -76,7 +87,8 @@ struct DrawData
 
 	PixelProcessor::Stencil stencil[2];  // clockwise, counterclockwise
 	PixelProcessor::Factor factor;
-	unsigned int occlusion[MaxClusterCount];  // Number of pixels passing depth test
+	unsigned int occlusion[MaxClusterCount];            // Number of pixels passing depth test
+	unsigned int fragmentInvocations[MaxClusterCount];  // Number of fragment shader invocations
 
 	float4 WxF;
 	float4 HxF;
@@ -132,19 +144,35 @@ struct DrawCall
 		marl::Ticket clusterTickets[MaxClusterCount];
 	};
 
+	// Rows of the framebuffer covered by the primitives of a binned batch.
+	struct RowRange
+	{
+		int yMin;
+		int yMax;
+	};
+
 	using Pool = marl::BoundedPool<DrawCall, MaxDrawCount, marl::PoolPolicy::Preserve>;
-	using SetupFunction = int (*)(vk::Device *device, Triangle *triangles, Primitive *primitives, const DrawCall *drawCall, int count);
+	using TiledPool = marl::BoundedPool<DrawCall, 2 * MaxTiledDrawCount, marl::PoolPolicy::Preserve>;
+	using SetupFunction = int (*)(vk::Device *device, Triangle *triangles, Primitive *primitives, const DrawCall *drawCall, const DrawData *data, int count);
 
 	DrawCall();
 	~DrawCall();
 
-	static void run(vk::Device *device, const marl::Loan<DrawCall> &draw, marl::Ticket::Queue *tickets, marl::Ticket::Queue clusterQueues[MaxClusterCount]);
+	static void run(vk::Device *device, const marl::Loan<DrawCall> &draw, marl::Ticket::Queue *tickets, marl::Ticket::Queue clusterQueues[MaxClusterCount],
+	                const std::shared_ptr<marl::Finally> &multiDraw);
 	static void processVertices(vk::Device *device, DrawCall *draw, BatchData *batch);
 	static void processPrimitives(vk::Device *device, DrawCall *draw, BatchData *batch);
 	static void processPixels(vk::Device *device, const marl::Loan<DrawCall> &draw, const marl::Loan<BatchData> &batch, const std::shared_ptr<marl::Finally> &finally);
+	static void bin(vk::Device *device, const marl::Loan<DrawCall> &draw, TileBin *tileBin);
+	static void binPrimitives(DrawCall *draw, BatchData *batch);
+	static void processTiles(vk::Device *device, TileBin *tileBin);
+	static void processBand(vk::Device *device, TileBin *tileBin, int y0, int y1, Primitive *primitives, DrawData *data);
 	void setup();
 	void teardown(vk::Device *device);
 
+	// Returns the number of vertices read by the input assembly stage.
+	uint64_t inputAssemblyVertices() const;
+
 	int id;
 
 	BatchData::Pool *batchDataPool;
@@ -161,6 +189,7 @@ struct DrawCall
 
 	VertexProcessor::RoutineType vertexRoutine;
 	SetupProcessor::RoutineType setupRoutine;
+	SetupProcessor::CullRoutineType cullRoutine;  // Only for solid triangles
 	PixelProcessor::RoutineType pixelRoutine;
 	bool containsImageWrite;
 
@@ -175,9 +204,19 @@ struct DrawCall
 	sw::CountedEvent *events;
 
 	vk::Query *occlusionQuery;
+	vk::Query *pipelineStatisticsQuery;
+
+	// Pipeline statistics gathered by the batches, when pipelineStatisticsQuery is set.
+	std::atomic<uint64_t> vertexInvocations;
+	std::atomic<uint64_t> clippingPrimitives;
 
 	DrawData *data;
 
+	// Post-transform primitives of a draw binned by a tiled subpass, rasterized
+	// when the bin is flushed.
+	Triangle *binnedTriangles;
+	std::vector<RowRange> batchRows;
+
 	static void processPrimitiveVertices(
 	    unsigned int triangleIndicesOut[MaxBatchSize + 1][3],
 	    const void *primitiveIndices,
@@ -187,14 +226,60 @@ struct DrawCall
 	    VkPrimitiveTopology topology,
 	    VkProvokingVertexModeEXT provokingVertexMode);
 
-	static int setupSolidTriangles(vk::Device *device, Triangle *triangles, Primitive *primitives, const DrawCall *drawCall, int count);
-	static int setupWireframeTriangles(vk::Device *device, Triangle *triangles, Primitive *primitives, const DrawCall *drawCall, int count);
-	static int setupPointTriangles(vk::Device *device, Triangle *triangles, Primitive *primitives, const DrawCall *drawCall, int count);
-	static int setupLines(vk::Device *device, Triangle *triangles, Primitive *primitives, const DrawCall *drawCall, int count);
-	static int setupPoints(vk::Device *device, Triangle *triangles, Primitive *primitives, const DrawCall *drawCall, int count);
+	static int setupSolidTriangles(vk::Device *device, Triangle *triangles, Primitive *primitives, const DrawCall *drawCall, const DrawData *data, int count);
+	static int setupWireframeTriangles(vk::Device *device, Triangle *triangles, Primitive *primitives, const DrawCall *drawCall, const DrawData *data, int count);
+	static int setupPointTriangles(vk::Device *device, Triangle *triangles, Primitive *primitives, const DrawCall *drawCall, const DrawData *data, int count);
+	static int setupLines(vk::Device *device, Triangle *triangles, Primitive *primitives, const DrawCall *drawCall, const DrawData *data, int count);
+	static int setupPoints(vk::Device *device, Triangle *triangles, Primitive *primitives, const DrawCall *drawCall, const DrawData *data, int count);
+
+	static bool setupLine(vk::Device *device, Primitive &primitive, Triangle &triangle, const DrawCall &draw, const DrawData &data);
+	static bool setupPoint(vk::Device *device, Primitive &primitive, Triangle &triangle, const DrawCall &draw, const DrawData &data);
+};
+
+// The draws of a tiled subpass, binned so they can be rendered one horizontal
+// band of the framebuffer at a time. Each band is processed for all of the
+// draws before moving on to the next, which keeps its attachment rows in cache.
+struct TileBin
+{
+	using Pool = marl::BoundedPool<TileBin, 2, marl::PoolPolicy::Preserve>;
+
+	// Working memory of one of the tasks rendering the bands.
+	struct Scratch
+	{
+		Primitive primitives[TileBatchSize];
+		DrawData data;  // Draw data with the scissor restricted to the band
+	};
+
+	TileBin();
+
+	std::vector<marl::Loan<DrawCall>> draws;
+	std::unique_ptr<Triangle[]> triangles;  // Post-transform primitives of all draws
+	unsigned int numTriangles = 0;
+	marl::WaitGroup vertexProcessing;  // Outstanding vertex processing of the binned batches
+	marl::Ticket clusterTickets[MaxClusterCount];
+
+	int width = 0;
+	int height = 0;
+
+	// The subpass whose multisample attachments are resolved within each band,
+	// when the bin is the last one of the subpass.
+	vk::Framebuffer *framebuffer = nullptr;
+	const vk::RenderPass *renderPass = nullptr;
+	uint32_t subpassIndex = 0;
 
-	static bool setupLine(vk::Device *device, Primitive &primitive, Triangle &triangle, const DrawCall &draw);
-	static bool setupPoint(vk::Device *device, Primitive &primitive, Triangle &triangle, const DrawCall &draw);
+	std::unique_ptr<Scratch> scratch[MaxClusterCount];
+};
+
+// The routine caches of the renderers of all the queues of a device. Routines
+// needed by draws on multiple queues are shared, and only generated once.
+struct DrawRoutineCaches
+{
+	DrawRoutineCaches(size_t cacheSize);
+
+	VertexProcessor::RoutineCacheType vertex;
+	SetupProcessor::RoutineCacheType setup;
+	SetupProcessor::CullRoutineCacheType cull;
+	PixelProcessor::RoutineCacheType pixel;
 };
 
 class alignas(16) Renderer
@@ -208,26 +293,80 @@ public:
 	void operator delete(void *mem);
 
 	bool hasOcclusionQuery() const { return occlusionQuery != nullptr; }
+	bool hasPipelineStatisticsQuery() const { return pipelineStatisticsQuery != nullptr; }
+
+	// Returns the active pipeline statistics query, if any. Work which does not
+	// go through draw() adds its own statistics to it.
+	vk::Query *getPipelineStatisticsQuery() const { return pipelineStatisticsQuery; }
 
 	void draw(const vk::GraphicsPipeline *pipeline, const vk::DynamicState &dynamicState, unsigned int count, int baseVertex,
 	          CountedEvent *events, int instanceID, int viewID, void *indexBuffer, const VkExtent3D &framebufferExtent,
 	          vk::Pipeline::PushConstantStorage const &pushConstants, bool update = true);
 
+	// Draws issued between beginMultiDraw() and endMultiDraw() form a single
+	// multi-draw job, such as the records of an indirect draw command. They
+	// must share the pipeline and dynamic state. The routines are resolved and
+	// the descriptor sets are prepared for sampling by the first draw only, and
+	// the job completes as a whole on a single ticket of the draw queue.
+	void beginMultiDraw();
+	void endMultiDraw();
+
 	void addQuery(vk::Query *query);
 	void removeQuery(vk::Query *query);
 
 	void synchronize();
 
+	// Returns a ticket which is called once all draws issued before this call
+	// have completed. Unlike synchronize(), the wait may be performed on any
+	// thread or fiber. done() must be called on the ticket after waiting.
+	marl::Ticket takeSynchronizationTicket();
+
+	// Tiled render pass execution is enabled by setting the environment variable
+	// SWIFTSHADER_TILED_RENDERING to 1. The draws of a tiled subpass are binned, and only
+	// rasterized when the bin is flushed, one band of the framebuffer at a time.
+	// Draws which can't be binned, such as those counted by a query, and any
+	// synchronization flush the bin first so that rasterization order is kept.
+	void beginTiledSubpass(vk::Framebuffer *framebuffer, const vk::RenderPass *renderPass, uint32_t subpassIndex);
+
+	// Flushes the binned draws of the subpass. Returns true if its multisample
+	// attachments have been resolved within each band, in which case the caller
+	// must not resolve them again.
+	bool endTiledSubpass();
+
 private:
+	void flushTiles(bool resolve);
+
 	DrawCall::Pool drawCallPool;
 	DrawCall::BatchData::Pool batchDataPool;
 
 	std::atomic<int> nextDrawID = { 0 };
 
 	vk::Query *occlusionQuery = nullptr;
+	vk::Query *pipelineStatisticsQuery = nullptr;
 	marl::Ticket::Queue drawTickets;
+
+	struct MultiDraw
+	{
+		bool active = false;
+		bool started = false;                   // The first draw of the job has been issued
+		std::shared_ptr<marl::Finally> ticket;  // Done when the last draw of the job finishes
+	} multiDraw;
 	marl::Ticket::Queue clusterQueues[MaxClusterCount];
 
+	struct Tiling
+	{
+		DrawCall::TiledPool drawCallPool;
+		TileBin::Pool binPool;
+
+		vk::Framebuffer *framebuffer = nullptr;  // Framebuffer of the tiled subpass, if any
+		const vk::RenderPass *renderPass = nullptr;
+		uint32_t subpassIndex = 0;
+
+		bool binned = false;
+		marl::Loan<TileBin> bin;  // Bin of the current draws, when binned is true
+	};
+	std::unique_ptr<Tiling> tiling;  // Only allocated when tiled rendering is enabled
+
 	VertexProcessor vertexProcessor;
 	PixelProcessor pixelProcessor;
 	SetupProcessor setupProcessor;
@@ -238,6 +377,7 @@ private:
 
 	VertexProcessor::RoutineType vertexRoutine;
 	SetupProcessor::RoutineType setupRoutine;
+	SetupProcessor::CullRoutineType cullRoutine;
 	PixelProcessor::RoutineType pixelRoutine;
 
 	vk::Device *device;
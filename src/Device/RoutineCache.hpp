@@ -16,6 +16,7 @@
 #define sw_RoutineCache_hpp
 
 #include "System/LRUCache.hpp"
+#include "System/SharedLRUCache.hpp"
 
 #include "Reactor/Reactor.hpp"
 
@@ -26,6 +27,9 @@ using namespace rr;
 template<class State, class FunctionType>
 using RoutineCache = LRUCache<State, RoutineT<FunctionType>>;
 
+template<class State, class FunctionType>
+using SharedRoutineCache = SharedLRUCache<State, RoutineT<FunctionType>>;
+
 }  // namespace sw
 
 #endif  // sw_RoutineCache_hpp
@@ -50,11 +50,6 @@ bool SetupProcessor::State::operator==(const State &state) const
 	return *static_cast<const States *>(this) == static_cast<const States &>(state);
 }
 
-SetupProcessor::SetupProcessor()
-{
-	setRoutineCacheSize(1024);
-}
-
 SetupProcessor::State SetupProcessor::update(const vk::GraphicsState &pipelineState, const sw::SpirvShader *fragmentShader, const sw::SpirvShader *vertexShader, const vk::Attachments &attachments) const
 {
 	State state;
@@ -96,24 +91,41 @@ SetupProcessor::State SetupProcessor::update(const vk::GraphicsState &pipelineSt
 
 SetupProcessor::RoutineType SetupProcessor::routine(const State &state)
 {
-	auto routine = routineCache->lookup(state);
-
-	if(!routine)
-	{
+	return routineCache->getOrCreate(state, [&]() -> RoutineType {
 		SetupRoutine *generator = new SetupRoutine(state);
 		generator->generate();
-		routine = generator->getRoutine();
+		auto routine = generator->getRoutine();
 		delete generator;
 
-		routineCache->add(state, routine);
-	}
+		return routine;
+	});
+}
+
+SetupProcessor::CullRoutineType SetupProcessor::cullRoutine(const State &state)
+{
+	// Culling only depends on a few of the setup state's fields, so the cull
+	// routines are shared by all draws which agree on those.
+	State cullState;
+	cullState.isDrawTriangle = true;
+	cullState.frontFace = state.frontFace;
+	cullState.cullMode = state.cullMode;
+	cullState.enableMultiSampling = state.enableMultiSampling;
+	cullState.hash = cullState.computeHash();
+
+	return cullRoutineCache->getOrCreate(cullState, [&]() -> CullRoutineType {
+		SetupRoutine *generator = new SetupRoutine(cullState);
+		generator->generateCulling();
+		auto routine = generator->getCullRoutine();
+		delete generator;
 
-	return routine;
+		return routine;
+	});
 }
 
-void SetupProcessor::setRoutineCacheSize(int cacheSize)
+void SetupProcessor::setRoutineCaches(RoutineCacheType *cache, CullRoutineCacheType *cullCache)
 {
-	routineCache = std::make_unique<RoutineCacheType>(clamp(cacheSize, 1, 65536));
+	routineCache = cache;
+	cullRoutineCache = cullCache;
 }
 
 }  // namespace sw
@@ -34,6 +34,10 @@ struct DrawData;
 
 using SetupFunction = FunctionT<int(const vk::Device *device, Primitive *primitive, const Triangle *triangle, const Polygon *polygon, const DrawData *draw)>;
 
+// Culls a batch of solid triangles four at a time, and writes the indices of the
+// ones which may be visible to 'survivors'. Returns the number of survivors.
+using CullFunction = FunctionT<int(const Triangle *triangles, int count, const DrawData *draw, int *survivors)>;
+
 class SetupProcessor
 {
 public:
@@ -73,17 +77,19 @@ public:
 	};
 
 	using RoutineType = SetupFunction::RoutineType;
-
-	SetupProcessor();
+	using CullRoutineType = CullFunction::RoutineType;
 
 	State update(const vk::GraphicsState &pipelineState, const sw::SpirvShader *fragmentShader, const sw::SpirvShader *vertexShader, const vk::Attachments &attachments) const;
 	RoutineType routine(const State &state);
+	CullRoutineType cullRoutine(const State &state);
 
-	void setRoutineCacheSize(int cacheSize);
+	using RoutineCacheType = SharedRoutineCache<State, SetupFunction::CFunctionType>;
+	using CullRoutineCacheType = SharedRoutineCache<State, CullFunction::CFunctionType>;
+	void setRoutineCaches(RoutineCacheType *cache, CullRoutineCacheType *cullCache);
 
 private:
-	using RoutineCacheType = RoutineCache<State, SetupFunction::CFunctionType>;
-	std::unique_ptr<RoutineCacheType> routineCache;
+	RoutineCacheType *routineCache = nullptr;
+	CullRoutineCacheType *cullRoutineCache = nullptr;
 };
 
 }  // namespace sw
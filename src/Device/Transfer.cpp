@@ -0,0 +1,159 @@
+// Copyright 2021 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "Transfer.hpp"
+
+#include "System/Memory.hpp"
+
+#include "marl/scheduler.h"
+#include "marl/waitgroup.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// Smallest amount of memory worth handing to another thread.
+constexpr size_t MIN_CHUNK_BYTES = 256 * 1024;
+
+// Number of chunks per thread, so that threads which are busy with other work
+// (e.g. rendering) don't hold up the transfer.
+constexpr size_t CHUNKS_PER_THREAD = 4;
+
+// Transfers at least this large are assumed to not fit in the last level cache,
+// so their destination is written with non-temporal stores.
+constexpr size_t NON_TEMPORAL_BYTES = 16 * 1024 * 1024;
+
+// Calls function(begin, end) on consecutive ranges which cover [0, count),
+// where each unit of work accounts for unitBytes of memory traffic.
+template<typename Function>
+void parallelize(size_t count, size_t unitBytes, const Function &function)
+{
+	marl::Scheduler *scheduler = marl::Scheduler::get();
+	size_t totalBytes = count * unitBytes;
+
+	size_t chunkCount = 1;
+	if(scheduler && (totalBytes >= 2 * MIN_CHUNK_BYTES))
+	{
+		size_t threadCount = scheduler->config().workerThread.count + 1;
+		chunkCount = std::min({ totalBytes / MIN_CHUNK_BYTES, threadCount * CHUNKS_PER_THREAD, count });
+	}
+
+	if(chunkCount <= 1)
+	{
+		function(0, count);
+		return;
+	}
+
+	size_t unitsPerChunk = (count + chunkCount - 1) / chunkCount;
+	chunkCount = (count + unitsPerChunk - 1) / unitsPerChunk;
+
+	marl::WaitGroup chunks(chunkCount - 1);
+	for(size_t chunk = 1; chunk < chunkCount; chunk++)
+	{
+		marl::schedule([=, &function] {
+			function(chunk * unitsPerChunk, std::min((chunk + 1) * unitsPerChunk, count));
+			chunks.done();
+		});
+	}
+
+	// The calling thread takes the first chunk.
+	function(0, unitsPerChunk);
+	chunks.wait();
+}
+
+}  // anonymous namespace
+
+namespace sw {
+
+void transferCopy(const StridedCopy &copy)
+{
+	StridedCopy c = copy;
+
+	// Rows and slices which are contiguous in both layouts get copied as one.
+	if((c.rowCount > 1) && (c.srcRowPitch == c.rowBytes) && (c.dstRowPitch == c.rowBytes))
+	{
+		c.rowBytes *= c.rowCount;
+		c.rowCount = 1;
+	}
+
+	if((c.rowCount == 1) && (c.sliceCount > 1) && (c.srcSlicePitch == c.rowBytes) && (c.dstSlicePitch == c.rowBytes))
+	{
+		c.rowBytes *= c.sliceCount;
+		c.sliceCount = 1;
+	}
+
+	size_t rowCount = c.rowCount * c.sliceCount;
+	if(c.rowBytes == 0 || rowCount == 0)
+	{
+		return;
+	}
+
+	bool nonTemporal = (c.rowBytes * rowCount) >= NON_TEMPORAL_BYTES;
+
+	// Long rows are split into pieces, so a single large copy still gets parallelized.
+	size_t piecesPerRow = std::max<size_t>(c.rowBytes / MIN_CHUNK_BYTES, 1);
+	size_t pieceBytes = (c.rowBytes + piecesPerRow - 1) / piecesPerRow;
+
+	parallelize(rowCount * piecesPerRow, pieceBytes, [&](size_t begin, size_t end) {
+		for(size_t i = begin; i < end; i++)
+		{
+			size_t row = i / piecesPerRow;
+			size_t offset = (i % piecesPerRow) * pieceBytes;
+			size_t bytes = std::min(pieceBytes, c.rowBytes - offset);
+			size_t y = row % c.rowCount;
+			size_t z = row / c.rowCount;
+
+			uint8_t *dst = c.dst + z * c.dstSlicePitch + y * c.dstRowPitch + offset;
+			const uint8_t *src = c.src + z * c.srcSlicePitch + y * c.srcRowPitch + offset;
+
+			if(nonTemporal)
+			{
+				copyNonTemporal(dst, src, bytes);
+			}
+			else
+			{
+				memcpy(dst, src, bytes);
+			}
+		}
+	});
+}
+
+void transferCopy(void *dst, const void *src, size_t bytes)
+{
+	StridedCopy copy;
+	copy.dst = static_cast<uint8_t *>(dst);
+	copy.src = static_cast<const uint8_t *>(src);
+	copy.rowBytes = bytes;
+
+	transferCopy(copy);
+}
+
+void transferFill(uint32_t *dst, uint32_t value, size_t count)
+{
+	bool nonTemporal = (count * sizeof(uint32_t)) >= NON_TEMPORAL_BYTES;
+
+	parallelize(count, sizeof(uint32_t), [&](size_t begin, size_t end) {
+		if(nonTemporal)
+		{
+			clearNonTemporal(dst + begin, value, end - begin);
+		}
+		else
+		{
+			clear(dst + begin, value, end - begin);
+		}
+	});
+}
+
+}  // namespace sw
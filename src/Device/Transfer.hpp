@@ -0,0 +1,48 @@
+// Copyright 2021 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef sw_Transfer_hpp
+#define sw_Transfer_hpp
+
+#include <cstddef>
+#include <cstdint>
+
+namespace sw {
+
+// A copy of sliceCount slices of rowCount rows of rowBytes bytes each,
+// between two strided memory layouts.
+struct StridedCopy
+{
+	uint8_t *dst = nullptr;
+	const uint8_t *src = nullptr;
+	size_t rowBytes = 0;
+	size_t rowCount = 1;
+	size_t sliceCount = 1;
+	size_t dstRowPitch = 0;
+	size_t srcRowPitch = 0;
+	size_t dstSlicePitch = 0;
+	size_t srcSlicePitch = 0;
+};
+
+// Memory transfers for the copy and fill commands. Large transfers are split
+// into chunks which run in parallel on the marl scheduler bound to the calling
+// thread, if there is one. Destinations too large to stay cached are written
+// with non-temporal stores. The transfer has completed when the call returns.
+void transferCopy(const StridedCopy &copy);
+void transferCopy(void *dst, const void *src, size_t bytes);
+void transferFill(uint32_t *dst, uint32_t value, size_t count);
+
+}  // namespace sw
+
+#endif  // sw_Transfer_hpp
@@ -18,6 +18,7 @@
 #include "Pipeline/VertexProgram.hpp"
 #include "System/Debug.hpp"
 #include "System/Math.hpp"
+#include "System/Metrics.hpp"
 #include "Vulkan/VkPipelineLayout.hpp"
 
 #include <cstring>
@@ -55,14 +56,9 @@ bool VertexProcessor::State::operator==(const State &state) const
 	return *static_cast<const States *>(this) == static_cast<const States &>(state);
 }
 
-VertexProcessor::VertexProcessor()
+void VertexProcessor::setRoutineCache(RoutineCacheType *cache)
 {
-	setRoutineCacheSize(1024);
-}
-
-void VertexProcessor::setRoutineCacheSize(int cacheSize)
-{
-	routineCache = std::make_unique<RoutineCacheType>(clamp(cacheSize, 1, 65536));
+	routineCache = cache;
 }
 
 const VertexProcessor::State VertexProcessor::update(const vk::GraphicsState &pipelineState, const sw::SpirvShader *vertexShader, const vk::Inputs &inputs)
@@ -93,19 +89,17 @@ VertexProcessor::RoutineType VertexProcessor::routine(const State &state,
                                                       SpirvShader const *vertexShader,
                                                       const vk::DescriptorSet::Bindings &descriptorSets)
 {
-	auto routine = routineCache->lookup(state);
-
-	if(!routine)  // Create one
-	{
+	return routineCache->getOrCreate(state, [&]() -> RoutineType {
 		VertexRoutine *generator = new VertexProgram(state, pipelineLayout, vertexShader, descriptorSets);
-		generator->generate();
-		routine = (*generator)("VertexRoutine_%0.8X", state.shaderID);
+		{
+			Metrics::ScopedTimer timer(Metrics::ShaderEmitTime);
+			generator->generate();
+		}
+		auto routine = (*generator)("VertexRoutine_%0.8X", state.shaderID);
 		delete generator;
 
-		routineCache->add(state, routine);
-	}
-
-	return routine;
+		return routine;
+	});
 }
 
 }  // namespace sw
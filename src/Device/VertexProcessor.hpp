@@ -48,6 +48,8 @@ struct VertexTask
 {
 	unsigned int vertexCount;
 	unsigned int primitiveStart;
+	unsigned int invocations;  // Number of vertex shader invocations of the batch
+	unsigned int simdGroups;   // Number of SIMD groups the invocations were executed in
 	VertexCache vertexCache;
 };
 
@@ -93,17 +95,15 @@ public:
 
 	using RoutineType = VertexRoutineFunction::RoutineType;
 
-	VertexProcessor();
-
 	const State update(const vk::GraphicsState &pipelineState, const sw::SpirvShader *vertexShader, const vk::Inputs &inputs);
 	RoutineType routine(const State &state, vk::PipelineLayout const *pipelineLayout,
 	                    SpirvShader const *vertexShader, const vk::DescriptorSet::Bindings &descriptorSets);
 
-	void setRoutineCacheSize(int cacheSize);
+	using RoutineCacheType = SharedRoutineCache<State, VertexRoutineFunction::CFunctionType>;
+	void setRoutineCache(RoutineCacheType *cache);
 
 private:
-	using RoutineCacheType = RoutineCache<State, VertexRoutineFunction::CFunctionType>;
-	std::unique_ptr<RoutineCacheType> routineCache;
+	RoutineCacheType *routineCache = nullptr;
 };
 
 }  // namespace sw
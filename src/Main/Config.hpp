@@ -17,12 +17,11 @@
 
 #include "Common/Types.hpp"
 
-#define PERF_HUD 0       // Display time spent on vertex, setup and pixel processing for each thread
 #define PERF_PROFILE 0   // Profile various pipeline stages and display the timing in SwiftConfig
 
 // Worker thread count when not set by SwiftConfig
 // 0 = process affinity count (recommended)
-// 1 = rendering on main thread (no worker threads), useful for debugging
+// 1 = a single worker thread, useful for debugging
 #ifndef DEFAULT_THREAD_COUNT
 #define DEFAULT_THREAD_COUNT 0
 #endif
@@ -21,6 +21,10 @@
 #include "ParseHelper.h"
 #include "ValidateLimitations.h"
 
+#include <mutex>
+#include <string.h>
+#include <vector>
+
 namespace
 {
 class TScopedPoolAllocator {
@@ -41,6 +45,104 @@ private:
 	TPoolAllocator* mAllocator;
 	bool mPushPopAllocator;
 };
+
+// The built-in symbols only depend on the shader type and the resources, so
+// their tables are built once per process, in a pool of their own, and shared
+// read-only by the compilers.
+struct BuiltInSymbolTable
+{
+	GLenum shaderType;
+	ShBuiltInResources resources;
+	TSymbolTable symbolTable;
+};
+
+std::mutex builtInsMutex;
+TPoolAllocator *builtInsAllocator = nullptr;
+std::vector<BuiltInSymbolTable*> builtInSymbolTables;
+
+void InsertBuiltIns(GLenum shaderType, const ShBuiltInResources &resources, TSymbolTable &symbolTable)
+{
+	symbolTable.push();   // COMMON_BUILTINS
+	symbolTable.push();   // ESSL1_BUILTINS
+	symbolTable.push();   // ESSL3_BUILTINS
+
+	TPublicType integer;
+	integer.type = EbtInt;
+	integer.primarySize = 1;
+	integer.secondarySize = 1;
+	integer.array = false;
+
+	TPublicType floatingPoint;
+	floatingPoint.type = EbtFloat;
+	floatingPoint.primarySize = 1;
+	floatingPoint.secondarySize = 1;
+	floatingPoint.array = false;
+
+	switch(shaderType)
+	{
+	case GL_FRAGMENT_SHADER:
+		symbolTable.setDefaultPrecision(integer, EbpMedium);
+		break;
+	case GL_VERTEX_SHADER:
+		symbolTable.setDefaultPrecision(integer, EbpHigh);
+		symbolTable.setDefaultPrecision(floatingPoint, EbpHigh);
+		break;
+	default: assert(false && "Language not supported");
+	}
+
+	InsertBuiltInFunctions(shaderType, resources, symbolTable);
+
+	IdentifyBuiltIns(shaderType, resources, symbolTable);
+
+	symbolTable.finalizeBuiltIns();
+}
+
+const TSymbolTable &GetBuiltInSymbolTable(GLenum shaderType, const ShBuiltInResources &resources)
+{
+	std::lock_guard<std::mutex> lock(builtInsMutex);
+
+	for(BuiltInSymbolTable *builtIns : builtInSymbolTables)
+	{
+		// The resources are a plain collection of integers.
+		if(builtIns->shaderType == shaderType &&
+		   memcmp(&builtIns->resources, &resources, sizeof(ShBuiltInResources)) == 0)
+		{
+			return builtIns->symbolTable;
+		}
+	}
+
+	if(!builtInsAllocator)
+	{
+		builtInsAllocator = new TPoolAllocator();
+	}
+
+	TPoolAllocator *compilerAllocator = GetGlobalPoolAllocator();
+	SetGlobalPoolAllocator(builtInsAllocator);
+
+	BuiltInSymbolTable *builtIns = new BuiltInSymbolTable;
+	builtIns->shaderType = shaderType;
+	builtIns->resources = resources;
+	InsertBuiltIns(shaderType, resources, builtIns->symbolTable);
+	builtInSymbolTables.push_back(builtIns);
+
+	SetGlobalPoolAllocator(compilerAllocator);
+
+	return builtIns->symbolTable;
+}
+
+void FreeBuiltInSymbolTables()
+{
+	std::lock_guard<std::mutex> lock(builtInsMutex);
+
+	for(BuiltInSymbolTable *builtIns : builtInSymbolTables)
+	{
+		delete builtIns;
+	}
+	builtInSymbolTables.clear();
+
+	delete builtInsAllocator;
+	builtInsAllocator = nullptr;
+}
 }  // namespace
 
 //
@@ -165,37 +267,7 @@ bool TCompiler::compile(const char* const shaderStrings[],
 bool TCompiler::InitBuiltInSymbolTable(const ShBuiltInResources &resources)
 {
 	assert(symbolTable.isEmpty());
-	symbolTable.push();   // COMMON_BUILTINS
-	symbolTable.push();   // ESSL1_BUILTINS
-	symbolTable.push();   // ESSL3_BUILTINS
-
-	TPublicType integer;
-	integer.type = EbtInt;
-	integer.primarySize = 1;
-	integer.secondarySize = 1;
-	integer.array = false;
-
-	TPublicType floatingPoint;
-	floatingPoint.type = EbtFloat;
-	floatingPoint.primarySize = 1;
-	floatingPoint.secondarySize = 1;
-	floatingPoint.array = false;
-
-	switch(shaderType)
-	{
-	case GL_FRAGMENT_SHADER:
-		symbolTable.setDefaultPrecision(integer, EbpMedium);
-		break;
-	case GL_VERTEX_SHADER:
-		symbolTable.setDefaultPrecision(integer, EbpHigh);
-		symbolTable.setDefaultPrecision(floatingPoint, EbpHigh);
-		break;
-	default: assert(false && "Language not supported");
-	}
-
-	InsertBuiltInFunctions(shaderType, resources, symbolTable);
-
-	IdentifyBuiltIns(shaderType, resources, symbolTable);
+	symbolTable.shareBuiltIns(GetBuiltInSymbolTable(shaderType, resources));
 
 	return true;
 }
@@ -269,6 +341,8 @@ bool InitCompilerGlobals()
 
 void FreeCompilerGlobals()
 {
+	FreeBuiltInSymbolTables();
 	FreeParseContextIndex();
 	FreePoolIndex();
+	FreePoolPages();
 }
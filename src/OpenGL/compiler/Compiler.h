@@ -109,8 +109,8 @@ private:
 
 	unsigned int maxCallStackDepth;
 
-	// Built-in symbol table for the given language, spec, and resources.
-	// It is preserved from compile-to-compile.
+	// Symbol table whose built-in levels are shared with all compilers of
+	// the same language and resources. They are never popped.
 	TSymbolTable symbolTable;
 	// Built-in extensions with default behavior.
 	TExtensionBehavior extensionBehavior;
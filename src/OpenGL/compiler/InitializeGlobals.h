@@ -18,4 +18,7 @@
 bool InitializePoolIndex();
 void FreePoolIndex();
 
+// Returns the pages kept for reuse by pool allocators to the heap.
+void FreePoolPages();
+
 #endif // __INITIALIZE_GLOBALS_INCLUDED_
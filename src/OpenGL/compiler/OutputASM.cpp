@@ -275,6 +275,11 @@ namespace glsl
 		}
 	}
 
+	ShaderVariable::ShaderVariable(GLenum type, GLenum precision, const std::string& name, int arraySize, int registerIndex) :
+		type(type), precision(precision), name(name), arraySize(arraySize), registerIndex(registerIndex)
+	{
+	}
+
 	Uniform::Uniform(const TType& type, const std::string &name, int registerIndex, int blockId, const BlockMemberInfo& blockMemberInfo) :
 		ShaderVariable(type, name, registerIndex), blockId(blockId), blockInfo(blockMemberInfo)
 	{
@@ -58,6 +58,7 @@ namespace glsl
 	struct ShaderVariable
 	{
 		ShaderVariable(const TType& type, const std::string& name, int registerIndex);
+		ShaderVariable(GLenum type, GLenum precision, const std::string& name, int arraySize, int registerIndex);
 
 		GLenum type;
 		GLenum precision;
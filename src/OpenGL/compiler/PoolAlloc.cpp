@@ -20,11 +20,75 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <mutex>
+
 #include "InitializeGlobals.h"
 #include "osinclude.h"
 
 OS_TLSIndex PoolIndex = OS_INVALID_TLS_INDEX;
 
+#if !defined(SWIFTSHADER_TRANSLATOR_DISABLE_POOL_ALLOC)
+namespace
+{
+// A new allocator is created for every shader compile, so the single pages of
+// destroyed allocators are kept here for the next ones to reuse instead of
+// going back to the heap. They are linked through their first word.
+const size_t recycledPageSize = 8 * 1024;
+const size_t maxRecycledPages = 256;
+
+std::mutex recycledPagesMutex;
+void *recycledPages = nullptr;
+size_t recycledPageCount = 0;
+
+void *AcquireRecycledPage(size_t pageSize)
+{
+	if (pageSize != recycledPageSize)
+		return nullptr;
+
+	std::lock_guard<std::mutex> lock(recycledPagesMutex);
+
+	void *page = recycledPages;
+	if (page) {
+		recycledPages = *static_cast<void**>(page);
+		recycledPageCount--;
+	}
+
+	return page;
+}
+
+void ReleasePage(void *page, size_t pageSize)
+{
+	if (pageSize == recycledPageSize) {
+		std::lock_guard<std::mutex> lock(recycledPagesMutex);
+
+		if (recycledPageCount < maxRecycledPages) {
+			*static_cast<void**>(page) = recycledPages;
+			recycledPages = page;
+			recycledPageCount++;
+			return;
+		}
+	}
+
+	delete [] static_cast<char*>(page);
+}
+}  // anonymous namespace
+#endif
+
+void FreePoolPages()
+{
+#if !defined(SWIFTSHADER_TRANSLATOR_DISABLE_POOL_ALLOC)
+	std::lock_guard<std::mutex> lock(recycledPagesMutex);
+
+	while (recycledPages) {
+		void *next = *static_cast<void**>(recycledPages);
+		delete [] static_cast<char*>(recycledPages);
+		recycledPages = next;
+	}
+
+	recycledPageCount = 0;
+#endif
+}
+
 bool InitializePoolIndex()
 {
 	assert(PoolIndex == OS_INVALID_TLS_INDEX);
@@ -113,7 +177,10 @@ TPoolAllocator::~TPoolAllocator()
 	while (inUseList) {
 		tHeader* next = inUseList->nextPage;
 		inUseList->~tHeader();
-		delete [] reinterpret_cast<char*>(inUseList);
+		if (inUseList->pageCount > 1)
+			delete [] reinterpret_cast<char*>(inUseList);
+		else
+			ReleasePage(inUseList, pageSize);
 		inUseList = next;
 	}
 
@@ -123,7 +190,7 @@ TPoolAllocator::~TPoolAllocator()
 	//
 	while (freeList) {
 		tHeader* next = freeList->nextPage;
-		delete [] reinterpret_cast<char*>(freeList);
+		ReleasePage(freeList, pageSize);
 		freeList = next;
 	}
 #else  // !defined(SWIFTSHADER_TRANSLATOR_DISABLE_POOL_ALLOC)
@@ -302,6 +369,8 @@ void* TPoolAllocator::allocate(size_t numBytes)
 	if (freeList) {
 		memory = freeList;
 		freeList = freeList->nextPage;
+	} else if (void* page = AcquireRecycledPage(pageSize)) {
+		memory = static_cast<tHeader*>(page);
 	} else {
 		memory = reinterpret_cast<tHeader*>(::new char[pageSize]);
 		if (memory == 0)
@@ -115,7 +115,8 @@ private:
 // Page stacks are linked together with a simple header at the beginning
 // of each allocation obtained from the underlying OS.  Multi-page allocations
 // are returned to the OS.  Individual page allocations are kept for future
-// re-use.
+// re-use, and when the allocator is destroyed they are handed to the
+// allocators created after it, up to a process-wide limit.
 //
 // The "page size" used is not, nor must it match, the underlying OS
 // page size.  But, having it be about that size or equal to a set of
@@ -265,6 +266,12 @@ public:
 	pool_allocator(TPoolAllocator& a) : allocator(&a) { }
 	pool_allocator(const pool_allocator<T>& p) : allocator(p.allocator) { }
 
+	// Copies are allocated from the current pool rather than the one of the
+	// original, which may be shared and outlive the compile (e.g. built-ins).
+	pool_allocator select_on_container_copy_construction() const {
+		return GetGlobalPoolAllocator() ? pool_allocator() : *this;
+	}
+
 	template <class Other>
 	pool_allocator<T>& operator=(const pool_allocator<Other>& p) {
 	  allocator = p.allocator;
@@ -227,6 +227,24 @@ TSymbol *TSymbolTableLevel::find(const TString &name) const
 		return (*it).second;
 }
 
+void TSymbolTableLevel::evaluateLazyTypeInfo()
+{
+	for(auto &entry : level)
+	{
+		if(entry.second->isVariable())
+		{
+			TType &type = static_cast<TVariable*>(entry.second)->getType();
+			type.getMangledName();
+
+			if(type.getStruct())
+			{
+				type.getStruct()->objectSize();
+				type.getStruct()->deepestNesting();
+			}
+		}
+	}
+}
+
 TSymbol *TSymbolTable::find(const TString &name, int shaderVersion, bool *builtIn, bool *sameScope) const
 {
 	int level = currentLevel();
@@ -213,6 +213,10 @@ public:
 
 	TSymbol *find(const TString &name) const;
 
+	// Computes the names and sizes which the types of the level's variables
+	// otherwise evaluate lazily, so that the level can be shared read-only.
+	void evaluateLazyTypeInfo();
+
 	static int nextUniqueId()
 	{
 		return ++uniqueId;
@@ -300,7 +304,7 @@ class TSymbolTable
 {
 public:
 	TSymbolTable()
-		: mGlobalInvariant(false)
+		: mSharedBuiltIns(nullptr), mGlobalInvariant(false)
 	{
 		//
 		// The symbol table cannot be used until push() is called, but
@@ -318,6 +322,26 @@ public:
 	}
 
 	bool isEmpty() { return table.empty(); }
+
+	// Uses the built-in levels of 'builtIns' instead of inserting our own.
+	// They must outlive this table, and are never modified through it.
+	void shareBuiltIns(const TSymbolTable &builtIns)
+	{
+		assert(isEmpty());
+		table = builtIns.table;
+		precisionStack = builtIns.precisionStack;
+		mSharedBuiltIns = &builtIns;
+	}
+
+	// Must be called once all built-ins are inserted, before sharing them.
+	void finalizeBuiltIns()
+	{
+		for(int level = COMMON_BUILTINS; level <= LAST_BUILTIN_LEVEL; level++)
+		{
+			table[level]->evaluateLazyTypeInfo();
+		}
+	}
+
 	bool atBuiltInLevel() { return currentLevel() <= LAST_BUILTIN_LEVEL; }
 	bool atGlobalLevel() { return currentLevel() <= GLOBAL_LEVEL; }
 	void push()
@@ -512,7 +536,11 @@ public:
 	void setGlobalInvariant() { mGlobalInvariant = true; }
 	bool getGlobalInvariant() const { return mGlobalInvariant; }
 
-	bool hasUnmangledBuiltIn(const char *name) { return mUnmangledBuiltinNames.count(std::string(name)) > 0; }
+	bool hasUnmangledBuiltIn(const char *name) const
+	{
+		const std::set<std::string> &names = mSharedBuiltIns ? mSharedBuiltIns->mUnmangledBuiltinNames : mUnmangledBuiltinNames;
+		return names.count(std::string(name)) > 0;
+	}
 
 private:
 	// Used to insert unmangled functions to check redeclaration of built-ins in ESSL 3.00.
@@ -526,6 +554,7 @@ protected:
 	std::vector< PrecisionStackLevel > precisionStack;
 
 	std::set<std::string> mUnmangledBuiltinNames;
+	const TSymbolTable *mSharedBuiltIns;
 
 	std::set<std::string> mInvariantVaryings;
 	bool mGlobalInvariant;
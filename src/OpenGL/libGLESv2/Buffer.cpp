@@ -22,6 +22,13 @@
 #include "VertexDataManager.h"
 #include "IndexDataManager.h"
 
+#include <tuple>
+
+namespace
+{
+	enum { MAX_CACHED_INDEX_RANGES = 64 };
+}
+
 namespace es2
 {
 
@@ -34,6 +41,7 @@ Buffer::Buffer(GLuint name) : NamedObject(name)
 	mOffset = 0;
 	mLength = 0;
 	mAccess = 0;
+	mTransformFeedbackPending = false;
 }
 
 Buffer::~Buffer()
@@ -55,6 +63,9 @@ void Buffer::bufferData(const void *data, GLsizeiptr size, GLenum usage)
 	mSize = size;
 	mUsage = usage;
 
+	invalidateIndexRanges();
+	mTransformFeedbackPending = false;   // Draws still writing the previous contents don't affect the new ones
+
 	if(size > 0)
 	{
 		const int padding = 1024;   // For SIMD processing of vertices
@@ -80,6 +91,8 @@ void Buffer::bufferSubData(const void *data, GLsizeiptr size, GLintptr offset)
 		char *buffer = (char*)mContents->lock(sw::PUBLIC);
 		memcpy(buffer + offset, data, size);
 		mContents->unlock();
+
+		invalidateIndexRanges();
 	}
 }
 
@@ -103,6 +116,10 @@ bool Buffer::unmap()
 	{
 		mContents->unlock();
 	}
+	if(mAccess & GL_MAP_WRITE_BIT)
+	{
+		invalidateIndexRanges();
+	}
 	mIsMapped = false;
 	mOffset = 0;
 	mLength = 0;
@@ -115,4 +132,47 @@ sw::Resource *Buffer::getResource()
 	return mContents;
 }
 
+bool Buffer::IndexRangeKey::operator<(const IndexRangeKey &other) const
+{
+	return std::tie(type, offset, count, primitiveRestart) < std::tie(other.type, other.offset, other.count, other.primitiveRestart);
+}
+
+const Buffer::IndexRange *Buffer::getIndexRange(GLenum type, GLintptr offset, GLsizei count, bool primitiveRestart) const
+{
+	auto it = mIndexRanges.find({ type, offset, count, primitiveRestart });
+
+	return (it != mIndexRanges.end()) ? &it->second : nullptr;
+}
+
+const Buffer::IndexRange *Buffer::addIndexRange(GLenum type, GLintptr offset, GLsizei count, bool primitiveRestart, IndexRange &&range)
+{
+	// Buffers drawn with many different ranges aren't worth caching all of.
+	if(mIndexRanges.size() >= MAX_CACHED_INDEX_RANGES)
+	{
+		mIndexRanges.clear();
+	}
+
+	return &(mIndexRanges[{ type, offset, count, primitiveRestart }] = std::move(range));
+}
+
+void Buffer::invalidateIndexRanges()
+{
+	mIndexRanges.clear();
+}
+
+void Buffer::synchronizeTransformFeedback()
+{
+	if(mTransformFeedbackPending && mContents)
+	{
+		// The renderer holds a private lock on the buffer until the draws
+		// writing it are done.
+		mContents->lock(sw::PUBLIC);
+		mContents->unlock();
+
+		invalidateIndexRanges();
+	}
+
+	mTransformFeedbackPending = false;
+}
+
 }
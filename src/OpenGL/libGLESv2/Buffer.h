@@ -25,6 +25,7 @@
 #include <GLES2/gl2.h>
 
 #include <cstddef>
+#include <map>
 #include <vector>
 
 namespace es2
@@ -53,7 +54,39 @@ public:
 
 	sw::Resource *getResource();
 
+	// Range of the indices in a portion of the buffer, as used by an indexed
+	// draw. Ranges are cached until the contents of the buffer change.
+	struct IndexRange
+	{
+		GLuint minIndex;
+		GLuint maxIndex;
+		std::vector<GLsizei> restartIndices;   // Positions of the primitive restart indices
+	};
+
+	const IndexRange *getIndexRange(GLenum type, GLintptr offset, GLsizei count, bool primitiveRestart) const;
+	const IndexRange *addIndexRange(GLenum type, GLintptr offset, GLsizei count, bool primitiveRestart, IndexRange &&range);
+	void invalidateIndexRanges();
+
+	// Transform feedback writes the buffer asynchronously, while the draws
+	// execute, so cached index ranges can't be trusted until they complete.
+	void transformFeedbackStarted() { mTransformFeedbackPending = true; }
+	// Waits for the draws writing the buffer through transform feedback.
+	void synchronizeTransformFeedback();
+
 private:
+	struct IndexRangeKey
+	{
+		bool operator<(const IndexRangeKey &other) const;
+
+		GLenum type;
+		GLintptr offset;
+		GLsizei count;
+		bool primitiveRestart;
+	};
+
+	std::map<IndexRangeKey, IndexRange> mIndexRanges;
+	bool mTransformFeedbackPending;
+
 	sw::Resource *mContents;
 	size_t mSize;
 	GLenum mUsage;
@@ -2356,8 +2356,7 @@ template<typename T> bool Context::getIntegerv(GLenum pname, T *params) const
 		*params = mState.pixelUnpackBuffer.name();
 		return true;
 	case GL_PROGRAM_BINARY_FORMATS:
-		// Since NUM_PROGRAM_BINARY_FORMATS is 0, the input
-		// should be a 0 sized array, so don't write to params
+		*params = PROGRAM_BINARY_FORMAT_SWIFTSHADER;
 		return true;
 	case GL_READ_BUFFER:
 		{
@@ -3377,6 +3376,12 @@ void Context::readPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum
 	GLsizei outputWidth = (mState.packParameters.rowLength > 0) ? mState.packParameters.rowLength : width;
 	GLsizei outputPitch = gl::ComputePitch(outputWidth, format, type, mState.packParameters.alignment);
 	GLsizei outputHeight = (mState.packParameters.imageHeight == 0) ? height : mState.packParameters.imageHeight;
+
+	if(getPixelPackBuffer())
+	{
+		getPixelPackBuffer()->invalidateIndexRanges();
+	}
+
 	pixels = getPixelPackBuffer() ? (unsigned char*)getPixelPackBuffer()->data() + (ptrdiff_t)pixels : (unsigned char*)pixels;
 	pixels = ((char*)pixels) + gl::ComputePackingOffset(format, type, outputWidth, outputHeight, mState.packParameters);
 
@@ -4508,6 +4513,7 @@ const GLubyte *Context::getExtensions(GLuint index, GLuint *numExt) const
 		"GL_OES_element_index_uint",
 		"GL_OES_fbo_render_mipmap",
 		"GL_OES_framebuffer_object",
+		"GL_OES_get_program_binary",
 		"GL_OES_packed_depth_stencil",
 		"GL_OES_rgb8_rgba8",
 		"GL_OES_standard_derivatives",
@@ -104,10 +104,14 @@ enum
 	MAX_TRANSFORM_FEEDBACK_SEPARATE_ATTRIBS = 4,
 	MAX_UNIFORM_BUFFER_BINDINGS = sw::MAX_UNIFORM_BUFFER_BINDINGS,
 	UNIFORM_BUFFER_OFFSET_ALIGNMENT = 4,
-	NUM_PROGRAM_BINARY_FORMATS = 0,
+	NUM_PROGRAM_BINARY_FORMATS = 1,
 	MAX_SHADER_CALL_STACK_SIZE = sw::MAX_SHADER_CALL_STACK_SIZE,
 };
 
+// Format of the binaries returned by glGetProgramBinary. This isn't a
+// registered enum, since applications only pass it back to glProgramBinary.
+const GLenum PROGRAM_BINARY_FORMAT_SWIFTSHADER = 0x9F00;
+
 const GLenum compressedTextureFormats[] =
 {
 	GL_ETC1_RGB8_OES,
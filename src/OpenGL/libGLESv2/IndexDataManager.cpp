@@ -20,9 +20,14 @@
 #include "Buffer.h"
 #include "common/debug.h"
 
+#include <limits.h>
 #include <string.h>
 #include <algorithm>
 
+#if defined(__i386__) || defined(__x86_64__)
+	#include <emmintrin.h>
+#endif
+
 namespace
 {
 	enum { INITIAL_INDEX_BUFFER_SIZE = 4096 * sizeof(GLuint) };
@@ -193,23 +198,108 @@ void copyIndices(GLenum mode, GLenum type, const std::vector<GLsizei>& restartIn
 }
 
 template<class IndexType>
-void computeRange(const IndexType *indices, GLsizei count, GLuint *minIndex, GLuint *maxIndex, std::vector<GLsizei>* restartIndices)
+void computeRange(const IndexType *indices, GLsizei begin, GLsizei end, GLuint &minIndex, GLuint &maxIndex, std::vector<GLsizei>* restartIndices)
 {
-	*maxIndex = 0;
-	*minIndex = MAX_ELEMENTS_INDICES;
-
-	for(GLsizei i = 0; i < count; i++)
+	for(GLsizei i = begin; i < end; i++)
 	{
 		if(restartIndices && indices[i] == IndexType(-1))
 		{
 			restartIndices->push_back(i);
 			continue;
 		}
-		if(*minIndex > indices[i]) *minIndex = indices[i];
-		if(*maxIndex < indices[i]) *maxIndex = indices[i];
+		if(minIndex > indices[i]) minIndex = indices[i];
+		if(maxIndex < indices[i]) maxIndex = indices[i];
 	}
 }
 
+#if defined(__i386__) || defined(__x86_64__)
+// SSE2 only has signed 16-bit and unsigned 8-bit min/max, so wider indices
+// are biased to make signed comparisons order them as unsigned values.
+template<class IndexType>
+struct IndexLanes;
+
+template<>
+struct IndexLanes<GLubyte>
+{
+	static __m128i bias(__m128i x) { return x; }
+	static __m128i min(__m128i x, __m128i y) { return _mm_min_epu8(x, y); }
+	static __m128i max(__m128i x, __m128i y) { return _mm_max_epu8(x, y); }
+	static __m128i restart(__m128i x) { return _mm_cmpeq_epi8(x, _mm_set1_epi8(-1)); }
+};
+
+template<>
+struct IndexLanes<GLushort>
+{
+	static __m128i bias(__m128i x) { return _mm_xor_si128(x, _mm_set1_epi16(-0x8000)); }
+	static __m128i min(__m128i x, __m128i y) { return _mm_min_epi16(x, y); }
+	static __m128i max(__m128i x, __m128i y) { return _mm_max_epi16(x, y); }
+	static __m128i restart(__m128i x) { return _mm_cmpeq_epi16(x, _mm_set1_epi16(-1)); }
+};
+
+template<>
+struct IndexLanes<GLuint>
+{
+	static __m128i bias(__m128i x) { return _mm_xor_si128(x, _mm_set1_epi32(INT_MIN)); }
+	static __m128i min(__m128i x, __m128i y) { return select(_mm_cmpgt_epi32(x, y), y, x); }
+	static __m128i max(__m128i x, __m128i y) { return select(_mm_cmpgt_epi32(x, y), x, y); }
+	static __m128i restart(__m128i x) { return _mm_cmpeq_epi32(x, _mm_set1_epi32(-1)); }
+
+	static __m128i select(__m128i mask, __m128i x, __m128i y) { return _mm_or_si128(_mm_and_si128(mask, x), _mm_andnot_si128(mask, y)); }
+};
+#endif
+
+template<class IndexType>
+void computeRange(const IndexType *indices, GLsizei count, GLuint *minIndex, GLuint *maxIndex, std::vector<GLsizei>* restartIndices)
+{
+	*maxIndex = 0;
+	*minIndex = MAX_ELEMENTS_INDICES;
+
+	GLsizei i = 0;
+
+	#if defined(__i386__) || defined(__x86_64__)
+		typedef IndexLanes<IndexType> Lanes;
+		const GLsizei laneCount = sizeof(__m128i) / sizeof(IndexType);
+
+		__m128i minimum = Lanes::bias(_mm_set1_epi8(-1));
+		__m128i maximum = Lanes::bias(_mm_setzero_si128());
+		bool vectorized = false;
+
+		for(; i + laneCount <= count; i += laneCount)
+		{
+			__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(indices + i));
+
+			// Blocks containing primitive restart indices are rare, so let
+			// the scalar loop record their positions.
+			if(restartIndices && _mm_movemask_epi8(Lanes::restart(x)) != 0)
+			{
+				computeRange(indices, i, i + laneCount, *minIndex, *maxIndex, restartIndices);
+				continue;
+			}
+
+			x = Lanes::bias(x);
+			minimum = Lanes::min(minimum, x);
+			maximum = Lanes::max(maximum, x);
+			vectorized = true;
+		}
+
+		if(vectorized)
+		{
+			IndexType minimums[laneCount];
+			IndexType maximums[laneCount];
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(minimums), Lanes::bias(minimum));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(maximums), Lanes::bias(maximum));
+
+			for(GLsizei lane = 0; lane < laneCount; lane++)
+			{
+				if(*minIndex > minimums[lane]) *minIndex = minimums[lane];
+				if(*maxIndex < maximums[lane]) *maxIndex = maximums[lane];
+			}
+		}
+	#endif
+
+	computeRange(indices, i, count, *minIndex, *maxIndex, restartIndices);
+}
+
 void computeRange(GLenum type, const void *indices, GLsizei count, GLuint *minIndex, GLuint *maxIndex, std::vector<GLsizei>* restartIndices)
 {
 	if(type == GL_UNSIGNED_BYTE)
@@ -286,22 +376,36 @@ GLenum IndexDataManager::prepareIndexData(GLenum mode, GLenum type, GLuint start
 			return GL_INVALID_OPERATION;
 		}
 
+		// Indices written by transform feedback are only valid once the draws
+		// writing them are done.
+		buffer->synchronizeTransformFeedback();
+
 		indices = static_cast<const GLubyte*>(buffer->data()) + offset;
 	}
 
-	std::vector<GLsizei>* restartIndices = primitiveRestart ? new std::vector<GLsizei>() : nullptr;
-	computeRange(type, indices, count, &translated->minIndex, &translated->maxIndex, restartIndices);
+	// Static element buffers are typically drawn with the same ranges every
+	// frame, so their index ranges are only computed once.
+	Buffer::IndexRange computedRange;
+	const Buffer::IndexRange *range = buffer ? buffer->getIndexRange(type, offset, count, primitiveRestart) : nullptr;
+
+	if(!range)
+	{
+		computeRange(type, indices, count, &computedRange.minIndex, &computedRange.maxIndex, primitiveRestart ? &computedRange.restartIndices : nullptr);
+		range = buffer ? buffer->addIndexRange(type, offset, count, primitiveRestart, std::move(computedRange)) : &computedRange;
+	}
+
+	translated->minIndex = range->minIndex;
+	translated->maxIndex = range->maxIndex;
 
 	StreamingIndexBuffer *streamingBuffer = mStreamingBuffer;
 
 	sw::Resource *staticBuffer = buffer ? buffer->getResource() : NULL;
 
-	if(restartIndices)
+	if(primitiveRestart)
 	{
-		int vertexPerPrimitive = recomputePrimitiveCount(mode, count, *restartIndices, &translated->primitiveCount);
+		int vertexPerPrimitive = recomputePrimitiveCount(mode, count, range->restartIndices, &translated->primitiveCount);
 		if(vertexPerPrimitive == -1)
 		{
-			delete restartIndices;
 			return GL_INVALID_ENUM;
 		}
 
@@ -313,17 +417,15 @@ GLenum IndexDataManager::prepareIndexData(GLenum mode, GLenum type, GLuint start
 
 		if(output == NULL)
 		{
-			delete restartIndices;
 			ERR("Failed to map index buffer.");
 			return GL_OUT_OF_MEMORY;
 		}
 
-		copyIndices(mode, type, *restartIndices, indices, count, output);
+		copyIndices(mode, type, range->restartIndices, indices, count, output);
 		streamingBuffer->unmap();
 
 		translated->indexBuffer = streamingBuffer->getResource();
 		translated->indexOffset = static_cast<unsigned int>(streamOffset);
-		delete restartIndices;
 	}
 	else if(staticBuffer)
 	{
@@ -23,6 +23,8 @@
 #include "TransformFeedback.h"
 #include "utilities.h"
 #include "common/debug.h"
+#include "Common/BinaryStream.hpp"
+#include "Common/Version.h"
 #include "Shader/PixelShader.hpp"
 #include "Shader/VertexShader.hpp"
 
@@ -54,10 +56,15 @@ namespace es2
 	}
 
 	Uniform::Uniform(const glsl::Uniform &uniform, const BlockInfo &blockInfo)
-	 : type(uniform.type), precision(uniform.precision), name(uniform.name),
-	   arraySize(uniform.arraySize), blockInfo(blockInfo), fields(uniform.fields)
+	 : Uniform(uniform.type, uniform.precision, uniform.name, uniform.arraySize, blockInfo, uniform.fields)
 	{
-		if((blockInfo.index == -1) && uniform.fields.empty())
+	}
+
+	Uniform::Uniform(GLenum type, GLenum precision, const std::string &name, unsigned int arraySize,
+	                 const BlockInfo &blockInfo, const std::vector<glsl::ShaderVariable> &fields)
+	 : type(type), precision(precision), name(name), arraySize(arraySize), blockInfo(blockInfo), fields(fields)
+	{
+		if((blockInfo.index == -1) && fields.empty())
 		{
 			size_t bytes = UniformTypeSize(type) * size();
 			data = new unsigned char[bytes];
@@ -245,24 +252,21 @@ namespace es2
 			std::string baseName(name);
 			unsigned int subscript = GL_INVALID_INDEX;
 			baseName = ParseUniformName(baseName, &subscript);
-			for(auto const &varying : fragmentShader->varyings)
+			for(auto const &output : fragmentOutputs)
 			{
-				if(varying.qualifier == EvqFragmentOut)
+				if(output.name == baseName)
 				{
-					if(varying.name == baseName)
-					{
-						ASSERT(varying.registerIndex >= 0);
+					ASSERT(output.registerIndex >= 0);
 
-						if(subscript == GL_INVALID_INDEX)   // No subscript
-						{
-							return varying.registerIndex;
-						}
+					if(subscript == GL_INVALID_INDEX)   // No subscript
+					{
+						return output.registerIndex;
+					}
 
-						int rowCount = VariableRowCount(varying.type);
-						int colCount = VariableColumnCount(varying.type);
+					int rowCount = VariableRowCount(output.type);
+					int colCount = VariableColumnCount(output.type);
 
-						return varying.registerIndex + (rowCount > 1 ? colCount * subscript : subscript);
-					}
+					return output.registerIndex + (rowCount > 1 ? colCount * subscript : subscript);
 				}
 			}
 		}
@@ -1246,6 +1250,7 @@ namespace es2
 				int nbComponentsPerReg = rowCount > 1 ? rowCount : colCount;
 				int componentStride = rowCount * colCount * size;
 				int baseOffset = transformFeedback->vertexOffset() * componentStride * sizeof(float);
+				transformFeedbackBuffers[index].get()->transformFeedbackStarted();
 				device->VertexProcessor::setTransformFeedbackBuffer(index,
 					transformFeedbackBuffers[index].get()->getResource(),
 					transformFeedbackBuffers[index].getOffset() + baseOffset,
@@ -1264,6 +1269,10 @@ namespace es2
 			sw::Resource* resource = transformFeedbackBuffers[0].get() ?
 			                         transformFeedbackBuffers[0].get()->getResource() :
 			                         nullptr;
+			if(transformFeedbackBuffers[0].get())
+			{
+				transformFeedbackBuffers[0].get()->transformFeedbackStarted();
+			}
 			int componentStride = static_cast<int>(totalLinkedVaryingsComponents);
 			int baseOffset = transformFeedbackBuffers[0].getOffset() + (transformFeedback->vertexOffset() * componentStride * sizeof(float));
 			maxVaryings = sw::min(maxVaryings, (unsigned int)sw::MAX_TRANSFORM_FEEDBACK_INTERLEAVED_COMPONENTS);
@@ -1577,6 +1586,14 @@ namespace es2
 			return;
 		}
 
+		for(auto const &varying : fragmentShader->varyings)
+		{
+			if(varying.qualifier == EvqFragmentOut)
+			{
+				fragmentOutputs.push_back(varying);
+			}
+		}
+
 		linked = true;   // Success
 	}
 
@@ -2662,6 +2679,7 @@ namespace es2
 
 		uniformIndex.clear();
 		transformFeedbackLinkedVaryings.clear();
+		fragmentOutputs.clear();
 
 		delete[] infoLog;
 		infoLog = 0;
@@ -2679,10 +2697,516 @@ namespace es2
 		return validated;
 	}
 
+	namespace
+	{
+		// Program binaries start with this magic number, which also tells apart
+		// binaries from hosts of a different endianness.
+		const uint32_t PROGRAM_BINARY_MAGIC = 0x53575042;   // 'SWPB'
+
+		// Must be incremented whenever the layout of program binaries changes.
+		const uint32_t PROGRAM_BINARY_VERSION = 1;
+
+		// Program binaries contain the shader instructions in the host's memory
+		// layout, so they are only valid for builds which share it.
+		uint32_t layoutFingerprint()
+		{
+			const uint32_t sizes[] =
+			{
+				sizeof(void*),
+				sizeof(sw::Shader::Instruction),
+				sizeof(sw::Shader::DestinationParameter),
+				sizeof(sw::Shader::SourceParameter),
+				sizeof(sw::Shader::Semantic),
+				sw::MAX_VERTEX_INPUTS,
+				sw::MAX_VERTEX_OUTPUTS,
+				sw::MAX_FRAGMENT_INPUTS,
+				MAX_VERTEX_ATTRIBS,
+				MAX_TEXTURE_IMAGE_UNITS,
+				MAX_VERTEX_TEXTURE_IMAGE_UNITS,
+			};
+
+			uint32_t hash = 2166136261u;
+
+			for(uint32_t size : sizes)
+			{
+				hash = (hash ^ size) * 16777619u;
+			}
+
+			return hash;
+		}
+
+		// FNV-1a hash, to reject binaries corrupted by the application's cache.
+		uint64_t checksum(const unsigned char *data, size_t size)
+		{
+			uint64_t hash = 14695981039346656037ull;
+
+			for(size_t i = 0; i < size; i++)
+			{
+				hash = (hash ^ data[i]) * 1099511628211ull;
+			}
+
+			return hash;
+		}
+
+		void writeFields(sw::BinaryOutputStream &stream, const std::vector<glsl::ShaderVariable> &fields)
+		{
+			stream.write<uint32_t>(static_cast<uint32_t>(fields.size()));
+
+			for(const auto &field : fields)
+			{
+				stream.write(field.type);
+				stream.write(field.precision);
+				stream.write(field.name);
+				stream.write(field.arraySize);
+				stream.write(field.registerIndex);
+				writeFields(stream, field.fields);
+			}
+		}
+
+		// The compiler limits the nesting of structures to 4 levels, so deeper
+		// fields can only come from a corrupt binary.
+		enum { MAX_FIELD_NESTING = 8 };
+
+		std::vector<glsl::ShaderVariable> readFields(sw::BinaryInputStream &stream, int depth = 0)
+		{
+			std::vector<glsl::ShaderVariable> fields;
+			uint32_t count = stream.read<uint32_t>();
+
+			if(count > 0 && depth >= MAX_FIELD_NESTING)
+			{
+				stream.fail();
+				return fields;
+			}
+
+			for(uint32_t i = 0; i < count && !stream.error(); i++)
+			{
+				GLenum type = stream.read<GLenum>();
+				GLenum precision = stream.read<GLenum>();
+				std::string name = stream.readString();
+				int arraySize = stream.read<int>();
+				int registerIndex = stream.read<int>();
+
+				fields.push_back(glsl::ShaderVariable(type, precision, name, arraySize, registerIndex));
+				fields.back().fields = readFields(stream, depth + 1);
+			}
+
+			return fields;
+		}
+	}
+
 	GLint Program::getBinaryLength() const
 	{
-		UNIMPLEMENTED();
-		return 0;
+		if(!linked)
+		{
+			return 0;
+		}
+
+		sw::BinaryOutputStream stream;
+		writeBinary(stream);
+
+		return static_cast<GLint>(stream.getData().size());
+	}
+
+	bool Program::getBinary(GLsizei bufSize, GLsizei *length, GLenum *binaryFormat, void *binary) const
+	{
+		sw::BinaryOutputStream stream;
+		writeBinary(stream);
+
+		const std::vector<unsigned char> &data = stream.getData();
+
+		if(data.size() > static_cast<size_t>(bufSize))
+		{
+			if(length)
+			{
+				*length = 0;
+			}
+
+			return false;
+		}
+
+		memcpy(binary, data.data(), data.size());
+
+		if(length)
+		{
+			*length = static_cast<GLsizei>(data.size());
+		}
+
+		*binaryFormat = PROGRAM_BINARY_FORMAT_SWIFTSHADER;
+
+		return true;
+	}
+
+	// Restores the linked state of the program from a binary returned by
+	// getBinary(), which skips compiling and linking its shaders. The Reactor
+	// routines are generated from the restored shaders on first use, like for
+	// a newly linked program.
+	void Program::loadBinary(const void *binary, GLsizei length)
+	{
+		unlink();
+
+		resetUniformBlockBindings();
+
+		const unsigned char *data = static_cast<const unsigned char*>(binary);
+		size_t size = static_cast<size_t>(length);
+
+		if(size < sizeof(uint64_t))
+		{
+			appendToInfoLog("Invalid program binary");
+			return;
+		}
+
+		uint64_t storedChecksum;
+		memcpy(&storedChecksum, data + size - sizeof(uint64_t), sizeof(uint64_t));
+
+		if(storedChecksum != checksum(data, size - sizeof(uint64_t)))
+		{
+			appendToInfoLog("Corrupted program binary");
+			return;
+		}
+
+		sw::BinaryInputStream stream(data, size - sizeof(uint64_t));
+
+		if(stream.read<uint32_t>() != PROGRAM_BINARY_MAGIC ||
+		   stream.read<uint32_t>() != PROGRAM_BINARY_VERSION ||
+		   stream.read<uint32_t>() != layoutFingerprint() ||
+		   stream.readString() != VERSION_STRING)
+		{
+			appendToInfoLog("Program binary is incompatible with this version of SwiftShader");
+			return;
+		}
+
+		if(!readBinary(stream) || stream.error() || !stream.endOfStream())
+		{
+			unlink();
+			appendToInfoLog("Invalid program binary");
+			return;
+		}
+
+		linked = true;
+	}
+
+	void Program::writeBinary(sw::BinaryOutputStream &stream) const
+	{
+		stream.write(PROGRAM_BINARY_MAGIC);
+		stream.write(PROGRAM_BINARY_VERSION);
+		stream.write(layoutFingerprint());
+		stream.write(std::string(VERSION_STRING));
+
+		vertexBinary->write(stream);
+		pixelBinary->write(stream);
+
+		stream.write<uint32_t>(static_cast<uint32_t>(linkedAttribute.size()));
+		for(const auto &attribute : linkedAttribute)
+		{
+			stream.write(attribute.type);
+			stream.write(attribute.name);
+			stream.write(attribute.arraySize);
+			stream.write(attribute.layoutLocation);
+			stream.write(attribute.registerIndex);
+		}
+
+		stream.write<uint32_t>(static_cast<uint32_t>(linkedAttributeLocation.size()));
+		for(const auto &location : linkedAttributeLocation)
+		{
+			stream.write(location.first);
+			stream.write(location.second);
+		}
+
+		stream.write(attributeStream);
+		stream.write(samplersPS);
+		stream.write(samplersVS);
+
+		stream.write<uint32_t>(static_cast<uint32_t>(uniforms.size()));
+		for(const auto &uniform : uniforms)
+		{
+			stream.write(uniform->type);
+			stream.write(uniform->precision);
+			stream.write(uniform->name);
+			stream.write(uniform->arraySize);
+			stream.write(uniform->blockInfo);
+			writeFields(stream, uniform->fields);
+			stream.write(uniform->psRegisterIndex);
+			stream.write(uniform->vsRegisterIndex);
+		}
+
+		stream.write<uint32_t>(static_cast<uint32_t>(uniformIndex.size()));
+		for(const auto &location : uniformIndex)
+		{
+			stream.write(location.name);
+			stream.write(location.element);
+			stream.write(location.index);
+		}
+
+		stream.write<uint32_t>(static_cast<uint32_t>(uniformBlocks.size()));
+		for(const auto &block : uniformBlocks)
+		{
+			stream.write(block->name);
+			stream.write(block->elementIndex);
+			stream.write(block->dataSize);
+			stream.write<uint32_t>(static_cast<uint32_t>(block->memberUniformIndexes.size()));
+			for(unsigned int index : block->memberUniformIndexes)
+			{
+				stream.write(index);
+			}
+			stream.write(block->psRegisterIndex);
+			stream.write(block->vsRegisterIndex);
+		}
+
+		stream.write<uint32_t>(static_cast<uint32_t>(transformFeedbackLinkedVaryings.size()));
+		for(const auto &varying : transformFeedbackLinkedVaryings)
+		{
+			stream.write(varying.name);
+			stream.write(varying.type);
+			stream.write(varying.size);
+			stream.write(varying.reg);
+			stream.write(varying.col);
+		}
+
+		stream.write(transformFeedbackBufferMode);
+		stream.write<uint64_t>(totalLinkedVaryingsComponents);
+		writeFields(stream, fragmentOutputs);
+
+		stream.write(checksum(stream.getData().data(), stream.getData().size()));
+	}
+
+	// Deserializes the state written by writeBinary(). The binary's checksum only
+	// guards against corruption, so every index and size which is later used to
+	// access an array or allocate memory is checked against the limits that
+	// linking enforces. Returns false for a binary which linking can't produce.
+	bool Program::readBinary(sw::BinaryInputStream &stream)
+	{
+		vertexBinary = new sw::VertexShader(stream);
+		pixelBinary = new sw::PixelShader(stream);
+
+		if(stream.error())
+		{
+			return false;
+		}
+
+		uint32_t attributeCount = stream.read<uint32_t>();
+		for(uint32_t i = 0; i < attributeCount && !stream.error(); i++)
+		{
+			GLenum type = stream.read<GLenum>();
+			std::string name = stream.readString();
+			int arraySize = stream.read<int>();
+			int layoutLocation = stream.read<int>();
+			int registerIndex = stream.read<int>();
+
+			if(arraySize < 0 || arraySize > MAX_VERTEX_ATTRIBS ||
+			   layoutLocation < -1 || layoutLocation >= MAX_VERTEX_ATTRIBS ||
+			   registerIndex < -1 || registerIndex >= MAX_VERTEX_ATTRIBS)
+			{
+				return false;
+			}
+
+			linkedAttribute.push_back(glsl::Attribute(type, name, arraySize, layoutLocation, registerIndex));
+		}
+
+		uint32_t locationCount = stream.read<uint32_t>();
+		for(uint32_t i = 0; i < locationCount && !stream.error(); i++)
+		{
+			std::string name = stream.readString();
+			GLuint location = stream.read<GLuint>();
+
+			if(location >= MAX_VERTEX_ATTRIBS)
+			{
+				return false;
+			}
+
+			linkedAttributeLocation[name] = location;
+		}
+
+		stream.read(attributeStream);
+		stream.read(samplersPS);
+		stream.read(samplersVS);
+
+		for(int attributeStreamIndex : attributeStream)
+		{
+			if(attributeStreamIndex < -1 || attributeStreamIndex >= MAX_VERTEX_ATTRIBS)
+			{
+				return false;
+			}
+		}
+
+		auto validSamplers = [](const Sampler *samplers, int count)
+		{
+			for(int i = 0; i < count; i++)
+			{
+				if(samplers[i].active &&
+				   (samplers[i].logicalTextureUnit < 0 || samplers[i].logicalTextureUnit >= MAX_COMBINED_TEXTURE_IMAGE_UNITS ||
+				    samplers[i].textureType < 0 || samplers[i].textureType >= TEXTURE_TYPE_COUNT))
+				{
+					return false;
+				}
+			}
+
+			return true;
+		};
+
+		if(!validSamplers(samplersPS, MAX_TEXTURE_IMAGE_UNITS) || !validSamplers(samplersVS, MAX_VERTEX_TEXTURE_IMAGE_UNITS))
+		{
+			return false;
+		}
+
+		uint32_t uniformCount = stream.read<uint32_t>();
+		for(uint32_t i = 0; i < uniformCount && !stream.error(); i++)
+		{
+			GLenum type = stream.read<GLenum>();
+			GLenum precision = stream.read<GLenum>();
+			std::string name = stream.readString();
+			unsigned int arraySize = stream.read<unsigned int>();
+			Uniform::BlockInfo blockInfo = stream.read<Uniform::BlockInfo>();
+			std::vector<glsl::ShaderVariable> fields = readFields(stream);
+
+			short psRegisterIndex = stream.read<short>();
+			short vsRegisterIndex = stream.read<short>();
+
+			if(!IsSamplerUniform(type) && UniformTypeSize(type) == 0 && fields.empty())
+			{
+				return false;
+			}
+
+			// The array size sets the size of the uniform's storage, which linking
+			// limits through the register counts.
+			if(arraySize > MAX_UNIFORM_BLOCK_SIZE || blockInfo.index < -1 || psRegisterIndex < -1 || vsRegisterIndex < -1)
+			{
+				return false;
+			}
+
+			Uniform *uniform = new Uniform(type, precision, name, arraySize, blockInfo, fields);
+			uniforms.push_back(uniform);
+
+			uniform->psRegisterIndex = psRegisterIndex;
+			uniform->vsRegisterIndex = vsRegisterIndex;
+
+			if(blockInfo.index == -1 && fields.empty())
+			{
+				int registerCount = uniform->registerCount();
+				int psRegisters = IsSamplerUniform(type) ? MAX_TEXTURE_IMAGE_UNITS : MAX_FRAGMENT_UNIFORM_VECTORS;
+				int vsRegisters = IsSamplerUniform(type) ? MAX_VERTEX_TEXTURE_IMAGE_UNITS : MAX_VERTEX_UNIFORM_VECTORS;
+
+				if((psRegisterIndex != -1 && psRegisterIndex + registerCount > psRegisters) ||
+				   (vsRegisterIndex != -1 && vsRegisterIndex + registerCount > vsRegisters))
+				{
+					return false;
+				}
+			}
+		}
+
+		uint32_t locationIndexCount = stream.read<uint32_t>();
+		for(uint32_t i = 0; i < locationIndexCount && !stream.error(); i++)
+		{
+			std::string name = stream.readString();
+			unsigned int element = stream.read<unsigned int>();
+			unsigned int index = stream.read<unsigned int>();
+
+			// Members of uniform blocks have locations without a uniform.
+			if(index != GL_INVALID_INDEX && (index >= uniforms.size() || element >= static_cast<unsigned int>(uniforms[index]->size())))
+			{
+				return false;
+			}
+
+			uniformIndex.push_back(UniformLocation(name, element, index));
+		}
+
+		uint32_t blockCount = stream.read<uint32_t>();
+		if(blockCount > MAX_UNIFORM_BUFFER_BINDINGS)
+		{
+			return false;
+		}
+
+		int psBlockCount = 0;
+		int vsBlockCount = 0;
+		for(uint32_t i = 0; i < blockCount && !stream.error(); i++)
+		{
+			std::string name = stream.readString();
+			unsigned int elementIndex = stream.read<unsigned int>();
+			unsigned int dataSize = stream.read<unsigned int>();
+
+			std::vector<unsigned int> memberUniformIndexes;
+			uint32_t memberCount = stream.read<uint32_t>();
+			for(uint32_t j = 0; j < memberCount && !stream.error(); j++)
+			{
+				unsigned int index = stream.read<unsigned int>();
+
+				if(index >= uniforms.size())
+				{
+					return false;
+				}
+
+				memberUniformIndexes.push_back(index);
+			}
+
+			UniformBlock *block = new UniformBlock(name, elementIndex, dataSize, memberUniformIndexes);
+			uniformBlocks.push_back(block);
+
+			stream.read(block->psRegisterIndex);
+			stream.read(block->vsRegisterIndex);
+
+			if(block->isReferencedByFragmentShader())
+			{
+				psBlockCount++;
+
+				if(block->psRegisterIndex >= MAX_FRAGMENT_UNIFORM_BLOCKS)
+				{
+					return false;
+				}
+			}
+
+			if(block->isReferencedByVertexShader())
+			{
+				vsBlockCount++;
+
+				if(block->vsRegisterIndex >= MAX_VERTEX_UNIFORM_BLOCKS)
+				{
+					return false;
+				}
+			}
+		}
+
+		if(psBlockCount > MAX_FRAGMENT_UNIFORM_BLOCKS || vsBlockCount > MAX_VERTEX_UNIFORM_BLOCKS)
+		{
+			return false;
+		}
+
+		for(const auto &uniform : uniforms)
+		{
+			if(uniform->blockInfo.index >= static_cast<int>(blockCount))
+			{
+				return false;
+			}
+		}
+
+		uint32_t varyingCount = stream.read<uint32_t>();
+		for(uint32_t i = 0; i < varyingCount && !stream.error(); i++)
+		{
+			std::string name = stream.readString();
+			GLenum type = stream.read<GLenum>();
+			GLsizei size = stream.read<GLsizei>();
+			int reg = stream.read<int>();
+			int col = stream.read<int>();
+
+			if(size < 1 || reg < 0 || col < 0 || col >= 4 ||
+			   reg + static_cast<int64_t>(size) * VariableRegisterCount(type) > sw::MAX_VERTEX_OUTPUTS)
+			{
+				return false;
+			}
+
+			transformFeedbackLinkedVaryings.push_back(LinkedVarying(name, type, size, reg, col));
+		}
+
+		stream.read(transformFeedbackBufferMode);
+		uint64_t totalComponents = stream.read<uint64_t>();
+		fragmentOutputs = readFields(stream);
+
+		if(totalComponents > sw::MAX_TRANSFORM_FEEDBACK_INTERLEAVED_COMPONENTS)
+		{
+			return false;
+		}
+
+		totalLinkedVaryingsComponents = static_cast<size_t>(totalComponents);
+
+		return true;
 	}
 
 	void Program::release()
@@ -28,6 +28,12 @@
 #include <set>
 #include <map>
 
+namespace sw
+{
+	class BinaryOutputStream;
+	class BinaryInputStream;
+}
+
 namespace es2
 {
 	class Device;
@@ -40,6 +46,7 @@ namespace es2
 	{
 		struct BlockInfo
 		{
+			BlockInfo() = default;
 			BlockInfo(const glsl::Uniform& uniform, int blockIndex);
 
 			int index = -1;
@@ -50,6 +57,8 @@ namespace es2
 		};
 
 		Uniform(const glsl::Uniform &uniform, const BlockInfo &blockInfo);
+		Uniform(GLenum type, GLenum precision, const std::string &name, unsigned int arraySize,
+		        const BlockInfo &blockInfo, const std::vector<glsl::ShaderVariable> &fields);
 
 		~Uniform();
 
@@ -219,6 +228,8 @@ namespace es2
 		bool getBinaryRetrievableHint() const { return retrievableBinary; }
 		void setBinaryRetrievable(bool retrievable) { retrievableBinary = retrievable; }
 		GLint getBinaryLength() const;
+		bool getBinary(GLsizei bufSize, GLsizei *length, GLenum *binaryFormat, void *binary) const;
+		void loadBinary(const void *binary, GLsizei length);
 
 	private:
 		void unlink();
@@ -271,6 +282,9 @@ namespace es2
 		bool setUniformiv(GLint location, GLsizei count, const GLint *v, int numElements);
 		bool setUniformuiv(GLint location, GLsizei count, const GLuint *v, int numElements);
 
+		void writeBinary(sw::BinaryOutputStream &stream) const;
+		bool readBinary(sw::BinaryInputStream &stream);
+
 		void appendToInfoLog(const char *info, ...);
 		void resetInfoLog();
 
@@ -313,6 +327,7 @@ namespace es2
 		UniformBlockArray uniformBlocks;
 		typedef std::vector<LinkedVarying> LinkedVaryingArray;
 		LinkedVaryingArray transformFeedbackLinkedVaryings;
+		std::vector<glsl::ShaderVariable> fragmentOutputs;   // Kept for program binaries, which have no attached shaders
 
 		bool linked;
 		bool orphaned;   // Flag to indicate that the program can be deleted when no longer in use
@@ -1502,6 +1502,16 @@ GL_APICALL void GL_APIENTRY glProgramBinary(GLuint program, GLenum binaryFormat,
 	return gl::ProgramBinary(program, binaryFormat, binary, length);
 }
 
+GL_APICALL void GL_APIENTRY glGetProgramBinaryOES(GLuint program, GLsizei bufSize, GLsizei *length, GLenum *binaryFormat, void *binary)
+{
+	return gl::GetProgramBinaryOES(program, bufSize, length, binaryFormat, binary);
+}
+
+GL_APICALL void GL_APIENTRY glProgramBinaryOES(GLuint program, GLenum binaryFormat, const void *binary, GLint length)
+{
+	return gl::ProgramBinaryOES(program, binaryFormat, binary, length);
+}
+
 GL_APICALL void GL_APIENTRY glProgramParameteri(GLuint program, GLenum pname, GLint value)
 {
 	return gl::ProgramParameteri(program, pname, value);
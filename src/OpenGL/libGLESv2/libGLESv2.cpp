@@ -6410,6 +6410,7 @@ extern "C" NO_SANITIZE_FUNCTION __eglMustCastToProperFunctionPointerType es2GetP
 		FUNCTION(GetIntegerv),
 		FUNCTION(GetInternalformativ),
 		FUNCTION(GetProgramBinary),
+		FUNCTION(GetProgramBinaryOES),
 		FUNCTION(GetProgramInfoLog),
 		FUNCTION(GetProgramiv),
 		FUNCTION(GetQueryObjectuiv),
@@ -6470,6 +6471,7 @@ extern "C" NO_SANITIZE_FUNCTION __eglMustCastToProperFunctionPointerType es2GetP
 		FUNCTION(PixelStorei),
 		FUNCTION(PolygonOffset),
 		FUNCTION(ProgramBinary),
+		FUNCTION(ProgramBinaryOES),
 		FUNCTION(ProgramParameteri),
 		FUNCTION(ReadBuffer),
 		FUNCTION(ReadPixels),
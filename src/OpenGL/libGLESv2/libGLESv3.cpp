@@ -3477,10 +3477,12 @@ void GL_APIENTRY GetProgramBinary(GLuint program, GLsizei bufSize, GLsizei *leng
 		{
 			return error(GL_INVALID_OPERATION);
 		}
-	}
 
-	// SwiftShader doesn't return a program binary and sets the program binay size to 0, so any attempt at getting one is invalid.
-	return error(GL_INVALID_OPERATION);
+		if(!programObject->getBinary(bufSize, length, binaryFormat, binary))
+		{
+			return error(GL_INVALID_OPERATION);
+		}
+	}
 }
 
 void GL_APIENTRY ProgramBinary(GLuint program, GLenum binaryFormat, const void *binary, GLsizei length)
@@ -3503,10 +3505,24 @@ void GL_APIENTRY ProgramBinary(GLuint program, GLenum binaryFormat, const void *
 		{
 			return error(GL_INVALID_OPERATION);
 		}
+
+		if(binaryFormat != es2::PROGRAM_BINARY_FORMAT_SWIFTSHADER)
+		{
+			return error(GL_INVALID_ENUM);
+		}
+
+		programObject->loadBinary(binary, length);
 	}
+}
 
-	// Regardless of what the binaryFormat is, it is unrecognized by SwiftShader, since it supports no format.
-	return error(GL_INVALID_ENUM);
+void GL_APIENTRY GetProgramBinaryOES(GLuint program, GLsizei bufSize, GLsizei *length, GLenum *binaryFormat, void *binary)
+{
+	GetProgramBinary(program, bufSize, length, binaryFormat, binary);
+}
+
+void GL_APIENTRY ProgramBinaryOES(GLuint program, GLenum binaryFormat, const void *binary, GLint length)
+{
+	ProgramBinary(program, binaryFormat, binary, length);
 }
 
 void GL_APIENTRY ProgramParameteri(GLuint program, GLenum pname, GLint value)
@@ -16,11 +16,12 @@
 
 #include "Constants.hpp"
 #include "System/Debug.hpp"
+#include "System/Metrics.hpp"
+#include "System/Trace.hpp"
 #include "Vulkan/VkDevice.hpp"
 #include "Vulkan/VkPipelineLayout.hpp"
 
 #include "marl/defer.h"
-#include "marl/trace.h"
 #include "marl/waitgroup.h"
 
 #include <queue>
@@ -52,7 +53,8 @@ ComputeProgram::~ComputeProgram()
 
 void ComputeProgram::generate()
 {
-	MARL_SCOPED_EVENT("ComputeProgram::generate");
+	SW_SCOPED_EVENT("ComputeProgram::generate");
+	Metrics::ScopedTimer timer(Metrics::ShaderEmitTime);
 
 	SpirvRoutine routine(pipelineLayout);
 	shader->emitProlog(&routine);
@@ -193,8 +195,7 @@ void ComputeProgram::emit(SpirvRoutine *routine)
 	Int workgroupID[3] = { workgroupX, workgroupY, workgroupZ };
 	setWorkgroupBuiltins(data, routine, workgroupID);
 
-	For(Int i = 0, i < subgroupCount, i++)
-	{
+	auto beginSubgroup = [&](Int i) {
 		auto subgroupIndex = firstSubgroup + i;
 
 		// TODO: Replace SIMD::Int(0, 1, 2, 3) with SIMD-width equivalent
@@ -205,10 +206,30 @@ void ComputeProgram::emit(SpirvRoutine *routine)
 
 		setSubgroupBuiltins(data, routine, workgroupID, localInvocationIndex, subgroupIndex);
 
+		return activeLaneMask;
+	};
+
+	if(shader->getAnalysis().ControlBarriersAtTopLevel)
+	{
+		// Run the subgroups one after the other up to each control barrier,
+		// with the state they need after it spilled to the workgroup memory.
+		spillSize = shader->emitPhases(routine, descriptorSets, workgroupMemory + spillOffset(), subgroupCount, beginSubgroup);
+		return;
+	}
+
+	For(Int i = 0, i < subgroupCount, i++)
+	{
+		auto activeLaneMask = beginSubgroup(i);
+
 		shader->emit(routine, activeLaneMask, activeLaneMask, descriptorSets);
 	}
 }
 
+size_t ComputeProgram::spillOffset() const
+{
+	return sw::align<16>(shader->workgroupMemory.size());
+}
+
 void ComputeProgram::run(
     vk::DescriptorSet::Array const &descriptorSetObjects,
     vk::DescriptorSet::Bindings const &descriptorSets,
@@ -239,6 +260,16 @@ void ComputeProgram::run(
 	data.subgroupsPerWorkgroup = subgroupsPerWorkgroup;
 	data.pushConstants = pushConstants;
 
+	// Shaders which can't be split at their control barriers need a
+	// coroutine per subgroup, which yields at each barrier.
+	bool yieldAtBarriers = shader->getAnalysis().ContainsControlBarriers && !shader->getAnalysis().ControlBarriersAtTopLevel;
+
+	size_t workgroupMemorySize = shader->workgroupMemory.size();
+	if(spillSize > 0)
+	{
+		workgroupMemorySize = spillOffset() + size_t(spillSize) * subgroupsPerWorkgroup;
+	}
+
 	marl::WaitGroup wg;
 	const uint32_t batchCount = 16;
 
@@ -249,7 +280,7 @@ void ComputeProgram::run(
 		wg.add(1);
 		marl::schedule([=, &data] {
 			defer(wg.done());
-			std::vector<uint8_t> workgroupMemory(shader->workgroupMemory.size());
+			std::vector<uint8_t> workgroupMemory(workgroupMemorySize);
 
 			for(uint32_t groupIndex = batchID; groupIndex < groupCount; groupIndex += batchCount)
 			{
@@ -263,12 +294,12 @@ void ComputeProgram::run(
 				auto groupZ = baseGroupZ + groupOffsetZ;
 				auto groupY = baseGroupY + groupOffsetY;
 				auto groupX = baseGroupX + groupOffsetX;
-				MARL_SCOPED_EVENT("groupX: %d, groupY: %d, groupZ: %d", groupX, groupY, groupZ);
+				SW_SCOPED_EVENT("groupX: %d, groupY: %d, groupZ: %d", groupX, groupY, groupZ);
 
 				using Coroutine = std::unique_ptr<rr::Stream<SpirvShader::YieldResult>>;
 				std::queue<Coroutine> coroutines;
 
-				if(shader->getAnalysis().ContainsControlBarriers)
+				if(yieldAtBarriers)
 				{
 					// Make a function call per subgroup so each subgroup
 					// can yield, bringing all subgroups to the barrier
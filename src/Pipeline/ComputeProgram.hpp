@@ -68,6 +68,10 @@ protected:
 	void setWorkgroupBuiltins(Pointer<Byte> data, SpirvRoutine *routine, Int workgroupID[3]);
 	void setSubgroupBuiltins(Pointer<Byte> data, SpirvRoutine *routine, Int workgroupID[3], SIMD::Int localInvocationIndex, Int subgroupIndex);
 
+	// Returns the offset of the state spilled at control barriers within the
+	// workgroup memory.
+	size_t spillOffset() const;
+
 	struct Data
 	{
 		vk::DescriptorSet::Bindings descriptorSets;
@@ -84,6 +88,8 @@ protected:
 	const std::shared_ptr<SpirvShader> shader;
 	const vk::PipelineLayout *const pipelineLayout;  // Reference held by vk::Pipeline
 	const vk::DescriptorSet::Bindings &descriptorSets;
+
+	uint32_t spillSize = 0;  // Bytes spilled per subgroup, see SpirvShader::emitPhases().
 };
 
 }  // namespace sw
@@ -285,6 +285,7 @@ void PixelRoutine::quad(Pointer<Byte> cBuffer[MAX_COLOR_BUFFERS], Pointer<Byte>
 
 			if(spirvShader)
 			{
+				fragmentInvocationCount(earlyFragmentTests ? zMask : cMask, samples);
 				executeShader(cMask, earlyFragmentTests ? sMask : cMask, earlyFragmentTests ? zMask : cMask, samples);
 			}
 
@@ -776,6 +777,24 @@ void PixelRoutine::occlusionSampleCount(const Int zMask[4], const Int sMask[4],
 	}
 }
 
+void PixelRoutine::fragmentInvocationCount(const Int mask[4], const SampleSet &samples)
+{
+	if(!state.pipelineStatisticsEnabled)
+	{
+		return;
+	}
+
+	// Without per-sample shading, the shader is invoked once for each pixel
+	// covered by any of the samples.
+	Int invocationMask = 0;
+	for(unsigned int q : samples)
+	{
+		invocationMask |= mask[q];
+	}
+
+	fragmentInvocations += *Pointer<UInt>(constants + OFFSET(Constants, occlusionCount) + 4 * invocationMask);
+}
+
 void PixelRoutine::writeStencil(Pointer<Byte> &sBuffer, const Int &x, const Int sMask[4], const Int zMask[4], const Int cMask[4], const SampleSet &samples)
 {
 	if(!state.stencilActive)
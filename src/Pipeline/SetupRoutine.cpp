@@ -15,6 +15,8 @@
 #include "SetupRoutine.hpp"
 
 #include "Constants.hpp"
+#include "ShaderCore.hpp"
+#include "Device/Clipper.hpp"
 #include "Device/Polygon.hpp"
 #include "Device/Primitive.hpp"
 #include "Device/Renderer.hpp"
@@ -525,6 +527,150 @@ void SetupRoutine::generate()
 	routine = function("SetupRoutine");
 }
 
+void SetupRoutine::generateCulling()
+{
+	CullFunction function;
+	{
+		Pointer<Byte> triangles(function.Arg<0>());
+		Int count(function.Arg<1>());
+		Pointer<Byte> data(function.Arg<2>());
+		Pointer<Int> survivors(function.Arg<3>());
+
+		constexpr int subPixB = vk::SUBPIXEL_PRECISION_BITS;
+		constexpr int subPixM = vk::SUBPIXEL_PRECISION_MASK;
+
+		Int4 scissorX0 = Int4(*Pointer<Int>(data + OFFSET(DrawData, scissorX0)));
+		Int4 scissorX1 = Int4(*Pointer<Int>(data + OFFSET(DrawData, scissorX1)));
+		Int4 scissorY0 = Int4(*Pointer<Int>(data + OFFSET(DrawData, scissorY0)));
+		Int4 scissorY1 = Int4(*Pointer<Int>(data + OFFSET(DrawData, scissorY1)));
+
+		Int visible = 0;
+
+		For(Int i = 0, i < count, i += 4)
+		{
+			// Lanes past the end of the batch repeat its last triangle, and are masked out.
+			Int4 valid = CmpLT(Int4(i) + Int4(0, 1, 2, 3), Int4(count));
+
+			Float4 P[3][4];  // Projected vertex positions, per vertex and lane
+			Int4 clipOr;     // Clip flags of any vertex
+			Int4 clipAnd;    // Clip flags of all vertices
+			Int4 cullOr;     // Cull mask of any vertex
+			Int4 wSign;      // Sign bit holds the product of the signs of the vertices' w
+
+			for(int lane = 0; lane < 4; lane++)
+			{
+				Pointer<Byte> tri = triangles + Min(i + lane, count - 1) * Int(sizeof(Triangle));
+				Pointer<Byte> v0 = tri + OFFSET(Triangle, v0);
+				Pointer<Byte> v1 = tri + OFFSET(Triangle, v1);
+				Pointer<Byte> v2 = tri + OFFSET(Triangle, v2);
+
+				P[0][lane] = *Pointer<Float4>(v0 + OFFSET(Vertex, projected), 16);
+				P[1][lane] = *Pointer<Float4>(v1 + OFFSET(Vertex, projected), 16);
+				P[2][lane] = *Pointer<Float4>(v2 + OFFSET(Vertex, projected), 16);
+
+				Int clipFlags0 = *Pointer<Int>(v0 + OFFSET(Vertex, clipFlags));
+				Int clipFlags1 = *Pointer<Int>(v1 + OFFSET(Vertex, clipFlags));
+				Int clipFlags2 = *Pointer<Int>(v2 + OFFSET(Vertex, clipFlags));
+
+				clipOr = Insert(clipOr, clipFlags0 | clipFlags1 | clipFlags2, lane);
+				clipAnd = Insert(clipAnd, clipFlags0 & clipFlags1 & clipFlags2, lane);
+				cullOr = Insert(cullOr, *Pointer<Int>(v0 + OFFSET(Vertex, cullMask)) |
+				                            *Pointer<Int>(v1 + OFFSET(Vertex, cullMask)) |
+				                            *Pointer<Int>(v2 + OFFSET(Vertex, cullMask)),
+				                lane);
+				wSign = Insert(wSign, *Pointer<Int>(v0 + OFFSET(Vertex, w)) ^
+				                          *Pointer<Int>(v1 + OFFSET(Vertex, w)) ^
+				                          *Pointer<Int>(v2 + OFFSET(Vertex, w)),
+				               lane);
+			}
+
+			Int4 X[3];
+			Int4 Y[3];
+
+			for(int vertex = 0; vertex < 3; vertex++)
+			{
+				transpose4x2(P[vertex][0], P[vertex][1], P[vertex][2], P[vertex][3]);
+
+				X[vertex] = As<Int4>(P[vertex][0]);
+				Y[vertex] = As<Int4>(P[vertex][1]);
+			}
+
+			// Triangles which are entirely outside of one clip plane, or not in any view, get rejected.
+			// Ones which straddle a clip plane are left for the clipper.
+			Int4 rejected = CmpEQ(cullOr, Int4(0)) | CmpNEQ(clipAnd, Int4(Clipper::CLIP_FINITE));
+			Int4 unclipped = CmpEQ(clipOr, Int4(Clipper::CLIP_FINITE));
+
+			// Facing, computed like the setup routine does.
+			if(state.cullMode != VK_CULL_MODE_NONE)
+			{
+				Float4 x0 = Float4(X[0]);
+				Float4 x1 = Float4(X[1]);
+				Float4 x2 = Float4(X[2]);
+
+				Float4 y0 = Float4(Y[0]);
+				Float4 y1 = Float4(Y[1]);
+				Float4 y2 = Float4(Y[2]);
+
+				Float4 A = (y0 - y2) * x1 + (y2 - y1) * x0 + (y1 - y0) * x2;  // Area
+				A = As<Float4>(As<Int4>(A) ^ (wSign & Int4(0x80000000)));
+
+				Int4 frontFacing = (state.frontFace == VK_FRONT_FACE_COUNTER_CLOCKWISE) ? CmpGE(A, Float4(0.0f)) : CmpLE(A, Float4(0.0f));
+
+				if(state.cullMode & VK_CULL_MODE_FRONT_BIT)
+				{
+					rejected |= unclipped & frontFacing;
+				}
+				if(state.cullMode & VK_CULL_MODE_BACK_BIT)
+				{
+					rejected |= unclipped & ~frontFacing;
+				}
+			}
+
+			// Triangles which don't cover any sample rows within the scissor
+			// rectangle, or for single-sampling any pixel column, are too small
+			// or outside of it.
+			Int4 yMin = Min(Min(Y[0], Y[1]), Y[2]);
+			Int4 yMax = Max(Max(Y[0], Y[1]), Y[2]);
+
+			if(state.enableMultiSampling)
+			{
+				yMin = (yMin + Int4(Constants::yMinMultiSampleOffset)) >> subPixB;
+				yMax = (yMax + Int4(Constants::yMaxMultiSampleOffset)) >> subPixB;
+			}
+			else
+			{
+				yMin = (yMin + Int4(subPixM)) >> subPixB;
+				yMax = (yMax + Int4(subPixM)) >> subPixB;
+			}
+
+			Int4 empty = CmpGE(Max(yMin, scissorY0), Min(yMax, scissorY1));
+
+			if(!state.enableMultiSampling)
+			{
+				Int4 xMin = (Min(Min(X[0], X[1]), X[2]) + Int4(subPixM)) >> subPixB;
+				Int4 xMax = (Max(Max(X[0], X[1]), X[2]) + Int4(subPixM)) >> subPixB;
+
+				empty |= CmpGE(Max(xMin, scissorX0), Min(xMax, scissorX1));
+			}
+
+			rejected |= unclipped & empty;
+
+			// Compact the survivors.
+			Int4 accepted = valid & ~rejected;
+
+			for(int lane = 0; lane < 4; lane++)
+			{
+				survivors[visible] = i + lane;
+				visible -= Extract(accepted, lane);
+			}
+		}
+
+		Return(visible);
+	}
+
+	cullRoutine = function("SetupCullRoutine");
+}
+
 void SetupRoutine::setupGradient(Pointer<Byte> &primitive, Pointer<Byte> &triangle, Float4 &w012, Float4 (&m)[3], Pointer<Byte> &v0, Pointer<Byte> &v1, Pointer<Byte> &v2, int attribute, int planeEquation, bool flat, bool perspective)
 {
 	if(!flat)
@@ -678,4 +824,9 @@ SetupFunction::RoutineType SetupRoutine::getRoutine()
 	return routine;
 }
 
+CullFunction::RoutineType SetupRoutine::getCullRoutine()
+{
+	return cullRoutine;
+}
+
 }  // namespace sw
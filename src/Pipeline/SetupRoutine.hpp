@@ -32,6 +32,9 @@ public:
 	void generate();
 	SetupFunction::RoutineType getRoutine();
 
+	void generateCulling();
+	CullFunction::RoutineType getCullRoutine();
+
 private:
 	void setupGradient(Pointer<Byte> &primitive, Pointer<Byte> &triangle, Float4 &w012, Float4 (&m)[3], Pointer<Byte> &v0, Pointer<Byte> &v1, Pointer<Byte> &v2, int attribute, int planeEquation, bool flatShading, bool perspective);
 	void edge(Pointer<Byte> &primitive, Pointer<Byte> &data, const Int &Xa, const Int &Ya, const Int &Xb, const Int &Yb, Int &q);
@@ -41,6 +44,7 @@ private:
 	const SetupProcessor::State &state;
 
 	SetupFunction::RoutineType routine;
+	CullFunction::RoutineType cullRoutine;
 };
 
 }  // namespace sw
@@ -598,8 +598,10 @@ SIMD::UInt floatToHalfBits(SIMD::UInt floatBits, bool storeInUpperBits)
 	SIMD::UInt rounded = base + bias + SIMD::UInt(0x00000FFF) + ((base >> 13) & SIMD::UInt(1));
 	SIMD::UInt fp16u = rounded >> 13;
 
-	// Infinity
-	fp16u |= CmpNLE(abs, SIMD::UInt(0x47FFEFFF)) & SIMD::UInt(0x7FFF);
+	// Values which round above the largest half float become infinity, NaNs stay NaN.
+	SIMD::UInt overflow = CmpNLE(abs, SIMD::UInt(0x477FEFFF));
+	SIMD::UInt nan = CmpNLE(abs, SIMD::UInt(0x7F800000));
+	fp16u = (fp16u & ~overflow) | (overflow & SIMD::UInt(0x7C00)) | (nan & SIMD::UInt(0x0200));
 
 	return storeInUpperBits ? (sign | (fp16u << 16)) : ((sign >> 16) | fp16u);
 }
@@ -670,6 +672,27 @@ sw::SIMD::UInt CountBits(rr::RValue<sw::SIMD::UInt> const &bits)
 	return c;
 }
 
+rr::RValue<sw::SIMD::Int> SignExtend(rr::RValue<sw::SIMD::Int> const &val, unsigned int width)
+{
+	if(width >= 32)
+	{
+		return val;
+	}
+
+	unsigned char shift = static_cast<unsigned char>(32 - width);
+	return (val << shift) >> shift;
+}
+
+rr::RValue<sw::SIMD::UInt> ZeroExtend(rr::RValue<sw::SIMD::UInt> const &val, unsigned int width)
+{
+	if(width >= 32)
+	{
+		return val;
+	}
+
+	return val & sw::SIMD::UInt((1u << width) - 1);
+}
+
 // Returns 1 << bits.
 // If the resulting bit overflows a 32 bit integer, 0 is returned.
 rr::RValue<sw::SIMD::UInt> NthBit32(rr::RValue<sw::SIMD::UInt> const &bits)
@@ -689,7 +712,7 @@ rr::RValue<sw::SIMD::Float> FMA(
     rr::RValue<sw::SIMD::Float> const &b,
     rr::RValue<sw::SIMD::Float> const &c)
 {
-	return a * b + c;
+	return rr::MulAdd(a, b, c);
 }
 
 // Returns the exponent of the floating point number f.
@@ -1072,6 +1095,131 @@ bool Pointer::hasStaticEqualOffsets() const
 	return true;
 }
 
+SIMD::UInt Pointer::LoadNarrow(unsigned int size, OutOfBoundsBehavior robustness, Int mask)
+{
+	ASSERT(size == 1 || size == 2);
+	static_assert(SIMD::Width == 4, "Expects SIMD::Width to be 4");
+
+	if(isStaticallyInBounds(size, robustness) && hasStaticSequentialOffsets(size))
+	{
+		// Offsets are sequential. Load all lanes at once and widen them.
+		if(size == 1)
+		{
+			return As<SIMD::UInt>(Int4(*rr::Pointer<Byte4>(base + staticOffsets[0], 1)));
+		}
+
+		return As<SIMD::UInt>(Int4(*rr::Pointer<UShort4>(base + staticOffsets[0], 2)));
+	}
+
+	switch(robustness)
+	{
+	case OutOfBoundsBehavior::Nullify:
+	case OutOfBoundsBehavior::RobustBufferAccess:
+	case OutOfBoundsBehavior::UndefinedValue:
+		mask &= isInBounds(size, robustness);  // Disable out-of-bounds reads.
+		break;
+	case OutOfBoundsBehavior::UndefinedBehavior:
+		// Nothing to do. Application/compiler must guarantee no out-of-bounds accesses.
+		break;
+	}
+
+	auto offs = offsets();
+	SIMD::UInt out = SIMD::UInt(0);
+	for(int i = 0; i < SIMD::Width; i++)
+	{
+		If(Extract(mask, i) != 0)
+		{
+			auto p = base + Extract(offs, i);
+			if(size == 1)
+			{
+				out = Insert(out, rr::UInt(rr::Int(Byte(*rr::Pointer<Byte>(p)))), i);
+			}
+			else
+			{
+				out = Insert(out, rr::UInt(UShort(*rr::Pointer<UShort>(p, 2))), i);
+			}
+		}
+	}
+
+	return out;
+}
+
+void Pointer::StoreNarrow(unsigned int size, SIMD::UInt val, OutOfBoundsBehavior robustness, Int mask)
+{
+	ASSERT(size == 1 || size == 2);
+	static_assert(SIMD::Width == 4, "Expects SIMD::Width to be 4");
+
+	switch(robustness)
+	{
+	case OutOfBoundsBehavior::Nullify:
+	case OutOfBoundsBehavior::RobustBufferAccess:  // TODO: Allows writing anywhere within bounds. Could be faster than masking.
+	case OutOfBoundsBehavior::UndefinedValue:      // Should not be used for store operations. Treat as robust buffer access.
+		mask &= isInBounds(size, robustness);      // Disable out-of-bounds writes.
+		break;
+	case OutOfBoundsBehavior::UndefinedBehavior:
+		// Nothing to do. Application/compiler must guarantee no out-of-bounds accesses.
+		break;
+	}
+
+	auto offs = offsets();
+	auto storeLanes = [&]() {
+		for(int i = 0; i < SIMD::Width; i++)
+		{
+			If(Extract(mask, i) != 0)
+			{
+				auto p = base + Extract(offs, i);
+				if(size == 1)
+				{
+					*rr::Pointer<Byte>(p) = Byte(Extract(val, i));
+				}
+				else
+				{
+					*rr::Pointer<UShort>(p, 2) = UShort(Extract(val, i));
+				}
+			}
+		}
+	};
+
+	if(hasStaticSequentialOffsets(size) && isStaticallyInBounds(size, robustness))
+	{
+		// Store all lanes with a single write when none of them are masked off.
+		If(AnyFalse(mask))
+		{
+			storeLanes();
+		}
+		Else
+		{
+			if(size == 1)
+			{
+				*rr::Pointer<Byte4>(base + staticOffsets[0], 1) = Byte4(val);
+			}
+			else
+			{
+				*rr::Pointer<UShort4>(base + staticOffsets[0], 2) = UShort4(As<Int4>(val));
+			}
+		}
+	}
+	else
+	{
+		storeLanes();
+	}
+}
+
+rr::Pointer<rr::Byte> Pointer::getPointerForLane(int lane) const
+{
+	if(!hasDynamicOffsets)
+	{
+		return base + staticOffsets[lane];
+	}
+
+	return base + Extract(offsets(), lane);
+}
+
+rr::Pointer<rr::Byte> Pointer::getUniformPointer() const
+{
+	return getPointerForLane(0);
+}
+
 }  // namespace SIMD
 
 }  // namespace sw
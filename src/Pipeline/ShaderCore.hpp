@@ -138,9 +138,21 @@ struct Pointer
 	// (N, N, N, N)
 	bool hasStaticEqualOffsets() const;
 
+	// Returns the pointer of the given lane.
+	rr::Pointer<rr::Byte> getPointerForLane(int lane) const;
+
+	// Returns the pointer shared by all lanes, which must have equal offsets.
+	rr::Pointer<rr::Byte> getUniformPointer() const;
+
 	template<typename T>
 	inline T Load(OutOfBoundsBehavior robustness, Int mask, bool atomic = false, std::memory_order order = std::memory_order_relaxed, int alignment = sizeof(float));
 
+	// Loads a 1 or 2 byte scalar per lane, zero-extended to 32 bits.
+	SIMD::UInt LoadNarrow(unsigned int size, OutOfBoundsBehavior robustness, Int mask);
+
+	// Stores the low 1 or 2 bytes of each lane.
+	void StoreNarrow(unsigned int size, SIMD::UInt val, OutOfBoundsBehavior robustness, Int mask);
+
 	template<typename T>
 	inline void Store(T val, OutOfBoundsBehavior robustness, Int mask, bool atomic = false, std::memory_order order = std::memory_order_relaxed);
 
@@ -245,6 +257,12 @@ Modf(rr::RValue<sw::SIMD::Float> const &val);
 // Returns the number of 1s in bits, per lane.
 sw::SIMD::UInt CountBits(rr::RValue<sw::SIMD::UInt> const &bits);
 
+// Sign-extends the low width bits of each lane to 32 bits.
+rr::RValue<sw::SIMD::Int> SignExtend(rr::RValue<sw::SIMD::Int> const &val, unsigned int width);
+
+// Zero-extends the low width bits of each lane to 32 bits.
+rr::RValue<sw::SIMD::UInt> ZeroExtend(rr::RValue<sw::SIMD::UInt> const &val, unsigned int width);
+
 // Returns 1 << bits.
 // If the resulting bit overflows a 32 bit integer, 0 is returned.
 rr::RValue<sw::SIMD::UInt> NthBit32(rr::RValue<sw::SIMD::UInt> const &bits);
@@ -16,6 +16,7 @@
 #include "SpirvShaderDebug.hpp"
 
 #include "System/Debug.hpp"
+#include "System/Half.hpp"
 #include "Vulkan/VkPipelineLayout.hpp"
 #include "Vulkan/VkRenderPass.hpp"
 
@@ -324,7 +325,19 @@ SpirvShader::SpirvShader(
 
 		case spv::OpConstant:
 		case spv::OpSpecConstant:
-			CreateConstant(insn).constantValue[0] = insn.word(3);
+			{
+				auto &object = CreateConstant(insn);
+				auto &objectTy = getType(object);
+				if(objectTy.opcode() == spv::OpTypeFloat && objectTy.componentWidth == 16)
+				{
+					// Half precision constants are held as the equal single precision value.
+					object.constantValue[0] = bit_cast<uint32_t>(static_cast<float>(sw::shortAsHalf(static_cast<short>(insn.word(3)))));
+				}
+				else
+				{
+					object.constantValue[0] = NarrowConstant(insn.word(3), objectTy);
+				}
+			}
 			break;
 		case spv::OpConstantFalse:
 		case spv::OpSpecConstantFalse:
@@ -421,6 +434,22 @@ SpirvShader::SpirvShader(
 				case spv::CapabilityStencilExportEXT: capabilities.StencilExportEXT = true; break;
 				case spv::CapabilityVulkanMemoryModel: capabilities.VulkanMemoryModel = true; break;
 				case spv::CapabilityVulkanMemoryModelDeviceScope: capabilities.VulkanMemoryModelDeviceScope = true; break;
+				case spv::CapabilityShaderNonUniform: capabilities.ShaderNonUniform = true; break;
+				case spv::CapabilityRuntimeDescriptorArray: capabilities.RuntimeDescriptorArray = true; break;
+				case spv::CapabilityInputAttachmentArrayDynamicIndexing: capabilities.InputAttachmentArrayDynamicIndexing = true; break;
+				case spv::CapabilityUniformTexelBufferArrayDynamicIndexing: capabilities.UniformTexelBufferArrayDynamicIndexing = true; break;
+				case spv::CapabilityStorageTexelBufferArrayDynamicIndexing: capabilities.StorageTexelBufferArrayDynamicIndexing = true; break;
+				case spv::CapabilitySampledImageArrayNonUniformIndexing: capabilities.SampledImageArrayNonUniformIndexing = true; break;
+				case spv::CapabilityUniformTexelBufferArrayNonUniformIndexing: capabilities.UniformTexelBufferArrayNonUniformIndexing = true; break;
+				case spv::CapabilityFloat16: capabilities.Float16 = true; break;
+				case spv::CapabilityInt16: capabilities.Int16 = true; break;
+				case spv::CapabilityInt8: capabilities.Int8 = true; break;
+				case spv::CapabilityStorageBuffer16BitAccess: capabilities.StorageBuffer16BitAccess = true; break;
+				case spv::CapabilityUniformAndStorageBuffer16BitAccess: capabilities.UniformAndStorageBuffer16BitAccess = true; break;
+				case spv::CapabilityStoragePushConstant16: capabilities.StoragePushConstant16 = true; break;
+				case spv::CapabilityStorageBuffer8BitAccess: capabilities.StorageBuffer8BitAccess = true; break;
+				case spv::CapabilityUniformAndStorageBuffer8BitAccess: capabilities.UniformAndStorageBuffer8BitAccess = true; break;
+				case spv::CapabilityStoragePushConstant8: capabilities.StoragePushConstant8 = true; break;
 				default:
 					UNSUPPORTED("Unsupported capability %u", insn.word(1));
 				}
@@ -514,18 +543,6 @@ SpirvShader::SpirvShader(
 			// TODO(b/141246700): Add full support for spv::OpFunctionCall
 			break;
 
-		case spv::OpFConvert:
-			UNSUPPORTED("SPIR-V Float16 or Float64 Capability (OpFConvert)");
-			break;
-
-		case spv::OpSConvert:
-			UNSUPPORTED("SPIR-V Int16 or Int64 Capability (OpSConvert)");
-			break;
-
-		case spv::OpUConvert:
-			UNSUPPORTED("SPIR-V Int16 or Int64 Capability (OpUConvert)");
-			break;
-
 		case spv::OpLoad:
 		case spv::OpAccessChain:
 		case spv::OpInBoundsAccessChain:
@@ -579,6 +596,9 @@ SpirvShader::SpirvShader(
 		case spv::OpFNegate:
 		case spv::OpLogicalNot:
 		case spv::OpQuantizeToF16:
+		case spv::OpFConvert:
+		case spv::OpSConvert:
+		case spv::OpUConvert:
 		// Binary ops
 		case spv::OpIAdd:
 		case spv::OpISub:
@@ -757,12 +777,14 @@ SpirvShader::SpirvShader(
 				if(!strcmp(ext, "SPV_KHR_storage_buffer_storage_class")) break;
 				if(!strcmp(ext, "SPV_KHR_shader_draw_parameters")) break;
 				if(!strcmp(ext, "SPV_KHR_16bit_storage")) break;
+				if(!strcmp(ext, "SPV_KHR_8bit_storage")) break;
 				if(!strcmp(ext, "SPV_KHR_variable_pointers")) break;
 				if(!strcmp(ext, "SPV_KHR_device_group")) break;
 				if(!strcmp(ext, "SPV_KHR_multiview")) break;
 				if(!strcmp(ext, "SPV_EXT_shader_stencil_export")) break;
 				if(!strcmp(ext, "SPV_KHR_float_controls")) break;
 				if(!strcmp(ext, "SPV_KHR_vulkan_memory_model")) break;
+				if(!strcmp(ext, "SPV_EXT_descriptor_indexing")) break;
 				UNSUPPORTED("SPIR-V Extension: %s", ext);
 			}
 			break;
@@ -778,6 +800,10 @@ SpirvShader::SpirvShader(
 		it.second.AssignBlockFields();
 	}
 
+	// Barriers can't be split into phases while the debugger needs the
+	// per-subgroup invocation state.
+	analysis.ControlBarriersAtTopLevel = analysis.ContainsControlBarriers && !impl.debugger && AreControlBarriersAtTopLevel();
+
 #ifdef SPIRV_SHADER_CFG_GRAPHVIZ_DOT_FILEPATH
 	{
 		char path[1024];
@@ -830,8 +856,18 @@ void SpirvShader::DeclareType(InsnIterator insn)
 			type.storageClass = static_cast<spv::StorageClass>(insn.word(2));
 		}
 		break;
+	case spv::OpTypeInt:
+	case spv::OpTypeFloat:
+		type.componentWidth = insn.word(2);
+		break;
 	case spv::OpTypeVector:
 	case spv::OpTypeMatrix:
+		{
+			Type::ID elementTypeId = insn.word(2);
+			type.element = elementTypeId;
+			type.componentWidth = getType(elementTypeId).componentWidth;
+		}
+		break;
 	case spv::OpTypeArray:
 	case spv::OpTypeRuntimeArray:
 		{
@@ -1255,7 +1291,7 @@ SIMD::Pointer SpirvShader::WalkExplicitLayoutAccessChain(Object::ID baseId, uint
 				// TODO: b/127950082: Check bounds.
 				ASSERT(d.HasMatrixStride);
 				d.InsideMatrix = true;
-				auto columnStride = (d.HasRowMajor && d.RowMajor) ? static_cast<int32_t>(sizeof(float)) : d.MatrixStride;
+				auto columnStride = (d.HasRowMajor && d.RowMajor) ? static_cast<int32_t>(type.componentWidth / 8) : d.MatrixStride;
 				auto &obj = getObject(indexIds[i]);
 				if(obj.kind == Object::Kind::Constant)
 				{
@@ -1270,7 +1306,7 @@ SIMD::Pointer SpirvShader::WalkExplicitLayoutAccessChain(Object::ID baseId, uint
 			break;
 		case spv::OpTypeVector:
 			{
-				auto elemStride = (d.InsideMatrix && d.HasRowMajor && d.RowMajor) ? d.MatrixStride : static_cast<int32_t>(sizeof(float));
+				auto elemStride = (d.InsideMatrix && d.HasRowMajor && d.RowMajor) ? d.MatrixStride : static_cast<int32_t>(type.componentWidth / 8);
 				auto &obj = getObject(indexIds[i]);
 				if(obj.kind == Object::Kind::Constant)
 				{
@@ -1343,8 +1379,9 @@ SIMD::Pointer SpirvShader::WalkAccessChain(Object::ID baseId, uint32_t numIndexe
 					}
 					else
 					{
-						// Note: the value of indexIds[i] must be dynamically uniform.
-						ptr.base += descriptorSize * Extract(state->getIntermediate(indexIds[i]).Int(0), 0);
+						// The index may differ between lanes. Image instructions sample
+						// each distinct descriptor separately when the offsets diverge.
+						ptr += SIMD::Int(descriptorSize) * state->getIntermediate(indexIds[i]).Int(0);
 					}
 				}
 				else
@@ -1878,7 +1915,6 @@ SpirvShader::EmitResult SpirvShader::EmitInstruction(InsnIterator insn, EmitStat
 	case spv::OpConvertFToS:
 	case spv::OpConvertSToF:
 	case spv::OpConvertUToF:
-	case spv::OpBitcast:
 	case spv::OpIsInf:
 	case spv::OpIsNan:
 	case spv::OpDPdx:
@@ -1891,8 +1927,14 @@ SpirvShader::EmitResult SpirvShader::EmitInstruction(InsnIterator insn, EmitStat
 	case spv::OpDPdyFine:
 	case spv::OpFwidthFine:
 	case spv::OpQuantizeToF16:
+	case spv::OpFConvert:
+	case spv::OpSConvert:
+	case spv::OpUConvert:
 		return EmitUnaryOp(insn, state);
 
+	case spv::OpBitcast:
+		return EmitBitcast(insn, state);
+
 	case spv::OpIAdd:
 	case spv::OpISub:
 	case spv::OpIMul:
@@ -125,6 +125,15 @@ public:
 		return As<SIMD::UInt>(scalar[i]);  // TODO(b/128539387): RValue<SIMD::UInt>(scalar)
 	}
 
+	// Replaces an already constructed element. Used to bring the results of
+	// 32-bit arithmetic back into the range and precision of narrower types.
+	void replace(uint32_t i, RValue<SIMD::UInt> &&value)
+	{
+		ASSERT(i < componentCount);
+		ASSERT(scalar[i] != nullptr);
+		scalar[i] = value.value();
+	}
+
 	// No copy/move construction or assignment
 	Intermediate(Intermediate const &) = delete;
 	Intermediate(Intermediate &&) = delete;
@@ -314,6 +323,10 @@ public:
 		uint32_t componentCount = 0;
 		bool isBuiltInBlock = false;
 
+		// Bit width of the scalar components of scalar, vector and matrix types.
+		// 8-bit and 16-bit components still occupy a full 32-bit lane each.
+		uint32_t componentWidth = 32;
+
 		// Inner element type for pointers, arrays, vectors and matrices.
 		ID element;
 	};
@@ -445,6 +458,12 @@ public:
 		// notPassingThrough.
 		bool ExistsPath(Block::ID from, Block::ID to, Block::ID notPassingThrough) const;
 
+		// IsTopLevel returns true if the given block is executed exactly once
+		// by every invocation of the function. That is, it is not within a
+		// loop or selection construct, and no block before it can return
+		// from the function.
+		bool IsTopLevel(Block::ID id) const;
+
 		Block const &getBlock(Block::ID id) const
 		{
 			auto it = blocks.find(id);
@@ -641,6 +660,7 @@ public:
 	{
 		bool ContainsKill : 1;
 		bool ContainsControlBarriers : 1;
+		bool ControlBarriersAtTopLevel : 1;  // All workgroup control barriers can be split by emitPhases().
 		bool NeedsCentroid : 1;
 		bool ContainsSampleQualifier : 1;
 	};
@@ -682,6 +702,22 @@ public:
 		bool StencilExportEXT : 1;
 		bool VulkanMemoryModel : 1;
 		bool VulkanMemoryModelDeviceScope : 1;
+		bool ShaderNonUniform : 1;
+		bool RuntimeDescriptorArray : 1;
+		bool InputAttachmentArrayDynamicIndexing : 1;
+		bool UniformTexelBufferArrayDynamicIndexing : 1;
+		bool StorageTexelBufferArrayDynamicIndexing : 1;
+		bool SampledImageArrayNonUniformIndexing : 1;
+		bool UniformTexelBufferArrayNonUniformIndexing : 1;
+		bool Float16 : 1;
+		bool Int16 : 1;
+		bool Int8 : 1;
+		bool StorageBuffer16BitAccess : 1;
+		bool UniformAndStorageBuffer16BitAccess : 1;
+		bool StoragePushConstant16 : 1;
+		bool StorageBuffer8BitAccess : 1;
+		bool UniformAndStorageBuffer8BitAccess : 1;
+		bool StoragePushConstant8 : 1;
 	};
 
 	const Capabilities &getUsedCapabilities() const
@@ -873,6 +909,18 @@ public:
 	void emitProlog(SpirvRoutine *routine) const;
 	void emit(SpirvRoutine *routine, RValue<SIMD::Int> const &activeLaneMask, RValue<SIMD::Int> const &storesAndAtomicsMask, const vk::DescriptorSet::Bindings &descriptorSets, unsigned int multiSampleCount = 0) const;
 	void emitEpilog(SpirvRoutine *routine) const;
+
+	// emitPhases() emits the compute shader for all the subgroups of a
+	// workgroup, as a loop over the subgroups for each phase between the
+	// workgroup control barriers. beginSubgroup() is called at the start of
+	// each iteration to set up the builtins of the subgroup with the given
+	// index, and returns its active lane mask. The state which is live across
+	// a barrier is spilled to spillMemory, which must hold subgroupCount times
+	// the returned number of bytes.
+	// Must only be called if Analysis::ControlBarriersAtTopLevel is true.
+	uint32_t emitPhases(SpirvRoutine *routine, const vk::DescriptorSet::Bindings &descriptorSets,
+	                    Pointer<Byte> spillMemory, Int subgroupCount,
+	                    const std::function<RValue<SIMD::Int>(Int subgroupIndex)> &beginSubgroup) const;
 	void clearPhis(SpirvRoutine *routine) const;
 
 	bool containsImageWrite() const { return imageWriteEmitted; }
@@ -999,6 +1047,13 @@ private:
 
 	void ProcessInterfaceVariable(Object &object);
 
+	// Returns true if every workgroup control barrier of the shader is at the
+	// top level of the entry point function.
+	bool AreControlBarriersAtTopLevel() const;
+
+	// Phases holds the subgroup loop state for the emitPhases() pass.
+	struct Phases;
+
 	// EmitState holds control-flow state for the emit() pass.
 	class EmitState
 	{
@@ -1074,6 +1129,7 @@ private:
 		Block::Set visited;                              // Blocks already built.
 		std::unordered_map<Block::Edge, RValue<SIMD::Int>, Block::Edge::Hash> edgeActiveLaneMasks;
 		std::deque<Block::ID> *pending;
+		Phases *phases = nullptr;  // Non-null when emitting with emitPhases().
 
 		const vk::DescriptorSet::Bindings &descriptorSets;
 
@@ -1111,6 +1167,10 @@ private:
 		}
 
 	private:
+		// The intermediates and pointers are spilled and restored by
+		// SpirvShader::EmitPhaseBoundary().
+		friend class SpirvShader;
+
 		std::unordered_map<Object::ID, Intermediate> intermediates;
 		std::unordered_map<Object::ID, SIMD::Pointer> pointers;
 
@@ -1208,6 +1268,17 @@ private:
 		return getType(getObject(id));
 	}
 
+	// Returns the scalar type of a scalar, vector or matrix type.
+	Type const &getComponentType(Type const &type) const
+	{
+		auto *t = &type;
+		while(t->opcode() == spv::OpTypeVector || t->opcode() == spv::OpTypeMatrix)
+		{
+			t = &getType(t->element);
+		}
+		return *t;
+	}
+
 	Function const &getFunction(Function::ID id) const
 	{
 		auto it = functions.find(id);
@@ -1279,6 +1350,7 @@ private:
 	EmitResult EmitVectorExtractDynamic(InsnIterator insn, EmitState *state) const;
 	EmitResult EmitVectorInsertDynamic(InsnIterator insn, EmitState *state) const;
 	EmitResult EmitUnaryOp(InsnIterator insn, EmitState *state) const;
+	EmitResult EmitBitcast(InsnIterator insn, EmitState *state) const;
 	EmitResult EmitBinaryOp(InsnIterator insn, EmitState *state) const;
 	EmitResult EmitDot(InsnIterator insn, EmitState *state) const;
 	EmitResult EmitSelect(InsnIterator insn, EmitState *state) const;
@@ -1310,6 +1382,7 @@ private:
 	EmitResult EmitCopyObject(InsnIterator insn, EmitState *state) const;
 	EmitResult EmitCopyMemory(InsnIterator insn, EmitState *state) const;
 	EmitResult EmitControlBarrier(InsnIterator insn, EmitState *state) const;
+	void EmitPhaseBoundary(InsnIterator insn, EmitState *state) const;
 	EmitResult EmitMemoryBarrier(InsnIterator insn, EmitState *state) const;
 	EmitResult EmitGroupNonUniform(InsnIterator insn, EmitState *state) const;
 	EmitResult EmitArrayLength(InsnIterator insn, EmitState *state) const;
@@ -1317,8 +1390,9 @@ private:
 	// Emits code to sample an image, regardless of whether any SIMD lanes are active.
 	void EmitImageSampleUnconditional(Array<SIMD::Float> &out, const ImageInstruction &instruction, EmitState *state) const;
 
-	Pointer<Byte> lookupSamplerFunction(Pointer<Byte> imageDescriptor, const ImageInstruction &instruction, EmitState *state) const;
-	void callSamplerFunction(Pointer<Byte> samplerFunction, Array<SIMD::Float> &out, Pointer<Byte> imageDescriptor, const ImageInstruction &instruction, EmitState *state) const;
+	Pointer<Byte> lookupSamplerFunction(Pointer<Byte> imageDescriptor, Pointer<Byte> samplerDescriptor, const ImageInstruction &instruction, EmitState *state) const;
+	void getSamplerFunctionInputs(Array<SIMD::Float> &in, const ImageInstruction &instruction, EmitState *state) const;
+	void callSamplerFunction(Pointer<Byte> samplerFunction, Array<SIMD::Float> &in, Array<SIMD::Float> &out, Pointer<Byte> imageDescriptor, EmitState *state) const;
 
 	void GetImageDimensions(EmitState const *state, Type const &resultTy, Object::ID imageId, Object::ID lodId, Intermediate &dst) const;
 	static SIMD::Pointer GetTexelAddress(ImageInstructionSignature instruction, Pointer<Byte> descriptor, SIMD::Int coordinate[], SIMD::Int sample, vk::Format imageFormat, OutOfBoundsBehavior outOfBoundsBehavior, const EmitState *state);
@@ -1376,6 +1450,23 @@ private:
 	// has a result type ID and result ID, i.e. defines an Object.
 	static bool HasTypeAndResult(spv::Op op);
 
+	// Scalars narrower than 32 bits are held in 32-bit lanes. Half precision
+	// floats are represented by the equal single precision value, and 8 and
+	// 16-bit integers are sign or zero-extended according to their signedness.
+	//
+	// FromNarrowBits() returns the lane value for the low bits of bits, as
+	// read from memory. ToNarrowBits() returns the bits to write to memory,
+	// rounding floats to the nearest half precision value.
+	static SIMD::UInt FromNarrowBits(RValue<SIMD::UInt> bits, Type const &scalarType);
+	static SIMD::UInt ToNarrowBits(RValue<SIMD::UInt> value, Type const &scalarType);
+
+	// NarrowResult() rounds or wraps the components of dst, as computed with
+	// 32-bit arithmetic, to the range and precision of type.
+	void NarrowResult(Intermediate &dst, Type const &type) const;
+
+	// Host equivalent of NarrowResult() for constant values.
+	static uint32_t NarrowConstant(uint32_t value, Type const &scalarType);
+
 	// Helper as we often need to take dot products as part of doing other things.
 	SIMD::Float Dot(unsigned numComponents, Operand const &x, Operand const &y) const;
 
@@ -16,6 +16,7 @@
 #include "SpirvShaderDebug.hpp"
 
 #include "ShaderCore.hpp"
+#include "System/Half.hpp"
 
 #include <spirv/unified1/spirv.hpp>
 
@@ -33,6 +34,8 @@ SpirvShader::EmitResult SpirvShader::EmitVectorTimesScalar(InsnIterator insn, Em
 		dst.move(i, lhs.Float(i) * rhs.Float(0));
 	}
 
+	NarrowResult(dst, type);
+
 	return EmitResult::Continue;
 }
 
@@ -53,6 +56,8 @@ SpirvShader::EmitResult SpirvShader::EmitMatrixTimesVector(InsnIterator insn, Em
 		dst.move(i, v);
 	}
 
+	NarrowResult(dst, type);
+
 	return EmitResult::Continue;
 }
 
@@ -73,6 +78,8 @@ SpirvShader::EmitResult SpirvShader::EmitVectorTimesMatrix(InsnIterator insn, Em
 		dst.move(i, v);
 	}
 
+	NarrowResult(dst, type);
+
 	return EmitResult::Continue;
 }
 
@@ -100,6 +107,8 @@ SpirvShader::EmitResult SpirvShader::EmitMatrixTimesMatrix(InsnIterator insn, Em
 		}
 	}
 
+	NarrowResult(dst, type);
+
 	return EmitResult::Continue;
 }
 
@@ -121,6 +130,8 @@ SpirvShader::EmitResult SpirvShader::EmitOuterProduct(InsnIterator insn, EmitSta
 		}
 	}
 
+	NarrowResult(dst, type);
+
 	return EmitResult::Continue;
 }
 
@@ -149,6 +160,7 @@ SpirvShader::EmitResult SpirvShader::EmitUnaryOp(InsnIterator insn, EmitState *s
 	auto &type = getType(insn.resultTypeId());
 	auto &dst = state->createIntermediate(insn.resultId(), type.componentCount);
 	auto src = Operand(this, state, insn.word(3));
+	auto width = getObjectType(insn.word(3)).componentWidth;
 
 	for(auto i = 0u; i < type.componentCount; i++)
 	{
@@ -198,11 +210,15 @@ SpirvShader::EmitResult SpirvShader::EmitUnaryOp(InsnIterator insn, EmitState *s
 				v = ((v >> 4) & SIMD::UInt(0x0F0F0F0F)) | ((v & SIMD::UInt(0x0F0F0F0F)) << 4);
 				v = ((v >> 8) & SIMD::UInt(0x00FF00FF)) | ((v & SIMD::UInt(0x00FF00FF)) << 8);
 				v = (v >> 16) | (v << 16);
+				if(width < 32)
+				{
+					v = v >> SIMD::UInt(32 - width);
+				}
 				dst.move(i, v);
 			}
 			break;
 		case spv::OpBitCount:
-			dst.move(i, CountBits(src.UInt(i)));
+			dst.move(i, CountBits(ZeroExtend(src.UInt(i), width)));
 			break;
 		case spv::OpSNegate:
 			dst.move(i, -src.Int(i));
@@ -217,14 +233,20 @@ SpirvShader::EmitResult SpirvShader::EmitUnaryOp(InsnIterator insn, EmitState *s
 			dst.move(i, SIMD::Int(src.Float(i)));
 			break;
 		case spv::OpConvertSToF:
-			dst.move(i, SIMD::Float(src.Int(i)));
+			dst.move(i, SIMD::Float(SignExtend(src.Int(i), width)));
 			break;
 		case spv::OpConvertUToF:
-			dst.move(i, SIMD::Float(src.UInt(i)));
+			dst.move(i, SIMD::Float(ZeroExtend(src.UInt(i), width)));
 			break;
-		case spv::OpBitcast:
+		case spv::OpFConvert:
 			dst.move(i, src.Float(i));
 			break;
+		case spv::OpSConvert:
+			dst.move(i, SignExtend(src.Int(i), width));
+			break;
+		case spv::OpUConvert:
+			dst.move(i, ZeroExtend(src.UInt(i), width));
+			break;
 		case spv::OpIsInf:
 			dst.move(i, IsInf(src.Float(i)));
 			break;
@@ -303,6 +325,61 @@ SpirvShader::EmitResult SpirvShader::EmitUnaryOp(InsnIterator insn, EmitState *s
 		}
 	}
 
+	NarrowResult(dst, type);
+
+	return EmitResult::Continue;
+}
+
+SpirvShader::EmitResult SpirvShader::EmitBitcast(InsnIterator insn, EmitState *state) const
+{
+	auto &type = getType(insn.resultTypeId());
+	auto &dst = state->createIntermediate(insn.resultId(), type.componentCount);
+	auto &srcType = getObjectType(insn.word(3));
+	auto src = Operand(this, state, insn.word(3));
+
+	auto dstWidth = type.componentWidth;
+	auto srcWidth = srcType.componentWidth;
+
+	if(dstWidth == 32 && srcWidth == 32)
+	{
+		for(auto i = 0u; i < type.componentCount; i++)
+		{
+			dst.move(i, src.Float(i));
+		}
+
+		return EmitResult::Continue;
+	}
+
+	// Narrow components are reassembled from their in-memory bit patterns.
+	// Wider components are split into, or packed from, several narrow ones,
+	// with the lowest numbered component in the least significant bits.
+	auto &srcScalar = getComponentType(srcType);
+	auto &dstScalar = getComponentType(type);
+
+	if(srcWidth >= dstWidth)
+	{
+		auto ratio = srcWidth / dstWidth;
+		for(auto i = 0u; i < type.componentCount; i++)
+		{
+			SIMD::UInt bits = ToNarrowBits(src.UInt(i / ratio), srcScalar);
+			bits = bits >> SIMD::UInt((i % ratio) * dstWidth);
+			dst.move(i, FromNarrowBits(bits, dstScalar));
+		}
+	}
+	else
+	{
+		auto ratio = dstWidth / srcWidth;
+		for(auto i = 0u; i < type.componentCount; i++)
+		{
+			SIMD::UInt bits = SIMD::UInt(0);
+			for(auto j = 0u; j < ratio; j++)
+			{
+				bits |= ToNarrowBits(src.UInt(i * ratio + j), srcScalar) << SIMD::UInt(j * srcWidth);
+			}
+			dst.move(i, FromNarrowBits(bits, dstScalar));
+		}
+	}
+
 	return EmitResult::Continue;
 }
 
@@ -314,6 +391,13 @@ SpirvShader::EmitResult SpirvShader::EmitBinaryOp(InsnIterator insn, EmitState *
 	auto lhs = Operand(this, state, insn.word(3));
 	auto rhs = Operand(this, state, insn.word(4));
 
+	// 8 and 16-bit integers are held sign or zero-extended according to their
+	// type's signedness. Operations which interpret their operands' upper bits
+	// extend them according to the operation's signedness instead.
+	auto width = lhsType.componentWidth;
+	auto sext = [&](const Operand &op, uint32_t i) { return SignExtend(op.Int(i), width); };
+	auto zext = [&](const Operand &op, uint32_t i) { return ZeroExtend(op.UInt(i), width); };
+
 	for(auto i = 0u; i < lhsType.componentCount; i++)
 	{
 		switch(insn.opcode())
@@ -329,8 +413,8 @@ SpirvShader::EmitResult SpirvShader::EmitBinaryOp(InsnIterator insn, EmitState *
 			break;
 		case spv::OpSDiv:
 			{
-				SIMD::Int a = lhs.Int(i);
-				SIMD::Int b = rhs.Int(i);
+				SIMD::Int a = sext(lhs, i);
+				SIMD::Int b = sext(rhs, i);
 				b = b | CmpEQ(b, SIMD::Int(0));                                       // prevent divide-by-zero
 				a = a | (CmpEQ(a, SIMD::Int(0x80000000)) & CmpEQ(b, SIMD::Int(-1)));  // prevent integer overflow
 				dst.move(i, a / b);
@@ -338,14 +422,14 @@ SpirvShader::EmitResult SpirvShader::EmitBinaryOp(InsnIterator insn, EmitState *
 			break;
 		case spv::OpUDiv:
 			{
-				auto zeroMask = As<SIMD::UInt>(CmpEQ(rhs.Int(i), SIMD::Int(0)));
-				dst.move(i, lhs.UInt(i) / (rhs.UInt(i) | zeroMask));
+				auto zeroMask = As<SIMD::UInt>(CmpEQ(zext(rhs, i), SIMD::UInt(0)));
+				dst.move(i, zext(lhs, i) / (zext(rhs, i) | zeroMask));
 			}
 			break;
 		case spv::OpSRem:
 			{
-				SIMD::Int a = lhs.Int(i);
-				SIMD::Int b = rhs.Int(i);
+				SIMD::Int a = sext(lhs, i);
+				SIMD::Int b = sext(rhs, i);
 				b = b | CmpEQ(b, SIMD::Int(0));                                       // prevent divide-by-zero
 				a = a | (CmpEQ(a, SIMD::Int(0x80000000)) & CmpEQ(b, SIMD::Int(-1)));  // prevent integer overflow
 				dst.move(i, a % b);
@@ -353,8 +437,8 @@ SpirvShader::EmitResult SpirvShader::EmitBinaryOp(InsnIterator insn, EmitState *
 			break;
 		case spv::OpSMod:
 			{
-				SIMD::Int a = lhs.Int(i);
-				SIMD::Int b = rhs.Int(i);
+				SIMD::Int a = sext(lhs, i);
+				SIMD::Int b = sext(rhs, i);
 				b = b | CmpEQ(b, SIMD::Int(0));                                       // prevent divide-by-zero
 				a = a | (CmpEQ(a, SIMD::Int(0x80000000)) & CmpEQ(b, SIMD::Int(-1)));  // prevent integer overflow
 				auto mod = a % b;
@@ -371,41 +455,41 @@ SpirvShader::EmitResult SpirvShader::EmitBinaryOp(InsnIterator insn, EmitState *
 			break;
 		case spv::OpUMod:
 			{
-				auto zeroMask = As<SIMD::UInt>(CmpEQ(rhs.Int(i), SIMD::Int(0)));
-				dst.move(i, lhs.UInt(i) % (rhs.UInt(i) | zeroMask));
+				auto zeroMask = As<SIMD::UInt>(CmpEQ(zext(rhs, i), SIMD::UInt(0)));
+				dst.move(i, zext(lhs, i) % (zext(rhs, i) | zeroMask));
 			}
 			break;
 		case spv::OpIEqual:
 		case spv::OpLogicalEqual:
-			dst.move(i, CmpEQ(lhs.Int(i), rhs.Int(i)));
+			dst.move(i, CmpEQ(zext(lhs, i), zext(rhs, i)));
 			break;
 		case spv::OpINotEqual:
 		case spv::OpLogicalNotEqual:
-			dst.move(i, CmpNEQ(lhs.Int(i), rhs.Int(i)));
+			dst.move(i, CmpNEQ(zext(lhs, i), zext(rhs, i)));
 			break;
 		case spv::OpUGreaterThan:
-			dst.move(i, CmpGT(lhs.UInt(i), rhs.UInt(i)));
+			dst.move(i, CmpGT(zext(lhs, i), zext(rhs, i)));
 			break;
 		case spv::OpSGreaterThan:
-			dst.move(i, CmpGT(lhs.Int(i), rhs.Int(i)));
+			dst.move(i, CmpGT(sext(lhs, i), sext(rhs, i)));
 			break;
 		case spv::OpUGreaterThanEqual:
-			dst.move(i, CmpGE(lhs.UInt(i), rhs.UInt(i)));
+			dst.move(i, CmpGE(zext(lhs, i), zext(rhs, i)));
 			break;
 		case spv::OpSGreaterThanEqual:
-			dst.move(i, CmpGE(lhs.Int(i), rhs.Int(i)));
+			dst.move(i, CmpGE(sext(lhs, i), sext(rhs, i)));
 			break;
 		case spv::OpULessThan:
-			dst.move(i, CmpLT(lhs.UInt(i), rhs.UInt(i)));
+			dst.move(i, CmpLT(zext(lhs, i), zext(rhs, i)));
 			break;
 		case spv::OpSLessThan:
-			dst.move(i, CmpLT(lhs.Int(i), rhs.Int(i)));
+			dst.move(i, CmpLT(sext(lhs, i), sext(rhs, i)));
 			break;
 		case spv::OpULessThanEqual:
-			dst.move(i, CmpLE(lhs.UInt(i), rhs.UInt(i)));
+			dst.move(i, CmpLE(zext(lhs, i), zext(rhs, i)));
 			break;
 		case spv::OpSLessThanEqual:
-			dst.move(i, CmpLE(lhs.Int(i), rhs.Int(i)));
+			dst.move(i, CmpLE(sext(lhs, i), sext(rhs, i)));
 			break;
 		case spv::OpFAdd:
 			dst.move(i, lhs.Float(i) + rhs.Float(i));
@@ -463,10 +547,10 @@ SpirvShader::EmitResult SpirvShader::EmitBinaryOp(InsnIterator insn, EmitState *
 			dst.move(i, CmpUGE(lhs.Float(i), rhs.Float(i)));
 			break;
 		case spv::OpShiftRightLogical:
-			dst.move(i, lhs.UInt(i) >> rhs.UInt(i));
+			dst.move(i, zext(lhs, i) >> rhs.UInt(i));
 			break;
 		case spv::OpShiftRightArithmetic:
-			dst.move(i, lhs.Int(i) >> rhs.Int(i));
+			dst.move(i, sext(lhs, i) >> rhs.Int(i));
 			break;
 		case spv::OpShiftLeftLogical:
 			dst.move(i, lhs.UInt(i) << rhs.UInt(i));
@@ -486,26 +570,77 @@ SpirvShader::EmitResult SpirvShader::EmitBinaryOp(InsnIterator insn, EmitState *
 			// Extended ops: result is a structure containing two members of the same type as lhs & rhs.
 			// In our flat view then, component i is the i'th component of the first member;
 			// component i + N is the i'th component of the second member.
-			dst.move(i, lhs.Int(i) * rhs.Int(i));
-			dst.move(i + lhsType.componentCount, MulHigh(lhs.Int(i), rhs.Int(i)));
+			if(width < 32)
+			{
+				// The full product of narrow integers fits in 32 bits.
+				SIMD::Int product = sext(lhs, i) * sext(rhs, i);
+				dst.move(i, product);
+				dst.move(i + lhsType.componentCount, product >> SIMD::Int(width));
+			}
+			else
+			{
+				dst.move(i, lhs.Int(i) * rhs.Int(i));
+				dst.move(i + lhsType.componentCount, MulHigh(lhs.Int(i), rhs.Int(i)));
+			}
 			break;
 		case spv::OpUMulExtended:
-			dst.move(i, lhs.UInt(i) * rhs.UInt(i));
-			dst.move(i + lhsType.componentCount, MulHigh(lhs.UInt(i), rhs.UInt(i)));
+			if(width < 32)
+			{
+				SIMD::UInt product = zext(lhs, i) * zext(rhs, i);
+				dst.move(i, product);
+				dst.move(i + lhsType.componentCount, product >> SIMD::UInt(width));
+			}
+			else
+			{
+				dst.move(i, lhs.UInt(i) * rhs.UInt(i));
+				dst.move(i + lhsType.componentCount, MulHigh(lhs.UInt(i), rhs.UInt(i)));
+			}
 			break;
 		case spv::OpIAddCarry:
-			dst.move(i, lhs.UInt(i) + rhs.UInt(i));
-			dst.move(i + lhsType.componentCount, CmpLT(dst.UInt(i), lhs.UInt(i)) >> 31);
+			if(width < 32)
+			{
+				SIMD::UInt sum = zext(lhs, i) + zext(rhs, i);
+				dst.move(i, sum);
+				dst.move(i + lhsType.componentCount, sum >> SIMD::UInt(width));
+			}
+			else
+			{
+				dst.move(i, lhs.UInt(i) + rhs.UInt(i));
+				dst.move(i + lhsType.componentCount, CmpLT(dst.UInt(i), lhs.UInt(i)) >> 31);
+			}
 			break;
 		case spv::OpISubBorrow:
 			dst.move(i, lhs.UInt(i) - rhs.UInt(i));
-			dst.move(i + lhsType.componentCount, CmpLT(lhs.UInt(i), rhs.UInt(i)) >> 31);
+			dst.move(i + lhsType.componentCount, CmpLT(zext(lhs, i), zext(rhs, i)) >> 31);
 			break;
 		default:
 			UNREACHABLE("%s", OpcodeName(insn.opcode()));
 		}
 	}
 
+	if(width < 32)
+	{
+		switch(insn.opcode())
+		{
+		case spv::OpSMulExtended:
+		case spv::OpUMulExtended:
+		case spv::OpIAddCarry:
+		case spv::OpISubBorrow:
+			{
+				// Both members of the result structure have the operands' type.
+				auto &scalarType = getComponentType(getType(type.definition.word(2)));
+				for(auto i = 0u; i < type.componentCount; i++)
+				{
+					dst.replace(i, FromNarrowBits(dst.UInt(i), scalarType));
+				}
+			}
+			break;
+		default:
+			NarrowResult(dst, type);
+			break;
+		}
+	}
+
 	SPIRV_SHADER_DBG("{0}: {1}", insn.word(2), dst);
 	SPIRV_SHADER_DBG("{0}: {1}", insn.word(3), lhs);
 	SPIRV_SHADER_DBG("{0}: {1}", insn.word(4), rhs);
@@ -523,6 +658,7 @@ SpirvShader::EmitResult SpirvShader::EmitDot(InsnIterator insn, EmitState *state
 	auto rhs = Operand(this, state, insn.word(4));
 
 	dst.move(0, Dot(lhsType.componentCount, lhs, rhs));
+	NarrowResult(dst, type);
 
 	SPIRV_SHADER_DBG("{0}: {1}", insn.resultId(), dst);
 	SPIRV_SHADER_DBG("{0}: {1}", insn.word(3), lhs);
@@ -543,6 +679,97 @@ SIMD::Float SpirvShader::Dot(unsigned numComponents, Operand const &x, Operand c
 	return d;
 }
 
+SIMD::UInt SpirvShader::FromNarrowBits(RValue<SIMD::UInt> bits, Type const &scalarType)
+{
+	auto width = scalarType.componentWidth;
+	if(width >= 32)
+	{
+		return bits;
+	}
+
+	switch(scalarType.opcode())
+	{
+	case spv::OpTypeFloat:
+		ASSERT(width == 16);
+		return halfToFloatBits(bits);
+	case spv::OpTypeInt:
+		if(scalarType.definition.word(3) != 0)  // Signedness
+		{
+			return As<SIMD::UInt>(SignExtend(As<SIMD::Int>(bits), width));
+		}
+		return ZeroExtend(bits, width);
+	default:
+		UNREACHABLE("%s", OpcodeName(scalarType.opcode()));
+		return bits;
+	}
+}
+
+SIMD::UInt SpirvShader::ToNarrowBits(RValue<SIMD::UInt> value, Type const &scalarType)
+{
+	auto width = scalarType.componentWidth;
+	if(width >= 32)
+	{
+		return value;
+	}
+
+	switch(scalarType.opcode())
+	{
+	case spv::OpTypeFloat:
+		ASSERT(width == 16);
+		return floatToHalfBits(value, false);
+	case spv::OpTypeInt:
+		return ZeroExtend(value, width);
+	default:
+		UNREACHABLE("%s", OpcodeName(scalarType.opcode()));
+		return value;
+	}
+}
+
+void SpirvShader::NarrowResult(Intermediate &dst, Type const &type) const
+{
+	if(type.componentWidth >= 32)
+	{
+		return;
+	}
+
+	// Single precision arithmetic on half precision operands followed by
+	// rounding to half precision produces the correctly rounded result, since
+	// the intermediate has more than twice the precision of the final type.
+	auto &scalarType = getComponentType(type);
+	for(auto i = 0u; i < dst.componentCount; i++)
+	{
+		dst.replace(i, FromNarrowBits(ToNarrowBits(dst.UInt(i), scalarType), scalarType));
+	}
+}
+
+uint32_t SpirvShader::NarrowConstant(uint32_t value, Type const &scalarType)
+{
+	auto width = scalarType.componentWidth;
+	if(width >= 32)
+	{
+		return value;
+	}
+
+	switch(scalarType.opcode())
+	{
+	case spv::OpTypeFloat:
+		ASSERT(width == 16);
+		return bit_cast<uint32_t>(static_cast<float>(sw::half(bit_cast<float>(value))));
+	case spv::OpTypeInt:
+		{
+			auto shift = 32 - width;
+			if(scalarType.definition.word(3) != 0)  // Signedness
+			{
+				return static_cast<uint32_t>(static_cast<int32_t>(value << shift) >> shift);
+			}
+			return (value << shift) >> shift;
+		}
+	default:
+		UNREACHABLE("%s", OpcodeName(scalarType.opcode()));
+		return value;
+	}
+}
+
 std::pair<SIMD::Float, SIMD::Int> SpirvShader::Frexp(RValue<SIMD::Float> val) const
 {
 	// Assumes IEEE 754
@@ -21,6 +21,7 @@
 
 #include <spirv/unified1/spirv.hpp>
 
+#include <algorithm>
 #include <queue>
 
 #include <fstream>
@@ -195,6 +196,72 @@ bool SpirvShader::Function::ExistsPath(Block::ID from, Block::ID to, Block::ID n
 	return false;
 }
 
+bool SpirvShader::Function::IsTopLevel(Block::ID id) const
+{
+	// Gather the blocks which can be reached without passing through the
+	// block, and those which can be reached from it.
+	Block::Set before;
+	before.emplace(id);
+	TraverseReachableBlocks(entry, before);
+
+	Block::Set after;
+	for(auto out : getBlock(id).outs)
+	{
+		TraverseReachableBlocks(out, after);
+	}
+
+	if(after.count(id) != 0)
+	{
+		return false;  // Within a loop.
+	}
+
+	for(auto blockId : before)
+	{
+		if(blockId == id)
+		{
+			continue;
+		}
+
+		if(after.count(blockId) != 0)
+		{
+			return false;  // Within a loop or selection construct.
+		}
+
+		if(getBlock(blockId).outs.empty())
+		{
+			return false;  // Preceded by a return or kill.
+		}
+	}
+
+	return true;
+}
+
+bool SpirvShader::AreControlBarriersAtTopLevel() const
+{
+	for(auto &functionIt : functions)
+	{
+		auto &function = functionIt.second;
+		for(auto &blockIt : function.blocks)
+		{
+			for(auto insn : blockIt.second)
+			{
+				if(insn.opcode() != spv::OpControlBarrier ||
+				   spv::Scope(GetConstScalarInt(insn.word(1))) != spv::ScopeWorkgroup)
+				{
+					continue;
+				}
+
+				if(functionIt.first != entryPoint || !function.IsTopLevel(blockIt.first))
+				{
+					return false;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
 void SpirvShader::EmitState::addOutputActiveLaneMaskEdge(Block::ID to, RValue<SIMD::Int> mask)
 {
 	addActiveLaneMaskEdge(block, to, mask & activeLaneMask());
@@ -630,7 +697,14 @@ SpirvShader::EmitResult SpirvShader::EmitControlBarrier(InsnIterator insn, EmitS
 	switch(executionScope)
 	{
 	case spv::ScopeWorkgroup:
-		Yield(YieldResult::ControlBarrier);
+		if(state->phases)
+		{
+			EmitPhaseBoundary(insn, state);
+		}
+		else
+		{
+			Yield(YieldResult::ControlBarrier);
+		}
 		break;
 	case spv::ScopeSubgroup:
 		break;
@@ -643,6 +717,250 @@ SpirvShader::EmitResult SpirvShader::EmitControlBarrier(InsnIterator insn, EmitS
 	return EmitResult::Continue;
 }
 
+struct SpirvShader::Phases
+{
+	// Size of a spill slot. sizeof(SIMD::Int) is the size of the Reactor
+	// variable on the host, not of the SIMD value it holds.
+	static constexpr int SlotSize = SIMD::Width * sizeof(int32_t);
+
+	Phases(Pointer<Byte> spillMemory, Int subgroupCount, const std::function<RValue<SIMD::Int>(Int subgroupIndex)> &beginSubgroup)
+	    : spillMemory(spillMemory)
+	    , subgroupCount(subgroupCount)
+	    , beginSubgroup(beginSubgroup)
+	{}
+
+	// begin() starts the loop over the subgroups of a phase, and returns the
+	// active lane mask of the subgroup.
+	RValue<SIMD::Int> begin()
+	{
+		subgroupIndex = 0;
+		loop = Nucleus::createBasicBlock();
+		Nucleus::createBr(loop);
+		Nucleus::setInsertBlock(loop);
+
+		return beginSubgroup(subgroupIndex);
+	}
+
+	// end() ends the loop over the subgroups of a phase.
+	void end()
+	{
+		subgroupIndex++;
+		BasicBlock *exit = Nucleus::createBasicBlock();
+		Nucleus::createCondBr((subgroupIndex < subgroupCount).value(), loop, exit);
+		Nucleus::setInsertBlock(exit);
+	}
+
+	// Returns the address of the current subgroup's spill slot with the given
+	// index. Each slot holds a SIMD::Int, and is interleaved for all subgroups.
+	Pointer<Byte> slot(uint32_t index)
+	{
+		return spillMemory + (Int(index) * subgroupCount + subgroupIndex) * Int(SlotSize);
+	}
+
+	Pointer<Byte> spillMemory;
+	Int subgroupCount;
+	const std::function<RValue<SIMD::Int>(Int subgroupIndex)> &beginSubgroup;
+
+	Int subgroupIndex;
+	BasicBlock *loop = nullptr;
+	uint32_t slotCount = 0;  // Largest number of slots spilled at a barrier.
+
+	// Objects declared outside of the functions, which are the same for all
+	// subgroups and don't need to be spilled.
+	std::unordered_set<Object::ID> globals;
+};
+
+uint32_t SpirvShader::emitPhases(SpirvRoutine *routine, const vk::DescriptorSet::Bindings &descriptorSets,
+                                 Pointer<Byte> spillMemory, Int subgroupCount,
+                                 const std::function<RValue<SIMD::Int>(Int subgroupIndex)> &beginSubgroup) const
+{
+	ASSERT(analysis.ControlBarriersAtTopLevel);
+
+	Phases phases(spillMemory, subgroupCount, beginSubgroup);
+	RValue<SIMD::Int> activeLaneMask = phases.begin();
+
+	EmitState state(routine, entryPoint, activeLaneMask, activeLaneMask, descriptorSets, robustBufferAccess, 0, executionModel);
+	state.phases = &phases;
+
+	// Emit everything up to the first label
+	for(auto insn : *this)
+	{
+		if(insn.opcode() == spv::OpLabel)
+		{
+			break;
+		}
+		EmitInstruction(insn, &state);
+	}
+
+	for(auto &it : state.intermediates)
+	{
+		phases.globals.emplace(it.first);
+	}
+	for(auto &it : state.pointers)
+	{
+		phases.globals.emplace(it.first);
+	}
+
+	// Emit all the blocks starting from entryPoint. Each workgroup control
+	// barrier ends the loop of the current phase, see EmitPhaseBoundary().
+	EmitBlocks(getFunction(entryPoint).entry, &state);
+
+	phases.end();
+
+	return phases.slotCount * Phases::SlotSize;
+}
+
+void SpirvShader::EmitPhaseBoundary(InsnIterator insn, EmitState *state) const
+{
+	auto phases = state->phases;
+	auto routine = state->routine;
+	auto &function = getFunction(state->function);
+
+	// The barrier is at the top level of the entry point, so the rest of the
+	// shader consists of the remainder of this block and the blocks which
+	// have not been emitted yet. Treat all of their operands as identifiers,
+	// which at worst spills some state that isn't used again.
+	std::unordered_set<uint32_t> used;
+	auto addOperands = [&](InsnIterator begin, InsnIterator end) {
+		for(auto it = begin; it != end; it++)
+		{
+			for(uint32_t i = 1; i < it.wordCount(); i++)
+			{
+				used.emplace(it.word(i));
+			}
+		}
+	};
+
+	auto next = insn;
+	addOperands(++next, function.getBlock(state->block).end());
+	for(auto &it : function.blocks)
+	{
+		if(state->visited.count(it.first) == 0)
+		{
+			addOperands(it.second.begin(), it.second.end());
+		}
+	}
+
+	auto isLive = [&](Object::ID id) {
+		return used.count(id.value()) != 0 && phases->globals.count(id) == 0;
+	};
+
+	std::vector<Object::ID> intermediates;
+	for(auto &it : state->intermediates)
+	{
+		if(isLive(it.first))
+		{
+			intermediates.push_back(it.first);
+		}
+	}
+
+	std::vector<Object::ID> pointers;
+	for(auto &it : state->pointers)
+	{
+		if(isLive(it.first))
+		{
+			pointers.push_back(it.first);
+		}
+	}
+
+	// Function and private variables hold the per-invocation memory, which
+	// can be accessed through any pointer derived from them.
+	std::vector<Object::ID> variables;
+	for(auto &it : routine->variables)
+	{
+		auto storageClass = getType(getObject(it.first)).storageClass;
+		if(storageClass == spv::StorageClassFunction || storageClass == spv::StorageClassPrivate)
+		{
+			variables.push_back(it.first);
+		}
+	}
+
+	auto variableSize = [&](Object::ID id) {
+		return getType(getType(getObject(id)).element).componentCount;
+	};
+
+	// Spill the state of the subgroup, and move on to the next one.
+	uint32_t slot = 0;
+	*Pointer<SIMD::Int>(phases->slot(slot++)) = state->activeLaneMask();
+
+	for(auto id : intermediates)
+	{
+		auto &intermediate = state->getIntermediate(id);
+		for(uint32_t i = 0; i < intermediate.componentCount; i++)
+		{
+			*Pointer<SIMD::Int>(phases->slot(slot++)) = intermediate.Int(i);
+		}
+	}
+
+	for(auto id : pointers)
+	{
+		auto &ptr = state->getPointer(id);
+		*Pointer<Pointer<Byte>>(phases->slot(slot++)) = ptr.base;
+		if(ptr.hasDynamicLimit)
+		{
+			*Pointer<Int>(phases->slot(slot++)) = ptr.dynamicLimit;
+		}
+		if(ptr.hasDynamicOffsets)
+		{
+			*Pointer<SIMD::Int>(phases->slot(slot++)) = ptr.dynamicOffsets;
+		}
+	}
+
+	for(auto id : variables)
+	{
+		auto &variable = routine->getVariable(id);
+		for(uint32_t i = 0; i < variableSize(id); i++)
+		{
+			*Pointer<SIMD::Float>(phases->slot(slot++)) = variable[i];
+		}
+	}
+
+	phases->end();
+
+	// Start the next phase by restoring the state of each subgroup.
+	RValue<SIMD::Int> storesAndAtomicsMask = phases->begin();
+	state->storesAndAtomicsMaskValue = storesAndAtomicsMask.value();
+
+	phases->slotCount = std::max(phases->slotCount, slot);
+	slot = 0;
+	SetActiveLaneMask(*Pointer<SIMD::Int>(phases->slot(slot++)), state);
+
+	for(auto id : intermediates)
+	{
+		auto componentCount = state->getIntermediate(id).componentCount;
+		state->intermediates.erase(id);
+
+		auto &intermediate = state->createIntermediate(id, componentCount);
+		for(uint32_t i = 0; i < componentCount; i++)
+		{
+			intermediate.move(i, *Pointer<SIMD::Int>(phases->slot(slot++)));
+		}
+	}
+
+	for(auto id : pointers)
+	{
+		auto &ptr = state->pointers.at(id);
+		ptr.base = *Pointer<Pointer<Byte>>(phases->slot(slot++));
+		if(ptr.hasDynamicLimit)
+		{
+			ptr.dynamicLimit = *Pointer<Int>(phases->slot(slot++));
+		}
+		if(ptr.hasDynamicOffsets)
+		{
+			ptr.dynamicOffsets = *Pointer<SIMD::Int>(phases->slot(slot++));
+		}
+	}
+
+	for(auto id : variables)
+	{
+		auto &variable = routine->getVariable(id);
+		for(uint32_t i = 0; i < variableSize(id); i++)
+		{
+			variable[i] = *Pointer<SIMD::Float>(phases->slot(slot++));
+		}
+	}
+}
+
 SpirvShader::EmitResult SpirvShader::EmitPhi(InsnIterator insn, EmitState *state) const
 {
 	auto &function = getFunction(state->function);
@@ -53,6 +53,10 @@ SpirvShader::EmitResult SpirvShader::EmitExtGLSLstd450(InsnIterator insn, EmitSt
 	auto &dst = state->createIntermediate(insn.resultId(), type.componentCount);
 	auto extInstIndex = static_cast<GLSLstd450>(insn.word(4));
 
+	// Signed and unsigned integer operations extend 8 and 16-bit operands
+	// according to the operation, regardless of their type's signedness.
+	auto width = getObjectType(insn.word(5)).componentWidth;
+
 	switch(extInstIndex)
 	{
 	case GLSLstd450FAbs:
@@ -69,7 +73,7 @@ SpirvShader::EmitResult SpirvShader::EmitExtGLSLstd450(InsnIterator insn, EmitSt
 			auto src = Operand(this, state, insn.word(5));
 			for(auto i = 0u; i < type.componentCount; i++)
 			{
-				dst.move(i, Abs(src.Int(i)));
+				dst.move(i, Abs(SignExtend(src.Int(i), width)));
 			}
 		}
 		break;
@@ -165,7 +169,7 @@ SpirvShader::EmitResult SpirvShader::EmitExtGLSLstd450(InsnIterator insn, EmitSt
 			auto rhs = Operand(this, state, insn.word(6));
 			for(auto i = 0u; i < type.componentCount; i++)
 			{
-				dst.move(i, Min(lhs.Int(i), rhs.Int(i)));
+				dst.move(i, Min(SignExtend(lhs.Int(i), width), SignExtend(rhs.Int(i), width)));
 			}
 		}
 		break;
@@ -175,7 +179,7 @@ SpirvShader::EmitResult SpirvShader::EmitExtGLSLstd450(InsnIterator insn, EmitSt
 			auto rhs = Operand(this, state, insn.word(6));
 			for(auto i = 0u; i < type.componentCount; i++)
 			{
-				dst.move(i, Max(lhs.Int(i), rhs.Int(i)));
+				dst.move(i, Max(SignExtend(lhs.Int(i), width), SignExtend(rhs.Int(i), width)));
 			}
 		}
 		break;
@@ -185,7 +189,7 @@ SpirvShader::EmitResult SpirvShader::EmitExtGLSLstd450(InsnIterator insn, EmitSt
 			auto rhs = Operand(this, state, insn.word(6));
 			for(auto i = 0u; i < type.componentCount; i++)
 			{
-				dst.move(i, Min(lhs.UInt(i), rhs.UInt(i)));
+				dst.move(i, Min(ZeroExtend(lhs.UInt(i), width), ZeroExtend(rhs.UInt(i), width)));
 			}
 		}
 		break;
@@ -195,7 +199,7 @@ SpirvShader::EmitResult SpirvShader::EmitExtGLSLstd450(InsnIterator insn, EmitSt
 			auto rhs = Operand(this, state, insn.word(6));
 			for(auto i = 0u; i < type.componentCount; i++)
 			{
-				dst.move(i, Max(lhs.UInt(i), rhs.UInt(i)));
+				dst.move(i, Max(ZeroExtend(lhs.UInt(i), width), ZeroExtend(rhs.UInt(i), width)));
 			}
 		}
 		break;
@@ -253,7 +257,7 @@ SpirvShader::EmitResult SpirvShader::EmitExtGLSLstd450(InsnIterator insn, EmitSt
 			auto maxVal = Operand(this, state, insn.word(7));
 			for(auto i = 0u; i < type.componentCount; i++)
 			{
-				dst.move(i, Min(Max(x.Int(i), minVal.Int(i)), maxVal.Int(i)));
+				dst.move(i, Min(Max(SignExtend(x.Int(i), width), SignExtend(minVal.Int(i), width)), SignExtend(maxVal.Int(i), width)));
 			}
 		}
 		break;
@@ -264,7 +268,7 @@ SpirvShader::EmitResult SpirvShader::EmitExtGLSLstd450(InsnIterator insn, EmitSt
 			auto maxVal = Operand(this, state, insn.word(7));
 			for(auto i = 0u; i < type.componentCount; i++)
 			{
-				dst.move(i, Min(Max(x.UInt(i), minVal.UInt(i)), maxVal.UInt(i)));
+				dst.move(i, Min(Max(ZeroExtend(x.UInt(i), width), ZeroExtend(minVal.UInt(i), width)), ZeroExtend(maxVal.UInt(i), width)));
 			}
 		}
 		break;
@@ -284,8 +288,8 @@ SpirvShader::EmitResult SpirvShader::EmitExtGLSLstd450(InsnIterator insn, EmitSt
 			auto src = Operand(this, state, insn.word(5));
 			for(auto i = 0u; i < type.componentCount; i++)
 			{
-				auto neg = CmpLT(src.Int(i), SIMD::Int(0)) & SIMD::Int(-1);
-				auto pos = CmpNLE(src.Int(i), SIMD::Int(0)) & SIMD::Int(1);
+				auto neg = CmpLT(SignExtend(src.Int(i), width), SIMD::Int(0)) & SIMD::Int(-1);
+				auto pos = CmpNLE(SignExtend(src.Int(i), width), SIMD::Int(0)) & SIMD::Int(1);
 				dst.move(i, neg | pos);
 			}
 		}
@@ -885,7 +889,8 @@ SpirvShader::EmitResult SpirvShader::EmitExtGLSLstd450(InsnIterator insn, EmitSt
 			auto val = Operand(this, state, insn.word(5));
 			for(auto i = 0u; i < type.componentCount; i++)
 			{
-				auto v = val.UInt(i) ^ As<SIMD::UInt>(CmpLT(val.Int(i), SIMD::Int(0)));
+				auto s = SignExtend(val.Int(i), width);
+				auto v = As<SIMD::UInt>(s) ^ As<SIMD::UInt>(CmpLT(s, SIMD::Int(0)));
 				dst.move(i, SIMD::UInt(31) - Ctlz(v, false));
 			}
 		}
@@ -895,7 +900,7 @@ SpirvShader::EmitResult SpirvShader::EmitExtGLSLstd450(InsnIterator insn, EmitSt
 			auto val = Operand(this, state, insn.word(5));
 			for(auto i = 0u; i < type.componentCount; i++)
 			{
-				dst.move(i, SIMD::UInt(31) - Ctlz(val.UInt(i), false));
+				dst.move(i, SIMD::UInt(31) - Ctlz(ZeroExtend(val.UInt(i), width), false));
 			}
 		}
 		break;
@@ -969,6 +974,8 @@ SpirvShader::EmitResult SpirvShader::EmitExtGLSLstd450(InsnIterator insn, EmitSt
 		break;
 	}
 
+	NarrowResult(dst, type);
+
 	return EmitResult::Continue;
 }
 
@@ -20,11 +20,24 @@ namespace sw {
 
 struct SpirvShader::Impl::Group
 {
+	// How the operands of a binary operation are extended from their narrow
+	// type. Narrow integers are held sign or zero-extended according to the
+	// signedness of their type, but min and max take it from the operation.
+	enum class Extend
+	{
+		None,
+		Sign,
+		Zero,
+	};
+
 	// Template function to perform a binary operation.
 	// |TYPE| should be the type of the binary operation (as a SIMD::<ScalarType>).
 	// |I| should be a type suitable to initialize the identity value.
 	// |APPLY| should be a callable object that takes two RValue<TYPE> parameters
 	// and returns a new RValue<TYPE> corresponding to the operation's result.
+	// Operands narrower than 32 bits are extended according to |extend|. Without
+	// an extension the partial results are narrowed after each step, so that
+	// they match evaluation at the operands' width.
 	template<typename TYPE, typename I, typename APPLY>
 	static void BinaryOperation(
 	    const SpirvShader *shader,
@@ -32,15 +45,38 @@ struct SpirvShader::Impl::Group
 	    const SpirvShader::EmitState *state,
 	    Intermediate &dst,
 	    const I identityValue,
-	    APPLY &&apply)
+	    APPLY &&apply,
+	    Extend extend = Extend::None)
 	{
 		SpirvShader::Operand value(shader, state, insn.word(5));
 		auto &type = shader->getType(SpirvShader::Type::ID(insn.word(1)));
+		auto &scalarType = shader->getComponentType(type);
+		auto width = scalarType.componentWidth;
+
+		auto step = [&](RValue<TYPE> a, RValue<TYPE> b) -> TYPE {
+			TYPE result = apply(a, b);
+			if(width < 32 && extend == Extend::None)
+			{
+				result = As<TYPE>(FromNarrowBits(ToNarrowBits(As<SIMD::UInt>(result), scalarType), scalarType));
+			}
+			return result;
+		};
+
 		for(auto i = 0u; i < type.componentCount; i++)
 		{
+			SIMD::UInt operand = value.UInt(i);
+			if(extend == Extend::Sign)
+			{
+				operand = As<SIMD::UInt>(SignExtend(value.Int(i), width));
+			}
+			else if(extend == Extend::Zero)
+			{
+				operand = ZeroExtend(operand, width);
+			}
+
 			auto mask = As<SIMD::UInt>(state->activeLaneMask());  // Considers helper invocations active. See b/151137030
 			auto identity = TYPE(identityValue);
-			SIMD::UInt v_uint = (value.UInt(i) & mask) | (As<SIMD::UInt>(identity) & ~mask);
+			SIMD::UInt v_uint = (operand & mask) | (As<SIMD::UInt>(identity) & ~mask);
 			TYPE v = As<TYPE>(v_uint);
 			switch(spv::GroupOperation(insn.word(4)))
 			{
@@ -48,23 +84,23 @@ struct SpirvShader::Impl::Group
 				{
 					// NOTE: floating-point add and multiply are not really commutative so
 					//       ensure that all values in the final lanes are identical
-					TYPE v2 = apply(v.xxzz, v.yyww);    // [xy]   [xy]   [zw]   [zw]
-					TYPE v3 = apply(v2.xxxx, v2.zzzz);  // [xyzw] [xyzw] [xyzw] [xyzw]
+					TYPE v2 = step(v.xxzz, v.yyww);    // [xy]   [xy]   [zw]   [zw]
+					TYPE v3 = step(v2.xxxx, v2.zzzz);  // [xyzw] [xyzw] [xyzw] [xyzw]
 					dst.move(i, v3);
 				}
 				break;
 			case spv::GroupOperationInclusiveScan:
 				{
-					TYPE v2 = apply(v, Shuffle(v, identity, 0x4012) /* [id, v.y, v.z, v.w] */);      // [x] [xy] [yz]  [zw]
-					TYPE v3 = apply(v2, Shuffle(v2, identity, 0x4401) /* [id,  id, v2.x, v2.y] */);  // [x] [xy] [xyz] [xyzw]
+					TYPE v2 = step(v, Shuffle(v, identity, 0x4012) /* [id, v.y, v.z, v.w] */);      // [x] [xy] [yz]  [zw]
+					TYPE v3 = step(v2, Shuffle(v2, identity, 0x4401) /* [id,  id, v2.x, v2.y] */);  // [x] [xy] [xyz] [xyzw]
 					dst.move(i, v3);
 				}
 				break;
 			case spv::GroupOperationExclusiveScan:
 				{
-					TYPE v2 = apply(v, Shuffle(v, identity, 0x4012) /* [id, v.y, v.z, v.w] */);      // [x] [xy] [yz]  [zw]
-					TYPE v3 = apply(v2, Shuffle(v2, identity, 0x4401) /* [id,  id, v2.x, v2.y] */);  // [x] [xy] [xyz] [xyzw]
-					auto v4 = Shuffle(v3, identity, 0x4012 /* [id, v3.x, v3.y, v3.z] */);            // [i] [x]  [xy]  [xyz]
+					TYPE v2 = step(v, Shuffle(v, identity, 0x4012) /* [id, v.y, v.z, v.w] */);      // [x] [xy] [yz]  [zw]
+					TYPE v3 = step(v2, Shuffle(v2, identity, 0x4401) /* [id,  id, v2.x, v2.y] */);  // [x] [xy] [xyz] [xyzw]
+					auto v4 = Shuffle(v3, identity, 0x4012 /* [id, v3.x, v3.y, v3.z] */);           // [i] [x]  [xy]  [xyz]
 					dst.move(i, v4);
 				}
 				break;
@@ -73,7 +109,14 @@ struct SpirvShader::Impl::Group
 				            SpirvShader::OpcodeName(type.opcode()), insn.word(4));
 			}
 		}
+
+		// Brings extended results and identities back into the operand type.
+		shader->NarrowResult(dst, type);
 	}
+
+	// Largest and smallest values of a signed integer type of the given width.
+	static int32_t SignedMax(uint32_t width) { return static_cast<int32_t>(~0u >> (33 - width)); }
+	static int32_t SignedMin(uint32_t width) { return -SignedMax(width) - 1; }
 };
 
 SpirvShader::EmitResult SpirvShader::EmitGroupNonUniform(InsnIterator insn, EmitState *state) const
@@ -387,14 +430,14 @@ SpirvShader::EmitResult SpirvShader::EmitGroupNonUniform(InsnIterator insn, Emit
 
 	case spv::OpGroupNonUniformSMin:
 		Impl::Group::BinaryOperation<SIMD::Int>(
-		    this, insn, state, dst, INT32_MAX,
-		    [](auto a, auto b) { return Min(a, b); });
+		    this, insn, state, dst, Impl::Group::SignedMax(getComponentType(type).componentWidth),
+		    [](auto a, auto b) { return Min(a, b); }, Impl::Group::Extend::Sign);
 		break;
 
 	case spv::OpGroupNonUniformUMin:
 		Impl::Group::BinaryOperation<SIMD::UInt>(
 		    this, insn, state, dst, ~0u,
-		    [](auto a, auto b) { return Min(a, b); });
+		    [](auto a, auto b) { return Min(a, b); }, Impl::Group::Extend::Zero);
 		break;
 
 	case spv::OpGroupNonUniformFMin:
@@ -405,14 +448,14 @@ SpirvShader::EmitResult SpirvShader::EmitGroupNonUniform(InsnIterator insn, Emit
 
 	case spv::OpGroupNonUniformSMax:
 		Impl::Group::BinaryOperation<SIMD::Int>(
-		    this, insn, state, dst, INT32_MIN,
-		    [](auto a, auto b) { return Max(a, b); });
+		    this, insn, state, dst, Impl::Group::SignedMin(getComponentType(type).componentWidth),
+		    [](auto a, auto b) { return Max(a, b); }, Impl::Group::Extend::Sign);
 		break;
 
 	case spv::OpGroupNonUniformUMax:
 		Impl::Group::BinaryOperation<SIMD::UInt>(
 		    this, insn, state, dst, 0,
-		    [](auto a, auto b) { return Max(a, b); });
+		    [](auto a, auto b) { return Max(a, b); }, Impl::Group::Extend::Zero);
 		break;
 
 	case spv::OpGroupNonUniformFMax:
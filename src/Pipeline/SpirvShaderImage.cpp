@@ -355,21 +355,62 @@ SpirvShader::EmitResult SpirvShader::EmitImageSample(const ImageInstruction &ins
 
 void SpirvShader::EmitImageSampleUnconditional(Array<SIMD::Float> &out, const ImageInstruction &instruction, EmitState *state) const
 {
-	Pointer<Byte> imageDescriptor = state->getPointer(instruction.imageId).base;  // vk::SampledImageDescriptor*
+	// Both point to vk::SampledImageDescriptor structures. Samplerless instructions
+	// don't read the sampler descriptor, so the image one stands in for it.
+	const SIMD::Pointer &image = state->getPointer(instruction.imageId);
+	const SIMD::Pointer &sampler = state->getPointer((instruction.samplerId != 0) ? instruction.samplerId : instruction.imageId);
 
-	Pointer<Byte> samplerFunction = lookupSamplerFunction(imageDescriptor, instruction, state);
+	Array<SIMD::Float> in(16);  // Maximum 16 input parameter components.
+	getSamplerFunctionInputs(in, instruction, state);
+
+	if(!image.hasDynamicOffsets && !sampler.hasDynamicOffsets)
+	{
+		Pointer<Byte> imageDescriptor = image.getUniformPointer();
+		Pointer<Byte> samplerFunction = lookupSamplerFunction(imageDescriptor, sampler.getUniformPointer(), instruction, state);
+
+		callSamplerFunction(samplerFunction, in, out, imageDescriptor, state);
+		return;
+	}
+
+	// Descriptor arrays indexed by a non-constant value can select a different
+	// descriptor for each lane. Sample once when all lanes agree, which is the
+	// common case, and otherwise once per active lane.
+	If(image.hasEqualOffsets() && sampler.hasEqualOffsets())
+	{
+		Pointer<Byte> imageDescriptor = image.getUniformPointer();
+		Pointer<Byte> samplerFunction = lookupSamplerFunction(imageDescriptor, sampler.getUniformPointer(), instruction, state);
+
+		callSamplerFunction(samplerFunction, in, out, imageDescriptor, state);
+	}
+	Else
+	{
+		SIMD::Int activeLaneMask = state->activeLaneMask();
+		Array<SIMD::Float> laneOut(4);
+
+		for(int lane = 0; lane < SIMD::Width; lane++)
+		{
+			If(Extract(activeLaneMask, lane) != 0)
+			{
+				Pointer<Byte> imageDescriptor = image.getPointerForLane(lane);
+				Pointer<Byte> samplerFunction = lookupSamplerFunction(imageDescriptor, sampler.getPointerForLane(lane), instruction, state);
+
+				callSamplerFunction(samplerFunction, in, laneOut, imageDescriptor, state);
 
-	callSamplerFunction(samplerFunction, out, imageDescriptor, instruction, state);
+				for(int i = 0; i < 4; i++)
+				{
+					out[i] = Insert(out[i], Extract(laneOut[i], lane), lane);
+				}
+			}
+		}
+	}
 }
 
-Pointer<Byte> SpirvShader::lookupSamplerFunction(Pointer<Byte> imageDescriptor, const ImageInstruction &instruction, EmitState *state) const
+Pointer<Byte> SpirvShader::lookupSamplerFunction(Pointer<Byte> imageDescriptor, Pointer<Byte> samplerDescriptor, const ImageInstruction &instruction, EmitState *state) const
 {
 	Int samplerId = 0;
 
 	if(instruction.samplerId != 0)
 	{
-		Pointer<Byte> samplerDescriptor = state->getPointer(instruction.samplerId).base;  // vk::SampledImageDescriptor*
-
 		samplerId = *Pointer<rr::Int>(samplerDescriptor + OFFSET(vk::SampledImageDescriptor, samplerId));  // vk::Sampler::id
 	}
 
@@ -387,10 +428,8 @@ Pointer<Byte> SpirvShader::lookupSamplerFunction(Pointer<Byte> imageDescriptor,
 	return cache.function;
 }
 
-void SpirvShader::callSamplerFunction(Pointer<Byte> samplerFunction, Array<SIMD::Float> &out, Pointer<Byte> imageDescriptor, const ImageInstruction &instruction, EmitState *state) const
+void SpirvShader::getSamplerFunctionInputs(Array<SIMD::Float> &in, const ImageInstruction &instruction, EmitState *state) const
 {
-	Array<SIMD::Float> in(16);  // Maximum 16 input parameter components.
-
 	auto coordinate = Operand(this, state, instruction.coordinateId);
 
 	uint32_t i = 0;
@@ -468,8 +507,11 @@ void SpirvShader::callSamplerFunction(Pointer<Byte> samplerFunction, Array<SIMD:
 		auto sampleValue = Operand(this, state, instruction.sampleId);
 		in[i] = As<SIMD::Float>(sampleValue.Int(0));
 	}
+}
 
-	Pointer<Byte> texture = imageDescriptor + OFFSET(vk::SampledImageDescriptor, texture);  // sw::Texture*
+void SpirvShader::callSamplerFunction(Pointer<Byte> samplerFunction, Array<SIMD::Float> &in, Array<SIMD::Float> &out, Pointer<Byte> imageDescriptor, EmitState *state) const
+{
+	Pointer<Byte> texture = *Pointer<Pointer<Byte>>(imageDescriptor + OFFSET(vk::SampledImageDescriptor, texture));  // sw::Texture*
 
 	Call<ImageSampler>(samplerFunction, texture, &in, &out, state->routine->constants);
 }
@@ -511,7 +553,7 @@ void SpirvShader::GetImageDimensions(EmitState const *state, Type const &resultT
 	const DescriptorDecorations &d = descriptorDecorations.at(imageId);
 	auto descriptorType = routine->pipelineLayout->getDescriptorType(d.DescriptorSet, d.Binding);
 
-	Pointer<Byte> descriptor = state->getPointer(imageId).base;
+	Pointer<Byte> descriptor = state->getPointer(imageId).getUniformPointer();
 
 	Int width;
 	Int height;
@@ -570,7 +612,7 @@ SpirvShader::EmitResult SpirvShader::EmitImageQueryLevels(InsnIterator insn, Emi
 	const DescriptorDecorations &d = descriptorDecorations.at(imageId);
 	auto descriptorType = state->routine->pipelineLayout->getDescriptorType(d.DescriptorSet, d.Binding);
 
-	Pointer<Byte> descriptor = state->getPointer(imageId).base;
+	Pointer<Byte> descriptor = state->getPointer(imageId).getUniformPointer();
 	Int mipLevels = 0;
 	switch(descriptorType)
 	{
@@ -602,7 +644,7 @@ SpirvShader::EmitResult SpirvShader::EmitImageQuerySamples(InsnIterator insn, Em
 	const DescriptorDecorations &d = descriptorDecorations.at(imageId);
 	auto descriptorType = state->routine->pipelineLayout->getDescriptorType(d.DescriptorSet, d.Binding);
 
-	Pointer<Byte> descriptor = state->getPointer(imageId).base;
+	Pointer<Byte> descriptor = state->getPointer(imageId).getUniformPointer();
 	Int sampleCount = 0;
 	switch(descriptorType)
 	{
@@ -761,7 +803,7 @@ SpirvShader::EmitResult SpirvShader::EmitImageRead(const ImageInstruction &instr
 		imageFormat = VK_FORMAT_S8_UINT;
 	}
 
-	Pointer<Byte> descriptor = state->getPointer(instruction.imageId).base;  // vk::StorageImageDescriptor*
+	Pointer<Byte> descriptor = state->getPointer(instruction.imageId).getUniformPointer();  // vk::StorageImageDescriptor*
 	auto &dst = state->createIntermediate(instruction.resultId, resultType.componentCount);
 
 	// VK_EXT_image_robustness requires replacing out-of-bounds access with zero.
@@ -1185,13 +1227,13 @@ SpirvShader::EmitResult SpirvShader::EmitImageWrite(const ImageInstruction &inst
 	texelAndMask[3] = texel.Int(3);
 	texelAndMask[4] = state->activeStoresAndAtomicsMask();
 
-	Pointer<Byte> descriptor = state->getPointer(instruction.imageId).base;  // vk::StorageImageDescriptor*
+	Pointer<Byte> descriptor = state->getPointer(instruction.imageId).getUniformPointer();  // vk::StorageImageDescriptor*
 
 	vk::Format imageFormat = SpirvFormatToVulkanFormat(static_cast<spv::ImageFormat>(instruction.imageFormat));
 
 	if(imageFormat == VK_FORMAT_UNDEFINED)  // spv::ImageFormatUnknown
 	{
-		Pointer<Byte> samplerFunction = lookupSamplerFunction(descriptor, instruction, state);
+		Pointer<Byte> samplerFunction = lookupSamplerFunction(descriptor, descriptor, instruction, state);
 
 		Call<ImageSampler>(samplerFunction, descriptor, &coord, &texelAndMask, state->routine->constants);
 	}
@@ -1433,7 +1475,7 @@ SpirvShader::EmitResult SpirvShader::EmitImageTexelPointer(const ImageInstructio
 {
 	auto coordinate = Operand(this, state, instruction.coordinateId);
 
-	Pointer<Byte> descriptor = state->getPointer(instruction.imageId).base;  // vk::StorageImageDescriptor*
+	Pointer<Byte> descriptor = state->getPointer(instruction.imageId).getUniformPointer();  // vk::StorageImageDescriptor*
 
 	// VK_EXT_image_robustness requires checking for out-of-bounds accesses.
 	// TODO(b/162327166): Only perform bounds checks when VK_EXT_image_robustness is enabled.
@@ -57,11 +57,20 @@ SpirvShader::EmitResult SpirvShader::EmitLoad(InsnIterator insn, EmitState *stat
 	bool interleavedByLane = IsStorageInterleavedByLane(pointerTy.storageClass);
 	auto &dst = state->createIntermediate(resultId, resultTy.componentCount);
 	auto robustness = state->getOutOfBoundsBehavior(pointerTy.storageClass);
+	bool explicitLayout = IsExplicitLayout(pointerTy.storageClass);
 
 	VisitMemoryObject(pointerId, [&](const MemoryElement &el) {
 		auto p = ptr + el.offset;
 		if(interleavedByLane) { p = InterleaveByLane(p); }  // TODO: Interleave once, then add offset?
-		dst.move(el.index, p.Load<SIMD::Float>(robustness, state->activeLaneMask(), atomic, memoryOrder));
+		if(explicitLayout && el.type.componentWidth < 32)
+		{
+			auto bits = p.LoadNarrow(el.type.componentWidth / 8, robustness, state->activeLaneMask());
+			dst.move(el.index, FromNarrowBits(bits, el.type));
+		}
+		else
+		{
+			dst.move(el.index, p.Load<SIMD::Float>(robustness, state->activeLaneMask(), atomic, memoryOrder));
+		}
 	});
 
 	SPIRV_SHADER_DBG("Load(atomic: {0}, order: {1}, ptr: {2}, val: {3}, mask: {4})", atomic, int(memoryOrder), ptr, dst, state->activeLaneMask());
@@ -110,10 +119,19 @@ void SpirvShader::Store(Object::ID pointerId, const Operand &value, bool atomic,
 
 	SPIRV_SHADER_DBG("Store(atomic: {0}, order: {1}, ptr: {2}, val: {3}, mask: {4}", atomic, int(memoryOrder), ptr, value, mask);
 
+	bool explicitLayout = IsExplicitLayout(pointerTy.storageClass);
+
 	VisitMemoryObject(pointerId, [&](const MemoryElement &el) {
 		auto p = ptr + el.offset;
 		if(interleavedByLane) { p = InterleaveByLane(p); }
-		p.Store(value.Float(el.index), robustness, mask, atomic, memoryOrder);
+		if(explicitLayout && el.type.componentWidth < 32)
+		{
+			p.StoreNarrow(el.type.componentWidth / 8, ToNarrowBits(value.UInt(el.index), el.type), robustness, mask);
+		}
+		else
+		{
+			p.Store(value.Float(el.index), robustness, mask, atomic, memoryOrder);
+		}
 	});
 }
 
@@ -249,12 +267,18 @@ SpirvShader::EmitResult SpirvShader::EmitCopyMemory(InsnIterator insn, EmitState
 
 	bool dstInterleavedByLane = IsStorageInterleavedByLane(dstPtrTy.storageClass);
 	bool srcInterleavedByLane = IsStorageInterleavedByLane(srcPtrTy.storageClass);
+	bool dstExplicitLayout = IsExplicitLayout(dstPtrTy.storageClass);
+	bool srcExplicitLayout = IsExplicitLayout(srcPtrTy.storageClass);
 	auto dstPtr = GetPointerToData(dstPtrId, 0, state);
 	auto srcPtr = GetPointerToData(srcPtrId, 0, state);
 
 	std::unordered_map<uint32_t, uint32_t> srcOffsets;
+	std::unordered_map<uint32_t, const Type *> srcTypes;
 
-	VisitMemoryObject(srcPtrId, [&](const MemoryElement &el) { srcOffsets[el.index] = el.offset; });
+	VisitMemoryObject(srcPtrId, [&](const MemoryElement &el) {
+		srcOffsets[el.index] = el.offset;
+		srcTypes[el.index] = &el.type;
+	});
 
 	VisitMemoryObject(dstPtrId, [&](const MemoryElement &el) {
 		auto it = srcOffsets.find(el.index);
@@ -270,8 +294,31 @@ SpirvShader::EmitResult SpirvShader::EmitCopyMemory(InsnIterator insn, EmitState
 		// TODO(b/131224163): Optimize based on src/dst storage classes.
 		auto robustness = OutOfBoundsBehavior::RobustBufferAccess;
 
-		auto value = src.Load<SIMD::Float>(robustness, state->activeLaneMask());
-		dst.Store(value, robustness, state->activeLaneMask());
+		// 8 and 16-bit scalars are only stored in their narrow form in memory with an explicit layout.
+		auto &srcType = *srcTypes.at(el.index);
+		bool srcNarrow = srcExplicitLayout && srcType.componentWidth < 32;
+		bool dstNarrow = dstExplicitLayout && el.type.componentWidth < 32;
+
+		if(srcNarrow && dstNarrow)
+		{
+			auto bits = src.LoadNarrow(srcType.componentWidth / 8, robustness, state->activeLaneMask());
+			dst.StoreNarrow(el.type.componentWidth / 8, bits, robustness, state->activeLaneMask());
+		}
+		else if(srcNarrow)
+		{
+			auto bits = src.LoadNarrow(srcType.componentWidth / 8, robustness, state->activeLaneMask());
+			dst.Store(As<SIMD::Float>(FromNarrowBits(bits, srcType)), robustness, state->activeLaneMask());
+		}
+		else if(dstNarrow)
+		{
+			auto value = As<SIMD::UInt>(src.Load<SIMD::Float>(robustness, state->activeLaneMask()));
+			dst.StoreNarrow(el.type.componentWidth / 8, ToNarrowBits(value, el.type), robustness, state->activeLaneMask());
+		}
+		else
+		{
+			auto value = src.Load<SIMD::Float>(robustness, state->activeLaneMask());
+			dst.Store(value, robustness, state->activeLaneMask());
+		}
 	});
 	return EmitResult::Continue;
 }
@@ -308,7 +355,7 @@ void SpirvShader::VisitMemoryObjectInner(sw::SpirvShader::Type::ID id, sw::Spirv
 		break;
 	case spv::OpTypeVector:
 		{
-			auto elemStride = (d.InsideMatrix && d.HasRowMajor && d.RowMajor) ? d.MatrixStride : static_cast<int32_t>(sizeof(float));
+			auto elemStride = (d.InsideMatrix && d.HasRowMajor && d.RowMajor) ? d.MatrixStride : static_cast<int32_t>(type.componentWidth / 8);
 			for(auto i = 0u; i < type.definition.word(3); i++)
 			{
 				VisitMemoryObjectInner(type.definition.word(2), d, index, offset + elemStride * i, f);
@@ -317,7 +364,7 @@ void SpirvShader::VisitMemoryObjectInner(sw::SpirvShader::Type::ID id, sw::Spirv
 		break;
 	case spv::OpTypeMatrix:
 		{
-			auto columnStride = (d.HasRowMajor && d.RowMajor) ? static_cast<int32_t>(sizeof(float)) : d.MatrixStride;
+			auto columnStride = (d.HasRowMajor && d.RowMajor) ? static_cast<int32_t>(type.componentWidth / 8) : d.MatrixStride;
 			d.InsideMatrix = true;
 			for(auto i = 0u; i < type.definition.word(3); i++)
 			{
@@ -169,9 +169,19 @@ void SpirvShader::EvalSpecConstantUnaryOp(InsnIterator insn)
 		switch(opcode)
 		{
 		case spv::OpSConvert:
-		case spv::OpFConvert:
+			{
+				auto shift = 32 - getType(lhs).componentWidth;
+				v = static_cast<uint32_t>(static_cast<int32_t>(l << shift) >> shift);
+			}
+			break;
 		case spv::OpUConvert:
-			UNREACHABLE("Not possible until we have multiple bit widths");
+			{
+				auto shift = 32 - getType(lhs).componentWidth;
+				v = (l << shift) >> shift;
+			}
+			break;
+		case spv::OpFConvert:
+			v = l;
 			break;
 
 		case spv::OpSNegate:
@@ -200,6 +210,8 @@ void SpirvShader::EvalSpecConstantUnaryOp(InsnIterator insn)
 		default:
 			UNREACHABLE("EvalSpecConstantUnaryOp op: %s", OpcodeName(opcode));
 		}
+
+		v = NarrowConstant(v, getComponentType(getType(result)));
 	}
 }
 
@@ -308,6 +320,8 @@ void SpirvShader::EvalSpecConstantBinaryOp(InsnIterator insn)
 		default:
 			UNREACHABLE("EvalSpecConstantBinaryOp op: %s", OpcodeName(opcode));
 		}
+
+		v = NarrowConstant(v, getComponentType(getType(result)));
 	}
 }
 
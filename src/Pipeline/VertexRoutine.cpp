@@ -45,42 +45,118 @@ void VertexRoutine::generate()
 	Pointer<Byte> vertexCache = cache + OFFSET(VertexCache, vertex);
 	Pointer<UInt> tagCache = Pointer<UInt>(cache + OFFSET(VertexCache, tag));
 
-	UInt vertexCount = *Pointer<UInt>(task + OFFSET(VertexTask, vertexCount));
+	Int vertexCount = *Pointer<Int>(task + OFFSET(VertexTask, vertexCount));
+	UInt invocations = 0;
+	UInt simdGroups = 0;
 
 	constants = device + OFFSET(vk::Device, constants);
 
-	// Check the cache one vertex index at a time. If a hit occurs, copy from the cache to the 'vertex' output buffer.
-	// On a cache miss, process a SIMD width of consecutive indices from the input batch. They're written to the cache
-	// in reverse order to guarantee that the first one doesn't get evicted and can be written out.
+	// For points, vertexCount is 1 per primitive, so the vertex is duplicated for all 3 vertices of the primitive
+	const int outputStride = (state.isPoint ? 3 : 1) * sizeof(Vertex);
 
-	Do
+	// First check the cache one vertex index at a time. If a hit occurs, copy from the cache to the 'vertex' output
+	// buffer. Each index which misses is claimed in the cache and appended to a list of unique misses, and later
+	// occurrences of it in the batch refer to the output of its first occurrence. The misses are then shaded in
+	// full SIMD groups, writing directly to the outputs of their first occurrences, from which the cache entries
+	// and the remaining outputs get copied.
+
+	Array<Int> owner(VertexCache::SIZE);  // Output which gets shaded for each cache entry, or -1.
+	Array<UInt> missIndex(MaxBatchSize * 3 + SIMD::Width);
+	Array<Int> missOutput(MaxBatchSize * 3);
+	Array<Int> source(MaxBatchSize * 3);  // Output to copy from once shading is done, or -1.
+	Int missCount = 0;
+
+	For(Int i = 0, i < Int(VertexCache::SIZE), i++)
+	{
+		owner[i] = -1;
+	}
+
+	For(Int i = 0, i < vertexCount, i++)
 	{
-		UInt index = *batch;
-		UInt cacheIndex = index & VertexCache::TAG_MASK;
+		UInt index = batch[i];
+		Int cacheIndex = Int(index & VertexCache::TAG_MASK);
+		source[i] = -1;
 
-		If(tagCache[cacheIndex] != index)
+		If(tagCache[cacheIndex] == index)
+		{
+			If(owner[cacheIndex] >= 0)
+			{
+				source[i] = owner[cacheIndex];
+			}
+			Else
+			{
+				writeVertex(vertex + i * outputStride, vertexCache + cacheIndex * Int(sizeof(Vertex)));
+			}
+		}
+		Else
 		{
-			readInput(batch);
-			program(batch, vertexCount);
-			computeClipFlags();
-			computeCullMask();
+			tagCache[cacheIndex] = index;
+			owner[cacheIndex] = i;
+			missIndex[missCount] = index;
+			missOutput[missCount] = i;
+			missCount++;
+		}
+	}
 
-			writeCache(vertexCache, tagCache, batch);
+	If(missCount > 0)
+	{
+		// Pad the last SIMD group with the last index, so all lanes read valid vertex attributes.
+		UInt lastIndex = missIndex[missCount - 1];
+		for(int i = 0; i < SIMD::Width - 1; i++)
+		{
+			missIndex[missCount + i] = lastIndex;
 		}
+	}
 
-		Pointer<Byte> cacheEntry = vertexCache + cacheIndex * UInt((int)sizeof(Vertex));
+	Pointer<Byte> misses = Pointer<Byte>(&missIndex);
+
+	For(Int i = 0, i < missCount, i += SIMD::Width)
+	{
+		Pointer<UInt> group = Pointer<UInt>(misses + i * Int(sizeof(uint32_t)));
+		UInt groupCount = UInt(missCount - i);
 
-		// For points, vertexCount is 1 per primitive, so duplicate vertex for all 3 vertices of the primitive
-		for(int i = 0; i < (state.isPoint ? 3 : 1); i++)
+		invocations += Min(groupCount, UInt(SIMD::Width));
+		simdGroups++;
+
+		readInput(group);
+		program(group, groupCount);
+		computeClipFlags();
+		computeCullMask();
+
+		Pointer<Byte> outputs[4];
+		for(int lane = 0; lane < 4; lane++)
 		{
-			writeVertex(vertex, cacheEntry);
-			vertex += sizeof(Vertex);
+			outputs[lane] = vertex + missOutput[Min(i + lane, missCount - 1)] * outputStride;
 		}
 
-		batch = Pointer<UInt>(Pointer<Byte>(batch) + sizeof(uint32_t));
-		vertexCount--;
+		writeVertices(outputs);
 	}
-	Until(vertexCount == 0);
+
+	For(Int i = 0, i < Int(VertexCache::SIZE), i++)
+	{
+		If(owner[i] >= 0)
+		{
+			writeVertex(vertexCache + i * Int(sizeof(Vertex)), vertex + owner[i] * outputStride);
+		}
+	}
+
+	For(Int i = 0, i < vertexCount, i++)
+	{
+		Pointer<Byte> output = vertex + i * outputStride;
+
+		If(source[i] >= 0)
+		{
+			writeVertex(output, vertex + source[i] * outputStride);
+		}
+
+		for(int j = 1; j < (state.isPoint ? 3 : 1); j++)
+		{
+			writeVertex(output + j * sizeof(Vertex), output);
+		}
+	}
+
+	*Pointer<UInt>(task + OFFSET(VertexTask, invocations)) = invocations;
+	*Pointer<UInt>(task + OFFSET(VertexTask, simdGroups)) = simdGroups;
 
 	Return();
 }
@@ -565,24 +641,9 @@ Vector4f VertexRoutine::readStream(Pointer<Byte> &buffer, UInt &stride, const St
 	return v;
 }
 
-void VertexRoutine::writeCache(Pointer<Byte> &vertexCache, Pointer<UInt> &tagCache, Pointer<UInt> &batch)
+void VertexRoutine::writeVertices(Pointer<Byte> outputs[4])
 {
-	UInt index0 = batch[0];
-	UInt index1 = batch[1];
-	UInt index2 = batch[2];
-	UInt index3 = batch[3];
-
-	UInt cacheIndex0 = index0 & VertexCache::TAG_MASK;
-	UInt cacheIndex1 = index1 & VertexCache::TAG_MASK;
-	UInt cacheIndex2 = index2 & VertexCache::TAG_MASK;
-	UInt cacheIndex3 = index3 & VertexCache::TAG_MASK;
-
-	// We processed a SIMD group of vertices, with the first one being the one that missed the cache tag check.
-	// Write them out in reverse order here and below to ensure the first one is now guaranteed to be in the cache.
-	tagCache[cacheIndex3] = index3;
-	tagCache[cacheIndex2] = index2;
-	tagCache[cacheIndex1] = index1;
-	tagCache[cacheIndex0] = index0;
+	// Lanes past the end of the last SIMD group duplicate its last vertex, and write the same output.
 
 	auto it = spirvShader->outputBuiltins.find(spv::BuiltInPosition);
 	if(it != spirvShader->outputBuiltins.end())
@@ -608,22 +669,22 @@ void VertexRoutine::writeCache(Pointer<Byte> &vertexCache, Pointer<UInt> &tagCac
 
 		transpose4x4(pos.x, pos.y, pos.z, pos.w);
 
-		*Pointer<Float4>(vertexCache + sizeof(Vertex) * cacheIndex3 + OFFSET(Vertex, position), 16) = pos.w;
-		*Pointer<Float4>(vertexCache + sizeof(Vertex) * cacheIndex2 + OFFSET(Vertex, position), 16) = pos.z;
-		*Pointer<Float4>(vertexCache + sizeof(Vertex) * cacheIndex1 + OFFSET(Vertex, position), 16) = pos.y;
-		*Pointer<Float4>(vertexCache + sizeof(Vertex) * cacheIndex0 + OFFSET(Vertex, position), 16) = pos.x;
+		*Pointer<Float4>(outputs[3] + OFFSET(Vertex, position), 16) = pos.w;
+		*Pointer<Float4>(outputs[2] + OFFSET(Vertex, position), 16) = pos.z;
+		*Pointer<Float4>(outputs[1] + OFFSET(Vertex, position), 16) = pos.y;
+		*Pointer<Float4>(outputs[0] + OFFSET(Vertex, position), 16) = pos.x;
 
-		*Pointer<Int>(vertexCache + sizeof(Vertex) * cacheIndex3 + OFFSET(Vertex, clipFlags)) = (clipFlags >> 24) & 0x0000000FF;
-		*Pointer<Int>(vertexCache + sizeof(Vertex) * cacheIndex2 + OFFSET(Vertex, clipFlags)) = (clipFlags >> 16) & 0x0000000FF;
-		*Pointer<Int>(vertexCache + sizeof(Vertex) * cacheIndex1 + OFFSET(Vertex, clipFlags)) = (clipFlags >> 8) & 0x0000000FF;
-		*Pointer<Int>(vertexCache + sizeof(Vertex) * cacheIndex0 + OFFSET(Vertex, clipFlags)) = (clipFlags >> 0) & 0x0000000FF;
+		*Pointer<Int>(outputs[3] + OFFSET(Vertex, clipFlags)) = (clipFlags >> 24) & 0x0000000FF;
+		*Pointer<Int>(outputs[2] + OFFSET(Vertex, clipFlags)) = (clipFlags >> 16) & 0x0000000FF;
+		*Pointer<Int>(outputs[1] + OFFSET(Vertex, clipFlags)) = (clipFlags >> 8) & 0x0000000FF;
+		*Pointer<Int>(outputs[0] + OFFSET(Vertex, clipFlags)) = (clipFlags >> 0) & 0x0000000FF;
 
 		transpose4x4(proj.x, proj.y, proj.z, proj.w);
 
-		*Pointer<Float4>(vertexCache + sizeof(Vertex) * cacheIndex3 + OFFSET(Vertex, projected), 16) = proj.w;
-		*Pointer<Float4>(vertexCache + sizeof(Vertex) * cacheIndex2 + OFFSET(Vertex, projected), 16) = proj.z;
-		*Pointer<Float4>(vertexCache + sizeof(Vertex) * cacheIndex1 + OFFSET(Vertex, projected), 16) = proj.y;
-		*Pointer<Float4>(vertexCache + sizeof(Vertex) * cacheIndex0 + OFFSET(Vertex, projected), 16) = proj.x;
+		*Pointer<Float4>(outputs[3] + OFFSET(Vertex, projected), 16) = proj.w;
+		*Pointer<Float4>(outputs[2] + OFFSET(Vertex, projected), 16) = proj.z;
+		*Pointer<Float4>(outputs[1] + OFFSET(Vertex, projected), 16) = proj.y;
+		*Pointer<Float4>(outputs[0] + OFFSET(Vertex, projected), 16) = proj.x;
 	}
 
 	it = spirvShader->outputBuiltins.find(spv::BuiltInPointSize);
@@ -632,10 +693,10 @@ void VertexRoutine::writeCache(Pointer<Byte> &vertexCache, Pointer<UInt> &tagCac
 		ASSERT(it->second.SizeInComponents == 1);
 		auto psize = routine.getVariable(it->second.Id)[it->second.FirstComponent];
 
-		*Pointer<Float>(vertexCache + sizeof(Vertex) * cacheIndex3 + OFFSET(Vertex, pointSize)) = Extract(psize, 3);
-		*Pointer<Float>(vertexCache + sizeof(Vertex) * cacheIndex2 + OFFSET(Vertex, pointSize)) = Extract(psize, 2);
-		*Pointer<Float>(vertexCache + sizeof(Vertex) * cacheIndex1 + OFFSET(Vertex, pointSize)) = Extract(psize, 1);
-		*Pointer<Float>(vertexCache + sizeof(Vertex) * cacheIndex0 + OFFSET(Vertex, pointSize)) = Extract(psize, 0);
+		*Pointer<Float>(outputs[3] + OFFSET(Vertex, pointSize)) = Extract(psize, 3);
+		*Pointer<Float>(outputs[2] + OFFSET(Vertex, pointSize)) = Extract(psize, 2);
+		*Pointer<Float>(outputs[1] + OFFSET(Vertex, pointSize)) = Extract(psize, 1);
+		*Pointer<Float>(outputs[0] + OFFSET(Vertex, pointSize)) = Extract(psize, 0);
 	}
 
 	it = spirvShader->outputBuiltins.find(spv::BuiltInClipDistance);
@@ -645,10 +706,10 @@ void VertexRoutine::writeCache(Pointer<Byte> &vertexCache, Pointer<UInt> &tagCac
 		for(unsigned int i = 0; i < count; i++)
 		{
 			auto dist = routine.getVariable(it->second.Id)[it->second.FirstComponent + i];
-			*Pointer<Float>(vertexCache + sizeof(Vertex) * cacheIndex3 + OFFSET(Vertex, clipDistance[i])) = Extract(dist, 3);
-			*Pointer<Float>(vertexCache + sizeof(Vertex) * cacheIndex2 + OFFSET(Vertex, clipDistance[i])) = Extract(dist, 2);
-			*Pointer<Float>(vertexCache + sizeof(Vertex) * cacheIndex1 + OFFSET(Vertex, clipDistance[i])) = Extract(dist, 1);
-			*Pointer<Float>(vertexCache + sizeof(Vertex) * cacheIndex0 + OFFSET(Vertex, clipDistance[i])) = Extract(dist, 0);
+			*Pointer<Float>(outputs[3] + OFFSET(Vertex, clipDistance[i])) = Extract(dist, 3);
+			*Pointer<Float>(outputs[2] + OFFSET(Vertex, clipDistance[i])) = Extract(dist, 2);
+			*Pointer<Float>(outputs[1] + OFFSET(Vertex, clipDistance[i])) = Extract(dist, 1);
+			*Pointer<Float>(outputs[0] + OFFSET(Vertex, clipDistance[i])) = Extract(dist, 0);
 		}
 	}
 
@@ -659,17 +720,17 @@ void VertexRoutine::writeCache(Pointer<Byte> &vertexCache, Pointer<UInt> &tagCac
 		for(unsigned int i = 0; i < count; i++)
 		{
 			auto dist = routine.getVariable(it->second.Id)[it->second.FirstComponent + i];
-			*Pointer<Float>(vertexCache + sizeof(Vertex) * cacheIndex3 + OFFSET(Vertex, cullDistance[i])) = Extract(dist, 3);
-			*Pointer<Float>(vertexCache + sizeof(Vertex) * cacheIndex2 + OFFSET(Vertex, cullDistance[i])) = Extract(dist, 2);
-			*Pointer<Float>(vertexCache + sizeof(Vertex) * cacheIndex1 + OFFSET(Vertex, cullDistance[i])) = Extract(dist, 1);
-			*Pointer<Float>(vertexCache + sizeof(Vertex) * cacheIndex0 + OFFSET(Vertex, cullDistance[i])) = Extract(dist, 0);
+			*Pointer<Float>(outputs[3] + OFFSET(Vertex, cullDistance[i])) = Extract(dist, 3);
+			*Pointer<Float>(outputs[2] + OFFSET(Vertex, cullDistance[i])) = Extract(dist, 2);
+			*Pointer<Float>(outputs[1] + OFFSET(Vertex, cullDistance[i])) = Extract(dist, 1);
+			*Pointer<Float>(outputs[0] + OFFSET(Vertex, cullDistance[i])) = Extract(dist, 0);
 		}
 	}
 
-	*Pointer<Int>(vertexCache + sizeof(Vertex) * cacheIndex3 + OFFSET(Vertex, cullMask)) = -((cullMask >> 3) & 1);
-	*Pointer<Int>(vertexCache + sizeof(Vertex) * cacheIndex2 + OFFSET(Vertex, cullMask)) = -((cullMask >> 2) & 1);
-	*Pointer<Int>(vertexCache + sizeof(Vertex) * cacheIndex1 + OFFSET(Vertex, cullMask)) = -((cullMask >> 1) & 1);
-	*Pointer<Int>(vertexCache + sizeof(Vertex) * cacheIndex0 + OFFSET(Vertex, cullMask)) = -((cullMask >> 0) & 1);
+	*Pointer<Int>(outputs[3] + OFFSET(Vertex, cullMask)) = -((cullMask >> 3) & 1);
+	*Pointer<Int>(outputs[2] + OFFSET(Vertex, cullMask)) = -((cullMask >> 2) & 1);
+	*Pointer<Int>(outputs[1] + OFFSET(Vertex, cullMask)) = -((cullMask >> 1) & 1);
+	*Pointer<Int>(outputs[0] + OFFSET(Vertex, cullMask)) = -((cullMask >> 0) & 1);
 
 	for(int i = 0; i < MAX_INTERFACE_COMPONENTS; i += 4)
 	{
@@ -686,15 +747,15 @@ void VertexRoutine::writeCache(Pointer<Byte> &vertexCache, Pointer<UInt> &tagCac
 
 			transpose4x4(v.x, v.y, v.z, v.w);
 
-			*Pointer<Float4>(vertexCache + sizeof(Vertex) * cacheIndex3 + OFFSET(Vertex, v[i]), 16) = v.w;
-			*Pointer<Float4>(vertexCache + sizeof(Vertex) * cacheIndex2 + OFFSET(Vertex, v[i]), 16) = v.z;
-			*Pointer<Float4>(vertexCache + sizeof(Vertex) * cacheIndex1 + OFFSET(Vertex, v[i]), 16) = v.y;
-			*Pointer<Float4>(vertexCache + sizeof(Vertex) * cacheIndex0 + OFFSET(Vertex, v[i]), 16) = v.x;
+			*Pointer<Float4>(outputs[3] + OFFSET(Vertex, v[i]), 16) = v.w;
+			*Pointer<Float4>(outputs[2] + OFFSET(Vertex, v[i]), 16) = v.z;
+			*Pointer<Float4>(outputs[1] + OFFSET(Vertex, v[i]), 16) = v.y;
+			*Pointer<Float4>(outputs[0] + OFFSET(Vertex, v[i]), 16) = v.x;
 		}
 	}
 }
 
-void VertexRoutine::writeVertex(const Pointer<Byte> &vertex, Pointer<Byte> &cacheEntry)
+void VertexRoutine::writeVertex(const Pointer<Byte> &vertex, const Pointer<Byte> &cacheEntry)
 {
 	*Pointer<Int4>(vertex + OFFSET(Vertex, position)) = *Pointer<Int4>(cacheEntry + OFFSET(Vertex, position));
 	*Pointer<Int>(vertex + OFFSET(Vertex, pointSize)) = *Pointer<Int>(cacheEntry + OFFSET(Vertex, pointSize));
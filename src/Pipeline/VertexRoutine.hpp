@@ -77,8 +77,8 @@ private:
 	void readInput(Pointer<UInt> &batch);
 	void computeClipFlags();
 	void computeCullMask();
-	void writeCache(Pointer<Byte> &vertexCache, Pointer<UInt> &tagCache, Pointer<UInt> &batch);
-	void writeVertex(const Pointer<Byte> &vertex, Pointer<Byte> &cacheEntry);
+	void writeVertices(Pointer<Byte> outputs[4]);
+	void writeVertex(const Pointer<Byte> &vertex, const Pointer<Byte> &cacheEntry);
 };
 
 }  // namespace sw
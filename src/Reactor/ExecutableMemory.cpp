@@ -37,6 +37,8 @@
 #	include <sys/prctl.h>
 #endif
 
+#include <atomic>
+
 #include <memory.h>
 
 #undef allocate
@@ -58,6 +60,8 @@
 namespace rr {
 namespace {
 
+std::atomic<uint64_t> executableBytesAllocated = { 0 };
+
 struct Allocation
 {
 	// size_t bytes;
@@ -358,9 +362,19 @@ void *allocateMemoryPages(size_t bytes, int permissions, bool need_exec)
 	protectMemoryPages(mapping, length, permissions);
 #endif
 
+	if(mapping && need_exec)
+	{
+		executableBytesAllocated.fetch_add(length, std::memory_order_relaxed);
+	}
+
 	return mapping;
 }
 
+uint64_t executableMemoryAllocated()
+{
+	return executableBytesAllocated.load(std::memory_order_relaxed);
+}
+
 void protectMemoryPages(void *memory, size_t bytes, int permissions)
 {
 	if(bytes == 0)
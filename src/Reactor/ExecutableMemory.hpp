@@ -40,6 +40,10 @@ void protectMemoryPages(void *memory, size_t bytes, int permissions);
 // Releases memory allocated with allocateMemoryPages().
 void deallocateMemoryPages(void *memory, size_t bytes);
 
+// Returns the total number of bytes allocated so far by allocateMemoryPages()
+// with |need_exec| set, including memory since released.
+uint64_t executableMemoryAllocated();
+
 template<typename P>
 P unaligned_read(P *address)
 {
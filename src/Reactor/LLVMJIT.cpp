@@ -17,6 +17,7 @@
 #include "Debug.hpp"
 #include "ExecutableMemory.hpp"
 #include "LLVMAsm.hpp"
+#include "PerfMap.hpp"
 #include "PragmaInternals.hpp"
 #include "Routine.hpp"
 
@@ -26,12 +27,17 @@ __pragma(warning(push))
     __pragma(warning(disable : 4146))  // unary minus operator applied to unsigned type, result still unsigned
 #endif
 
+#ifdef ENABLE_RR_DEBUG_INFO
+#	include "llvm/DebugInfo/DWARF/DWARFContext.h"
+#endif  // ENABLE_RR_DEBUG_INFO
+#include "llvm/ExecutionEngine/JITEventListener.h"
 #include "llvm/ExecutionEngine/Orc/CompileUtils.h"
 #include "llvm/ExecutionEngine/Orc/IRCompileLayer.h"
 #include "llvm/ExecutionEngine/Orc/RTDyldObjectLinkingLayer.h"
 #include "llvm/ExecutionEngine/SectionMemoryManager.h"
 #include "llvm/IR/DiagnosticInfo.h"
 #include "llvm/IR/LegacyPassManager.h"
+#include "llvm/Object/ELFObjectFile.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Host.h"
 #include "llvm/Support/TargetSelect.h"
@@ -44,6 +50,8 @@ __pragma(warning(push))
     __pragma(warning(pop))
 #endif
 
+#include <unordered_map>
+
 #if defined(_WIN64)
         extern "C" void __chkstk();
 #elif defined(_WIN32)
@@ -687,6 +695,91 @@ struct FatalDiagnosticsHandler : public llvm::DiagnosticHandler
 	bool *fatal;
 };
 
+// Records the load address and size of each function in the objects emitted
+// for a routine, and their line tables when debug info is emitted, so that
+// they can be published through rr::PerfMap.
+struct FunctionInfoListener : public llvm::JITEventListener
+{
+	void notifyObjectLoaded(ObjectKey key,
+	                        const llvm::object::ObjectFile &obj,
+	                        const llvm::RuntimeDyld::LoadedObjectInfo &info) override
+	{
+		if(!enabled)
+		{
+			return;
+		}
+
+		// Only ELF objects carry symbol sizes, and perf is only available on Linux.
+		auto elf = llvm::dyn_cast<llvm::object::ELFObjectFileBase>(&obj);
+		if(!elf)
+		{
+			return;
+		}
+
+#ifdef ENABLE_RR_DEBUG_INFO
+		// The object for debugging has its sections at their load addresses.
+		auto debugObject = info.getObjectForDebug(obj);
+		std::unique_ptr<llvm::DIContext> debugContext;
+		if(debugObject.getBinary())
+		{
+			debugContext = llvm::DWARFContext::create(*debugObject.getBinary());
+		}
+#endif  // ENABLE_RR_DEBUG_INFO
+
+		for(const llvm::object::ELFSymbolRef &symbol : elf->symbols())
+		{
+			auto type = symbol.getType();
+			auto address = symbol.getAddress();
+			auto section = symbol.getSection();
+
+			if(!type || !address || !section ||
+			   *type != llvm::object::SymbolRef::ST_Function ||
+			   *section == obj.section_end())
+			{
+				llvm::consumeError(type.takeError());
+				llvm::consumeError(address.takeError());
+				llvm::consumeError(section.takeError());
+				continue;
+			}
+
+			uint64_t offset = *address - (*section)->getAddress();
+			uint64_t loadAddress = info.getSectionLoadAddress(**section) + offset;
+			sizes[loadAddress] = symbol.getSize();
+
+#ifdef ENABLE_RR_DEBUG_INFO
+			if(debugContext)
+			{
+				llvm::object::SectionedAddress sectionedAddress = { loadAddress, (*section)->getIndex() };
+				auto table = debugContext->getLineInfoForAddressRange(sectionedAddress, symbol.getSize(),
+				                                                      llvm::DILineInfoSpecifier::FileLineInfoKind::AbsoluteFilePath);
+
+				std::vector<rr::PerfMap::Line> &functionLines = lines[loadAddress];
+				for(const auto &row : table)
+				{
+					functionLines.push_back({ reinterpret_cast<const void *>(static_cast<uintptr_t>(row.first)), row.second.FileName, static_cast<int>(row.second.Line) });
+				}
+			}
+#endif  // ENABLE_RR_DEBUG_INFO
+		}
+	}
+
+	size_t sizeAt(const void *address) const
+	{
+		auto it = sizes.find(reinterpret_cast<uintptr_t>(address));
+		return (it != sizes.end()) ? it->second : 0;
+	}
+
+	std::vector<rr::PerfMap::Line> linesAt(const void *address) const
+	{
+		auto it = lines.find(reinterpret_cast<uintptr_t>(address));
+		return (it != lines.end()) ? it->second : std::vector<rr::PerfMap::Line>();
+	}
+
+	bool enabled = false;
+	std::unordered_map<uint64_t, uint64_t> sizes;
+	std::unordered_map<uint64_t, std::vector<rr::PerfMap::Line>> lines;  // Empty without debug info
+};
+
 // JITRoutine is a rr::Routine that holds a LLVM JIT session, compiler and
 // object layer as each routine may require different target machine
 // settings and no Reactor routine directly links against another.
@@ -713,19 +806,34 @@ public:
 		bool fatalCompileIssue = false;
 		context->setDiagnosticHandler(std::make_unique<FatalDiagnosticsHandler>(&fatalCompileIssue), true);
 
-#ifdef ENABLE_RR_DEBUG_INFO
+		functionInfo.enabled = rr::PerfMap::isEnabled();
+
+#if LLVM_VERSION_MAJOR < 11
 		// TODO(b/165000222): Update this on next LLVM roll.
 		// https://github.com/llvm/llvm-project/commit/98f2bb4461072347dcca7d2b1b9571b3a6525801
 		// introduces RTDyldObjectLinkingLayer::registerJITEventListener().
 		// The current API does not appear to have any way to bind the
 		// rr::DebugInfo::NotifyFreeingObject event.
+		objectLayer.setNotifyLoaded([this](llvm::orc::VModuleKey key,
+		                                   const llvm::object::ObjectFile &obj,
+		                                   const llvm::RuntimeDyld::LoadedObjectInfo &l) {
+#	ifdef ENABLE_RR_DEBUG_INFO
+			static std::atomic<uint64_t> unique_key{ 0 };
+			rr::DebugInfo::NotifyObjectEmitted(unique_key++, obj, l);
+#	endif  // ENABLE_RR_DEBUG_INFO
+			functionInfo.notifyObjectLoaded(key, obj, l);
+		});
+#else
+#	ifdef ENABLE_RR_DEBUG_INFO
 		objectLayer.setNotifyLoaded([](llvm::orc::VModuleKey,
 		                               const llvm::object::ObjectFile &obj,
 		                               const llvm::RuntimeDyld::LoadedObjectInfo &l) {
 			static std::atomic<uint64_t> unique_key{ 0 };
 			rr::DebugInfo::NotifyObjectEmitted(unique_key++, obj, l);
 		});
-#endif  // ENABLE_RR_DEBUG_INFO
+#	endif  // ENABLE_RR_DEBUG_INFO
+		objectLayer.registerJITEventListener(functionInfo);
+#endif
 
 		if(JITGlobals::get()->getTargetTriple().isOSBinFormatCOFF())
 		{
@@ -790,6 +898,15 @@ public:
 #ifdef ENABLE_RR_EMIT_ASM_FILE
 		rr::AsmFile::fixupAsmFile(asmFilename, addresses);
 #endif
+
+		if(functionInfo.enabled)
+		{
+			for(size_t i = 0; i < count; i++)
+			{
+				std::string perfName = (i == 0) ? this->name : this->name + "::" + (*functionNames[i]).str();
+				rr::PerfMap::notifyFunctionEmitted(perfName.c_str(), addresses[i], functionInfo.sizeAt(addresses[i]), functionInfo.linesAt(addresses[i]));
+			}
+		}
 	}
 
 	~JITRoutine()
@@ -809,6 +926,7 @@ public:
 
 private:
 	std::string name;
+	FunctionInfoListener functionInfo;  // Must outlive the objectLayer
 	llvm::orc::ExecutionSession session;
 	llvm::orc::RTDyldObjectLinkingLayer objectLayer;
 	std::vector<const void *> addresses;
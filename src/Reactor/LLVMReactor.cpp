@@ -27,6 +27,7 @@
 #include "llvm/IR/LegacyPassManager.h"
 #include "llvm/IR/Verifier.h"
 #include "llvm/Support/Alignment.h"
+#include "llvm/Support/Host.h"
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Transforms/Coroutines.h"
 #include "llvm/Transforms/IPO.h"
@@ -137,6 +138,23 @@ llvm::Value *lowerPABS(llvm::Value *v)
 }
 #endif  // defined(__i386__) || defined(__x86_64__)
 
+llvm::Value *lowerFMulAdd(llvm::Value *x, llvm::Value *y, llvm::Value *z)
+{
+	llvm::Function *fmuladd = llvm::Intrinsic::getDeclaration(
+	    jit->module.get(), llvm::Intrinsic::fmuladd, { x->getType() });
+	return jit->builder->CreateCall(fmuladd, { x, y, z });
+}
+
+bool detectFMA()
+{
+#if defined(__aarch64__)
+	return true;  // Fused multiply-add is part of the base AArch64 ISA.
+#else
+	llvm::StringMap<bool> cpuFeatures;
+	return llvm::sys::getHostCPUFeatures(cpuFeatures) && cpuFeatures.lookup("fma");
+#endif
+}
+
 #if !defined(__i386__) && !defined(__x86_64__)
 llvm::Value *lowerPFMINMAX(llvm::Value *x, llvm::Value *y,
                            llvm::FCmpInst::Predicate pred)
@@ -391,7 +409,8 @@ std::string BackendName()
 }
 
 const Capabilities Caps = {
-	true,  // CoroutinesSupported
+	true,         // CoroutinesSupported
+	detectFMA(),  // FMASupported
 };
 
 // The abstract Type* types are implemented as LLVM types, except that
@@ -571,6 +590,9 @@ Config Nucleus::getDefaultConfig()
 
 std::shared_ptr<Routine> Nucleus::acquireRoutine(const char *name, const Config::Edit *cfgEdit /* = nullptr */)
 {
+	auto compiledCallback = getRoutineCompiledCallback();
+	auto compileStart = std::chrono::steady_clock::now();
+
 	if(jit->builder->GetInsertBlock()->empty() || !jit->builder->GetInsertBlock()->back().isTerminator())
 	{
 		llvm::Type *type = jit->function->getReturnType();
@@ -642,6 +664,11 @@ std::shared_ptr<Routine> Nucleus::acquireRoutine(const char *name, const Config:
 	acquire(jit);
 #endif
 
+	if(compiledCallback)
+	{
+		compiledCallback(name, std::chrono::steady_clock::now() - compileStart);
+	}
+
 	return routine;
 }
 
@@ -3212,6 +3239,13 @@ RValue<Float4> Sqrt(RValue<Float4> x)
 #endif
 }
 
+RValue<Float4> MulAdd(RValue<Float4> x, RValue<Float4> y, RValue<Float4> z)
+{
+	RR_DEBUG_INFO_UPDATE_LOC();
+	// llvm.fmuladd is fused only when the host has hardware support for it.
+	return RValue<Float4>(V(lowerFMulAdd(V(x.value()), V(y.value()), V(z.value()))));
+}
+
 RValue<Int> SignMask(RValue<Float4> x)
 {
 	RR_DEBUG_INFO_UPDATE_LOC();
@@ -4380,6 +4414,9 @@ void Nucleus::yield(Value *val)
 
 std::shared_ptr<Routine> Nucleus::acquireCoroutine(const char *name, const Config::Edit *cfgEdit /* = nullptr */)
 {
+	auto compiledCallback = getRoutineCompiledCallback();
+	auto compileStart = std::chrono::steady_clock::now();
+
 	bool isCoroutine = jit->coroutine.id != nullptr;
 	if(isCoroutine)
 	{
@@ -4459,6 +4496,11 @@ std::shared_ptr<Routine> Nucleus::acquireCoroutine(const char *name, const Confi
 	delete jit;
 	jit = nullptr;
 
+	if(compiledCallback)
+	{
+		compiledCallback(name, std::chrono::steady_clock::now() - compileStart);
+	}
+
 	return routine;
 }
 
@@ -17,6 +17,7 @@
 
 #include <atomic>
 #include <cassert>
+#include <chrono>
 #include <cstdarg>
 #include <cstdint>
 #include <functional>
@@ -345,6 +346,15 @@ public:
 	// Sets the callback to be used by the next optimizer invocation (during acquireRoutine),
 	// for reporting stats about the resulting IR code. For testing only.
 	static void setOptimizerCallback(OptimizerCallback *callback);
+
+	using RoutineCompiledCallback = void(const char *name, std::chrono::nanoseconds duration);
+
+	// Sets the callback invoked after each routine or coroutine is acquired,
+	// on the thread which acquired it, with its name and the time spent
+	// optimizing and compiling it. Unlike the optimizer callback it remains set, for all
+	// threads, so that clients can gather statistics about their routines.
+	static void setRoutineCompiledCallback(RoutineCompiledCallback *callback);
+	static RoutineCompiledCallback *getRoutineCompiledCallback();
 };
 
 }  // namespace rr
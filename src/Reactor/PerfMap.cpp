@@ -0,0 +1,376 @@
+// Copyright 2021 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "PerfMap.hpp"
+
+#include "Debug.hpp"
+
+#if defined(__linux__)
+#	include <elf.h>
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/syscall.h>
+#	include <time.h>
+#	include <unistd.h>
+#endif
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+namespace rr {
+
+#if defined(__linux__)
+
+namespace {
+
+// Record layouts from the perf jitdump specification:
+// tools/perf/Documentation/jitdump-specification.txt in the Linux kernel tree.
+struct JitdumpHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t totalSize;
+	uint32_t elfMach;
+	uint32_t pad1;
+	uint32_t pid;
+	uint64_t timestamp;
+	uint64_t flags;
+};
+
+struct JitdumpCodeLoad
+{
+	uint32_t id;
+	uint32_t totalSize;
+	uint64_t timestamp;
+	uint32_t pid;
+	uint32_t tid;
+	uint64_t vma;
+	uint64_t codeAddress;
+	uint64_t codeSize;
+	uint64_t codeIndex;
+	// Followed by the null-terminated function name and the code bytes.
+};
+
+struct JitdumpDebugInfo
+{
+	uint32_t id;
+	uint32_t totalSize;
+	uint64_t timestamp;
+	uint64_t codeAddress;
+	uint64_t entryCount;
+	// Followed by the entries.
+};
+
+struct JitdumpDebugEntry
+{
+	uint64_t address;
+	int32_t line;
+	int32_t discriminator;
+	// Followed by the null-terminated file name.
+};
+
+constexpr uint32_t kJitdumpMagic = 0x4A695444;  // "JiTD"
+constexpr uint32_t kJitdumpVersion = 1;
+constexpr uint32_t kJitCodeLoad = 0;
+constexpr uint32_t kJitCodeDebugInfo = 2;
+
+// perf inject turns each code load record into an ELF file whose code is
+// preceded by its ELF header, and doesn't account for it in the addresses of
+// the line table. Offset them the same way LLVM's PerfJITEventListener does.
+constexpr uint64_t kJitdumpElfHeaderSize = 0x40;
+
+constexpr uint32_t elfMachine()
+{
+#	if defined(__x86_64__)
+	return EM_X86_64;
+#	elif defined(__i386__)
+	return EM_386;
+#	elif defined(__aarch64__)
+	return EM_AARCH64;
+#	elif defined(__arm__)
+	return EM_ARM;
+#	elif defined(__mips__)
+	return EM_MIPS;
+#	else
+	return EM_NONE;
+#	endif
+}
+
+// perf correlates jitdump records with samples using CLOCK_MONOTONIC
+// (perf record -k 1).
+uint64_t timestamp()
+{
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+}
+
+class PerfOutput
+{
+public:
+	static PerfOutput &get()
+	{
+		static PerfOutput instance;
+		return instance;
+	}
+
+	bool isEnabled()
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		return perfMapEnabled || !jitdumpDirectory.empty();
+	}
+
+	void setEnabled(bool perfMap, const std::string &directory)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		closeFiles();
+		perfMapEnabled = perfMap;
+		jitdumpDirectory = directory;
+	}
+
+	void write(const char *name, const void *code, size_t size, const std::vector<PerfMap::Line> &lines)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+
+		if(perfMapEnabled)
+		{
+			writePerfMapEntry(name, code, size);
+		}
+
+		if(!jitdumpDirectory.empty())
+		{
+			writeJitdumpEntry(name, code, size, lines);
+		}
+	}
+
+private:
+	PerfOutput()
+	{
+		perfMapEnabled = getenv("REACTOR_PERF_MAP") != nullptr;
+
+		if(const char *directory = getenv("REACTOR_PERF_JITDUMP"))
+		{
+			jitdumpDirectory = (directory[0] == '/') ? directory : "/tmp";
+		}
+	}
+
+	~PerfOutput()
+	{
+		closeFiles();
+	}
+
+	void writePerfMapEntry(const char *name, const void *code, size_t size)
+	{
+		if(!perfMapFile)
+		{
+			perfMapFile = fopen(PerfMap::perfMapPath().c_str(), "a");
+			if(!perfMapFile)
+			{
+				warn("Failed to open %s\n", PerfMap::perfMapPath().c_str());
+				perfMapEnabled = false;
+				return;
+			}
+		}
+
+		fprintf(perfMapFile, "%" PRIxPTR " %zx %s\n", reinterpret_cast<uintptr_t>(code), size, name);
+		fflush(perfMapFile);
+	}
+
+	void writeJitdumpEntry(const char *name, const void *code, size_t size, const std::vector<PerfMap::Line> &lines)
+	{
+		if(jitdumpFd < 0 && !openJitdump())
+		{
+			jitdumpDirectory.clear();
+			return;
+		}
+
+		// The debug info must precede the code load record it describes.
+		if(!lines.empty())
+		{
+			writeJitdumpDebugInfo(code, lines);
+		}
+
+		const size_t nameSize = strlen(name) + 1;
+
+		JitdumpCodeLoad record = {};
+		record.id = kJitCodeLoad;
+		record.totalSize = static_cast<uint32_t>(sizeof(record) + nameSize + size);
+		record.timestamp = timestamp();
+		record.pid = static_cast<uint32_t>(getpid());
+		record.tid = static_cast<uint32_t>(syscall(SYS_gettid));
+		record.vma = reinterpret_cast<uintptr_t>(code);
+		record.codeAddress = reinterpret_cast<uintptr_t>(code);
+		record.codeSize = size;
+		record.codeIndex = codeIndex++;
+
+		writeFully(&record, sizeof(record));
+		writeFully(name, nameSize);
+		writeFully(code, size);
+	}
+
+	void writeJitdumpDebugInfo(const void *code, const std::vector<PerfMap::Line> &lines)
+	{
+		size_t totalSize = sizeof(JitdumpDebugInfo);
+		for(const PerfMap::Line &line : lines)
+		{
+			totalSize += sizeof(JitdumpDebugEntry) + line.file.size() + 1;
+		}
+
+		JitdumpDebugInfo record = {};
+		record.id = kJitCodeDebugInfo;
+		record.totalSize = static_cast<uint32_t>(totalSize);
+		record.timestamp = timestamp();
+		record.codeAddress = reinterpret_cast<uintptr_t>(code);
+		record.entryCount = lines.size();
+
+		writeFully(&record, sizeof(record));
+
+		for(const PerfMap::Line &line : lines)
+		{
+			JitdumpDebugEntry entry = {};
+			entry.address = reinterpret_cast<uintptr_t>(line.address) + kJitdumpElfHeaderSize;
+			entry.line = line.line;
+
+			writeFully(&entry, sizeof(entry));
+			writeFully(line.file.c_str(), line.file.size() + 1);
+		}
+	}
+
+	bool openJitdump()
+	{
+		std::string path = jitdumpDirectory + "/jit-" + std::to_string(getpid()) + ".dump";
+		jitdumpFd = open(path.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0666);
+		if(jitdumpFd < 0)
+		{
+			warn("Failed to open %s\n", path.c_str());
+			return false;
+		}
+
+		// perf discovers the jitdump file through an executable mapping of it
+		// recorded in the profile.
+		jitdumpMarker = mmap(nullptr, sysconf(_SC_PAGESIZE), PROT_READ | PROT_EXEC, MAP_PRIVATE, jitdumpFd, 0);
+		if(jitdumpMarker == MAP_FAILED)
+		{
+			jitdumpMarker = nullptr;
+		}
+
+		JitdumpHeader header = {};
+		header.magic = kJitdumpMagic;
+		header.version = kJitdumpVersion;
+		header.totalSize = sizeof(header);
+		header.elfMach = elfMachine();
+		header.pid = static_cast<uint32_t>(getpid());
+		header.timestamp = timestamp();
+		writeFully(&header, sizeof(header));
+
+		return true;
+	}
+
+	void writeFully(const void *data, size_t size)
+	{
+		auto bytes = reinterpret_cast<const uint8_t *>(data);
+		while(size > 0)
+		{
+			ssize_t written = ::write(jitdumpFd, bytes, size);
+			if(written <= 0)
+			{
+				return;
+			}
+			bytes += written;
+			size -= written;
+		}
+	}
+
+	void closeFiles()
+	{
+		if(perfMapFile)
+		{
+			fclose(perfMapFile);
+			perfMapFile = nullptr;
+		}
+
+		if(jitdumpMarker)
+		{
+			munmap(jitdumpMarker, sysconf(_SC_PAGESIZE));
+			jitdumpMarker = nullptr;
+		}
+
+		if(jitdumpFd >= 0)
+		{
+			close(jitdumpFd);
+			jitdumpFd = -1;
+		}
+	}
+
+	std::mutex mutex;
+	bool perfMapEnabled = false;
+	std::string jitdumpDirectory;  // Empty when jitdump output is disabled
+
+	FILE *perfMapFile = nullptr;
+	int jitdumpFd = -1;
+	void *jitdumpMarker = nullptr;
+	uint64_t codeIndex = 0;
+};
+
+}  // anonymous namespace
+
+bool PerfMap::isEnabled()
+{
+	return PerfOutput::get().isEnabled();
+}
+
+void PerfMap::setEnabled(bool perfMap, const std::string &jitdumpDirectory)
+{
+	PerfOutput::get().setEnabled(perfMap, jitdumpDirectory);
+}
+
+std::string PerfMap::perfMapPath()
+{
+	return "/tmp/perf-" + std::to_string(getpid()) + ".map";
+}
+
+void PerfMap::notifyFunctionEmitted(const char *name, const void *code, size_t size, const std::vector<Line> &lines)
+{
+	if(code && size > 0)
+	{
+		PerfOutput::get().write(name, code, size, lines);
+	}
+}
+
+#else  // !defined(__linux__)
+
+bool PerfMap::isEnabled()
+{
+	return false;
+}
+
+void PerfMap::setEnabled(bool perfMap, const std::string &jitdumpDirectory)
+{
+}
+
+std::string PerfMap::perfMapPath()
+{
+	return "";
+}
+
+void PerfMap::notifyFunctionEmitted(const char *name, const void *code, size_t size, const std::vector<Line> &lines)
+{
+}
+
+#endif  // defined(__linux__)
+
+}  // namespace rr
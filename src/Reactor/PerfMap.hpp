@@ -0,0 +1,67 @@
+// Copyright 2021 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef rr_PerfMap_hpp
+#define rr_PerfMap_hpp
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace rr {
+
+// PerfMap publishes the names and address ranges of JIT-compiled routines to
+// the Linux `perf` profiler, so samples in generated code can be attributed
+// to the routine which produced them.
+//
+// Setting the REACTOR_PERF_MAP environment variable appends an entry per
+// routine function to /tmp/perf-<pid>.map. Setting REACTOR_PERF_JITDUMP to a
+// directory (or to any other value for /tmp) additionally writes a jitdump
+// file, jit-<pid>.dump, containing the code bytes, for use with
+// `perf record -k 1` and `perf inject --jit`. When Reactor emits debug info
+// (REACTOR_EMIT_DEBUG_INFO), the jitdump also maps the code to the source
+// lines which generated it.
+//
+// On platforms other than Linux these functions are no-ops.
+class PerfMap
+{
+public:
+	// Returns true if any perf output is enabled. Backends use this to skip
+	// gathering code sizes when nobody is listening.
+	static bool isEnabled();
+
+	// Overrides the state set by the environment variables. An empty
+	// jitdumpDirectory disables the jitdump output.
+	static void setEnabled(bool perfMap, const std::string &jitdumpDirectory = "");
+
+	// Returns the path of the perf map file for the current process.
+	static std::string perfMapPath();
+
+	// The source line of the code starting at |address|, up to the next line's.
+	struct Line
+	{
+		const void *address;
+		std::string file;
+		int line;
+	};
+
+	// Records that |size| bytes of executable code for the function |name|
+	// have been made available at |code|. |lines| is the function's line
+	// table, empty if the code has no debug info.
+	static void notifyFunctionEmitted(const char *name, const void *code, size_t size, const std::vector<Line> &lines = {});
+};
+
+}  // namespace rr
+
+#endif  // rr_PerfMap_hpp
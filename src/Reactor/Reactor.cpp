@@ -67,6 +67,18 @@ void rr::Config::Edit::apply(const std::vector<std::pair<ListEdit, T>> &edits, s
 	}
 }
 
+static std::atomic<Nucleus::RoutineCompiledCallback *> routineCompiledCallback = { nullptr };
+
+void Nucleus::setRoutineCompiledCallback(RoutineCompiledCallback *callback)
+{
+	routineCompiledCallback = callback;
+}
+
+Nucleus::RoutineCompiledCallback *Nucleus::getRoutineCompiledCallback()
+{
+	return routineCompiledCallback.load(std::memory_order_relaxed);
+}
+
 thread_local Variable::UnmaterializedVariables *Variable::unmaterializedVariables = nullptr;
 
 void Variable::UnmaterializedVariables::add(const Variable *v)
@@ -82,6 +82,7 @@ std::string BackendName();
 struct Capabilities
 {
 	bool CoroutinesSupported;  // Support for rr::Coroutine<F>
+	bool FMASupported;         // MulAdd(Float4) is fused into a single rounding
 };
 extern const Capabilities Caps;
 
@@ -2354,6 +2355,8 @@ RValue<Float4> RcpSqrt_pp(RValue<Float4> val);
 RValue<Float4> Rcp(RValue<Float4> x, Precision p = Precision::Full, bool finite = false, bool exactAtPow2 = false);
 RValue<Float4> RcpSqrt(RValue<Float4> x, Precision p = Precision::Full);
 RValue<Float4> Sqrt(RValue<Float4> x);
+// Returns x * y + z, fused into a single rounding when Caps.FMASupported.
+RValue<Float4> MulAdd(RValue<Float4> x, RValue<Float4> y, RValue<Float4> z);
 RValue<Float4> Insert(RValue<Float4> val, RValue<Float> element, int i);
 RValue<Float> Extract(RValue<Float4> x, int i);
 RValue<Float4> Swizzle(RValue<Float4> x, uint16_t select);
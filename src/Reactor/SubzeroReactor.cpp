@@ -21,6 +21,7 @@
 
 #include "ExecutableMemory.hpp"
 #include "Optimizer.hpp"
+#include "PerfMap.hpp"
 
 #include "src/IceCfg.h"
 #include "src/IceCfgNode.h"
@@ -49,6 +50,8 @@
 #		define NOMINMAX
 #	endif  // !NOMINMAX
 #	include <Windows.h>
+#	include <immintrin.h>
+#	include <intrin.h>
 #endif
 
 #include <array>
@@ -289,17 +292,18 @@ class CPUID
 public:
 	const static bool ARM;
 	const static bool SSE4_1;
+	const static bool AVX2;  // Also implies FMA3 support
 
 private:
-	static void cpuid(int registers[4], int info)
+	static void cpuid(int registers[4], int info, int subleaf = 0)
 	{
 #if defined(__i386__) || defined(__x86_64__)
 #	if defined(_WIN32)
-		__cpuid(registers, info);
+		__cpuidex(registers, info, subleaf);
 #	else
 		__asm volatile("cpuid"
 		               : "=a"(registers[0]), "=b"(registers[1]), "=c"(registers[2]), "=d"(registers[3])
-		               : "a"(info));
+		               : "a"(info), "c"(subleaf));
 #	endif
 #else
 		registers[0] = 0;
@@ -309,6 +313,24 @@ private:
 #endif
 	}
 
+	// Returns the XCR0 register, which indicates which register states the OS saves.
+	static uint64_t xgetbv()
+	{
+#if defined(__i386__) || defined(__x86_64__)
+#	if defined(_WIN32)
+		return _xgetbv(0);
+#	else
+		uint32_t eax, edx;
+		__asm volatile("xgetbv"
+		               : "=a"(eax), "=d"(edx)
+		               : "c"(0));
+		return (static_cast<uint64_t>(edx) << 32) | eax;
+#	endif
+#else
+		return 0;
+#endif
+	}
+
 	constexpr static bool detectARM()
 	{
 #if defined(__arm__) || defined(__aarch64__)
@@ -330,12 +352,46 @@ private:
 		return (registers[2] & 0x00080000) != 0;
 #else
 		return false;
+#endif
+	}
+
+	static bool detectAVX2()
+	{
+		// Only the x86-64 Subzero backend implements VEX-encoded instructions.
+#if defined(__x86_64__)
+		int registers[4];
+		cpuid(registers, 0);
+		if(registers[0] < 7)
+		{
+			return false;
+		}
+
+		cpuid(registers, 1);
+		const bool fma = (registers[2] & 0x00001000) != 0;
+		const bool osxsave = (registers[2] & 0x08000000) != 0;
+		const bool avx = (registers[2] & 0x10000000) != 0;
+		if(!fma || !osxsave || !avx)
+		{
+			return false;
+		}
+
+		// The OS must save and restore the XMM and YMM register states.
+		if((xgetbv() & 0x6) != 0x6)
+		{
+			return false;
+		}
+
+		cpuid(registers, 7, 0);
+		return (registers[1] & 0x00000020) != 0;
+#else
+		return false;
 #endif
 	}
 };
 
 constexpr bool CPUID::ARM = CPUID::detectARM();
 const bool CPUID::SSE4_1 = CPUID::detectSSE4_1();
+const bool CPUID::AVX2 = CPUID::detectAVX2();
 constexpr bool emulateIntrinsics = false;
 constexpr bool emulateMismatchedBitCast = CPUID::ARM;
 
@@ -357,7 +413,8 @@ std::string BackendName()
 }
 
 const Capabilities Caps = {
-	true,  // CoroutinesSupported
+	true,         // CoroutinesSupported
+	CPUID::AVX2,  // FMASupported
 };
 
 enum EmulatedType
@@ -892,7 +949,7 @@ Nucleus::Nucleus()
 	Flags.setTargetInstructionSet(Ice::BaseInstructionSet);
 #else  // x86
 	Flags.setTargetArch(sizeof(void *) == 8 ? Ice::Target_X8664 : Ice::Target_X8632);
-	Flags.setTargetInstructionSet(CPUID::SSE4_1 ? Ice::X86InstructionSet_SSE4_1 : Ice::X86InstructionSet_SSE2);
+	Flags.setTargetInstructionSet(CPUID::AVX2 ? Ice::X86InstructionSet_AVX2 : CPUID::SSE4_1 ? Ice::X86InstructionSet_SSE4_1 : Ice::X86InstructionSet_SSE2);
 #endif
 	Flags.setOutFileType(Ice::FT_Elf);
 	Flags.setOptLevel(toIce(getDefaultConfig().getOptimization().getLevel()));
@@ -991,6 +1048,9 @@ static std::shared_ptr<Routine> acquireRoutine(Ice::Cfg *const (&functions)[Coun
 	// This logic is modeled after the IceCompiler, as well as GlobalContext::translateFunctions
 	// and GlobalContext::emitItems.
 
+	auto compiledCallback = Nucleus::getRoutineCompiledCallback();
+	auto compileStart = std::chrono::steady_clock::now();
+
 	if(subzeroDumpEnabled)
 	{
 		// Output dump strings immediately, rather than once buffer is full. Useful for debugging.
@@ -1083,9 +1143,31 @@ static std::shared_ptr<Routine> acquireRoutine(Ice::Cfg *const (&functions)[Coun
 
 	::routine->finalize();
 
+	if(PerfMap::isEnabled())
+	{
+		// Entry points after the first are named after the routine they belong to.
+		size_t i = 0;
+		for(const char *name : names)
+		{
+			std::string perfName = name;
+			if(i != 0)
+			{
+				perfName = std::string(names[0]) + "::" + name;
+			}
+
+			PerfMap::notifyFunctionEmitted(perfName.c_str(), entryPoints[i].entry, entryPoints[i].codeSize);
+			i++;
+		}
+	}
+
 	Routine *handoffRoutine = ::routine;
 	::routine = nullptr;
 
+	if(compiledCallback)
+	{
+		compiledCallback(names[0], std::chrono::steady_clock::now() - compileStart);
+	}
+
 	return std::shared_ptr<Routine>(handoffRoutine);
 }
 
@@ -4031,6 +4113,27 @@ RValue<Float4> Sqrt(RValue<Float4> x)
 	}
 }
 
+RValue<Float4> MulAdd(RValue<Float4> x, RValue<Float4> y, RValue<Float4> z)
+{
+	RR_DEBUG_INFO_UPDATE_LOC();
+	if(emulateIntrinsics || !CPUID::AVX2)
+	{
+		return x * y + z;
+	}
+	else
+	{
+		Ice::Variable *result = ::function->makeVariable(Ice::IceType_v4f32);
+		const Ice::Intrinsics::IntrinsicInfo intrinsic = { Ice::Intrinsics::FusedMultiplyAdd, Ice::Intrinsics::SideEffects_F, Ice::Intrinsics::ReturnsTwice_F, Ice::Intrinsics::MemoryWrite_F };
+		auto fma = Ice::InstIntrinsic::create(::function, 3, result, intrinsic);
+		fma->addArg(x.value());
+		fma->addArg(y.value());
+		fma->addArg(z.value());
+		::basicBlock->appendInst(fma);
+
+		return RValue<Float4>(V(result));
+	}
+}
+
 RValue<Int> SignMask(RValue<Float4> x)
 {
 	RR_DEBUG_INFO_UPDATE_LOC();
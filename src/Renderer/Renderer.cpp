@@ -31,6 +31,8 @@
 #include "Common/Timer.hpp"
 #include "Common/Debug.hpp"
 
+#include "marl/trace.h"
+
 #undef max
 
 bool disableServer = true;
@@ -63,7 +65,6 @@ namespace sw
 
 	static const int batchSize = 128;
 	AtomicInt threadCount(1);
-	AtomicInt Renderer::unitCount(1);
 	AtomicInt Renderer::clusterCount(1);
 
 	TranscendentalPrecision logPrecision = ACCURATE;
@@ -90,12 +91,6 @@ namespace sw
 		}
 	}
 
-	struct Parameters
-	{
-		Renderer *renderer;
-		int threadIndex;
-	};
-
 	Query::Query(Type type) : building(false), data(0), type(type), reference(1)
 	{
 	}
@@ -142,6 +137,26 @@ namespace sw
 		deallocate(data);
 	}
 
+	Renderer::BatchData::BatchData()
+	{
+		triangles = (Triangle*)allocate(batchSize * sizeof(Triangle));
+		primitives = (Primitive*)allocate(batchSize * sizeof(Primitive));
+
+		vertexTask = (VertexTask*)allocate(sizeof(VertexTask));
+		vertexTask->vertexCache.drawCall = -1;
+
+		firstPrimitive = 0;
+		primitiveCount = 0;
+		visible = 0;
+	}
+
+	Renderer::BatchData::~BatchData()
+	{
+		deallocate(triangles);
+		deallocate(primitives);
+		deallocate(vertexTask);
+	}
+
 	Renderer::Renderer(Context *context, Conventions conventions, bool exactColorRounding) : VertexProcessor(context), PixelProcessor(context), SetupProcessor(context), context(context), viewport()
 	{
 		setGlobalRenderingSettings(conventions, exactColorRounding);
@@ -155,48 +170,13 @@ namespace sw
 		updateProjectionMatrix = true;
 		updateClipPlanes = true;
 
-		#if PERF_HUD
-			resetTimers();
-		#endif
-
-		for(int i = 0; i < 16; i++)
-		{
-			vertexTask[i] = 0;
-
-			worker[i] = 0;
-			resume[i] = 0;
-			suspend[i] = 0;
-		}
-
-		threadsAwake = 0;
 		resumeApp = new Event();
 
-		currentDraw = 0;
-		nextDraw = 0;
-
-		qHead = 0;
-		qSize = 0;
-
-		for(int i = 0; i < 16; i++)
-		{
-			triangleBatch[i] = 0;
-			primitiveBatch[i] = 0;
-		}
+		nextDrawID = 0;
 
 		for(int draw = 0; draw < DRAW_COUNT; draw++)
 		{
 			drawCall[draw] = new DrawCall();
-			drawList[draw] = drawCall[draw];
-		}
-
-		for(int unit = 0; unit < 16; unit++)
-		{
-			primitiveProgress[unit].init();
-		}
-
-		for(int cluster = 0; cluster < 16; cluster++)
-		{
-			pixelProgress[cluster].init();
 		}
 
 		clipFlags = 0;
@@ -288,7 +268,7 @@ namespace sw
 
 			int batch = batchSize / ms;
 
-			int (Renderer::*setupPrimitives)(int batch, int count);
+			int (Renderer::*setupPrimitives)(Triangle *triangle, Primitive *primitive, const DrawCall &draw, int count);
 
 			if(context->isDrawTriangle())
 			{
@@ -328,7 +308,6 @@ namespace sw
 					if(drawCall[i]->references == -1)
 					{
 						draw = drawCall[i];
-						drawList[nextDraw & DRAW_COUNT_BITS] = draw;
 
 						break;
 					}
@@ -357,6 +336,7 @@ namespace sw
 				}
 			}
 
+			draw->id = nextDrawID++;
 			draw->drawType = drawType;
 			draw->batchSize = batch;
 
@@ -685,36 +665,10 @@ namespace sw
 				data->scissorY1 = scissor.y1;
 			}
 
-			draw->primitive = 0;
 			draw->count = count;
+			draw->references = 1;
 
-			draw->references = (count + batch - 1) / batch;
-
-			schedulerMutex.lock();
-			++nextDraw; // Atomic
-			schedulerMutex.unlock();
-
-			#ifndef NDEBUG
-			if(threadCount == 1)   // Use main thread for draw execution
-			{
-				threadsAwake = 1;
-				task[0].type = Task::RESUME;
-
-				taskLoop(0);
-			}
-			else
-			#endif
-			{
-				if(!threadsAwake)
-				{
-					suspend[0]->wait();
-
-					threadsAwake = 1;
-					task[0].type = Task::RESUME;
-
-					resume[0]->signal();
-				}
-			}
+			scheduleDraw(draw);
 		}
 
 		// TODO(sugoi): This is a temporary brute-force workaround to ensure IOSurface synchronization.
@@ -739,237 +693,73 @@ namespace sw
 		blitter->blit3D(source, dest);
 	}
 
-	void Renderer::threadFunction(void *parameters)
+	void Renderer::scheduleDraw(DrawCall *draw)
 	{
-		Renderer *renderer = static_cast<Parameters*>(parameters)->renderer;
-		int threadIndex = static_cast<Parameters*>(parameters)->threadIndex;
+		int batchSize = draw->batchSize;
+		int count = draw->count;
 
-		if(logPrecision < IEEE)
-		{
-			CPUID::setFlushToZero(true);
-			CPUID::setDenormalsAreZero(true);
-		}
+		drawsInFlight.add(1);
 
-		renderer->threadLoop(threadIndex);
-	}
+		// The draw call is finished once the last of its batches releases this.
+		auto finally = marl::make_shared_finally([this, draw] {
+			MARL_SCOPED_EVENT("FINISH draw %d", draw->id);
+			finishRendering(*draw);
+			drawsInFlight.done();
+		});
 
-	void Renderer::threadLoop(int threadIndex)
-	{
-		while(!exitThreads)
+		for(int firstPrimitive = 0; firstPrimitive < count; firstPrimitive += batchSize)
 		{
-			taskLoop(threadIndex);
+			auto batch = batchDataPool.borrow();
+			batch->firstPrimitive = firstPrimitive;
+			batch->primitiveCount = count - firstPrimitive >= batchSize ? batchSize : count - firstPrimitive;
 
-			suspend[threadIndex]->signal();
-			resume[threadIndex]->wait();
-		}
-	}
+			for(int cluster = 0; cluster < clusterCount; cluster++)
+			{
+				batch->clusterTickets[cluster] = clusterQueues[cluster].take();
+			}
 
-	void Renderer::taskLoop(int threadIndex)
-	{
-		while(task[threadIndex].type != Task::SUSPEND)
-		{
-			scheduleTask(threadIndex);
-			executeTask(threadIndex);
+			scheduler->enqueue(marl::Task([this, draw, batch, finally] {
+				processBatch(draw, batch, finally);
+			}));
 		}
 	}
 
-	void Renderer::findAvailableTasks()
+	void Renderer::processBatch(DrawCall *draw, const BatchData::Pool::Loan &batch, const std::shared_ptr<marl::Finally> &finally)
 	{
-		// Find pixel tasks
-		for(int cluster = 0; cluster < clusterCount; cluster++)
 		{
-			if(!pixelProgress[cluster].executing)
-			{
-				for(int unit = 0; unit < unitCount; unit++)
-				{
-					if(primitiveProgress[unit].references > 0)   // Contains processed primitives
-					{
-						if(pixelProgress[cluster].drawCall == primitiveProgress[unit].drawCall)
-						{
-							if(pixelProgress[cluster].processedPrimitives == primitiveProgress[unit].firstPrimitive)   // Previous primitives have been rendered
-							{
-								Task &task = taskQueue[qHead];
-								task.type = Task::PIXELS;
-								task.primitiveUnit = unit;
-								task.pixelCluster = cluster;
-
-								pixelProgress[cluster].executing = true;
-
-								// Commit to the task queue
-								qHead = (qHead + 1) & TASK_COUNT_BITS;
-								qSize++;
-
-								break;
-							}
-						}
-					}
-				}
-			}
+			MARL_SCOPED_EVENT("VERTEX draw %d, primitive %d", draw->id, batch->firstPrimitive);
+			processPrimitiveVertices(*batch.get(), *draw);
 		}
 
-		// Find primitive tasks
-		if(currentDraw == nextDraw)
-		{
-			return;   // No more primitives to process
-		}
+		batch->visible = 0;
 
-		for(int unit = 0; unit < unitCount; unit++)
+		if(!draw->setupState.rasterizerDiscard)
 		{
-			DrawCall *draw = drawList[currentDraw & DRAW_COUNT_BITS];
-
-			int primitive = draw->primitive;
-			int count = draw->count;
-
-			if(primitive >= count)
-			{
-				++currentDraw; // Atomic
-
-				if(currentDraw == nextDraw)
-				{
-					return;   // No more primitives to process
-				}
-
-				draw = drawList[currentDraw & DRAW_COUNT_BITS];
-			}
-
-			if(!primitiveProgress[unit].references)   // Task not already being executed and not still in use by a pixel unit
-			{
-				primitive = draw->primitive;
-				count = draw->count;
-				int batch = draw->batchSize;
-
-				primitiveProgress[unit].drawCall = currentDraw;
-				primitiveProgress[unit].firstPrimitive = primitive;
-				primitiveProgress[unit].primitiveCount = count - primitive >= batch ? batch : count - primitive;
-
-				draw->primitive += batch;
-
-				Task &task = taskQueue[qHead];
-				task.type = Task::PRIMITIVES;
-				task.primitiveUnit = unit;
-
-				primitiveProgress[unit].references = -1;
-
-				// Commit to the task queue
-				qHead = (qHead + 1) & TASK_COUNT_BITS;
-				qSize++;
-			}
+			MARL_SCOPED_EVENT("SETUP draw %d, primitive %d", draw->id, batch->firstPrimitive);
+			batch->visible = (this->*draw->setupPrimitives)(batch->triangles, batch->primitives, *draw, batch->primitiveCount);
 		}
-	}
 
-	void Renderer::scheduleTask(int threadIndex)
-	{
-		schedulerMutex.lock();
-
-		int curThreadsAwake = threadsAwake;
-
-		if((int)qSize < threadCount - curThreadsAwake + 1)
+		if(batch->visible > 0)
 		{
-			findAvailableTasks();
+			processPixels(draw, batch, finally);
+			return;
 		}
 
-		if(qSize != 0)
+		for(int cluster = 0; cluster < clusterCount; cluster++)
 		{
-			task[threadIndex] = taskQueue[(qHead - qSize) & TASK_COUNT_BITS];
-			qSize--;
-
-			if(curThreadsAwake != threadCount)
-			{
-				int wakeup = qSize - curThreadsAwake + 1;
-
-				for(int i = 0; i < threadCount && wakeup > 0; i++)
-				{
-					if(task[i].type == Task::SUSPEND)
-					{
-						suspend[i]->wait();
-						task[i].type = Task::RESUME;
-						resume[i]->signal();
-
-						++threadsAwake; // Atomic
-						wakeup--;
-					}
-				}
-			}
+			batch->clusterTickets[cluster].done();
 		}
-		else
-		{
-			task[threadIndex].type = Task::SUSPEND;
-
-			--threadsAwake; // Atomic
-		}
-
-		schedulerMutex.unlock();
 	}
 
-	void Renderer::executeTask(int threadIndex)
+	void Renderer::processPixels(DrawCall *draw, const BatchData::Pool::Loan &batch, const std::shared_ptr<marl::Finally> &finally)
 	{
-		#if PERF_HUD
-			int64_t startTick = Timer::ticks();
-		#endif
-
-		switch(task[threadIndex].type)
+		for(int cluster = 0; cluster < clusterCount; cluster++)
 		{
-		case Task::PRIMITIVES:
-			{
-				int unit = task[threadIndex].primitiveUnit;
-
-				int input = primitiveProgress[unit].firstPrimitive;
-				int count = primitiveProgress[unit].primitiveCount;
-				DrawCall *draw = drawList[primitiveProgress[unit].drawCall & DRAW_COUNT_BITS];
-				int (Renderer::*setupPrimitives)(int batch, int count) = draw->setupPrimitives;
-
-				processPrimitiveVertices(unit, input, count, draw->count, threadIndex);
-
-				#if PERF_HUD
-					int64_t time = Timer::ticks();
-					vertexTime[threadIndex] += time - startTick;
-					startTick = time;
-				#endif
-
-				int visible = 0;
-
-				if(!draw->setupState.rasterizerDiscard)
-				{
-					visible = (this->*setupPrimitives)(unit, count);
-				}
-
-				primitiveProgress[unit].visible = visible;
-				primitiveProgress[unit].references = clusterCount;
-
-				#if PERF_HUD
-					setupTime[threadIndex] += Timer::ticks() - startTick;
-				#endif
-			}
-			break;
-		case Task::PIXELS:
-			{
-				int unit = task[threadIndex].primitiveUnit;
-				int visible = primitiveProgress[unit].visible;
-
-				if(visible > 0)
-				{
-					int cluster = task[threadIndex].pixelCluster;
-					Primitive *primitive = primitiveBatch[unit];
-					DrawCall *draw = drawList[pixelProgress[cluster].drawCall & DRAW_COUNT_BITS];
-					DrawData *data = draw->data;
-					PixelProcessor::RoutinePointer pixelRoutine = draw->pixelPointer;
-
-					pixelRoutine(primitive, visible, cluster, data);
-				}
-
-				finishRendering(task[threadIndex]);
-
-				#if PERF_HUD
-					pixelTime[threadIndex] += Timer::ticks() - startTick;
-				#endif
-			}
-			break;
-		case Task::RESUME:
-			break;
-		case Task::SUSPEND:
-			break;
-		default:
-			ASSERT(false);
+			batch->clusterTickets[cluster].onCall([draw, batch, finally, cluster] {
+				MARL_SCOPED_EVENT("PIXEL draw %d, primitive %d, cluster %d", draw->id, batch->firstPrimitive, cluster);
+				draw->pixelPointer(batch->primitives, batch->visible, cluster, draw->data);
+				batch->clusterTickets[cluster].done();
+			});
 		}
 	}
 
@@ -979,162 +769,136 @@ namespace sw
 		sync->unlock();
 	}
 
-	void Renderer::finishRendering(Task &pixelTask)
+	void Renderer::finishRendering(DrawCall &draw)
 	{
-		int unit = pixelTask.primitiveUnit;
-		int cluster = pixelTask.pixelCluster;
-
-		DrawCall &draw = *drawList[primitiveProgress[unit].drawCall & DRAW_COUNT_BITS];
 		DrawData &data = *draw.data;
-		int primitive = primitiveProgress[unit].firstPrimitive;
-		int count = primitiveProgress[unit].primitiveCount;
-		int processedPrimitives = primitive + count;
-
-		pixelProgress[cluster].processedPrimitives = processedPrimitives;
 
-		if(pixelProgress[cluster].processedPrimitives >= draw.count)
-		{
-			++pixelProgress[cluster].drawCall; // Atomic
-			pixelProgress[cluster].processedPrimitives = 0;
-		}
-
-		int ref = primitiveProgress[unit].references--; // Atomic
-
-		if(ref == 0)
-		{
-			ref = draw.references--; // Atomic
-
-			if(ref == 0)
+		#if PERF_PROFILE
+			for(int cluster = 0; cluster < clusterCount; cluster++)
 			{
-				#if PERF_PROFILE
-					for(int cluster = 0; cluster < clusterCount; cluster++)
-					{
-						for(int i = 0; i < PERF_TIMERS; i++)
-						{
-							profiler.cycles[i] += data.cycles[i][cluster];
-						}
-					}
-				#endif
-
-				if(draw.queries)
+				for(int i = 0; i < PERF_TIMERS; i++)
 				{
-					for(auto &query : *(draw.queries))
-					{
-						switch(query->type)
-						{
-						case Query::FRAGMENTS_PASSED:
-							for(int cluster = 0; cluster < clusterCount; cluster++)
-							{
-								query->data += data.occlusion[cluster];
-							}
-							break;
-						case Query::TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN:
-							query->data += processedPrimitives;
-							break;
-						default:
-							break;
-						}
-
-						query->release();
-					}
-
-					delete draw.queries;
-					draw.queries = 0;
+					profiler.cycles[i] += data.cycles[i][cluster];
 				}
+			}
+		#endif
 
-				for(int i = 0; i < RENDERTARGETS; i++)
+		if(draw.queries)
+		{
+			for(auto &query : *(draw.queries))
+			{
+				switch(query->type)
 				{
-					if(draw.renderTarget[i])
+				case Query::FRAGMENTS_PASSED:
+					for(int cluster = 0; cluster < clusterCount; cluster++)
 					{
-						draw.renderTarget[i]->unlockInternal();
+						query->data += data.occlusion[cluster];
 					}
+					break;
+				case Query::TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN:
+					query->data += draw.count;
+					break;
+				default:
+					break;
 				}
 
-				if(draw.depthBuffer)
-				{
-					draw.depthBuffer->unlockInternal();
-				}
+				query->release();
+			}
 
-				if(draw.stencilBuffer)
-				{
-					draw.stencilBuffer->unlockStencil();
-				}
+			delete draw.queries;
+			draw.queries = 0;
+		}
 
-				for(int i = 0; i < TOTAL_IMAGE_UNITS; i++)
-				{
-					if(draw.texture[i])
-					{
-						draw.texture[i]->unlock();
-					}
-				}
+		for(int i = 0; i < RENDERTARGETS; i++)
+		{
+			if(draw.renderTarget[i])
+			{
+				draw.renderTarget[i]->unlockInternal();
+			}
+		}
 
-				for(int i = 0; i < MAX_VERTEX_INPUTS; i++)
-				{
-					if(draw.vertexStream[i])
-					{
-						draw.vertexStream[i]->unlock();
-					}
-				}
+		if(draw.depthBuffer)
+		{
+			draw.depthBuffer->unlockInternal();
+		}
 
-				if(draw.indexBuffer)
-				{
-					draw.indexBuffer->unlock();
-				}
+		if(draw.stencilBuffer)
+		{
+			draw.stencilBuffer->unlockStencil();
+		}
 
-				for(int i = 0; i < MAX_UNIFORM_BUFFER_BINDINGS; i++)
-				{
-					if(draw.pUniformBuffers[i])
-					{
-						draw.pUniformBuffers[i]->unlock();
-					}
-					if(draw.vUniformBuffers[i])
-					{
-						draw.vUniformBuffers[i]->unlock();
-					}
-				}
+		for(int i = 0; i < TOTAL_IMAGE_UNITS; i++)
+		{
+			if(draw.texture[i])
+			{
+				draw.texture[i]->unlock();
+			}
+		}
 
-				for(int i = 0; i < MAX_TRANSFORM_FEEDBACK_INTERLEAVED_COMPONENTS; i++)
-				{
-					if(draw.transformFeedbackBuffers[i])
-					{
-						draw.transformFeedbackBuffers[i]->unlock();
-					}
-				}
+		for(int i = 0; i < MAX_VERTEX_INPUTS; i++)
+		{
+			if(draw.vertexStream[i])
+			{
+				draw.vertexStream[i]->unlock();
+			}
+		}
 
-				draw.vertexRoutine.reset();
-				draw.setupRoutine.reset();
-				draw.pixelRoutine.reset();
+		if(draw.indexBuffer)
+		{
+			draw.indexBuffer->unlock();
+		}
 
-				sync->unlock();
+		for(int i = 0; i < MAX_UNIFORM_BUFFER_BINDINGS; i++)
+		{
+			if(draw.pUniformBuffers[i])
+			{
+				draw.pUniformBuffers[i]->unlock();
+			}
+			if(draw.vUniformBuffers[i])
+			{
+				draw.vUniformBuffers[i]->unlock();
+			}
+		}
 
-				draw.references = -1;
-				resumeApp->signal();
+		for(int i = 0; i < MAX_TRANSFORM_FEEDBACK_INTERLEAVED_COMPONENTS; i++)
+		{
+			if(draw.transformFeedbackBuffers[i])
+			{
+				draw.transformFeedbackBuffers[i]->unlock();
 			}
 		}
 
-		pixelProgress[cluster].executing = false;
+		draw.vertexRoutine.reset();
+		draw.setupRoutine.reset();
+		draw.pixelRoutine.reset();
+
+		sync->unlock();
+
+		draw.references = -1;
+		resumeApp->signal();
 	}
 
-	void Renderer::processPrimitiveVertices(int unit, unsigned int start, unsigned int triangleCount, unsigned int loop, int thread)
+	void Renderer::processPrimitiveVertices(BatchData &batchData, const DrawCall &draw)
 	{
-		Triangle *triangle = triangleBatch[unit];
-		int primitiveDrawCall = primitiveProgress[unit].drawCall;
-		DrawCall *draw = drawList[primitiveDrawCall & DRAW_COUNT_BITS];
-		DrawData *data = draw->data;
-		VertexTask *task = vertexTask[thread];
+		Triangle *triangle = batchData.triangles;
+		unsigned int start = batchData.firstPrimitive;
+		unsigned int triangleCount = batchData.primitiveCount;
+		unsigned int loop = draw.count;
+		DrawData *data = draw.data;
+		VertexTask *task = batchData.vertexTask;
 
 		const void *indices = data->indices;
-		VertexProcessor::RoutinePointer vertexRoutine = draw->vertexPointer;
+		VertexProcessor::RoutinePointer vertexRoutine = draw.vertexPointer;
 
-		if(task->vertexCache.drawCall != primitiveDrawCall)
+		if(task->vertexCache.drawCall != draw.id)
 		{
 			task->vertexCache.clear();
-			task->vertexCache.drawCall = primitiveDrawCall;
+			task->vertexCache.drawCall = draw.id;
 		}
 
 		unsigned int batch[128][3];   // FIXME: Adjust to dynamic batch size
 
-		switch(draw->drawType)
+		switch(draw.drawType)
 		{
 		case DRAW_POINTLIST:
 			{
@@ -1562,13 +1326,10 @@ namespace sw
 		vertexRoutine(&triangle->v0, (unsigned int*)&batch, task, data);
 	}
 
-	int Renderer::setupSolidTriangles(int unit, int count)
+	int Renderer::setupSolidTriangles(Triangle *triangle, Primitive *primitive, const DrawCall &draw, int count)
 	{
-		Triangle *triangle = triangleBatch[unit];
-		Primitive *primitive = primitiveBatch[unit];
 
-		DrawCall &draw = *drawList[primitiveProgress[unit].drawCall & DRAW_COUNT_BITS];
-		SetupProcessor::State &state = draw.setupState;
+		const SetupProcessor::State &state = draw.setupState;
 		const SetupProcessor::RoutinePointer &setupRoutine = draw.setupPointer;
 
 		int ms = state.multiSample;
@@ -1607,14 +1368,11 @@ namespace sw
 		return visible;
 	}
 
-	int Renderer::setupWireframeTriangle(int unit, int count)
+	int Renderer::setupWireframeTriangle(Triangle *triangle, Primitive *primitive, const DrawCall &draw, int count)
 	{
-		Triangle *triangle = triangleBatch[unit];
-		Primitive *primitive = primitiveBatch[unit];
 		int visible = 0;
 
-		DrawCall &draw = *drawList[primitiveProgress[unit].drawCall & DRAW_COUNT_BITS];
-		SetupProcessor::State &state = draw.setupState;
+		const SetupProcessor::State &state = draw.setupState;
 
 		const Vertex &v0 = triangle[0].v0;
 		const Vertex &v1 = triangle[0].v1;
@@ -1664,14 +1422,11 @@ namespace sw
 		return visible;
 	}
 
-	int Renderer::setupVertexTriangle(int unit, int count)
+	int Renderer::setupVertexTriangle(Triangle *triangle, Primitive *primitive, const DrawCall &draw, int count)
 	{
-		Triangle *triangle = triangleBatch[unit];
-		Primitive *primitive = primitiveBatch[unit];
 		int visible = 0;
 
-		DrawCall &draw = *drawList[primitiveProgress[unit].drawCall & DRAW_COUNT_BITS];
-		SetupProcessor::State &state = draw.setupState;
+		const SetupProcessor::State &state = draw.setupState;
 
 		const Vertex &v0 = triangle[0].v0;
 		const Vertex &v1 = triangle[0].v1;
@@ -1708,14 +1463,11 @@ namespace sw
 		return visible;
 	}
 
-	int Renderer::setupLines(int unit, int count)
+	int Renderer::setupLines(Triangle *triangle, Primitive *primitive, const DrawCall &draw, int count)
 	{
-		Triangle *triangle = triangleBatch[unit];
-		Primitive *primitive = primitiveBatch[unit];
 		int visible = 0;
 
-		DrawCall &draw = *drawList[primitiveProgress[unit].drawCall & DRAW_COUNT_BITS];
-		SetupProcessor::State &state = draw.setupState;
+		const SetupProcessor::State &state = draw.setupState;
 
 		int ms = state.multiSample;
 
@@ -1733,14 +1485,11 @@ namespace sw
 		return visible;
 	}
 
-	int Renderer::setupPoints(int unit, int count)
+	int Renderer::setupPoints(Triangle *triangle, Primitive *primitive, const DrawCall &draw, int count)
 	{
-		Triangle *triangle = triangleBatch[unit];
-		Primitive *primitive = primitiveBatch[unit];
 		int visible = 0;
 
-		DrawCall &draw = *drawList[primitiveProgress[unit].drawCall & DRAW_COUNT_BITS];
-		SetupProcessor::State &state = draw.setupState;
+		const SetupProcessor::State &state = draw.setupState;
 
 		int ms = state.multiSample;
 
@@ -2131,72 +1880,28 @@ namespace sw
 
 	void Renderer::initializeThreads()
 	{
-		unitCount = ceilPow2(threadCount);
-		clusterCount = ceilPow2(threadCount);
-
-		for(int i = 0; i < unitCount; i++)
-		{
-			triangleBatch[i] = (Triangle*)allocate(batchSize * sizeof(Triangle));
-			primitiveBatch[i] = (Primitive*)allocate(batchSize * sizeof(Primitive));
-		}
-
-		for(int i = 0; i < threadCount; i++)
-		{
-			vertexTask[i] = (VertexTask*)allocate(sizeof(VertexTask));
-			vertexTask[i]->vertexCache.drawCall = -1;
-
-			task[i].type = Task::SUSPEND;
-
-			resume[i] = new Event();
-			suspend[i] = new Event();
-
-			Parameters parameters;
-			parameters.threadIndex = i;
-			parameters.renderer = this;
+		// Pixel tasks are split into at most 16 clusters, but any number of
+		// worker threads can pick up the vertex, setup and pixel tasks.
+		clusterCount = ceilPow2(threadCount) < 16 ? ceilPow2(threadCount) : 16;
 
-			exitThreads = false;
-			worker[i] = new Thread(threadFunction, &parameters);
+		marl::Scheduler::Config config;
+		config.setWorkerThreadCount(threadCount);
+		config.setWorkerThreadInitializer([](int) {
+			if(logPrecision < IEEE)
+			{
+				CPUID::setFlushToZero(true);
+				CPUID::setDenormalsAreZero(true);
+			}
+		});
 
-			suspend[i]->wait();
-			suspend[i]->signal();
-		}
+		scheduler.reset(new marl::Scheduler(config));
 	}
 
 	void Renderer::terminateThreads()
 	{
-		while(threadsAwake != 0)
-		{
-			Thread::sleep(1);
-		}
-
-		for(int thread = 0; thread < threadCount; thread++)
-		{
-			if(worker[thread])
-			{
-				exitThreads = true;
-				resume[thread]->signal();
-				worker[thread]->join();
+		drawsInFlight.wait();
 
-				delete worker[thread];
-				worker[thread] = 0;
-				delete resume[thread];
-				resume[thread] = 0;
-				delete suspend[thread];
-				suspend[thread] = 0;
-			}
-
-			deallocate(vertexTask[thread]);
-			vertexTask[thread] = 0;
-		}
-
-		for(int i = 0; i < 16; i++)
-		{
-			deallocate(triangleBatch[i]);
-			triangleBatch[i] = 0;
-
-			deallocate(primitiveBatch[i]);
-			primitiveBatch[i] = 0;
-		}
+		scheduler.reset();
 	}
 
 	void Renderer::loadConstants(const VertexShader *vertexShader)
@@ -2794,38 +2499,6 @@ namespace sw
 		queries.remove(query);
 	}
 
-	#if PERF_HUD
-		int Renderer::getThreadCount()
-		{
-			return threadCount;
-		}
-
-		int64_t Renderer::getVertexTime(int thread)
-		{
-			return vertexTime[thread];
-		}
-
-		int64_t Renderer::getSetupTime(int thread)
-		{
-			return setupTime[thread];
-		}
-
-		int64_t Renderer::getPixelTime(int thread)
-		{
-			return pixelTime[thread];
-		}
-
-		void Renderer::resetTimers()
-		{
-			for(int thread = 0; thread < threadCount; thread++)
-			{
-				vertexTime[thread] = 0;
-				setupTime[thread] = 0;
-				pixelTime[thread] = 0;
-			}
-		}
-	#endif
-
 	void Renderer::setViewport(const Viewport &viewport)
 	{
 		this->viewport = viewport;
@@ -2968,7 +2641,7 @@ namespace sw
 		#endif
 		}
 
-		if(!initialUpdate && !worker[0])
+		if(!initialUpdate && !scheduler)
 		{
 			initializeThreads();
 		}
@@ -24,7 +24,14 @@
 #include "Common/Thread.hpp"
 #include "Main/Config.hpp"
 
+#include "marl/finally.h"
+#include "marl/pool.h"
+#include "marl/scheduler.h"
+#include "marl/ticket.h"
+#include "marl/waitgroup.h"
+
 #include <list>
+#include <memory>
 
 namespace sw
 {
@@ -222,52 +229,26 @@ namespace sw
 
 	class Renderer : public VertexProcessor, public PixelProcessor, public SetupProcessor
 	{
-		struct Task
+		// Storage and synchronization of a batch of primitives, which are processed
+		// by a single vertex and setup task, followed by one pixel task per cluster.
+		struct BatchData
 		{
-			enum Type
-			{
-				PRIMITIVES,
-				PIXELS,
-
-				RESUME,
-				SUSPEND
-			};
-
-			AtomicInt type;
-			AtomicInt primitiveUnit;
-			AtomicInt pixelCluster;
-		};
+			using Pool = marl::BoundedPool<BatchData, 16, marl::PoolPolicy::Preserve>;
 
-		struct PrimitiveProgress
-		{
-			void init()
-			{
-				drawCall = 0;
-				firstPrimitive = 0;
-				primitiveCount = 0;
-				visible = 0;
-				references = 0;
-			}
-
-			AtomicInt drawCall;
-			AtomicInt firstPrimitive;
-			AtomicInt primitiveCount;
-			AtomicInt visible;
-			AtomicInt references;
-		};
+			BatchData();
+			~BatchData();
 
-		struct PixelProgress
-		{
-			void init()
-			{
-				drawCall = 0;
-				processedPrimitives = 0;
-				executing = false;
-			}
-
-			AtomicInt drawCall;
-			AtomicInt processedPrimitives;
-			AtomicInt executing;
+			Triangle *triangles;
+			Primitive *primitives;
+			VertexTask *vertexTask;
+
+			// Pixel tasks of a cluster run in batch order, by waiting on these
+			// tickets from the cluster's queue.
+			marl::Ticket clusterTickets[16];
+
+			int firstPrimitive;
+			int primitiveCount;
+			int visible;
 		};
 
 	public:
@@ -352,33 +333,21 @@ namespace sw
 
 		void synchronize();
 
-		#if PERF_HUD
-			// Performance timers
-			int getThreadCount();
-			int64_t getVertexTime(int thread);
-			int64_t getSetupTime(int thread);
-			int64_t getPixelTime(int thread);
-			void resetTimers();
-		#endif
-
 		static int getClusterCount() { return clusterCount; }
 
 	private:
-		static void threadFunction(void *parameters);
-		void threadLoop(int threadIndex);
-		void taskLoop(int threadIndex);
-		void findAvailableTasks();
-		void scheduleTask(int threadIndex);
-		void executeTask(int threadIndex);
-		void finishRendering(Task &pixelTask);
-
-		void processPrimitiveVertices(int unit, unsigned int start, unsigned int count, unsigned int loop, int thread);
-
-		int setupSolidTriangles(int batch, int count);
-		int setupWireframeTriangle(int batch, int count);
-		int setupVertexTriangle(int batch, int count);
-		int setupLines(int batch, int count);
-		int setupPoints(int batch, int count);
+		void scheduleDraw(DrawCall *draw);
+		void processBatch(DrawCall *draw, const BatchData::Pool::Loan &batch, const std::shared_ptr<marl::Finally> &finally);
+		void processPixels(DrawCall *draw, const BatchData::Pool::Loan &batch, const std::shared_ptr<marl::Finally> &finally);
+		void finishRendering(DrawCall &draw);
+
+		void processPrimitiveVertices(BatchData &batch, const DrawCall &draw);
+
+		int setupSolidTriangles(Triangle *triangle, Primitive *primitive, const DrawCall &draw, int count);
+		int setupWireframeTriangle(Triangle *triangle, Primitive *primitive, const DrawCall &draw, int count);
+		int setupVertexTriangle(Triangle *triangle, Primitive *primitive, const DrawCall &draw, int count);
+		int setupLines(Triangle *triangle, Primitive *primitive, const DrawCall &draw, int count);
+		int setupPoints(Triangle *triangle, Primitive *primitive, const DrawCall &draw, int count);
 
 		bool setupLine(Primitive &primitive, Triangle &triangle, const DrawCall &draw);
 		bool setupPoint(Primitive &primitive, Triangle &triangle, const DrawCall &draw);
@@ -399,56 +368,28 @@ namespace sw
 		Rect scissor;
 		int clipFlags;
 
-		Triangle *triangleBatch[16];
-		Primitive *primitiveBatch[16];
-
 		// User-defined clipping planes
 		Plane userPlane[MAX_CLIP_PLANES];
 		Plane clipPlane[MAX_CLIP_PLANES];   // Tranformed to clip space
 		bool updateClipPlanes;
 
-		AtomicInt exitThreads;
-		AtomicInt threadsAwake;
-		Thread *worker[16];
-		Event *resume[16];         // Events for resuming threads
-		Event *suspend[16];        // Events for suspending threads
+		// Rendering tasks run on a scheduler owned by the renderer, so its worker
+		// count follows the configured thread count.
+		std::unique_ptr<marl::Scheduler> scheduler;
+		marl::WaitGroup drawsInFlight;
 		Event *resumeApp;          // Event for resuming the application thread
 
-		PrimitiveProgress primitiveProgress[16];
-		PixelProgress pixelProgress[16];
-		Task task[16];   // Current tasks for threads
-
 		enum {
 			DRAW_COUNT = 16,   // Number of draw calls buffered (must be power of 2)
-			DRAW_COUNT_BITS = DRAW_COUNT - 1,
 		};
 		DrawCall *drawCall[DRAW_COUNT];
-		DrawCall *drawList[DRAW_COUNT];
+		int nextDrawID;
 
-		AtomicInt currentDraw;
-		AtomicInt nextDraw;
-
-		enum {
-			TASK_COUNT = 32,   // Size of the task queue (must be power of 2)
-			TASK_COUNT_BITS = TASK_COUNT - 1,
-		};
-		Task taskQueue[TASK_COUNT];
-		AtomicInt qHead;
-		AtomicInt qSize;
+		BatchData::Pool batchDataPool;
+		marl::Ticket::Queue clusterQueues[16];
 
-		static AtomicInt unitCount;
 		static AtomicInt clusterCount;
 
-		MutexLock schedulerMutex;
-
-		#if PERF_HUD
-			int64_t vertexTime[16];
-			int64_t setupTime[16];
-			int64_t pixelTime[16];
-		#endif
-
-		VertexTask *vertexTask[16];
-
 		SwiftConfig *swiftConfig;
 
 		std::list<Query*> queries;
@@ -480,7 +421,7 @@ namespace sw
 		SetupProcessor::RoutinePointer setupPointer;
 		PixelProcessor::RoutinePointer pixelPointer;
 
-		int (Renderer::*setupPrimitives)(int batch, int count);
+		int (Renderer::*setupPrimitives)(Triangle *triangle, Primitive *primitive, const DrawCall &draw, int count);
 		SetupProcessor::State setupState;
 
 		Resource *vertexStream[MAX_VERTEX_INPUTS];
@@ -505,9 +446,9 @@ namespace sw
 
 		AtomicInt clipFlags;
 
-		AtomicInt primitive;    // Current primitive to enter pipeline
+		int id;                 // Identifies the draw call's vertices in the batches' vertex caches
 		AtomicInt count;        // Number of primitives to render
-		AtomicInt references;   // Remaining references to this draw call, 0 when done drawing, -1 when resources unlocked and slot is free
+		AtomicInt references;   // 1 while the draw call is in flight, -1 when resources unlocked and slot is free
 
 		DrawData *data;
 	};
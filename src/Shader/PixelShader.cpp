@@ -14,6 +14,7 @@
 
 #include "PixelShader.hpp"
 
+#include "Common/BinaryStream.hpp"
 #include "Common/Debug.hpp"
 
 #include <string.h>
@@ -56,10 +57,39 @@ namespace sw
 		analyze();
 	}
 
+	PixelShader::PixelShader(BinaryInputStream &stream) : Shader()
+	{
+		shaderModel = 0x0300;
+		centroid = false;
+
+		readInstructions(stream, { MAX_FRAGMENT_INPUTS, RENDERTARGETS, RENDERTARGETS, true, FRAGMENT_UNIFORM_VECTORS, TEXTURE_IMAGE_UNITS });
+
+		stream.read(input);
+		stream.read(vPosDeclared);
+		stream.read(vFaceDeclared);
+
+		// The shader is discarded when the stream is invalid, and analyzing its
+		// instructions is only safe once they have been validated.
+		if(!stream.error())
+		{
+			optimize();
+			analyze();
+		}
+	}
+
 	PixelShader::~PixelShader()
 	{
 	}
 
+	void PixelShader::write(BinaryOutputStream &stream) const
+	{
+		writeInstructions(stream);
+
+		stream.write(input);
+		stream.write(vPosDeclared);
+		stream.write(vFaceDeclared);
+	}
+
 	int PixelShader::validate(const unsigned long *const token)
 	{
 		if(!token)
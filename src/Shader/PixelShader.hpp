@@ -25,10 +25,13 @@ namespace sw
 	public:
 		explicit PixelShader(const PixelShader *ps = 0);
 		explicit PixelShader(const unsigned long *token);
+		explicit PixelShader(BinaryInputStream &stream);   // Reads a shader written by write()
 
 		virtual ~PixelShader();
 
 		static int validate(const unsigned long *const token);   // Returns number of instructions if valid
+		void write(BinaryOutputStream &stream) const;
+
 		bool depthOverride() const;
 		bool containsKill() const;
 		bool containsCentroid() const;
@@ -16,6 +16,7 @@
 
 #include "VertexShader.hpp"
 #include "PixelShader.hpp"
+#include "Common/BinaryStream.hpp"
 #include "Common/Math.hpp"
 #include "Common/Debug.hpp"
 
@@ -1471,6 +1472,145 @@ namespace sw
 		file << instruction[index]->string(shaderType, shaderModel) << std::endl;
 	}
 
+	void Shader::writeInstructions(BinaryOutputStream &stream) const
+	{
+		static_assert(std::is_trivially_copyable<DestinationParameter>::value &&
+		              std::is_trivially_copyable<SourceParameter>::value, "parameters are written as raw bytes");
+
+		stream.write<uint32_t>(static_cast<uint32_t>(instruction.size()));
+
+		for(const auto &inst : instruction)
+		{
+			stream.write(inst->opcode);
+			stream.write(inst->control);
+			stream.write(inst->predicate);
+			stream.write(inst->predicateNot);
+			stream.write(inst->predicateSwizzle);
+			stream.write(inst->coissue);
+			stream.write(inst->samplerType);
+			stream.write(inst->usage);
+			stream.write(inst->usageIndex);
+			stream.write(inst->dst);
+			stream.write(inst->src);
+			stream.write(inst->analysis);
+		}
+
+		stream.write(usedSamplers);
+	}
+
+	// Returns whether a register of a deserialized instruction is one the GLSL
+	// compiler produces, within the shader stage's register files.
+	static bool validRegister(Shader::ParameterType type, unsigned int index, int bufferIndex, const Shader::RegisterFiles &registerFiles)
+	{
+		switch(type)
+		{
+		case Shader::PARAMETER_VOID:     return true;
+		case Shader::PARAMETER_TEMP:     return index < NUM_TEMPORARY_REGISTERS;
+		case Shader::PARAMETER_INPUT:    return index < registerFiles.inputs;
+		case Shader::PARAMETER_OUTPUT:   return index < registerFiles.outputs;
+		case Shader::PARAMETER_COLOROUT: return index < registerFiles.colorOutputs;
+		case Shader::PARAMETER_DEPTHOUT: return registerFiles.depthOutput;
+		case Shader::PARAMETER_SAMPLER:  return index < registerFiles.samplers;
+		case Shader::PARAMETER_MISCTYPE: return true;
+		case Shader::PARAMETER_CONST:
+			if(bufferIndex == -1)
+			{
+				return index < registerFiles.constants;
+			}
+			return bufferIndex >= 0 && bufferIndex < MAX_UNIFORM_BUFFER_BINDINGS && index < MAX_UNIFORM_BLOCK_SIZE;
+		default:
+			return false;
+		}
+	}
+
+	static bool validParameter(const Shader::Parameter &param, int bufferIndex, const Shader::RegisterFiles &registerFiles)
+	{
+		if(param.type == Shader::PARAMETER_FLOAT4LITERAL || param.type == Shader::PARAMETER_LABEL)
+		{
+			return true;   // Holds a value or label instead of a register
+		}
+
+		return validRegister(param.type, param.index, bufferIndex, registerFiles) &&
+		       validRegister(param.rel.type, param.rel.index, bufferIndex, registerFiles);
+	}
+
+	// Returns whether the labels are ones the GLSL compiler produces, one per
+	// function, and each call targets a declared label. Programs index their
+	// per-label code blocks with them, sized from the highest label.
+	static bool validLabels(const std::vector<Shader::Instruction*> &instructions)
+	{
+		std::unordered_set<unsigned int> labels;
+
+		for(const auto &inst : instructions)
+		{
+			if(inst->opcode == Shader::OPCODE_LABEL)
+			{
+				if(inst->dst.label >= instructions.size() || !labels.insert(inst->dst.label).second)
+				{
+					return false;
+				}
+			}
+		}
+
+		for(const auto &inst : instructions)
+		{
+			if(inst->opcode == Shader::OPCODE_CALL || inst->opcode == Shader::OPCODE_CALLNZ)
+			{
+				if(labels.find(inst->dst.label) == labels.end())
+				{
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	void Shader::readInstructions(BinaryInputStream &stream, const RegisterFiles &registerFiles)
+	{
+		uint32_t count = stream.read<uint32_t>();
+
+		for(uint32_t i = 0; i < count && !stream.error(); i++)
+		{
+			Instruction *inst = new Instruction(OPCODE_NOP);
+
+			stream.read(inst->opcode);
+			stream.read(inst->control);
+			stream.read(inst->predicate);
+			stream.read(inst->predicateNot);
+			stream.read(inst->predicateSwizzle);
+			stream.read(inst->coissue);
+			stream.read(inst->samplerType);
+			stream.read(inst->usage);
+			stream.read(inst->usageIndex);
+			stream.read(inst->dst);
+			stream.read(inst->src);
+			stream.read(inst->analysis);
+
+			bool valid = validParameter(inst->dst, -1, registerFiles);
+			for(const auto &src : inst->src)
+			{
+				valid = valid && validParameter(src, src.bufferIndex, registerFiles);
+			}
+
+			if(!valid)
+			{
+				delete inst;
+				stream.fail();
+				break;
+			}
+
+			append(inst);
+		}
+
+		if(!stream.error() && !validLabels(instruction))
+		{
+			stream.fail();
+		}
+
+		stream.read(usedSamplers);
+	}
+
 	void Shader::append(Instruction *instruction)
 	{
 		this->instruction.push_back(instruction);
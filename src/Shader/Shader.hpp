@@ -22,6 +22,9 @@
 
 namespace sw
 {
+	class BinaryOutputStream;
+	class BinaryInputStream;
+
 	class Shader
 	{
 	public:
@@ -564,6 +567,17 @@ namespace sw
 			uint32_t maxLabel = 0; // highest label in use.
 		};
 
+		// Sizes of a shader stage's register files.
+		struct RegisterFiles
+		{
+			unsigned int inputs;
+			unsigned int outputs;
+			unsigned int colorOutputs;
+			bool depthOutput;
+			unsigned int constants;
+			unsigned int samplers;
+		};
+
 		Shader();
 
 		virtual ~Shader();
@@ -631,6 +645,13 @@ namespace sw
 	protected:
 		void parse(const unsigned long *token);
 
+		// Program binary support. Only the state copied by the derived classes'
+		// copy constructors is stored; the rest is derived by analysis. Reading
+		// stops, and fails the stream, at an instruction whose registers are not
+		// ones the GLSL compiler produces for the given register files.
+		void writeInstructions(BinaryOutputStream &stream) const;
+		void readInstructions(BinaryInputStream &stream, const RegisterFiles &registerFiles);
+
 		void optimizeLeave();
 		void optimizeCall();
 		void removeNull();
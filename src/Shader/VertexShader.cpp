@@ -15,6 +15,7 @@
 #include "VertexShader.hpp"
 
 #include "Renderer/Vertex.hpp"
+#include "Common/BinaryStream.hpp"
 #include "Common/Debug.hpp"
 
 #include <string.h>
@@ -77,10 +78,53 @@ namespace sw
 		analyze();
 	}
 
+	VertexShader::VertexShader(BinaryInputStream &stream) : Shader()
+	{
+		shaderModel = 0x0300;
+		textureSampling = false;
+
+		readInstructions(stream, { MAX_VERTEX_INPUTS, MAX_VERTEX_OUTPUTS, 0, false, VERTEX_UNIFORM_VECTORS, VERTEX_TEXTURE_IMAGE_UNITS });
+
+		stream.read(output);
+		stream.read(input);
+		stream.read(attribType);
+		stream.read(positionRegister);
+		stream.read(pointSizeRegister);
+		stream.read(instanceIdDeclared);
+		stream.read(vertexIdDeclared);
+
+		if(positionRegister < 0 || positionRegister >= MAX_VERTEX_OUTPUTS ||
+		   pointSizeRegister < 0 || (pointSizeRegister >= MAX_VERTEX_OUTPUTS && pointSizeRegister != Unused))
+		{
+			stream.fail();
+		}
+
+		// The shader is discarded when the stream is invalid, and analyzing its
+		// instructions is only safe once they have been validated.
+		if(!stream.error())
+		{
+			optimize();
+			analyze();
+		}
+	}
+
 	VertexShader::~VertexShader()
 	{
 	}
 
+	void VertexShader::write(BinaryOutputStream &stream) const
+	{
+		writeInstructions(stream);
+
+		stream.write(output);
+		stream.write(input);
+		stream.write(attribType);
+		stream.write(positionRegister);
+		stream.write(pointSizeRegister);
+		stream.write(instanceIdDeclared);
+		stream.write(vertexIdDeclared);
+	}
+
 	int VertexShader::validate(const unsigned long *const token)
 	{
 		if(!token)
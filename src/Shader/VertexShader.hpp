@@ -34,12 +34,15 @@ namespace sw
 
 		explicit VertexShader(const VertexShader *vs = 0);
 		explicit VertexShader(const unsigned long *token);
+		explicit VertexShader(BinaryInputStream &stream);   // Reads a shader written by write()
 
 		virtual ~VertexShader();
 
 		static int validate(const unsigned long *const token);   // Returns number of instructions if valid
 		bool containsTextureSampling() const;
 
+		void write(BinaryOutputStream &stream) const;
+
 		void setInput(int inputIdx, const Semantic& semantic, AttribType attribType = ATTRIBTYPE_FLOAT);
 		void setOutput(int outputIdx, int nbComponents, const Semantic& semantic);
 		void setPositionRegister(int posReg);
@@ -22,9 +22,13 @@ half::half(float fp32)
 	unsigned int sign = (fp32i & 0x80000000) >> 16;
 	unsigned int abs = fp32i & 0x7FFFFFFF;
 
-	if(abs > 0x47FFEFFF)  // Infinity
+	if(abs > 0x7F800000)  // NaN
 	{
-		fp16i = sign | 0x7FFF;
+		fp16i = sign | 0x7E00;
+	}
+	else if(abs > 0x477FEFFF)  // Rounds to infinity
+	{
+		fp16i = sign | 0x7C00;
 	}
 	else if(abs < 0x38800000)  // Denormal
 	{
@@ -56,7 +60,13 @@ half::operator float() const
 	int e = (fp16i >> 10) & 0x0000001F;
 	int m = fp16i & 0x000003FF;
 
-	if(e == 0)
+	if(e == 31)  // Infinity or NaN
+	{
+		fp32i = (s << 31) | 0x7F800000 | (m << 13);
+
+		return (float &)fp32i;
+	}
+	else if(e == 0)
 	{
 		if(m == 0)
 		{
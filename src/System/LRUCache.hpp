@@ -77,8 +77,8 @@ public:
 	// replaced with data.
 	// If no existing entry exists in the cache, and the cache is already full
 	// then the least recently used entry is evicted before adding the new
-	// entry.
-	inline void add(const Key &key, const Data &data);
+	// entry, and true is returned.
+	inline bool add(const Key &key, const Data &data);
 
 	// clear() clears the cache of all elements.
 	inline void clear();
@@ -238,7 +238,7 @@ DATA LRUCache<KEY, DATA, HASH>::lookup(const Key &key)
 }
 
 template<typename KEY, typename DATA, typename HASH>
-void LRUCache<KEY, DATA, HASH>::add(const Key &key, const Data &data)
+bool LRUCache<KEY, DATA, HASH>::add(const Key &key, const Data &data)
 {
 	if(Entry *entry = find(key))
 	{
@@ -246,9 +246,10 @@ void LRUCache<KEY, DATA, HASH>::add(const Key &key, const Data &data)
 		unlink(entry);
 		link(entry);
 		entry->data = data;
-		return;
+		return false;
 	}
 
+	bool evicted = false;
 	Entry *entry = free;
 	if(entry)
 	{
@@ -262,6 +263,7 @@ void LRUCache<KEY, DATA, HASH>::add(const Key &key, const Data &data)
 		entry = tail;
 		unlink(entry);
 		set.erase(entry);
+		evicted = true;
 	}
 
 	// link as most recently used.
@@ -274,6 +276,8 @@ void LRUCache<KEY, DATA, HASH>::add(const Key &key, const Data &data)
 	entry->key = key;
 	entry->data = data;
 	set.emplace(entry);
+
+	return evicted;
 }
 
 template<typename KEY, typename DATA, typename HASH>
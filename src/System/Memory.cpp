@@ -40,6 +40,11 @@
 #	define __x86__
 #endif
 
+#if defined(__x86__) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#	include <emmintrin.h>
+#	define SW_NON_TEMPORAL_STORES
+#endif
+
 // A Clang extension to determine compiler features.
 // We use it to detect Sanitizer builds (e.g. -fsanitize=memory).
 #ifndef __has_feature
@@ -127,6 +132,121 @@ void freeMemory(void *memory)
 	}
 }
 
+#if defined(__linux__)
+// Transparent huge pages are 2 MiB on x86 and on ARM with 4 KiB base pages.
+// Aligning large mappings to this lets the kernel back them with huge pages.
+static constexpr size_t hugePageSize = 2 * 1024 * 1024;
+#endif
+
+void *allocateZeroPages(size_t bytes)
+{
+	size_t pageSize = memoryPageSize();
+	size_t length = (bytes + pageSize - 1) & ~(pageSize - 1);
+
+#if defined(_WIN32)
+	return VirtualAlloc(nullptr, length, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+#	if defined(__linux__)
+	if(length >= hugePageSize)
+	{
+		// Over-allocate so the range can be aligned, then unmap the excess.
+		size_t mapped = length + hugePageSize;
+		void *mapping = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if(mapping == MAP_FAILED)
+		{
+			return nullptr;
+		}
+
+		uintptr_t begin = reinterpret_cast<uintptr_t>(mapping);
+		uintptr_t aligned = (begin + hugePageSize - 1) & ~(hugePageSize - 1);
+		size_t head = aligned - begin;
+		size_t tail = mapped - head - length;
+
+		if(head > 0)
+		{
+			munmap(mapping, head);
+		}
+
+		if(tail > 0)
+		{
+			munmap(reinterpret_cast<void *>(aligned + length), tail);
+		}
+
+		// Advisory only. Fails harmlessly when THP is disabled.
+		madvise(reinterpret_cast<void *>(aligned), length, MADV_HUGEPAGE);
+
+		return reinterpret_cast<void *>(aligned);
+	}
+#	endif
+
+	void *mapping = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+	return (mapping != MAP_FAILED) ? mapping : nullptr;
+#endif
+}
+
+void discardPages(void *memory, size_t bytes)
+{
+	size_t pageSize = memoryPageSize();
+	size_t length = (bytes + pageSize - 1) & ~(pageSize - 1);
+
+#if defined(_WIN32)
+	// Decommitted pages are zero-filled when committed again.
+	VirtualFree(memory, length, MEM_DECOMMIT);
+	VirtualAlloc(memory, length, MEM_COMMIT, PAGE_READWRITE);
+#elif defined(__linux__)
+	// Private anonymous pages are zero-filled on the next access.
+	madvise(memory, length, MADV_DONTNEED);
+#else
+	// MADV_DONTNEED doesn't guarantee zero-filling elsewhere. Replacing the
+	// range with a fresh mapping does.
+	mmap(memory, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+#endif
+}
+
+void freePages(void *memory, size_t bytes)
+{
+	if(memory)
+	{
+#if defined(_WIN32)
+		VirtualFree(memory, 0, MEM_RELEASE);
+#else
+		size_t pageSize = memoryPageSize();
+		size_t length = (bytes + pageSize - 1) & ~(pageSize - 1);
+
+		munmap(memory, length);
+#endif
+	}
+}
+
+size_t residentPageBytes(const void *memory, size_t bytes)
+{
+	size_t pageSize = memoryPageSize();
+	size_t length = (bytes + pageSize - 1) & ~(pageSize - 1);
+
+#if defined(__linux__)
+	size_t pageCount = length / pageSize;
+	unsigned char *residency = reinterpret_cast<unsigned char *>(malloc(pageCount));
+	if(!residency || mincore(const_cast<void *>(memory), length, residency) != 0)
+	{
+		free(residency);
+		return length;
+	}
+
+	size_t residentCount = 0;
+	for(size_t i = 0; i < pageCount; i++)
+	{
+		residentCount += residency[i] & 1;
+	}
+
+	free(residency);
+
+	return residentCount * pageSize;
+#else
+	return length;
+#endif
+}
+
 void clear(uint16_t *memory, uint16_t element, size_t count)
 {
 #if defined(_MSC_VER) && defined(__x86__) && !defined(MEMORY_SANITIZER)
@@ -161,4 +281,73 @@ void clear(uint32_t *memory, uint32_t element, size_t count)
 #endif
 }
 
+void copyNonTemporal(void *dst, const void *src, size_t bytes)
+{
+#if defined(SW_NON_TEMPORAL_STORES) && !defined(MEMORY_SANITIZER)
+	uint8_t *d = static_cast<uint8_t *>(dst);
+	const uint8_t *s = static_cast<const uint8_t *>(src);
+
+	// Streaming stores need a 16-byte aligned destination.
+	size_t head = (16 - (reinterpret_cast<uintptr_t>(d) & 15)) & 15;
+	if(bytes < head + 64)
+	{
+		memcpy(d, s, bytes);
+		return;
+	}
+
+	memcpy(d, s, head);
+	d += head;
+	s += head;
+	bytes -= head;
+
+	for(; bytes >= 64; bytes -= 64, d += 64, s += 64)
+	{
+		__m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + 0));
+		__m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + 16));
+		__m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + 32));
+		__m128i v3 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + 48));
+		_mm_stream_si128(reinterpret_cast<__m128i *>(d + 0), v0);
+		_mm_stream_si128(reinterpret_cast<__m128i *>(d + 16), v1);
+		_mm_stream_si128(reinterpret_cast<__m128i *>(d + 32), v2);
+		_mm_stream_si128(reinterpret_cast<__m128i *>(d + 48), v3);
+	}
+
+	_mm_sfence();
+	memcpy(d, s, bytes);
+#else
+	memcpy(dst, src, bytes);
+#endif
+}
+
+void clearNonTemporal(uint32_t *memory, uint32_t element, size_t count)
+{
+#if defined(SW_NON_TEMPORAL_STORES) && !defined(MEMORY_SANITIZER)
+	// Streaming stores need a 16-byte aligned destination.
+	size_t head = ((16 - (reinterpret_cast<uintptr_t>(memory) & 15)) & 15) / sizeof(uint32_t);
+	if(count < head + 16)
+	{
+		clear(memory, element, count);
+		return;
+	}
+
+	clear(memory, element, head);
+	memory += head;
+	count -= head;
+
+	__m128i v = _mm_set1_epi32(static_cast<int>(element));
+	for(; count >= 16; count -= 16, memory += 16)
+	{
+		_mm_stream_si128(reinterpret_cast<__m128i *>(memory + 0), v);
+		_mm_stream_si128(reinterpret_cast<__m128i *>(memory + 4), v);
+		_mm_stream_si128(reinterpret_cast<__m128i *>(memory + 8), v);
+		_mm_stream_si128(reinterpret_cast<__m128i *>(memory + 12), v);
+	}
+
+	_mm_sfence();
+	clear(memory, element, count);
+#else
+	clear(memory, element, count);
+#endif
+}
+
 }  // namespace sw
@@ -28,9 +28,27 @@ void *allocateZeroOrPoison(size_t bytes, size_t alignment = 16);   // Initialize
 
 void freeMemory(void *memory);
 
+// Maps whole pages directly from the operating system. The memory reads as
+// zero, and physical pages are only committed when they're first touched.
+// Returns nullptr on failure.
+void *allocateZeroPages(size_t bytes);
+// Returns the physical pages backing the range to the operating system,
+// while keeping it mapped. It reads as zero again afterwards.
+void discardPages(void *memory, size_t bytes);
+void freePages(void *memory, size_t bytes);
+// Returns the number of bytes of the page range which are backed by physical
+// memory. Where this can't be queried, the whole range is reported.
+size_t residentPageBytes(const void *memory, size_t bytes);
+
 void clear(uint16_t *memory, uint16_t element, size_t count);
 void clear(uint32_t *memory, uint32_t element, size_t count);
 
+// Variants of memcpy() and clear() which write around the cache, for large
+// destinations which aren't read back soon. The stores are complete and
+// visible to other threads on return.
+void copyNonTemporal(void *dst, const void *src, size_t bytes);
+void clearNonTemporal(uint32_t *memory, uint32_t element, size_t count);
+
 }  // namespace sw
 
 #endif  // Memory_hpp
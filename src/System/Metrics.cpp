@@ -0,0 +1,319 @@
+// Copyright 2021 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "Metrics.hpp"
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace sw {
+
+namespace {
+
+const char *const counterNames[] = {
+	"draws",
+	"vertex.invocations",
+	"vertex.simd_groups",
+	"jit.routines",
+};
+
+const char *const cacheNames[] = {
+	"cache.pipeline_spirv",
+	"cache.pipeline_compute",
+	"cache.vertex_routine",
+	"cache.setup_routine",
+	"cache.cull_routine",
+	"cache.pixel_routine",
+	"cache.sampling_routine",
+	"cache.blit_routine",
+};
+
+const char *const cacheEventNames[] = {
+	"hits",
+	"misses",
+	"evictions",
+};
+
+const char *const histogramNames[] = {
+	"time.spirv_optimize",
+	"time.shader_emit",
+	"time.jit_compile",
+	"time.vertex_task",
+	"time.setup_task",
+	"time.pixel_task",
+};
+
+static_assert(sizeof(counterNames) / sizeof(counterNames[0]) == Metrics::COUNTER_COUNT, "missing counter name");
+static_assert(sizeof(cacheNames) / sizeof(cacheNames[0]) == Metrics::CACHE_COUNT, "missing cache name");
+static_assert(sizeof(cacheEventNames) / sizeof(cacheEventNames[0]) == Metrics::CACHE_EVENT_COUNT, "missing cache event name");
+static_assert(sizeof(histogramNames) / sizeof(histogramNames[0]) == Metrics::HISTOGRAM_COUNT, "missing histogram name");
+
+std::atomic<uint64_t (*)()> jitCodeBytesSource = { nullptr };
+
+// State of the reports requested through the environment.
+std::atomic<bool> reportsRequested = { false };
+std::atomic<int64_t> reportPeriod = { 0 };      // In steady_clock ticks, or 0 for no periodic reports
+std::atomic<int64_t> nextReportTime = { 0 };    // In steady_clock ticks since its epoch
+
+void append(std::string &string, const char *name, const char *suffix, uint64_t value)
+{
+	char line[128];
+	snprintf(line, sizeof(line), "%s%s %" PRIu64 "\n", name, suffix, value);
+	string += line;
+}
+
+}  // anonymous namespace
+
+std::atomic<bool> Metrics::enabled = { false };
+Metrics::Shard Metrics::shards[SHARD_COUNT];
+
+Metrics::Shard &Metrics::shard()
+{
+	static std::atomic<unsigned int> nextShard = { 0 };
+	thread_local unsigned int index = nextShard.fetch_add(1, std::memory_order_relaxed) % SHARD_COUNT;
+
+	return shards[index];
+}
+
+void Metrics::setEnabled(bool enable)
+{
+	enabled.store(enable, std::memory_order_relaxed);
+}
+
+void Metrics::record(Histogram histogram, std::chrono::nanoseconds duration)
+{
+	if(!isEnabled())
+	{
+		return;
+	}
+
+	uint64_t nanoseconds = duration.count() > 0 ? static_cast<uint64_t>(duration.count()) : 0;
+
+	int bucket = 0;
+	while(bucket < BUCKET_COUNT - 1 && (nanoseconds >> (bucket + 1)) != 0)
+	{
+		bucket++;
+	}
+
+	Shard &s = shard();
+	s.histogramSums[histogram].fetch_add(nanoseconds, std::memory_order_relaxed);
+	s.histogramBuckets[histogram][bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t Metrics::HistogramData::quantile(double q) const
+{
+	if(count == 0)
+	{
+		return 0;
+	}
+
+	uint64_t rank = static_cast<uint64_t>(q * count);
+	uint64_t cumulative = 0;
+
+	for(int i = 0; i < BUCKET_COUNT; i++)
+	{
+		cumulative += buckets[i];
+		if(cumulative > rank)
+		{
+			return uint64_t(2) << i;
+		}
+	}
+
+	return uint64_t(2) << (BUCKET_COUNT - 1);
+}
+
+void Metrics::setJITCodeBytesSource(uint64_t (*source)())
+{
+	jitCodeBytesSource.store(source);
+}
+
+Metrics::Snapshot Metrics::snapshot()
+{
+	Snapshot snapshot = {};
+
+	for(const Shard &s : shards)
+	{
+		for(int i = 0; i < COUNTER_COUNT; i++)
+		{
+			snapshot.counters[i] += s.counters[i].load(std::memory_order_relaxed);
+		}
+
+		for(int i = 0; i < CACHE_COUNT; i++)
+		{
+			for(int j = 0; j < CACHE_EVENT_COUNT; j++)
+			{
+				snapshot.cacheEvents[i][j] += s.cacheEvents[i][j].load(std::memory_order_relaxed);
+			}
+		}
+
+		for(int i = 0; i < HISTOGRAM_COUNT; i++)
+		{
+			HistogramData &histogram = snapshot.histograms[i];
+			histogram.sum += s.histogramSums[i].load(std::memory_order_relaxed);
+
+			for(int j = 0; j < BUCKET_COUNT; j++)
+			{
+				uint64_t count = s.histogramBuckets[i][j].load(std::memory_order_relaxed);
+				histogram.buckets[j] += count;
+				histogram.count += count;
+			}
+		}
+	}
+
+	if(auto source = jitCodeBytesSource.load())
+	{
+		snapshot.jitCodeBytes = source();
+	}
+
+	return snapshot;
+}
+
+void Metrics::reset()
+{
+	for(Shard &s : shards)
+	{
+		for(auto &counter : s.counters)
+		{
+			counter.store(0, std::memory_order_relaxed);
+		}
+
+		for(auto &cache : s.cacheEvents)
+		{
+			for(auto &event : cache)
+			{
+				event.store(0, std::memory_order_relaxed);
+			}
+		}
+
+		for(int i = 0; i < HISTOGRAM_COUNT; i++)
+		{
+			s.histogramSums[i].store(0, std::memory_order_relaxed);
+
+			for(auto &bucket : s.histogramBuckets[i])
+			{
+				bucket.store(0, std::memory_order_relaxed);
+			}
+		}
+	}
+}
+
+std::string Metrics::format(const Snapshot &snapshot)
+{
+	std::string string;
+
+	for(int i = 0; i < COUNTER_COUNT; i++)
+	{
+		append(string, counterNames[i], "", snapshot.counters[i]);
+	}
+
+	for(int i = 0; i < CACHE_COUNT; i++)
+	{
+		for(int j = 0; j < CACHE_EVENT_COUNT; j++)
+		{
+			std::string suffix = std::string(".") + cacheEventNames[j];
+			append(string, cacheNames[i], suffix.c_str(), snapshot.cacheEvents[i][j]);
+		}
+	}
+
+	for(int i = 0; i < HISTOGRAM_COUNT; i++)
+	{
+		const HistogramData &histogram = snapshot.histograms[i];
+		append(string, histogramNames[i], ".count", histogram.count);
+		append(string, histogramNames[i], ".total_us", histogram.sum / 1000);
+		append(string, histogramNames[i], ".p50_us", histogram.quantile(0.5) / 1000);
+		append(string, histogramNames[i], ".p99_us", histogram.quantile(0.99) / 1000);
+	}
+
+	append(string, "jit.code_bytes", "", snapshot.jitCodeBytes);
+
+	return string;
+}
+
+uint64_t Metrics::value(const Snapshot &snapshot, const char *name)
+{
+	if(!name)
+	{
+		return 0;
+	}
+
+	std::string string = format(snapshot);
+	size_t length = strlen(name);
+
+	for(size_t line = 0; line < string.size();)
+	{
+		size_t end = string.find('\n', line);
+
+		if(string.compare(line, length, name) == 0 && string[line + length] == ' ')
+		{
+			return strtoull(string.c_str() + line + length + 1, nullptr, 10);
+		}
+
+		line = end + 1;
+	}
+
+	return 0;
+}
+
+void Metrics::initializeFromEnvironment()
+{
+	const char *metrics = getenv("SWIFTSHADER_METRICS");
+	if(!metrics)
+	{
+		return;
+	}
+
+	double seconds = atof(metrics);
+	if(seconds > 0)
+	{
+		auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds));
+		reportPeriod = period.count();
+		nextReportTime = (std::chrono::steady_clock::now() + period).time_since_epoch().count();
+	}
+
+	reportsRequested = true;
+	setEnabled(true);
+}
+
+void Metrics::reportFromEnvironment(bool final)
+{
+	if(!reportsRequested.load(std::memory_order_relaxed))
+	{
+		return;
+	}
+
+	if(!final)
+	{
+		int64_t period = reportPeriod.load(std::memory_order_relaxed);
+		if(period == 0)
+		{
+			return;
+		}
+
+		// Only the thread which moves the deadline on writes the report.
+		int64_t now = std::chrono::steady_clock::now().time_since_epoch().count();
+		int64_t deadline = nextReportTime.load(std::memory_order_relaxed);
+		if(now < deadline || !nextReportTime.compare_exchange_strong(deadline, now + period))
+		{
+			return;
+		}
+	}
+
+	std::string report = format(snapshot());
+	fprintf(stderr, "SwiftShader metrics:\n%s", report.c_str());
+	fflush(stderr);
+}
+
+}  // namespace sw
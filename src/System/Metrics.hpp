@@ -0,0 +1,214 @@
+// Copyright 2021 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef sw_Metrics_hpp
+#define sw_Metrics_hpp
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace sw {
+
+// Metrics is a process-wide registry of counters and latency histograms, for
+// observing where the driver spends its time outside of the shaders it runs:
+// compiling them, and looking up the caches which avoid compiling them again.
+//
+// Recording is always compiled in, but does nothing beyond loading a relaxed
+// atomic flag while disabled, which is the default. Setting the
+// SWIFTSHADER_METRICS environment variable enables it, and makes queue
+// submissions write a report to stderr every SWIFTSHADER_METRICS seconds
+// (if the value is a positive number), as well as when the last instance is
+// destroyed. Otherwise it is controlled by setEnabled(), which the
+// swiftshader*Metrics() C entry points expose to applications.
+//
+// Values are accumulated in per-thread shards of atomics, so that threads
+// recording the same metric don't contend for its cache line.
+class Metrics
+{
+public:
+	enum Counter
+	{
+		Draws,
+		VertexInvocations,  // Vertex shader invocations which did useful work
+		VertexSimdGroups,   // SIMD groups the vertex shader invocations ran in
+		JITRoutines,        // Reactor routines compiled
+
+		COUNTER_COUNT
+	};
+
+	// Each cache counts hits, misses (which lead to creating the entry) and
+	// evictions of least recently used entries.
+	enum Cache
+	{
+		PipelineSpirvCache,
+		PipelineComputeCache,
+		VertexRoutineCache,
+		SetupRoutineCache,
+		CullRoutineCache,
+		PixelRoutineCache,
+		SamplingRoutineCache,
+		BlitRoutineCache,
+
+		CACHE_COUNT
+	};
+
+	enum CacheEvent
+	{
+		CacheHit,
+		CacheMiss,
+		CacheEviction,
+
+		CACHE_EVENT_COUNT
+	};
+
+	enum Histogram
+	{
+		SpirvOptimizeTime,  // Running spirv-opt on a shader module
+		ShaderEmitTime,     // Emitting the Reactor IR of a SPIR-V shader
+		JITCompileTime,     // Optimizing, compiling and linking a Reactor routine
+		VertexTaskTime,     // Processing a batch of vertices
+		SetupTaskTime,      // Setting up a batch of primitives
+		PixelTaskTime,      // Rasterizing a batch into one cluster
+
+		HISTOGRAM_COUNT
+	};
+
+	// Histogram bucket i counts durations in [2^i, 2^(i+1)) nanoseconds,
+	// bucket 0 also counting those under one nanosecond.
+	static constexpr int BUCKET_COUNT = 40;
+
+	struct HistogramData
+	{
+		uint64_t count;
+		uint64_t sum;  // In nanoseconds
+		uint64_t buckets[BUCKET_COUNT];
+
+		// Returns an upper bound of the given quantile (0 to 1), in
+		// nanoseconds, from the bucket it falls into.
+		uint64_t quantile(double q) const;
+	};
+
+	struct Snapshot
+	{
+		uint64_t counters[COUNTER_COUNT];
+		uint64_t cacheEvents[CACHE_COUNT][CACHE_EVENT_COUNT];
+		HistogramData histograms[HISTOGRAM_COUNT];
+		uint64_t jitCodeBytes;
+	};
+
+	static bool isEnabled()
+	{
+		return enabled.load(std::memory_order_relaxed);
+	}
+
+	static void setEnabled(bool enable);
+
+	static void add(Counter counter, uint64_t value = 1)
+	{
+		if(isEnabled())
+		{
+			shard().counters[counter].fetch_add(value, std::memory_order_relaxed);
+		}
+	}
+
+	static void count(Cache cache, CacheEvent event)
+	{
+		if(isEnabled())
+		{
+			shard().cacheEvents[cache][event].fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	static void record(Histogram histogram, std::chrono::nanoseconds duration);
+
+	// Records the time from its construction to its destruction, or nothing
+	// when metrics were disabled at construction.
+	class ScopedTimer
+	{
+	public:
+		ScopedTimer(Histogram histogram)
+		    : histogram(histogram)
+		    , active(isEnabled())
+		{
+			if(active)
+			{
+				start = std::chrono::steady_clock::now();
+			}
+		}
+
+		~ScopedTimer()
+		{
+			if(active)
+			{
+				record(histogram, std::chrono::steady_clock::now() - start);
+			}
+		}
+
+	private:
+		const Histogram histogram;
+		const bool active;
+		std::chrono::steady_clock::time_point start;
+	};
+
+	// Sets the function which reports the number of bytes of executable
+	// memory allocated for JIT-compiled code so far. It lives in Reactor,
+	// which doesn't depend on this library.
+	static void setJITCodeBytesSource(uint64_t (*source)());
+
+	// Sums the shards. Values recorded concurrently may or may not be included.
+	static Snapshot snapshot();
+
+	// Zeroes all values. Values recorded concurrently may or may not survive.
+	static void reset();
+
+	// Returns the snapshot as one "name value" line per metric. Histograms
+	// are reported as name.count, name.total_us, name.p50_us and name.p99_us.
+	static std::string format(const Snapshot &snapshot);
+
+	// Returns the value of the metric of that name in format(), or 0 if
+	// there is no such metric or name is null.
+	static uint64_t value(const Snapshot &snapshot, const char *name);
+
+	// Reads the SWIFTSHADER_METRICS environment variable. Called once at
+	// library initialization.
+	static void initializeFromEnvironment();
+
+	// Writes a report to stderr if SWIFTSHADER_METRICS requested periodic
+	// reports and the period has elapsed since the last one, or whenever
+	// 'final' is set and the environment variable enabled the metrics.
+	static void reportFromEnvironment(bool final = false);
+
+private:
+	static constexpr int SHARD_COUNT = 16;
+
+	struct alignas(64) Shard
+	{
+		std::atomic<uint64_t> counters[COUNTER_COUNT];
+		std::atomic<uint64_t> cacheEvents[CACHE_COUNT][CACHE_EVENT_COUNT];
+		std::atomic<uint64_t> histogramSums[HISTOGRAM_COUNT];
+		std::atomic<uint64_t> histogramBuckets[HISTOGRAM_COUNT][BUCKET_COUNT];
+	};
+
+	static Shard &shard();
+
+	static std::atomic<bool> enabled;
+	static Shard shards[SHARD_COUNT];
+};
+
+}  // namespace sw
+
+#endif  // sw_Metrics_hpp
@@ -0,0 +1,150 @@
+// Copyright 2021 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef sw_SharedLRUCache_hpp
+#define sw_SharedLRUCache_hpp
+
+#include "LRUCache.hpp"
+#include "Metrics.hpp"
+
+#include "marl/event.h"
+#include "marl/mutex.h"
+#include "marl/tsa.h"
+
+#include <memory>
+#include <unordered_map>
+
+namespace sw {
+
+// SharedLRUCache is a thread-safe LRUCache which creates missing entries on
+// demand. Each entry is only created once: threads which look up a key while
+// its data is being created by another thread wait for that data, while data
+// for other keys can be created concurrently.
+template<typename KEY, typename DATA, typename HASH = std::hash<KEY>>
+class SharedLRUCache
+{
+public:
+	using Key = KEY;
+	using Data = DATA;
+	using Hash = HASH;
+
+	// Construct a shared LRU cache with the given maximum number of entries.
+	// Its hits, misses and evictions are counted as those of metricsCache,
+	// unless it is Metrics::CACHE_COUNT.
+	inline SharedLRUCache(size_t capacity, Metrics::Cache metricsCache = Metrics::CACHE_COUNT);
+
+	// getOrCreate() looks up the cache entry with the given key, and returns
+	// its data. If the entry is not found, and no other thread is creating it,
+	// then create() is called without holding the cache's lock, and the data it
+	// returns is added to the cache and returned.
+	// Function must be a function of the signature:
+	//     Data()
+	// Data must be convertible to bool, with default initialized Data being
+	// false.
+	template<typename Function>
+	inline Data getOrCreate(const Key &key, Function &&create);
+
+private:
+	// Data being created by one thread, which other threads can wait for.
+	struct Pending
+	{
+		marl::Event created = marl::Event(marl::Event::Mode::Manual);
+		Data data = {};
+	};
+
+	inline void count(Metrics::CacheEvent event);
+
+	const Metrics::Cache metricsCache;
+
+	marl::mutex mutex;
+	LRUCache<Key, Data, Hash> cache GUARDED_BY(mutex);
+	std::unordered_map<Key, std::shared_ptr<Pending>, Hash> pending GUARDED_BY(mutex);
+};
+
+template<typename KEY, typename DATA, typename HASH>
+SharedLRUCache<KEY, DATA, HASH>::SharedLRUCache(size_t capacity, Metrics::Cache metricsCache)
+    : metricsCache(metricsCache)
+    , cache(capacity)
+{
+}
+
+template<typename KEY, typename DATA, typename HASH>
+void SharedLRUCache<KEY, DATA, HASH>::count(Metrics::CacheEvent event)
+{
+	if(metricsCache != Metrics::CACHE_COUNT)
+	{
+		Metrics::count(metricsCache, event);
+	}
+}
+
+template<typename KEY, typename DATA, typename HASH>
+template<typename Function>
+DATA SharedLRUCache<KEY, DATA, HASH>::getOrCreate(const Key &key, Function &&create)
+{
+	std::shared_ptr<Pending> entry;
+
+	{
+		marl::lock lock(mutex);
+
+		Data data = cache.lookup(key);
+		if(data)
+		{
+			count(Metrics::CacheHit);
+			return data;
+		}
+
+		// Waiting for another thread to create the data counts as a hit.
+		auto it = pending.find(key);
+		if(it != pending.end())
+		{
+			entry = it->second;
+			count(Metrics::CacheHit);
+		}
+		else
+		{
+			pending.emplace(key, std::make_shared<Pending>());
+			count(Metrics::CacheMiss);
+		}
+	}
+
+	if(entry)
+	{
+		entry->created.wait();
+		return entry->data;
+	}
+
+	Data data = create();
+
+	{
+		marl::lock lock(mutex);
+
+		if(cache.add(key, data))
+		{
+			count(Metrics::CacheEviction);
+		}
+
+		auto it = pending.find(key);
+		entry = it->second;
+		pending.erase(it);
+	}
+
+	entry->data = data;
+	entry->created.signal();
+
+	return data;
+}
+
+}  // namespace sw
+
+#endif  // sw_SharedLRUCache_hpp
@@ -0,0 +1,921 @@
+// Copyright 2021 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "Trace.hpp"
+
+#include "Debug.hpp"
+
+#include "marl/scheduler.h"
+
+#if defined(_WIN32)
+#	ifndef WIN32_LEAN_AND_MEAN
+#		define WIN32_LEAN_AND_MEAN
+#	endif
+#	include <windows.h>
+#else
+#	include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sw {
+
+namespace {
+
+constexpr int MaxThreads = 256;             // Threads recording at once
+constexpr uint64_t BufferCapacity = 32768;  // Events per thread
+constexpr std::chrono::milliseconds FlushPeriod(100);
+
+enum Phase : uint16_t
+{
+	Complete,
+	AsyncBegin,
+	AsyncEnd,
+};
+
+struct Event
+{
+	uint64_t timestamp;  // In steady_clock nanoseconds
+	uint64_t argument;   // Duration of complete events, id of asynchronous events
+	uint16_t phase;
+	uint16_t fiber;  // Id of the marl fiber within its thread, 0 outside of fibers
+	char name[Trace::MaxNameLength];
+};
+
+static_assert(sizeof(Event) == 64, "events should fill a cache line");
+
+// A single-producer single-consumer ring buffer. Only the thread it belongs
+// to writes events and advances 'written', and only flush() reads them and
+// advances 'read', while holding the state's mutex.
+struct ThreadBuffer
+{
+	std::atomic<uint64_t> written = { 0 };
+	std::atomic<uint64_t> read = { 0 };
+	std::atomic<uint64_t> dropped = { 0 };
+
+	int id = 0;              // The thread's id in the trace, starting at 1
+	char name[32] = {};      // Guarded by the state's mutex once the buffer is registered
+	bool described = false;  // Guarded by the state's mutex. Whether the current file names this thread.
+
+	// Guarded by the state's mutex. The fibers given a track in the current
+	// file, and the number of dropped events reported in it so far.
+	std::vector<uint16_t> fibers;
+	uint64_t reportedDropped = 0;
+
+	Event events[BufferCapacity];
+};
+
+// Each thread which records events claims a slot, which holds its buffer
+// while a trace is being written. Trace::stop() frees the buffers, once no
+// thread is recording into them, and a thread's exit frees its own buffer
+// after draining it.
+struct alignas(64) Slot
+{
+	std::atomic<ThreadBuffer *> buffer;
+	std::atomic<bool> used;
+	std::atomic<bool> recording;
+};
+
+Slot slots[MaxThreads];
+std::atomic<int> nextThreadID = { 1 };
+
+// Releases the thread's slot when the thread exits.
+struct ThreadSlot
+{
+	~ThreadSlot();
+
+	int index = -1;
+	int id = 0;
+};
+
+#if defined(__clang__)
+#	pragma clang diagnostic push
+#	pragma clang diagnostic ignored "-Wexit-time-destructors"  // Destroyed on thread exit
+#endif
+thread_local ThreadSlot threadSlot;
+#if defined(__clang__)
+#	pragma clang diagnostic pop
+#endif
+
+thread_local char threadName[sizeof(ThreadBuffer::name)] = {};
+
+struct State
+{
+	std::mutex mutex;
+	FILE *file = nullptr;
+	Trace::Format format = Trace::ChromeJSON;
+	bool firstEntry = true;
+	uint64_t startTime = 0;
+	std::atomic<int64_t> nextFlushTime = { 0 };  // In steady_clock ticks since its epoch
+};
+
+State &state()
+{
+	static State *state = new State();
+	return *state;
+}
+
+uint64_t nanoseconds(std::chrono::steady_clock::time_point time)
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+uint32_t processID()
+{
+#if defined(_WIN32)
+	return static_cast<uint32_t>(GetCurrentProcessId());
+#else
+	return static_cast<uint32_t>(getpid());
+#endif
+}
+
+// Returns the calling thread's slot, claiming a free one if it has none, or
+// null if all are in use.
+Slot *getThreadSlot()
+{
+	if(threadSlot.index < 0)
+	{
+		for(int i = 0; i < MaxThreads; i++)
+		{
+			bool used = false;
+			if(!slots[i].used.load(std::memory_order_relaxed) && slots[i].used.compare_exchange_strong(used, true))
+			{
+				threadSlot.index = i;
+				break;
+			}
+		}
+
+		if(threadSlot.index < 0)
+		{
+			return nullptr;
+		}
+	}
+
+	return &slots[threadSlot.index];
+}
+
+uint16_t currentFiber()
+{
+	marl::Scheduler::Fiber *fiber = marl::Scheduler::Fiber::current();
+
+	return fiber ? static_cast<uint16_t>(std::min<uint32_t>(fiber->id, UINT16_MAX)) : 0;
+}
+
+// Writes an event into the thread's buffer, allocating it if needed. Must be
+// called while tracing is enabled and the slot is flagged as recording.
+// Returns whether the buffer is at least half full.
+bool writeEvent(Slot &slot, Phase phase, const char *name, uint64_t timestamp, uint64_t argument)
+{
+	ThreadBuffer *buffer = slot.buffer.load(std::memory_order_relaxed);
+	if(!buffer)
+	{
+		if(threadSlot.id == 0)
+		{
+			threadSlot.id = nextThreadID.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		buffer = new ThreadBuffer();
+		buffer->id = threadSlot.id;
+		memcpy(buffer->name, threadName, sizeof(threadName));
+		slot.buffer.store(buffer, std::memory_order_release);
+	}
+
+	uint64_t written = buffer->written.load(std::memory_order_relaxed);
+	uint64_t count = written - buffer->read.load(std::memory_order_acquire);
+	if(count >= BufferCapacity)
+	{
+		buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	Event &event = buffer->events[written % BufferCapacity];
+	event.timestamp = timestamp;
+	event.argument = argument;
+	event.phase = phase;
+	event.fiber = currentFiber();
+	strncpy(event.name, name, Trace::MaxNameLength - 1);
+	event.name[Trace::MaxNameLength - 1] = '\0';
+
+	buffer->written.store(written + 1, std::memory_order_release);
+
+	return count + 1 >= BufferCapacity / 2;
+}
+
+void drain(State &state);
+
+void record(Phase phase, const char *name, uint64_t timestamp, uint64_t argument)
+{
+	Slot *slot = getThreadSlot();
+	if(!slot)
+	{
+		return;
+	}
+
+	// Trace::stop() disables tracing before waiting for the slots to stop
+	// recording, and this flags the slot before checking tracing is still
+	// enabled, so the buffer can't be freed while the event is written.
+	slot->recording.store(true, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	bool halfFull = Trace::isEnabled() && writeEvent(*slot, phase, name, timestamp, argument);
+
+	slot->recording.store(false, std::memory_order_release);
+
+	// Threads which record many events between flushes, such as the workers
+	// of a long dispatch, drain the buffers themselves before they overflow,
+	// unless another thread is already draining them.
+	if(halfFull)
+	{
+		State &state = sw::state();
+		std::unique_lock<std::mutex> lock(state.mutex, std::try_to_lock);
+
+		if(lock.owns_lock())
+		{
+			drain(state);
+		}
+	}
+}
+
+// Chrome trace event JSON array format.
+class JSONWriter
+{
+public:
+	JSONWriter(std::string &out, State &state)
+	    : out(out)
+	    , state(state)
+	    , pid(processID())
+	{}
+
+	void describeThread(const ThreadBuffer &buffer)
+	{
+		beginEntry();
+		append("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":%d,\"args\":{\"name\":", pid, buffer.id);
+		if(buffer.name[0])
+		{
+			appendString(buffer.name);
+		}
+		else
+		{
+			append("\"Thread %d\"", buffer.id);
+		}
+		out += "}}";
+	}
+
+	void events(const ThreadBuffer &buffer, const std::vector<Event> &events)
+	{
+		for(const Event &event : events)
+		{
+			beginEntry();
+			out += "{\"name\":";
+			appendString(event.name);
+
+			double timestamp = (event.timestamp - state.startTime) / 1000.0;
+
+			switch(event.phase)
+			{
+			case Complete:
+				append(",\"ph\":\"X\",\"pid\":%u,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}", pid, buffer.id, timestamp, event.argument / 1000.0);
+				break;
+			case AsyncBegin:
+			case AsyncEnd:
+				append(",\"cat\":\"swiftshader\",\"ph\":\"%s\",\"id\":\"0x%" PRIx64 "\",\"pid\":%u,\"tid\":%d,\"ts\":%.3f}",
+				       event.phase == AsyncBegin ? "b" : "e", event.argument, pid, buffer.id, timestamp);
+				break;
+			}
+		}
+	}
+
+	void dropped(const ThreadBuffer &buffer, uint64_t timestamp, const char *name)
+	{
+		beginEntry();
+		out += "{\"name\":";
+		appendString(name);
+		append(",\"ph\":\"i\",\"s\":\"t\",\"pid\":%u,\"tid\":%d,\"ts\":%.3f}", pid, buffer.id, (timestamp - state.startTime) / 1000.0);
+	}
+
+private:
+	void beginEntry()
+	{
+		if(!state.firstEntry)
+		{
+			out += ",\n";
+		}
+
+		state.firstEntry = false;
+	}
+
+	void append(const char *format, ...) SW_TRACE_PRINTF_ARGS(2, 3)
+	{
+		char entry[256];
+		va_list args;
+		va_start(args, format);
+		vsnprintf(entry, sizeof(entry), format, args);
+		va_end(args);
+
+		out += entry;
+	}
+
+	void appendString(const char *string)
+	{
+		out += '"';
+
+		for(const char *c = string; *c; c++)
+		{
+			if(*c == '"' || *c == '\\')
+			{
+				out += '\\';
+				out += *c;
+			}
+			else if(static_cast<unsigned char>(*c) < 0x20)
+			{
+				append("\\u%04x", *c);
+			}
+			else
+			{
+				out += *c;
+			}
+		}
+
+		out += '"';
+	}
+
+	std::string &out;
+	State &state;
+	const uint32_t pid;
+};
+
+// Perfetto protobuf format, consisting of TrackEvent packets. Complete events
+// become pairs of slice begin and end events, which must be strictly nested
+// on each track. Events of a thread only nest within each of its marl fibers,
+// as a fiber which blocks within an event lets the thread run others, so the
+// events of fibers other than the thread's first go on tracks of their own.
+class PerfettoWriter
+{
+public:
+	PerfettoWriter(std::string &out, State &state)
+	    : out(out)
+	    , state(state)
+	    , pid(processID())
+	{}
+
+	void describeProcess()
+	{
+		std::string process;
+		putUint(process, 1, pid);  // ProcessDescriptor.pid
+
+		std::string track;
+		putUint(track, 1, processTrack());    // TrackDescriptor.uuid
+		putBytes(track, 3, process);          // TrackDescriptor.process
+
+		std::string packet;
+		putUint(packet, 13, 1);  // TracePacket.sequence_flags = SEQ_INCREMENTAL_STATE_CLEARED
+		putPacket(packet, track);
+	}
+
+	void describeThread(const ThreadBuffer &buffer)
+	{
+		std::string thread;
+		putUint(thread, 1, pid);               // ThreadDescriptor.pid
+		putUint(thread, 2, buffer.id);  // ThreadDescriptor.tid
+		if(buffer.name[0])
+		{
+			putBytes(thread, 5, buffer.name);  // ThreadDescriptor.thread_name
+		}
+
+		std::string track;
+		putUint(track, 1, threadTrack(buffer));  // TrackDescriptor.uuid
+		putBytes(track, 4, thread);              // TrackDescriptor.thread
+
+		std::string packet;
+		putPacket(packet, track);
+	}
+
+	void events(ThreadBuffer &buffer, std::vector<Event> &events)
+	{
+		// Group the events by fiber. Outer events complete after the events
+		// they contain. Begin them first.
+		std::sort(events.begin(), events.end(), [](const Event &a, const Event &b) {
+			if(a.fiber != b.fiber)
+			{
+				return a.fiber < b.fiber;
+			}
+
+			if(a.timestamp != b.timestamp)
+			{
+				return a.timestamp < b.timestamp;
+			}
+
+			if(a.phase != b.phase)
+			{
+				return a.phase < b.phase;
+			}
+
+			return a.phase == Complete && a.argument > b.argument;
+		});
+
+		std::vector<uint64_t> ends;  // End times of the slices begun, innermost last
+		uint64_t track = 0;
+
+		for(size_t i = 0; i < events.size(); i++)
+		{
+			const Event &event = events[i];
+
+			if(i == 0 || event.fiber != events[i - 1].fiber)
+			{
+				endSlices(track, ends, UINT64_MAX);
+				track = fiberTrack(buffer, event.fiber);
+			}
+
+			if(event.phase == Complete)
+			{
+				endSlices(track, ends, event.timestamp);
+
+				putTrackEvent(1, track, event.timestamp, event.name);
+				ends.push_back(event.timestamp + event.argument);
+			}
+			else
+			{
+				uint64_t asyncTrack = this->asyncTrack(event);
+
+				if(event.phase == AsyncBegin)
+				{
+					std::string track;
+					putUint(track, 1, asyncTrack);      // TrackDescriptor.uuid
+					putUint(track, 5, processTrack());  // TrackDescriptor.parent_uuid
+					putBytes(track, 2, event.name);     // TrackDescriptor.name
+
+					std::string packet;
+					putPacket(packet, track);
+				}
+
+				putTrackEvent(event.phase == AsyncBegin ? 1 : 2, asyncTrack, event.timestamp, event.name);
+			}
+		}
+
+		endSlices(track, ends, UINT64_MAX);
+	}
+
+	void dropped(const ThreadBuffer &buffer, uint64_t timestamp, const char *name)
+	{
+		putTrackEvent(3, threadTrack(buffer), timestamp, name);
+	}
+
+private:
+	static constexpr uint64_t TrustedPacketSequenceID = 1;
+
+	uint64_t processTrack() const
+	{
+		return pid;
+	}
+
+	uint64_t threadTrack(const ThreadBuffer &buffer) const
+	{
+		return (uint64_t(pid) << 32) | uint64_t(buffer.id);
+	}
+
+	// Returns the track of the fiber's events, describing it first if needed.
+	uint64_t fiberTrack(ThreadBuffer &buffer, uint16_t fiber)
+	{
+		uint64_t thread = threadTrack(buffer);
+		if(fiber == 0)
+		{
+			return thread;
+		}
+
+		// Thread tracks have the top bits clear, and asynchronous ones the top bit set.
+		uint64_t track = (((thread * 0x100000001B3ull) ^ fiber) & ~(uint64_t(3) << 62)) | (uint64_t(1) << 62);
+
+		if(std::find(buffer.fibers.begin(), buffer.fibers.end(), fiber) == buffer.fibers.end())
+		{
+			char name[64];
+			if(buffer.name[0])
+			{
+				snprintf(name, sizeof(name), "%s fiber %d", buffer.name, int(fiber));
+			}
+			else
+			{
+				snprintf(name, sizeof(name), "Thread %d fiber %d", buffer.id, int(fiber));
+			}
+
+			std::string descriptor;
+			putUint(descriptor, 1, track);   // TrackDescriptor.uuid
+			putUint(descriptor, 5, thread);  // TrackDescriptor.parent_uuid
+			putBytes(descriptor, 2, name);   // TrackDescriptor.name
+
+			std::string packet;
+			putPacket(packet, descriptor);
+
+			buffer.fibers.push_back(fiber);
+		}
+
+		return track;
+	}
+
+	// Ends the slices begun on the track which end by the given time.
+	void endSlices(uint64_t track, std::vector<uint64_t> &ends, uint64_t time)
+	{
+		while(!ends.empty() && ends.back() <= time)
+		{
+			putTrackEvent(2, track, ends.back(), nullptr);
+			ends.pop_back();
+		}
+	}
+
+	uint64_t asyncTrack(const Event &event) const
+	{
+		// FNV-1a hash of the name, combined with the id.
+		uint64_t hash = 0xCBF29CE484222325ull;
+		for(const char *c = event.name; *c; c++)
+		{
+			hash = (hash ^ static_cast<unsigned char>(*c)) * 0x100000001B3ull;
+		}
+
+		return (hash ^ (event.argument * 0x9E3779B97F4A7C15ull)) | (uint64_t(1) << 63);
+	}
+
+	// 'type' is TrackEvent.Type, 1 for SLICE_BEGIN, 2 for SLICE_END and 3 for INSTANT.
+	void putTrackEvent(uint64_t type, uint64_t track, uint64_t timestamp, const char *name)
+	{
+		std::string trackEvent;
+		putUint(trackEvent, 9, type);    // TrackEvent.type
+		putUint(trackEvent, 11, track);  // TrackEvent.track_uuid
+		if(name)
+		{
+			putBytes(trackEvent, 23, name);  // TrackEvent.name
+		}
+
+		std::string packet;
+		putUint(packet, 8, timestamp - state.startTime);  // TracePacket.timestamp
+		putBytes(packet, 11, trackEvent);                 // TracePacket.track_event
+		putPacket(packet, "");
+	}
+
+	// Appends a TracePacket with the given fields, and the TrackDescriptor
+	// if not empty, to the Trace.
+	void putPacket(std::string &packet, const std::string &trackDescriptor)
+	{
+		putUint(packet, 10, TrustedPacketSequenceID);  // TracePacket.trusted_packet_sequence_id
+		if(!trackDescriptor.empty())
+		{
+			putBytes(packet, 60, trackDescriptor);  // TracePacket.track_descriptor
+		}
+
+		putBytes(out, 1, packet);  // Trace.packet
+	}
+
+	static void putVarint(std::string &out, uint64_t value)
+	{
+		while(value >= 0x80)
+		{
+			out += static_cast<char>((value & 0x7F) | 0x80);
+			value >>= 7;
+		}
+
+		out += static_cast<char>(value);
+	}
+
+	static void putUint(std::string &out, uint32_t field, uint64_t value)
+	{
+		putVarint(out, field << 3);  // Wire type 0: varint
+		putVarint(out, value);
+	}
+
+	static void putBytes(std::string &out, uint32_t field, const std::string &bytes)
+	{
+		putVarint(out, (field << 3) | 2);  // Wire type 2: length-delimited
+		putVarint(out, bytes.size());
+		out += bytes;
+	}
+
+	std::string &out;
+	State &state;
+	const uint32_t pid;
+};
+
+// Drains all threads' buffers into the trace file. Must be called with the
+// state's mutex held.
+void drain(State &state)
+{
+	if(!state.file)
+	{
+		return;
+	}
+
+	std::string out;
+	JSONWriter json(out, state);
+	PerfettoWriter perfetto(out, state);
+	std::vector<Event> events;
+
+	for(Slot &slot : slots)
+	{
+		ThreadBuffer *buffer = slot.buffer.load(std::memory_order_acquire);
+		if(!buffer)
+		{
+			continue;
+		}
+
+		uint64_t read = buffer->read.load(std::memory_order_relaxed);
+		uint64_t written = buffer->written.load(std::memory_order_acquire);
+
+		if(read == written)
+		{
+			continue;
+		}
+
+		if(!buffer->described)
+		{
+			if(state.format == Trace::ChromeJSON)
+			{
+				json.describeThread(*buffer);
+			}
+			else
+			{
+				perfetto.describeThread(*buffer);
+			}
+
+			buffer->described = true;
+		}
+
+		events.clear();
+		for(uint64_t e = read; e < written; e++)
+		{
+			events.push_back(buffer->events[e % BufferCapacity]);
+		}
+
+		// Events are only dropped while the buffer is full, so after the last
+		// event read, which was recorded at its end.
+		const Event &last = events.back();
+		uint64_t lastTime = last.phase == Complete ? last.timestamp + last.argument : last.timestamp;
+		uint64_t dropped = buffer->dropped.load(std::memory_order_relaxed);
+
+		buffer->read.store(written, std::memory_order_release);
+
+		if(state.format == Trace::ChromeJSON)
+		{
+			json.events(*buffer, events);
+		}
+		else
+		{
+			perfetto.events(*buffer, events);
+		}
+
+		if(dropped > buffer->reportedDropped)
+		{
+			char name[Trace::MaxNameLength];
+			snprintf(name, sizeof(name), "%" PRIu64 " events dropped", dropped - buffer->reportedDropped);
+			buffer->reportedDropped = dropped;
+
+			if(state.format == Trace::ChromeJSON)
+			{
+				json.dropped(*buffer, lastTime, name);
+			}
+			else
+			{
+				perfetto.dropped(*buffer, lastTime, name);
+			}
+		}
+	}
+
+	fwrite(out.data(), 1, out.size(), state.file);
+	fflush(state.file);
+}
+
+ThreadSlot::~ThreadSlot()
+{
+	if(index < 0)
+	{
+		return;
+	}
+
+	// Write the thread's remaining events before freeing its buffer.
+	{
+		State &state = sw::state();
+		std::unique_lock<std::mutex> lock(state.mutex);
+
+		drain(state);
+		delete slots[index].buffer.exchange(nullptr);
+	}
+
+	slots[index].used.store(false, std::memory_order_release);
+}
+
+}  // anonymous namespace
+
+std::atomic<bool> Trace::enabled = { false };
+
+bool Trace::start(const char *path)
+{
+	const char *extension = strrchr(path, '.');
+	bool perfetto = extension && (strcmp(extension, ".pftrace") == 0 || strcmp(extension, ".perfetto-trace") == 0);
+
+	return start(path, perfetto ? Perfetto : ChromeJSON);
+}
+
+bool Trace::start(const char *path, Format format)
+{
+	State &state = sw::state();
+	std::unique_lock<std::mutex> lock(state.mutex);
+
+	if(state.file)
+	{
+		return false;
+	}
+
+	state.file = fopen(path, "wb");
+	if(!state.file)
+	{
+		return false;
+	}
+
+	state.format = format;
+	state.firstEntry = true;
+	state.startTime = nanoseconds(std::chrono::steady_clock::now());
+	state.nextFlushTime = (std::chrono::steady_clock::now() + FlushPeriod).time_since_epoch().count();
+
+	if(format == ChromeJSON)
+	{
+		fputs("[\n", state.file);
+	}
+	else
+	{
+		std::string out;
+		PerfettoWriter(out, state).describeProcess();
+		fwrite(out.data(), 1, out.size(), state.file);
+	}
+
+	enabled = true;
+
+	return true;
+}
+
+void Trace::stop()
+{
+	State &state = sw::state();
+	std::unique_lock<std::mutex> lock(state.mutex);
+
+	if(!state.file)
+	{
+		return;
+	}
+
+	enabled = false;
+
+	// Wait for the threads still writing an event into their buffer.
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	for(Slot &slot : slots)
+	{
+		while(slot.recording.load(std::memory_order_acquire))
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	drain(state);
+
+	if(state.format == ChromeJSON)
+	{
+		fputs("\n]\n", state.file);
+	}
+
+	fclose(state.file);
+	state.file = nullptr;
+
+	// Threads allocate new buffers if another trace is started.
+	uint64_t dropped = 0;
+	for(Slot &slot : slots)
+	{
+		if(ThreadBuffer *buffer = slot.buffer.exchange(nullptr))
+		{
+			dropped += buffer->dropped.load();
+			delete buffer;
+		}
+	}
+
+	if(dropped > 0)
+	{
+		warn("%" PRIu64 " trace events were dropped. Flush the trace more often.\n", dropped);
+	}
+}
+
+void Trace::flush()
+{
+	State &state = sw::state();
+	std::unique_lock<std::mutex> lock(state.mutex);
+
+	drain(state);
+}
+
+void Trace::flushPeriodically()
+{
+	if(!isEnabled())
+	{
+		return;
+	}
+
+	// Only the thread which moves the deadline on flushes.
+	State &state = sw::state();
+	int64_t now = std::chrono::steady_clock::now().time_since_epoch().count();
+	int64_t deadline = state.nextFlushTime.load(std::memory_order_relaxed);
+	int64_t period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(FlushPeriod).count();
+	if(now < deadline || !state.nextFlushTime.compare_exchange_strong(deadline, now + period))
+	{
+		return;
+	}
+
+	flush();
+}
+
+void Trace::initializeFromEnvironment()
+{
+	const char *path = getenv("SWIFTSHADER_TRACE");
+	if(!path || !path[0])
+	{
+		return;
+	}
+
+	if(!start(path))
+	{
+		warn("Failed to start tracing to %s\n", path);
+		return;
+	}
+
+	// Write the events recorded since the last flush, and complete the file,
+	// when the process exits or the library is unloaded.
+	atexit([] { stop(); });
+}
+
+void Trace::nameThread(const char *format, ...)
+{
+	if(threadName[0] != '\0')
+	{
+		return;
+	}
+
+	va_list args;
+	va_start(args, format);
+	vsnprintf(threadName, sizeof(threadName), format, args);
+	va_end(args);
+
+	// The buffer is only allocated once the thread records an event, and then
+	// takes the thread's name.
+	if(threadSlot.index >= 0)
+	{
+		State &state = sw::state();
+		std::unique_lock<std::mutex> lock(state.mutex);
+
+		if(ThreadBuffer *buffer = slots[threadSlot.index].buffer.load())
+		{
+			memcpy(buffer->name, threadName, sizeof(threadName));
+		}
+	}
+}
+
+void Trace::event(const char *name, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end)
+{
+	if(isEnabled())
+	{
+		record(Complete, name, nanoseconds(begin), nanoseconds(end) - nanoseconds(begin));
+	}
+}
+
+void Trace::beginAsync(const char *name, uint64_t id)
+{
+	if(isEnabled())
+	{
+		record(AsyncBegin, name, nanoseconds(std::chrono::steady_clock::now()), id);
+	}
+}
+
+void Trace::endAsync(const char *name, uint64_t id)
+{
+	if(isEnabled())
+	{
+		record(AsyncEnd, name, nanoseconds(std::chrono::steady_clock::now()), id);
+	}
+}
+
+void Trace::format(char *name, const char *format, va_list args)
+{
+	vsnprintf(name, MaxNameLength, format, args);
+}
+
+}  // namespace sw
@@ -0,0 +1,154 @@
+// Copyright 2021 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef sw_Trace_hpp
+#define sw_Trace_hpp
+
+#include "marl/trace.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstdint>
+
+#if defined(__GNUC__) || defined(__clang__)
+#	define SW_TRACE_PRINTF_ARGS(formatIndex, firstArg) __attribute__((format(printf, formatIndex, firstArg)))
+#else
+#	define SW_TRACE_PRINTF_ARGS(formatIndex, firstArg)
+#endif
+
+namespace sw {
+
+// Trace records timed events into a trace file, which can be opened with
+// chrome://tracing or https://ui.perfetto.dev, to see how the driver's work
+// is spread over its threads.
+//
+// Unlike marl's tracing, it is always compiled in and is started at runtime,
+// either by setting the SWIFTSHADER_TRACE environment variable to the path
+// of the trace file, or through the swiftshader*Trace() C entry points. Paths
+// ending with .pftrace or .perfetto-trace produce a Perfetto protobuf trace,
+// others a Chrome trace event JSON array. A trace started from the
+// environment is stopped when the process exits.
+//
+// While stopped, recording an event does nothing beyond loading a relaxed
+// atomic flag. While started, each thread records its events into its own
+// single-producer single-consumer ring buffer, without locks. The buffers
+// are drained into the file by flush(), which the queue threads call
+// periodically after each submission, and by the threads whose buffer gets
+// half full. They are freed when their thread exits or the trace stops.
+// Events recorded while a thread's buffer is full are dropped, and reported
+// by an instant event on the thread's track.
+class Trace
+{
+public:
+	enum Format
+	{
+		ChromeJSON,
+		Perfetto,
+	};
+
+	// Names longer than this, including the terminating null, are truncated.
+	static constexpr int MaxNameLength = 44;
+
+	static bool isEnabled()
+	{
+		return enabled.load(std::memory_order_relaxed);
+	}
+
+	// Starts writing a trace to the file at path, in the format given by its
+	// extension. Returns false if a trace is already being written or the
+	// file can't be created.
+	static bool start(const char *path);
+	static bool start(const char *path, Format format);
+
+	// Writes the events recorded so far and closes the trace file.
+	static void stop();
+
+	// Writes the events recorded so far to the trace file.
+	static void flush();
+
+	// Calls flush() if it wasn't called in the last 100 milliseconds.
+	static void flushPeriodically();
+
+	// Starts a trace if the SWIFTSHADER_TRACE environment variable is set.
+	// Called once at library initialization.
+	static void initializeFromEnvironment();
+
+	// Names the calling thread's track in the trace. Only the first name a
+	// thread is given is used.
+	static void nameThread(const char *format, ...) SW_TRACE_PRINTF_ARGS(1, 2);
+
+	// Records an event spanning the given time range on the calling thread.
+	static void event(const char *name, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end);
+
+	// Record the beginning and the end of an asynchronous event, which may
+	// begin and end on different threads. Events of the same name are told
+	// apart by their id, and are grouped together in the trace viewers.
+	static void beginAsync(const char *name, uint64_t id);
+	static void endAsync(const char *name, uint64_t id);
+
+	// Records an event spanning its own lifetime, named by a printf format.
+	// Use SW_SCOPED_EVENT instead of declaring one directly.
+	class ScopedEvent
+	{
+	public:
+		inline ScopedEvent(const char *format, ...) SW_TRACE_PRINTF_ARGS(2, 3);
+		inline ~ScopedEvent();
+
+	private:
+		const bool active;
+		std::chrono::steady_clock::time_point begin;
+		char name[MaxNameLength];
+	};
+
+private:
+	static void format(char *name, const char *format, va_list args);
+
+	static std::atomic<bool> enabled;
+};
+
+Trace::ScopedEvent::ScopedEvent(const char *format, ...)
+    : active(isEnabled())
+{
+	if(active)
+	{
+		va_list args;
+		va_start(args, format);
+		Trace::format(name, format, args);
+		va_end(args);
+
+		begin = std::chrono::steady_clock::now();
+	}
+}
+
+Trace::ScopedEvent::~ScopedEvent()
+{
+	if(active)
+	{
+		event(name, begin, std::chrono::steady_clock::now());
+	}
+}
+
+}  // namespace sw
+
+#define SW_TRACE_CONCAT_(a, b) a##b
+#define SW_TRACE_CONCAT(a, b) SW_TRACE_CONCAT_(a, b)
+
+// SW_SCOPED_EVENT(format, ...) records the enclosing scope as an event, in
+// both marl's trace (when built in) and SwiftShader's (when started).
+#define SW_SCOPED_EVENT(...)      \
+	MARL_SCOPED_EVENT(__VA_ARGS__); \
+	::sw::Trace::ScopedEvent SW_TRACE_CONCAT(swScopedEvent, __LINE__)(__VA_ARGS__)
+
+#endif  // sw_Trace_hpp
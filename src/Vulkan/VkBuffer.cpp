@@ -16,6 +16,7 @@
 
 #include "VkConfig.hpp"
 #include "VkDeviceMemory.hpp"
+#include "Device/Transfer.hpp"
 
 #include <cstring>
 #include <limits>
@@ -106,14 +107,14 @@ void Buffer::copyFrom(const void *srcMemory, VkDeviceSize pSize, VkDeviceSize pO
 {
 	ASSERT((pSize + pOffset) <= size);
 
-	memcpy(getOffsetPointer(pOffset), srcMemory, pSize);
+	sw::transferCopy(getOffsetPointer(pOffset), srcMemory, pSize);
 }
 
 void Buffer::copyTo(void *dstMemory, VkDeviceSize pSize, VkDeviceSize pOffset) const
 {
 	ASSERT((pSize + pOffset) <= size);
 
-	memcpy(dstMemory, getOffsetPointer(pOffset), pSize);
+	sw::transferCopy(dstMemory, getOffsetPointer(pOffset), pSize);
 }
 
 void Buffer::copyTo(Buffer *dstBuffer, const VkBufferCopy2KHR &pRegion) const
@@ -131,10 +132,7 @@ void Buffer::fill(VkDeviceSize dstOffset, VkDeviceSize fillSize, uint32_t data)
 
 	// Vulkan 1.1 spec: "If VK_WHOLE_SIZE is used and the remaining size of the buffer is
 	//                   not a multiple of 4, then the nearest smaller multiple is used."
-	for(; bytes >= 4; bytes -= 4, memToWrite++)
-	{
-		*memToWrite = data;
-	}
+	sw::transferFill(memToWrite, data, bytes / 4);
 }
 
 void Buffer::update(VkDeviceSize dstOffset, VkDeviceSize dataSize, const void *pData)
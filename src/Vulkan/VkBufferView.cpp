@@ -32,6 +32,14 @@ BufferView::BufferView(const VkBufferViewCreateInfo *pCreateInfo, void *mem)
 	{
 		range = pCreateInfo->range;
 	}
+
+	sampledTexture = new(mem) sw::Texture();
+	writeSampledTexture();
+}
+
+void BufferView::destroy(const VkAllocationCallbacks *pAllocator)
+{
+	vk::freeHostMemory(sampledTexture, pAllocator);
 }
 
 void *BufferView::getPointer() const
@@ -39,4 +47,24 @@ void *BufferView::getPointer() const
 	return buffer->getOffsetPointer(offset);
 }
 
+void BufferView::writeSampledTexture()
+{
+	auto numElements = getElementCount();
+
+	sampledTexture->widthWidthHeightHeight = sw::float4(static_cast<float>(numElements), static_cast<float>(numElements), 1, 1);
+	sampledTexture->width = sw::float4(static_cast<float>(numElements));
+	sampledTexture->height = sw::float4(1);
+	sampledTexture->depth = sw::float4(1);
+
+	sw::Mipmap &mipmap = sampledTexture->mipmap[0];
+	mipmap.buffer = getPointer();
+	mipmap.width[0] = mipmap.width[1] = mipmap.width[2] = mipmap.width[3] = numElements;
+	mipmap.height[0] = mipmap.height[1] = mipmap.height[2] = mipmap.height[3] = 1;
+	mipmap.depth[0] = mipmap.depth[1] = mipmap.depth[2] = mipmap.depth[3] = 1;
+	mipmap.pitchP.x = mipmap.pitchP.y = mipmap.pitchP.z = mipmap.pitchP.w = numElements;
+	mipmap.sliceP.x = mipmap.sliceP.y = mipmap.sliceP.z = mipmap.sliceP.w = 0;
+	mipmap.onePitchP[0] = mipmap.onePitchP[2] = 1;
+	mipmap.onePitchP[1] = mipmap.onePitchP[3] = 0;
+}
+
 }  // namespace vk
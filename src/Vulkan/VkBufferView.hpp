@@ -27,10 +27,11 @@ class BufferView : public Object<BufferView, VkBufferView>
 {
 public:
 	BufferView(const VkBufferViewCreateInfo *pCreateInfo, void *mem);
+	void destroy(const VkAllocationCallbacks *pAllocator);
 
 	static size_t ComputeRequiredAllocationSize(const VkBufferViewCreateInfo *pCreateInfo)
 	{
-		return 0;
+		return sizeof(sw::Texture);
 	}
 
 	void *getPointer() const;
@@ -38,13 +39,20 @@ public:
 	uint32_t getRangeInBytes() const { return static_cast<uint32_t>(range); }
 	VkFormat getFormat() const { return format; }
 
+	// Sampling parameters for uniform texel buffer descriptors.
+	const sw::Texture *getSampledTexture() const { return sampledTexture; }
+
 	const Identifier id;
 
 private:
+	void writeSampledTexture();
+
 	Buffer *buffer;
 	VkFormat format;
 	VkDeviceSize offset;
 	VkDeviceSize range;
+
+	sw::Texture *sampledTexture = nullptr;
 };
 
 static inline BufferView *Cast(VkBufferView object)
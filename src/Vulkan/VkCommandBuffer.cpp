@@ -27,12 +27,14 @@
 #include "VkQueryPool.hpp"
 #include "VkRenderPass.hpp"
 #include "Device/Renderer.hpp"
+#include "System/Trace.hpp"
 
 #include "./Debug/Context.hpp"
 #include "./Debug/File.hpp"
 #include "./Debug/Thread.hpp"
 
 #include "marl/defer.h"
+#include "marl/scheduler.h"
 
 #include <bitset>
 #include <cstring>
@@ -68,6 +70,8 @@ public:
 		// Vulkan specifies that the attachments' `loadOp` gets executed "at the beginning of the subpass where it is first used."
 		// Since we don't discard any contents between subpasses, this is equivalent to executing it at the start of the renderpass.
 		framebuffer->executeLoadOp(executionState.renderPass, clearValueCount, clearValues, renderArea);
+
+		executionState.renderer->beginTiledSubpass(framebuffer, renderPass, 0);
 	}
 
 	std::string description() override { return "vkCmdBeginRenderPass()"; }
@@ -85,8 +89,10 @@ class CmdNextSubpass : public vk::CommandBuffer::Command
 public:
 	void execute(vk::CommandBuffer::ExecutionState &executionState) override
 	{
+		bool resolved = executionState.renderer->endTiledSubpass();
+
 		bool hasResolveAttachments = (executionState.renderPass->getSubpass(executionState.subpassIndex).pResolveAttachments != nullptr);
-		if(hasResolveAttachments)
+		if(hasResolveAttachments && !resolved)
 		{
 			// TODO(b/197691918): Avoid halt-the-world synchronization.
 			executionState.renderer->synchronize();
@@ -96,6 +102,8 @@ public:
 		}
 
 		executionState.subpassIndex++;
+
+		executionState.renderer->beginTiledSubpass(executionState.renderPassFramebuffer, executionState.renderPass, executionState.subpassIndex);
 	}
 
 	std::string description() override { return "vkCmdNextSubpass()"; }
@@ -106,12 +114,19 @@ class CmdEndRenderPass : public vk::CommandBuffer::Command
 public:
 	void execute(vk::CommandBuffer::ExecutionState &executionState) override
 	{
+		bool resolved = executionState.renderer->endTiledSubpass();
+
 		// Execute (implicit or explicit) VkSubpassDependency to VK_SUBPASS_EXTERNAL.
 		// TODO(b/197691918): Avoid halt-the-world synchronization.
 		executionState.renderer->synchronize();
 
-		// TODO(b/197691917): Eliminate redundant resolve operations.
-		executionState.renderPassFramebuffer->resolve(executionState.renderPass, executionState.subpassIndex);
+		if(!resolved)
+		{
+			// TODO(b/197691917): Eliminate redundant resolve operations.
+			executionState.renderPassFramebuffer->resolve(executionState.renderPass, executionState.subpassIndex);
+		}
+
+		executionState.renderPassFramebuffer->executeStoreOp(executionState.renderPass);
 
 		executionState.renderPass = nullptr;
 		executionState.renderPassFramebuffer = nullptr;
@@ -160,6 +175,19 @@ private:
 	vk::Pipeline *const pipeline;
 };
 
+// Dispatches run to completion on the queue thread, so their statistics are
+// added to the active pipeline statistics query directly.
+void addComputeStatistics(vk::CommandBuffer::ExecutionState &executionState, const vk::ComputePipeline *pipeline,
+                          uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ)
+{
+	if(auto *query = executionState.renderer->getPipelineStatisticsQuery())
+	{
+		uint64_t groupCount = uint64_t(groupCountX) * groupCountY * groupCountZ;
+		query->addStatistic(VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT,
+		                    groupCount * pipeline->getWorkgroupInvocationCount());
+	}
+}
+
 class CmdDispatch : public vk::CommandBuffer::Command
 {
 public:
@@ -184,6 +212,8 @@ public:
 		              pipelineState.descriptorSets,
 		              pipelineState.descriptorDynamicOffsets,
 		              executionState.pushConstants);
+
+		addComputeStatistics(executionState, pipeline, groupCountX, groupCountY, groupCountZ);
 	}
 
 	std::string description() override { return "vkCmdDispatch()"; }
@@ -218,6 +248,8 @@ public:
 		              pipelineState.descriptorSets,
 		              pipelineState.descriptorDynamicOffsets,
 		              executionState.pushConstants);
+
+		addComputeStatistics(executionState, pipeline, cmd->x, cmd->y, cmd->z);
 	}
 
 	std::string description() override { return "vkCmdDispatchIndirect()"; }
@@ -473,6 +505,46 @@ class CmdDrawBase : public vk::CommandBuffer::Command
 public:
 	void draw(vk::CommandBuffer::ExecutionState &executionState, bool indexed,
 	          uint32_t count, uint32_t instanceCount, uint32_t first, int32_t vertexOffset, uint32_t firstInstance)
+	{
+		auto *pipeline = bindState(executionState);
+		drawInstances(executionState, pipeline, indexed, count, instanceCount, first, vertexOffset, firstInstance);
+	}
+
+	// Executes drawCount indirect draw records as a single multi-draw job.
+	void drawIndirect(vk::CommandBuffer::ExecutionState &executionState, bool indexed,
+	                  const vk::Buffer *buffer, VkDeviceSize offset, uint32_t drawCount, uint32_t stride)
+	{
+		if(drawCount == 0)
+		{
+			return;
+		}
+
+		auto *pipeline = bindState(executionState);
+
+		executionState.renderer->beginMultiDraw();
+
+		for(auto drawId = 0u; drawId < drawCount; drawId++)
+		{
+			const void *record = buffer->getOffsetPointer(offset + drawId * stride);
+
+			if(indexed)
+			{
+				auto cmd = reinterpret_cast<VkDrawIndexedIndirectCommand const *>(record);
+				drawInstances(executionState, pipeline, true, cmd->indexCount, cmd->instanceCount, cmd->firstIndex, cmd->vertexOffset, cmd->firstInstance);
+			}
+			else
+			{
+				auto cmd = reinterpret_cast<VkDrawIndirectCommand const *>(record);
+				drawInstances(executionState, pipeline, false, cmd->vertexCount, cmd->instanceCount, 0, cmd->firstVertex, cmd->firstInstance);
+			}
+		}
+
+		executionState.renderer->endMultiDraw();
+	}
+
+private:
+	// Binds the state which all draws of a command share.
+	vk::GraphicsPipeline *bindState(vk::CommandBuffer::ExecutionState &executionState)
 	{
 		auto const &pipelineState = executionState.pipelineState[VK_PIPELINE_BIND_POINT_GRAPHICS];
 
@@ -486,11 +558,19 @@ public:
 		                            pipelineState.descriptorSets,
 		                            pipelineState.descriptorDynamicOffsets);
 		inputs.setVertexInputBinding(executionState.vertexInputBindings);
-		inputs.bindVertexInputs(firstInstance);
 
 		vk::IndexBuffer &indexBuffer = pipeline->getIndexBuffer();
 		indexBuffer.setIndexBufferBinding(executionState.indexBufferBinding, executionState.indexType);
 
+		return pipeline;
+	}
+
+	void drawInstances(vk::CommandBuffer::ExecutionState &executionState, vk::GraphicsPipeline *pipeline, bool indexed,
+	                   uint32_t count, uint32_t instanceCount, uint32_t first, int32_t vertexOffset, uint32_t firstInstance)
+	{
+		vk::Inputs &inputs = pipeline->getInputs();
+		inputs.bindVertexInputs(firstInstance);
+
 		std::vector<std::pair<uint32_t, void *>> indexBuffers;
 		pipeline->getIndexBuffers(count, first, indexed, &indexBuffers);
 
@@ -582,11 +662,7 @@ public:
 
 	void execute(vk::CommandBuffer::ExecutionState &executionState) override
 	{
-		for(auto drawId = 0u; drawId < drawCount; drawId++)
-		{
-			auto cmd = reinterpret_cast<VkDrawIndirectCommand const *>(buffer->getOffsetPointer(offset + drawId * stride));
-			draw(executionState, false, cmd->vertexCount, cmd->instanceCount, 0, cmd->firstVertex, cmd->firstInstance);
-		}
+		drawIndirect(executionState, false, buffer, offset, drawCount, stride);
 	}
 
 	std::string description() override { return "vkCmdDrawIndirect()"; }
@@ -611,11 +687,7 @@ public:
 
 	void execute(vk::CommandBuffer::ExecutionState &executionState) override
 	{
-		for(auto drawId = 0u; drawId < drawCount; drawId++)
-		{
-			auto cmd = reinterpret_cast<VkDrawIndexedIndirectCommand const *>(buffer->getOffsetPointer(offset + drawId * stride));
-			draw(executionState, true, cmd->indexCount, cmd->instanceCount, cmd->firstIndex, cmd->vertexOffset, cmd->firstInstance);
-		}
+		drawIndirect(executionState, true, buffer, offset, drawCount, stride);
 	}
 
 	std::string description() override { return "vkCmdDrawIndexedIndirect()"; }
@@ -627,6 +699,66 @@ private:
 	const uint32_t stride;
 };
 
+class CmdDrawIndirectCount : public CmdDrawBase
+{
+public:
+	CmdDrawIndirectCount(vk::Buffer *buffer, VkDeviceSize offset, vk::Buffer *countBuffer, VkDeviceSize countBufferOffset, uint32_t maxDrawCount, uint32_t stride)
+	    : buffer(buffer)
+	    , offset(offset)
+	    , countBuffer(countBuffer)
+	    , countBufferOffset(countBufferOffset)
+	    , maxDrawCount(maxDrawCount)
+	    , stride(stride)
+	{
+	}
+
+	void execute(vk::CommandBuffer::ExecutionState &executionState) override
+	{
+		auto drawCount = *reinterpret_cast<uint32_t const *>(countBuffer->getOffsetPointer(countBufferOffset));
+		drawIndirect(executionState, false, buffer, offset, std::min(drawCount, maxDrawCount), stride);
+	}
+
+	std::string description() override { return "vkCmdDrawIndirectCount()"; }
+
+private:
+	const vk::Buffer *const buffer;
+	const VkDeviceSize offset;
+	const vk::Buffer *const countBuffer;
+	const VkDeviceSize countBufferOffset;
+	const uint32_t maxDrawCount;
+	const uint32_t stride;
+};
+
+class CmdDrawIndexedIndirectCount : public CmdDrawBase
+{
+public:
+	CmdDrawIndexedIndirectCount(vk::Buffer *buffer, VkDeviceSize offset, vk::Buffer *countBuffer, VkDeviceSize countBufferOffset, uint32_t maxDrawCount, uint32_t stride)
+	    : buffer(buffer)
+	    , offset(offset)
+	    , countBuffer(countBuffer)
+	    , countBufferOffset(countBufferOffset)
+	    , maxDrawCount(maxDrawCount)
+	    , stride(stride)
+	{
+	}
+
+	void execute(vk::CommandBuffer::ExecutionState &executionState) override
+	{
+		auto drawCount = *reinterpret_cast<uint32_t const *>(countBuffer->getOffsetPointer(countBufferOffset));
+		drawIndirect(executionState, true, buffer, offset, std::min(drawCount, maxDrawCount), stride);
+	}
+
+	std::string description() override { return "vkCmdDrawIndexedIndirectCount()"; }
+
+private:
+	const vk::Buffer *const buffer;
+	const VkDeviceSize offset;
+	const vk::Buffer *const countBuffer;
+	const VkDeviceSize countBufferOffset;
+	const uint32_t maxDrawCount;
+	const uint32_t stride;
+};
+
 class CmdCopyImage : public vk::CommandBuffer::Command
 {
 public:
@@ -1072,7 +1204,7 @@ public:
 		}
 
 		// The renderer accumulates the result into a single query.
-		ASSERT(queryPool->getType() == VK_QUERY_TYPE_OCCLUSION);
+		ASSERT(queryPool->getType() == VK_QUERY_TYPE_OCCLUSION || queryPool->getType() == VK_QUERY_TYPE_PIPELINE_STATISTICS);
 		executionState.renderer->addQuery(queryPool->getQuery(query));
 	}
 
@@ -1096,7 +1228,7 @@ public:
 	void execute(vk::CommandBuffer::ExecutionState &executionState) override
 	{
 		// The renderer accumulates the result into a single query.
-		ASSERT(queryPool->getType() == VK_QUERY_TYPE_OCCLUSION);
+		ASSERT(queryPool->getType() == VK_QUERY_TYPE_OCCLUSION || queryPool->getType() == VK_QUERY_TYPE_PIPELINE_STATISTICS);
 		executionState.renderer->removeQuery(queryPool->getQuery(query));
 
 		// "implementations may write the total result to the first query and write zero to the other queries."
@@ -1153,23 +1285,54 @@ public:
 
 	void execute(vk::CommandBuffer::ExecutionState &executionState) override
 	{
-		if(stage & ~(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT))
+		// "the timestamp uses N consecutive query indices in the query pool (starting at `query`) where
+		//  N is the number of bits set in the view mask of the subpass the command is executed in."
+		const uint32_t viewCount = executionState.viewCount();
+
+		if(!(stage & ~(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT)))
 		{
 			// The `top of pipe` and `draw indirect` stages are handled in command buffer processing so a timestamp write
 			// done in those stages can just be done here without any additional synchronization.
-			// Everything else is deferred to the Renderer; we will treat those stages all as if they were
-			// `bottom of pipe`.
-			//
-			// FIXME(chrisforbes): once Marl is integrated, do this in a task so we don't have to stall here.
-			executionState.renderer->synchronize();
+			for(uint32_t i = 0; i < viewCount; i++)
+			{
+				queryPool->writeTimestamp(query + i);
+			}
+
+			return;
 		}
 
-		// "the timestamp uses N consecutive query indices in the query pool (starting at `query`) where
-		//  N is the number of bits set in the view mask of the subpass the command is executed in."
-		for(uint32_t i = 0; i < executionState.viewCount(); i++)
+		// Everything else is deferred to the Renderer; we will treat those stages all as if they were
+		// `bottom of pipe`. The timestamp is written by a task once the draws issued so far have
+		// completed, so command processing does not stall. The queries remain unavailable until then.
+		for(uint32_t i = 0; i < viewCount; i++)
 		{
-			queryPool->writeTimestamp(query + i);
+			queryPool->getQuery(query + i)->start();
 		}
+
+		auto *events = executionState.events;
+		if(events)
+		{
+			events->add();
+		}
+
+		marl::Ticket ticket = executionState.renderer->takeSynchronizationTicket();
+		marl::schedule([queryPool = queryPool, query = query, viewCount, events, ticket] {
+			SW_SCOPED_EVENT("vkCmdWriteTimeStamp");
+
+			ticket.wait();
+
+			for(uint32_t i = 0; i < viewCount; i++)
+			{
+				queryPool->finishTimestamp(query + i);
+			}
+
+			ticket.done();
+
+			if(events)
+			{
+				events->done();
+			}
+		});
 	}
 
 	std::string description() override { return "vkCmdWriteTimeStamp()"; }
@@ -1710,6 +1873,16 @@ void CommandBuffer::drawIndexedIndirect(Buffer *buffer, VkDeviceSize offset, uin
 	addCommand<::CmdDrawIndexedIndirect>(buffer, offset, drawCount, stride);
 }
 
+void CommandBuffer::drawIndirectCount(Buffer *buffer, VkDeviceSize offset, Buffer *countBuffer, VkDeviceSize countBufferOffset, uint32_t maxDrawCount, uint32_t stride)
+{
+	addCommand<::CmdDrawIndirectCount>(buffer, offset, countBuffer, countBufferOffset, maxDrawCount, stride);
+}
+
+void CommandBuffer::drawIndexedIndirectCount(Buffer *buffer, VkDeviceSize offset, Buffer *countBuffer, VkDeviceSize countBufferOffset, uint32_t maxDrawCount, uint32_t stride)
+{
+	addCommand<::CmdDrawIndexedIndirectCount>(buffer, offset, countBuffer, countBufferOffset, maxDrawCount, stride);
+}
+
 void CommandBuffer::beginDebugUtilsLabel(const VkDebugUtilsLabelEXT *pLabelInfo)
 {
 	// Optional debug label region
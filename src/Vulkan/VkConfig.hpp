@@ -42,7 +42,8 @@ constexpr VkDeviceSize MIN_TEXEL_BUFFER_OFFSET_ALIGNMENT = 256;
 constexpr VkDeviceSize MIN_UNIFORM_BUFFER_OFFSET_ALIGNMENT = 256;
 constexpr VkDeviceSize MIN_STORAGE_BUFFER_OFFSET_ALIGNMENT = 256;
 
-constexpr uint32_t MEMORY_TYPE_GENERIC_BIT = 0x1;  // Generic system memory.
+constexpr uint32_t MEMORY_TYPE_GENERIC_BIT = 0x1;           // Generic system memory.
+constexpr uint32_t MEMORY_TYPE_LAZILY_ALLOCATED_BIT = 0x2;  // Pages committed on first write.
 
 constexpr uint32_t MAX_IMAGE_LEVELS_1D = 15;
 constexpr uint32_t MAX_IMAGE_LEVELS_2D = 15;
@@ -66,6 +67,11 @@ constexpr uint32_t MAX_DESCRIPTOR_SET_COMBINED_BUFFERS_DYNAMIC =
     MAX_DESCRIPTOR_SET_UNIFORM_BUFFERS_DYNAMIC +
     MAX_DESCRIPTOR_SET_STORAGE_BUFFERS_DYNAMIC;
 
+// Descriptors of sets allocated from update-after-bind pools are only bounded
+// by memory, since shaders read them when they execute. This is the minimum
+// the specification requires when descriptor indexing is supported.
+constexpr uint32_t MAX_UPDATE_AFTER_BIND_DESCRIPTORS = 500000;
+
 constexpr float MAX_POINT_SIZE = 1023.0;
 
 constexpr int MAX_SAMPLER_ALLOCATION_COUNT = 4000;
@@ -88,6 +94,7 @@ static_assert(MAX_MEMORY_ALLOCATION_SIZE <= 0x80000000ull, "maxMemoryAllocationS
 #if defined(__linux__) && !defined(__ANDROID__)
 #	define SWIFTSHADER_EXTERNAL_MEMORY_OPAQUE_FD 1
 #	define SWIFTSHADER_EXTERNAL_SEMAPHORE_OPAQUE_FD 1
+#	define SWIFTSHADER_HEADLESS_FRAME_EXPORT 1
 #elif defined(__ANDROID__)
 #	define SWIFTSHADER_EXTERNAL_SEMAPHORE_OPAQUE_FD 1
 #endif
@@ -55,14 +55,19 @@ size_t DescriptorPool::ComputeRequiredAllocationSize(const VkDescriptorPoolCreat
 	return size;
 }
 
-VkResult DescriptorPool::allocateSets(uint32_t descriptorSetCount, const VkDescriptorSetLayout *pSetLayouts, VkDescriptorSet *pDescriptorSets)
+VkResult DescriptorPool::allocateSets(uint32_t descriptorSetCount, const VkDescriptorSetLayout *pSetLayouts, const uint32_t *pVariableDescriptorCounts, VkDescriptorSet *pDescriptorSets)
 {
 	// FIXME (b/119409619): use an allocator here so we can control all memory allocations
 	std::unique_ptr<size_t[]> layoutSizes(new size_t[descriptorSetCount]);
 	for(uint32_t i = 0; i < descriptorSetCount; i++)
 	{
+		// "If VkDescriptorSetAllocateInfo::pNext does not include a VkDescriptorSetVariableDescriptorCountAllocateInfo
+		//  structure, or if descriptorSetCount is zero, then the variable lengthed descriptor binding in the
+		//  corresponding descriptor set layout has a descriptor count of zero."
+		uint32_t variableDescriptorCount = pVariableDescriptorCounts ? pVariableDescriptorCounts[i] : 0;
+
 		pDescriptorSets[i] = VK_NULL_HANDLE;
-		layoutSizes[i] = vk::Cast(pSetLayouts[i])->getDescriptorSetAllocationSize();
+		layoutSizes[i] = vk::Cast(pSetLayouts[i])->getDescriptorSetAllocationSize(variableDescriptorCount);
 	}
 
 	VkResult result = allocateSets(&(layoutSizes[0]), descriptorSetCount, pDescriptorSets);
@@ -70,7 +75,8 @@ VkResult DescriptorPool::allocateSets(uint32_t descriptorSetCount, const VkDescr
 	{
 		for(uint32_t i = 0; i < descriptorSetCount; i++)
 		{
-			vk::Cast(pSetLayouts[i])->initialize(vk::Cast(pDescriptorSets[i]));
+			uint32_t variableDescriptorCount = pVariableDescriptorCounts ? pVariableDescriptorCounts[i] : 0;
+			vk::Cast(pSetLayouts[i])->initialize(vk::Cast(pDescriptorSets[i]), variableDescriptorCount);
 		}
 	}
 	return result;
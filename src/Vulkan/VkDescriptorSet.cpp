@@ -14,6 +14,7 @@
 
 #include "VkDescriptorSet.hpp"
 
+#include "VkDescriptorSetLayout.hpp"
 #include "VkDevice.hpp"
 #include "VkImageView.hpp"
 #include "VkPipelineLayout.hpp"
@@ -30,7 +31,7 @@ void DescriptorSet::ParseDescriptors(const Array &descriptorSets, const Pipeline
 		for(uint32_t i = 0; i < descriptorSetCount; ++i)
 		{
 			DescriptorSet *descriptorSet = descriptorSets[i];
-			if(!descriptorSet)
+			if(!descriptorSet || !descriptorSet->header.hasMemoryOwners)
 			{
 				continue;
 			}
@@ -40,7 +41,7 @@ void DescriptorSet::ParseDescriptors(const Array &descriptorSets, const Pipeline
 			for(uint32_t j = 0; j < bindingCount; ++j)
 			{
 				VkDescriptorType type = layout->getDescriptorType(i, j);
-				uint32_t descriptorCount = layout->getDescriptorCount(i, j);
+				uint32_t descriptorCount = descriptorSet->header.layout->getDescriptorCount(descriptorSet, j);
 				uint32_t descriptorSize = layout->getDescriptorSize(i, j);
 				uint8_t *descriptorMemory = descriptorSet->data + layout->getBindingOffset(i, j);
 
@@ -19,6 +19,7 @@
 #include "marl/mutex.h"
 
 #include <array>
+#include <atomic>
 #include <cstdint>
 #include <memory>
 
@@ -31,6 +32,8 @@ class PipelineLayout;
 struct alignas(16) DescriptorSetHeader
 {
 	DescriptorSetLayout *layout;
+	uint32_t variableDescriptorCount;   // Of the binding with VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT, if any.
+	std::atomic<bool> hasMemoryOwners;  // True once a descriptor referencing an image which requires preprocessing was written.
 	marl::mutex mutex;
 };
 
@@ -35,6 +35,20 @@ static bool UsesImmutableSamplers(const VkDescriptorSetLayoutBinding &binding)
 	        (binding.pImmutableSamplers != nullptr));
 }
 
+// Returns the image view to notify when the descriptor is used, or null if the
+// notifications would be no-ops. Descriptor sets without any memory owners are
+// skipped entirely when drawing, which keeps large descriptor arrays cheap to bind.
+static ImageView *MemoryOwner(DescriptorSet *descriptorSet, ImageView *imageView)
+{
+	if(!imageView->requiresPreprocessing())
+	{
+		return nullptr;
+	}
+
+	descriptorSet->header.hasMemoryOwners = true;
+	return imageView;
+}
+
 DescriptorSetLayout::DescriptorSetLayout(const VkDescriptorSetLayoutCreateInfo *pCreateInfo, void *mem)
     : flags(pCreateInfo->flags)
     , bindings(reinterpret_cast<Binding *>(mem))
@@ -54,9 +68,26 @@ DescriptorSetLayout::DescriptorSetLayout(const VkDescriptorSetLayoutCreateInfo *
 	{
 		bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
 		bindings[i].descriptorCount = 0;
+		bindings[i].flags = 0;
 		bindings[i].immutableSamplers = nullptr;
 	}
 
+	const VkDescriptorBindingFlags *bindingFlags = nullptr;
+	for(const auto *nextInfo = reinterpret_cast<const VkBaseInStructure *>(pCreateInfo->pNext); nextInfo != nullptr; nextInfo = nextInfo->pNext)
+	{
+		if(nextInfo->sType == VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO)
+		{
+			const auto *bindingFlagsInfo = reinterpret_cast<const VkDescriptorSetLayoutBindingFlagsCreateInfo *>(nextInfo);
+			// "If bindingCount is zero or if this structure is not included in the pNext chain,
+			//  the VkDescriptorBindingFlags for each descriptor set layout binding is considered to be zero."
+			if(bindingFlagsInfo->bindingCount != 0)
+			{
+				ASSERT(bindingFlagsInfo->bindingCount == pCreateInfo->bindingCount);
+				bindingFlags = bindingFlagsInfo->pBindingFlags;
+			}
+		}
+	}
+
 	for(uint32_t i = 0; i < pCreateInfo->bindingCount; i++)
 	{
 		const auto &srcBinding = pCreateInfo->pBindings[i];
@@ -64,6 +95,12 @@ DescriptorSetLayout::DescriptorSetLayout(const VkDescriptorSetLayoutCreateInfo *
 
 		dstBinding.descriptorType = srcBinding.descriptorType;
 		dstBinding.descriptorCount = srcBinding.descriptorCount;
+		dstBinding.flags = bindingFlags ? bindingFlags[i] : 0;
+
+		// "If an element of pBindingFlags includes VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT,
+		//  then all other elements of VkDescriptorSetLayoutCreateInfo::pBindings must have a smaller
+		//  value of binding."
+		ASSERT(!(dstBinding.flags & VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT) || (srcBinding.binding + 1 == bindingsArraySize));
 
 		if(UsesImmutableSamplers(srcBinding))
 		{
@@ -85,7 +122,8 @@ DescriptorSetLayout::DescriptorSetLayout(const VkDescriptorSetLayoutCreateInfo *
 		offset += bindings[i].descriptorCount * GetDescriptorSize(bindings[i].descriptorType);
 	}
 
-	ASSERT_MSG(offset == getDescriptorSetDataSize(), "offset: %d, size: %d", int(offset), int(getDescriptorSetDataSize()));
+	uint32_t maxVariableDescriptorCount = hasVariableDescriptorCount() ? bindings[bindingsArraySize - 1].descriptorCount : 0;
+	ASSERT_MSG(offset == getDescriptorSetDataSize(maxVariableDescriptorCount), "offset: %d, size: %d", int(offset), int(getDescriptorSetDataSize(maxVariableDescriptorCount)));
 }
 
 void DescriptorSetLayout::destroy(const VkAllocationCallbacks *pAllocator)
@@ -141,38 +179,47 @@ bool DescriptorSetLayout::IsDescriptorDynamic(VkDescriptorType type)
 	       type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
 }
 
-size_t DescriptorSetLayout::getDescriptorSetAllocationSize() const
+size_t DescriptorSetLayout::getDescriptorSetAllocationSize(uint32_t variableDescriptorCount) const
 {
 	// vk::DescriptorSet has a header with a pointer to the layout.
-	return sw::align<alignof(DescriptorSet)>(OFFSET(DescriptorSet, data) + getDescriptorSetDataSize());
+	return sw::align<alignof(DescriptorSet)>(OFFSET(DescriptorSet, data) + getDescriptorSetDataSize(variableDescriptorCount));
 }
 
-size_t DescriptorSetLayout::getDescriptorSetDataSize() const
+size_t DescriptorSetLayout::getDescriptorSetDataSize(uint32_t variableDescriptorCount) const
 {
 	size_t size = 0;
 	for(uint32_t i = 0; i < bindingsArraySize; i++)
 	{
-		size += bindings[i].descriptorCount * GetDescriptorSize(bindings[i].descriptorType);
+		uint32_t descriptorCount = (bindings[i].flags & VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT) ? variableDescriptorCount : bindings[i].descriptorCount;
+		size += descriptorCount * GetDescriptorSize(bindings[i].descriptorType);
 	}
 
 	return size;
 }
 
-void DescriptorSetLayout::initialize(DescriptorSet *descriptorSet)
+bool DescriptorSetLayout::hasVariableDescriptorCount() const
+{
+	return (bindingsArraySize > 0) && (bindings[bindingsArraySize - 1].flags & VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT);
+}
+
+void DescriptorSetLayout::initialize(DescriptorSet *descriptorSet, uint32_t variableDescriptorCount)
 {
 	ASSERT(descriptorSet->header.layout == nullptr);
 
 	// Use a pointer to this descriptor set layout as the descriptor set's header
 	descriptorSet->header.layout = this;
+	descriptorSet->header.variableDescriptorCount = hasVariableDescriptorCount() ? variableDescriptorCount : 0;
+	descriptorSet->header.hasMemoryOwners = false;
 	uint8_t *mem = descriptorSet->data;
 
 	for(uint32_t i = 0; i < bindingsArraySize; i++)
 	{
 		size_t descriptorSize = GetDescriptorSize(bindings[i].descriptorType);
+		uint32_t descriptorCount = getDescriptorCount(descriptorSet, i);
 
 		if(bindings[i].immutableSamplers)
 		{
-			for(uint32_t j = 0; j < bindings[i].descriptorCount; j++)
+			for(uint32_t j = 0; j < descriptorCount; j++)
 			{
 				SampledImageDescriptor *imageSamplerDescriptor = reinterpret_cast<SampledImageDescriptor *>(mem);
 				imageSamplerDescriptor->samplerId = bindings[i].immutableSamplers[j]->id;
@@ -188,7 +235,7 @@ void DescriptorSetLayout::initialize(DescriptorSet *descriptorSet)
 			case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
 			case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
 			case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
-				for(uint32_t j = 0; j < bindings[i].descriptorCount; j++)
+				for(uint32_t j = 0; j < descriptorCount; j++)
 				{
 					SampledImageDescriptor *imageSamplerDescriptor = reinterpret_cast<SampledImageDescriptor *>(mem);
 					imageSamplerDescriptor->memoryOwner = nullptr;
@@ -198,7 +245,7 @@ void DescriptorSetLayout::initialize(DescriptorSet *descriptorSet)
 			case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
 			case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
 			case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
-				for(uint32_t j = 0; j < bindings[i].descriptorCount; j++)
+				for(uint32_t j = 0; j < descriptorCount; j++)
 				{
 					StorageImageDescriptor *storageImage = reinterpret_cast<StorageImageDescriptor *>(mem);
 					storageImage->memoryOwner = nullptr;
@@ -209,7 +256,7 @@ void DescriptorSetLayout::initialize(DescriptorSet *descriptorSet)
 			case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
 			case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
 			case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
-				mem += bindings[i].descriptorCount * descriptorSize;
+				mem += descriptorCount * descriptorSize;
 				break;
 			default:
 				UNSUPPORTED("Unsupported Descriptor Type: %d", int(bindings[i].descriptorType));
@@ -230,6 +277,17 @@ uint32_t DescriptorSetLayout::getDescriptorCount(uint32_t bindingNumber) const
 	return bindings[bindingNumber].descriptorCount;
 }
 
+uint32_t DescriptorSetLayout::getDescriptorCount(const DescriptorSet *descriptorSet, uint32_t bindingNumber) const
+{
+	ASSERT(bindingNumber < bindingsArraySize);
+	if(bindings[bindingNumber].flags & VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT)
+	{
+		return descriptorSet->header.variableDescriptorCount;
+	}
+
+	return bindings[bindingNumber].descriptorCount;
+}
+
 uint32_t DescriptorSetLayout::getDynamicDescriptorCount() const
 {
 	uint32_t count = 0;
@@ -272,7 +330,7 @@ uint8_t *DescriptorSetLayout::getDescriptorPointer(DescriptorSet *descriptorSet,
 	ASSERT(bindingNumber < bindingsArraySize);
 	*typeSize = GetDescriptorSize(bindings[bindingNumber].descriptorType);
 	size_t byteOffset = bindings[bindingNumber].offset + (*typeSize * arrayElement);
-	ASSERT(((*typeSize * count) + byteOffset) <= getDescriptorSetDataSize());  // Make sure the operation will not go out of bounds
+	ASSERT(((*typeSize * count) + byteOffset) <= getDescriptorSetDataSize(descriptorSet->header.variableDescriptorCount));  // Make sure the operation will not go out of bounds
 
 	return &descriptorSet->data[byteOffset];
 }
@@ -315,26 +373,12 @@ void DescriptorSetLayout::WriteDescriptorSet(Device *device, DescriptorSet *dstS
 
 			sampledImage[i].imageViewId = bufferView->id;
 
-			auto numElements = bufferView->getElementCount();
-			sampledImage[i].width = numElements;
+			sampledImage[i].width = bufferView->getElementCount();
 			sampledImage[i].height = 1;
 			sampledImage[i].depth = 1;
 			sampledImage[i].mipLevels = 1;
 			sampledImage[i].sampleCount = 1;
-			sampledImage[i].texture.widthWidthHeightHeight = sw::float4(static_cast<float>(numElements), static_cast<float>(numElements), 1, 1);
-			sampledImage[i].texture.width = sw::float4(static_cast<float>(numElements));
-			sampledImage[i].texture.height = sw::float4(1);
-			sampledImage[i].texture.depth = sw::float4(1);
-
-			sw::Mipmap &mipmap = sampledImage[i].texture.mipmap[0];
-			mipmap.buffer = bufferView->getPointer();
-			mipmap.width[0] = mipmap.width[1] = mipmap.width[2] = mipmap.width[3] = numElements;
-			mipmap.height[0] = mipmap.height[1] = mipmap.height[2] = mipmap.height[3] = 1;
-			mipmap.depth[0] = mipmap.depth[1] = mipmap.depth[2] = mipmap.depth[3] = 1;
-			mipmap.pitchP.x = mipmap.pitchP.y = mipmap.pitchP.z = mipmap.pitchP.w = numElements;
-			mipmap.sliceP.x = mipmap.sliceP.y = mipmap.sliceP.z = mipmap.sliceP.w = 0;
-			mipmap.onePitchP[0] = mipmap.onePitchP[2] = 1;
-			mipmap.onePitchP[1] = mipmap.onePitchP[3] = 0;
+			sampledImage[i].texture = bufferView->getSampledTexture();
 		}
 	}
 	else if(entry.descriptorType == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER ||
@@ -347,9 +391,6 @@ void DescriptorSetLayout::WriteDescriptorSet(Device *device, DescriptorSet *dstS
 			auto *update = reinterpret_cast<VkDescriptorImageInfo const *>(src + entry.offset + entry.stride * i);
 
 			vk::ImageView *imageView = vk::Cast(update->imageView);
-			Format format = imageView->getFormat(ImageView::SAMPLING);
-
-			sw::Texture *texture = &sampledImage[i].texture;
 
 			if(entry.descriptorType == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER)
 			{
@@ -364,85 +405,15 @@ void DescriptorSetLayout::WriteDescriptorSet(Device *device, DescriptorSet *dstS
 			const auto &extent = imageView->getMipLevelExtent(0);
 
 			sampledImage[i].imageViewId = imageView->id;
+			sampledImage[i].texture = imageView->getSampledTexture();
 			sampledImage[i].width = extent.width;
 			sampledImage[i].height = extent.height;
 			sampledImage[i].depth = imageView->getDepthOrLayerCount(0);
 			sampledImage[i].mipLevels = imageView->getSubresourceRange().levelCount;
 			sampledImage[i].sampleCount = imageView->getSampleCount();
-			sampledImage[i].memoryOwner = imageView;
-
-			auto &subresourceRange = imageView->getSubresourceRange();
-
-			if(format.isYcbcrFormat())
-			{
-				ASSERT(subresourceRange.levelCount == 1);
-
-				// YCbCr images can only have one level, so we can store parameters for the
-				// different planes in the descriptor's mipmap levels instead.
-
-				const int level = 0;
-				VkOffset3D offset = { 0, 0, 0 };
-				texture->mipmap[0].buffer = imageView->getOffsetPointer(offset, VK_IMAGE_ASPECT_PLANE_0_BIT, level, 0, ImageView::SAMPLING);
-				texture->mipmap[1].buffer = imageView->getOffsetPointer(offset, VK_IMAGE_ASPECT_PLANE_1_BIT, level, 0, ImageView::SAMPLING);
-				if(format.getAspects() & VK_IMAGE_ASPECT_PLANE_2_BIT)
-				{
-					texture->mipmap[2].buffer = imageView->getOffsetPointer(offset, VK_IMAGE_ASPECT_PLANE_2_BIT, level, 0, ImageView::SAMPLING);
-				}
-
-				VkExtent2D extent = imageView->getMipLevelExtent(0);
-
-				int width = extent.width;
-				int height = extent.height;
-				int pitchP0 = imageView->rowPitchBytes(VK_IMAGE_ASPECT_PLANE_0_BIT, level, ImageView::SAMPLING) /
-				              imageView->getFormat(VK_IMAGE_ASPECT_PLANE_0_BIT).bytes();
+			sampledImage[i].memoryOwner = MemoryOwner(dstSet, imageView);
 
-				// Write plane 0 parameters to mipmap level 0.
-				WriteTextureLevelInfo(texture, 0, width, height, 1, pitchP0, 0, 0, 0);
-
-				// Plane 2, if present, has equal parameters to plane 1, so we use mipmap level 1 for both.
-				int pitchP1 = imageView->rowPitchBytes(VK_IMAGE_ASPECT_PLANE_1_BIT, level, ImageView::SAMPLING) /
-				              imageView->getFormat(VK_IMAGE_ASPECT_PLANE_1_BIT).bytes();
-
-				WriteTextureLevelInfo(texture, 1, width / 2, height / 2, 1, pitchP1, 0, 0, 0);
-			}
-			else
-			{
-				for(int mipmapLevel = 0; mipmapLevel < sw::MIPMAP_LEVELS; mipmapLevel++)
-				{
-					int level = sw::clamp(mipmapLevel, 0, (int)subresourceRange.levelCount - 1);  // Level within the image view
-
-					VkImageAspectFlagBits aspect = static_cast<VkImageAspectFlagBits>(imageView->getSubresourceRange().aspectMask);
-					sw::Mipmap &mipmap = texture->mipmap[mipmapLevel];
-
-					if((imageView->getType() == VK_IMAGE_VIEW_TYPE_CUBE) ||
-					   (imageView->getType() == VK_IMAGE_VIEW_TYPE_CUBE_ARRAY))
-					{
-						// Obtain the pointer to the corner of the level including the border, for seamless sampling.
-						// This is taken into account in the sampling routine, which can't handle negative texel coordinates.
-						VkOffset3D offset = { -1, -1, 0 };
-						mipmap.buffer = imageView->getOffsetPointer(offset, aspect, level, 0, ImageView::SAMPLING);
-					}
-					else
-					{
-						VkOffset3D offset = { 0, 0, 0 };
-						mipmap.buffer = imageView->getOffsetPointer(offset, aspect, level, 0, ImageView::SAMPLING);
-					}
-
-					VkExtent2D extent = imageView->getMipLevelExtent(level);
-
-					int width = extent.width;
-					int height = extent.height;
-					int layerCount = imageView->getSubresourceRange().layerCount;
-					int depth = imageView->getDepthOrLayerCount(level);
-					int bytes = format.bytes();
-					int pitchP = imageView->rowPitchBytes(aspect, level, ImageView::SAMPLING) / bytes;
-					int sliceP = (layerCount > 1 ? imageView->layerPitchBytes(aspect, ImageView::SAMPLING) : imageView->slicePitchBytes(aspect, level, ImageView::SAMPLING)) / bytes;
-					int samplePitchP = imageView->getMipLevelSize(aspect, level, ImageView::SAMPLING) / bytes;
-					int sampleMax = imageView->getSampleCount() - 1;
-
-					WriteTextureLevelInfo(texture, mipmapLevel, width, height, depth, pitchP, sliceP, samplePitchP, sampleMax);
-				}
-			}
+			ASSERT(sampledImage[i].texture);
 		}
 	}
 	else if(entry.descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_IMAGE ||
@@ -468,7 +439,7 @@ void DescriptorSetLayout::WriteDescriptorSet(Device *device, DescriptorSet *dstS
 			                                      : imageView->slicePitchBytes(VK_IMAGE_ASPECT_COLOR_BIT, 0);
 			storageImage[i].sampleCount = imageView->getSampleCount();
 			storageImage[i].sizeInBytes = static_cast<int>(imageView->getSizeInBytes());
-			storageImage[i].memoryOwner = imageView;
+			storageImage[i].memoryOwner = MemoryOwner(dstSet, imageView);
 
 			if(imageView->getFormat().isStencil())
 			{
@@ -521,45 +492,6 @@ void DescriptorSetLayout::WriteDescriptorSet(Device *device, DescriptorSet *dstS
 	}
 }
 
-void DescriptorSetLayout::WriteTextureLevelInfo(sw::Texture *texture, int level, int width, int height, int depth, int pitchP, int sliceP, int samplePitchP, int sampleMax)
-{
-	if(level == 0)
-	{
-		texture->widthWidthHeightHeight[0] = static_cast<float>(width);
-		texture->widthWidthHeightHeight[1] = static_cast<float>(width);
-		texture->widthWidthHeightHeight[2] = static_cast<float>(height);
-		texture->widthWidthHeightHeight[3] = static_cast<float>(height);
-
-		texture->width = sw::float4(static_cast<float>(width));
-		texture->height = sw::float4(static_cast<float>(height));
-		texture->depth = sw::float4(static_cast<float>(depth));
-	}
-
-	sw::Mipmap &mipmap = texture->mipmap[level];
-
-	short halfTexelU = 0x8000 / width;
-	short halfTexelV = 0x8000 / height;
-	short halfTexelW = 0x8000 / depth;
-
-	mipmap.uHalf = sw::short4(halfTexelU);
-	mipmap.vHalf = sw::short4(halfTexelV);
-	mipmap.wHalf = sw::short4(halfTexelW);
-
-	mipmap.width = sw::int4(width);
-	mipmap.height = sw::int4(height);
-	mipmap.depth = sw::int4(depth);
-
-	mipmap.onePitchP[0] = 1;
-	mipmap.onePitchP[1] = static_cast<short>(pitchP);
-	mipmap.onePitchP[2] = 1;
-	mipmap.onePitchP[3] = static_cast<short>(pitchP);
-
-	mipmap.pitchP = sw::int4(pitchP);
-	mipmap.sliceP = sw::int4(sliceP);
-	mipmap.samplePitchP = sw::int4(samplePitchP);
-	mipmap.sampleMax = sw::int4(sampleMax);
-}
-
 void DescriptorSetLayout::WriteDescriptorSet(Device *device, const VkWriteDescriptorSet &writeDescriptorSet)
 {
 	DescriptorSet *dstSet = vk::Cast(writeDescriptorSet.dstSet);
@@ -621,6 +553,11 @@ void DescriptorSetLayout::CopyDescriptorSet(const VkCopyDescriptorSet &descripto
 	ASSERT(srcTypeSize == dstTypeSize);
 	size_t writeSize = dstTypeSize * descriptorCopies.descriptorCount;
 	memcpy(memToWrite, memToRead, writeSize);
+
+	if(srcSet->header.hasMemoryOwners)
+	{
+		dstSet->header.hasMemoryOwners = true;
+	}
 }
 
 }  // namespace vk
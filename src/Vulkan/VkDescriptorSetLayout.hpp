@@ -40,8 +40,8 @@ struct alignas(16) SampledImageDescriptor : ImageDescriptor
 
 	uint32_t samplerId;
 
-	alignas(16) sw::Texture texture;
-	int width;  // Of base mip-level.
+	const sw::Texture *texture;  // Owned by the image view or buffer view
+	int width;                   // Of base mip-level.
 	int height;
 	int depth;  // Layer/cube count for arrayed images
 	int mipLevels;
@@ -87,6 +87,7 @@ class DescriptorSetLayout : public Object<DescriptorSetLayout, VkDescriptorSetLa
 	{
 		VkDescriptorType descriptorType;
 		uint32_t descriptorCount;
+		VkDescriptorBindingFlags flags;
 		const vk::Sampler **immutableSamplers;
 
 		uint32_t offset;  // Offset in bytes in the descriptor set data.
@@ -105,12 +106,16 @@ public:
 	static void CopyDescriptorSet(const VkCopyDescriptorSet &descriptorCopies);
 
 	static void WriteDescriptorSet(Device *device, DescriptorSet *dstSet, VkDescriptorUpdateTemplateEntry const &entry, char const *src);
-	static void WriteTextureLevelInfo(sw::Texture *texture, int level, int width, int height, int depth, int pitchP, int sliceP, int samplePitchP, int sampleMax);
 
-	void initialize(DescriptorSet *descriptorSet);
+	void initialize(DescriptorSet *descriptorSet, uint32_t variableDescriptorCount);
 
-	// Returns the total size of the descriptor set in bytes.
-	size_t getDescriptorSetAllocationSize() const;
+	// Returns the total size of the descriptor set in bytes. The variable
+	// descriptor count replaces the descriptor count of the binding with
+	// VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT, if there is one.
+	size_t getDescriptorSetAllocationSize(uint32_t variableDescriptorCount) const;
+
+	// Returns true if the last binding has a variable descriptor count.
+	bool hasVariableDescriptorCount() const;
 
 	// Returns the byte offset from the base address of the descriptor set for
 	// the given binding number.
@@ -119,6 +124,11 @@ public:
 	// Returns the number of descriptors for the given binding number.
 	uint32_t getDescriptorCount(uint32_t bindingNumber) const;
 
+	// Returns the number of descriptors for the given binding number in a
+	// descriptor set allocated with this layout. This is lower than the layout's
+	// count for a binding with a variable descriptor count.
+	uint32_t getDescriptorCount(const DescriptorSet *descriptorSet, uint32_t bindingNumber) const;
+
 	// Returns the number of descriptors across all bindings that are dynamic.
 	uint32_t getDynamicDescriptorCount() const;
 
@@ -137,7 +147,7 @@ public:
 
 private:
 	uint8_t *getDescriptorPointer(DescriptorSet *descriptorSet, uint32_t bindingNumber, uint32_t arrayElement, uint32_t count, size_t *typeSize) const;
-	size_t getDescriptorSetDataSize() const;
+	size_t getDescriptorSetDataSize(uint32_t variableDescriptorCount) const;
 	static bool isDynamic(VkDescriptorType type);
 
 	const VkDescriptorSetLayoutCreateFlags flags;
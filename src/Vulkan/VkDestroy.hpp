@@ -66,6 +66,21 @@ inline void destroy(VkT vkObject, const VkAllocationCallbacks *pAllocator)
 	}
 }
 
+// Destroys an object which was created from an ObjectPool, and returns its
+// memory to the pool.
+template<typename VkT>
+inline void destroy(VkT vkObject, const VkAllocationCallbacks *pAllocator, ObjectPool &pool)
+{
+	auto object = Cast(vkObject);
+	if(object)
+	{
+		using T = typename std::remove_pointer<decltype(object)>::type;
+		object->destroy(pAllocator);
+		object->~T();
+		pool.free(vkObject, pAllocator);
+	}
+}
+
 template<typename VkT>
 inline void release(VkT vkObject, const VkAllocationCallbacks *pAllocator)
 {
@@ -14,17 +14,22 @@
 
 #include "VkDevice.hpp"
 
+#include "VkBufferView.hpp"
 #include "VkConfig.hpp"
 #include "VkDescriptorSetLayout.hpp"
+#include "VkEvent.hpp"
 #include "VkFence.hpp"
+#include "VkFramebuffer.hpp"
 #include "VkQueue.hpp"
 #include "VkSemaphore.hpp"
 #include "VkTimelineSemaphore.hpp"
 #include "Debug/Context.hpp"
 #include "Debug/Server.hpp"
 #include "Device/Blitter.hpp"
+#include "Device/Renderer.hpp"
 #include "System/Debug.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <climits>
 #include <new>  // Must #include this to use "placement new"
@@ -153,9 +158,21 @@ Device::Device(const VkDeviceCreateInfo *pCreateInfo, void *mem, PhysicalDevice
 
 	// FIXME (b/119409619): use an allocator here so we can control all memory allocations
 	blitter.reset(new sw::Blitter());
+	drawRoutineCaches.reset(new sw::DrawRoutineCaches(1024));
 	samplingRoutineCache.reset(new SamplingRoutineCache());
 	samplerIndexer.reset(new SamplerIndexer());
 
+	auto createObjectPool = [this](ObjectPool::Type type, size_t blockSize) {
+		objectPools[static_cast<size_t>(type)].reset(new ObjectPool(type, blockSize));
+	};
+	createObjectPool(ObjectPool::Type::Event, sizeof(Event));
+	createObjectPool(ObjectPool::Type::Fence, sizeof(Fence));
+	createObjectPool(ObjectPool::Type::Semaphore, std::max(sizeof(BinarySemaphore), sizeof(TimelineSemaphore)));
+	createObjectPool(ObjectPool::Type::Framebuffer, sizeof(Framebuffer));
+	createObjectPool(ObjectPool::Type::ImageView, sizeof(ImageView));
+	createObjectPool(ObjectPool::Type::BufferView, sizeof(BufferView));
+	createObjectPool(ObjectPool::Type::Sampler, sizeof(Sampler));
+
 #ifdef ENABLE_VK_DEBUGGER
 	static auto port = getenv("VK_DEBUGGER_PORT");
 	if(port)
@@ -362,6 +379,32 @@ void Device::getDescriptorSetLayoutSupport(const VkDescriptorSetLayoutCreateInfo
 
 	// We have no "strange" limitations to enforce beyond the device limits, so we can safely always claim support.
 	pSupport->supported = VK_TRUE;
+
+	for(auto *nextInfo = reinterpret_cast<VkBaseOutStructure *>(pSupport->pNext); nextInfo != nullptr; nextInfo = nextInfo->pNext)
+	{
+		if(nextInfo->sType == VK_STRUCTURE_TYPE_DESCRIPTOR_SET_VARIABLE_DESCRIPTOR_COUNT_LAYOUT_SUPPORT)
+		{
+			// "If the VkDescriptorSetLayoutCreateInfo structure does not include a variable-sized
+			//  descriptor, then maxVariableDescriptorCount is set to zero."
+			auto *variableDescriptorCountSupport = reinterpret_cast<VkDescriptorSetVariableDescriptorCountLayoutSupport *>(nextInfo);
+			variableDescriptorCountSupport->maxVariableDescriptorCount = 0;
+
+			for(const auto *createInfo = reinterpret_cast<const VkBaseInStructure *>(pCreateInfo->pNext); createInfo != nullptr; createInfo = createInfo->pNext)
+			{
+				if(createInfo->sType == VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO)
+				{
+					const auto *bindingFlagsInfo = reinterpret_cast<const VkDescriptorSetLayoutBindingFlagsCreateInfo *>(createInfo);
+					for(uint32_t i = 0; i < bindingFlagsInfo->bindingCount; i++)
+					{
+						if(bindingFlagsInfo->pBindingFlags[i] & VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT)
+						{
+							variableDescriptorCountSupport->maxVariableDescriptorCount = MAX_UPDATE_AFTER_BIND_DESCRIPTORS;
+						}
+					}
+				}
+			}
+		}
+	}
 }
 
 void Device::updateDescriptorSets(uint32_t descriptorWriteCount, const VkWriteDescriptorSet *pDescriptorWrites,
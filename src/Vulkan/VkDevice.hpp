@@ -16,14 +16,17 @@
 #define VK_DEVICE_HPP_
 
 #include "VkImageView.hpp"
+#include "VkObjectPool.hpp"
 #include "VkSampler.hpp"
 #include "Pipeline/Constants.hpp"
 #include "Reactor/Routine.hpp"
 #include "System/LRUCache.hpp"
+#include "System/Metrics.hpp"
 
 #include "marl/mutex.h"
 #include "marl/tsa.h"
 
+#include <array>
 #include <map>
 #include <memory>
 #include <unordered_map>
@@ -34,6 +37,7 @@ class Scheduler;
 }
 namespace sw {
 class Blitter;
+struct DrawRoutineCaches;
 }
 
 namespace vk {
@@ -69,6 +73,7 @@ public:
 	void getRequirements(VkMemoryDedicatedRequirements *requirements) const;
 	const VkPhysicalDeviceFeatures &getEnabledFeatures() const { return enabledFeatures; }
 	sw::Blitter *getBlitter() const { return blitter.get(); }
+	sw::DrawRoutineCaches *getDrawRoutineCaches() const { return drawRoutineCaches.get(); }
 
 	void registerImageView(ImageView *imageView);
 	void unregisterImageView(ImageView *imageView);
@@ -107,16 +112,25 @@ public:
 		std::shared_ptr<rr::Routine> getOrCreate(const Key &key, Function &&createRoutine)
 		{
 			auto it = snapshot.find(key);
-			if(it != snapshot.end()) { return it->second; }
+			if(it != snapshot.end())
+			{
+				sw::Metrics::count(sw::Metrics::SamplingRoutineCache, sw::Metrics::CacheHit);
+				return it->second;
+			}
 
 			marl::lock lock(mutex);
 			if(auto existingRoutine = cache.lookup(key))
 			{
+				sw::Metrics::count(sw::Metrics::SamplingRoutineCache, sw::Metrics::CacheHit);
 				return existingRoutine;
 			}
 
+			sw::Metrics::count(sw::Metrics::SamplingRoutineCache, sw::Metrics::CacheMiss);
 			std::shared_ptr<rr::Routine> newRoutine = createRoutine(key);
-			cache.add(key, newRoutine);
+			if(cache.add(key, newRoutine))
+			{
+				sw::Metrics::count(sw::Metrics::SamplingRoutineCache, sw::Metrics::CacheEviction);
+			}
 			snapshotNeedsUpdate = true;
 
 			return newRoutine;
@@ -161,6 +175,9 @@ public:
 	void removeSampler(const SamplerState &samplerState);
 	const SamplerState *findSampler(uint32_t samplerId) const;
 
+	// Returns the pool recycling the memory of the given object type.
+	ObjectPool &getObjectPool(ObjectPool::Type type) { return *objectPools[static_cast<size_t>(type)]; }
+
 	std::shared_ptr<vk::dbg::Context> getDebuggerContext() const
 	{
 #ifdef ENABLE_VK_DEBUGGER
@@ -184,6 +201,7 @@ private:
 	Queue *const queues = nullptr;
 	uint32_t queueCount = 0;
 	std::unique_ptr<sw::Blitter> blitter;
+	std::unique_ptr<sw::DrawRoutineCaches> drawRoutineCaches;
 	uint32_t enabledExtensionCount = 0;
 	typedef char ExtensionName[VK_MAX_EXTENSION_NAME_SIZE];
 	ExtensionName *extensions = nullptr;
@@ -196,6 +214,8 @@ private:
 	marl::mutex imageViewSetMutex;
 	std::unordered_set<ImageView *> imageViewSet GUARDED_BY(imageViewSetMutex);
 
+	std::array<std::unique_ptr<ObjectPool>, static_cast<size_t>(ObjectPool::Type::Count)> objectPools;
+
 #ifdef ENABLE_VK_DEBUGGER
 	struct
 	{
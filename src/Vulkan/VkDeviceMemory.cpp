@@ -21,6 +21,9 @@
 #include "VkImage.hpp"
 #include "VkMemory.hpp"
 #include "VkStringify.hpp"
+#include "System/Memory.hpp"
+
+#include <algorithm>
 
 #if SWIFTSHADER_EXTERNAL_MEMORY_OPAQUE_FD
 
@@ -285,9 +288,34 @@ VkResult DeviceMemory::map(VkDeviceSize pOffset, VkDeviceSize pSize, void **ppDa
 
 VkDeviceSize DeviceMemory::getCommittedMemoryInBytes() const
 {
+	if(isLazilyAllocated() && buffer)
+	{
+		return std::min(static_cast<VkDeviceSize>(sw::residentPageBytes(buffer, allocationSize)), allocationSize);
+	}
+
 	return allocationSize;
 }
 
+void DeviceMemory::discard(VkDeviceSize offset, VkDeviceSize size)
+{
+	if(!isLazilyAllocated() || !buffer)
+	{
+		return;
+	}
+
+	// Pages partially outside of the range may hold other resources' contents,
+	// except for the padding at the end of the allocation.
+	uintptr_t pageMask = sw::memoryPageSize() - 1;
+	uintptr_t begin = (reinterpret_cast<uintptr_t>(buffer) + offset + pageMask) & ~pageMask;
+	uintptr_t end = reinterpret_cast<uintptr_t>(buffer) + std::min(offset + size, allocationSize);
+	end = (offset + size >= allocationSize) ? ((end + pageMask) & ~pageMask) : (end & ~pageMask);
+
+	if(end > begin)
+	{
+		sw::discardPages(reinterpret_cast<void *>(begin), end - begin);
+	}
+}
+
 void *DeviceMemory::getOffsetPointer(VkDeviceSize pOffset) const
 {
 	ASSERT(buffer);
@@ -320,7 +348,8 @@ bool DeviceMemory::checkExternalMemoryHandleType(
 // and sets `buffer`.
 VkResult DeviceMemory::allocateBuffer()
 {
-	buffer = vk::allocateDeviceMemory(allocationSize, REQUIRED_MEMORY_ALIGNMENT);
+	buffer = isLazilyAllocated() ? vk::allocateLazyDeviceMemory(allocationSize)
+	                             : vk::allocateDeviceMemory(allocationSize, REQUIRED_MEMORY_ALIGNMENT);
 	if(!buffer)
 	{
 		return VK_ERROR_OUT_OF_DEVICE_MEMORY;
@@ -332,7 +361,14 @@ VkResult DeviceMemory::allocateBuffer()
 // Free previously allocated memory at `buffer`.
 void DeviceMemory::freeBuffer()
 {
-	vk::freeDeviceMemory(buffer);
+	if(isLazilyAllocated())
+	{
+		vk::freeLazyDeviceMemory(buffer, allocationSize);
+	}
+	else
+	{
+		vk::freeDeviceMemory(buffer, allocationSize);
+	}
 	buffer = nullptr;
 }
 
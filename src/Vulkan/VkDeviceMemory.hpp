@@ -80,8 +80,14 @@ public:
 	VkResult allocate();
 	VkResult map(VkDeviceSize offset, VkDeviceSize size, void **ppData);
 	VkDeviceSize getCommittedMemoryInBytes() const;
+	VkDeviceSize getAllocationSize() const { return allocationSize; }
 	void *getOffsetPointer(VkDeviceSize pOffset) const;
 	uint32_t getMemoryTypeIndex() const { return memoryTypeIndex; }
+	bool isLazilyAllocated() const { return ((1u << memoryTypeIndex) & MEMORY_TYPE_LAZILY_ALLOCATED_BIT) != 0; }
+
+	// Returns the physical pages which lie entirely within the range to the
+	// system. Only has an effect on lazily allocated memory.
+	void discard(VkDeviceSize offset, VkDeviceSize size);
 
 	// If this is external memory, return true iff its handle type matches the bitmask
 	// provided by |supportedExternalHandleTypes|. Otherwise, always return true.
@@ -425,8 +425,7 @@ VkResult AHardwareBufferExternalMemory::GetAndroidHardwareBufferProperties(VkDev
 		}
 	}
 
-	const VkPhysicalDeviceMemoryProperties phyDeviceMemProps = vk::PhysicalDevice::GetMemoryProperties();
-	pProperties->memoryTypeBits = phyDeviceMemProps.memoryTypes[0].propertyFlags;
+	pProperties->memoryTypeBits = vk::MEMORY_TYPE_GENERIC_BIT;
 
 	if(ahbDesc.format == AHARDWAREBUFFER_FORMAT_BLOB)
 	{
@@ -134,6 +134,37 @@ void Framebuffer::executeLoadOp(const RenderPass *renderPass, uint32_t clearValu
 	}
 }
 
+void Framebuffer::executeStoreOp(const RenderPass *renderPass)
+{
+	// This gets called at the end of a renderpass, once all rendering and resolves have completed.
+	// Attachments whose contents aren't stored can have the memory backing them released, which
+	// keeps transient attachments from occupying physical memory between render passes.
+
+	ASSERT(attachmentCount == renderPass->getAttachmentCount());
+
+	for(uint32_t i = 0; i < attachmentCount; i++)
+	{
+		const VkAttachmentDescription attachment = renderPass->getAttachment(i);
+		VkImageAspectFlags aspects = Format(attachment.format).getAspects();
+		bool discard = true;
+
+		if(aspects & (VK_IMAGE_ASPECT_COLOR_BIT | VK_IMAGE_ASPECT_DEPTH_BIT))
+		{
+			discard = discard && (attachment.storeOp == VK_ATTACHMENT_STORE_OP_DONT_CARE);
+		}
+
+		if(aspects & VK_IMAGE_ASPECT_STENCIL_BIT)
+		{
+			discard = discard && (attachment.stencilStoreOp == VK_ATTACHMENT_STORE_OP_DONT_CARE);
+		}
+
+		if(discard && renderPass->isAttachmentUsed(i))
+		{
+			attachments[i]->discard();
+		}
+	}
+}
+
 void Framebuffer::clearAttachment(const RenderPass *renderPass, uint32_t subpassIndex, const VkClearAttachment &attachment, const VkClearRect &rect)
 {
 	VkSubpassDescription subpass = renderPass->getSubpass(subpassIndex);
@@ -231,6 +262,28 @@ void Framebuffer::resolve(const RenderPass *renderPass, uint32_t subpassIndex)
 	}
 }
 
+// Resolves the color attachments of the subpass within an area only, such as
+// a band of a tiled render pass. Multiview and depth/stencil resolves are not
+// supported.
+void Framebuffer::resolve(const RenderPass *renderPass, uint32_t subpassIndex, const VkRect2D &area)
+{
+	ASSERT(!renderPass->isMultiView() && !renderPass->hasDepthStencilResolve());
+
+	auto const &subpass = renderPass->getSubpass(subpassIndex);
+	if(subpass.pResolveAttachments)
+	{
+		for(uint32_t i = 0; i < subpass.colorAttachmentCount; i++)
+		{
+			uint32_t resolveAttachment = subpass.pResolveAttachments[i].attachment;
+			if(resolveAttachment != VK_ATTACHMENT_UNUSED)
+			{
+				ImageView *imageView = attachments[subpass.pColorAttachments[i].attachment];
+				imageView->resolve(attachments[resolveAttachment], area);
+			}
+		}
+	}
+}
+
 size_t Framebuffer::ComputeRequiredAllocationSize(const VkFramebufferCreateInfo *pCreateInfo)
 {
 	const VkBaseInStructure *curInfo = reinterpret_cast<const VkBaseInStructure *>(pCreateInfo->pNext);
@@ -29,12 +29,14 @@ public:
 	void destroy(const VkAllocationCallbacks *pAllocator);
 
 	void executeLoadOp(const RenderPass *renderPass, uint32_t clearValueCount, const VkClearValue *pClearValues, const VkRect2D &renderArea);
+	void executeStoreOp(const RenderPass *renderPass);
 	void clearAttachment(const RenderPass *renderPass, uint32_t subpassIndex, const VkClearAttachment &attachment, const VkClearRect &rect);
 
 	static size_t ComputeRequiredAllocationSize(const VkFramebufferCreateInfo *pCreateInfo);
 	void setAttachment(ImageView *imageView, uint32_t index);
 	ImageView *getAttachment(uint32_t index) const;
 	void resolve(const RenderPass *renderPass, uint32_t subpassIndex);
+	void resolve(const RenderPass *renderPass, uint32_t subpassIndex, const VkRect2D &area);
 
 	const VkExtent3D &getExtent() const { return extent; }
 
@@ -24,6 +24,7 @@
 #include "Device/BC_Decoder.hpp"
 #include "Device/Blitter.hpp"
 #include "Device/ETC_Decoder.hpp"
+#include "Device/Transfer.hpp"
 
 #ifdef __ANDROID__
 #	include "System/GrallocAndroid.hpp"
@@ -221,6 +222,10 @@ const VkMemoryRequirements Image::getMemoryRequirements() const
 	VkMemoryRequirements memoryRequirements;
 	memoryRequirements.alignment = vk::REQUIRED_MEMORY_ALIGNMENT;
 	memoryRequirements.memoryTypeBits = vk::MEMORY_TYPE_GENERIC_BIT;
+	if(usage & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT)
+	{
+		memoryRequirements.memoryTypeBits |= vk::MEMORY_TYPE_LAZILY_ALLOCATED_BIT;
+	}
 	memoryRequirements.size = getStorageSize(format.getAspects()) +
 	                          (decompressedImage ? decompressedImage->getStorageSize(decompressedImage->format.getAspects()) : 0);
 	return memoryRequirements;
@@ -410,8 +415,6 @@ void Image::copySingleAspectTo(Image *dstImage, const VkImageCopy2KHR &region) c
 	ASSERT(bytesPerBlock == dstFormat.bytesPerBlock());
 	ASSERT(samples == dstImage->samples);
 
-	VkExtent3D srcExtent = getMipLevelExtent(srcAspect, region.srcSubresource.mipLevel);
-	VkExtent3D dstExtent = dstImage->getMipLevelExtent(dstAspect, region.dstSubresource.mipLevel);
 	VkExtent3D copyExtent = imageExtentInBlocks(region.extent, srcAspect);
 
 	VkImageType srcImageType = imageType;
@@ -444,99 +447,27 @@ void Image::copySingleAspectTo(Image *dstImage, const VkImageCopy2KHR &region) c
 	// TODO(b/160600347): Store samples consecutively.
 	uint32_t sliceCount = both3D ? copyExtent.depth : samples;
 
-	bool isSingleSlice = (sliceCount == 1);
-	bool isSingleRow = (copyExtent.height == 1) && isSingleSlice;
-	// In order to copy multiple rows using a single memcpy call, we
-	// have to make sure that we need to copy the entire row and that
-	// both source and destination rows have the same size in bytes
-	bool isEntireRow = (region.extent.width == srcExtent.width) &&
-	                   (region.extent.width == dstExtent.width) &&
-	                   // For non-compressed formats, blockWidth is 1. For compressed
-	                   // formats, rowPitchBytes returns the number of bytes for a row of
-	                   // blocks, so we have to divide by the block height, which means:
-	                   // srcRowPitchBytes / srcBlockWidth == dstRowPitchBytes / dstBlockWidth
-	                   // And, to avoid potential non exact integer division, for example if a
-	                   // block has 16 bytes and represents 5 rows, we change the equation to:
-	                   // srcRowPitchBytes * dstBlockWidth == dstRowPitchBytes * srcBlockWidth
-	                   ((srcRowPitch * dstFormat.blockWidth()) ==
-	                    (dstRowPitch * srcFormat.blockWidth()));
-	// In order to copy multiple slices using a single memcpy call, we
-	// have to make sure that we need to copy the entire slice and that
-	// both source and destination slices have the same size in bytes
-	bool isEntireSlice = isEntireRow &&
-	                     (copyExtent.height == srcExtent.height) &&
-	                     (copyExtent.height == dstExtent.height) &&
-	                     (srcDepthPitch == dstDepthPitch);
+	// Rows and slices which are contiguous in both images get merged into larger copies by sw::transferCopy().
+	sw::StridedCopy copy;
+	copy.rowBytes = copyExtent.width * bytesPerBlock;
+	copy.rowCount = copyExtent.height;
+	copy.sliceCount = sliceCount;
+	copy.srcRowPitch = srcRowPitch;
+	copy.dstRowPitch = dstRowPitch;
+	copy.srcSlicePitch = srcDepthPitch;
+	copy.dstSlicePitch = dstDepthPitch;
 
 	const uint8_t *srcLayer = static_cast<const uint8_t *>(getTexelPointer(region.srcOffset, ImageSubresource(region.srcSubresource)));
 	uint8_t *dstLayer = static_cast<uint8_t *>(dstImage->getTexelPointer(region.dstOffset, ImageSubresource(region.dstSubresource)));
 
 	for(uint32_t layer = 0; layer < layerCount; layer++)
 	{
-		if(isSingleRow)  // Copy one row
-		{
-			size_t copySize = copyExtent.width * bytesPerBlock;
-			ASSERT((srcLayer + copySize) < end());
-			ASSERT((dstLayer + copySize) < dstImage->end());
-			memcpy(dstLayer, srcLayer, copySize);
-		}
-		else if(isEntireRow && isSingleSlice)  // Copy one slice
-		{
-			size_t copySize = copyExtent.height * srcRowPitch;
-			ASSERT((srcLayer + copySize) < end());
-			ASSERT((dstLayer + copySize) < dstImage->end());
-			memcpy(dstLayer, srcLayer, copySize);
-		}
-		else if(isEntireSlice)  // Copy multiple slices
-		{
-			size_t copySize = sliceCount * srcDepthPitch;
-			ASSERT((srcLayer + copySize) < end());
-			ASSERT((dstLayer + copySize) < dstImage->end());
-			memcpy(dstLayer, srcLayer, copySize);
-		}
-		else if(isEntireRow)  // Copy slice by slice
-		{
-			size_t sliceSize = copyExtent.height * srcRowPitch;
-			const uint8_t *srcSlice = srcLayer;
-			uint8_t *dstSlice = dstLayer;
-
-			for(uint32_t z = 0; z < sliceCount; z++)
-			{
-				ASSERT((srcSlice + sliceSize) < end());
-				ASSERT((dstSlice + sliceSize) < dstImage->end());
+		copy.src = srcLayer;
+		copy.dst = dstLayer;
 
-				memcpy(dstSlice, srcSlice, sliceSize);
-
-				dstSlice += dstDepthPitch;
-				srcSlice += srcDepthPitch;
-			}
-		}
-		else  // Copy row by row
-		{
-			size_t rowSize = copyExtent.width * bytesPerBlock;
-			const uint8_t *srcSlice = srcLayer;
-			uint8_t *dstSlice = dstLayer;
-
-			for(uint32_t z = 0; z < sliceCount; z++)
-			{
-				const uint8_t *srcRow = srcSlice;
-				uint8_t *dstRow = dstSlice;
-
-				for(uint32_t y = 0; y < copyExtent.height; y++)
-				{
-					ASSERT((srcRow + rowSize) < end());
-					ASSERT((dstRow + rowSize) < dstImage->end());
-
-					memcpy(dstRow, srcRow, rowSize);
-
-					srcRow += srcRowPitch;
-					dstRow += dstRowPitch;
-				}
-
-				srcSlice += srcDepthPitch;
-				dstSlice += dstDepthPitch;
-			}
-		}
+		ASSERT((srcLayer + (sliceCount - 1) * srcDepthPitch + (copyExtent.height - 1) * srcRowPitch + copy.rowBytes) < end());
+		ASSERT((dstLayer + (sliceCount - 1) * dstDepthPitch + (copyExtent.height - 1) * dstRowPitch + copy.rowBytes) < dstImage->end());
+		sw::transferCopy(copy);
 
 		srcLayer += srcLayerPitch;
 		dstLayer += dstLayerPitch;
@@ -589,35 +520,19 @@ void Image::copy(Buffer *buffer, const VkBufferImageCopy2KHR &region, bool buffe
 	int srcRowPitchBytes = bufferIsSource ? bufferRowPitchBytes : imageRowPitchBytes;
 	int dstRowPitchBytes = bufferIsSource ? imageRowPitchBytes : bufferRowPitchBytes;
 
-	VkExtent3D mipLevelExtent = getMipLevelExtent(aspect, region.imageSubresource.mipLevel);
-	bool isSingleSlice = (imageExtent.depth == 1);
-	bool isSingleRow = (imageExtent.height == 1) && isSingleSlice;
-	bool isEntireRow = (imageExtent.width == mipLevelExtent.width) &&
-	                   (imageRowPitchBytes == bufferRowPitchBytes);
-	bool isEntireSlice = isEntireRow && (imageExtent.height == mipLevelExtent.height) &&
-	                     (imageSlicePitchBytes == bufferSlicePitchBytes);
+	// Rows and slices which are contiguous in both the buffer and the image get merged into larger copies by sw::transferCopy().
+	sw::StridedCopy copy;
+	copy.rowBytes = imageExtent.width * bytesPerBlock;
+	copy.rowCount = imageExtent.height;
+	copy.sliceCount = imageExtent.depth;
+	copy.srcRowPitch = srcRowPitchBytes;
+	copy.dstRowPitch = dstRowPitchBytes;
+	copy.srcSlicePitch = srcSlicePitchBytes;
+	copy.dstSlicePitch = dstSlicePitchBytes;
 
-	VkDeviceSize copySize = 0;
-	if(isSingleRow)
-	{
-		copySize = imageExtent.width * bytesPerBlock;
-	}
-	else if(isEntireRow && isSingleSlice)
-	{
-		copySize = (imageExtent.height - 1) * imageRowPitchBytes + imageExtent.width * bytesPerBlock;
-	}
-	else if(isEntireSlice)
-	{
-		copySize = (imageExtent.depth - 1) * imageSlicePitchBytes + (imageExtent.height - 1) * imageRowPitchBytes + imageExtent.width * bytesPerBlock;  // Copy multiple slices
-	}
-	else if(isEntireRow)  // Copy slice by slice
-	{
-		copySize = (imageExtent.height - 1) * imageRowPitchBytes + imageExtent.width * bytesPerBlock;
-	}
-	else  // Copy row by row
-	{
-		copySize = imageExtent.width * bytesPerBlock;
-	}
+	// Offset of the end of the last row, relative to the start of the layer.
+	VkDeviceSize imageCopySize = (imageExtent.depth - 1) * imageSlicePitchBytes + (imageExtent.height - 1) * imageRowPitchBytes + copy.rowBytes;
+	VkDeviceSize bufferCopySize = (imageExtent.depth - 1) * bufferSlicePitchBytes + (imageExtent.height - 1) * bufferRowPitchBytes + copy.rowBytes;
 
 	VkDeviceSize imageLayerSize = getLayerSize(aspect);
 	VkDeviceSize srcLayerSize = bufferIsSource ? bufferSlicePitchBytes : imageLayerSize;
@@ -625,45 +540,12 @@ void Image::copy(Buffer *buffer, const VkBufferImageCopy2KHR &region, bool buffe
 
 	for(uint32_t i = 0; i < region.imageSubresource.layerCount; i++)
 	{
-		if(isSingleRow || (isEntireRow && isSingleSlice) || isEntireSlice)
-		{
-			ASSERT(((bufferIsSource ? dstMemory : srcMemory) + copySize) < end());
-			ASSERT(((bufferIsSource ? srcMemory : dstMemory) + copySize) < buffer->end());
-			memcpy(dstMemory, srcMemory, copySize);
-		}
-		else if(isEntireRow)  // Copy slice by slice
-		{
-			uint8_t *srcSliceMemory = srcMemory;
-			uint8_t *dstSliceMemory = dstMemory;
-			for(uint32_t z = 0; z < imageExtent.depth; z++)
-			{
-				ASSERT(((bufferIsSource ? dstSliceMemory : srcSliceMemory) + copySize) < end());
-				ASSERT(((bufferIsSource ? srcSliceMemory : dstSliceMemory) + copySize) < buffer->end());
-				memcpy(dstSliceMemory, srcSliceMemory, copySize);
-				srcSliceMemory += srcSlicePitchBytes;
-				dstSliceMemory += dstSlicePitchBytes;
-			}
-		}
-		else  // Copy row by row
-		{
-			uint8_t *srcLayerMemory = srcMemory;
-			uint8_t *dstLayerMemory = dstMemory;
-			for(uint32_t z = 0; z < imageExtent.depth; z++)
-			{
-				uint8_t *srcSliceMemory = srcLayerMemory;
-				uint8_t *dstSliceMemory = dstLayerMemory;
-				for(uint32_t y = 0; y < imageExtent.height; y++)
-				{
-					ASSERT(((bufferIsSource ? dstSliceMemory : srcSliceMemory) + copySize) < end());
-					ASSERT(((bufferIsSource ? srcSliceMemory : dstSliceMemory) + copySize) < buffer->end());
-					memcpy(dstSliceMemory, srcSliceMemory, copySize);
-					srcSliceMemory += srcRowPitchBytes;
-					dstSliceMemory += dstRowPitchBytes;
-				}
-				srcLayerMemory += srcSlicePitchBytes;
-				dstLayerMemory += dstSlicePitchBytes;
-			}
-		}
+		copy.src = srcMemory;
+		copy.dst = dstMemory;
+
+		ASSERT(((bufferIsSource ? dstMemory : srcMemory) + imageCopySize) < end());
+		ASSERT(((bufferIsSource ? srcMemory : dstMemory) + bufferCopySize) < buffer->end());
+		sw::transferCopy(copy);
 
 		srcMemory += srcLayerSize;
 		dstMemory += dstLayerSize;
@@ -870,9 +752,17 @@ bool Image::isCubeCompatible() const
 	return cubeCompatible;
 }
 
+void Image::discard()
+{
+	if(deviceMemory && deviceMemory->isLazilyAllocated())
+	{
+		deviceMemory->discard(memoryOffset, getMemoryRequirements().size);
+	}
+}
+
 uint8_t *Image::end() const
 {
-	return reinterpret_cast<uint8_t *>(deviceMemory->getOffsetPointer(deviceMemory->getCommittedMemoryInBytes() + 1));
+	return reinterpret_cast<uint8_t *>(deviceMemory->getOffsetPointer(deviceMemory->getAllocationSize() + 1));
 }
 
 VkDeviceSize Image::getMemoryOffset(VkImageAspectFlagBits aspect) const
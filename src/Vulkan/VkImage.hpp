@@ -70,6 +70,8 @@ public:
 	void clear(const VkClearValue &clearValue, const vk::Format &viewFormat, const VkRect2D &renderArea, const VkImageSubresourceRange &subresourceRange);
 	void clear(const VkClearColorValue &color, const VkImageSubresourceRange &subresourceRange);
 	void clear(const VkClearDepthStencilValue &color, const VkImageSubresourceRange &subresourceRange);
+	// Releases the pages backing a lazily allocated image. Its contents become undefined.
+	void discard();
 
 	// Get the last layer and mipmap level, handling VK_REMAINING_ARRAY_LAYERS and
 	// VK_REMAINING_MIP_LEVELS, respectively. Note VkImageSubresourceLayers does not
@@ -97,6 +99,10 @@ public:
 	VkDeviceSize getMipLevelSize(VkImageAspectFlagBits aspect, uint32_t mipLevel) const;
 	bool canBindToMemory(DeviceMemory *pDeviceMemory) const;
 
+	// Returns true if prepareForSampling() and contentsChanged() have work to do
+	// for this image, i.e. it is a cube map or has a compressed format which is
+	// decompressed for sampling.
+	bool requiresPreprocessing() const;
 	void prepareForSampling(const VkImageSubresourceRange &subresourceRange) const;
 	enum ContentsChangedContext
 	{
@@ -134,7 +140,6 @@ private:
 	void clear(const void *pixelData, VkFormat pixelFormat, const vk::Format &viewFormat, const VkImageSubresourceRange &subresourceRange, const VkRect2D *renderArea);
 	int borderSize() const;
 
-	bool requiresPreprocessing() const;
 	void decompress(const VkImageSubresource &subresource) const;
 	void decodeETC2(const VkImageSubresource &subresource) const;
 	void decodeBC(const VkImageSubresource &subresource) const;
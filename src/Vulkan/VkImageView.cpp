@@ -35,6 +35,50 @@ Format GetImageViewFormat(const VkImageViewCreateInfo *pCreateInfo)
 	return vk::Cast(pCreateInfo->image)->getFormat();
 }
 
+bool IsSampleable(VkImageAspectFlags aspectMask)
+{
+	return (aspectMask & (aspectMask - 1)) == 0;
+}
+
+void WriteTextureLevelInfo(sw::Texture *texture, int level, int width, int height, int depth, int pitchP, int sliceP, int samplePitchP, int sampleMax)
+{
+	if(level == 0)
+	{
+		texture->widthWidthHeightHeight[0] = static_cast<float>(width);
+		texture->widthWidthHeightHeight[1] = static_cast<float>(width);
+		texture->widthWidthHeightHeight[2] = static_cast<float>(height);
+		texture->widthWidthHeightHeight[3] = static_cast<float>(height);
+
+		texture->width = sw::float4(static_cast<float>(width));
+		texture->height = sw::float4(static_cast<float>(height));
+		texture->depth = sw::float4(static_cast<float>(depth));
+	}
+
+	sw::Mipmap &mipmap = texture->mipmap[level];
+
+	short halfTexelU = 0x8000 / width;
+	short halfTexelV = 0x8000 / height;
+	short halfTexelW = 0x8000 / depth;
+
+	mipmap.uHalf = sw::short4(halfTexelU);
+	mipmap.vHalf = sw::short4(halfTexelV);
+	mipmap.wHalf = sw::short4(halfTexelW);
+
+	mipmap.width = sw::int4(width);
+	mipmap.height = sw::int4(height);
+	mipmap.depth = sw::int4(depth);
+
+	mipmap.onePitchP[0] = 1;
+	mipmap.onePitchP[1] = static_cast<short>(pitchP);
+	mipmap.onePitchP[2] = 1;
+	mipmap.onePitchP[3] = static_cast<short>(pitchP);
+
+	mipmap.pitchP = sw::int4(pitchP);
+	mipmap.sliceP = sw::int4(sliceP);
+	mipmap.samplePitchP = sw::int4(samplePitchP);
+	mipmap.sampleMax = sw::int4(sampleMax);
+}
+
 }  // anonymous namespace
 
 VkComponentMapping ResolveIdentityMapping(VkComponentMapping mapping)
@@ -128,15 +172,100 @@ ImageView::ImageView(const VkImageViewCreateInfo *pCreateInfo, void *mem, const
     , ycbcrConversion(ycbcrConversion)
     , id(pCreateInfo)
 {
+	if(mem)
+	{
+		sampledTexture = new(mem) sw::Texture();
+		writeSampledTexture();
+	}
 }
 
 size_t ImageView::ComputeRequiredAllocationSize(const VkImageViewCreateInfo *pCreateInfo)
 {
-	return 0;
+	// Only views of a single aspect can be sampled. Multi-planar formats are
+	// sampled through the color aspect.
+	return IsSampleable(pCreateInfo->subresourceRange.aspectMask) ? sizeof(sw::Texture) : 0;
 }
 
 void ImageView::destroy(const VkAllocationCallbacks *pAllocator)
 {
+	vk::freeHostMemory(sampledTexture, pAllocator);
+}
+
+void ImageView::writeSampledTexture()
+{
+	Format format = getFormat(ImageView::SAMPLING);
+	sw::Texture *texture = sampledTexture;
+
+	if(format.isYcbcrFormat())
+	{
+		ASSERT(subresourceRange.levelCount == 1);
+
+		// YCbCr images can only have one level, so we can store parameters for the
+		// different planes in the descriptor's mipmap levels instead.
+
+		const int level = 0;
+		VkOffset3D offset = { 0, 0, 0 };
+		texture->mipmap[0].buffer = getOffsetPointer(offset, VK_IMAGE_ASPECT_PLANE_0_BIT, level, 0, ImageView::SAMPLING);
+		texture->mipmap[1].buffer = getOffsetPointer(offset, VK_IMAGE_ASPECT_PLANE_1_BIT, level, 0, ImageView::SAMPLING);
+		if(format.getAspects() & VK_IMAGE_ASPECT_PLANE_2_BIT)
+		{
+			texture->mipmap[2].buffer = getOffsetPointer(offset, VK_IMAGE_ASPECT_PLANE_2_BIT, level, 0, ImageView::SAMPLING);
+		}
+
+		VkExtent2D extent = getMipLevelExtent(0);
+
+		int width = extent.width;
+		int height = extent.height;
+		int pitchP0 = rowPitchBytes(VK_IMAGE_ASPECT_PLANE_0_BIT, level, ImageView::SAMPLING) /
+		              getFormat(VK_IMAGE_ASPECT_PLANE_0_BIT).bytes();
+
+		// Write plane 0 parameters to mipmap level 0.
+		WriteTextureLevelInfo(texture, 0, width, height, 1, pitchP0, 0, 0, 0);
+
+		// Plane 2, if present, has equal parameters to plane 1, so we use mipmap level 1 for both.
+		int pitchP1 = rowPitchBytes(VK_IMAGE_ASPECT_PLANE_1_BIT, level, ImageView::SAMPLING) /
+		              getFormat(VK_IMAGE_ASPECT_PLANE_1_BIT).bytes();
+
+		WriteTextureLevelInfo(texture, 1, width / 2, height / 2, 1, pitchP1, 0, 0, 0);
+	}
+	else
+	{
+		for(int mipmapLevel = 0; mipmapLevel < sw::MIPMAP_LEVELS; mipmapLevel++)
+		{
+			int level = sw::clamp(mipmapLevel, 0, (int)subresourceRange.levelCount - 1);  // Level within the image view
+
+			VkImageAspectFlagBits aspect = static_cast<VkImageAspectFlagBits>(subresourceRange.aspectMask);
+			sw::Mipmap &mipmap = texture->mipmap[mipmapLevel];
+
+			if((viewType == VK_IMAGE_VIEW_TYPE_CUBE) ||
+			   (viewType == VK_IMAGE_VIEW_TYPE_CUBE_ARRAY))
+			{
+				// Obtain the pointer to the corner of the level including the border, for seamless sampling.
+				// This is taken into account in the sampling routine, which can't handle negative texel coordinates.
+				VkOffset3D offset = { -1, -1, 0 };
+				mipmap.buffer = getOffsetPointer(offset, aspect, level, 0, ImageView::SAMPLING);
+			}
+			else
+			{
+				VkOffset3D offset = { 0, 0, 0 };
+				mipmap.buffer = getOffsetPointer(offset, aspect, level, 0, ImageView::SAMPLING);
+			}
+
+			VkExtent2D extent = getMipLevelExtent(level);
+
+			int width = extent.width;
+			int height = extent.height;
+			int layerCount = subresourceRange.layerCount;
+			int depth = getDepthOrLayerCount(level);
+			int bytes = format.bytes();
+			int pitchP = rowPitchBytes(aspect, level, ImageView::SAMPLING) / bytes;
+			int sliceP = (layerCount > 1 ? layerPitchBytes(aspect, ImageView::SAMPLING) : slicePitchBytes(aspect, level, ImageView::SAMPLING)) / bytes;
+			int samplePitchP = getMipLevelSize(aspect, level, ImageView::SAMPLING) / bytes;
+			int sampleMax = getSampleCount() - 1;
+
+			WriteTextureLevelInfo(texture, mipmapLevel, width, height, depth, pitchP, sliceP, samplePitchP, sampleMax);
+		}
+	}
 }
 
 // Vulkan 1.2 Table 8. Image and image view parameter compatibility requirements
@@ -251,6 +380,14 @@ void ImageView::resolve(ImageView *resolveAttachment, int layer)
 }
 
 void ImageView::resolve(ImageView *resolveAttachment)
+{
+	VkExtent3D extent = image->getMipLevelExtent(static_cast<VkImageAspectFlagBits>(subresourceRange.aspectMask),
+	                                             subresourceRange.baseMipLevel);
+
+	resolve(resolveAttachment, { { 0, 0 }, { extent.width, extent.height } });
+}
+
+void ImageView::resolve(ImageView *resolveAttachment, const VkRect2D &area)
 {
 	if((subresourceRange.levelCount != 1) || (resolveAttachment->subresourceRange.levelCount != 1))
 	{
@@ -266,16 +403,15 @@ void ImageView::resolve(ImageView *resolveAttachment)
 		subresourceRange.baseArrayLayer,
 		subresourceRange.layerCount
 	};
-	region.srcOffset = { 0, 0, 0 };
+	region.srcOffset = { area.offset.x, area.offset.y, 0 };
 	region.dstSubresource = {
 		resolveAttachment->subresourceRange.aspectMask,
 		resolveAttachment->subresourceRange.baseMipLevel,
 		resolveAttachment->subresourceRange.baseArrayLayer,
 		resolveAttachment->subresourceRange.layerCount
 	};
-	region.dstOffset = { 0, 0, 0 };
-	region.extent = image->getMipLevelExtent(static_cast<VkImageAspectFlagBits>(subresourceRange.aspectMask),
-	                                         subresourceRange.baseMipLevel);
+	region.dstOffset = { area.offset.x, area.offset.y, 0 };
+	region.extent = { area.extent.width, area.extent.height, 1 };
 
 	image->resolveTo(resolveAttachment->image, region);
 }
@@ -301,6 +437,21 @@ void ImageView::resolveDepthStencil(ImageView *resolveAttachment, const VkSubpas
 	image->resolveDepthStencilTo(this, resolveAttachment, dsResolve);
 }
 
+void ImageView::discard()
+{
+	// Other views of a partially covered image may still have defined contents.
+	bool wholeImage = (subresourceRange.aspectMask == image->getFormat().getAspects()) &&
+	                  (subresourceRange.baseMipLevel == 0) &&
+	                  (subresourceRange.levelCount == image->getMipLevels()) &&
+	                  (subresourceRange.baseArrayLayer == 0) &&
+	                  (subresourceRange.layerCount == image->getArrayLayers());
+
+	if(wholeImage)
+	{
+		image->discard();
+	}
+}
+
 const Image *ImageView::getImage(Usage usage) const
 {
 	switch(usage)
@@ -19,6 +19,7 @@
 #include "VkImage.hpp"
 #include "VkObject.hpp"
 
+#include "Device/Sampler.hpp"
 #include "System/Debug.hpp"
 
 #include <atomic>
@@ -97,8 +98,10 @@ public:
 	void clearWithLayerMask(const VkClearValue &clearValue, VkImageAspectFlags aspectMask, const VkRect2D &renderArea, uint32_t layerMask);
 	void resolve(ImageView *resolveAttachment);
 	void resolve(ImageView *resolveAttachment, int layer);
+	void resolve(ImageView *resolveAttachment, const VkRect2D &area);
 	void resolveWithLayerMask(ImageView *resolveAttachment, uint32_t layerMask);
 	void resolveDepthStencil(ImageView *resolveAttachment, const VkSubpassDescriptionDepthStencilResolve &dsResolve);
+	void discard();
 
 	VkImageViewType getType() const { return viewType; }
 	Format getFormat(Usage usage = RAW) const;
@@ -127,6 +130,7 @@ public:
 	bool hasDepthAspect() const { return (subresourceRange.aspectMask & VK_IMAGE_ASPECT_DEPTH_BIT) != 0; }
 	bool hasStencilAspect() const { return (subresourceRange.aspectMask & VK_IMAGE_ASPECT_STENCIL_BIT) != 0; }
 
+	bool requiresPreprocessing() const { return image->requiresPreprocessing(); }
 	void contentsChanged(Image::ContentsChangedContext context) { image->contentsChanged(subresourceRange, context); }
 
 	void prepareForSampling() { image->prepareForSampling(subresourceRange); }
@@ -135,9 +139,15 @@ public:
 	const VkImageSubresourceRange &getSubresourceRange() const { return subresourceRange; }
 	size_t getSizeInBytes() const { return image->getSizeInBytes(subresourceRange); }
 
+	// Sampling parameters of each mip level, shared by all sampled image
+	// descriptors which reference this view. Null for views which can't be
+	// sampled.
+	const sw::Texture *getSampledTexture() const { return sampledTexture; }
+
 private:
 	bool imageTypesMatch(VkImageType imageType) const;
 	const Image *getImage(Usage usage) const;
+	void writeSampledTexture();
 
 	Image *const image = nullptr;
 	const VkImageViewType viewType = VK_IMAGE_VIEW_TYPE_2D;
@@ -147,6 +157,8 @@ private:
 
 	const vk::SamplerYcbcrConversion *ycbcrConversion = nullptr;
 
+	sw::Texture *sampledTexture = nullptr;
+
 public:
 	const Identifier id;
 };
@@ -15,12 +15,122 @@
 #include "VkMemory.hpp"
 
 #include "VkConfig.hpp"
+#include "System/Debug.hpp"
 #include "System/Memory.hpp"
 
+#include "marl/mutex.h"
+#include "marl/tsa.h"
+
+// A Clang extension to determine compiler features.
+// We use it to detect Sanitizer builds (e.g. -fsanitize=memory).
+#ifndef __has_feature
+#	define __has_feature(x) 0
+#endif
+
 namespace vk {
 
+namespace {
+
+// Page mappings are zero-filled by the OS as they're touched, so mapping
+// large allocations directly avoids clearing memory the application may never
+// use. In MemorySanitizer builds the memory has to stay poisoned instead.
+#if defined(SWIFTSHADER_ZERO_INITIALIZE_DEVICE_MEMORY) || !__has_feature(memory_sanitizer)
+constexpr bool usePageAllocations = true;
+#else
+constexpr bool usePageAllocations = false;
+#endif
+
+// Smaller allocations are served by the heap, which pools them.
+constexpr size_t PAGE_ALLOCATION_THRESHOLD = 256 * 1024;
+
+// Freed page allocations are kept mapped, with their physical pages discarded,
+// so that applications which repeatedly allocate the same sizes don't pay for
+// new mappings. This only holds on to address space.
+constexpr size_t MAX_CACHED_PAGE_ALLOCATIONS = 8;
+
+class PageAllocationCache
+{
+public:
+	void *take(size_t bytes)
+	{
+		marl::lock lock(mutex);
+
+		for(size_t i = 0; i < count; i++)
+		{
+			if(entries[i].bytes == bytes)
+			{
+				void *memory = entries[i].memory;
+				entries[i] = entries[--count];
+				return memory;
+			}
+		}
+
+		return nullptr;
+	}
+
+	bool put(void *memory, size_t bytes)
+	{
+		marl::lock lock(mutex);
+
+		if(count == MAX_CACHED_PAGE_ALLOCATIONS)
+		{
+			return false;
+		}
+
+		sw::discardPages(memory, bytes);
+		entries[count++] = { memory, bytes };
+
+		return true;
+	}
+
+private:
+	struct Entry
+	{
+		void *memory;
+		size_t bytes;
+	};
+
+	marl::mutex mutex;
+	Entry entries[MAX_CACHED_PAGE_ALLOCATIONS] GUARDED_BY(mutex);
+	size_t count GUARDED_BY(mutex) = 0;
+};
+
+PageAllocationCache &pageAllocationCache()
+{
+	static PageAllocationCache cache;
+	return cache;
+}
+
+void *allocatePageMemory(size_t bytes)
+{
+	if(void *memory = pageAllocationCache().take(bytes))
+	{
+		return memory;
+	}
+
+	return sw::allocateZeroPages(bytes);
+}
+
+void freePageMemory(void *ptr, size_t bytes)
+{
+	if(ptr && !pageAllocationCache().put(ptr, bytes))
+	{
+		sw::freePages(ptr, bytes);
+	}
+}
+
+}  // anonymous namespace
+
 void *allocateDeviceMemory(size_t bytes, size_t alignment)
 {
+	if(usePageAllocations && bytes >= PAGE_ALLOCATION_THRESHOLD)
+	{
+		// Page allocations exceed any alignment we require.
+		ASSERT(alignment <= sw::memoryPageSize());
+
+		return allocatePageMemory(bytes);
+	}
+
 	// TODO(b/140991626): Use allocateZeroOrPoison() instead of allocateZero() to detect MemorySanitizer errors.
 #if defined(SWIFTSHADER_ZERO_INITIALIZE_DEVICE_MEMORY)
 	return sw::allocateZero(bytes, alignment);
@@ -30,11 +140,27 @@ void *allocateDeviceMemory(size_t bytes, size_t alignment)
 #endif
 }
 
-void freeDeviceMemory(void *ptr)
+void freeDeviceMemory(void *ptr, size_t bytes)
 {
+	if(usePageAllocations && bytes >= PAGE_ALLOCATION_THRESHOLD)
+	{
+		freePageMemory(ptr, bytes);
+		return;
+	}
+
 	sw::freeMemory(ptr);
 }
 
+void *allocateLazyDeviceMemory(size_t bytes)
+{
+	return allocatePageMemory(bytes);
+}
+
+void freeLazyDeviceMemory(void *ptr, size_t bytes)
+{
+	freePageMemory(ptr, bytes);
+}
+
 void *allocateHostMemory(size_t bytes, size_t alignment, const VkAllocationCallbacks *pAllocator, VkSystemAllocationScope allocationScope)
 {
 	if(pAllocator)
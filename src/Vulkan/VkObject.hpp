@@ -17,6 +17,7 @@
 
 #include "VkConfig.hpp"
 #include "VkMemory.hpp"
+#include "VkObjectPool.hpp"
 #include "System/Debug.hpp"
 
 #include <vulkan/vk_icd.h>
@@ -40,7 +41,7 @@ static inline VkT TtoVkT(T *object)
 }
 
 template<typename T, typename VkT, typename CreateInfo, typename... ExtendedInfo>
-static VkResult Create(const VkAllocationCallbacks *pAllocator, const CreateInfo *pCreateInfo, VkT *outObject, ExtendedInfo... extendedInfo)
+static VkResult Create(ObjectPool *pool, const VkAllocationCallbacks *pAllocator, const CreateInfo *pCreateInfo, VkT *outObject, ExtendedInfo... extendedInfo)
 {
 	*outObject = VK_NULL_HANDLE;
 
@@ -55,7 +56,8 @@ static VkResult Create(const VkAllocationCallbacks *pAllocator, const CreateInfo
 		}
 	}
 
-	void *objectMemory = vk::allocateHostMemory(sizeof(T), alignof(T), pAllocator, T::GetAllocationScope());
+	void *objectMemory = pool ? pool->allocate(sizeof(T), alignof(T), pAllocator)
+	                          : vk::allocateHostMemory(sizeof(T), alignof(T), pAllocator, T::GetAllocationScope());
 	if(!objectMemory)
 	{
 		vk::freeHostMemory(memory, pAllocator);
@@ -78,6 +80,12 @@ static VkResult Create(const VkAllocationCallbacks *pAllocator, const CreateInfo
 	return VK_SUCCESS;
 }
 
+template<typename T, typename VkT, typename CreateInfo, typename... ExtendedInfo>
+static VkResult Create(const VkAllocationCallbacks *pAllocator, const CreateInfo *pCreateInfo, VkT *outObject, ExtendedInfo... extendedInfo)
+{
+	return Create<T, VkT, CreateInfo>(nullptr, pAllocator, pCreateInfo, outObject, extendedInfo...);
+}
+
 template<typename T, typename VkT>
 class ObjectBase
 {
@@ -92,6 +100,13 @@ public:
 		return vk::Create<T, VkT, CreateInfo>(pAllocator, pCreateInfo, outObject, extendedInfo...);
 	}
 
+	// Allocates the object's memory from the pool, for objects which get created and destroyed frequently.
+	template<typename CreateInfo, typename... ExtendedInfo>
+	static VkResult Create(ObjectPool &pool, const VkAllocationCallbacks *pAllocator, const CreateInfo *pCreateInfo, VkT *outObject, ExtendedInfo... extendedInfo)
+	{
+		return vk::Create<T, VkT, CreateInfo>(&pool, pAllocator, pCreateInfo, outObject, extendedInfo...);
+	}
+
 	static constexpr VkSystemAllocationScope GetAllocationScope() { return VK_SYSTEM_ALLOCATION_SCOPE_OBJECT; }
 };
 
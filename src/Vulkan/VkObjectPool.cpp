@@ -0,0 +1,139 @@
+// Copyright 2021 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "VkObjectPool.hpp"
+
+#include "VkConfig.hpp"
+#include "VkMemory.hpp"
+#include "System/Debug.hpp"
+#include "System/Memory.hpp"
+
+namespace vk {
+
+namespace {
+
+constexpr size_t BLOCK_ALIGNMENT = REQUIRED_MEMORY_ALIGNMENT;
+
+// Number of free blocks each thread keeps per object type.
+constexpr size_t THREAD_CACHE_SIZE = 32;
+
+// Number of free blocks a pool keeps before returning them to the system.
+constexpr size_t MAX_POOLED_BLOCKS = 4096;
+
+// Blocks of the same object type have the same size for every device, so
+// they can be shared between the pools of different devices.
+struct ThreadCache
+{
+	~ThreadCache()
+	{
+		for(size_t i = 0; i < count; i++)
+		{
+			sw::freeMemory(blocks[i]);
+		}
+	}
+
+	void *blocks[THREAD_CACHE_SIZE];
+	size_t count = 0;
+};
+
+ThreadCache &threadCache(ObjectPool::Type type)
+{
+	thread_local ThreadCache caches[static_cast<size_t>(ObjectPool::Type::Count)];
+	return caches[static_cast<size_t>(type)];
+}
+
+}  // anonymous namespace
+
+ObjectPool::ObjectPool(Type type, size_t blockSize)
+    : type(type)
+    , blockSize(blockSize)
+{
+}
+
+ObjectPool::~ObjectPool()
+{
+	marl::lock lock(mutex);
+
+	for(void *block : freeBlocks)
+	{
+		sw::freeMemory(block);
+	}
+}
+
+void *ObjectPool::allocate(size_t bytes, size_t alignment, const VkAllocationCallbacks *pAllocator)
+{
+	if(pAllocator)
+	{
+		return vk::allocateHostMemory(bytes, alignment, pAllocator, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+	}
+
+	ASSERT(bytes <= blockSize && alignment <= BLOCK_ALIGNMENT);
+
+	ThreadCache &cache = threadCache(type);
+	if(cache.count == 0)
+	{
+		// Refill half of the thread's cache at once, to take the lock less often.
+		marl::lock lock(mutex);
+		while(cache.count < THREAD_CACHE_SIZE / 2 && !freeBlocks.empty())
+		{
+			cache.blocks[cache.count++] = freeBlocks.back();
+			freeBlocks.pop_back();
+		}
+	}
+
+	if(cache.count > 0)
+	{
+		return cache.blocks[--cache.count];
+	}
+
+	return sw::allocateZeroOrPoison(blockSize, BLOCK_ALIGNMENT);
+}
+
+void ObjectPool::free(void *ptr, const VkAllocationCallbacks *pAllocator)
+{
+	if(pAllocator)
+	{
+		vk::freeHostMemory(ptr, pAllocator);
+		return;
+	}
+
+	if(!ptr)
+	{
+		return;
+	}
+
+	ThreadCache &cache = threadCache(type);
+	if(cache.count == THREAD_CACHE_SIZE)
+	{
+		// Hand half of the thread's cache over to the pool, so that blocks
+		// freed on one thread can be reused by objects created on another.
+		marl::lock lock(mutex);
+		while(cache.count > THREAD_CACHE_SIZE / 2)
+		{
+			void *block = cache.blocks[--cache.count];
+			if(freeBlocks.size() < MAX_POOLED_BLOCKS)
+			{
+				freeBlocks.push_back(block);
+			}
+			else
+			{
+				sw::freeMemory(block);
+			}
+		}
+	}
+
+	cache.blocks[cache.count++] = ptr;
+}
+
+}  // namespace vk
@@ -0,0 +1,71 @@
+// Copyright 2021 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef VK_OBJECT_POOL_HPP_
+#define VK_OBJECT_POOL_HPP_
+
+#include "Vulkan/VulkanPlatform.hpp"
+
+#include "marl/mutex.h"
+#include "marl/tsa.h"
+
+#include <vector>
+
+namespace vk {
+
+// ObjectPool recycles the host memory of an object type which applications
+// create and destroy at a high rate. Freed blocks are reused as-is, without
+// being returned to the system allocator or cleared, since the object's
+// constructor initializes every member.
+// Each thread keeps a small cache of free blocks per type in front of the
+// pools, so that creating and destroying objects on the same thread doesn't
+// take a lock. Blocks which overflow the thread's cache are kept by the pool
+// until its device is destroyed.
+// Allocations made with application provided VkAllocationCallbacks bypass the
+// pool, since they must be returned to the application's allocator.
+class ObjectPool
+{
+public:
+	enum class Type
+	{
+		Event,
+		Fence,
+		Semaphore,
+		Framebuffer,
+		ImageView,
+		BufferView,
+		Sampler,
+		Count
+	};
+
+	ObjectPool(Type type, size_t blockSize);
+	~ObjectPool();
+
+	void *allocate(size_t bytes, size_t alignment, const VkAllocationCallbacks *pAllocator);
+	void free(void *ptr, const VkAllocationCallbacks *pAllocator);
+
+private:
+	ObjectPool(const ObjectPool &) = delete;
+	ObjectPool &operator=(const ObjectPool &) = delete;
+
+	const Type type;
+	const size_t blockSize;
+
+	marl::mutex mutex;
+	std::vector<void *> freeBlocks GUARDED_BY(mutex);
+};
+
+}  // namespace vk
+
+#endif  // VK_OBJECT_POOL_HPP_
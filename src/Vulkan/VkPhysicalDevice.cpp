@@ -63,7 +63,7 @@ const VkPhysicalDeviceFeatures &PhysicalDevice::getFeatures() const
 #endif
 		VK_TRUE,   // textureCompressionBC
 		VK_TRUE,   // occlusionQueryPrecise
-		VK_FALSE,  // pipelineStatisticsQuery
+		VK_TRUE,   // pipelineStatisticsQuery
 		VK_TRUE,   // vertexPipelineStoresAndAtomics
 		VK_TRUE,   // fragmentStoresAndAtomics
 		VK_FALSE,  // shaderTessellationAndGeometryPointSize
@@ -80,7 +80,7 @@ const VkPhysicalDeviceFeatures &PhysicalDevice::getFeatures() const
 		VK_TRUE,   // shaderCullDistance
 		VK_FALSE,  // shaderFloat64
 		VK_FALSE,  // shaderInt64
-		VK_FALSE,  // shaderInt16
+		VK_TRUE,   // shaderInt16
 		VK_FALSE,  // shaderResourceResidency
 		VK_FALSE,  // shaderResourceMinLod
 		VK_FALSE,  // sparseBinding
@@ -108,10 +108,10 @@ static void getPhysicalDeviceSamplerYcbcrConversionFeatures(T *features)
 template<typename T>
 static void getPhysicalDevice16BitStorageFeatures(T *features)
 {
-	features->storageBuffer16BitAccess = VK_FALSE;
+	features->storageBuffer16BitAccess = VK_TRUE;
 	features->storageInputOutput16 = VK_FALSE;
-	features->storagePushConstant16 = VK_FALSE;
-	features->uniformAndStorageBuffer16BitAccess = VK_FALSE;
+	features->storagePushConstant16 = VK_TRUE;
+	features->uniformAndStorageBuffer16BitAccess = VK_TRUE;
 }
 
 template<typename T>
@@ -124,9 +124,9 @@ static void getPhysicalDeviceVariablePointersFeatures(T *features)
 template<typename T>
 static void getPhysicalDevice8BitStorageFeaturesKHR(T *features)
 {
-	features->storageBuffer8BitAccess = VK_FALSE;
-	features->uniformAndStorageBuffer8BitAccess = VK_FALSE;
-	features->storagePushConstant8 = VK_FALSE;
+	features->storageBuffer8BitAccess = VK_TRUE;
+	features->uniformAndStorageBuffer8BitAccess = VK_TRUE;
+	features->storagePushConstant8 = VK_TRUE;
 }
 
 template<typename T>
@@ -243,26 +243,26 @@ static void getPhysicalDeviceUniformBufferStandardLayoutFeatures(T *features)
 template<typename T>
 static void getPhysicalDeviceDescriptorIndexingFeatures(T *features)
 {
-	features->shaderInputAttachmentArrayDynamicIndexing = VK_FALSE;
-	features->shaderUniformTexelBufferArrayDynamicIndexing = VK_FALSE;
-	features->shaderStorageTexelBufferArrayDynamicIndexing = VK_FALSE;
+	features->shaderInputAttachmentArrayDynamicIndexing = VK_TRUE;
+	features->shaderUniformTexelBufferArrayDynamicIndexing = VK_TRUE;
+	features->shaderStorageTexelBufferArrayDynamicIndexing = VK_TRUE;
 	features->shaderUniformBufferArrayNonUniformIndexing = VK_FALSE;
-	features->shaderSampledImageArrayNonUniformIndexing = VK_FALSE;
+	features->shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
 	features->shaderStorageBufferArrayNonUniformIndexing = VK_FALSE;
 	features->shaderStorageImageArrayNonUniformIndexing = VK_FALSE;
 	features->shaderInputAttachmentArrayNonUniformIndexing = VK_FALSE;
-	features->shaderUniformTexelBufferArrayNonUniformIndexing = VK_FALSE;
+	features->shaderUniformTexelBufferArrayNonUniformIndexing = VK_TRUE;
 	features->shaderStorageTexelBufferArrayNonUniformIndexing = VK_FALSE;
 	features->descriptorBindingUniformBufferUpdateAfterBind = VK_FALSE;
-	features->descriptorBindingSampledImageUpdateAfterBind = VK_FALSE;
-	features->descriptorBindingStorageImageUpdateAfterBind = VK_FALSE;
-	features->descriptorBindingStorageBufferUpdateAfterBind = VK_FALSE;
-	features->descriptorBindingUniformTexelBufferUpdateAfterBind = VK_FALSE;
-	features->descriptorBindingStorageTexelBufferUpdateAfterBind = VK_FALSE;
-	features->descriptorBindingUpdateUnusedWhilePending = VK_FALSE;
-	features->descriptorBindingPartiallyBound = VK_FALSE;
-	features->descriptorBindingVariableDescriptorCount = VK_FALSE;
-	features->runtimeDescriptorArray = VK_FALSE;
+	features->descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+	features->descriptorBindingStorageImageUpdateAfterBind = VK_TRUE;
+	features->descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+	features->descriptorBindingUniformTexelBufferUpdateAfterBind = VK_TRUE;
+	features->descriptorBindingStorageTexelBufferUpdateAfterBind = VK_TRUE;
+	features->descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+	features->descriptorBindingPartiallyBound = VK_TRUE;
+	features->descriptorBindingVariableDescriptorCount = VK_TRUE;
+	features->runtimeDescriptorArray = VK_TRUE;
 }
 
 template<typename T>
@@ -289,8 +289,8 @@ static void getPhysicalDeviceShaderAtomicInt64Features(T *features)
 template<typename T>
 static void getPhysicalDeviceShaderFloat16Int8Features(T *features)
 {
-	features->shaderFloat16 = VK_FALSE;
-	features->shaderInt8 = VK_FALSE;
+	features->shaderFloat16 = VK_TRUE;
+	features->shaderInt8 = VK_TRUE;
 }
 
 template<typename T>
@@ -305,10 +305,12 @@ template<typename T>
 static void getPhysicalDeviceVulkan12Features(T *features)
 {
 	features->samplerMirrorClampToEdge = VK_FALSE;
-	features->drawIndirectCount = VK_FALSE;
+	features->drawIndirectCount = VK_TRUE;
 	getPhysicalDevice8BitStorageFeaturesKHR(features);
 	getPhysicalDeviceShaderAtomicInt64Features(features);
 	getPhysicalDeviceShaderFloat16Int8Features(features);
+	// Non-uniform indexing of storage buffer and storage image arrays is
+	// required for the aggregate feature, but not supported.
 	features->descriptorIndexing = VK_FALSE;
 	getPhysicalDeviceDescriptorIndexingFeatures(features);
 	features->samplerFilterMinmax = VK_FALSE;
@@ -993,28 +995,29 @@ static void getDescriptorIndexingProperties(T *properties)
 	//  the corresponding non-UpdateAfterBind limit."
 	const VkPhysicalDeviceLimits &limits = PhysicalDevice::getLimits();
 
-	properties->maxUpdateAfterBindDescriptorsInAllPools = 0;
+	properties->maxUpdateAfterBindDescriptorsInAllPools = MAX_UPDATE_AFTER_BIND_DESCRIPTORS;
 	properties->shaderUniformBufferArrayNonUniformIndexingNative = VK_FALSE;
 	properties->shaderSampledImageArrayNonUniformIndexingNative = VK_FALSE;
 	properties->shaderStorageBufferArrayNonUniformIndexingNative = VK_FALSE;
 	properties->shaderStorageImageArrayNonUniformIndexingNative = VK_FALSE;
 	properties->shaderInputAttachmentArrayNonUniformIndexingNative = VK_FALSE;
-	properties->robustBufferAccessUpdateAfterBind = VK_FALSE;
+	properties->robustBufferAccessUpdateAfterBind = VK_TRUE;
 	properties->quadDivergentImplicitLod = VK_FALSE;
-	properties->maxPerStageDescriptorUpdateAfterBindSamplers = limits.maxPerStageDescriptorSamplers;
+	properties->maxPerStageDescriptorUpdateAfterBindSamplers = MAX_UPDATE_AFTER_BIND_DESCRIPTORS;
+	// Uniform buffers can't be updated after bind, so their limits are the minimum required.
 	properties->maxPerStageDescriptorUpdateAfterBindUniformBuffers = limits.maxPerStageDescriptorUniformBuffers;
-	properties->maxPerStageDescriptorUpdateAfterBindStorageBuffers = limits.maxPerStageDescriptorStorageBuffers;
-	properties->maxPerStageDescriptorUpdateAfterBindSampledImages = limits.maxPerStageDescriptorSampledImages;
-	properties->maxPerStageDescriptorUpdateAfterBindStorageImages = limits.maxPerStageDescriptorStorageImages;
+	properties->maxPerStageDescriptorUpdateAfterBindStorageBuffers = MAX_UPDATE_AFTER_BIND_DESCRIPTORS;
+	properties->maxPerStageDescriptorUpdateAfterBindSampledImages = MAX_UPDATE_AFTER_BIND_DESCRIPTORS;
+	properties->maxPerStageDescriptorUpdateAfterBindStorageImages = MAX_UPDATE_AFTER_BIND_DESCRIPTORS;
 	properties->maxPerStageDescriptorUpdateAfterBindInputAttachments = limits.maxPerStageDescriptorInputAttachments;
-	properties->maxPerStageUpdateAfterBindResources = limits.maxPerStageResources;
-	properties->maxDescriptorSetUpdateAfterBindSamplers = limits.maxDescriptorSetSamplers;
+	properties->maxPerStageUpdateAfterBindResources = MAX_UPDATE_AFTER_BIND_DESCRIPTORS;
+	properties->maxDescriptorSetUpdateAfterBindSamplers = MAX_UPDATE_AFTER_BIND_DESCRIPTORS;
 	properties->maxDescriptorSetUpdateAfterBindUniformBuffers = limits.maxDescriptorSetUniformBuffers;
 	properties->maxDescriptorSetUpdateAfterBindUniformBuffersDynamic = limits.maxDescriptorSetUniformBuffersDynamic;
-	properties->maxDescriptorSetUpdateAfterBindStorageBuffers = limits.maxDescriptorSetStorageBuffers;
+	properties->maxDescriptorSetUpdateAfterBindStorageBuffers = MAX_UPDATE_AFTER_BIND_DESCRIPTORS;
 	properties->maxDescriptorSetUpdateAfterBindStorageBuffersDynamic = limits.maxDescriptorSetStorageBuffersDynamic;
-	properties->maxDescriptorSetUpdateAfterBindSampledImages = limits.maxDescriptorSetSampledImages;
-	properties->maxDescriptorSetUpdateAfterBindStorageImages = limits.maxDescriptorSetStorageImages;
+	properties->maxDescriptorSetUpdateAfterBindSampledImages = MAX_UPDATE_AFTER_BIND_DESCRIPTORS;
+	properties->maxDescriptorSetUpdateAfterBindStorageImages = MAX_UPDATE_AFTER_BIND_DESCRIPTORS;
 	properties->maxDescriptorSetUpdateAfterBindInputAttachments = limits.maxDescriptorSetInputAttachments;
 }
 
@@ -1806,7 +1809,7 @@ void PhysicalDevice::getQueueFamilyProperties(uint32_t pQueueFamilyPropertyCount
 const VkPhysicalDeviceMemoryProperties &PhysicalDevice::GetMemoryProperties()
 {
 	static const VkPhysicalDeviceMemoryProperties properties{
-		1,  // memoryTypeCount
+		2,  // memoryTypeCount
 		{
 		    // vk::MEMORY_TYPE_GENERIC_BIT
 		    {
@@ -1816,6 +1819,12 @@ const VkPhysicalDeviceMemoryProperties &PhysicalDevice::GetMemoryProperties()
 		         VK_MEMORY_PROPERTY_HOST_CACHED_BIT),  // propertyFlags
 		        0                                      // heapIndex
 		    },
+		    // vk::MEMORY_TYPE_LAZILY_ALLOCATED_BIT
+		    {
+		        (VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT |
+		         VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT),  // propertyFlags
+		        0                                           // heapIndex
+		    },
 		},
 		1,  // memoryHeapCount
 		{
@@ -23,8 +23,8 @@
 #include "VkStringify.hpp"
 #include "Pipeline/ComputeProgram.hpp"
 #include "Pipeline/SpirvShader.hpp"
-
-#include "marl/trace.h"
+#include "System/Metrics.hpp"
+#include "System/Trace.hpp"
 
 #include "spirv-tools/optimizer.hpp"
 
@@ -35,6 +35,8 @@ namespace {
 // optimizeSpirv() applies and freezes specializations into constants, and runs spirv-opt.
 sw::SpirvBinary optimizeSpirv(const vk::PipelineCache::SpirvBinaryKey &key)
 {
+	sw::Metrics::ScopedTimer timer(sw::Metrics::SpirvOptimizeTime);
+
 	const sw::SpirvBinary &code = key.getBinary();
 	const VkSpecializationInfo *specializationInfo = key.getSpecializationInfo();
 	bool optimize = key.getOptimization();
@@ -109,7 +111,7 @@ sw::SpirvBinary optimizeSpirv(const vk::PipelineCache::SpirvBinaryKey &key)
 
 std::shared_ptr<sw::ComputeProgram> createProgram(vk::Device *device, std::shared_ptr<sw::SpirvShader> shader, const vk::PipelineLayout *layout)
 {
-	MARL_SCOPED_EVENT("createProgram");
+	SW_SCOPED_EVENT("createProgram");
 
 	vk::DescriptorSet::Bindings descriptorSets;  // TODO(b/129523279): Delay code generation until dispatch time.
 	// TODO(b/119409619): use allocator.
@@ -483,4 +485,10 @@ void ComputePipeline::run(uint32_t baseGroupX, uint32_t baseGroupY, uint32_t bas
 	    groupCountX, groupCountY, groupCountZ);
 }
 
+uint32_t ComputePipeline::getWorkgroupInvocationCount() const
+{
+	auto &executionModes = shader->getExecutionModes();
+	return executionModes.WorkgroupSizeX * executionModes.WorkgroupSizeY * executionModes.WorkgroupSizeZ;
+}
+
 }  // namespace vk
@@ -148,6 +148,9 @@ public:
 	         vk::DescriptorSet::DynamicOffsets const &descriptorDynamicOffsets,
 	         vk::Pipeline::PushConstantStorage const &pushConstants);
 
+	// Returns the number of shader invocations of each workgroup.
+	uint32_t getWorkgroupInvocationCount() const;
+
 protected:
 	std::shared_ptr<sw::SpirvShader> shader;
 	std::shared_ptr<sw::ComputeProgram> program;
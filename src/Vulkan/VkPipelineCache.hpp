@@ -18,6 +18,7 @@
 #include "VkObject.hpp"
 #include "VkSpecializationInfo.hpp"
 #include "Pipeline/SpirvBinary.hpp"
+#include "System/Metrics.hpp"
 
 #include "marl/mutex.h"
 #include "marl/tsa.h"
@@ -137,9 +138,11 @@ std::shared_ptr<sw::ComputeProgram> PipelineCache::getOrCreateComputeProgram(con
 	auto it = computePrograms.find(key);
 	if(it != computePrograms.end())
 	{
+		sw::Metrics::count(sw::Metrics::PipelineComputeCache, sw::Metrics::CacheHit);
 		return it->second;
 	}
 
+	sw::Metrics::count(sw::Metrics::PipelineComputeCache, sw::Metrics::CacheMiss);
 	auto created = create();
 	computePrograms.emplace(key, created);
 
@@ -161,10 +164,12 @@ sw::SpirvBinary PipelineCache::getOrOptimizeSpirv(const PipelineCache::SpirvBina
 	auto it = spirvShaders.find(key);
 	if(it != spirvShaders.end())
 	{
+		sw::Metrics::count(sw::Metrics::PipelineSpirvCache, sw::Metrics::CacheHit);
 		cacheHit();
 		return it->second;
 	}
 
+	sw::Metrics::count(sw::Metrics::PipelineSpirvCache, sw::Metrics::CacheMiss);
 	sw::SpirvBinary outShader = create();
 	spirvShaders.emplace(key, outShader);
 	return outShader;
@@ -14,6 +14,8 @@
 
 #include "VkQueryPool.hpp"
 
+#include "System/Math.hpp"
+
 #include <chrono>
 #include <cstring>
 #include <new>
@@ -25,7 +27,12 @@ Query::Query(VkQueryType type)
     , state(UNAVAILABLE)
     , type(type)
     , value(0)
-{}
+{
+	for(auto &statistic : statistics)
+	{
+		statistic = 0;
+	}
+}
 
 void Query::reset()
 {
@@ -33,6 +40,11 @@ void Query::reset()
 	auto prevState = state.exchange(UNAVAILABLE);
 	ASSERT(prevState != ACTIVE);
 	value = 0;
+
+	for(auto &statistic : statistics)
+	{
+		statistic = 0;
+	}
 }
 
 void Query::start()
@@ -80,22 +92,22 @@ void Query::add(int64_t v)
 	value += v;
 }
 
+void Query::addStatistic(VkQueryPipelineStatisticFlagBits statistic, int64_t v)
+{
+	statistics[sw::log2i(statistic)] += v;
+}
+
+int64_t Query::getStatistic(VkQueryPipelineStatisticFlagBits statistic) const
+{
+	return statistics[sw::log2i(statistic)];
+}
+
 QueryPool::QueryPool(const VkQueryPoolCreateInfo *pCreateInfo, void *mem)
     : pool(reinterpret_cast<Query *>(mem))
     , type(pCreateInfo->queryType)
     , count(pCreateInfo->queryCount)
+    , pipelineStatistics((type == VK_QUERY_TYPE_PIPELINE_STATISTICS) ? pCreateInfo->pipelineStatistics : 0)
 {
-	// According to the Vulkan 1.2 spec, section 30. Features:
-	// "pipelineStatisticsQuery specifies whether the pipeline statistics
-	//  queries are supported. If this feature is not enabled, queries of
-	//  type VK_QUERY_TYPE_PIPELINE_STATISTICS cannot be created, and
-	//  none of the VkQueryPipelineStatisticFlagBits bits can be set in the
-	//  pipelineStatistics member of the VkQueryPoolCreateInfo structure."
-	if(type == VK_QUERY_TYPE_PIPELINE_STATISTICS)
-	{
-		UNSUPPORTED("VkPhysicalDeviceFeatures::pipelineStatisticsQuery");
-	}
-
 	// Construct all queries
 	for(uint32_t i = 0; i < count; i++)
 	{
@@ -152,16 +164,35 @@ VkResult QueryPool::getResults(uint32_t firstQuery, uint32_t queryCount, size_t
 			writeResult = (flags & VK_QUERY_RESULT_PARTIAL_BIT);  // Allow writing partial results
 		}
 
+		// "If the query type is VK_QUERY_TYPE_PIPELINE_STATISTICS, one integer value is written
+		//  for each bit that is enabled in the pipelineStatistics when the pool is created, and
+		//  the statistics values are written in bit order starting from the least significant bit."
+		int64_t values[Query::PipelineStatisticCount] = { current.value };
+		if(type == VK_QUERY_TYPE_PIPELINE_STATISTICS)
+		{
+			uint32_t index = 0;
+			for(uint32_t bits = pipelineStatistics; bits != 0; bits &= bits - 1)
+			{
+				auto statistic = static_cast<VkQueryPipelineStatisticFlagBits>(bits & ~(bits - 1));
+				values[index++] = query.getStatistic(statistic);
+			}
+		}
+
+		const uint32_t valueCount = resultCount();
+
 		if(flags & VK_QUERY_RESULT_64_BIT)
 		{
 			uint64_t *result64 = reinterpret_cast<uint64_t *>(data);
 			if(writeResult)
 			{
-				result64[0] = current.value;
+				for(uint32_t j = 0; j < valueCount; j++)
+				{
+					result64[j] = values[j];
+				}
 			}
 			if(flags & VK_QUERY_RESULT_WITH_AVAILABILITY_BIT)  // Output query availablity
 			{
-				result64[1] = current.state;
+				result64[valueCount] = current.state;
 			}
 		}
 		else
@@ -169,11 +200,14 @@ VkResult QueryPool::getResults(uint32_t firstQuery, uint32_t queryCount, size_t
 			uint32_t *result32 = reinterpret_cast<uint32_t *>(data);
 			if(writeResult)
 			{
-				result32[0] = static_cast<uint32_t>(current.value);
+				for(uint32_t j = 0; j < valueCount; j++)
+				{
+					result32[j] = static_cast<uint32_t>(values[j]);
+				}
 			}
 			if(flags & VK_QUERY_RESULT_WITH_AVAILABILITY_BIT)  // Output query availablity
 			{
-				result32[1] = current.state;
+				result32[valueCount] = current.state;
 			}
 		}
 	}
@@ -181,6 +215,22 @@ VkResult QueryPool::getResults(uint32_t firstQuery, uint32_t queryCount, size_t
 	return result;
 }
 
+uint32_t QueryPool::resultCount() const
+{
+	if(type != VK_QUERY_TYPE_PIPELINE_STATISTICS)
+	{
+		return 1;
+	}
+
+	uint32_t valueCount = 0;
+	for(uint32_t bits = pipelineStatistics; bits != 0; bits &= bits - 1)
+	{
+		valueCount++;
+	}
+
+	return valueCount;
+}
+
 void QueryPool::begin(uint32_t query, VkQueryControlFlags flags)
 {
 	ASSERT(query < count);
@@ -217,6 +267,14 @@ void QueryPool::writeTimestamp(uint32_t query)
 	ASSERT(type == VK_QUERY_TYPE_TIMESTAMP);
 
 	pool[query].start();
+	finishTimestamp(query);
+}
+
+void QueryPool::finishTimestamp(uint32_t query)
+{
+	ASSERT(query < count);
+	ASSERT(type == VK_QUERY_TYPE_TIMESTAMP);
+
 	pool[query].set(std::chrono::time_point_cast<std::chrono::nanoseconds>(
 	                    std::chrono::steady_clock::now())
 	                    .time_since_epoch()
@@ -75,12 +75,25 @@ public:
 	// add() adds val to the current query value.
 	void add(int64_t val);
 
+	// Number of VkQueryPipelineStatisticFlagBits counters held by a pipeline
+	// statistics query.
+	static constexpr int PipelineStatisticCount = 11;
+
+	// addStatistic() adds val to the pipeline statistics counter of the given
+	// statistic.
+	void addStatistic(VkQueryPipelineStatisticFlagBits statistic, int64_t val);
+
+	// getStatistic() returns the pipeline statistics counter of the given
+	// statistic.
+	int64_t getStatistic(VkQueryPipelineStatisticFlagBits statistic) const;
+
 private:
 	marl::WaitGroup wg;
 	marl::Event finished;
 	std::atomic<State> state;
 	std::atomic<VkQueryType> type;
 	std::atomic<int64_t> value;
+	std::atomic<int64_t> statistics[PipelineStatisticCount];
 };
 
 class QueryPool : public Object<QueryPool, VkQueryPool>
@@ -99,13 +112,22 @@ public:
 
 	void writeTimestamp(uint32_t query);
 
+	// finishTimestamp() writes the current time to a timestamp query which
+	// was started ahead of the write, and makes it available.
+	void finishTimestamp(uint32_t query);
+
 	inline Query *getQuery(uint32_t query) const { return &pool[query]; }
 	inline VkQueryType getType() const { return type; }
 
 private:
+	// Returns the number of values written per query by getResults(),
+	// excluding the availability value.
+	uint32_t resultCount() const;
+
 	Query *const pool;
 	const VkQueryType type;
 	const uint32_t count;
+	const VkQueryPipelineStatisticFlags pipelineStatistics;
 };
 
 static inline QueryPool *Cast(VkQueryPool object)
@@ -20,13 +20,14 @@
 #include "VkStringify.hpp"
 #include "VkTimelineSemaphore.hpp"
 #include "Device/Renderer.hpp"
+#include "System/Trace.hpp"
 #include "WSI/VkSwapchainKHR.hpp"
 
 #include "marl/defer.h"
 #include "marl/scheduler.h"
 #include "marl/thread.h"
-#include "marl/trace.h"
 
+#include <atomic>
 #include <cstring>
 
 namespace vk {
@@ -186,9 +187,13 @@ VkResult Queue::submit(uint32_t submitCount, const VkSubmitInfo *pSubmits, Fence
 {
 	garbageCollect();
 
+	static std::atomic<uint64_t> nextSubmissionID = { 1 };
+
 	Task task;
 	task.submitCount = submitCount;
 	task.pSubmits = DeepCopySubmitInfo(submitCount, pSubmits);
+	task.id = nextSubmissionID++;
+	sw::Trace::beginAsync("submission", task.id);
 	if(fence)
 	{
 		task.events = fence->getCountedEvent();
@@ -202,6 +207,8 @@ VkResult Queue::submit(uint32_t submitCount, const VkSubmitInfo *pSubmits, Fence
 
 void Queue::submitQueue(const Task &task)
 {
+	SW_SCOPED_EVENT("submit %d", int(task.id));
+
 	if(renderer == nullptr)
 	{
 		renderer.reset(new sw::Renderer(device));
@@ -267,11 +274,17 @@ void Queue::submitQueue(const Task &task)
 		renderer->synchronize();
 		task.events->done();
 	}
+
+	if(task.id != 0)
+	{
+		sw::Trace::endAsync("submission", task.id);
+	}
 }
 
 void Queue::taskLoop(marl::Scheduler *scheduler)
 {
 	marl::Thread::setName("Queue<%p>", this);
+	sw::Trace::nameThread("Queue %p", this);
 	scheduler->bind();
 	defer(scheduler->unbind());
 
@@ -286,7 +299,14 @@ void Queue::taskLoop(marl::Scheduler *scheduler)
 			return;
 		case Task::SUBMIT_QUEUE:
 			submitQueue(task);
+			// Write the trace from the queue's thread rather than the application's.
+			sw::Trace::flushPeriodically();
 			break;
+#ifndef __ANDROID__
+		case Task::PRESENT_QUEUE:
+			presentQueue(task);
+			break;
+#endif
 		default:
 			UNREACHABLE("task.type %d", static_cast<int>(task.type));
 			break;
@@ -324,16 +344,28 @@ void Queue::garbageCollect()
 #ifndef __ANDROID__
 VkResult Queue::present(const VkPresentInfoKHR *presentInfo)
 {
-	// This is a hack to deal with screen tearing for now.
-	// Need to correctly implement threading using VkSemaphore
-	// to get rid of it. b/132458423
-	waitIdle();
+	garbageCollect();
 
-	for(uint32_t i = 0; i < presentInfo->waitSemaphoreCount; i++)
-	{
-		auto *semaphore = vk::DynamicCast<BinarySemaphore>(presentInfo->pWaitSemaphores[i]);
-		semaphore->wait();
-	}
+	PresentInfo present = {};
+	present.pPresentInfo = presentInfo;
+
+	Task task;
+	task.type = Task::PRESENT_QUEUE;
+	task.pPresent = &present;
+	task.events = std::make_shared<sw::CountedEvent>();
+	task.events->add();  // done() is called once the queue thread has processed the present
+
+	pending.put(task);
+	task.events->wait();
+
+	SW_SCOPED_EVENT("present");
+
+	// Only the draws submitted before the present are waited for, rather than
+	// the whole queue. The surfaces are then updated on the calling thread,
+	// as windowing systems such as Xlib can't be used from other threads
+	// unless the application initialized them for it.
+	present.drawTicket.wait();
+	present.drawTicket.done();
 
 	VkResult commandResult = VK_SUCCESS;
 
@@ -360,6 +392,27 @@ VkResult Queue::present(const VkPresentInfoKHR *presentInfo)
 
 	return commandResult;
 }
+
+// Waits on the present's semaphores, in order with the submissions, and takes
+// a ticket for the draws issued before the present.
+void Queue::presentQueue(const Task &task)
+{
+	if(renderer == nullptr)
+	{
+		renderer.reset(new sw::Renderer(device));
+	}
+
+	const VkPresentInfoKHR *presentInfo = task.pPresent->pPresentInfo;
+
+	for(uint32_t i = 0; i < presentInfo->waitSemaphoreCount; i++)
+	{
+		auto *semaphore = vk::DynamicCast<BinarySemaphore>(presentInfo->pWaitSemaphores[i]);
+		semaphore->wait();
+	}
+
+	task.pPresent->drawTicket = renderer->takeSynchronizationTicket();
+	task.events->done();
+}
 #endif
 
 void Queue::beginDebugUtilsLabel(const VkDebugUtilsLabelEXT *pLabelInfo)
@@ -19,6 +19,8 @@
 #include "Device/Renderer.hpp"
 #include "System/Synchronization.hpp"
 
+#include "marl/ticket.h"
+
 #include <thread>
 
 namespace marl {
@@ -76,16 +78,27 @@ private:
 		const uint64_t *pSignalSemaphoreValues;
 	};
 
+	// vkQueuePresentKHR() waits for the queue thread to process the present,
+	// so it refers to the application's structure rather than a copy.
+	struct PresentInfo
+	{
+		const VkPresentInfoKHR *pPresentInfo;
+		marl::Ticket drawTicket;  // Called once the draws preceding the present are complete
+	};
+
 	struct Task
 	{
 		uint32_t submitCount = 0;
 		SubmitInfo *pSubmits = nullptr;
+		PresentInfo *pPresent = nullptr;
 		std::shared_ptr<sw::CountedEvent> events;
+		uint64_t id = 0;  // Identifies submissions in traces, or 0 for internal tasks
 
 		enum Type
 		{
 			KILL_THREAD,
-			SUBMIT_QUEUE
+			SUBMIT_QUEUE,
+			PRESENT_QUEUE
 		};
 		Type type = SUBMIT_QUEUE;
 	};
@@ -94,6 +107,9 @@ private:
 	void garbageCollect();
 	void submitQueue(const Task &task);
 	static SubmitInfo *DeepCopySubmitInfo(uint32_t submitCount, const VkSubmitInfo *pSubmits);
+#ifndef __ANDROID__
+	void presentQueue(const Task &task);
+#endif
 
 	Device *device;
 	std::unique_ptr<sw::Renderer> renderer;
@@ -45,9 +45,12 @@
 #include "VkStructConversion.hpp"
 #include "VkTimelineSemaphore.hpp"
 
+#include "Reactor/ExecutableMemory.hpp"
 #include "Reactor/Nucleus.hpp"
 #include "System/CPUID.hpp"
 #include "System/Debug.hpp"
+#include "System/Metrics.hpp"
+#include "System/Trace.hpp"
 #include "WSI/HeadlessSurfaceKHR.hpp"
 #include "WSI/VkSwapchainKHR.hpp"
 
@@ -84,6 +87,9 @@
 #include "marl/thread.h"
 #include "marl/tsa.h"
 
+#include <vulkan/vk_swiftshader_metrics.h>
+#include <vulkan/vk_swiftshader_trace.h>
+
 #ifdef __ANDROID__
 #	include "commit.h"
 #	include "System/GrallocAndroid.hpp"
@@ -130,6 +136,33 @@ void setReactorDefaultConfig()
 	rr::Nucleus::adjustDefaultConfig(cfg);
 }
 
+// initializeMetrics() routes Reactor's compilation statistics to sw::Metrics
+// and sw::Trace, and enables metrics if requested by the environment.
+void initializeMetrics()
+{
+	rr::Nucleus::setRoutineCompiledCallback([](const char *name, std::chrono::nanoseconds duration) {
+		sw::Metrics::add(sw::Metrics::JITRoutines);
+		sw::Metrics::record(sw::Metrics::JITCompileTime, duration);
+
+		if(sw::Trace::isEnabled())
+		{
+			auto end = std::chrono::steady_clock::now();
+			char event[sw::Trace::MaxNameLength];
+			snprintf(event, sizeof(event), "JIT %s", name);
+			sw::Trace::event(event, end - std::chrono::duration_cast<std::chrono::steady_clock::duration>(duration), end);
+		}
+	});
+
+	sw::Metrics::setJITCodeBytesSource(rr::executableMemoryAllocated);
+	sw::Metrics::initializeFromEnvironment();
+}
+
+// initializeTrace() starts writing a trace if requested by the environment.
+void initializeTrace()
+{
+	sw::Trace::initializeFromEnvironment();
+}
+
 std::shared_ptr<marl::Scheduler> getOrCreateScheduler()
 {
 	struct Scheduler
@@ -146,7 +179,8 @@ std::shared_ptr<marl::Scheduler> getOrCreateScheduler()
 	{
 		marl::Scheduler::Config cfg;
 		cfg.setWorkerThreadCount(std::min<size_t>(marl::Thread::numLogicalCPUs(), 16));
-		cfg.setWorkerThreadInitializer([](int) {
+		cfg.setWorkerThreadInitializer([](int id) {
+			sw::Trace::nameThread("Worker %d", id);
 			sw::CPUID::setFlushToZero(true);
 			sw::CPUID::setDenormalsAreZero(true);
 		});
@@ -165,6 +199,8 @@ void initializeLibrary()
 		logBuildVersionInformation();
 #endif  // __ANDROID__ && ENABLE_BUILD_VERSION_OUTPUT
 		setReactorDefaultConfig();
+		initializeMetrics();
+		initializeTrace();
 		return true;
 	}();
 	(void)doOnce;
@@ -295,6 +331,66 @@ VK_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vk_icdInitializeConnectToServiceCallbac
 
 #endif  // VK_USE_PLATFORM_FUCHSIA
 
+// SwiftShader-specific entry points for observing the driver's metrics. See
+// include/vulkan/vk_swiftshader_metrics.h.
+VK_EXPORT VKAPI_ATTR void VKAPI_CALL swiftshaderSetMetricsEnabled(VkBool32 enabled)
+{
+	TRACE("(VkBool32 enabled = %d)", enabled);
+
+	sw::Metrics::setEnabled(enabled != VK_FALSE);
+}
+
+VK_EXPORT VKAPI_ATTR void VKAPI_CALL swiftshaderResetMetrics()
+{
+	TRACE("()");
+
+	sw::Metrics::reset();
+}
+
+VK_EXPORT VKAPI_ATTR size_t VKAPI_CALL swiftshaderGetMetrics(char *pReport, size_t reportSize)
+{
+	TRACE("(char* pReport = %p, size_t reportSize = %d)", pReport, int(reportSize));
+
+	std::string report = sw::Metrics::format(sw::Metrics::snapshot());
+
+	if(pReport && reportSize > 0)
+	{
+		size_t length = std::min(report.size(), reportSize - 1);
+		memcpy(pReport, report.c_str(), length);
+		pReport[length] = '\0';
+	}
+
+	return report.size();
+}
+
+VK_EXPORT VKAPI_ATTR uint64_t VKAPI_CALL swiftshaderGetMetric(const char *pName)
+{
+	TRACE("(const char* pName = %s)", pName ? pName : "(null)");
+
+	if(!pName)
+	{
+		return 0;
+	}
+
+	return sw::Metrics::value(sw::Metrics::snapshot(), pName);
+}
+
+// SwiftShader-specific entry points for tracing the driver's work. See
+// include/vulkan/vk_swiftshader_trace.h.
+VK_EXPORT VKAPI_ATTR VkBool32 VKAPI_CALL swiftshaderStartTrace(const char *pPath)
+{
+	TRACE("(const char* pPath = %s)", pPath);
+
+	return sw::Trace::start(pPath) ? VK_TRUE : VK_FALSE;
+}
+
+VK_EXPORT VKAPI_ATTR void VKAPI_CALL swiftshaderStopTrace()
+{
+	TRACE("()");
+
+	sw::Trace::stop();
+}
+
 struct ExtensionProperties : public VkExtensionProperties
 {
 	std::function<bool()> isSupported = [] { return true; };
@@ -416,6 +512,7 @@ static const ExtensionProperties deviceExtensionProperties[] = {
 	{ { VK_EXT_SCALAR_BLOCK_LAYOUT_EXTENSION_NAME, VK_EXT_SCALAR_BLOCK_LAYOUT_SPEC_VERSION } },
 	{ { VK_EXT_SEPARATE_STENCIL_USAGE_EXTENSION_NAME, VK_EXT_SEPARATE_STENCIL_USAGE_SPEC_VERSION } },
 	{ { VK_KHR_DEPTH_STENCIL_RESOLVE_EXTENSION_NAME, VK_KHR_DEPTH_STENCIL_RESOLVE_SPEC_VERSION } },
+	{ { VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME, VK_KHR_DRAW_INDIRECT_COUNT_SPEC_VERSION } },
 	{ { VK_KHR_IMAGE_FORMAT_LIST_EXTENSION_NAME, VK_KHR_IMAGE_FORMAT_LIST_SPEC_VERSION } },
 	{ { VK_KHR_IMAGELESS_FRAMEBUFFER_EXTENSION_NAME, VK_KHR_IMAGELESS_FRAMEBUFFER_SPEC_VERSION } },
 	{ { VK_KHR_SHADER_FLOAT_CONTROLS_EXTENSION_NAME, VK_KHR_SHADER_FLOAT_CONTROLS_SPEC_VERSION } },
@@ -430,6 +527,9 @@ static const ExtensionProperties deviceExtensionProperties[] = {
 	{ { VK_KHR_SWAPCHAIN_MUTABLE_FORMAT_EXTENSION_NAME, VK_KHR_SWAPCHAIN_MUTABLE_FORMAT_SPEC_VERSION } },
 	{ { VK_KHR_FORMAT_FEATURE_FLAGS_2_EXTENSION_NAME, VK_KHR_FORMAT_FEATURE_FLAGS_2_SPEC_VERSION } },
 	{ { VK_KHR_VULKAN_MEMORY_MODEL_EXTENSION_NAME, VK_KHR_VULKAN_MEMORY_MODEL_SPEC_VERSION } },
+	{ { VK_KHR_16BIT_STORAGE_EXTENSION_NAME, VK_KHR_16BIT_STORAGE_SPEC_VERSION } },
+	{ { VK_KHR_8BIT_STORAGE_EXTENSION_NAME, VK_KHR_8BIT_STORAGE_SPEC_VERSION } },
+	{ { VK_KHR_SHADER_FLOAT16_INT8_EXTENSION_NAME, VK_KHR_SHADER_FLOAT16_INT8_SPEC_VERSION } },
 };
 
 static uint32_t numSupportedExtensions(const ExtensionProperties *extensionProperties, uint32_t extensionPropertiesCount)
@@ -586,6 +686,9 @@ VKAPI_ATTR void VKAPI_CALL vkDestroyInstance(VkInstance instance, const VkAlloca
 	TRACE("(VkInstance instance = %p, const VkAllocationCallbacks* pAllocator = %p)", instance, pAllocator);
 
 	vk::destroy(instance, pAllocator);
+
+	sw::Metrics::reportFromEnvironment(true);
+	sw::Trace::flush();
 }
 
 VKAPI_ATTR VkResult VKAPI_CALL vkEnumeratePhysicalDevices(VkInstance instance, uint32_t *pPhysicalDeviceCount, VkPhysicalDevice *pPhysicalDevices)
@@ -747,10 +850,8 @@ VKAPI_ATTR VkResult VKAPI_CALL vkCreateDevice(VkPhysicalDevice physicalDevice, c
 			{
 				const VkPhysicalDevice16BitStorageFeatures *storage16BitFeatures = reinterpret_cast<const VkPhysicalDevice16BitStorageFeatures *>(extensionCreateInfo);
 
-				if(storage16BitFeatures->storageBuffer16BitAccess != VK_FALSE ||
-				   storage16BitFeatures->uniformAndStorageBuffer16BitAccess != VK_FALSE ||
-				   storage16BitFeatures->storagePushConstant16 != VK_FALSE ||
-				   storage16BitFeatures->storageInputOutput16 != VK_FALSE)
+				// 16-bit buffer and push constant storage is supported; shader inputs and outputs remain 32-bit.
+				if(storage16BitFeatures->storageInputOutput16 != VK_FALSE)
 				{
 					return VK_ERROR_FEATURE_NOT_PRESENT;
 				}
@@ -942,6 +1043,9 @@ VKAPI_ATTR VkResult VKAPI_CALL vkCreateDevice(VkPhysicalDevice physicalDevice, c
 		case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_SUBGROUP_EXTENDED_TYPES_FEATURES:
 		case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_4444_FORMATS_FEATURES_EXT:
 		case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_MEMORY_MODEL_FEATURES:
+		case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_8BIT_STORAGE_FEATURES:
+		case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_FLOAT16_INT8_FEATURES:
+		case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES:
 			break;
 		default:
 			// "the [driver] must skip over, without processing (other than reading the sType and pNext members) any structures in the chain with sType values not defined by [supported extenions]"
@@ -1072,6 +1176,8 @@ VKAPI_ATTR VkResult VKAPI_CALL vkQueueSubmit(VkQueue queue, uint32_t submitCount
 	TRACE("(VkQueue queue = %p, uint32_t submitCount = %d, const VkSubmitInfo* pSubmits = %p, VkFence fence = %p)",
 	      queue, submitCount, pSubmits, static_cast<void *>(fence));
 
+	sw::Metrics::reportFromEnvironment();
+
 	return vk::Cast(queue)->submit(submitCount, pSubmits, vk::Cast(fence));
 }
 
@@ -1143,11 +1249,8 @@ VKAPI_ATTR VkResult VKAPI_CALL vkGetMemoryFdPropertiesKHR(VkDevice device, VkExt
 		return VK_ERROR_INVALID_EXTERNAL_HANDLE;
 	}
 
-	const VkPhysicalDeviceMemoryProperties &memoryProperties =
-	    vk::PhysicalDevice::GetMemoryProperties();
-
-	// All SwiftShader memory types support this!
-	pMemoryFdProperties->memoryTypeBits = (1U << memoryProperties.memoryTypeCount) - 1U;
+	// Imported memory is always committed, so it can't be lazily allocated.
+	pMemoryFdProperties->memoryTypeBits = vk::MEMORY_TYPE_GENERIC_BIT;
 
 	return VK_SUCCESS;
 }
@@ -1182,11 +1285,8 @@ VKAPI_ATTR VkResult VKAPI_CALL vkGetMemoryZirconHandlePropertiesFUCHSIA(VkDevice
 		return VK_ERROR_INVALID_EXTERNAL_HANDLE;
 	}
 
-	const VkPhysicalDeviceMemoryProperties &memoryProperties =
-	    vk::PhysicalDevice::GetMemoryProperties();
-
-	// All SwiftShader memory types support this!
-	pMemoryZirconHandleProperties->memoryTypeBits = (1U << memoryProperties.memoryTypeCount) - 1U;
+	// Imported memory is always committed, so it can't be lazily allocated.
+	pMemoryZirconHandleProperties->memoryTypeBits = vk::MEMORY_TYPE_GENERIC_BIT;
 
 	return VK_SUCCESS;
 }
@@ -1202,7 +1302,7 @@ VKAPI_ATTR VkResult VKAPI_CALL vkGetMemoryHostPointerPropertiesEXT(VkDevice devi
 		UNSUPPORTED("handleType %u", handleType);
 		return VK_ERROR_INVALID_EXTERNAL_HANDLE;
 	}
-	pMemoryHostPointerProperties->memoryTypeBits = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+	pMemoryHostPointerProperties->memoryTypeBits = vk::MEMORY_TYPE_GENERIC_BIT;
 
 	return VK_SUCCESS;
 }
@@ -1373,7 +1473,7 @@ VKAPI_ATTR VkResult VKAPI_CALL vkCreateFence(VkDevice device, const VkFenceCreat
 		nextInfo = nextInfo->pNext;
 	}
 
-	return vk::Fence::Create(pAllocator, pCreateInfo, pFence);
+	return vk::Fence::Create(vk::Cast(device)->getObjectPool(vk::ObjectPool::Type::Fence), pAllocator, pCreateInfo, pFence);
 }
 
 VKAPI_ATTR void VKAPI_CALL vkDestroyFence(VkDevice device, VkFence fence, const VkAllocationCallbacks *pAllocator)
@@ -1381,7 +1481,7 @@ VKAPI_ATTR void VKAPI_CALL vkDestroyFence(VkDevice device, VkFence fence, const
 	TRACE("(VkDevice device = %p, VkFence fence = %p, const VkAllocationCallbacks* pAllocator = %p)",
 	      device, static_cast<void *>(fence), pAllocator);
 
-	vk::destroy(fence, pAllocator);
+	vk::destroy(fence, pAllocator, vk::Cast(device)->getObjectPool(vk::ObjectPool::Type::Fence));
 }
 
 VKAPI_ATTR VkResult VKAPI_CALL vkResetFences(VkDevice device, uint32_t fenceCount, const VkFence *pFences)
@@ -1444,13 +1544,14 @@ VKAPI_ATTR VkResult VKAPI_CALL vkCreateSemaphore(VkDevice device, const VkSemaph
 		}
 	}
 
+	auto &pool = vk::Cast(device)->getObjectPool(vk::ObjectPool::Type::Semaphore);
 	if(type == VK_SEMAPHORE_TYPE_BINARY)
 	{
-		return vk::BinarySemaphore::Create(pAllocator, pCreateInfo, pSemaphore, pAllocator);
+		return vk::BinarySemaphore::Create(pool, pAllocator, pCreateInfo, pSemaphore, pAllocator);
 	}
 	else
 	{
-		return vk::TimelineSemaphore::Create(pAllocator, pCreateInfo, pSemaphore, pAllocator);
+		return vk::TimelineSemaphore::Create(pool, pAllocator, pCreateInfo, pSemaphore, pAllocator);
 	}
 }
 
@@ -1459,7 +1560,7 @@ VKAPI_ATTR void VKAPI_CALL vkDestroySemaphore(VkDevice device, VkSemaphore semap
 	TRACE("(VkDevice device = %p, VkSemaphore semaphore = %p, const VkAllocationCallbacks* pAllocator = %p)",
 	      device, static_cast<void *>(semaphore), pAllocator);
 
-	vk::destroy(semaphore, pAllocator);
+	vk::destroy(semaphore, pAllocator, vk::Cast(device)->getObjectPool(vk::ObjectPool::Type::Semaphore));
 }
 
 #if SWIFTSHADER_EXTERNAL_SEMAPHORE_OPAQUE_FD
@@ -1574,7 +1675,7 @@ VKAPI_ATTR VkResult VKAPI_CALL vkCreateEvent(VkDevice device, const VkEventCreat
 		extInfo = extInfo->pNext;
 	}
 
-	return vk::Event::Create(pAllocator, pCreateInfo, pEvent);
+	return vk::Event::Create(vk::Cast(device)->getObjectPool(vk::ObjectPool::Type::Event), pAllocator, pCreateInfo, pEvent);
 }
 
 VKAPI_ATTR void VKAPI_CALL vkDestroyEvent(VkDevice device, VkEvent event, const VkAllocationCallbacks *pAllocator)
@@ -1582,7 +1683,7 @@ VKAPI_ATTR void VKAPI_CALL vkDestroyEvent(VkDevice device, VkEvent event, const
 	TRACE("(VkDevice device = %p, VkEvent event = %p, const VkAllocationCallbacks* pAllocator = %p)",
 	      device, static_cast<void *>(event), pAllocator);
 
-	vk::destroy(event, pAllocator);
+	vk::destroy(event, pAllocator, vk::Cast(device)->getObjectPool(vk::ObjectPool::Type::Event));
 }
 
 VKAPI_ATTR VkResult VKAPI_CALL vkGetEventStatus(VkDevice device, VkEvent event)
@@ -1723,7 +1824,7 @@ VKAPI_ATTR VkResult VKAPI_CALL vkCreateBufferView(VkDevice device, const VkBuffe
 		extInfo = extInfo->pNext;
 	}
 
-	return vk::BufferView::Create(pAllocator, pCreateInfo, pView);
+	return vk::BufferView::Create(vk::Cast(device)->getObjectPool(vk::ObjectPool::Type::BufferView), pAllocator, pCreateInfo, pView);
 }
 
 VKAPI_ATTR void VKAPI_CALL vkDestroyBufferView(VkDevice device, VkBufferView bufferView, const VkAllocationCallbacks *pAllocator)
@@ -1731,7 +1832,7 @@ VKAPI_ATTR void VKAPI_CALL vkDestroyBufferView(VkDevice device, VkBufferView buf
 	TRACE("(VkDevice device = %p, VkBufferView bufferView = %p, const VkAllocationCallbacks* pAllocator = %p)",
 	      device, static_cast<void *>(bufferView), pAllocator);
 
-	vk::destroy(bufferView, pAllocator);
+	vk::destroy(bufferView, pAllocator, vk::Cast(device)->getObjectPool(vk::ObjectPool::Type::BufferView));
 }
 
 VKAPI_ATTR VkResult VKAPI_CALL vkCreateImage(VkDevice device, const VkImageCreateInfo *pCreateInfo, const VkAllocationCallbacks *pAllocator, VkImage *pImage)
@@ -1906,7 +2007,7 @@ VKAPI_ATTR VkResult VKAPI_CALL vkCreateImageView(VkDevice device, const VkImageV
 		extensionCreateInfo = extensionCreateInfo->pNext;
 	}
 
-	VkResult result = vk::ImageView::Create(pAllocator, pCreateInfo, pView, ycbcrConversion);
+	VkResult result = vk::ImageView::Create(vk::Cast(device)->getObjectPool(vk::ObjectPool::Type::ImageView), pAllocator, pCreateInfo, pView, ycbcrConversion);
 	if(result == VK_SUCCESS)
 	{
 		vk::Cast(device)->registerImageView(vk::Cast(*pView));
@@ -1921,7 +2022,7 @@ VKAPI_ATTR void VKAPI_CALL vkDestroyImageView(VkDevice device, VkImageView image
 	      device, static_cast<void *>(imageView), pAllocator);
 
 	vk::Cast(device)->unregisterImageView(vk::Cast(imageView));
-	vk::destroy(imageView, pAllocator);
+	vk::destroy(imageView, pAllocator, vk::Cast(device)->getObjectPool(vk::ObjectPool::Type::ImageView));
 }
 
 VKAPI_ATTR VkResult VKAPI_CALL vkCreateShaderModule(VkDevice device, const VkShaderModuleCreateInfo *pCreateInfo, const VkAllocationCallbacks *pAllocator, VkShaderModule *pShaderModule)
@@ -2199,7 +2300,7 @@ VKAPI_ATTR VkResult VKAPI_CALL vkCreateSampler(VkDevice device, const VkSamplerC
 	vk::SamplerState samplerState(pCreateInfo, ycbcrConversion, filteringPrecision, borderColor);
 	uint32_t samplerID = vk::Cast(device)->indexSampler(samplerState);
 
-	VkResult result = vk::Sampler::Create(pAllocator, pCreateInfo, pSampler, samplerState, samplerID);
+	VkResult result = vk::Sampler::Create(vk::Cast(device)->getObjectPool(vk::ObjectPool::Type::Sampler), pAllocator, pCreateInfo, pSampler, samplerState, samplerID);
 
 	if(*pSampler == VK_NULL_HANDLE)
 	{
@@ -2219,7 +2320,7 @@ VKAPI_ATTR void VKAPI_CALL vkDestroySampler(VkDevice device, VkSampler sampler,
 	{
 		vk::Cast(device)->removeSampler(*vk::Cast(sampler));
 
-		vk::destroy(sampler, pAllocator);
+		vk::destroy(sampler, pAllocator, vk::Cast(device)->getObjectPool(vk::ObjectPool::Type::Sampler));
 	}
 }
 
@@ -2234,8 +2335,8 @@ VKAPI_ATTR VkResult VKAPI_CALL vkCreateDescriptorSetLayout(VkDevice device, cons
 	{
 		switch(extensionCreateInfo->sType)
 		{
-		case VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT:
-			ASSERT(!vk::Cast(device)->hasExtension(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME));
+		case VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO:
+			// Handled in vk::DescriptorSetLayout's constructor.
 			break;
 		default:
 			UNSUPPORTED("pCreateInfo->pNext sType = %s", vk::Stringify(extensionCreateInfo->sType).c_str());
@@ -2298,14 +2399,32 @@ VKAPI_ATTR VkResult VKAPI_CALL vkAllocateDescriptorSets(VkDevice device, const V
 	TRACE("(VkDevice device = %p, const VkDescriptorSetAllocateInfo* pAllocateInfo = %p, VkDescriptorSet* pDescriptorSets = %p)",
 	      device, pAllocateInfo, pDescriptorSets);
 
+	const uint32_t *variableDescriptorCounts = nullptr;
+
 	auto extInfo = reinterpret_cast<VkBaseInStructure const *>(pAllocateInfo->pNext);
 	while(extInfo)
 	{
-		UNSUPPORTED("pAllocateInfo->pNext sType = %s", vk::Stringify(extInfo->sType).c_str());
+		switch(extInfo->sType)
+		{
+		case VK_STRUCTURE_TYPE_DESCRIPTOR_SET_VARIABLE_DESCRIPTOR_COUNT_ALLOCATE_INFO:
+			{
+				auto *variableDescriptorCountInfo = reinterpret_cast<const VkDescriptorSetVariableDescriptorCountAllocateInfo *>(extInfo);
+				if(variableDescriptorCountInfo->descriptorSetCount != 0)
+				{
+					ASSERT(variableDescriptorCountInfo->descriptorSetCount == pAllocateInfo->descriptorSetCount);
+					variableDescriptorCounts = variableDescriptorCountInfo->pDescriptorCounts;
+				}
+			}
+			break;
+		default:
+			UNSUPPORTED("pAllocateInfo->pNext sType = %s", vk::Stringify(extInfo->sType).c_str());
+			break;
+		}
+
 		extInfo = extInfo->pNext;
 	}
 
-	return vk::Cast(pAllocateInfo->descriptorPool)->allocateSets(pAllocateInfo->descriptorSetCount, pAllocateInfo->pSetLayouts, pDescriptorSets);
+	return vk::Cast(pAllocateInfo->descriptorPool)->allocateSets(pAllocateInfo->descriptorSetCount, pAllocateInfo->pSetLayouts, variableDescriptorCounts, pDescriptorSets);
 }
 
 VKAPI_ATTR VkResult VKAPI_CALL vkFreeDescriptorSets(VkDevice device, VkDescriptorPool descriptorPool, uint32_t descriptorSetCount, const VkDescriptorSet *pDescriptorSets)
@@ -2331,7 +2450,7 @@ VKAPI_ATTR VkResult VKAPI_CALL vkCreateFramebuffer(VkDevice device, const VkFram
 	TRACE("(VkDevice device = %p, const VkFramebufferCreateInfo* pCreateInfo = %p, const VkAllocationCallbacks* pAllocator = %p, VkFramebuffer* pFramebuffer = %p)",
 	      device, pCreateInfo, pAllocator, pFramebuffer);
 
-	return vk::Framebuffer::Create(pAllocator, pCreateInfo, pFramebuffer);
+	return vk::Framebuffer::Create(vk::Cast(device)->getObjectPool(vk::ObjectPool::Type::Framebuffer), pAllocator, pCreateInfo, pFramebuffer);
 }
 
 VKAPI_ATTR void VKAPI_CALL vkDestroyFramebuffer(VkDevice device, VkFramebuffer framebuffer, const VkAllocationCallbacks *pAllocator)
@@ -2339,7 +2458,7 @@ VKAPI_ATTR void VKAPI_CALL vkDestroyFramebuffer(VkDevice device, VkFramebuffer f
 	TRACE("(VkDevice device = %p, VkFramebuffer framebuffer = %p, const VkAllocationCallbacks* pAllocator = %p)",
 	      device, static_cast<void *>(framebuffer), pAllocator);
 
-	vk::destroy(framebuffer, pAllocator);
+	vk::destroy(framebuffer, pAllocator, vk::Cast(device)->getObjectPool(vk::ObjectPool::Type::Framebuffer));
 }
 
 VKAPI_ATTR VkResult VKAPI_CALL vkCreateRenderPass(VkDevice device, const VkRenderPassCreateInfo *pCreateInfo, const VkAllocationCallbacks *pAllocator, VkRenderPass *pRenderPass)
@@ -2636,14 +2755,16 @@ VKAPI_ATTR void VKAPI_CALL vkCmdDrawIndirectCount(VkCommandBuffer commandBuffer,
 {
 	TRACE("(VkCommandBuffer commandBuffer = %p, VkBuffer buffer = %p, VkDeviceSize offset = %d, VkBuffer countBuffer = %p, VkDeviceSize countBufferOffset = %d, uint32_t maxDrawCount = %d, uint32_t stride = %d",
 	      commandBuffer, static_cast<void *>(buffer), int(offset), static_cast<void *>(countBuffer), int(countBufferOffset), int(maxDrawCount), int(stride));
-	UNSUPPORTED("VK_KHR_draw_indirect_count");
+
+	vk::Cast(commandBuffer)->drawIndirectCount(vk::Cast(buffer), offset, vk::Cast(countBuffer), countBufferOffset, maxDrawCount, stride);
 }
 
 VKAPI_ATTR void VKAPI_CALL vkCmdDrawIndexedIndirectCount(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, VkBuffer countBuffer, VkDeviceSize countBufferOffset, uint32_t maxDrawCount, uint32_t stride)
 {
 	TRACE("(VkCommandBuffer commandBuffer = %p, VkBuffer buffer = %p, VkDeviceSize offset = %d, VkBuffer countBuffer = %p, VkDeviceSize countBufferOffset = %d, uint32_t maxDrawCount = %d, uint32_t stride = %d",
 	      commandBuffer, static_cast<void *>(buffer), int(offset), static_cast<void *>(countBuffer), int(countBufferOffset), int(maxDrawCount), int(stride));
-	UNSUPPORTED("VK_KHR_draw_indirect_count");
+
+	vk::Cast(commandBuffer)->drawIndexedIndirectCount(vk::Cast(buffer), offset, vk::Cast(countBuffer), countBufferOffset, maxDrawCount, stride);
 }
 
 VKAPI_ATTR void VKAPI_CALL vkCmdDispatch(VkCommandBuffer commandBuffer, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ)
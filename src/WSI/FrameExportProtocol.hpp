@@ -0,0 +1,64 @@
+// Copyright 2021 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SWIFTSHADER_FRAMEEXPORTPROTOCOL_HPP_
+#define SWIFTSHADER_FRAMEEXPORTPROTOCOL_HPP_
+
+#include <cstdint>
+
+// Wire format used by headless surfaces to hand presented frames to another
+// process without copying them.
+//
+// When the SWIFTSHADER_FRAME_EXPORT_SOCKET environment variable names a
+// listening SOCK_SEQPACKET Unix domain socket, each headless surface connects
+// to it and allocates its swapchain images from memfd-backed memory. Every
+// message is a single FrameExportMessage, optionally carrying one file
+// descriptor as SCM_RIGHTS ancillary data:
+//
+//  - FRAME_EXPORT_ATTACH carries the memfd holding a swapchain image. The
+//    pixels start at offset 0, with rowPitch bytes between rows.
+//  - FRAME_EXPORT_DETACH is sent once the image's buffer is no longer used.
+//  - FRAME_EXPORT_PRESENT announces that the buffer holds a complete frame. It
+//    carries a release fence: an eventfd the consumer must write to once it
+//    has finished reading the buffer. The image isn't handed back to the
+//    application for rendering before then.
+//
+// This header has no dependencies, so consumers may include it directly.
+
+namespace sw {
+
+enum FrameExportMessageType : uint32_t
+{
+	FRAME_EXPORT_ATTACH = 1,
+	FRAME_EXPORT_DETACH = 2,
+	FRAME_EXPORT_PRESENT = 3,
+};
+
+struct FrameExportMessage
+{
+	uint32_t type;  // FrameExportMessageType
+	uint32_t bufferIndex;
+	uint32_t width;
+	uint32_t height;
+	uint32_t rowPitch;  // In bytes
+	uint32_t format;    // VkFormat
+	uint64_t size;      // Size of the buffer, in bytes
+	uint64_t frameNumber;
+};
+
+constexpr const char *FrameExportSocketEnvironmentVariable = "SWIFTSHADER_FRAME_EXPORT_SOCKET";
+
+}  // namespace sw
+
+#endif  // SWIFTSHADER_FRAMEEXPORTPROTOCOL_HPP_
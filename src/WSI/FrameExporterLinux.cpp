@@ -0,0 +1,325 @@
+// Copyright 2021 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "FrameExporterLinux.hpp"
+
+#include "VkSurfaceKHR.hpp"
+#include "System/Debug.hpp"
+#include "Vulkan/VkDeviceMemory.hpp"
+#include "Vulkan/VkImage.hpp"
+
+#include "marl/blockingcall.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+// Converts a Vulkan timeout in nanoseconds to a poll() timeout, rounding up.
+int pollTimeout(uint64_t timeout)
+{
+	if(timeout == UINT64_MAX)
+	{
+		return -1;  // Wait indefinitely
+	}
+
+	uint64_t milliseconds = (timeout + 999999) / 1000000;
+	return static_cast<int>(std::min<uint64_t>(milliseconds, INT_MAX));
+}
+
+}  // anonymous namespace
+
+namespace vk {
+
+std::unique_ptr<FrameExporter> FrameExporter::CreateFromEnvironment()
+{
+	const char *path = getenv(sw::FrameExportSocketEnvironmentVariable);
+	if(!path || !*path)
+	{
+		return nullptr;
+	}
+
+	sockaddr_un address = {};
+	address.sun_family = AF_UNIX;
+	if(strlen(path) >= sizeof(address.sun_path))
+	{
+		WARN("Frame export socket path too long: %s", path);
+		return nullptr;
+	}
+	strcpy(address.sun_path, path);
+
+	int fd = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+	if(fd < 0)
+	{
+		return nullptr;
+	}
+
+	if(connect(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0)
+	{
+		WARN("Failed to connect to frame export socket %s: %s", path, strerror(errno));
+		close(fd);
+		return nullptr;
+	}
+
+	return std::unique_ptr<FrameExporter>(new FrameExporter(fd));
+}
+
+FrameExporter::FrameExporter(int socket)
+    : socket(socket)
+{
+}
+
+FrameExporter::~FrameExporter()
+{
+	disconnect();
+}
+
+void FrameExporter::attachImage(PresentImage *image)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+
+	uint32_t bufferIndex = nextBufferIndex++;
+	bufferIndices[image] = bufferIndex;
+
+	if(socket < 0)
+	{
+		return;
+	}
+
+	int memoryFd = -1;
+	if(image->getImageMemory()->exportFd(&memoryFd) != VK_SUCCESS)
+	{
+		WARN("Failed to export swapchain image memory");
+		disconnect();
+		return;
+	}
+
+	const Image *vkImage = image->getImage();
+	const VkExtent3D &extent = vkImage->getExtent();
+
+	sw::FrameExportMessage message = {};
+	message.type = sw::FRAME_EXPORT_ATTACH;
+	message.bufferIndex = bufferIndex;
+	message.width = extent.width;
+	message.height = extent.height;
+	message.rowPitch = vkImage->rowPitchBytes(VK_IMAGE_ASPECT_COLOR_BIT, 0);
+	message.format = vkImage->getFormat(VK_IMAGE_ASPECT_COLOR_BIT);
+	message.size = image->getImageMemory()->getCommittedMemoryInBytes();
+
+	send(message, memoryFd);
+	close(memoryFd);
+}
+
+void FrameExporter::detachImage(PresentImage *image)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+
+	auto it = bufferIndices.find(image);
+	if(it == bufferIndices.end())
+	{
+		return;
+	}
+
+	sw::FrameExportMessage message = {};
+	message.type = sw::FRAME_EXPORT_DETACH;
+	message.bufferIndex = it->second;
+	bufferIndices.erase(it);
+	closeReleaseFd(image);
+
+	send(message, -1);
+}
+
+void FrameExporter::present(PresentImage *image)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+
+	auto it = bufferIndices.find(image);
+	if(socket < 0 || it == bufferIndices.end())
+	{
+		return;
+	}
+
+	int releaseFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+	if(releaseFd < 0)
+	{
+		return;
+	}
+
+	sw::FrameExportMessage message = {};
+	message.type = sw::FRAME_EXPORT_PRESENT;
+	message.bufferIndex = it->second;
+	message.frameNumber = frameNumber++;
+
+	if(send(message, releaseFd))
+	{
+		// The image can't be handed back to the application for rendering
+		// until the consumer has finished reading it. isReleased() checks
+		// this when the image is next acquired.
+		closeReleaseFd(image);
+		releaseFds[image] = releaseFd;
+	}
+	else
+	{
+		close(releaseFd);
+	}
+}
+
+bool FrameExporter::isReleased(PresentImage *image)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+
+	auto it = releaseFds.find(image);
+	if(it == releaseFds.end())
+	{
+		return true;
+	}
+
+	uint64_t value = 0;
+	if(read(it->second, &value, sizeof(value)) == sizeof(value))
+	{
+		close(it->second);
+		releaseFds.erase(it);
+		return true;
+	}
+
+	return false;
+}
+
+bool FrameExporter::waitForRelease(uint64_t timeout)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+
+	if(releaseFds.empty())
+	{
+		return false;
+	}
+
+	std::vector<pollfd> fds;
+	fds.reserve(releaseFds.size() + 1);
+	for(auto &releaseFd : releaseFds)
+	{
+		fds.push_back({ releaseFd.second, POLLIN, 0 });
+	}
+	fds.push_back({ socket, 0, 0 });  // Only reports POLLHUP and POLLERR
+
+	int result = marl::blocking_call([&fds, timeout]() {
+		int result;
+		do
+		{
+			result = poll(fds.data(), fds.size(), pollTimeout(timeout));
+		} while(result < 0 && errno == EINTR);
+		return result;
+	});
+
+	if(result <= 0)
+	{
+		return false;
+	}
+
+	if(fds.back().revents != 0)
+	{
+		// The consumer has gone away, so nothing is reading the images anymore.
+		WARN("Frame export consumer disconnected");
+		disconnect();
+	}
+
+	return true;
+}
+
+void FrameExporter::closeReleaseFd(PresentImage *image)
+{
+	auto it = releaseFds.find(image);
+	if(it != releaseFds.end())
+	{
+		close(it->second);
+		releaseFds.erase(it);
+	}
+}
+
+bool FrameExporter::send(const sw::FrameExportMessage &message, int fd)
+{
+	if(socket < 0)
+	{
+		return false;
+	}
+
+	iovec iov = {};
+	iov.iov_base = const_cast<sw::FrameExportMessage *>(&message);
+	iov.iov_len = sizeof(message);
+
+	union
+	{
+		cmsghdr header;
+		char buffer[CMSG_SPACE(sizeof(int))];
+	} control = {};
+
+	msghdr msg = {};
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+
+	if(fd >= 0)
+	{
+		msg.msg_control = control.buffer;
+		msg.msg_controllen = sizeof(control.buffer);
+
+		cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+		cmsg->cmsg_level = SOL_SOCKET;
+		cmsg->cmsg_type = SCM_RIGHTS;
+		cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+		memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+	}
+
+	ssize_t sent;
+	do
+	{
+		sent = sendmsg(socket, &msg, MSG_NOSIGNAL);
+	} while(sent < 0 && errno == EINTR);
+
+	if(sent != static_cast<ssize_t>(sizeof(message)))
+	{
+		disconnect();
+		return false;
+	}
+
+	return true;
+}
+
+void FrameExporter::disconnect()
+{
+	if(socket >= 0)
+	{
+		close(socket);
+		socket = -1;
+	}
+
+	// Images presented to a consumer which is no longer connected are never
+	// released by it.
+	for(auto &releaseFd : releaseFds)
+	{
+		close(releaseFd.second);
+	}
+	releaseFds.clear();
+}
+
+}  // namespace vk
@@ -0,0 +1,72 @@
+// Copyright 2021 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SWIFTSHADER_FRAMEEXPORTERLINUX_HPP_
+#define SWIFTSHADER_FRAMEEXPORTERLINUX_HPP_
+
+#include "FrameExportProtocol.hpp"
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace vk {
+
+class PresentImage;
+
+// FrameExporter publishes the swapchain images of a headless surface to a
+// consumer process, following the protocol in FrameExportProtocol.hpp.
+class FrameExporter
+{
+public:
+	// Connects to the socket named by SWIFTSHADER_FRAME_EXPORT_SOCKET.
+	// Returns nullptr if the variable isn't set or the connection fails.
+	static std::unique_ptr<FrameExporter> CreateFromEnvironment();
+
+	~FrameExporter();
+
+	// The image's memory must have been allocated with the
+	// VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT export handle type.
+	void attachImage(PresentImage *image);
+	void detachImage(PresentImage *image);
+
+	// Publishes the image without waiting for the consumer to read it.
+	void present(PresentImage *image);
+
+	// Returns false while the consumer still reads the image it was last
+	// presented with.
+	bool isReleased(PresentImage *image);
+
+	// Waits up to timeout nanoseconds for the consumer to release any of the
+	// presented images. Returns false on timeout or when no image is pending.
+	bool waitForRelease(uint64_t timeout);
+
+private:
+	explicit FrameExporter(int socket);
+
+	bool send(const sw::FrameExportMessage &message, int fd);
+	void disconnect();
+	void closeReleaseFd(PresentImage *image);
+
+	std::mutex mutex;
+	int socket = -1;  // -1 once the consumer has gone away
+	std::unordered_map<PresentImage *, uint32_t> bufferIndices;
+	std::unordered_map<PresentImage *, int> releaseFds;  // Signaled by the consumer
+	uint32_t nextBufferIndex = 0;
+	uint64_t frameNumber = 0;
+};
+
+}  // namespace vk
+
+#endif  // SWIFTSHADER_FRAMEEXPORTERLINUX_HPP_
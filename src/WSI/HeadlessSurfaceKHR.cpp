@@ -18,6 +18,9 @@ namespace vk {
 
 HeadlessSurfaceKHR::HeadlessSurfaceKHR(const VkHeadlessSurfaceCreateInfoEXT *pCreateInfo, void *mem)
 {
+#if SWIFTSHADER_HEADLESS_FRAME_EXPORT
+	exporter = FrameExporter::CreateFromEnvironment();
+#endif
 }
 
 size_t HeadlessSurfaceKHR::ComputeRequiredAllocationSize(const VkHeadlessSurfaceCreateInfoEXT *pCreateInfo)
@@ -27,6 +30,9 @@ size_t HeadlessSurfaceKHR::ComputeRequiredAllocationSize(const VkHeadlessSurface
 
 void HeadlessSurfaceKHR::destroySurface(const VkAllocationCallbacks *pAllocator)
 {
+#if SWIFTSHADER_HEADLESS_FRAME_EXPORT
+	exporter.reset();
+#endif
 }
 
 VkResult HeadlessSurfaceKHR::getSurfaceCapabilities(VkSurfaceCapabilitiesKHR *pSurfaceCapabilities) const
@@ -44,15 +50,70 @@ VkResult HeadlessSurfaceKHR::getSurfaceCapabilities(VkSurfaceCapabilitiesKHR *pS
 
 void HeadlessSurfaceKHR::attachImage(PresentImage *image)
 {
+#if SWIFTSHADER_HEADLESS_FRAME_EXPORT
+	if(exporter)
+	{
+		exporter->attachImage(image);
+	}
+#endif
 }
 
 void HeadlessSurfaceKHR::detachImage(PresentImage *image)
 {
+#if SWIFTSHADER_HEADLESS_FRAME_EXPORT
+	if(exporter)
+	{
+		exporter->detachImage(image);
+	}
+#endif
 }
 
 VkResult HeadlessSurfaceKHR::present(PresentImage *image)
 {
+#if SWIFTSHADER_HEADLESS_FRAME_EXPORT
+	if(exporter)
+	{
+		exporter->present(image);
+	}
+#endif
+
 	return VK_SUCCESS;
 }
 
+bool HeadlessSurfaceKHR::isImageReleased(PresentImage *image)
+{
+#if SWIFTSHADER_HEADLESS_FRAME_EXPORT
+	if(exporter)
+	{
+		return exporter->isReleased(image);
+	}
+#endif
+
+	return true;
+}
+
+bool HeadlessSurfaceKHR::waitForImageRelease(uint64_t timeout)
+{
+#if SWIFTSHADER_HEADLESS_FRAME_EXPORT
+	if(exporter)
+	{
+		return exporter->waitForRelease(timeout);
+	}
+#endif
+
+	return false;
+}
+
+VkExternalMemoryHandleTypeFlags HeadlessSurfaceKHR::getImageMemoryExportHandleTypes() const
+{
+#if SWIFTSHADER_HEADLESS_FRAME_EXPORT
+	if(exporter)
+	{
+		return VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT;
+	}
+#endif
+
+	return 0;
+}
+
 }  // namespace vk
\ No newline at end of file
@@ -17,6 +17,10 @@
 
 #include "VkSurfaceKHR.hpp"
 
+#if SWIFTSHADER_HEADLESS_FRAME_EXPORT
+#	include "FrameExporterLinux.hpp"
+#endif
+
 namespace vk {
 
 class HeadlessSurfaceKHR : public SurfaceKHR, public ObjectBase<HeadlessSurfaceKHR, VkSurfaceKHR>
@@ -31,6 +35,15 @@ public:
 	void attachImage(PresentImage *image) override;
 	void detachImage(PresentImage *image) override;
 	VkResult present(PresentImage *image) override;
+	bool isImageReleased(PresentImage *image) override;
+	bool waitForImageRelease(uint64_t timeout) override;
+	VkExternalMemoryHandleTypeFlags getImageMemoryExportHandleTypes() const override;
+
+private:
+#if SWIFTSHADER_HEADLESS_FRAME_EXPORT
+	// Set when frames are published to another process.
+	std::unique_ptr<FrameExporter> exporter;
+#endif
 };
 
 }  // namespace vk
@@ -91,6 +91,18 @@ public:
 	virtual void detachImage(PresentImage *image) = 0;
 	virtual VkResult present(PresentImage *image) = 0;
 
+	// Returns false while the presentation engine still reads the image, which
+	// keeps it from being acquired.
+	virtual bool isImageReleased(PresentImage *image) { return true; }
+
+	// Waits up to timeout nanoseconds for any presented image to be released.
+	// Returns false on timeout or when no image is being read.
+	virtual bool waitForImageRelease(uint64_t timeout) { return false; }
+
+	// Returns the external memory handle types the swapchain images' memory
+	// must be exportable to.
+	virtual VkExternalMemoryHandleTypeFlags getImageMemoryExportHandleTypes() const { return 0; }
+
 	void associateSwapchain(SwapchainKHR *swapchain);
 	void disassociateSwapchain();
 	bool hasAssociatedSwapchain();
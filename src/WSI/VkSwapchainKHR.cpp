@@ -20,6 +20,7 @@
 #include "Vulkan/VkSemaphore.hpp"
 
 #include <algorithm>
+#include <chrono>
 #include <cstring>
 
 namespace vk {
@@ -127,6 +128,14 @@ VkResult SwapchainKHR::createImages(VkDevice device, const VkSwapchainCreateInfo
 	allocInfo.allocationSize = 0;
 	allocInfo.memoryTypeIndex = 0;
 
+	VkExportMemoryAllocateInfo exportInfo = {};
+	exportInfo.sType = VK_STRUCTURE_TYPE_EXPORT_MEMORY_ALLOCATE_INFO;
+	exportInfo.handleTypes = surface->getImageMemoryExportHandleTypes();
+	if(exportInfo.handleTypes != 0)
+	{
+		allocInfo.pNext = &exportInfo;
+	}
+
 	VkResult status;
 	for(uint32_t i = 0; i < imageCount; i++)
 	{
@@ -177,29 +186,51 @@ VkResult SwapchainKHR::getImages(uint32_t *pSwapchainImageCount, VkImage *pSwapc
 
 VkResult SwapchainKHR::getNextImage(uint64_t timeout, BinarySemaphore *semaphore, Fence *fence, uint32_t *pImageIndex)
 {
-	for(uint32_t i = 0; i < imageCount; i++)
+	const auto start = std::chrono::steady_clock::now();
+
+	while(true)
 	{
-		PresentImage &currentImage = images[i];
-		if(currentImage.isAvailable())
+		for(uint32_t i = 0; i < imageCount; i++)
 		{
-			currentImage.setStatus(DRAWING);
-			*pImageIndex = i;
-
-			if(semaphore)
+			PresentImage &currentImage = images[i];
+			if(currentImage.isAvailable() && surface->isImageReleased(&currentImage))
 			{
-				semaphore->signal();
-			}
+				currentImage.setStatus(DRAWING);
+				*pImageIndex = i;
 
-			if(fence)
-			{
-				fence->complete();
+				if(semaphore)
+				{
+					semaphore->signal();
+				}
+
+				if(fence)
+				{
+					fence->complete();
+				}
+
+				return VK_SUCCESS;
 			}
+		}
 
-			return VK_SUCCESS;
+		if(timeout == 0)
+		{
+			return VK_NOT_READY;
 		}
-	}
 
-	return (timeout > 0) ? VK_TIMEOUT : VK_NOT_READY;
+		// Wait for the presentation engine to release an image, if it still
+		// reads any.
+		uint64_t remaining = timeout;
+		if(timeout != UINT64_MAX)
+		{
+			uint64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+			remaining = (elapsed < timeout) ? (timeout - elapsed) : 0;
+		}
+
+		if(remaining == 0 || !surface->waitForImageRelease(remaining))
+		{
+			return VK_TIMEOUT;
+		}
+	}
 }
 
 VkResult SwapchainKHR::present(uint32_t index)
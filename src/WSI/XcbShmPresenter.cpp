@@ -0,0 +1,137 @@
+// Copyright 2021 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "XcbShmPresenter.hpp"
+
+#include "VkSurfaceKHR.hpp"
+#include "Vulkan/VkDeviceMemory.hpp"
+#include "Vulkan/VkImage.hpp"
+
+#include <cstdlib>
+
+namespace vk {
+
+bool XcbShmPresenter::isSupported(xcb_connection_t *connection)
+{
+	if(!libXCB->xcb_shm_query_version || !libXCB->xcb_shm_id || !libXCB->xcb_get_extension_data)
+	{
+		return false;
+	}
+
+	// Sending an MIT-SHM request to a server without the extension would make
+	// libxcb shut down the connection, so check that the server has it first.
+	const xcb_query_extension_reply_t *extension = libXCB->xcb_get_extension_data(connection, libXCB->xcb_shm_id);
+	if(!extension || !extension->present)
+	{
+		return false;
+	}
+
+	auto cookie = libXCB->xcb_shm_query_version(connection);
+	auto *reply = libXCB->xcb_shm_query_version_reply(connection, cookie, nullptr);
+	if(!reply)
+	{
+		return false;
+	}
+
+	bool supported = (reply->major_version > 1) || (reply->major_version == 1 && reply->minor_version >= 2);
+	free(reply);
+
+	return supported;
+}
+
+XcbShmPresenter::XcbShmPresenter(xcb_connection_t *connection)
+    : connection(connection)
+{
+}
+
+XcbShmPresenter::~XcbShmPresenter()
+{
+	for(auto &segment : segments)
+	{
+		libXCB->xcb_shm_detach(connection, segment.second);
+	}
+
+	libXCB->xcb_flush(connection);
+}
+
+bool XcbShmPresenter::attachImage(PresentImage *image)
+{
+	int fd = -1;
+	if(image->getImageMemory()->exportFd(&fd) != VK_SUCCESS)
+	{
+		return false;
+	}
+
+	// The X server takes ownership of the file descriptor.
+	xcb_shm_seg_t segment = libXCB->xcb_generate_id(connection);
+	auto cookie = libXCB->xcb_shm_attach_fd_checked(connection, segment, fd, true /* read_only */);
+	if(xcb_generic_error_t *error = libXCB->xcb_request_check(connection, cookie))
+	{
+		free(error);
+		return false;
+	}
+
+	segments[image] = segment;
+
+	return true;
+}
+
+void XcbShmPresenter::detachImage(PresentImage *image)
+{
+	auto it = segments.find(image);
+	if(it != segments.end())
+	{
+		libXCB->xcb_shm_detach(connection, it->second);
+		libXCB->xcb_flush(connection);
+		segments.erase(it);
+	}
+}
+
+bool XcbShmPresenter::present(PresentImage *image, xcb_drawable_t window, xcb_gcontext_t gc, uint8_t depth)
+{
+	auto it = segments.find(image);
+	if(it == segments.end())
+	{
+		return false;
+	}
+
+	const VkExtent3D &extent = image->getImage()->getExtent();
+	int stride = image->getImage()->rowPitchBytes(VK_IMAGE_ASPECT_COLOR_BIT, 0);
+	int bytesPerPixel = static_cast<int>(image->getImage()->getFormat(VK_IMAGE_ASPECT_COLOR_BIT).bytes());
+
+	libXCB->xcb_shm_put_image(
+	    connection,
+	    window,
+	    gc,
+	    stride / bytesPerPixel,  // total_width
+	    extent.height,           // total_height
+	    0, 0,                    // src x, y
+	    extent.width,
+	    extent.height,
+	    0, 0,  // dst x, y
+	    depth,
+	    XCB_IMAGE_FORMAT_Z_PIXMAP,
+	    0,  // send_event
+	    it->second,
+	    0);  // offset
+
+	// The server reads the segment asynchronously. Make a round trip so it is
+	// done with the image before it can be handed back to the application.
+	auto cookie = libXCB->xcb_get_geometry(connection, window);
+	free(libXCB->xcb_get_geometry_reply(connection, cookie, nullptr));
+
+	return true;
+}
+
+}  // namespace vk
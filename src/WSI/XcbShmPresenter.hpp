@@ -0,0 +1,56 @@
+// Copyright 2021 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SWIFTSHADER_XCBSHMPRESENTER_HPP
+#define SWIFTSHADER_XCBSHMPRESENTER_HPP
+
+#include "libXCB.hpp"
+
+#include <unordered_map>
+
+namespace vk {
+
+class PresentImage;
+
+// XcbShmPresenter presents swapchain images through the MIT-SHM extension.
+// The images' memfd-backed memory is attached to the X server as shared
+// memory segments, so presenting a frame doesn't copy it over the socket.
+// Used by both the XCB and Xlib surfaces.
+class XcbShmPresenter
+{
+public:
+	// Returns true if the X server supports MIT-SHM 1.2, which can attach
+	// segments passed as file descriptors. This is false for remote servers.
+	static bool isSupported(xcb_connection_t *connection);
+
+	explicit XcbShmPresenter(xcb_connection_t *connection);
+	~XcbShmPresenter();
+
+	// Shares the image's memory with the X server. Returns false if the
+	// server refused the segment, in which case the image must be presented
+	// by copying it.
+	bool attachImage(PresentImage *image);
+	void detachImage(PresentImage *image);
+
+	// Returns false if the image wasn't attached.
+	bool present(PresentImage *image, xcb_drawable_t window, xcb_gcontext_t gc, uint8_t depth);
+
+private:
+	xcb_connection_t *connection;
+	std::unordered_map<PresentImage *, xcb_shm_seg_t> segments;
+};
+
+}  // namespace vk
+
+#endif  // SWIFTSHADER_XCBSHMPRESENTER_HPP
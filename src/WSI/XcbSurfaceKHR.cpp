@@ -46,6 +46,11 @@ XcbSurfaceKHR::XcbSurfaceKHR(const VkXcbSurfaceCreateInfoKHR *pCreateInfo, void
     , window(pCreateInfo->window)
 {
 	ASSERT(isSupported());
+
+	if(XcbShmPresenter::isSupported(connection))
+	{
+		shmPresenter = std::make_unique<XcbShmPresenter>(connection);
+	}
 }
 
 void XcbSurfaceKHR::destroySurface(const VkAllocationCallbacks *pAllocator)
@@ -74,6 +79,12 @@ VkResult XcbSurfaceKHR::getSurfaceCapabilities(VkSurfaceCapabilitiesKHR *pSurfac
 	return VK_SUCCESS;
 }
 
+VkExternalMemoryHandleTypeFlags XcbSurfaceKHR::getImageMemoryExportHandleTypes() const
+{
+	// Sharing the images with the X server requires file descriptor backed memory.
+	return shmPresenter ? VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT : 0;
+}
+
 void XcbSurfaceKHR::attachImage(PresentImage *image)
 {
 	auto gc = libXCB->xcb_generate_id(connection);
@@ -82,10 +93,20 @@ void XcbSurfaceKHR::attachImage(PresentImage *image)
 	libXCB->xcb_create_gc(connection, gc, window, XCB_GC_FOREGROUND | XCB_GC_BACKGROUND, values);
 
 	graphicsContexts[image] = gc;
+
+	if(shmPresenter)
+	{
+		shmPresenter->attachImage(image);
+	}
 }
 
 void XcbSurfaceKHR::detachImage(PresentImage *image)
 {
+	if(shmPresenter)
+	{
+		shmPresenter->detachImage(image);
+	}
+
 	auto it = graphicsContexts.find(image);
 	if(it != graphicsContexts.end())
 	{
@@ -114,6 +135,11 @@ VkResult XcbSurfaceKHR::present(PresentImage *image)
 		}
 
 		// TODO: Convert image if not RGB888.
+		if(shmPresenter && shmPresenter->present(image, window, it->second, depth))
+		{
+			return VK_SUCCESS;
+		}
+
 		int stride = image->getImage()->rowPitchBytes(VK_IMAGE_ASPECT_COLOR_BIT, 0);
 		int bytesPerPixel = static_cast<int>(image->getImage()->getFormat(VK_IMAGE_ASPECT_COLOR_BIT).bytes());
 		int width = stride / bytesPerPixel;
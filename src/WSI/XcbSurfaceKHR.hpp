@@ -16,11 +16,13 @@
 #define SWIFTSHADER_XCBSURFACEKHR_HPP
 
 #include "VkSurfaceKHR.hpp"
+#include "XcbShmPresenter.hpp"
 #include "Vulkan/VkObject.hpp"
 
 #include <vulkan/vulkan_xcb.h>
 #include <xcb/xcb.h>
 
+#include <memory>
 #include <unordered_map>
 
 namespace vk {
@@ -36,6 +38,7 @@ public:
 	static size_t ComputeRequiredAllocationSize(const VkXcbSurfaceCreateInfoKHR *pCreateInfo);
 
 	VkResult getSurfaceCapabilities(VkSurfaceCapabilitiesKHR *pSurfaceCapabilities) const override;
+	VkExternalMemoryHandleTypeFlags getImageMemoryExportHandleTypes() const override;
 
 	virtual void attachImage(PresentImage *image) override;
 	virtual void detachImage(PresentImage *image) override;
@@ -45,6 +48,7 @@ private:
 	xcb_connection_t *connection;
 	xcb_window_t window;
 	std::unordered_map<PresentImage *, uint32_t> graphicsContexts;
+	std::unique_ptr<XcbShmPresenter> shmPresenter;  // Null if MIT-SHM is unavailable
 };
 
 }  // namespace vk
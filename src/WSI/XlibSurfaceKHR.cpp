@@ -17,6 +17,10 @@
 #include "Vulkan/VkDeviceMemory.hpp"
 #include "Vulkan/VkImage.hpp"
 
+#ifdef VK_USE_PLATFORM_XCB_KHR
+#	include "libXCB.hpp"
+#endif
+
 namespace vk {
 
 bool XlibSurfaceKHR::isSupported()
@@ -37,10 +41,38 @@ XlibSurfaceKHR::XlibSurfaceKHR(const VkXlibSurfaceCreateInfoKHR *pCreateInfo, vo
 	Status status = libX11->XMatchVisualInfo(pDisplay, screen, 32, TrueColor, &xVisual);
 	bool match = (status != 0 && xVisual.blue_mask == 0xFF);
 	visual = match ? xVisual.visual : libX11->XDefaultVisual(pDisplay, screen);
+
+#ifdef VK_USE_PLATFORM_XCB_KHR
+	if(libX11->XGetXCBConnection && libXCB.isPresent())
+	{
+		connection = libX11->XGetXCBConnection(pDisplay);
+
+		if(XcbShmPresenter::isSupported(connection))
+		{
+			XWindowAttributes attr;
+			libX11->XGetWindowAttributes(pDisplay, window, &attr);
+			depth = attr.depth;
+
+			shmGC = libXCB->xcb_generate_id(connection);
+			uint32_t values[2] = { 0, 0xffffffff };
+			libXCB->xcb_create_gc(connection, shmGC, window, XCB_GC_FOREGROUND | XCB_GC_BACKGROUND, values);
+
+			shmPresenter = std::make_unique<XcbShmPresenter>(connection);
+		}
+	}
+#endif
 }
 
 void XlibSurfaceKHR::destroySurface(const VkAllocationCallbacks *pAllocator)
 {
+#ifdef VK_USE_PLATFORM_XCB_KHR
+	if(shmPresenter)
+	{
+		shmPresenter.reset();
+		libXCB->xcb_free_gc(connection, shmGC);
+		libXCB->xcb_flush(connection);
+	}
+#endif
 }
 
 size_t XlibSurfaceKHR::ComputeRequiredAllocationSize(const VkXlibSurfaceCreateInfoKHR *pCreateInfo)
@@ -62,6 +94,19 @@ VkResult XlibSurfaceKHR::getSurfaceCapabilities(VkSurfaceCapabilitiesKHR *pSurfa
 	return VK_SUCCESS;
 }
 
+VkExternalMemoryHandleTypeFlags XlibSurfaceKHR::getImageMemoryExportHandleTypes() const
+{
+#ifdef VK_USE_PLATFORM_XCB_KHR
+	// Sharing the images with the X server requires file descriptor backed memory.
+	if(shmPresenter)
+	{
+		return VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT;
+	}
+#endif
+
+	return 0;
+}
+
 void XlibSurfaceKHR::attachImage(PresentImage *image)
 {
 	XWindowAttributes attr;
@@ -75,10 +120,24 @@ void XlibSurfaceKHR::attachImage(PresentImage *image)
 	XImage *xImage = libX11->XCreateImage(pDisplay, visual, attr.depth, ZPixmap, 0, buffer, extent.width, extent.height, 32, bytes_per_line);
 
 	imageMap[image] = xImage;
+
+#ifdef VK_USE_PLATFORM_XCB_KHR
+	if(shmPresenter)
+	{
+		shmPresenter->attachImage(image);
+	}
+#endif
 }
 
 void XlibSurfaceKHR::detachImage(PresentImage *image)
 {
+#ifdef VK_USE_PLATFORM_XCB_KHR
+	if(shmPresenter)
+	{
+		shmPresenter->detachImage(image);
+	}
+#endif
+
 	auto it = imageMap.find(image);
 	if(it != imageMap.end())
 	{
@@ -108,6 +167,19 @@ VkResult XlibSurfaceKHR::present(PresentImage *image)
 				return VK_ERROR_OUT_OF_DATE_KHR;
 			}
 
+#ifdef VK_USE_PLATFORM_XCB_KHR
+			if(shmPresenter)
+			{
+				// Flush requests Xlib has buffered so they are ordered before ours.
+				libX11->XFlush(pDisplay);
+
+				if(shmPresenter->present(image, window, shmGC, depth))
+				{
+					return VK_SUCCESS;
+				}
+			}
+#endif
+
 			libX11->XPutImage(pDisplay, window, gc, xImage, 0, 0, 0, 0, extent.width, extent.height);
 		}
 	}
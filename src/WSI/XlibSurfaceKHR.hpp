@@ -21,6 +21,11 @@
 
 #include <vulkan/vulkan_xlib.h>
 
+#ifdef VK_USE_PLATFORM_XCB_KHR
+#	include "XcbShmPresenter.hpp"
+#endif
+
+#include <memory>
 #include <unordered_map>
 
 namespace vk {
@@ -36,6 +41,7 @@ public:
 	static size_t ComputeRequiredAllocationSize(const VkXlibSurfaceCreateInfoKHR *pCreateInfo);
 
 	VkResult getSurfaceCapabilities(VkSurfaceCapabilitiesKHR *pSurfaceCapabilities) const override;
+	VkExternalMemoryHandleTypeFlags getImageMemoryExportHandleTypes() const override;
 
 	virtual void attachImage(PresentImage *image) override;
 	virtual void detachImage(PresentImage *image) override;
@@ -47,6 +53,14 @@ private:
 	GC gc;
 	Visual *visual = nullptr;
 	std::unordered_map<PresentImage *, XImage *> imageMap;
+
+#ifdef VK_USE_PLATFORM_XCB_KHR
+	// MIT-SHM presentation goes through the display's XCB connection.
+	xcb_connection_t *connection = nullptr;
+	xcb_gcontext_t shmGC = 0;
+	int depth = 0;
+	std::unique_ptr<XcbShmPresenter> shmPresenter;  // Null if MIT-SHM is unavailable
+#endif
 };
 
 }  // namespace vk
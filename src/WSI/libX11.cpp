@@ -18,7 +18,7 @@
 
 #include <memory>
 
-LibX11exports::LibX11exports(void *libX11, void *libXext)
+LibX11exports::LibX11exports(void *libX11, void *libXext, void *libX11xcb)
 {
 	getFuncAddress(libX11, "XOpenDisplay", &XOpenDisplay);
 	getFuncAddress(libX11, "XGetWindowAttributes", &XGetWindowAttributes);
@@ -32,6 +32,7 @@ LibX11exports::LibX11exports(void *libX11, void *libXext)
 	getFuncAddress(libX11, "XDefaultVisual", &XDefaultVisual);
 	getFuncAddress(libX11, "XSetErrorHandler", &XSetErrorHandler);
 	getFuncAddress(libX11, "XSync", &XSync);
+	getFuncAddress(libX11, "XFlush", &XFlush);
 	getFuncAddress(libX11, "XCreateImage", &XCreateImage);
 	getFuncAddress(libX11, "XCloseDisplay", &XCloseDisplay);
 	getFuncAddress(libX11, "XPutImage", &XPutImage);
@@ -42,6 +43,8 @@ LibX11exports::LibX11exports(void *libX11, void *libXext)
 	getFuncAddress(libXext, "XShmAttach", &XShmAttach);
 	getFuncAddress(libXext, "XShmDetach", &XShmDetach);
 	getFuncAddress(libXext, "XShmPutImage", &XShmPutImage);
+
+	getFuncAddress(libX11xcb, "XGetXCBConnection", &XGetXCBConnection);
 }
 
 LibX11exports *LibX11::operator->()
@@ -54,7 +57,7 @@ LibX11exports *LibX11::loadExports()
 	static LibX11exports exports = [] {
 		if(getProcAddress(RTLD_DEFAULT, "XOpenDisplay"))  // Search the global scope for pre-loaded X11 library.
 		{
-			return LibX11exports(RTLD_DEFAULT, RTLD_DEFAULT);
+			return LibX11exports(RTLD_DEFAULT, RTLD_DEFAULT, loadLibrary("libX11-xcb.so.1"));
 		}
 
 		void *libX11 = loadLibrary("libX11.so");
@@ -62,7 +65,8 @@ LibX11exports *LibX11::loadExports()
 		if(libX11)
 		{
 			void *libXext = loadLibrary("libXext.so");
-			return LibX11exports(libX11, libXext);
+			void *libX11xcb = loadLibrary("libX11-xcb.so.1");
+			return LibX11exports(libX11, libXext, libX11xcb);
 		}
 
 		return LibX11exports();
@@ -20,10 +20,12 @@
 #include <X11/Xutil.h>
 #include <X11/extensions/XShm.h>
 
+struct xcb_connection_t;
+
 struct LibX11exports
 {
 	LibX11exports() {}
-	LibX11exports(void *libX11, void *libXext);
+	LibX11exports(void *libX11, void *libXext, void *libX11xcb);
 
 	Display *(*XOpenDisplay)(char *display_name) = nullptr;
 	Status (*XGetWindowAttributes)(Display *display, Window w, XWindowAttributes *window_attributes_return) = nullptr;
@@ -38,6 +40,7 @@ struct LibX11exports
 	Visual *(*XDefaultVisual)(Display *display, int screen_number) = nullptr;
 	int (*(*XSetErrorHandler)(int (*handler)(Display *, XErrorEvent *)))(Display *, XErrorEvent *) = nullptr;
 	int (*XSync)(Display *display, Bool discard) = nullptr;
+	int (*XFlush)(Display *display) = nullptr;
 	XImage *(*XCreateImage)(Display *display, Visual *visual, unsigned int depth, int format, int offset, char *data, unsigned int width, unsigned int height, int bitmap_pad, int bytes_per_line) = nullptr;
 	int (*XCloseDisplay)(Display *display) = nullptr;
 	int (*XPutImage)(Display *display, Drawable d, GC gc, XImage *image, int src_x, int src_y, int dest_x, int dest_y, unsigned int width, unsigned int height) = nullptr;
@@ -48,6 +51,9 @@ struct LibX11exports
 	Bool (*XShmAttach)(Display *display, XShmSegmentInfo *shminfo) = nullptr;
 	Bool (*XShmDetach)(Display *display, XShmSegmentInfo *shminfo) = nullptr;
 	int (*XShmPutImage)(Display *display, Drawable d, GC gc, XImage *image, int src_x, int src_y, int dest_x, int dest_y, unsigned int width, unsigned int height, bool send_event) = nullptr;
+
+	// From libX11-xcb. Null if the library isn't available.
+	xcb_connection_t *(*XGetXCBConnection)(Display *display) = nullptr;
 };
 
 class LibX11
@@ -18,15 +18,27 @@
 
 #include <memory>
 
-LibXcbExports::LibXcbExports(void *lib)
+LibXcbExports::LibXcbExports(void *libxcb, void *libshm)
 {
-	getFuncAddress(lib, "xcb_create_gc", &xcb_create_gc);
-	getFuncAddress(lib, "xcb_flush", &xcb_flush);
-	getFuncAddress(lib, "xcb_free_gc", &xcb_free_gc);
-	getFuncAddress(lib, "xcb_generate_id", &xcb_generate_id);
-	getFuncAddress(lib, "xcb_get_geometry", &xcb_get_geometry);
-	getFuncAddress(lib, "xcb_get_geometry_reply", &xcb_get_geometry_reply);
-	getFuncAddress(lib, "xcb_put_image", &xcb_put_image);
+	getFuncAddress(libxcb, "xcb_create_gc", &xcb_create_gc);
+	getFuncAddress(libxcb, "xcb_flush", &xcb_flush);
+	getFuncAddress(libxcb, "xcb_free_gc", &xcb_free_gc);
+	getFuncAddress(libxcb, "xcb_generate_id", &xcb_generate_id);
+	getFuncAddress(libxcb, "xcb_get_geometry", &xcb_get_geometry);
+	getFuncAddress(libxcb, "xcb_get_geometry_reply", &xcb_get_geometry_reply);
+	getFuncAddress(libxcb, "xcb_put_image", &xcb_put_image);
+	getFuncAddress(libxcb, "xcb_request_check", &xcb_request_check);
+	getFuncAddress(libxcb, "xcb_get_extension_data", &xcb_get_extension_data);
+
+	if(libshm)
+	{
+		getFuncAddress(libshm, "xcb_shm_id", &xcb_shm_id);
+		getFuncAddress(libshm, "xcb_shm_query_version", &xcb_shm_query_version);
+		getFuncAddress(libshm, "xcb_shm_query_version_reply", &xcb_shm_query_version_reply);
+		getFuncAddress(libshm, "xcb_shm_attach_fd_checked", &xcb_shm_attach_fd_checked);
+		getFuncAddress(libshm, "xcb_shm_detach", &xcb_shm_detach);
+		getFuncAddress(libshm, "xcb_shm_put_image", &xcb_shm_put_image);
+	}
 }
 
 LibXcbExports *LibXCB::operator->()
@@ -37,14 +49,17 @@ LibXcbExports *LibXCB::operator->()
 LibXcbExports *LibXCB::loadExports()
 {
 	static LibXcbExports exports = [] {
+		// MIT-SHM is optional. Presentation falls back to xcb_put_image() without it.
+		void *libshm = loadLibrary("libxcb-shm.so.0");
+
 		if(getProcAddress(RTLD_DEFAULT, "xcb_create_gc"))  // Search the global scope for pre-loaded XCB library.
 		{
-			return LibXcbExports(RTLD_DEFAULT);
+			return LibXcbExports(RTLD_DEFAULT, libshm);
 		}
 
 		if(void *lib = loadLibrary("libxcb.so.1"))
 		{
-			return LibXcbExports(lib);
+			return LibXcbExports(lib, libshm);
 		}
 
 		return LibXcbExports();
@@ -17,10 +17,37 @@
 
 #include <xcb/xcb.h>
 
+#if __has_include(<xcb/shm.h>)
+#	include <xcb/shm.h>
+#else
+// libxcb-shm is loaded at runtime, so its development headers aren't required.
+// These match the declarations generated from the MIT-SHM protocol description.
+typedef uint32_t xcb_shm_seg_t;
+
+typedef struct xcb_shm_query_version_cookie_t
+{
+	unsigned int sequence;
+} xcb_shm_query_version_cookie_t;
+
+typedef struct xcb_shm_query_version_reply_t
+{
+	uint8_t response_type;
+	uint8_t shared_pixmaps;
+	uint16_t sequence;
+	uint32_t length;
+	uint16_t major_version;
+	uint16_t minor_version;
+	uint16_t uid;
+	uint16_t gid;
+	uint8_t pixmap_format;
+	uint8_t pad0[15];
+} xcb_shm_query_version_reply_t;
+#endif
+
 struct LibXcbExports
 {
 	LibXcbExports() {}
-	LibXcbExports(void *lib);
+	LibXcbExports(void *libxcb, void *libshm);
 
 	xcb_void_cookie_t (*xcb_create_gc)(xcb_connection_t *c, xcb_gcontext_t cid, xcb_drawable_t drawable, uint32_t value_mask, const void *value_list) = nullptr;
 	int (*xcb_flush)(xcb_connection_t *c) = nullptr;
@@ -29,6 +56,16 @@ struct LibXcbExports
 	xcb_get_geometry_cookie_t (*xcb_get_geometry)(xcb_connection_t *c, xcb_drawable_t drawable) = nullptr;
 	xcb_get_geometry_reply_t *(*xcb_get_geometry_reply)(xcb_connection_t *c, xcb_get_geometry_cookie_t cookie, xcb_generic_error_t **e) = nullptr;
 	xcb_void_cookie_t (*xcb_put_image)(xcb_connection_t *c, uint8_t format, xcb_drawable_t drawable, xcb_gcontext_t gc, uint16_t width, uint16_t height, int16_t dst_x, int16_t dst_y, uint8_t left_pad, uint8_t depth, uint32_t data_len, const uint8_t *data) = nullptr;
+	xcb_generic_error_t *(*xcb_request_check)(xcb_connection_t *c, xcb_void_cookie_t cookie) = nullptr;
+	const xcb_query_extension_reply_t *(*xcb_get_extension_data)(xcb_connection_t *c, xcb_extension_t *ext) = nullptr;
+
+	// MIT-SHM, from libxcb-shm. Null if the library isn't available.
+	xcb_extension_t *xcb_shm_id = nullptr;
+	xcb_shm_query_version_cookie_t (*xcb_shm_query_version)(xcb_connection_t *c) = nullptr;
+	xcb_shm_query_version_reply_t *(*xcb_shm_query_version_reply)(xcb_connection_t *c, xcb_shm_query_version_cookie_t cookie, xcb_generic_error_t **e) = nullptr;
+	xcb_void_cookie_t (*xcb_shm_attach_fd_checked)(xcb_connection_t *c, xcb_shm_seg_t shmseg, int32_t shm_fd, uint8_t read_only) = nullptr;
+	xcb_void_cookie_t (*xcb_shm_detach)(xcb_connection_t *c, xcb_shm_seg_t shmseg) = nullptr;
+	xcb_void_cookie_t (*xcb_shm_put_image)(xcb_connection_t *c, xcb_drawable_t drawable, xcb_gcontext_t gc, uint16_t total_width, uint16_t total_height, uint16_t src_x, uint16_t src_y, uint16_t src_width, uint16_t src_height, int16_t dst_x, int16_t dst_y, uint8_t depth, uint8_t format, uint8_t send_event, xcb_shm_seg_t shmseg, uint32_t offset) = nullptr;
 };
 
 class LibXCB
@@ -0,0 +1,204 @@
+// Copyright 2021 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "GLESTester.hpp"
+
+#include "benchmark/benchmark.h"
+
+#include <iterator>
+
+namespace {
+
+struct ShaderSource
+{
+	GLenum type;
+	const char *source;
+};
+
+// A mix of the shaders an application compiles at startup: ESSL 1.00 and
+// 3.00, trivial pass-throughs as well as lighting with loops and functions.
+const ShaderSource corpus[] = {
+	{ GL_VERTEX_SHADER,
+	  R"(attribute vec4 position;
+		void main()
+		{
+			gl_Position = position;
+		})" },
+
+	{ GL_FRAGMENT_SHADER,
+	  R"(precision mediump float;
+		uniform vec4 color;
+		void main()
+		{
+			gl_FragColor = color;
+		})" },
+
+	{ GL_VERTEX_SHADER,
+	  R"(attribute vec3 position;
+		attribute vec3 normal;
+		attribute vec2 texCoord;
+		uniform mat4 modelViewProjection;
+		uniform mat3 normalMatrix;
+		varying vec3 vNormal;
+		varying vec2 vTexCoord;
+		void main()
+		{
+			vNormal = normalize(normalMatrix * normal);
+			vTexCoord = texCoord;
+			gl_Position = modelViewProjection * vec4(position, 1.0);
+		})" },
+
+	{ GL_FRAGMENT_SHADER,
+	  R"(precision mediump float;
+		uniform sampler2D diffuse;
+		uniform vec3 lightDirection;
+		varying vec3 vNormal;
+		varying vec2 vTexCoord;
+		void main()
+		{
+			float lambert = max(dot(normalize(vNormal), lightDirection), 0.0);
+			gl_FragColor = texture2D(diffuse, vTexCoord) * (0.2 + 0.8 * lambert);
+		})" },
+
+	{ GL_VERTEX_SHADER,
+	  R"(#version 300 es
+		layout(location = 0) in vec3 position;
+		layout(location = 1) in vec3 normal;
+		layout(location = 2) in vec4 boneWeights;
+		layout(location = 3) in uvec4 boneIndices;
+		uniform mat4 viewProjection;
+		uniform mat4 bones[32];
+		out vec3 vNormal;
+		out vec3 vPosition;
+		void main()
+		{
+			mat4 skin = mat4(0.0);
+			for(int i = 0; i < 4; i++)
+			{
+				skin += bones[boneIndices[i]] * boneWeights[i];
+			}
+			vec4 world = skin * vec4(position, 1.0);
+			vNormal = mat3(skin) * normal;
+			vPosition = world.xyz;
+			gl_Position = viewProjection * world;
+		})" },
+
+	{ GL_FRAGMENT_SHADER,
+	  R"(#version 300 es
+		precision highp float;
+		struct Light
+		{
+			vec3 position;
+			vec3 color;
+			float radius;
+		};
+		uniform Light lights[8];
+		uniform int lightCount;
+		uniform vec3 eye;
+		uniform sampler2D albedo;
+		uniform samplerCube environment;
+		in vec3 vNormal;
+		in vec3 vPosition;
+		out vec4 fragColor;
+		vec3 shade(Light light, vec3 n, vec3 v)
+		{
+			vec3 l = light.position - vPosition;
+			float attenuation = clamp(1.0 - length(l) / light.radius, 0.0, 1.0);
+			l = normalize(l);
+			vec3 h = normalize(l + v);
+			float specular = pow(max(dot(n, h), 0.0), 32.0);
+			return light.color * attenuation * (max(dot(n, l), 0.0) + specular);
+		}
+		void main()
+		{
+			vec3 n = normalize(vNormal);
+			vec3 v = normalize(eye - vPosition);
+			vec3 color = vec3(0.0);
+			for(int i = 0; i < lightCount; i++)
+			{
+				color += shade(lights[i], n, v);
+			}
+			vec3 reflection = texture(environment, reflect(-v, n)).rgb;
+			vec2 uv = vPosition.xz * 0.1;
+			fragColor = vec4(texture(albedo, uv).rgb * color + 0.1 * reflection, 1.0);
+		})" },
+};
+
+// Compiles the whole corpus once. Returns false if any shader failed to compile.
+bool CompileCorpus()
+{
+	bool compiled = true;
+
+	for(const ShaderSource &shader : corpus)
+	{
+		GLuint handle = glCreateShader(shader.type);
+		glShaderSource(handle, 1, &shader.source, nullptr);
+		glCompileShader(handle);
+
+		GLint status = GL_FALSE;
+		glGetShaderiv(handle, GL_COMPILE_STATUS, &status);
+		compiled = compiled && (status == GL_TRUE);
+
+		glDeleteShader(handle);
+	}
+
+	return compiled;
+}
+
+}  // anonymous namespace
+
+static void RunBenchmark(benchmark::State &state, bool releaseCompiler)
+{
+	GLESTester tester(64, 64);
+
+	if(!tester.initialize())
+	{
+		state.SkipWithError("Failed to create an OpenGL ES context");
+		return;
+	}
+
+	// Warmup, which also initializes the compiler.
+	if(!CompileCorpus())
+	{
+		state.SkipWithError("Failed to compile the shader corpus");
+		return;
+	}
+
+	for(auto _ : state)
+	{
+		if(releaseCompiler)
+		{
+			glReleaseShaderCompiler();
+		}
+
+		CompileCorpus();
+	}
+
+	state.SetItemsProcessed(state.iterations() * (std::end(corpus) - std::begin(corpus)));
+}
+
+// Compiles with the compiler's state retained from previous compiles.
+static void CompileShaders(benchmark::State &state)
+{
+	RunBenchmark(state, false);
+}
+BENCHMARK(CompileShaders)->Unit(benchmark::kMillisecond);
+
+// Releases the compiler before each pass, as an application's first compiles
+// after startup.
+static void CompileShadersAfterRelease(benchmark::State &state)
+{
+	RunBenchmark(state, true);
+}
+BENCHMARK(CompileShadersAfterRelease)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,230 @@
+// Copyright 2021 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "GLESTester.hpp"
+
+#include "benchmark/benchmark.h"
+
+#include <iterator>
+#include <vector>
+
+// Renders into an offscreen pbuffer, to measure the throughput of the legacy
+// renderer's vertex, setup and pixel tasks.
+class GLESDrawTester : public GLESTester
+{
+public:
+	GLESDrawTester(int width, int height)
+	    : GLESTester(width, height)
+	{}
+
+	~GLESDrawTester() override
+	{
+		if(program)
+		{
+			glDeleteProgram(program);
+			glDeleteBuffers(1, &vertexBuffer);
+			glDeleteBuffers(1, &indexBuffer);
+		}
+	}
+
+	bool initialize() override
+	{
+		return GLESTester::initialize() && createProgram();
+	}
+
+	// Fills the viewport with a grid of 'triangleCount' triangles, split into
+	// 'drawCount' draw calls. Indexed grids share the vertices of each quad.
+	void createGrid(int triangleCount, int drawCount, bool indexed)
+	{
+		int quads = (triangleCount + 1) / 2;
+		int columns = 1;
+		while(columns * columns < quads)
+		{
+			columns++;
+		}
+
+		std::vector<float> vertices;
+		vertices.reserve(quads * 6 * 2);
+		std::vector<GLuint> indices;
+		indices.reserve(indexed ? quads * 6 : 0);
+
+		for(int quad = 0; quad < quads; quad++)
+		{
+			float x0 = -1.0f + 2.0f * (quad % columns) / columns;
+			float y0 = -1.0f + 2.0f * (quad / columns) / columns;
+			float x1 = x0 + 2.0f / columns;
+			float y1 = y0 + 2.0f / columns;
+
+			if(indexed)
+			{
+				const float quadVertices[] = { x0, y0, x1, y0, x1, y1, x0, y1 };
+				vertices.insert(vertices.end(), std::begin(quadVertices), std::end(quadVertices));
+
+				GLuint first = quad * 4;
+				const GLuint quadIndices[] = { first, first + 1, first + 2, first, first + 2, first + 3 };
+				indices.insert(indices.end(), std::begin(quadIndices), std::end(quadIndices));
+			}
+			else
+			{
+				const float quadVertices[] = { x0, y0, x1, y0, x1, y1, x0, y0, x1, y1, x0, y1 };
+				vertices.insert(vertices.end(), std::begin(quadVertices), std::end(quadVertices));
+			}
+		}
+
+		glGenBuffers(1, &vertexBuffer);
+		glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+		glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+
+		GLint position = glGetAttribLocation(program, "position");
+		glVertexAttribPointer(position, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+		glEnableVertexAttribArray(position);
+
+		if(indexed)
+		{
+			glGenBuffers(1, &indexBuffer);
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+			glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+		}
+
+		vertexCount = quads * 6;
+		this->drawCount = drawCount;
+		this->indexed = indexed;
+	}
+
+	void renderFrame()
+	{
+		glClear(GL_COLOR_BUFFER_BIT);
+
+		int verticesPerDraw = (vertexCount / 3 + drawCount - 1) / drawCount * 3;
+
+		for(int first = 0; first < vertexCount; first += verticesPerDraw)
+		{
+			int count = vertexCount - first < verticesPerDraw ? vertexCount - first : verticesPerDraw;
+			if(indexed)
+			{
+				glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, reinterpret_cast<const void *>(first * sizeof(GLuint)));
+			}
+			else
+			{
+				glDrawArrays(GL_TRIANGLES, first, count);
+			}
+		}
+
+		glFinish();
+	}
+
+private:
+	bool createProgram()
+	{
+		const char *vs =
+		    R"(#version 300 es
+			in vec2 position;
+			out vec2 coord;
+			void main()
+			{
+				gl_Position = vec4(position, 0.5, 1.0);
+				coord = position;
+			})";
+
+		const char *fs =
+		    R"(#version 300 es
+			precision mediump float;
+			in vec2 coord;
+			out vec4 fragColor;
+			void main()
+			{
+				fragColor = vec4(fract(coord * 8.0), 0.5, 1.0);
+			})";
+
+		GLuint vertexShader = compileShader(GL_VERTEX_SHADER, vs);
+		GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, fs);
+
+		program = glCreateProgram();
+		glAttachShader(program, vertexShader);
+		glAttachShader(program, fragmentShader);
+		glLinkProgram(program);
+		glDeleteShader(vertexShader);
+		glDeleteShader(fragmentShader);
+
+		GLint linked = GL_FALSE;
+		glGetProgramiv(program, GL_LINK_STATUS, &linked);
+		glUseProgram(program);
+
+		glViewport(0, 0, width, height);
+		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+
+		return linked == GL_TRUE;
+	}
+
+	static GLuint compileShader(GLenum type, const char *source)
+	{
+		GLuint shader = glCreateShader(type);
+		glShaderSource(shader, 1, &source, nullptr);
+		glCompileShader(shader);
+
+		return shader;
+	}
+
+	GLuint program = 0;
+	GLuint vertexBuffer = 0;
+	GLuint indexBuffer = 0;
+	int vertexCount = 0;  // Number of indices, for indexed grids
+	int drawCount = 1;
+	bool indexed = false;
+};
+
+static void RunBenchmark(benchmark::State &state, int triangleCount, int drawCount, bool indexed = false)
+{
+	GLESDrawTester tester(1024, 1024);
+
+	if(!tester.initialize())
+	{
+		state.SkipWithError("Failed to create an OpenGL ES context");
+		return;
+	}
+
+	tester.createGrid(triangleCount, drawCount, indexed);
+
+	// Warmup, which also generates the routines.
+	tester.renderFrame();
+
+	for(auto _ : state)
+	{
+		tester.renderFrame();
+	}
+
+	state.SetItemsProcessed(state.iterations() * triangleCount);
+}
+
+// A single draw call whose batches are spread over all worker threads.
+static void DrawTriangles(benchmark::State &state)
+{
+	RunBenchmark(state, static_cast<int>(state.range(0)), 1);
+}
+BENCHMARK(DrawTriangles)->Arg(2)->Arg(1000)->Arg(100000)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Many small draw calls, dominated by the cost of scheduling their tasks.
+static void DrawCalls(benchmark::State &state)
+{
+	RunBenchmark(state, 2 * static_cast<int>(state.range(0)), static_cast<int>(state.range(0)));
+}
+BENCHMARK(DrawCalls)->Arg(100)->Arg(1000)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Indexed draws from a static element buffer, whose index range only needs to
+// be computed once.
+static void DrawElements(benchmark::State &state)
+{
+	RunBenchmark(state, static_cast<int>(state.range(0)), static_cast<int>(state.range(1)), true);
+}
+BENCHMARK(DrawElements)->Args({ 100000, 1 })->Args({ 2000, 1000 })->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,83 @@
+// Copyright 2021 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "GLESTester.hpp"
+
+#if defined(_WIN32)
+#	include <Windows.h>
+#endif
+
+GLESTester::~GLESTester()
+{
+	if(display != EGL_NO_DISPLAY)
+	{
+		eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		eglDestroyContext(display, context);
+		eglDestroySurface(display, surface);
+		eglTerminate(display);
+	}
+}
+
+bool GLESTester::initialize()
+{
+#if defined(_WIN32) && !defined(STANDALONE)
+	// The DLLs are delay loaded (see BUILD.gn), so we can load
+	// the correct ones from Chrome's swiftshader subdirectory.
+	if(!LoadLibraryA("swiftshader\\libEGL.dll") || !LoadLibraryA("swiftshader\\libGLESv2.dll"))
+	{
+		return false;
+	}
+#endif
+
+	display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+	if(!eglInitialize(display, nullptr, nullptr))
+	{
+		display = EGL_NO_DISPLAY;
+		return false;
+	}
+
+	eglBindAPI(EGL_OPENGL_ES_API);
+
+	const EGLint configAttributes[] = {
+		EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
+		EGL_ALPHA_SIZE, 8,
+		EGL_NONE
+	};
+
+	EGLConfig config;
+	EGLint configCount = 0;
+	if(!eglChooseConfig(display, configAttributes, &config, 1, &configCount) || configCount != 1)
+	{
+		return false;
+	}
+
+	const EGLint surfaceAttributes[] = {
+		EGL_WIDTH, width,
+		EGL_HEIGHT, height,
+		EGL_NONE
+	};
+
+	surface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+
+	const EGLint contextAttributes[] = {
+		EGL_CONTEXT_CLIENT_VERSION, 3,
+		EGL_NONE
+	};
+
+	context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+
+	return eglMakeCurrent(display, surface, surface, context) == EGL_TRUE;
+}
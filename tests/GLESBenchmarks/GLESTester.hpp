@@ -0,0 +1,46 @@
+// Copyright 2021 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GLES_TESTER_HPP_
+#define GLES_TESTER_HPP_
+
+#include <EGL/egl.h>
+#include <GLES2/gl2.h>
+#include <GLES3/gl3.h>
+
+// Makes an OpenGL ES 3.0 context current on an offscreen pbuffer, through
+// libEGL and libGLESv2.
+class GLESTester
+{
+public:
+	GLESTester(int width, int height)
+	    : width(width)
+	    , height(height)
+	{}
+
+	virtual ~GLESTester();
+
+	virtual bool initialize();
+
+protected:
+	const int width;
+	const int height;
+
+private:
+	EGLDisplay display = EGL_NO_DISPLAY;
+	EGLSurface surface = EGL_NO_SURFACE;
+	EGLContext context = EGL_NO_CONTEXT;
+};
+
+#endif  // GLES_TESTER_HPP_
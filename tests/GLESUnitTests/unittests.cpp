@@ -845,6 +845,187 @@ TEST_F(SwiftShaderTest, AttributeLocation)
 	Uninitialize();
 }
 
+// Tests that indexed draws see changes to the contents of the element buffer,
+// whose index ranges are cached between draws.
+TEST_F(SwiftShaderTest, DrawElementsAfterIndexBufferUpdate)
+{
+	Initialize(3, false);
+
+	const std::string vs =
+	    R"(#version 300 es
+		in vec4 position;
+		in vec4 vertexColor;
+		out vec4 color;
+		void main()
+		{
+			gl_Position = position;
+			color = vertexColor;
+		})";
+
+	const std::string fs =
+	    R"(#version 300 es
+		precision mediump float;
+		in vec4 color;
+		out vec4 fragColor;
+		void main()
+		{
+			fragColor = color;
+		})";
+
+	const ProgramHandles ph = createProgram(vs, fs);
+
+	glUseProgram(ph.program);
+	EXPECT_NO_GL_ERROR();
+
+	// Two full-screen quads, a red one followed by a green one. Client side
+	// attributes only get streamed for the range of vertices being indexed.
+	float vertices[8][3] = { { -1.0f, -1.0f, 0.5f },
+		                     { 1.0f, -1.0f, 0.5f },
+		                     { 1.0f, 1.0f, 0.5f },
+		                     { -1.0f, 1.0f, 0.5f },
+		                     { -1.0f, -1.0f, 0.5f },
+		                     { 1.0f, -1.0f, 0.5f },
+		                     { 1.0f, 1.0f, 0.5f },
+		                     { -1.0f, 1.0f, 0.5f } };
+
+	float colors[8][4] = { { 1.0f, 0.0f, 0.0f, 1.0f },
+		                   { 1.0f, 0.0f, 0.0f, 1.0f },
+		                   { 1.0f, 0.0f, 0.0f, 1.0f },
+		                   { 1.0f, 0.0f, 0.0f, 1.0f },
+		                   { 0.0f, 1.0f, 0.0f, 1.0f },
+		                   { 0.0f, 1.0f, 0.0f, 1.0f },
+		                   { 0.0f, 1.0f, 0.0f, 1.0f },
+		                   { 0.0f, 1.0f, 0.0f, 1.0f } };
+
+	GLint position = glGetAttribLocation(ph.program, "position");
+	glVertexAttribPointer(position, 3, GL_FLOAT, GL_FALSE, 0, vertices);
+	glEnableVertexAttribArray(position);
+
+	GLint vertexColor = glGetAttribLocation(ph.program, "vertexColor");
+	glVertexAttribPointer(vertexColor, 4, GL_FLOAT, GL_FALSE, 0, colors);
+	glEnableVertexAttribArray(vertexColor);
+	EXPECT_NO_GL_ERROR();
+
+	GLushort redQuad[6] = { 0, 1, 2, 0, 2, 3 };
+	GLushort greenQuad[6] = { 4, 5, 6, 4, 6, 7 };
+
+	GLuint indexBuffer = 0;
+	glGenBuffers(1, &indexBuffer);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(redQuad), redQuad, GL_STATIC_DRAW);
+	EXPECT_NO_GL_ERROR();
+
+	unsigned char red[4] = { 255, 0, 0, 255 };
+	unsigned char green[4] = { 0, 255, 0, 255 };
+
+	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, nullptr);
+	EXPECT_NO_GL_ERROR();
+	expectFramebufferColor(red);
+
+	glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, sizeof(greenQuad), greenQuad);
+	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, nullptr);
+	EXPECT_NO_GL_ERROR();
+	expectFramebufferColor(green);
+
+	void *mapped = glMapBufferRange(GL_ELEMENT_ARRAY_BUFFER, 0, sizeof(redQuad), GL_MAP_WRITE_BIT);
+	ASSERT_NE(mapped, nullptr);
+	memcpy(mapped, redQuad, sizeof(redQuad));
+	glUnmapBuffer(GL_ELEMENT_ARRAY_BUFFER);
+	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, nullptr);
+	EXPECT_NO_GL_ERROR();
+	expectFramebufferColor(red);
+
+	glDisableVertexAttribArray(position);
+	glDisableVertexAttribArray(vertexColor);
+	glDeleteBuffers(1, &indexBuffer);
+	deleteProgram(ph);
+	EXPECT_NO_GL_ERROR();
+
+	Uninitialize();
+}
+
+// Test that a program loaded from a program binary renders like the original
+TEST_F(SwiftShaderTest, ProgramBinary)
+{
+	Initialize(3, false);
+
+	const std::string vs =
+	    R"(#version 300 es
+		in vec4 position;
+		void main()
+		{
+			gl_Position = position;
+		})";
+
+	const std::string fs =
+	    R"(#version 300 es
+		precision mediump float;
+		uniform vec4 color;
+		out vec4 fragColor;
+		void main()
+		{
+			fragColor = color;
+		})";
+
+	const ProgramHandles ph = createProgram(vs, fs);
+
+	GLint formatCount = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+	EXPECT_EQ(formatCount, 1);
+
+	GLint length = 0;
+	glGetProgramiv(ph.program, GL_PROGRAM_BINARY_LENGTH, &length);
+	EXPECT_NO_GL_ERROR();
+	ASSERT_GT(length, 0);
+
+	std::vector<unsigned char> binary(length);
+	GLsizei binaryLength = 0;
+	GLenum binaryFormat = GL_NONE;
+	glGetProgramBinary(ph.program, length - 1, &binaryLength, &binaryFormat, binary.data());
+	EXPECT_GLENUM_EQ(GL_INVALID_OPERATION, glGetError());
+	glGetProgramBinary(ph.program, length, &binaryLength, &binaryFormat, binary.data());
+	EXPECT_NO_GL_ERROR();
+	EXPECT_EQ(binaryLength, length);
+
+	GLint format = GL_NONE;
+	glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, &format);
+	EXPECT_GLENUM_EQ(format, binaryFormat);
+
+	GLuint program = glCreateProgram();
+	glProgramBinary(program, binaryFormat, binary.data(), binaryLength);
+	EXPECT_NO_GL_ERROR();
+
+	GLint linkStatus = GL_FALSE;
+	glGetProgramiv(program, GL_LINK_STATUS, &linkStatus);
+	EXPECT_EQ(linkStatus, GL_TRUE);
+	EXPECT_EQ(glGetFragDataLocation(program, "fragColor"), 0);
+
+	glUseProgram(program);
+	glUniform4f(glGetUniformLocation(program, "color"), 0.0f, 1.0f, 0.0f, 1.0f);
+	EXPECT_NO_GL_ERROR();
+
+	drawQuad(program);
+
+	unsigned char green[4] = { 0, 255, 0, 255 };
+	expectFramebufferColor(green);
+
+	// Corrupted binaries fail to load, and leave the program unlinked.
+	binary[binaryLength / 2] ^= 0xFF;
+	glProgramBinary(program, binaryFormat, binary.data(), binaryLength);
+	EXPECT_NO_GL_ERROR();
+	glGetProgramiv(program, GL_LINK_STATUS, &linkStatus);
+	EXPECT_EQ(linkStatus, GL_FALSE);
+
+	glProgramBinary(program, GL_NONE, binary.data(), binaryLength);
+	EXPECT_GLENUM_EQ(GL_INVALID_ENUM, glGetError());
+
+	glDeleteProgram(program);
+	deleteProgram(ph);
+	EXPECT_NO_GL_ERROR();
+
+	Uninitialize();
+}
+
 // Test negative layout locations
 TEST_F(SwiftShaderTest, NegativeLocation)
 {
@@ -17,6 +17,8 @@
 
 #include "benchmark/benchmark.h"
 
+#include <vector>
+
 BENCHMARK_MAIN();
 
 class Coroutines : public benchmark::Fixture
@@ -68,3 +70,44 @@ BENCHMARK_DEFINE_F(Coroutines, Fibonacci)
 }
 
 BENCHMARK_REGISTER_F(Coroutines, Fibonacci)->RangeMultiplier(8)->Range(1, 0x1000000)->ArgName("iterations");
+
+// Evaluates a degree-7 polynomial using Horner's method, which is a chain of
+// dependent multiply-adds. Compares the fused MulAdd() against a separate
+// multiply and add.
+template<bool Fused>
+static void Horner(benchmark::State &state)
+{
+	using namespace rr;
+
+	FunctionT<void(float *, int)> function;
+	{
+		Pointer<Float4> data = function.Arg<0>();
+		Int count = function.Arg<1>();
+
+		For(Int i = 0, i < count, i++)
+		{
+			Float4 x = data[i];
+			Float4 r = Float4(0.125f);
+			for(int j = 0; j < 7; j++)
+			{
+				r = Fused ? MulAdd(r, x, Float4(0.5f)) : r * x + Float4(0.5f);
+			}
+			data[i] = r;
+		}
+	}
+
+	auto routine = function("Horner");
+
+	const int count = static_cast<int>(state.range(0));
+	std::vector<float> data(count * 4, 0.25f);
+
+	for(auto _ : state)
+	{
+		routine(data.data(), count);
+	}
+
+	state.SetItemsProcessed(state.iterations() * count * 4);
+}
+
+BENCHMARK_TEMPLATE(Horner, false)->Arg(1 << 16)->ArgName("vectors");
+BENCHMARK_TEMPLATE(Horner, true)->Arg(1 << 16)->ArgName("vectors");
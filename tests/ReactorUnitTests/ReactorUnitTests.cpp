@@ -14,6 +14,7 @@
 
 #include "Assert.hpp"
 #include "Coroutine.hpp"
+#include "PerfMap.hpp"
 #include "Print.hpp"
 #include "Reactor.hpp"
 
@@ -21,11 +22,16 @@
 
 #include <array>
 #include <cmath>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <thread>
 #include <tuple>
 
+#if defined(__linux__)
+#	include <unistd.h>
+#endif
+
 using namespace rr;
 
 static std::string testName()
@@ -1373,6 +1379,46 @@ TEST(ReactorUnitTests, RoundInt)
 	EXPECT_EQ(out[1][3], -2147483520);
 }
 
+TEST(ReactorUnitTests, MulAddFloat4)
+{
+	FunctionT<int(void *, void *)> function;
+	{
+		Pointer<Byte> out = function.Arg<0>();
+		Pointer<Byte> in = function.Arg<1>();
+
+		Float4 x = *Pointer<Float4>(in + 0);
+		Float4 y = *Pointer<Float4>(in + 16);
+		Float4 z = *Pointer<Float4>(in + 32);
+
+		*Pointer<Float4>(out) = MulAdd(x, y, z);
+
+		Return(0);
+	}
+
+	auto routine = function(testName().c_str());
+
+	// (1 + 2^-12)^2 - (1 + 2^-11) is exactly 2^-24, but the product rounds
+	// to 1 + 2^-11 when it is not fused with the addition.
+	const float a = 1.0f + std::ldexp(1.0f, -12);
+	const float b = -(1.0f + std::ldexp(1.0f, -11));
+
+	float in[3][4] = {
+		{ 2.0f, -3.0f, 0.5f, a },
+		{ 4.0f, 5.0f, 0.0f, a },
+		{ 1.0f, 1.0f, -1.0f, b },
+	};
+	float out[4];
+
+	memset(&out, 0, sizeof(out));
+
+	routine(&out, &in);
+
+	EXPECT_EQ(out[0], 9.0f);
+	EXPECT_EQ(out[1], -14.0f);
+	EXPECT_EQ(out[2], -1.0f);
+	EXPECT_EQ(out[3], Caps.FMASupported ? std::ldexp(1.0f, -24) : 0.0f);
+}
+
 TEST(ReactorUnitTests, FPtoUI)
 {
 	FunctionT<int(void *)> function;
@@ -3921,6 +3967,98 @@ TEST(ReactorUnitTests, EmitAsm)
 }
 #endif
 
+#if defined(__linux__)
+TEST(ReactorUnitTests, PerfMap)
+{
+	// Don't interfere with a perf map requested through the environment.
+	if(PerfMap::isEnabled()) return;
+
+	PerfMap::setEnabled(true);
+
+	FunctionT<int(int)> function;
+	{
+		Int x = function.Arg<0>();
+		Return(x + 1);
+	}
+
+	auto routine = function(testName().c_str());
+	EXPECT_EQ(routine(1), 2);
+
+	PerfMap::setEnabled(false);
+
+	// Each line of the map is "<start address> <size> <name>" in hexadecimal.
+	std::ifstream fin(PerfMap::perfMapPath());
+	EXPECT_TRUE(fin);
+
+	bool found = false;
+	std::string start, size, name;
+	while(fin >> start >> size && std::getline(fin >> std::ws, name))
+	{
+		if(name == testName())
+		{
+			EXPECT_EQ(std::stoull(start, nullptr, 16), reinterpret_cast<uintptr_t>(routine.getEntry()));
+			EXPECT_GT(std::stoull(size, nullptr, 16), 0u);
+			found = true;
+		}
+	}
+	EXPECT_TRUE(found);
+
+	fin.close();
+	std::remove(PerfMap::perfMapPath().c_str());
+}
+
+TEST(ReactorUnitTests, PerfMapJitdumpLines)
+{
+	if(PerfMap::isEnabled()) return;
+
+	std::string directory = std::filesystem::temp_directory_path().string();
+	PerfMap::setEnabled(false, directory);
+
+	static const uint8_t code[8] = {};
+	std::vector<PerfMap::Line> lines = {
+		{ code, "/src/a.cpp", 10 },
+		{ code + 4, "/src/b.cpp", 20 },
+	};
+	PerfMap::notifyFunctionEmitted(testName().c_str(), code, sizeof(code), lines);
+
+	PerfMap::setEnabled(false);
+
+	std::string path = directory + "/jit-" + std::to_string(getpid()) + ".dump";
+	std::ifstream fin(path, std::ios::binary);
+	std::string dump((std::istreambuf_iterator<char>(fin)), std::istreambuf_iterator<char>());
+	fin.close();
+	std::remove(path.c_str());
+
+	auto read32 = [&](size_t offset) { uint32_t value = 0; memcpy(&value, &dump[offset], sizeof(value)); return value; };
+	auto read64 = [&](size_t offset) { uint64_t value = 0; memcpy(&value, &dump[offset], sizeof(value)); return value; };
+
+	// Records follow the header, each starting with its id and total size.
+	// The debug info record (id 2) must immediately precede the code load
+	// record (id 0) it describes.
+	ASSERT_GE(dump.size(), 40u);
+	size_t offset = read32(8);
+	ASSERT_LE(offset + 40, dump.size());
+	EXPECT_EQ(read32(offset), 2u);
+	EXPECT_EQ(read64(offset + 16), reinterpret_cast<uintptr_t>(code));
+	EXPECT_EQ(read64(offset + 24), 2u);
+
+	size_t entry = offset + 32;
+	for(const PerfMap::Line &line : lines)
+	{
+		EXPECT_EQ(read64(entry), reinterpret_cast<uintptr_t>(line.address) + 0x40);
+		EXPECT_EQ(static_cast<int>(read32(entry + 8)), line.line);
+		EXPECT_EQ(std::string(&dump[entry + 16]), line.file);
+		entry += 16 + line.file.size() + 1;
+	}
+	EXPECT_EQ(entry, offset + read32(offset + 4));
+
+	offset = entry;
+	ASSERT_LE(offset + 56, dump.size());
+	EXPECT_EQ(read32(offset), 0u);
+	EXPECT_EQ(std::string(&dump[offset + 56]), testName());
+}
+#endif
+
 ////////////////////////////////
 // Trait compile time checks. //
 ////////////////////////////////
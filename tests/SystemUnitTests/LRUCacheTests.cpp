@@ -13,10 +13,15 @@
 // limitations under the License.
 
 #include "System/LRUCache.hpp"
+#include "System/SharedLRUCache.hpp"
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
 #include <vector>
 
 using namespace sw;
@@ -175,4 +180,102 @@ TEST(LRUCache, Reordering)
 	                      { "3", "three" },
 	                      { "1", "one" },
 	                  });
-}
\ No newline at end of file
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// SharedLRUCache
+////////////////////////////////////////////////////////////////////////////////
+TEST(SharedLRUCache, CreateOnce)
+{
+	SharedLRUCache<std::string, std::shared_ptr<std::string>> cache(4);
+	int created = 0;
+
+	auto create = [&] {
+		created++;
+		return std::make_shared<std::string>("one");
+	};
+
+	auto first = cache.getOrCreate("1", create);
+	auto second = cache.getOrCreate("1", create);
+
+	ASSERT_EQ(created, 1);
+	ASSERT_EQ(first, second);
+	ASSERT_EQ(*first, "one");
+}
+
+TEST(SharedLRUCache, Eviction)
+{
+	SharedLRUCache<int, std::shared_ptr<int>> cache(2);
+	int created = 0;
+
+	for(int key : { 1, 2, 3, 1 })
+	{
+		auto data = cache.getOrCreate(key, [&] {
+			created++;
+			return std::make_shared<int>(key);
+		});
+
+		ASSERT_EQ(*data, key);
+	}
+
+	ASSERT_EQ(created, 4);
+}
+
+// Threads which need the same entry at the same time, like the renderers of
+// multiple queues drawing with the same state, wait for a single creation.
+TEST(SharedLRUCache, ConcurrentSameKey)
+{
+	SharedLRUCache<int, std::shared_ptr<int>> cache(4);
+	std::atomic<int> created = { 0 };
+
+	constexpr int threadCount = 8;
+	std::shared_ptr<int> results[threadCount];
+	std::vector<std::thread> threads;
+
+	for(int i = 0; i < threadCount; i++)
+	{
+		threads.emplace_back([&, i] {
+			results[i] = cache.getOrCreate(42, [&] {
+				created++;
+				std::this_thread::sleep_for(std::chrono::milliseconds(50));
+				return std::make_shared<int>(42);
+			});
+		});
+	}
+
+	for(auto &thread : threads)
+	{
+		thread.join();
+	}
+
+	ASSERT_EQ(created, 1);
+	for(int i = 0; i < threadCount; i++)
+	{
+		ASSERT_EQ(results[i], results[0]);
+	}
+}
+
+// Entries with different keys are created concurrently.
+TEST(SharedLRUCache, ConcurrentDifferentKeys)
+{
+	SharedLRUCache<int, std::shared_ptr<int>> cache(4);
+	marl::Event firstStarted;
+	marl::Event secondCreated;
+	bool concurrent = false;
+
+	auto thread = std::thread([&] {
+		cache.getOrCreate(1, [&] {
+			firstStarted.signal();
+			concurrent = secondCreated.wait_for(std::chrono::seconds(10));
+			return std::make_shared<int>(1);
+		});
+	});
+
+	firstStarted.wait();
+	ASSERT_EQ(*cache.getOrCreate(2, [] { return std::make_shared<int>(2); }), 2);
+	secondCreated.signal();
+
+	thread.join();
+	ASSERT_TRUE(concurrent);
+	ASSERT_EQ(*cache.getOrCreate(1, [] { return std::make_shared<int>(0); }), 1);
+}
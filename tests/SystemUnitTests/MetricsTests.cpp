@@ -0,0 +1,155 @@
+// Copyright 2021 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "System/Metrics.hpp"
+#include "System/SharedLRUCache.hpp"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+using namespace sw;
+
+namespace {
+
+// Enables and resets the metrics for the duration of a test.
+class MetricsTest : public testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		Metrics::reset();
+		Metrics::setEnabled(true);
+	}
+
+	void TearDown() override
+	{
+		Metrics::setEnabled(false);
+		Metrics::reset();
+	}
+};
+
+}  // anonymous namespace
+
+TEST_F(MetricsTest, DisabledRecordsNothing)
+{
+	Metrics::setEnabled(false);
+
+	Metrics::add(Metrics::Draws);
+	Metrics::count(Metrics::BlitRoutineCache, Metrics::CacheHit);
+	Metrics::record(Metrics::JITCompileTime, std::chrono::microseconds(5));
+
+	Metrics::Snapshot snapshot = Metrics::snapshot();
+	ASSERT_EQ(snapshot.counters[Metrics::Draws], 0u);
+	ASSERT_EQ(snapshot.cacheEvents[Metrics::BlitRoutineCache][Metrics::CacheHit], 0u);
+	ASSERT_EQ(snapshot.histograms[Metrics::JITCompileTime].count, 0u);
+}
+
+TEST_F(MetricsTest, CountersSumAcrossThreads)
+{
+	std::vector<std::thread> threads;
+	for(int i = 0; i < 8; i++)
+	{
+		threads.emplace_back([] {
+			for(int j = 0; j < 1000; j++)
+			{
+				Metrics::add(Metrics::VertexInvocations, 3);
+			}
+		});
+	}
+
+	for(auto &thread : threads)
+	{
+		thread.join();
+	}
+
+	ASSERT_EQ(Metrics::snapshot().counters[Metrics::VertexInvocations], 8u * 1000u * 3u);
+}
+
+TEST_F(MetricsTest, Histogram)
+{
+	for(int i = 0; i < 99; i++)
+	{
+		Metrics::record(Metrics::SpirvOptimizeTime, std::chrono::microseconds(10));
+	}
+	Metrics::record(Metrics::SpirvOptimizeTime, std::chrono::milliseconds(100));
+
+	const Metrics::HistogramData &histogram = Metrics::snapshot().histograms[Metrics::SpirvOptimizeTime];
+	ASSERT_EQ(histogram.count, 100u);
+	ASSERT_EQ(histogram.sum, 99u * 10000u + 100000000u);
+
+	// Quantiles are bounded by their bucket's upper bound, at most twice the value.
+	ASSERT_GT(histogram.quantile(0.5), 10000u);
+	ASSERT_LE(histogram.quantile(0.5), 20000u);
+	ASSERT_GT(histogram.quantile(0.999), 100000000u);
+	ASSERT_LE(histogram.quantile(0.999), 200000000u);
+}
+
+TEST_F(MetricsTest, ScopedTimer)
+{
+	{
+		Metrics::ScopedTimer timer(Metrics::PixelTaskTime);
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	const Metrics::HistogramData &histogram = Metrics::snapshot().histograms[Metrics::PixelTaskTime];
+	ASSERT_EQ(histogram.count, 1u);
+	ASSERT_GE(histogram.sum, 1000000u);
+}
+
+TEST_F(MetricsTest, Reset)
+{
+	Metrics::add(Metrics::Draws);
+	Metrics::count(Metrics::PixelRoutineCache, Metrics::CacheMiss);
+	Metrics::record(Metrics::ShaderEmitTime, std::chrono::microseconds(1));
+
+	Metrics::reset();
+
+	Metrics::Snapshot snapshot = Metrics::snapshot();
+	ASSERT_EQ(snapshot.counters[Metrics::Draws], 0u);
+	ASSERT_EQ(snapshot.cacheEvents[Metrics::PixelRoutineCache][Metrics::CacheMiss], 0u);
+	ASSERT_EQ(snapshot.histograms[Metrics::ShaderEmitTime].count, 0u);
+}
+
+TEST_F(MetricsTest, Value)
+{
+	Metrics::add(Metrics::Draws, 7);
+	Metrics::count(Metrics::VertexRoutineCache, Metrics::CacheEviction);
+	Metrics::record(Metrics::JITCompileTime, std::chrono::milliseconds(2));
+
+	Metrics::Snapshot snapshot = Metrics::snapshot();
+	ASSERT_EQ(Metrics::value(snapshot, "draws"), 7u);
+	ASSERT_EQ(Metrics::value(snapshot, "cache.vertex_routine.evictions"), 1u);
+	ASSERT_EQ(Metrics::value(snapshot, "time.jit_compile.count"), 1u);
+	ASSERT_EQ(Metrics::value(snapshot, "time.jit_compile.total_us"), 2000u);
+	ASSERT_EQ(Metrics::value(snapshot, "no.such.metric"), 0u);
+	ASSERT_EQ(Metrics::value(snapshot, "draw"), 0u);
+	ASSERT_EQ(Metrics::value(snapshot, nullptr), 0u);
+}
+
+TEST_F(MetricsTest, SharedLRUCache)
+{
+	SharedLRUCache<int, int> cache(2, Metrics::SetupRoutineCache);
+
+	for(int key : { 1, 2, 1, 3, 2 })
+	{
+		cache.getOrCreate(key, [&] { return key * 10; });
+	}
+
+	Metrics::Snapshot snapshot = Metrics::snapshot();
+	ASSERT_EQ(snapshot.cacheEvents[Metrics::SetupRoutineCache][Metrics::CacheHit], 1u);
+	ASSERT_EQ(snapshot.cacheEvents[Metrics::SetupRoutineCache][Metrics::CacheMiss], 4u);
+	ASSERT_EQ(snapshot.cacheEvents[Metrics::SetupRoutineCache][Metrics::CacheEviction], 2u);
+}
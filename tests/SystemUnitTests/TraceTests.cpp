@@ -0,0 +1,452 @@
+// Copyright 2021 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "System/Trace.hpp"
+
+#include "marl/defer.h"
+#include "marl/event.h"
+#include "marl/scheduler.h"
+#include "marl/waitgroup.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace sw;
+
+namespace {
+
+std::string readFile(const std::string &path)
+{
+	std::ifstream file(path, std::ios::binary);
+	std::stringstream contents;
+	contents << file.rdbuf();
+	return contents.str();
+}
+
+// Records the same events in either format.
+void recordEvents()
+{
+	{
+		SW_SCOPED_EVENT("scoped %d", 42);
+	}
+
+	Trace::beginAsync("async", 7);
+
+	std::thread thread([] {
+		Trace::nameThread("Other %d", 1);
+		SW_SCOPED_EVENT("threaded");
+		Trace::endAsync("async", 7);
+	});
+	thread.join();
+}
+
+// Decodes the fields of a protobuf message, which the trace writes with
+// varint and length-delimited wire types only.
+class ProtoReader
+{
+public:
+	ProtoReader(const std::string &data)
+	    : data(data)
+	{}
+
+	// Reads the next field, returning false at the end of the message.
+	bool next(uint32_t &field, uint64_t &value, std::string &bytes)
+	{
+		if(offset >= data.size())
+		{
+			return false;
+		}
+
+		uint64_t key = varint();
+		field = static_cast<uint32_t>(key >> 3);
+
+		switch(key & 7)
+		{
+		case 0:
+			value = varint();
+			break;
+		case 2:
+			value = varint();
+			bytes = data.substr(offset, value);
+			offset += value;
+			break;
+		default:
+			ADD_FAILURE() << "Unexpected wire type " << (key & 7);
+			offset = data.size();
+			return false;
+		}
+
+		return offset <= data.size();
+	}
+
+private:
+	uint64_t varint()
+	{
+		uint64_t value = 0;
+		for(int shift = 0; offset < data.size(); shift += 7)
+		{
+			uint8_t byte = data[offset++];
+			value |= uint64_t(byte & 0x7F) << shift;
+			if(!(byte & 0x80))
+			{
+				break;
+			}
+		}
+
+		return value;
+	}
+
+	const std::string &data;
+	size_t offset = 0;
+};
+
+struct TrackEvent
+{
+	uint64_t timestamp = 0;
+	uint64_t type = 0;  // 1 for SLICE_BEGIN, 2 for SLICE_END, 3 for INSTANT
+	uint64_t track = 0;
+	std::string name;
+};
+
+struct TrackDescriptor
+{
+	uint64_t parent = 0;
+	std::string name;
+};
+
+// Decodes the TrackEvent and TrackDescriptor packets of a Perfetto trace.
+void decodePerfetto(const std::string &trace, std::vector<TrackEvent> &events, std::map<uint64_t, TrackDescriptor> &tracks)
+{
+	ProtoReader reader(trace);
+	uint32_t field;
+	uint64_t value;
+	std::string packet;
+
+	while(reader.next(field, value, packet))
+	{
+		ASSERT_EQ(field, 1u);  // Trace.packet
+
+		TrackEvent event;
+		std::string trackEvent;
+		std::string trackDescriptor;
+
+		ProtoReader packetReader(packet);
+		std::string bytes;
+		while(packetReader.next(field, value, bytes))
+		{
+			switch(field)
+			{
+			case 8: event.timestamp = value; break;
+			case 11: trackEvent = bytes; break;
+			case 60: trackDescriptor = bytes; break;
+			}
+		}
+
+		if(!trackDescriptor.empty())
+		{
+			uint64_t uuid = 0;
+			TrackDescriptor track;
+
+			ProtoReader trackReader(trackDescriptor);
+			while(trackReader.next(field, value, bytes))
+			{
+				switch(field)
+				{
+				case 1: uuid = value; break;
+				case 2: track.name = bytes; break;
+				case 5: track.parent = value; break;
+				}
+			}
+
+			ASSERT_EQ(tracks.count(uuid), 0u) << "Track described twice";
+			tracks[uuid] = track;
+		}
+
+		if(!trackEvent.empty())
+		{
+			ProtoReader eventReader(trackEvent);
+			while(eventReader.next(field, value, bytes))
+			{
+				switch(field)
+				{
+				case 9: event.type = value; break;
+				case 11: event.track = value; break;
+				case 23: event.name = bytes; break;
+				}
+			}
+
+			ASSERT_EQ(tracks.count(event.track), 1u) << "Event on a track not described before";
+			events.push_back(event);
+		}
+	}
+}
+
+}  // anonymous namespace
+
+TEST(TraceTest, DisabledRecordsNothing)
+{
+	ASSERT_FALSE(Trace::isEnabled());
+
+	{
+		SW_SCOPED_EVENT("ignored");
+	}
+
+	std::string path = testing::TempDir() + "trace_disabled.json";
+	ASSERT_TRUE(Trace::start(path.c_str()));
+	Trace::stop();
+
+	std::string json = readFile(path);
+	remove(path.c_str());
+
+	ASSERT_EQ(json.find("ignored"), std::string::npos);
+}
+
+TEST(TraceTest, ChromeJSON)
+{
+	std::string path = testing::TempDir() + "trace.json";
+	ASSERT_TRUE(Trace::start(path.c_str()));
+	ASSERT_TRUE(Trace::isEnabled());
+	ASSERT_FALSE(Trace::start(path.c_str()));  // Already started
+
+	recordEvents();
+
+	Trace::stop();
+	ASSERT_FALSE(Trace::isEnabled());
+
+	std::string json = readFile(path);
+	remove(path.c_str());
+
+	ASSERT_EQ(json.front(), '[');
+	ASSERT_EQ(json.substr(json.size() - 3), "\n]\n");
+	ASSERT_NE(json.find("\"name\":\"scoped 42\",\"ph\":\"X\""), std::string::npos);
+	ASSERT_NE(json.find("\"name\":\"threaded\",\"ph\":\"X\""), std::string::npos);
+	ASSERT_NE(json.find("\"name\":\"async\",\"cat\":\"swiftshader\",\"ph\":\"b\",\"id\":\"0x7\""), std::string::npos);
+	ASSERT_NE(json.find("\"name\":\"async\",\"cat\":\"swiftshader\",\"ph\":\"e\",\"id\":\"0x7\""), std::string::npos);
+	ASSERT_NE(json.find("\"name\":\"Other 1\""), std::string::npos);
+}
+
+TEST(TraceTest, Perfetto)
+{
+	std::string path = testing::TempDir() + "trace.pftrace";
+	ASSERT_TRUE(Trace::start(path.c_str()));
+
+	recordEvents();
+
+	Trace::stop();
+
+	std::string trace = readFile(path);
+	remove(path.c_str());
+
+	// Each packet is a length-delimited Trace.packet field.
+	ASSERT_EQ(trace.front(), '\x0A');
+	ASSERT_NE(trace.find("scoped 42"), std::string::npos);
+	ASSERT_NE(trace.find("threaded"), std::string::npos);
+	ASSERT_NE(trace.find("async"), std::string::npos);
+	ASSERT_NE(trace.find("Other 1"), std::string::npos);
+}
+
+// Slices of fibers which block within them overlap on their thread, and must
+// be written on separate tracks, each with strictly nested slices.
+TEST(TraceTest, PerfettoFiberSlices)
+{
+	marl::Scheduler::Config config;
+	config.setWorkerThreadCount(1);
+	marl::Scheduler scheduler(config);
+	scheduler.bind();
+	defer(scheduler.unbind());
+
+	std::string path = testing::TempDir() + "trace_fibers.pftrace";
+	ASSERT_TRUE(Trace::start(path.c_str()));
+
+	// On the single worker, "first" blocks until "second" has begun, and
+	// "second" blocks until "first" has ended.
+	marl::Event firstBegun;
+	marl::Event secondBegun;
+	marl::Event firstEnded;
+	marl::WaitGroup done(2);
+
+	marl::schedule([&] {
+		{
+			SW_SCOPED_EVENT("first");
+			firstBegun.signal();
+			secondBegun.wait();
+		}
+		firstEnded.signal();
+		done.done();
+	});
+
+	marl::schedule([&] {
+		firstBegun.wait();
+		{
+			SW_SCOPED_EVENT("second");
+			secondBegun.signal();
+			firstEnded.wait();
+			SW_SCOPED_EVENT("inner");
+		}
+		done.done();
+	});
+
+	done.wait();
+	Trace::stop();
+
+	std::string trace = readFile(path);
+	remove(path.c_str());
+
+	std::vector<TrackEvent> events;
+	std::map<uint64_t, TrackDescriptor> tracks;
+	decodePerfetto(trace, events, tracks);
+
+	struct Slice
+	{
+		uint64_t track;
+		uint64_t begin;
+		uint64_t end;
+	};
+
+	std::map<std::string, Slice> slices;
+	std::map<uint64_t, std::vector<TrackEvent>> open;  // Slices begun on each track, innermost last
+	std::map<uint64_t, uint64_t> lastTime;
+
+	for(const TrackEvent &event : events)
+	{
+		ASSERT_GE(event.timestamp, lastTime[event.track]) << "Events of a track out of order";
+		lastTime[event.track] = event.timestamp;
+
+		std::vector<TrackEvent> &stack = open[event.track];
+
+		if(event.type == 1)
+		{
+			stack.push_back(event);
+		}
+		else if(event.type == 2)
+		{
+			ASSERT_FALSE(stack.empty()) << "Slice ended without beginning";
+			slices[stack.back().name] = { event.track, stack.back().timestamp, event.timestamp };
+			stack.pop_back();
+		}
+	}
+
+	for(auto &track : open)
+	{
+		ASSERT_TRUE(track.second.empty()) << "Slice begun without ending";
+	}
+
+	ASSERT_EQ(slices.count("first"), 1u);
+	ASSERT_EQ(slices.count("second"), 1u);
+	ASSERT_EQ(slices.count("inner"), 1u);
+
+	const Slice &first = slices["first"];
+	const Slice &second = slices["second"];
+	const Slice &inner = slices["inner"];
+
+	// The slices did overlap, on tracks of the same thread.
+	ASSERT_LT(first.begin, second.begin);
+	ASSERT_LT(second.begin, first.end);
+	ASSERT_LT(first.end, second.end);
+	ASSERT_NE(first.track, second.track);
+	ASSERT_EQ(inner.track, second.track);
+	ASSERT_LE(second.begin, inner.begin);
+	ASSERT_LE(inner.end, second.end);
+
+	uint64_t firstThread = tracks[first.track].parent ? tracks[first.track].parent : first.track;
+	uint64_t secondThread = tracks[second.track].parent ? tracks[second.track].parent : second.track;
+	ASSERT_EQ(firstThread, secondThread);
+}
+
+// Threads free their buffers when they exit, after writing their events, so
+// more threads than can record at once record one after the other.
+TEST(TraceTest, ExitedThreads)
+{
+	std::string path = testing::TempDir() + "trace_threads.json";
+	ASSERT_TRUE(Trace::start(path.c_str()));
+
+	for(int i = 0; i < 300; i++)
+	{
+		std::thread thread([i] {
+			SW_SCOPED_EVENT("thread %d", i);
+		});
+		thread.join();
+	}
+
+	Trace::stop();
+
+	std::string json = readFile(path);
+	remove(path.c_str());
+
+	ASSERT_NE(json.find("\"name\":\"thread 0\""), std::string::npos);
+	ASSERT_NE(json.find("\"name\":\"thread 299\""), std::string::npos);
+}
+
+// Threads recording more events than their buffer holds between flushes drain
+// it themselves, rather than dropping events.
+TEST(TraceTest, LongBurst)
+{
+	std::string path = testing::TempDir() + "trace_burst.json";
+	ASSERT_TRUE(Trace::start(path.c_str()));
+
+	const int count = 100000;
+	for(int i = 0; i < count; i++)
+	{
+		SW_SCOPED_EVENT("burst");
+	}
+
+	Trace::stop();
+
+	std::string json = readFile(path);
+	remove(path.c_str());
+
+	int recorded = 0;
+	for(size_t i = json.find("\"burst\""); i != std::string::npos; i = json.find("\"burst\"", i + 1))
+	{
+		recorded++;
+	}
+
+	ASSERT_EQ(recorded, count);
+	ASSERT_EQ(json.find("events dropped"), std::string::npos);
+}
+
+// Stopping a trace frees the buffers, which are allocated again by the next.
+TEST(TraceTest, Restart)
+{
+	for(int i = 0; i < 2; i++)
+	{
+		std::string path = testing::TempDir() + "trace_restart.json";
+		ASSERT_TRUE(Trace::start(path.c_str()));
+
+		{
+			SW_SCOPED_EVENT("trace %d", i);
+		}
+
+		Trace::stop();
+
+		std::string json = readFile(path);
+		remove(path.c_str());
+
+		ASSERT_NE(json.find("\"name\":\"trace " + std::to_string(i) + "\""), std::string::npos);
+		ASSERT_EQ(json.find("\"name\":\"trace " + std::to_string(1 - i) + "\""), std::string::npos);
+	}
+}
+
+TEST(TraceTest, StartFailure)
+{
+	ASSERT_FALSE(Trace::start("/nonexistent/directory/trace.json"));
+	ASSERT_FALSE(Trace::isEnabled());
+}
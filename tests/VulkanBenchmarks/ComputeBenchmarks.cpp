@@ -0,0 +1,311 @@
+// Copyright 2021 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "Util.hpp"
+#include "VulkanTester.hpp"
+#include "benchmark/benchmark.h"
+
+#include <array>
+#include <string>
+
+// Runs a compute shader which reads the storage buffer at binding 0, and writes
+// the storage buffer at binding 1.
+class StorageBufferBenchmark
+{
+public:
+	void initialize(const std::string &shader, vk::DeviceSize srcSize, vk::DeviceSize dstSize, uint32_t groupCount)
+	{
+		tester.initialize();
+		auto &device = tester.getDevice();
+		auto &physicalDevice = tester.getPhysicalDevice();
+
+		vk::DeviceSize sizes[2] = { srcSize, dstSize };
+		vk::DeviceSize offsets[2] = {};
+		vk::MemoryAllocateInfo allocateInfo;
+		uint32_t memoryTypeBits = ~0u;
+
+		for(uint32_t i = 0; i < buffers.size(); i++)
+		{
+			vk::BufferCreateInfo bufferInfo;
+			bufferInfo.size = sizes[i];
+			bufferInfo.usage = vk::BufferUsageFlagBits::eStorageBuffer;
+			buffers[i] = device.createBuffer(bufferInfo);
+
+			vk::MemoryRequirements memoryRequirements = device.getBufferMemoryRequirements(buffers[i]);
+			offsets[i] = (allocateInfo.allocationSize + memoryRequirements.alignment - 1) & ~(memoryRequirements.alignment - 1);
+			allocateInfo.allocationSize = offsets[i] + memoryRequirements.size;
+			memoryTypeBits &= memoryRequirements.memoryTypeBits;
+		}
+
+		allocateInfo.memoryTypeIndex = Util::getMemoryTypeIndex(physicalDevice, memoryTypeBits);
+
+		memory = device.allocateMemory(allocateInfo);
+
+		device.bindBufferMemory(buffers[0], memory, offsets[0]);
+		device.bindBufferMemory(buffers[1], memory, offsets[1]);
+
+		std::array<vk::DescriptorSetLayoutBinding, 2> bindings;
+		for(uint32_t i = 0; i < bindings.size(); i++)
+		{
+			bindings[i].binding = i;
+			bindings[i].descriptorType = vk::DescriptorType::eStorageBuffer;
+			bindings[i].descriptorCount = 1;
+			bindings[i].stageFlags = vk::ShaderStageFlagBits::eCompute;
+		}
+
+		vk::DescriptorSetLayoutCreateInfo layoutInfo;
+		layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+		layoutInfo.pBindings = bindings.data();
+
+		descriptorSetLayout = device.createDescriptorSetLayout(layoutInfo);
+
+		vk::PipelineLayoutCreateInfo pipelineLayoutInfo;
+		pipelineLayoutInfo.setLayoutCount = 1;
+		pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout;
+
+		pipelineLayout = device.createPipelineLayout(pipelineLayoutInfo);
+
+		auto spirv = Util::compileGLSLtoSPIRV(shader.c_str(), EShLanguage::EShLangCompute);
+
+		vk::ShaderModuleCreateInfo moduleInfo;
+		moduleInfo.codeSize = spirv.size() * sizeof(uint32_t);
+		moduleInfo.pCode = spirv.data();
+
+		shaderModule = device.createShaderModule(moduleInfo);
+
+		vk::ComputePipelineCreateInfo pipelineInfo;
+		pipelineInfo.stage.stage = vk::ShaderStageFlagBits::eCompute;
+		pipelineInfo.stage.module = shaderModule;
+		pipelineInfo.stage.pName = "main";
+		pipelineInfo.layout = pipelineLayout;
+
+		pipeline = device.createComputePipeline(nullptr, pipelineInfo).value;
+
+		vk::DescriptorPoolSize poolSize(vk::DescriptorType::eStorageBuffer, 2);
+
+		vk::DescriptorPoolCreateInfo poolInfo;
+		poolInfo.maxSets = 1;
+		poolInfo.poolSizeCount = 1;
+		poolInfo.pPoolSizes = &poolSize;
+
+		descriptorPool = device.createDescriptorPool(poolInfo);
+
+		vk::DescriptorSetAllocateInfo setInfo;
+		setInfo.descriptorPool = descriptorPool;
+		setInfo.descriptorSetCount = 1;
+		setInfo.pSetLayouts = &descriptorSetLayout;
+
+		descriptorSet = device.allocateDescriptorSets(setInfo)[0];
+
+		std::array<vk::DescriptorBufferInfo, 2> bufferInfos = {
+			vk::DescriptorBufferInfo(buffers[0], 0, VK_WHOLE_SIZE),
+			vk::DescriptorBufferInfo(buffers[1], 0, VK_WHOLE_SIZE),
+		};
+
+		vk::WriteDescriptorSet write;
+		write.dstSet = descriptorSet;
+		write.dstBinding = 0;
+		write.descriptorCount = static_cast<uint32_t>(bufferInfos.size());
+		write.descriptorType = vk::DescriptorType::eStorageBuffer;
+		write.pBufferInfo = bufferInfos.data();
+
+		device.updateDescriptorSets(1, &write, 0, nullptr);
+
+		vk::CommandPoolCreateInfo commandPoolInfo;
+		commandPoolInfo.queueFamilyIndex = tester.getQueueFamilyIndex();
+
+		commandPool = device.createCommandPool(commandPoolInfo);
+
+		vk::CommandBufferAllocateInfo commandBufferInfo;
+		commandBufferInfo.commandPool = commandPool;
+		commandBufferInfo.commandBufferCount = 1;
+
+		commandBuffer = device.allocateCommandBuffers(commandBufferInfo)[0];
+
+		commandBuffer.begin(vk::CommandBufferBeginInfo());
+		commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, pipeline);
+		commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, pipelineLayout, 0, 1, &descriptorSet, 0, nullptr);
+		commandBuffer.dispatch(groupCount, 1, 1);
+		commandBuffer.end();
+	}
+
+	~StorageBufferBenchmark()
+	{
+		auto &device = tester.getDevice();
+
+		device.freeCommandBuffers(commandPool, 1, &commandBuffer);
+		device.destroyCommandPool(commandPool);
+		device.destroyPipeline(pipeline);
+		device.destroyShaderModule(shaderModule);
+		device.destroyPipelineLayout(pipelineLayout);
+		device.destroyDescriptorPool(descriptorPool);
+		device.destroyDescriptorSetLayout(descriptorSetLayout);
+		device.freeMemory(memory);
+		for(auto &buffer : buffers)
+		{
+			device.destroyBuffer(buffer);
+		}
+	}
+
+	void run()
+	{
+		vk::SubmitInfo submitInfo;
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &commandBuffer;
+
+		tester.getQueue().submit(1, &submitInfo, nullptr);
+		tester.getQueue().waitIdle();
+	}
+
+private:
+	VulkanTester tester;
+	std::array<vk::Buffer, 2> buffers;            // Owning handles
+	vk::DeviceMemory memory;                      // Owning handle
+	vk::DescriptorSetLayout descriptorSetLayout;  // Owning handle
+	vk::PipelineLayout pipelineLayout;            // Owning handle
+	vk::ShaderModule shaderModule;                // Owning handle
+	vk::Pipeline pipeline;                        // Owning handle
+	vk::DescriptorPool descriptorPool;            // Owning handle
+	vk::CommandPool commandPool;                  // Owning handle
+	vk::CommandBuffer commandBuffer;              // Owned by the pool
+	vk::DescriptorSet descriptorSet;              // Owned by the pool
+};
+
+enum class Precision
+{
+	Float32,
+	Float16,
+	Int8
+};
+
+// Streams a storage buffer through a multiply-add compute shader, with the
+// buffer elements held at different precisions. Narrower elements move fewer
+// bytes per invocation for the same amount of arithmetic.
+static void StreamStorageBuffer(benchmark::State &state, Precision precision)
+{
+	uint32_t elementCount = static_cast<uint32_t>(state.range(0));
+
+	const char *elementType = "vec4";
+	vk::DeviceSize elementSize = 4 * sizeof(float);
+	switch(precision)
+	{
+	case Precision::Float32:
+		break;
+	case Precision::Float16:
+		elementType = "f16vec4";
+		elementSize = 4 * sizeof(uint16_t);
+		break;
+	case Precision::Int8:
+		elementType = "i8vec4";
+		elementSize = 4 * sizeof(int8_t);
+		break;
+	}
+
+	std::string shader = std::string(R"(#version 450
+		#extension GL_EXT_shader_explicit_arithmetic_types : require
+		layout(local_size_x = 64) in;
+
+		#define T )") + elementType + R"(
+		layout(binding = 0, std430) readonly buffer In
+		{
+			T src[];
+		};
+		layout(binding = 1, std430) writeonly buffer Out
+		{
+			T dst[];
+		};
+
+		void main()
+		{
+			uint i = gl_GlobalInvocationID.x;
+			dst[i] = src[i] * T(3) + T(1);
+		})";
+
+	StorageBufferBenchmark benchmark;
+	benchmark.initialize(shader, elementCount * elementSize, elementCount * elementSize, elementCount / 64);
+
+	// Warmup
+	benchmark.run();
+
+	for(auto _ : state)
+	{
+		benchmark.run();
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.SetBytesProcessed(state.iterations() * 2 * elementCount * elementSize);
+}
+
+// Sums each workgroup's elements with a tree reduction in shared memory, which
+// needs a workgroup barrier per level of the tree. The levels are either
+// unrolled, with all the barriers at the top level of the shader, or in a loop.
+static void ReduceWorkgroup(benchmark::State &state, bool unrolled)
+{
+	uint32_t elementCount = static_cast<uint32_t>(state.range(0));
+	const uint32_t workgroupSize = 64;
+
+	std::string shader = std::string(R"(#version 450
+		layout(local_size_x = 64) in;
+
+		layout(binding = 0, std430) readonly buffer In
+		{
+			float src[];
+		};
+		layout(binding = 1, std430) writeonly buffer Out
+		{
+			float dst[];
+		};
+
+		shared float partial[64];
+
+		#define LEVEL(s) if(l < s) { partial[l] += partial[l + s]; } barrier();
+
+		void main()
+		{
+			uint l = gl_LocalInvocationID.x;
+			partial[l] = src[gl_GlobalInvocationID.x];
+			barrier();
+		)") + (unrolled ? R"(
+			LEVEL(32) LEVEL(16) LEVEL(8) LEVEL(4) LEVEL(2) LEVEL(1)
+		)" : R"(
+			for(uint s = 32; s > 0; s >>= 1)
+			{
+				LEVEL(s)
+			}
+		)") + R"(
+			if(l == 0)
+			{
+				dst[gl_WorkGroupID.x] = partial[0];
+			}
+		})";
+
+	StorageBufferBenchmark benchmark;
+	benchmark.initialize(shader, elementCount * sizeof(float), elementCount / workgroupSize * sizeof(float), elementCount / workgroupSize);
+
+	// Warmup
+	benchmark.run();
+
+	for(auto _ : state)
+	{
+		benchmark.run();
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_CAPTURE(StreamStorageBuffer, Float32, Precision::Float32)->RangeMultiplier(16)->Range(4096, 1 << 20)->ArgName("elements")->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(StreamStorageBuffer, Float16, Precision::Float16)->RangeMultiplier(16)->Range(4096, 1 << 20)->ArgName("elements")->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(StreamStorageBuffer, Int8, Precision::Int8)->RangeMultiplier(16)->Range(4096, 1 << 20)->ArgName("elements")->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(ReduceWorkgroup, Unrolled, true)->RangeMultiplier(16)->Range(4096, 1 << 20)->ArgName("elements")->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(ReduceWorkgroup, Loop, false)->RangeMultiplier(16)->Range(4096, 1 << 20)->ArgName("elements")->Unit(benchmark::kMillisecond);
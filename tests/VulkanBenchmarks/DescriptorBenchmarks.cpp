@@ -0,0 +1,455 @@
+// Copyright 2021 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "Image.hpp"
+#include "Util.hpp"
+#include "VulkanTester.hpp"
+#include "benchmark/benchmark.h"
+
+#include <array>
+#include <memory>
+#include <vector>
+
+class DescriptorUpdateBenchmark
+{
+public:
+	void initialize(uint32_t descriptorCount)
+	{
+		tester.initialize();
+		auto &device = tester.getDevice();
+		auto &physicalDevice = tester.getPhysicalDevice();
+
+		vk::ImageCreateInfo imageInfo;
+		imageInfo.imageType = vk::ImageType::e2D;
+		imageInfo.format = vk::Format::eR8G8B8A8Unorm;
+		imageInfo.tiling = vk::ImageTiling::eOptimal;
+		imageInfo.initialLayout = vk::ImageLayout::eUndefined;
+		imageInfo.usage = vk::ImageUsageFlagBits::eSampled;
+		imageInfo.samples = vk::SampleCountFlagBits::e1;
+		imageInfo.extent = vk::Extent3D(256, 256, 1);
+		imageInfo.mipLevels = 9;
+		imageInfo.arrayLayers = 1;
+
+		image = device.createImage(imageInfo);
+
+		vk::MemoryRequirements memoryRequirements = device.getImageMemoryRequirements(image);
+
+		vk::MemoryAllocateInfo allocateInfo;
+		allocateInfo.allocationSize = memoryRequirements.size;
+		allocateInfo.memoryTypeIndex = Util::getMemoryTypeIndex(physicalDevice, memoryRequirements.memoryTypeBits);
+
+		memory = device.allocateMemory(allocateInfo);
+
+		device.bindImageMemory(image, memory, 0);
+
+		vk::ImageViewCreateInfo imageViewInfo;
+		imageViewInfo.image = image;
+		imageViewInfo.viewType = vk::ImageViewType::e2D;
+		imageViewInfo.format = imageInfo.format;
+		imageViewInfo.subresourceRange = vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, imageInfo.mipLevels, 0, 1);
+
+		imageView = device.createImageView(imageViewInfo);
+
+		sampler = device.createSampler(vk::SamplerCreateInfo());
+
+		vk::DescriptorSetLayoutBinding binding;
+		binding.binding = 0;
+		binding.descriptorType = vk::DescriptorType::eCombinedImageSampler;
+		binding.descriptorCount = descriptorCount;
+		binding.stageFlags = vk::ShaderStageFlagBits::eFragment;
+
+		vk::DescriptorSetLayoutCreateInfo layoutInfo;
+		layoutInfo.bindingCount = 1;
+		layoutInfo.pBindings = &binding;
+
+		descriptorSetLayout = device.createDescriptorSetLayout(layoutInfo);
+
+		vk::DescriptorPoolSize poolSize(vk::DescriptorType::eCombinedImageSampler, descriptorCount);
+
+		vk::DescriptorPoolCreateInfo poolInfo;
+		poolInfo.maxSets = 2;
+		poolInfo.poolSizeCount = 1;
+		poolInfo.pPoolSizes = &poolSize;
+
+		descriptorPool = device.createDescriptorPool(poolInfo);
+
+		std::vector<vk::DescriptorSetLayout> layouts(2, descriptorSetLayout);
+
+		vk::DescriptorSetAllocateInfo setInfo;
+		setInfo.descriptorPool = descriptorPool;
+		setInfo.descriptorSetCount = 2;
+		setInfo.pSetLayouts = layouts.data();
+
+		auto sets = device.allocateDescriptorSets(setInfo);
+		srcSet = sets[0];
+		dstSet = sets[1];
+
+		imageInfos.resize(descriptorCount, vk::DescriptorImageInfo(sampler, imageView, vk::ImageLayout::eShaderReadOnlyOptimal));
+
+		write.dstSet = srcSet;
+		write.dstBinding = 0;
+		write.descriptorCount = descriptorCount;
+		write.descriptorType = vk::DescriptorType::eCombinedImageSampler;
+		write.pImageInfo = imageInfos.data();
+
+		copy.srcSet = srcSet;
+		copy.dstSet = dstSet;
+		copy.descriptorCount = descriptorCount;
+	}
+
+	~DescriptorUpdateBenchmark()
+	{
+		auto &device = tester.getDevice();
+
+		device.destroyDescriptorPool(descriptorPool);
+		device.destroyDescriptorSetLayout(descriptorSetLayout);
+		device.destroySampler(sampler);
+		device.destroyImageView(imageView);
+		device.freeMemory(memory);
+		device.destroyImage(image);
+	}
+
+	void writeDescriptors()
+	{
+		tester.getDevice().updateDescriptorSets(1, &write, 0, nullptr);
+	}
+
+	void copyDescriptors()
+	{
+		tester.getDevice().updateDescriptorSets(0, nullptr, 1, &copy);
+	}
+
+private:
+	VulkanTester tester;
+	vk::Image image;                              // Owning handle
+	vk::DeviceMemory memory;                      // Owning handle
+	vk::ImageView imageView;                      // Owning handle
+	vk::Sampler sampler;                          // Owning handle
+	vk::DescriptorSetLayout descriptorSetLayout;  // Owning handle
+	vk::DescriptorPool descriptorPool;            // Owning handle
+	vk::DescriptorSet srcSet;                     // Owned by the pool
+	vk::DescriptorSet dstSet;                     // Owned by the pool
+	std::vector<vk::DescriptorImageInfo> imageInfos;
+	vk::WriteDescriptorSet write;
+	vk::CopyDescriptorSet copy;
+};
+
+static void WriteSampledImageDescriptors(benchmark::State &state)
+{
+	DescriptorUpdateBenchmark benchmark;
+	benchmark.initialize(static_cast<uint32_t>(state.range(0)));
+
+	for(auto _ : state)
+	{
+		benchmark.writeDescriptors();
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void CopySampledImageDescriptors(benchmark::State &state)
+{
+	DescriptorUpdateBenchmark benchmark;
+	benchmark.initialize(static_cast<uint32_t>(state.range(0)));
+	benchmark.writeDescriptors();
+
+	for(auto _ : state)
+	{
+		benchmark.copyDescriptors();
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Dispatches one workgroup per texture, either by binding a separate
+// descriptor set for each dispatch, or by binding one descriptor set holding
+// all textures once and selecting the texture with a push constant.
+class DescriptorIndexingBenchmark
+{
+public:
+	enum class Binding
+	{
+		PerDispatch,
+		Bindless
+	};
+
+	void initialize(uint32_t textureCount, Binding binding)
+	{
+		tester.initialize();
+		auto &device = tester.getDevice();
+		auto &physicalDevice = tester.getPhysicalDevice();
+
+		texture = std::make_unique<Image>(device, physicalDevice, 16, 16, vk::Format::eR8G8B8A8Unorm);
+		sampler = device.createSampler(vk::SamplerCreateInfo());
+
+		vk::BufferCreateInfo bufferInfo;
+		bufferInfo.size = 16;
+		bufferInfo.usage = vk::BufferUsageFlagBits::eStorageBuffer;
+		buffer = device.createBuffer(bufferInfo);
+
+		vk::MemoryRequirements memoryRequirements = device.getBufferMemoryRequirements(buffer);
+
+		vk::MemoryAllocateInfo allocateInfo;
+		allocateInfo.allocationSize = memoryRequirements.size;
+		allocateInfo.memoryTypeIndex = Util::getMemoryTypeIndex(physicalDevice, memoryRequirements.memoryTypeBits);
+
+		memory = device.allocateMemory(allocateInfo);
+
+		device.bindBufferMemory(buffer, memory, 0);
+
+		const bool bindless = (binding == Binding::Bindless);
+		const uint32_t setCount = bindless ? 1 : textureCount;
+		const uint32_t texturesPerSet = bindless ? textureCount : 1;
+
+		std::vector<vk::DescriptorSetLayoutBinding> bindings(2);
+		bindings[0].binding = 0;
+		bindings[0].descriptorType = vk::DescriptorType::eCombinedImageSampler;
+		bindings[0].descriptorCount = texturesPerSet;
+		bindings[0].stageFlags = vk::ShaderStageFlagBits::eCompute;
+		bindings[1].binding = 1;
+		bindings[1].descriptorType = vk::DescriptorType::eStorageBuffer;
+		bindings[1].descriptorCount = 1;
+		bindings[1].stageFlags = vk::ShaderStageFlagBits::eCompute;
+
+		std::vector<vk::DescriptorBindingFlags> bindingFlags(2);
+		bindingFlags[0] = vk::DescriptorBindingFlagBits::eUpdateAfterBind | vk::DescriptorBindingFlagBits::ePartiallyBound;
+
+		vk::DescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo;
+		bindingFlagsInfo.bindingCount = static_cast<uint32_t>(bindingFlags.size());
+		bindingFlagsInfo.pBindingFlags = bindingFlags.data();
+
+		vk::DescriptorSetLayoutCreateInfo layoutInfo;
+		layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+		layoutInfo.pBindings = bindings.data();
+		if(bindless)
+		{
+			layoutInfo.pNext = &bindingFlagsInfo;
+			layoutInfo.flags = vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool;
+		}
+
+		descriptorSetLayout = device.createDescriptorSetLayout(layoutInfo);
+
+		vk::PushConstantRange pushConstantRange(vk::ShaderStageFlagBits::eCompute, 0, sizeof(uint32_t));
+
+		vk::PipelineLayoutCreateInfo pipelineLayoutInfo;
+		pipelineLayoutInfo.setLayoutCount = 1;
+		pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout;
+		pipelineLayoutInfo.pushConstantRangeCount = 1;
+		pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+		pipelineLayout = device.createPipelineLayout(pipelineLayoutInfo);
+
+		const char *perDispatchShader = R"(#version 450
+			layout(local_size_x = 1) in;
+
+			layout(binding = 0) uniform sampler2D tex;
+			layout(binding = 1, std430) buffer Result
+			{
+				vec4 color;
+			};
+
+			void main()
+			{
+				color = textureLod(tex, vec2(0.5), 0.0);
+			})";
+
+		const char *bindlessShader = R"(#version 450
+			#extension GL_EXT_nonuniform_qualifier : require
+			layout(local_size_x = 1) in;
+
+			layout(push_constant) uniform PushConstants
+			{
+				uint index;
+			};
+			layout(binding = 0) uniform sampler2D textures[];
+			layout(binding = 1, std430) buffer Result
+			{
+				vec4 color;
+			};
+
+			void main()
+			{
+				color = textureLod(textures[index], vec2(0.5), 0.0);
+			})";
+
+		auto spirv = Util::compileGLSLtoSPIRV(bindless ? bindlessShader : perDispatchShader, EShLanguage::EShLangCompute);
+
+		vk::ShaderModuleCreateInfo moduleInfo;
+		moduleInfo.codeSize = spirv.size() * sizeof(uint32_t);
+		moduleInfo.pCode = spirv.data();
+
+		shaderModule = device.createShaderModule(moduleInfo);
+
+		vk::ComputePipelineCreateInfo pipelineInfo;
+		pipelineInfo.stage.stage = vk::ShaderStageFlagBits::eCompute;
+		pipelineInfo.stage.module = shaderModule;
+		pipelineInfo.stage.pName = "main";
+		pipelineInfo.layout = pipelineLayout;
+
+		pipeline = device.createComputePipeline(nullptr, pipelineInfo).value;
+
+		std::vector<vk::DescriptorPoolSize> poolSizes = {
+			vk::DescriptorPoolSize(vk::DescriptorType::eCombinedImageSampler, textureCount),
+			vk::DescriptorPoolSize(vk::DescriptorType::eStorageBuffer, setCount),
+		};
+
+		vk::DescriptorPoolCreateInfo poolInfo;
+		poolInfo.maxSets = setCount;
+		poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+		poolInfo.pPoolSizes = poolSizes.data();
+		if(bindless)
+		{
+			poolInfo.flags = vk::DescriptorPoolCreateFlagBits::eUpdateAfterBind;
+		}
+
+		descriptorPool = device.createDescriptorPool(poolInfo);
+
+		std::vector<vk::DescriptorSetLayout> layouts(setCount, descriptorSetLayout);
+
+		vk::DescriptorSetAllocateInfo setInfo;
+		setInfo.descriptorPool = descriptorPool;
+		setInfo.descriptorSetCount = setCount;
+		setInfo.pSetLayouts = layouts.data();
+
+		descriptorSets = device.allocateDescriptorSets(setInfo);
+
+		std::vector<vk::DescriptorImageInfo> imageInfos(texturesPerSet, vk::DescriptorImageInfo(sampler, texture->getImageView(), vk::ImageLayout::eGeneral));
+		vk::DescriptorBufferInfo bufferDescriptorInfo(buffer, 0, VK_WHOLE_SIZE);
+
+		for(auto &descriptorSet : descriptorSets)
+		{
+			std::array<vk::WriteDescriptorSet, 2> writes = {};
+
+			writes[0].dstSet = descriptorSet;
+			writes[0].dstBinding = 0;
+			writes[0].descriptorCount = texturesPerSet;
+			writes[0].descriptorType = vk::DescriptorType::eCombinedImageSampler;
+			writes[0].pImageInfo = imageInfos.data();
+
+			writes[1].dstSet = descriptorSet;
+			writes[1].dstBinding = 1;
+			writes[1].descriptorCount = 1;
+			writes[1].descriptorType = vk::DescriptorType::eStorageBuffer;
+			writes[1].pBufferInfo = &bufferDescriptorInfo;
+
+			device.updateDescriptorSets(static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+		}
+
+		vk::CommandPoolCreateInfo commandPoolInfo;
+		commandPoolInfo.queueFamilyIndex = tester.getQueueFamilyIndex();
+
+		commandPool = device.createCommandPool(commandPoolInfo);
+
+		vk::CommandBufferAllocateInfo commandBufferInfo;
+		commandBufferInfo.commandPool = commandPool;
+		commandBufferInfo.commandBufferCount = 1;
+
+		commandBuffer = device.allocateCommandBuffers(commandBufferInfo)[0];
+
+		Util::transitionImageLayout(device, commandPool, tester.getQueue(), texture->getImage(), vk::Format::eR8G8B8A8Unorm, vk::ImageLayout::eUndefined, vk::ImageLayout::eGeneral);
+
+		this->textureCount = textureCount;
+		this->binding = binding;
+	}
+
+	~DescriptorIndexingBenchmark()
+	{
+		auto &device = tester.getDevice();
+
+		device.freeCommandBuffers(commandPool, 1, &commandBuffer);
+		device.destroyCommandPool(commandPool);
+		device.destroyPipeline(pipeline);
+		device.destroyShaderModule(shaderModule);
+		device.destroyPipelineLayout(pipelineLayout);
+		device.destroyDescriptorPool(descriptorPool);
+		device.destroyDescriptorSetLayout(descriptorSetLayout);
+		device.freeMemory(memory);
+		device.destroyBuffer(buffer);
+		device.destroySampler(sampler);
+		texture.reset();
+	}
+
+	// Records and executes one dispatch per texture.
+	void run()
+	{
+		commandBuffer.begin(vk::CommandBufferBeginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+		commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, pipeline);
+
+		if(binding == Binding::Bindless)
+		{
+			commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, pipelineLayout, 0, 1, &descriptorSets[0], 0, nullptr);
+		}
+
+		for(uint32_t i = 0; i < textureCount; i++)
+		{
+			if(binding == Binding::Bindless)
+			{
+				commandBuffer.pushConstants(pipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, sizeof(uint32_t), &i);
+			}
+			else
+			{
+				commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, pipelineLayout, 0, 1, &descriptorSets[i], 0, nullptr);
+			}
+
+			commandBuffer.dispatch(1, 1, 1);
+		}
+
+		commandBuffer.end();
+
+		vk::SubmitInfo submitInfo;
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &commandBuffer;
+
+		tester.getQueue().submit(1, &submitInfo, nullptr);
+		tester.getQueue().waitIdle();
+	}
+
+private:
+	VulkanTester tester;
+	std::unique_ptr<Image> texture;
+	vk::Sampler sampler;                            // Owning handle
+	vk::Buffer buffer;                              // Owning handle
+	vk::DeviceMemory memory;                        // Owning handle
+	vk::DescriptorSetLayout descriptorSetLayout;    // Owning handle
+	vk::PipelineLayout pipelineLayout;              // Owning handle
+	vk::ShaderModule shaderModule;                  // Owning handle
+	vk::Pipeline pipeline;                          // Owning handle
+	vk::DescriptorPool descriptorPool;              // Owning handle
+	vk::CommandPool commandPool;                    // Owning handle
+	vk::CommandBuffer commandBuffer;                // Owned by the pool
+	std::vector<vk::DescriptorSet> descriptorSets;  // Owned by the pool
+	uint32_t textureCount = 0;
+	Binding binding = Binding::PerDispatch;
+};
+
+static void DispatchWithDescriptorIndexing(benchmark::State &state, DescriptorIndexingBenchmark::Binding binding)
+{
+	DescriptorIndexingBenchmark benchmark;
+	benchmark.initialize(static_cast<uint32_t>(state.range(0)), binding);
+
+	// Warmup
+	benchmark.run();
+
+	for(auto _ : state)
+	{
+		benchmark.run();
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(WriteSampledImageDescriptors)->RangeMultiplier(8)->Range(8, 4096)->ArgName("descriptors")->Unit(benchmark::kMicrosecond);
+BENCHMARK(CopySampledImageDescriptors)->RangeMultiplier(8)->Range(8, 4096)->ArgName("descriptors")->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(DispatchWithDescriptorIndexing, PerDispatchSets, DescriptorIndexingBenchmark::Binding::PerDispatch)->RangeMultiplier(8)->Range(8, 4096)->ArgName("textures")->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(DispatchWithDescriptorIndexing, BindlessSet, DescriptorIndexingBenchmark::Binding::Bindless)->RangeMultiplier(8)->Range(8, 4096)->ArgName("textures")->Unit(benchmark::kMillisecond);
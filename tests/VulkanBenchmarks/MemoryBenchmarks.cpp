@@ -0,0 +1,229 @@
+// Copyright 2021 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "Util.hpp"
+#include "VulkanTester.hpp"
+#include "benchmark/benchmark.h"
+
+#include <cstdio>
+#include <vector>
+
+#if defined(__linux__)
+#	include <unistd.h>
+#endif
+
+// Returns the resident set size of the process in bytes, or 0 if unknown.
+static size_t residentSetSize()
+{
+#if defined(__linux__)
+	size_t size = 0;
+	size_t resident = 0;
+	if(FILE *statm = fopen("/proc/self/statm", "r"))
+	{
+		if(fscanf(statm, "%zu %zu", &size, &resident) != 2)
+		{
+			resident = 0;
+		}
+		fclose(statm);
+	}
+
+	return resident * sysconf(_SC_PAGESIZE);
+#else
+	return 0;
+#endif
+}
+
+// Measures the latency of vkAllocateMemory() followed by vkFreeMemory(), and
+// how much the resident set grows per allocation which is never written to.
+static void AllocateMemory(benchmark::State &state)
+{
+	VulkanTester tester;
+	tester.initialize();
+	auto &device = tester.getDevice();
+
+	vk::MemoryAllocateInfo allocateInfo;
+	allocateInfo.allocationSize = state.range(0);
+	allocateInfo.memoryTypeIndex = Util::getMemoryTypeIndex(tester.getPhysicalDevice(), ~0u);
+
+	for(auto _ : state)
+	{
+		vk::DeviceMemory memory = device.allocateMemory(allocateInfo);
+		device.freeMemory(memory);
+	}
+
+	constexpr int allocationCount = 4;
+	std::vector<vk::DeviceMemory> allocations;
+
+	size_t residentBefore = residentSetSize();
+	for(int i = 0; i < allocationCount; i++)
+	{
+		allocations.push_back(device.allocateMemory(allocateInfo));
+	}
+	size_t residentAfter = residentSetSize();
+
+	for(auto memory : allocations)
+	{
+		device.freeMemory(memory);
+	}
+
+	state.counters["RSSGrowth"] = benchmark::Counter(static_cast<double>(residentAfter - residentBefore) / allocationCount, benchmark::Counter::kDefaults, benchmark::Counter::kIs1024);
+	state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(AllocateMemory)->RangeMultiplier(16)->Range(64 << 10, 256 << 20)->ArgName("bytes")->Unit(benchmark::kMicrosecond);
+
+// Measures a render pass which clears a transient 4x multisampled attachment and
+// doesn't store it, and how much of the attachment stays resident afterwards.
+static void TransientAttachment(benchmark::State &state, bool lazilyAllocated)
+{
+	VulkanTester tester;
+	tester.initialize();
+	auto &device = tester.getDevice();
+	auto &physicalDevice = tester.getPhysicalDevice();
+
+	const vk::Format format = vk::Format::eR8G8B8A8Unorm;
+	const vk::Extent2D extent = { 1024, 1024 };
+
+	vk::ImageCreateInfo imageInfo;
+	imageInfo.imageType = vk::ImageType::e2D;
+	imageInfo.format = format;
+	imageInfo.tiling = vk::ImageTiling::eOptimal;
+	imageInfo.initialLayout = vk::ImageLayout::eUndefined;
+	imageInfo.usage = vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransientAttachment;
+	imageInfo.samples = vk::SampleCountFlagBits::e4;
+	imageInfo.extent = vk::Extent3D(extent.width, extent.height, 1);
+	imageInfo.mipLevels = 1;
+	imageInfo.arrayLayers = 1;
+
+	vk::Image image = device.createImage(imageInfo);
+
+	vk::MemoryRequirements memoryRequirements = device.getImageMemoryRequirements(image);
+
+	vk::MemoryPropertyFlags properties = lazilyAllocated ? vk::MemoryPropertyFlagBits::eLazilyAllocated : vk::MemoryPropertyFlags{};
+
+	vk::MemoryAllocateInfo allocateInfo;
+	allocateInfo.allocationSize = memoryRequirements.size;
+	allocateInfo.memoryTypeIndex = Util::getMemoryTypeIndex(physicalDevice, memoryRequirements.memoryTypeBits, properties);
+
+	size_t residentBefore = residentSetSize();
+
+	vk::DeviceMemory memory = device.allocateMemory(allocateInfo);
+	device.bindImageMemory(image, memory, 0);
+
+	vk::ImageViewCreateInfo imageViewInfo;
+	imageViewInfo.image = image;
+	imageViewInfo.viewType = vk::ImageViewType::e2D;
+	imageViewInfo.format = format;
+	imageViewInfo.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
+	imageViewInfo.subresourceRange.baseMipLevel = 0;
+	imageViewInfo.subresourceRange.levelCount = 1;
+	imageViewInfo.subresourceRange.baseArrayLayer = 0;
+	imageViewInfo.subresourceRange.layerCount = 1;
+
+	vk::ImageView imageView = device.createImageView(imageViewInfo);
+
+	vk::AttachmentDescription attachment;
+	attachment.format = format;
+	attachment.samples = vk::SampleCountFlagBits::e4;
+	attachment.loadOp = vk::AttachmentLoadOp::eClear;
+	attachment.storeOp = vk::AttachmentStoreOp::eDontCare;
+	attachment.stencilLoadOp = vk::AttachmentLoadOp::eDontCare;
+	attachment.stencilStoreOp = vk::AttachmentStoreOp::eDontCare;
+	attachment.initialLayout = vk::ImageLayout::eUndefined;
+	attachment.finalLayout = vk::ImageLayout::eColorAttachmentOptimal;
+
+	vk::AttachmentReference colorReference(0, vk::ImageLayout::eColorAttachmentOptimal);
+
+	vk::SubpassDescription subpass;
+	subpass.pipelineBindPoint = vk::PipelineBindPoint::eGraphics;
+	subpass.colorAttachmentCount = 1;
+	subpass.pColorAttachments = &colorReference;
+
+	vk::RenderPassCreateInfo renderPassInfo;
+	renderPassInfo.attachmentCount = 1;
+	renderPassInfo.pAttachments = &attachment;
+	renderPassInfo.subpassCount = 1;
+	renderPassInfo.pSubpasses = &subpass;
+
+	vk::RenderPass renderPass = device.createRenderPass(renderPassInfo);
+
+	vk::FramebufferCreateInfo framebufferInfo;
+	framebufferInfo.renderPass = renderPass;
+	framebufferInfo.attachmentCount = 1;
+	framebufferInfo.pAttachments = &imageView;
+	framebufferInfo.width = extent.width;
+	framebufferInfo.height = extent.height;
+	framebufferInfo.layers = 1;
+
+	vk::Framebuffer framebuffer = device.createFramebuffer(framebufferInfo);
+
+	vk::CommandPoolCreateInfo commandPoolCreateInfo;
+	commandPoolCreateInfo.queueFamilyIndex = tester.getQueueFamilyIndex();
+
+	vk::CommandPool commandPool = device.createCommandPool(commandPoolCreateInfo);
+
+	vk::CommandBufferAllocateInfo commandBufferAllocateInfo;
+	commandBufferAllocateInfo.commandPool = commandPool;
+	commandBufferAllocateInfo.commandBufferCount = 1;
+
+	vk::CommandBuffer commandBuffer = device.allocateCommandBuffers(commandBufferAllocateInfo)[0];
+
+	vk::ClearValue clearValue;
+	clearValue.color.float32[0] = 0.0f;
+	clearValue.color.float32[1] = 1.0f;
+	clearValue.color.float32[2] = 0.0f;
+	clearValue.color.float32[3] = 1.0f;
+
+	vk::RenderPassBeginInfo renderPassBeginInfo;
+	renderPassBeginInfo.renderPass = renderPass;
+	renderPassBeginInfo.framebuffer = framebuffer;
+	renderPassBeginInfo.renderArea.extent = extent;
+	renderPassBeginInfo.clearValueCount = 1;
+	renderPassBeginInfo.pClearValues = &clearValue;
+
+	commandBuffer.begin(vk::CommandBufferBeginInfo());
+	commandBuffer.beginRenderPass(renderPassBeginInfo, vk::SubpassContents::eInline);
+	commandBuffer.endRenderPass();
+	commandBuffer.end();
+
+	vk::SubmitInfo submitInfo;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &commandBuffer;
+
+	for(auto _ : state)
+	{
+		tester.getQueue().submit(1, &submitInfo, nullptr);
+		tester.getQueue().waitIdle();
+	}
+
+	size_t residentAfter = residentSetSize();
+
+	if(lazilyAllocated)
+	{
+		state.counters["Committed"] = benchmark::Counter(static_cast<double>(device.getMemoryCommitment(memory)), benchmark::Counter::kDefaults, benchmark::Counter::kIs1024);
+	}
+
+	state.counters["RSSGrowth"] = benchmark::Counter(static_cast<double>(residentAfter) - static_cast<double>(residentBefore), benchmark::Counter::kDefaults, benchmark::Counter::kIs1024);
+
+	device.freeCommandBuffers(commandPool, 1, &commandBuffer);
+	device.destroyCommandPool(commandPool);
+	device.destroyFramebuffer(framebuffer);
+	device.destroyRenderPass(renderPass);
+	device.destroyImageView(imageView);
+	device.freeMemory(memory);
+	device.destroyImage(image);
+}
+
+BENCHMARK_CAPTURE(TransientAttachment, Generic, false)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(TransientAttachment, LazilyAllocated, true)->Unit(benchmark::kMillisecond);
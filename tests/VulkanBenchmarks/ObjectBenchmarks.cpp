@@ -0,0 +1,188 @@
+// Copyright 2021 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "Buffer.hpp"
+#include "Image.hpp"
+#include "VulkanTester.hpp"
+#include "benchmark/benchmark.h"
+
+#include <vector>
+
+// Creates a batch of objects and then destroys them on each iteration, the way
+// an application recreating its per-frame objects would.
+template<typename CreateFunction, typename DestroyFunction>
+static void CreateAndDestroy(benchmark::State &state, CreateFunction create, DestroyFunction destroy)
+{
+	std::vector<decltype(create())> objects(state.range(0));
+
+	for(auto _ : state)
+	{
+		for(auto &object : objects)
+		{
+			object = create();
+		}
+
+		for(auto &object : objects)
+		{
+			destroy(object);
+		}
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void CreateAndDestroyFences(benchmark::State &state)
+{
+	VulkanTester tester;
+	tester.initialize();
+	auto &device = tester.getDevice();
+
+	CreateAndDestroy(
+	    state,
+	    [&] { return device.createFence(vk::FenceCreateInfo()); },
+	    [&](vk::Fence fence) { device.destroyFence(fence); });
+}
+
+static void CreateAndDestroyEvents(benchmark::State &state)
+{
+	VulkanTester tester;
+	tester.initialize();
+	auto &device = tester.getDevice();
+
+	CreateAndDestroy(
+	    state,
+	    [&] { return device.createEvent(vk::EventCreateInfo()); },
+	    [&](vk::Event event) { device.destroyEvent(event); });
+}
+
+static void CreateAndDestroySemaphores(benchmark::State &state)
+{
+	VulkanTester tester;
+	tester.initialize();
+	auto &device = tester.getDevice();
+
+	CreateAndDestroy(
+	    state,
+	    [&] { return device.createSemaphore(vk::SemaphoreCreateInfo()); },
+	    [&](vk::Semaphore semaphore) { device.destroySemaphore(semaphore); });
+}
+
+static void CreateAndDestroySamplers(benchmark::State &state)
+{
+	VulkanTester tester;
+	tester.initialize();
+	auto &device = tester.getDevice();
+
+	CreateAndDestroy(
+	    state,
+	    [&] { return device.createSampler(vk::SamplerCreateInfo()); },
+	    [&](vk::Sampler sampler) { device.destroySampler(sampler); });
+}
+
+static void CreateAndDestroyImageViews(benchmark::State &state)
+{
+	VulkanTester tester;
+	tester.initialize();
+	auto &device = tester.getDevice();
+
+	Image image(device, tester.getPhysicalDevice(), 256, 256, vk::Format::eR8G8B8A8Unorm);
+
+	vk::ImageViewCreateInfo imageViewInfo;
+	imageViewInfo.image = image.getImage();
+	imageViewInfo.viewType = vk::ImageViewType::e2D;
+	imageViewInfo.format = vk::Format::eR8G8B8A8Unorm;
+	imageViewInfo.subresourceRange = vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1);
+
+	CreateAndDestroy(
+	    state,
+	    [&] { return device.createImageView(imageViewInfo); },
+	    [&](vk::ImageView imageView) { device.destroyImageView(imageView); });
+}
+
+static void CreateAndDestroyBufferViews(benchmark::State &state)
+{
+	VulkanTester tester;
+	tester.initialize();
+	auto &device = tester.getDevice();
+
+	Buffer buffer(device, 4096, vk::BufferUsageFlagBits::eUniformTexelBuffer);
+
+	vk::BufferViewCreateInfo bufferViewInfo;
+	bufferViewInfo.buffer = buffer.getBuffer();
+	bufferViewInfo.format = vk::Format::eR32Sfloat;
+	bufferViewInfo.range = VK_WHOLE_SIZE;
+
+	CreateAndDestroy(
+	    state,
+	    [&] { return device.createBufferView(bufferViewInfo); },
+	    [&](vk::BufferView bufferView) { device.destroyBufferView(bufferView); });
+}
+
+static void CreateAndDestroyFramebuffers(benchmark::State &state)
+{
+	VulkanTester tester;
+	tester.initialize();
+	auto &device = tester.getDevice();
+
+	const vk::Format format = vk::Format::eR8G8B8A8Unorm;
+	Image image(device, tester.getPhysicalDevice(), 256, 256, format);
+
+	vk::AttachmentDescription attachment;
+	attachment.format = format;
+	attachment.samples = vk::SampleCountFlagBits::e1;
+	attachment.loadOp = vk::AttachmentLoadOp::eClear;
+	attachment.storeOp = vk::AttachmentStoreOp::eStore;
+	attachment.initialLayout = vk::ImageLayout::eUndefined;
+	attachment.finalLayout = vk::ImageLayout::eGeneral;
+
+	vk::AttachmentReference colorReference(0, vk::ImageLayout::eColorAttachmentOptimal);
+
+	vk::SubpassDescription subpass;
+	subpass.pipelineBindPoint = vk::PipelineBindPoint::eGraphics;
+	subpass.colorAttachmentCount = 1;
+	subpass.pColorAttachments = &colorReference;
+
+	vk::RenderPassCreateInfo renderPassInfo;
+	renderPassInfo.attachmentCount = 1;
+	renderPassInfo.pAttachments = &attachment;
+	renderPassInfo.subpassCount = 1;
+	renderPassInfo.pSubpasses = &subpass;
+
+	vk::RenderPass renderPass = device.createRenderPass(renderPassInfo);
+
+	vk::ImageView imageView = image.getImageView();
+
+	vk::FramebufferCreateInfo framebufferInfo;
+	framebufferInfo.renderPass = renderPass;
+	framebufferInfo.attachmentCount = 1;
+	framebufferInfo.pAttachments = &imageView;
+	framebufferInfo.width = 256;
+	framebufferInfo.height = 256;
+	framebufferInfo.layers = 1;
+
+	CreateAndDestroy(
+	    state,
+	    [&] { return device.createFramebuffer(framebufferInfo); },
+	    [&](vk::Framebuffer framebuffer) { device.destroyFramebuffer(framebuffer); });
+
+	device.destroyRenderPass(renderPass);
+}
+
+BENCHMARK(CreateAndDestroyFences)->RangeMultiplier(8)->Range(1, 4096)->ArgName("objects")->Unit(benchmark::kMicrosecond);
+BENCHMARK(CreateAndDestroyEvents)->RangeMultiplier(8)->Range(1, 4096)->ArgName("objects")->Unit(benchmark::kMicrosecond);
+BENCHMARK(CreateAndDestroySemaphores)->RangeMultiplier(8)->Range(1, 4096)->ArgName("objects")->Unit(benchmark::kMicrosecond);
+BENCHMARK(CreateAndDestroySamplers)->RangeMultiplier(8)->Range(1, 4096)->ArgName("objects")->Unit(benchmark::kMicrosecond);
+BENCHMARK(CreateAndDestroyImageViews)->RangeMultiplier(8)->Range(1, 4096)->ArgName("objects")->Unit(benchmark::kMicrosecond);
+BENCHMARK(CreateAndDestroyBufferViews)->RangeMultiplier(8)->Range(1, 4096)->ArgName("objects")->Unit(benchmark::kMicrosecond);
+BENCHMARK(CreateAndDestroyFramebuffers)->RangeMultiplier(8)->Range(1, 4096)->ArgName("objects")->Unit(benchmark::kMicrosecond);
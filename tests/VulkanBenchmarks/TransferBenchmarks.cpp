@@ -0,0 +1,180 @@
+// Copyright 2021 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "Buffer.hpp"
+#include "Util.hpp"
+#include "VulkanTester.hpp"
+#include "benchmark/benchmark.h"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Measures the bandwidth of transfer commands, by recording one into a command
+// buffer and timing its submission until the queue is idle.
+class TransferBenchmark
+{
+public:
+	TransferBenchmark()
+	{
+		tester.initialize();
+		auto &device = tester.getDevice();
+
+		vk::CommandPoolCreateInfo commandPoolCreateInfo;
+		commandPoolCreateInfo.queueFamilyIndex = tester.getQueueFamilyIndex();
+
+		commandPool = device.createCommandPool(commandPoolCreateInfo);
+
+		vk::CommandBufferAllocateInfo commandBufferAllocateInfo;
+		commandBufferAllocateInfo.commandPool = commandPool;
+		commandBufferAllocateInfo.commandBufferCount = 1;
+
+		commandBuffer = device.allocateCommandBuffers(commandBufferAllocateInfo)[0];
+	}
+
+	~TransferBenchmark()
+	{
+		auto &device = tester.getDevice();
+
+		if(image)
+		{
+			device.freeMemory(imageMemory);
+			device.destroyImage(image);
+		}
+
+		device.freeCommandBuffers(commandPool, 1, &commandBuffer);
+		device.destroyCommandPool(commandPool);
+	}
+
+	vk::Buffer createBuffer(vk::DeviceSize size)
+	{
+		buffers.push_back(std::make_unique<Buffer>(tester.getDevice(), size, vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst));
+
+		return buffers.back()->getBuffer();
+	}
+
+	vk::Image createImage(uint32_t width, uint32_t height)
+	{
+		auto &device = tester.getDevice();
+
+		vk::ImageCreateInfo imageInfo;
+		imageInfo.imageType = vk::ImageType::e2D;
+		imageInfo.format = vk::Format::eR8G8B8A8Unorm;
+		imageInfo.tiling = vk::ImageTiling::eOptimal;
+		imageInfo.initialLayout = vk::ImageLayout::eUndefined;
+		imageInfo.usage = vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eTransferDst;
+		imageInfo.samples = vk::SampleCountFlagBits::e1;
+		imageInfo.extent = vk::Extent3D(width, height, 1);
+		imageInfo.mipLevels = 1;
+		imageInfo.arrayLayers = 1;
+
+		image = device.createImage(imageInfo);
+
+		vk::MemoryRequirements memoryRequirements = device.getImageMemoryRequirements(image);
+
+		vk::MemoryAllocateInfo allocateInfo;
+		allocateInfo.allocationSize = memoryRequirements.size;
+		allocateInfo.memoryTypeIndex = Util::getMemoryTypeIndex(tester.getPhysicalDevice(), memoryRequirements.memoryTypeBits);
+
+		imageMemory = device.allocateMemory(allocateInfo);
+
+		device.bindImageMemory(image, imageMemory, 0);
+
+		return image;
+	}
+
+	void run(benchmark::State &state, size_t bytesPerIteration, const std::function<void(vk::CommandBuffer &)> &record)
+	{
+		commandBuffer.begin(vk::CommandBufferBeginInfo());
+		record(commandBuffer);
+		commandBuffer.end();
+
+		vk::SubmitInfo submitInfo;
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &commandBuffer;
+
+		for(auto _ : state)
+		{
+			tester.getQueue().submit(1, &submitInfo, nullptr);
+			tester.getQueue().waitIdle();
+		}
+
+		state.SetBytesProcessed(state.iterations() * bytesPerIteration);
+	}
+
+private:
+	VulkanTester tester;
+
+	vk::CommandPool commandPool;      // Owning handle
+	vk::CommandBuffer commandBuffer;  // Owning handle
+
+	std::vector<std::unique_ptr<Buffer>> buffers;
+	vk::Image image;               // Owning handle
+	vk::DeviceMemory imageMemory;  // Owning handle
+};
+
+static void CopyBuffer(benchmark::State &state)
+{
+	TransferBenchmark benchmark;
+	size_t size = state.range(0);
+
+	vk::Buffer src = benchmark.createBuffer(size);
+	vk::Buffer dst = benchmark.createBuffer(size);
+
+	benchmark.run(state, size, [&](vk::CommandBuffer &commandBuffer) {
+		commandBuffer.copyBuffer(src, dst, vk::BufferCopy(0, 0, size));
+	});
+}
+
+static void FillBuffer(benchmark::State &state)
+{
+	TransferBenchmark benchmark;
+	size_t size = state.range(0);
+
+	vk::Buffer dst = benchmark.createBuffer(size);
+
+	benchmark.run(state, size, [&](vk::CommandBuffer &commandBuffer) {
+		commandBuffer.fillBuffer(dst, 0, VK_WHOLE_SIZE, 0x12345678);
+	});
+}
+
+static void CopyImage(benchmark::State &state, bool toImage)
+{
+	TransferBenchmark benchmark;
+	uint32_t width = static_cast<uint32_t>(state.range(0));
+	size_t size = size_t(width) * width * 4;
+
+	vk::Buffer buffer = benchmark.createBuffer(size);
+	vk::Image image = benchmark.createImage(width, width);
+
+	vk::BufferImageCopy region;
+	region.imageSubresource = vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, 0, 0, 1);
+	region.imageExtent = vk::Extent3D(width, width, 1);
+
+	benchmark.run(state, size, [&](vk::CommandBuffer &commandBuffer) {
+		if(toImage)
+		{
+			commandBuffer.copyBufferToImage(buffer, image, vk::ImageLayout::eTransferDstOptimal, region);
+		}
+		else
+		{
+			commandBuffer.copyImageToBuffer(image, vk::ImageLayout::eTransferSrcOptimal, buffer, region);
+		}
+	});
+}
+
+BENCHMARK(CopyBuffer)->RangeMultiplier(16)->Range(64 << 10, 256 << 20)->ArgName("bytes")->Unit(benchmark::kMillisecond);
+BENCHMARK(FillBuffer)->RangeMultiplier(16)->Range(64 << 10, 256 << 20)->ArgName("bytes")->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(CopyImage, BufferToImage, true)->RangeMultiplier(4)->Range(256, 8192)->ArgName("width")->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(CopyImage, ImageToBuffer, false)->RangeMultiplier(4)->Range(256, 8192)->ArgName("width")->Unit(benchmark::kMillisecond);
@@ -16,7 +16,11 @@
 #include "DrawTester.hpp"
 #include "benchmark/benchmark.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
 #include <vector>
 
 template<typename T>
@@ -35,10 +39,8 @@ static void RunBenchmark(benchmark::State &state, T &tester)
 	}
 }
 
-static void TriangleSolidColor(benchmark::State &state, Multisample multisample)
+static void SetupSolidColorTriangle(DrawTester &tester)
 {
-	DrawTester tester(multisample);
-
 	tester.onCreateVertexBuffers([](DrawTester &tester) {
 		struct Vertex
 		{
@@ -82,10 +84,43 @@ static void TriangleSolidColor(benchmark::State &state, Multisample multisample)
 
 		return tester.createShaderModule(fragmentShader, EShLanguage::EShLangFragment);
 	});
+}
+
+static void TriangleSolidColor(benchmark::State &state, Multisample multisample)
+{
+	DrawTester tester(multisample);
+	SetupSolidColorTriangle(tester);
 
 	RunBenchmark(state, tester);
 }
 
+// Renders and presents frames to a headless surface as fast as possible. A
+// present only waits for the draws submitted before it. When waitIdle is true,
+// the queue is also drained after every present, as presents used to do.
+static void PresentLoop(benchmark::State &state, bool waitIdle)
+{
+	DrawTester tester;
+	SetupSolidColorTriangle(tester);
+	tester.initialize();
+
+	// Warmup
+	tester.renderFrame();
+
+	for(auto _ : state)
+	{
+		tester.renderFrame();
+
+		if(waitIdle)
+		{
+			tester.getQueue().waitIdle();
+		}
+	}
+
+	tester.getQueue().waitIdle();
+
+	state.counters["FPS"] = benchmark::Counter(static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+}
+
 static void TriangleInterpolateColor(benchmark::State &state, Multisample multisample)
 {
 	DrawTester tester(multisample);
@@ -281,9 +316,419 @@ static void TriangleSampleTexture(benchmark::State &state, Multisample multisamp
 	RunBenchmark(state, tester);
 }
 
+enum class DrawMode
+{
+	Direct,
+	Indirect
+};
+
+// Renders a grid of small triangles, each with its own draw. In indirect mode,
+// all draws are recorded by a single vkCmdDrawIndirect command.
+static void ManyDraws(benchmark::State &state, DrawMode mode)
+{
+	const uint32_t gridSize = 100;
+	const uint32_t drawCount = gridSize * gridSize;
+
+	DrawTester tester;
+	std::unique_ptr<Buffer> indirectBuffer;
+
+	tester.onCreateVertexBuffers([&](DrawTester &tester) {
+		struct Vertex
+		{
+			float position[3];
+		};
+
+		std::vector<Vertex> vertexBufferData;
+		vertexBufferData.reserve(3 * drawCount);
+
+		const float cellSize = 2.0f / gridSize;
+		for(uint32_t y = 0; y < gridSize; y++)
+		{
+			for(uint32_t x = 0; x < gridSize; x++)
+			{
+				float x0 = -1.0f + x * cellSize;
+				float y0 = -1.0f + y * cellSize;
+
+				vertexBufferData.push_back({ { x0 + cellSize, y0 + cellSize, 0.5f } });
+				vertexBufferData.push_back({ { x0, y0 + cellSize, 0.5f } });
+				vertexBufferData.push_back({ { x0 + 0.5f * cellSize, y0, 0.5f } });
+			}
+		}
+
+		std::vector<vk::VertexInputAttributeDescription> inputAttributes;
+		inputAttributes.push_back(vk::VertexInputAttributeDescription(0, 0, vk::Format::eR32G32B32Sfloat, offsetof(Vertex, position)));
+
+		tester.addVertexBuffer(vertexBufferData.data(), vertexBufferData.size() * sizeof(Vertex), std::move(inputAttributes));
+
+		if(mode == DrawMode::Indirect)
+		{
+			indirectBuffer = std::make_unique<Buffer>(tester.getDevice(), drawCount * sizeof(vk::DrawIndirectCommand), vk::BufferUsageFlagBits::eIndirectBuffer);
+			auto *commands = static_cast<vk::DrawIndirectCommand *>(indirectBuffer->mapMemory());
+
+			for(uint32_t i = 0; i < drawCount; i++)
+			{
+				commands[i] = vk::DrawIndirectCommand(3, 1, 3 * i, 0);
+			}
+
+			indirectBuffer->unmapMemory();
+		}
+	});
+
+	tester.onCreateVertexShader([](DrawTester &tester) {
+		const char *vertexShader = R"(#version 310 es
+			layout(location = 0) in vec3 inPos;
+
+			void main()
+			{
+				gl_Position = vec4(inPos.xyz, 1.0);
+			})";
+
+		return tester.createShaderModule(vertexShader, EShLanguage::EShLangVertex);
+	});
+
+	tester.onCreateFragmentShader([](DrawTester &tester) {
+		const char *fragmentShader = R"(#version 310 es
+			precision highp float;
+
+			layout(location = 0) out vec4 outColor;
+
+			void main()
+			{
+				outColor = vec4(1.0, 1.0, 1.0, 1.0);
+			})";
+
+		return tester.createShaderModule(fragmentShader, EShLanguage::EShLangFragment);
+	});
+
+	tester.onRecordDraws([&](DrawTester &tester, vk::CommandBuffer &commandBuffer) {
+		if(mode == DrawMode::Indirect)
+		{
+			commandBuffer.drawIndirect(indirectBuffer->getBuffer(), 0, drawCount, sizeof(vk::DrawIndirectCommand));
+		}
+		else
+		{
+			for(uint32_t i = 0; i < drawCount; i++)
+			{
+				commandBuffer.draw(3, 1, 3 * i, 0);
+			}
+		}
+	});
+
+	RunBenchmark(state, tester);
+
+	state.counters["Draws"] = benchmark::Counter(static_cast<double>(drawCount) * state.iterations(), benchmark::Counter::kIsRate);
+}
+
+// Renders a single mesh of many tiny triangles, most of which don't cover any
+// sample, so that the cost is dominated by primitive assembly and setup.
+static void HighPolyMesh(benchmark::State &state, Multisample multisample)
+{
+	const uint32_t gridSize = 512;
+	const uint32_t vertexCount = 6 * gridSize * gridSize;
+
+	DrawTester tester(multisample);
+
+	tester.onCreateVertexBuffers([&](DrawTester &tester) {
+		struct Vertex
+		{
+			float position[3];
+		};
+
+		std::vector<Vertex> vertexBufferData;
+		vertexBufferData.reserve(vertexCount);
+
+		const float cellSize = 2.0f / gridSize;
+		for(uint32_t y = 0; y < gridSize; y++)
+		{
+			for(uint32_t x = 0; x < gridSize; x++)
+			{
+				float x0 = -1.0f + x * cellSize;
+				float y0 = -1.0f + y * cellSize;
+				float x1 = x0 + cellSize;
+				float y1 = y0 + cellSize;
+
+				vertexBufferData.push_back({ { x0, y0, 0.5f } });
+				vertexBufferData.push_back({ { x1, y0, 0.5f } });
+				vertexBufferData.push_back({ { x0, y1, 0.5f } });
+				vertexBufferData.push_back({ { x1, y0, 0.5f } });
+				vertexBufferData.push_back({ { x1, y1, 0.5f } });
+				vertexBufferData.push_back({ { x0, y1, 0.5f } });
+			}
+		}
+
+		std::vector<vk::VertexInputAttributeDescription> inputAttributes;
+		inputAttributes.push_back(vk::VertexInputAttributeDescription(0, 0, vk::Format::eR32G32B32Sfloat, offsetof(Vertex, position)));
+
+		tester.addVertexBuffer(vertexBufferData.data(), vertexBufferData.size() * sizeof(Vertex), std::move(inputAttributes));
+	});
+
+	tester.onCreateVertexShader([](DrawTester &tester) {
+		const char *vertexShader = R"(#version 310 es
+			layout(location = 0) in vec3 inPos;
+
+			void main()
+			{
+				gl_Position = vec4(inPos.xyz, 1.0);
+			})";
+
+		return tester.createShaderModule(vertexShader, EShLanguage::EShLangVertex);
+	});
+
+	tester.onCreateFragmentShader([](DrawTester &tester) {
+		const char *fragmentShader = R"(#version 310 es
+			precision highp float;
+
+			layout(location = 0) out vec4 outColor;
+
+			void main()
+			{
+				outColor = vec4(1.0, 1.0, 1.0, 1.0);
+			})";
+
+		return tester.createShaderModule(fragmentShader, EShLanguage::EShLangFragment);
+	});
+
+	tester.onRecordDraws([&](DrawTester &tester, vk::CommandBuffer &commandBuffer) {
+		commandBuffer.draw(vertexCount, 1, 0, 0);
+	});
+
+	RunBenchmark(state, tester);
+
+	state.counters["Triangles"] = benchmark::Counter(static_cast<double>(vertexCount / 3) * state.iterations(), benchmark::Counter::kIsRate);
+}
+
+enum class IndexOrder
+{
+	Sequential,
+	LocalShuffle,
+	Random
+};
+
+// Renders an indexed grid mesh with a vertex shader heavy enough to dominate
+// the cost of the draw. The triangles are either in grid order, shuffled within
+// small groups, or shuffled across the whole mesh, so that vertices get reused
+// in progressively more scattered patterns.
+static void IndexedMesh(benchmark::State &state, IndexOrder order)
+{
+	const uint32_t gridSize = 256;
+	const uint32_t indexCount = 6 * gridSize * gridSize;
+
+	DrawTester tester;
+	std::unique_ptr<Buffer> indexBuffer;
+
+	tester.onCreateVertexBuffers([&](DrawTester &tester) {
+		struct Vertex
+		{
+			float position[3];
+		};
+
+		std::vector<Vertex> vertexBufferData;
+		vertexBufferData.reserve((gridSize + 1) * (gridSize + 1));
+
+		const float cellSize = 2.0f / gridSize;
+		for(uint32_t y = 0; y <= gridSize; y++)
+		{
+			for(uint32_t x = 0; x <= gridSize; x++)
+			{
+				vertexBufferData.push_back({ { -1.0f + x * cellSize, -1.0f + y * cellSize, 0.5f } });
+			}
+		}
+
+		std::vector<vk::VertexInputAttributeDescription> inputAttributes;
+		inputAttributes.push_back(vk::VertexInputAttributeDescription(0, 0, vk::Format::eR32G32B32Sfloat, offsetof(Vertex, position)));
+
+		tester.addVertexBuffer(vertexBufferData.data(), vertexBufferData.size() * sizeof(Vertex), std::move(inputAttributes));
+
+		struct Triangle
+		{
+			uint32_t index[3];
+		};
+
+		std::vector<Triangle> triangles;
+		triangles.reserve(indexCount / 3);
+
+		for(uint32_t y = 0; y < gridSize; y++)
+		{
+			for(uint32_t x = 0; x < gridSize; x++)
+			{
+				uint32_t i = y * (gridSize + 1) + x;
+
+				triangles.push_back({ { i, i + 1, i + gridSize + 1 } });
+				triangles.push_back({ { i + 1, i + gridSize + 2, i + gridSize + 1 } });
+			}
+		}
+
+		const size_t groupSize = (order == IndexOrder::LocalShuffle) ? 32 : triangles.size();
+		if(order != IndexOrder::Sequential)
+		{
+			srand(0);
+			for(size_t group = 0; group < triangles.size(); group += groupSize)
+			{
+				size_t count = std::min(groupSize, triangles.size() - group);
+				for(size_t i = count - 1; i > 0; i--)
+				{
+					std::swap(triangles[group + i], triangles[group + rand() % (i + 1)]);
+				}
+			}
+		}
+
+		indexBuffer = std::make_unique<Buffer>(tester.getDevice(), indexCount * sizeof(uint32_t), vk::BufferUsageFlagBits::eIndexBuffer);
+		memcpy(indexBuffer->mapMemory(), triangles.data(), indexCount * sizeof(uint32_t));
+		indexBuffer->unmapMemory();
+	});
+
+	tester.onCreateVertexShader([](DrawTester &tester) {
+		const char *vertexShader = R"(#version 310 es
+			layout(location = 0) in vec3 inPos;
+
+			void main()
+			{
+				vec3 p = inPos;
+				for(int i = 0; i < 16; i++)
+				{
+					p += 0.001 * sin(p.yzx * 7.0 + float(i));
+				}
+
+				gl_Position = vec4(p.xy, inPos.z, 1.0);
+			})";
+
+		return tester.createShaderModule(vertexShader, EShLanguage::EShLangVertex);
+	});
+
+	tester.onCreateFragmentShader([](DrawTester &tester) {
+		const char *fragmentShader = R"(#version 310 es
+			precision highp float;
+
+			layout(location = 0) out vec4 outColor;
+
+			void main()
+			{
+				outColor = vec4(1.0, 1.0, 1.0, 1.0);
+			})";
+
+		return tester.createShaderModule(fragmentShader, EShLanguage::EShLangFragment);
+	});
+
+	tester.onRecordDraws([&](DrawTester &tester, vk::CommandBuffer &commandBuffer) {
+		commandBuffer.bindIndexBuffer(indexBuffer->getBuffer(), 0, vk::IndexType::eUint32);
+		commandBuffer.drawIndexed(indexCount, 1, 0, 0, 0);
+	});
+
+	RunBenchmark(state, tester);
+
+	state.counters["Triangles"] = benchmark::Counter(static_cast<double>(indexCount / 3) * state.iterations(), benchmark::Counter::kIsRate);
+}
+
+// Tiled render pass execution is selected by an environment variable, which is
+// read when the device is created.
+static void SetTiledRendering(bool enable)
+{
+#if defined(_WIN32)
+	_putenv_s("SWIFTSHADER_TILED_RENDERING", enable ? "1" : "0");
+#else
+	setenv("SWIFTSHADER_TILED_RENDERING", enable ? "1" : "0", 1);
+#endif
+}
+
+// Renders layers of full-screen quads on top of each other, each with its own
+// draw, so that every pixel of the attachments is written many times per frame.
+static void Overdraw(benchmark::State &state, Multisample multisample, bool tiled)
+{
+	const uint32_t layerCount = 16;
+
+	SetTiledRendering(tiled);
+
+	DrawTester tester(multisample);
+
+	tester.onCreateVertexBuffers([&](DrawTester &tester) {
+		struct Vertex
+		{
+			float position[3];
+			float color[3];
+		};
+
+		std::vector<Vertex> vertexBufferData;
+		vertexBufferData.reserve(6 * layerCount);
+
+		for(uint32_t layer = 0; layer < layerCount; layer++)
+		{
+			float shade = static_cast<float>(layer + 1) / layerCount;
+
+			vertexBufferData.push_back({ { -1.0f, -1.0f, 0.5f }, { shade, 0.0f, 0.0f } });
+			vertexBufferData.push_back({ { 1.0f, -1.0f, 0.5f }, { 0.0f, shade, 0.0f } });
+			vertexBufferData.push_back({ { -1.0f, 1.0f, 0.5f }, { 0.0f, 0.0f, shade } });
+			vertexBufferData.push_back({ { 1.0f, -1.0f, 0.5f }, { 0.0f, shade, 0.0f } });
+			vertexBufferData.push_back({ { 1.0f, 1.0f, 0.5f }, { shade, shade, 0.0f } });
+			vertexBufferData.push_back({ { -1.0f, 1.0f, 0.5f }, { 0.0f, 0.0f, shade } });
+		}
+
+		std::vector<vk::VertexInputAttributeDescription> inputAttributes;
+		inputAttributes.push_back(vk::VertexInputAttributeDescription(0, 0, vk::Format::eR32G32B32Sfloat, offsetof(Vertex, position)));
+		inputAttributes.push_back(vk::VertexInputAttributeDescription(1, 0, vk::Format::eR32G32B32Sfloat, offsetof(Vertex, color)));
+
+		tester.addVertexBuffer(vertexBufferData.data(), vertexBufferData.size() * sizeof(Vertex), std::move(inputAttributes));
+	});
+
+	tester.onCreateVertexShader([](DrawTester &tester) {
+		const char *vertexShader = R"(#version 310 es
+			layout(location = 0) in vec3 inPos;
+			layout(location = 1) in vec3 inColor;
+
+			layout(location = 0) out vec3 outColor;
+
+			void main()
+			{
+				outColor = inColor;
+				gl_Position = vec4(inPos.xyz, 1.0);
+			})";
+
+		return tester.createShaderModule(vertexShader, EShLanguage::EShLangVertex);
+	});
+
+	tester.onCreateFragmentShader([](DrawTester &tester) {
+		const char *fragmentShader = R"(#version 310 es
+			precision highp float;
+
+			layout(location = 0) in vec3 inColor;
+
+			layout(location = 0) out vec4 outColor;
+
+			void main()
+			{
+				outColor = vec4(inColor, 1.0);
+			})";
+
+		return tester.createShaderModule(fragmentShader, EShLanguage::EShLangFragment);
+	});
+
+	tester.onRecordDraws([&](DrawTester &tester, vk::CommandBuffer &commandBuffer) {
+		for(uint32_t layer = 0; layer < layerCount; layer++)
+		{
+			commandBuffer.draw(6, 1, 6 * layer, 0);
+		}
+	});
+
+	RunBenchmark(state, tester);
+
+	SetTiledRendering(false);
+}
+
 BENCHMARK_CAPTURE(TriangleSolidColor, TriangleSolidColor, Multisample::False)->Unit(benchmark::kMillisecond)->MeasureProcessCPUTime();
 BENCHMARK_CAPTURE(TriangleInterpolateColor, TriangleInterpolateColor, Multisample::False)->Unit(benchmark::kMillisecond)->MeasureProcessCPUTime();
 BENCHMARK_CAPTURE(TriangleSampleTexture, TriangleSampleTexture, Multisample::False)->Unit(benchmark::kMillisecond)->MeasureProcessCPUTime();
 BENCHMARK_CAPTURE(TriangleSolidColor, TriangleSolidColor_Multisample, Multisample::True)->Unit(benchmark::kMillisecond)->MeasureProcessCPUTime();
 BENCHMARK_CAPTURE(TriangleInterpolateColor, TriangleInterpolateColor_Multisample, Multisample::True)->Unit(benchmark::kMillisecond)->MeasureProcessCPUTime();
 BENCHMARK_CAPTURE(TriangleSampleTexture, TriangleSampleTexture_Multisample, Multisample::True)->Unit(benchmark::kMillisecond)->MeasureProcessCPUTime();
+BENCHMARK_CAPTURE(PresentLoop, PresentLoop, false)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(PresentLoop, PresentLoop_WaitIdle, true)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(ManyDraws, ManyDraws_Direct, DrawMode::Direct)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(ManyDraws, ManyDraws_Indirect, DrawMode::Indirect)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(HighPolyMesh, HighPolyMesh, Multisample::False)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(HighPolyMesh, HighPolyMesh_Multisample, Multisample::True)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(IndexedMesh, IndexedMesh_Sequential, IndexOrder::Sequential)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(IndexedMesh, IndexedMesh_LocalShuffle, IndexOrder::LocalShuffle)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(IndexedMesh, IndexedMesh_Random, IndexOrder::Random)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(Overdraw, Overdraw, Multisample::False, false)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(Overdraw, Overdraw_Tiled, Multisample::False, true)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(Overdraw, Overdraw_Multisample, Multisample::True, false)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(Overdraw, Overdraw_Multisample_Tiled, Multisample::True, true)->Unit(benchmark::kMillisecond)->UseRealTime();
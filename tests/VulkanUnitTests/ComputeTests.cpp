@@ -20,6 +20,8 @@
 
 #include "spirv-tools/libspirv.hpp"
 
+#include <algorithm>
+#include <array>
 #include <cstring>
 #include <sstream>
 
@@ -28,6 +30,45 @@ size_t alignUp(size_t val, size_t alignment)
 {
 	return alignment * ((val + alignment - 1) / alignment);
 }
+
+// Converts a normal single precision value to half precision, rounding to nearest even.
+uint16_t floatToHalf(float f)
+{
+	uint32_t bits;
+	memcpy(&bits, &f, sizeof(bits));
+	if((bits & 0x7FFFFFFF) == 0)
+	{
+		return uint16_t(bits >> 16);
+	}
+
+	uint32_t sign = (bits >> 16) & 0x8000;
+	uint32_t exponent = ((bits >> 23) & 0xFF) - 127 + 15;
+	uint32_t mantissa = bits & 0x007FFFFF;
+	uint32_t half = (exponent << 10) | (mantissa >> 13);
+	uint32_t remainder = mantissa & 0x1FFF;
+	if(remainder > 0x1000 || (remainder == 0x1000 && (half & 1)))
+	{
+		half++;
+	}
+
+	return uint16_t(sign | half);
+}
+
+// Converts a normal half precision value to single precision.
+float halfToFloat(uint16_t h)
+{
+	uint32_t sign = uint32_t(h & 0x8000) << 16;
+	uint32_t bits = sign;
+	if((h & 0x7FFF) != 0)
+	{
+		uint32_t exponent = ((h >> 10) & 0x1F) - 15 + 127;
+		bits |= (exponent << 23) | (uint32_t(h & 0x03FF) << 13);
+	}
+
+	float f;
+	memcpy(&f, &bits, sizeof(f));
+	return f;
+}
 }  // anonymous namespace
 
 struct ComputeParams
@@ -65,9 +106,9 @@ protected:
 
 Driver ComputeTest::driver;
 
-std::vector<uint32_t> compileSpirv(const char *assembly)
+std::vector<uint32_t> compileSpirv(const char *assembly, spv_target_env env = SPV_ENV_VULKAN_1_0)
 {
-	spvtools::SpirvTools core(SPV_ENV_VULKAN_1_0);
+	spvtools::SpirvTools core(env);
 
 	core.SetMessageConsumer([](spv_message_level_t, const char *, const spv_position_t &p, const char *m) {
 		FAIL() << p.line << ":" << p.column << ": " << m;
@@ -121,15 +162,21 @@ class SwiftShaderVulkanBufferToBufferComputeTest : public ComputeTest
 public:
 	void test(const std::string &shader,
 	          std::function<uint32_t(uint32_t idx)> input,
-	          std::function<uint32_t(uint32_t idx)> expected);
+	          std::function<uint32_t(uint32_t idx)> expected,
+	          spv_target_env env = SPV_ENV_VULKAN_1_0);
+
+	// Returns the index of the first invocation of the subgroup of invocation idx,
+	// and the number of invocations in that subgroup.
+	std::pair<uint32_t, uint32_t> subgroup(uint32_t idx) const;
 };
 
 void SwiftShaderVulkanBufferToBufferComputeTest::test(
     const std::string &shader,
     std::function<uint32_t(uint32_t idx)> input,
-    std::function<uint32_t(uint32_t idx)> expected)
+    std::function<uint32_t(uint32_t idx)> expected,
+    spv_target_env env)
 {
-	auto code = compileSpirv(shader.c_str());
+	auto code = compileSpirv(shader.c_str(), env);
 
 	const VkInstanceCreateInfo createInfo = {
 		VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO,  // sType
@@ -311,6 +358,13 @@ void SwiftShaderVulkanBufferToBufferComputeTest::test(
 	driver.vkDestroyInstance(instance, nullptr);
 }
 
+std::pair<uint32_t, uint32_t> SwiftShaderVulkanBufferToBufferComputeTest::subgroup(uint32_t idx) const
+{
+	// Subgroups are 4 invocations wide, and don't span workgroups.
+	uint32_t size = std::min<uint32_t>(GetParam().localSizeX, 4);
+	return { idx - idx % size, size };
+}
+
 INSTANTIATE_TEST_SUITE_P(ComputeParams, SwiftShaderVulkanBufferToBufferComputeTest, testing::Values(ComputeParams{ 512, 1, 1, 1 }, ComputeParams{ 512, 2, 1, 1 }, ComputeParams{ 512, 4, 1, 1 }, ComputeParams{ 512, 8, 1, 1 }, ComputeParams{ 512, 16, 1, 1 }, ComputeParams{ 512, 32, 1, 1 },
 
                                                                                                     // Non-multiple of SIMD-lane.
@@ -1481,3 +1535,1300 @@ TEST_P(SwiftShaderVulkanBufferToBufferComputeTest, LoopDivergentMergePhi)
 	test(
 	    src.str(), [](uint32_t i) { return i; }, [](uint32_t i) { return i; });
 }
+
+TEST_P(SwiftShaderVulkanBufferToBufferComputeTest, WorkgroupBarrier)
+{
+	// #version 450
+	// layout(local_size_x = N, local_size_y = 1, local_size_z = 1) in;
+	// layout(binding = 0, std430) buffer InBuffer
+	// {
+	//     int Data[];
+	// } In;
+	// layout(binding = 1, std430) buffer OutBuffer
+	// {
+	//     int Data[];
+	// } Out;
+	// shared int Shared[32];
+	// void main()
+	// {
+	//     uint g = gl_GlobalInvocationID.x;
+	//     uint l = gl_LocalInvocationID.x;
+	//     int v = int(l) * 1000;
+	//     if ((l & 1) != 0)
+	//     {
+	//         v = -v;
+	//     }
+	//     Shared[l] = In.Data[g];
+	//     barrier();
+	//     int y = Shared[N - 1 - l];
+	//     barrier();
+	//     Shared[l] = y + v;
+	//     barrier();
+	//     Out.Data[g] = Shared[l] + int(l);
+	// }
+	std::stringstream src;
+	// clang-format off
+    src <<
+        "OpCapability Shader\n"
+        "OpMemoryModel Logical GLSL450\n"
+        "OpEntryPoint GLCompute %1 \"main\" %2 %3\n"
+        "OpExecutionMode %1 LocalSize " <<
+        GetParam().localSizeX << " " <<
+        GetParam().localSizeY << " " <<
+        GetParam().localSizeZ << "\n" <<
+        "OpDecorate %2 BuiltIn GlobalInvocationId\n"
+        "OpDecorate %3 BuiltIn LocalInvocationId\n"
+        "OpDecorate %4 ArrayStride 4\n"
+        "OpMemberDecorate %5 0 Offset 0\n"
+        "OpDecorate %5 BufferBlock\n"
+        "OpDecorate %6 DescriptorSet 0\n"
+        "OpDecorate %6 Binding 0\n"
+        "OpDecorate %7 DescriptorSet 0\n"
+        "OpDecorate %7 Binding 1\n"
+        "%8 = OpTypeVoid\n"
+        "%9 = OpTypeFunction %8\n"              // void()
+        "%10 = OpTypeInt 32 1\n"                // int32
+        "%11 = OpTypeInt 32 0\n"                // uint32
+        "%12 = OpTypeBool\n"
+        "%13 = OpTypeVector %11 3\n"            // vec3<uint32>
+        "%14 = OpTypePointer Input %13\n"       // vec3<uint32>*
+        "%2 = OpVariable %14 Input\n"           // gl_GlobalInvocationId
+        "%3 = OpVariable %14 Input\n"           // gl_LocalInvocationId
+        "%15 = OpTypePointer Input %11\n"       // uint32*
+        "%4 = OpTypeRuntimeArray %10\n"         // int32[]
+        "%5 = OpTypeStruct %4\n"                // struct{ int32[] }
+        "%16 = OpTypePointer Uniform %5\n"      // struct{ int32[] }*
+        "%6 = OpVariable %16 Uniform\n"         // struct{ int32[] }* in
+        "%7 = OpVariable %16 Uniform\n"         // struct{ int32[] }* out
+        "%17 = OpTypePointer Uniform %10\n"     // int32*
+        "%18 = OpConstant %11 32\n"             // uint32(32)
+        "%19 = OpTypeArray %10 %18\n"           // int32[32]
+        "%20 = OpTypePointer Workgroup %19\n"   // int32[32]*
+        "%21 = OpVariable %20 Workgroup\n"      // Shared
+        "%22 = OpTypePointer Workgroup %10\n"   // int32*
+        "%23 = OpTypePointer Function %10\n"    // int32*
+        "%24 = OpConstant %10 0\n"              // int32(0)
+        "%25 = OpConstant %11 0\n"              // uint32(0)
+        "%26 = OpConstant %11 1\n"              // uint32(1)
+        "%27 = OpConstant %11 2\n"              // Workgroup scope
+        "%28 = OpConstant %11 264\n"            // AcquireRelease | WorkgroupMemory
+        "%29 = OpConstant %11 " << (GetParam().localSizeX - 1) << "\n" <<
+        "%30 = OpConstant %10 1000\n"           // int32(1000)
+        "%1 = OpFunction %8 None %9\n"          // -- Function begin --
+        "%31 = OpLabel\n"
+        "%32 = OpVariable %23 Function\n"       // v
+        "%33 = OpAccessChain %15 %2 %25\n"
+        "%34 = OpLoad %11 %33\n"                // g
+        "%35 = OpAccessChain %15 %3 %25\n"
+        "%36 = OpLoad %11 %35\n"                // l
+        "%37 = OpBitcast %10 %36\n"             // int(l)
+        "%38 = OpIMul %10 %37 %30\n"
+        "OpStore %32 %38\n"                     // v = int(l) * 1000
+        "%39 = OpBitwiseAnd %11 %36 %26\n"
+        "%40 = OpINotEqual %12 %39 %25\n"
+        "OpSelectionMerge %41 None\n"
+        "OpBranchConditional %40 %42 %41\n"
+        "%42 = OpLabel\n"
+        "%43 = OpSNegate %10 %38\n"
+        "OpStore %32 %43\n"                     // v = -v
+        "OpBranch %41\n"
+        "%41 = OpLabel\n"
+        "%44 = OpAccessChain %17 %6 %24 %34\n"  // &in.arr[g]
+        "%45 = OpLoad %10 %44\n"
+        "%46 = OpAccessChain %22 %21 %36\n"     // &Shared[l]
+        "OpStore %46 %45\n"
+        "OpControlBarrier %27 %27 %28\n"
+        "%47 = OpISub %11 %29 %36\n"
+        "%48 = OpAccessChain %22 %21 %47\n"     // &Shared[N - 1 - l]
+        "%49 = OpLoad %10 %48\n"                // y
+        "OpControlBarrier %27 %27 %28\n"
+        "%50 = OpLoad %10 %32\n"
+        "%51 = OpIAdd %10 %49 %50\n"
+        "OpStore %46 %51\n"                     // Shared[l] = y + v
+        "OpControlBarrier %27 %27 %28\n"
+        "%52 = OpLoad %10 %46\n"
+        "%53 = OpIAdd %10 %52 %37\n"
+        "%54 = OpAccessChain %17 %7 %24 %34\n"  // &out.arr[g]
+        "OpStore %54 %53\n"
+        "OpReturn\n"
+        "OpFunctionEnd\n";
+	// clang-format on
+
+	int n = GetParam().localSizeX;
+	test(
+	    src.str(), [](uint32_t i) { return i; },
+	    [n](uint32_t i) {
+		    int l = i % n;
+		    int v = (l & 1) ? -l * 1000 : l * 1000;
+		    return uint32_t((i - l) + (n - 1 - l) + v + l);
+	    });
+}
+
+TEST_P(SwiftShaderVulkanBufferToBufferComputeTest, WorkgroupBarrierInLoop)
+{
+	// #version 450
+	// layout(local_size_x = N, local_size_y = 1, local_size_z = 1) in;
+	// layout(binding = 0, std430) buffer InBuffer
+	// {
+	//     int Data[];
+	// } In;
+	// layout(binding = 1, std430) buffer OutBuffer
+	// {
+	//     int Data[];
+	// } Out;
+	// shared int Shared[32];
+	// void main()
+	// {
+	//     uint g = gl_GlobalInvocationID.x;
+	//     uint l = gl_LocalInvocationID.x;
+	//     Shared[l] = In.Data[g];
+	//     for(int i = 0; i < 3; i++)
+	//     {
+	//         barrier();
+	//         int y = Shared[N - 1 - l];
+	//         barrier();
+	//         Shared[l] = y;
+	//     }
+	//     barrier();
+	//     Out.Data[g] = Shared[l];
+	// }
+	std::stringstream src;
+	// clang-format off
+    src <<
+        "OpCapability Shader\n"
+        "OpMemoryModel Logical GLSL450\n"
+        "OpEntryPoint GLCompute %1 \"main\" %2 %3\n"
+        "OpExecutionMode %1 LocalSize " <<
+        GetParam().localSizeX << " " <<
+        GetParam().localSizeY << " " <<
+        GetParam().localSizeZ << "\n" <<
+        "OpDecorate %2 BuiltIn GlobalInvocationId\n"
+        "OpDecorate %3 BuiltIn LocalInvocationId\n"
+        "OpDecorate %4 ArrayStride 4\n"
+        "OpMemberDecorate %5 0 Offset 0\n"
+        "OpDecorate %5 BufferBlock\n"
+        "OpDecorate %6 DescriptorSet 0\n"
+        "OpDecorate %6 Binding 0\n"
+        "OpDecorate %7 DescriptorSet 0\n"
+        "OpDecorate %7 Binding 1\n"
+        "%8 = OpTypeVoid\n"
+        "%9 = OpTypeFunction %8\n"              // void()
+        "%10 = OpTypeInt 32 1\n"                // int32
+        "%11 = OpTypeInt 32 0\n"                // uint32
+        "%12 = OpTypeBool\n"
+        "%13 = OpTypeVector %11 3\n"            // vec3<uint32>
+        "%14 = OpTypePointer Input %13\n"       // vec3<uint32>*
+        "%2 = OpVariable %14 Input\n"           // gl_GlobalInvocationId
+        "%3 = OpVariable %14 Input\n"           // gl_LocalInvocationId
+        "%15 = OpTypePointer Input %11\n"       // uint32*
+        "%4 = OpTypeRuntimeArray %10\n"         // int32[]
+        "%5 = OpTypeStruct %4\n"                // struct{ int32[] }
+        "%16 = OpTypePointer Uniform %5\n"      // struct{ int32[] }*
+        "%6 = OpVariable %16 Uniform\n"         // struct{ int32[] }* in
+        "%7 = OpVariable %16 Uniform\n"         // struct{ int32[] }* out
+        "%17 = OpTypePointer Uniform %10\n"     // int32*
+        "%18 = OpConstant %11 32\n"             // uint32(32)
+        "%19 = OpTypeArray %10 %18\n"           // int32[32]
+        "%20 = OpTypePointer Workgroup %19\n"   // int32[32]*
+        "%21 = OpVariable %20 Workgroup\n"      // Shared
+        "%22 = OpTypePointer Workgroup %10\n"   // int32*
+        "%23 = OpConstant %10 0\n"              // int32(0)
+        "%24 = OpConstant %10 1\n"              // int32(1)
+        "%25 = OpConstant %10 3\n"              // int32(3)
+        "%26 = OpConstant %11 0\n"              // uint32(0)
+        "%27 = OpConstant %11 2\n"              // Workgroup scope
+        "%28 = OpConstant %11 264\n"            // AcquireRelease | WorkgroupMemory
+        "%29 = OpConstant %11 " << (GetParam().localSizeX - 1) << "\n" <<
+        "%1 = OpFunction %8 None %9\n"          // -- Function begin --
+        "%30 = OpLabel\n"
+        "%31 = OpAccessChain %15 %2 %26\n"
+        "%32 = OpLoad %11 %31\n"                // g
+        "%33 = OpAccessChain %15 %3 %26\n"
+        "%34 = OpLoad %11 %33\n"                // l
+        "%35 = OpAccessChain %17 %6 %23 %32\n"  // &in.arr[g]
+        "%36 = OpLoad %10 %35\n"
+        "%37 = OpAccessChain %22 %21 %34\n"     // &Shared[l]
+        "OpStore %37 %36\n"
+        "OpBranch %38\n"
+        "%38 = OpLabel\n"
+        "%39 = OpPhi %10 %23 %30 %40 %41\n"     // i
+        "OpLoopMerge %42 %41 None\n"
+        "OpBranch %43\n"
+        "%43 = OpLabel\n"
+        "OpControlBarrier %27 %27 %28\n"
+        "%44 = OpISub %11 %29 %34\n"
+        "%45 = OpAccessChain %22 %21 %44\n"     // &Shared[N - 1 - l]
+        "%46 = OpLoad %10 %45\n"                // y
+        "OpControlBarrier %27 %27 %28\n"
+        "OpStore %37 %46\n"                     // Shared[l] = y
+        "OpBranch %41\n"
+        "%41 = OpLabel\n"
+        "%40 = OpIAdd %10 %39 %24\n"
+        "%47 = OpSLessThan %12 %40 %25\n"
+        "OpBranchConditional %47 %38 %42\n"
+        "%42 = OpLabel\n"
+        "OpControlBarrier %27 %27 %28\n"
+        "%48 = OpLoad %10 %37\n"
+        "%49 = OpAccessChain %17 %7 %23 %32\n"  // &out.arr[g]
+        "OpStore %49 %48\n"
+        "OpReturn\n"
+        "OpFunctionEnd\n";
+	// clang-format on
+
+	// Reversed an odd number of times.
+	int n = GetParam().localSizeX;
+	test(
+	    src.str(), [](uint32_t i) { return i; },
+	    [n](uint32_t i) {
+		    int l = i % n;
+		    return uint32_t((i - l) + (n - 1 - l));
+	    });
+}
+
+TEST_P(SwiftShaderVulkanBufferToBufferComputeTest, Float16Arithmetic)
+{
+	// #version 450
+	// #extension GL_EXT_shader_explicit_arithmetic_types_float16 : require
+	// layout(local_size_x = 1, local_size_y = 1, local_size_z = 1) in;
+	// layout(binding = 0, std430) buffer InBuffer
+	// {
+	//     f16vec2 Data[];
+	// } In;
+	// layout(binding = 1, std430) buffer OutBuffer
+	// {
+	//     f16vec2 Data[];
+	// } Out;
+	// void main()
+	// {
+	//     Out.Data[gl_GlobalInvocationID.x] = In.Data[gl_GlobalInvocationID.x] * 2.0hf + 1.0hf;
+	// }
+	std::stringstream src;
+	// clang-format off
+    src <<
+        "OpCapability Shader\n"
+        "OpCapability Float16\n"
+        "OpCapability UniformAndStorageBuffer16BitAccess\n"
+        "OpExtension \"SPV_KHR_16bit_storage\"\n"
+        "OpMemoryModel Logical GLSL450\n"
+        "OpEntryPoint GLCompute %1 \"main\" %2\n"
+        "OpExecutionMode %1 LocalSize " <<
+        GetParam().localSizeX << " " <<
+        GetParam().localSizeY << " " <<
+        GetParam().localSizeZ << "\n" <<
+        "OpDecorate %3 ArrayStride 4\n"
+        "OpMemberDecorate %4 0 Offset 0\n"
+        "OpDecorate %4 BufferBlock\n"
+        "OpDecorate %5 DescriptorSet 0\n"
+        "OpDecorate %5 Binding 1\n"
+        "OpDecorate %2 BuiltIn GlobalInvocationId\n"
+        "OpDecorate %6 DescriptorSet 0\n"
+        "OpDecorate %6 Binding 0\n"
+        "%7 = OpTypeVoid\n"
+        "%8 = OpTypeFunction %7\n"             // void()
+        "%9 = OpTypeFloat 16\n"                // float16
+        "%10 = OpTypeVector %9 2\n"             // vec2<float16>
+        "%11 = OpTypeInt 32 0\n"                // uint32
+        "%3 = OpTypeRuntimeArray %10\n"        // vec2<float16>[]
+        "%4 = OpTypeStruct %3\n"               // struct{ vec2<float16>[] }
+        "%12 = OpTypePointer Uniform %4\n"      // struct{ vec2<float16>[] }*
+        "%5 = OpVariable %12 Uniform\n"        // struct{ vec2<float16>[] }* out
+        "%13 = OpConstant %11 0\n"              // uint32(0)
+        "%14 = OpTypeVector %11 3\n"            // vec3<uint32>
+        "%15 = OpTypePointer Input %14\n"       // vec3<uint32>*
+        "%2 = OpVariable %15 Input\n"          // gl_GlobalInvocationId
+        "%16 = OpTypePointer Input %11\n"       // uint32*
+        "%6 = OpVariable %12 Uniform\n"        // struct{ vec2<float16>[] }* in
+        "%17 = OpTypePointer Uniform %10\n"     // vec2<float16>*
+        "%18 = OpConstant %9 0x1p+1\n"          // float16(2)
+        "%19 = OpConstant %9 0x1p+0\n"          // float16(1)
+        "%20 = OpConstantComposite %10 %19 %19\n" // vec2<float16>(1, 1)
+        "%1 = OpFunction %7 None %8\n"         // -- Function begin --
+        "%21 = OpLabel\n"
+        "%22 = OpAccessChain %16 %2 %13\n"      // &gl_GlobalInvocationId.x
+        "%23 = OpLoad %11 %22\n"                // gl_GlobalInvocationId.x
+        "%24 = OpAccessChain %17 %6 %13 %23\n"  // &in.arr[gl_GlobalInvocationId.x]
+        "%25 = OpLoad %10 %24\n"                // in.arr[gl_GlobalInvocationId.x]
+        "%26 = OpVectorTimesScalar %10 %25 %18\n" // in.arr[gl_GlobalInvocationId.x] * 2
+        "%27 = OpFAdd %10 %26 %20\n"            // in.arr[gl_GlobalInvocationId.x] * 2 + 1
+        "%28 = OpAccessChain %17 %5 %13 %23\n"  // &out.arr[gl_GlobalInvocationId.x]
+        "OpStore %28 %27\n"               // out.arr[gl_GlobalInvocationId.x] = in.arr[gl_GlobalInvocationId.x] * 2 + 1
+        "OpReturn\n"
+        "OpFunctionEnd\n";
+	// clang-format on
+
+	auto pack = [](float x, float y) { return uint32_t(floatToHalf(x)) | (uint32_t(floatToHalf(y)) << 16); };
+
+	test(
+	    src.str(),
+	    [&](uint32_t i) { return pack(float(i), -0.5f * float(i)); },
+	    [&](uint32_t i) { return pack(2.0f * float(i) + 1.0f, 1.0f - float(i)); });
+}
+
+TEST_P(SwiftShaderVulkanBufferToBufferComputeTest, Float16Rounding)
+{
+	// Each half precision operation must round its result, so (x * x) - 1
+	// differs from the single precision computation.
+	std::stringstream src;
+	// clang-format off
+    src <<
+        "OpCapability Shader\n"
+        "OpCapability Float16\n"
+        "OpCapability UniformAndStorageBuffer16BitAccess\n"
+        "OpExtension \"SPV_KHR_16bit_storage\"\n"
+        "OpMemoryModel Logical GLSL450\n"
+        "OpEntryPoint GLCompute %1 \"main\" %2\n"
+        "OpExecutionMode %1 LocalSize " <<
+        GetParam().localSizeX << " " <<
+        GetParam().localSizeY << " " <<
+        GetParam().localSizeZ << "\n" <<
+        "OpDecorate %3 ArrayStride 4\n"
+        "OpMemberDecorate %4 0 Offset 0\n"
+        "OpDecorate %4 BufferBlock\n"
+        "OpDecorate %5 DescriptorSet 0\n"
+        "OpDecorate %5 Binding 1\n"
+        "OpDecorate %2 BuiltIn GlobalInvocationId\n"
+        "OpDecorate %6 DescriptorSet 0\n"
+        "OpDecorate %6 Binding 0\n"
+        "%7 = OpTypeVoid\n"
+        "%8 = OpTypeFunction %7\n"             // void()
+        "%9 = OpTypeFloat 16\n"                // float16
+        "%10 = OpTypeInt 32 0\n"                // uint32
+        "%3 = OpTypeRuntimeArray %9\n"         // float16[]
+        "%4 = OpTypeStruct %3\n"               // struct{ float16[] }
+        "%11 = OpTypePointer Uniform %4\n"      // struct{ float16[] }*
+        "%5 = OpVariable %11 Uniform\n"        // struct{ float16[] }* out
+        "%12 = OpConstant %10 0\n"              // uint32(0)
+        "%13 = OpTypeVector %10 3\n"            // vec3<uint32>
+        "%14 = OpTypePointer Input %13\n"       // vec3<uint32>*
+        "%2 = OpVariable %14 Input\n"          // gl_GlobalInvocationId
+        "%15 = OpTypePointer Input %10\n"       // uint32*
+        "%6 = OpVariable %11 Uniform\n"        // struct{ float16[] }* in
+        "%16 = OpTypePointer Uniform %9\n"      // float16*
+        "%17 = OpConstant %9 0x1p+0\n"          // float16(1)
+        "%1 = OpFunction %7 None %8\n"         // -- Function begin --
+        "%18 = OpLabel\n"
+        "%19 = OpAccessChain %15 %2 %12\n"      // &gl_GlobalInvocationId.x
+        "%20 = OpLoad %10 %19\n"                // gl_GlobalInvocationId.x
+        "%21 = OpAccessChain %16 %6 %12 %20\n"  // &in.arr[gl_GlobalInvocationId.x]
+        "%22 = OpLoad %9 %21\n"                 // x = in.arr[gl_GlobalInvocationId.x]
+        "%23 = OpFMul %9 %22 %22\n"             // x * x
+        "%24 = OpFSub %9 %23 %17\n"             // x * x - 1
+        "%25 = OpAccessChain %16 %5 %12 %20\n"  // &out.arr[gl_GlobalInvocationId.x]
+        "OpStore %25 %24\n"               // out.arr[gl_GlobalInvocationId.x] = x * x - 1
+        "OpReturn\n"
+        "OpFunctionEnd\n";
+	// clang-format on
+
+	// Only the low 16 bits of each element are written.
+	auto input = [](uint32_t i) { return 1.0f + float(i % 1024) / 1024.0f; };
+
+	test(
+	    src.str(),
+	    [&](uint32_t i) { return uint32_t(floatToHalf(input(i))); },
+	    [&](uint32_t i) {
+		    float square = halfToFloat(floatToHalf(input(i) * input(i)));
+		    return uint32_t(floatToHalf(square - 1.0f));
+	    });
+}
+
+TEST_P(SwiftShaderVulkanBufferToBufferComputeTest, Int16Wraparound)
+{
+	// #version 450
+	// #extension GL_EXT_shader_explicit_arithmetic_types_int16 : require
+	// layout(local_size_x = 1, local_size_y = 1, local_size_z = 1) in;
+	// layout(binding = 0, std430) buffer InBuffer
+	// {
+	//     u16vec2 Data[];
+	// } In;
+	// layout(binding = 1, std430) buffer OutBuffer
+	// {
+	//     u16vec2 Data[];
+	// } Out;
+	// void main()
+	// {
+	//     Out.Data[gl_GlobalInvocationID.x] = (In.Data[gl_GlobalInvocationID.x] + u16vec2(0xFFFF, 0)) * u16vec2(1, 3);
+	// }
+	std::stringstream src;
+	// clang-format off
+    src <<
+        "OpCapability Shader\n"
+        "OpCapability Int16\n"
+        "OpCapability UniformAndStorageBuffer16BitAccess\n"
+        "OpExtension \"SPV_KHR_16bit_storage\"\n"
+        "OpMemoryModel Logical GLSL450\n"
+        "OpEntryPoint GLCompute %1 \"main\" %2\n"
+        "OpExecutionMode %1 LocalSize " <<
+        GetParam().localSizeX << " " <<
+        GetParam().localSizeY << " " <<
+        GetParam().localSizeZ << "\n" <<
+        "OpDecorate %3 ArrayStride 4\n"
+        "OpMemberDecorate %4 0 Offset 0\n"
+        "OpDecorate %4 BufferBlock\n"
+        "OpDecorate %5 DescriptorSet 0\n"
+        "OpDecorate %5 Binding 1\n"
+        "OpDecorate %2 BuiltIn GlobalInvocationId\n"
+        "OpDecorate %6 DescriptorSet 0\n"
+        "OpDecorate %6 Binding 0\n"
+        "%7 = OpTypeVoid\n"
+        "%8 = OpTypeFunction %7\n"             // void()
+        "%9 = OpTypeInt 16 0\n"                // uint16
+        "%10 = OpTypeVector %9 2\n"             // vec2<uint16>
+        "%11 = OpTypeInt 32 0\n"                // uint32
+        "%3 = OpTypeRuntimeArray %10\n"        // vec2<uint16>[]
+        "%4 = OpTypeStruct %3\n"               // struct{ vec2<uint16>[] }
+        "%12 = OpTypePointer Uniform %4\n"      // struct{ vec2<uint16>[] }*
+        "%5 = OpVariable %12 Uniform\n"        // struct{ vec2<uint16>[] }* out
+        "%13 = OpConstant %11 0\n"              // uint32(0)
+        "%14 = OpTypeVector %11 3\n"            // vec3<uint32>
+        "%15 = OpTypePointer Input %14\n"       // vec3<uint32>*
+        "%2 = OpVariable %15 Input\n"          // gl_GlobalInvocationId
+        "%16 = OpTypePointer Input %11\n"       // uint32*
+        "%6 = OpVariable %12 Uniform\n"        // struct{ vec2<uint16>[] }* in
+        "%17 = OpTypePointer Uniform %10\n"     // vec2<uint16>*
+        "%18 = OpConstant %9 65535\n"           // uint16(0xFFFF)
+        "%19 = OpConstant %9 0\n"               // uint16(0)
+        "%20 = OpConstant %9 1\n"               // uint16(1)
+        "%21 = OpConstant %9 3\n"               // uint16(3)
+        "%22 = OpConstantComposite %10 %18 %19\n" // vec2<uint16>(0xFFFF, 0)
+        "%23 = OpConstantComposite %10 %20 %21\n" // vec2<uint16>(1, 3)
+        "%1 = OpFunction %7 None %8\n"         // -- Function begin --
+        "%24 = OpLabel\n"
+        "%25 = OpAccessChain %16 %2 %13\n"      // &gl_GlobalInvocationId.x
+        "%26 = OpLoad %11 %25\n"                // gl_GlobalInvocationId.x
+        "%27 = OpAccessChain %17 %6 %13 %26\n"  // &in.arr[gl_GlobalInvocationId.x]
+        "%28 = OpLoad %10 %27\n"                // in.arr[gl_GlobalInvocationId.x]
+        "%29 = OpIAdd %10 %28 %22\n"            // in.arr[gl_GlobalInvocationId.x] + vec2(0xFFFF, 0)
+        "%30 = OpIMul %10 %29 %23\n"            // (in.arr[gl_GlobalInvocationId.x] + vec2(0xFFFF, 0)) * vec2(1, 3)
+        "%31 = OpAccessChain %17 %5 %13 %26\n"  // &out.arr[gl_GlobalInvocationId.x]
+        "OpStore %31 %30\n"               // out.arr[gl_GlobalInvocationId.x] = (in.arr[gl_GlobalInvocationId.x] + vec2(0xFFFF, 0)) * vec2(1, 3)
+        "OpReturn\n"
+        "OpFunctionEnd\n";
+	// clang-format on
+
+	test(
+	    src.str(),
+	    [](uint32_t i) { return i | ((i * 257) << 16); },
+	    [](uint32_t i) { return ((i - 1) & 0xFFFF) | (((i * 257 * 3) & 0xFFFF) << 16); });
+}
+
+TEST_P(SwiftShaderVulkanBufferToBufferComputeTest, Int8SignExtend)
+{
+	// #version 450
+	// #extension GL_EXT_shader_explicit_arithmetic_types_int8 : require
+	// layout(local_size_x = 1, local_size_y = 1, local_size_z = 1) in;
+	// layout(binding = 0, std430) buffer InBuffer
+	// {
+	//     i8vec4 Data[];
+	// } In;
+	// layout(binding = 1, std430) buffer OutBuffer
+	// {
+	//     int Data[];
+	// } Out;
+	// void main()
+	// {
+	//     ivec4 v = ivec4(In.Data[gl_GlobalInvocationID.x]);
+	//     Out.Data[gl_GlobalInvocationID.x] = v.x + v.y + v.z + v.w;
+	// }
+	std::stringstream src;
+	// clang-format off
+    src <<
+        "OpCapability Shader\n"
+        "OpCapability Int8\n"
+        "OpCapability UniformAndStorageBuffer8BitAccess\n"
+        "OpExtension \"SPV_KHR_8bit_storage\"\n"
+        "OpMemoryModel Logical GLSL450\n"
+        "OpEntryPoint GLCompute %1 \"main\" %2\n"
+        "OpExecutionMode %1 LocalSize " <<
+        GetParam().localSizeX << " " <<
+        GetParam().localSizeY << " " <<
+        GetParam().localSizeZ << "\n" <<
+        "OpDecorate %3 ArrayStride 4\n"
+        "OpMemberDecorate %4 0 Offset 0\n"
+        "OpDecorate %4 BufferBlock\n"
+        "OpDecorate %5 ArrayStride 4\n"
+        "OpMemberDecorate %6 0 Offset 0\n"
+        "OpDecorate %6 BufferBlock\n"
+        "OpDecorate %7 DescriptorSet 0\n"
+        "OpDecorate %7 Binding 1\n"
+        "OpDecorate %2 BuiltIn GlobalInvocationId\n"
+        "OpDecorate %8 DescriptorSet 0\n"
+        "OpDecorate %8 Binding 0\n"
+        "%9 = OpTypeVoid\n"
+        "%10 = OpTypeFunction %9\n"             // void()
+        "%11 = OpTypeInt 8 1\n"                 // int8
+        "%12 = OpTypeVector %11 4\n"            // vec4<int8>
+        "%13 = OpTypeInt 32 1\n"                // int32
+        "%14 = OpTypeVector %13 4\n"            // vec4<int32>
+        "%15 = OpTypeInt 32 0\n"                // uint32
+        "%3 = OpTypeRuntimeArray %12\n"        // vec4<int8>[]
+        "%4 = OpTypeStruct %3\n"               // struct{ vec4<int8>[] }
+        "%16 = OpTypePointer Uniform %4\n"      // struct{ vec4<int8>[] }*
+        "%5 = OpTypeRuntimeArray %13\n"        // int32[]
+        "%6 = OpTypeStruct %5\n"               // struct{ int32[] }
+        "%17 = OpTypePointer Uniform %6\n"      // struct{ int32[] }*
+        "%7 = OpVariable %17 Uniform\n"        // struct{ int32[] }* out
+        "%18 = OpConstant %15 0\n"              // uint32(0)
+        "%19 = OpTypeVector %15 3\n"            // vec3<uint32>
+        "%20 = OpTypePointer Input %19\n"       // vec3<uint32>*
+        "%2 = OpVariable %20 Input\n"          // gl_GlobalInvocationId
+        "%21 = OpTypePointer Input %15\n"       // uint32*
+        "%8 = OpVariable %16 Uniform\n"        // struct{ vec4<int8>[] }* in
+        "%22 = OpTypePointer Uniform %12\n"     // vec4<int8>*
+        "%23 = OpTypePointer Uniform %13\n"     // int32*
+        "%1 = OpFunction %9 None %10\n"        // -- Function begin --
+        "%24 = OpLabel\n"
+        "%25 = OpAccessChain %21 %2 %18\n"      // &gl_GlobalInvocationId.x
+        "%26 = OpLoad %15 %25\n"                // gl_GlobalInvocationId.x
+        "%27 = OpAccessChain %22 %8 %18 %26\n"  // &in.arr[gl_GlobalInvocationId.x]
+        "%28 = OpLoad %12 %27\n"                // in.arr[gl_GlobalInvocationId.x]
+        "%29 = OpSConvert %14 %28\n"            // v = ivec4(in.arr[gl_GlobalInvocationId.x])
+        "%30 = OpCompositeExtract %13 %29 0\n"  // v.x
+        "%31 = OpCompositeExtract %13 %29 1\n"  // v.y
+        "%32 = OpCompositeExtract %13 %29 2\n"  // v.z
+        "%33 = OpCompositeExtract %13 %29 3\n"  // v.w
+        "%34 = OpIAdd %13 %30 %31\n"            // v.x + v.y
+        "%35 = OpIAdd %13 %34 %32\n"            // v.x + v.y + v.z
+        "%36 = OpIAdd %13 %35 %33\n"            // v.x + v.y + v.z + v.w
+        "%37 = OpAccessChain %23 %7 %18 %26\n"  // &out.arr[gl_GlobalInvocationId.x]
+        "OpStore %37 %36\n"               // out.arr[gl_GlobalInvocationId.x] = v.x + v.y + v.z + v.w
+        "OpReturn\n"
+        "OpFunctionEnd\n";
+	// clang-format on
+
+	auto bytes = [](uint32_t i) { return std::array<int8_t, 4>{ int8_t(i), int8_t(-int32_t(i)), int8_t(i * 3), int8_t(0x80 | i) }; };
+
+	test(
+	    src.str(),
+	    [&](uint32_t i) {
+		    uint32_t packed = 0;
+		    auto b = bytes(i);
+		    memcpy(&packed, b.data(), sizeof(packed));
+		    return packed;
+	    },
+	    [&](uint32_t i) {
+		    auto b = bytes(i);
+		    return uint32_t(b[0] + b[1] + b[2] + b[3]);
+	    });
+}
+
+TEST_P(SwiftShaderVulkanBufferToBufferComputeTest, SubgroupArithmeticInt8)
+{
+	// #version 450
+	// #extension GL_KHR_shader_subgroup_arithmetic : require
+	// #extension GL_EXT_shader_explicit_arithmetic_types_int8 : require
+	// layout(local_size_x = 1, local_size_y = 1, local_size_z = 1) in;
+	// layout(binding = 0, std430) buffer InBuffer
+	// {
+	//     i8vec4 Data[];
+	// } In;
+	// layout(binding = 1, std430) buffer OutBuffer
+	// {
+	//     i8vec4 Data[];
+	// } Out;
+	// void main()
+	// {
+	//     i8vec4 v = In.Data[gl_GlobalInvocationID.x];
+	//     Out.Data[gl_GlobalInvocationID.x] = i8vec4(subgroupInclusiveAdd(v.x),
+	//                                                subgroupExclusiveMin(v.y),
+	//                                                int8_t(subgroupMax(uint8_t(v.z))),
+	//                                                subgroupExclusiveMax(v.w));
+	// }
+	std::stringstream src;
+	// clang-format off
+    src <<
+        "OpCapability Shader\n"
+        "OpCapability Int8\n"
+        "OpCapability UniformAndStorageBuffer8BitAccess\n"
+        "OpCapability GroupNonUniformArithmetic\n"
+        "OpExtension \"SPV_KHR_8bit_storage\"\n"
+        "OpMemoryModel Logical GLSL450\n"
+        "OpEntryPoint GLCompute %1 \"main\" %2\n"
+        "OpExecutionMode %1 LocalSize " <<
+        GetParam().localSizeX << " " <<
+        GetParam().localSizeY << " " <<
+        GetParam().localSizeZ << "\n" <<
+        "OpDecorate %3 ArrayStride 4\n"
+        "OpMemberDecorate %4 0 Offset 0\n"
+        "OpDecorate %4 BufferBlock\n"
+        "OpDecorate %5 DescriptorSet 0\n"
+        "OpDecorate %5 Binding 1\n"
+        "OpDecorate %2 BuiltIn GlobalInvocationId\n"
+        "OpDecorate %6 DescriptorSet 0\n"
+        "OpDecorate %6 Binding 0\n"
+        "%7 = OpTypeVoid\n"
+        "%8 = OpTypeFunction %7\n"             // void()
+        "%9 = OpTypeInt 8 1\n"                 // int8
+        "%10 = OpTypeVector %9 4\n"             // vec4<int8>
+        "%11 = OpTypeInt 32 0\n"                // uint32
+        "%3 = OpTypeRuntimeArray %10\n"        // vec4<int8>[]
+        "%4 = OpTypeStruct %3\n"               // struct{ vec4<int8>[] }
+        "%12 = OpTypePointer Uniform %4\n"      // struct{ vec4<int8>[] }*
+        "%5 = OpVariable %12 Uniform\n"        // struct{ vec4<int8>[] }* out
+        "%13 = OpConstant %11 0\n"              // uint32(0)
+        "%14 = OpTypeVector %11 3\n"            // vec3<uint32>
+        "%15 = OpTypePointer Input %14\n"       // vec3<uint32>*
+        "%2 = OpVariable %15 Input\n"          // gl_GlobalInvocationId
+        "%16 = OpTypePointer Input %11\n"       // uint32*
+        "%6 = OpVariable %12 Uniform\n"        // struct{ vec4<int8>[] }* in
+        "%17 = OpTypePointer Uniform %10\n"     // vec4<int8>*
+        "%18 = OpConstant %11 3\n"              // uint32(3) (Subgroup scope)
+        "%1 = OpFunction %7 None %8\n"         // -- Function begin --
+        "%19 = OpLabel\n"
+        "%20 = OpAccessChain %16 %2 %13\n"      // &gl_GlobalInvocationId.x
+        "%21 = OpLoad %11 %20\n"                // gl_GlobalInvocationId.x
+        "%22 = OpAccessChain %17 %6 %13 %21\n"  // &in.arr[gl_GlobalInvocationId.x]
+        "%23 = OpLoad %10 %22\n"                // v = in.arr[gl_GlobalInvocationId.x]
+        "%24 = OpCompositeExtract %9 %23 0\n"   // v.x
+        "%25 = OpCompositeExtract %9 %23 1\n"   // v.y
+        "%26 = OpCompositeExtract %9 %23 2\n"   // v.z
+        "%27 = OpCompositeExtract %9 %23 3\n"   // v.w
+        "%28 = OpGroupNonUniformIAdd %9 %18 InclusiveScan %24\n"  // subgroupInclusiveAdd(v.x)
+        "%29 = OpGroupNonUniformSMin %9 %18 ExclusiveScan %25\n"  // subgroupExclusiveMin(v.y)
+        "%30 = OpGroupNonUniformUMax %9 %18 Reduce %26\n"         // subgroupMax(uint8_t(v.z))
+        "%31 = OpGroupNonUniformSMax %9 %18 ExclusiveScan %27\n"  // subgroupExclusiveMax(v.w)
+        "%32 = OpCompositeConstruct %10 %28 %29 %30 %31\n"
+        "%33 = OpAccessChain %17 %5 %13 %21\n"  // &out.arr[gl_GlobalInvocationId.x]
+        "OpStore %33 %32\n"
+        "OpReturn\n"
+        "OpFunctionEnd\n";
+	// clang-format on
+
+	// The sums wrap around, and the exclusive min and max start from the limits of int8.
+	auto bytes = [](uint32_t i) { return std::array<int8_t, 4>{ int8_t(100 + 3 * i), int8_t(i * 37 + 5), int8_t(i * 13), int8_t(i * 59 - 7) }; };
+
+	auto pack = [](std::array<int8_t, 4> b) {
+		uint32_t packed = 0;
+		memcpy(&packed, b.data(), sizeof(packed));
+		return packed;
+	};
+
+	test(
+	    src.str(),
+	    [&](uint32_t i) { return pack(bytes(i)); },
+	    [&](uint32_t i) {
+		    auto [first, size] = subgroup(i);
+		    int8_t sum = 0;
+		    int8_t exclusiveMin = INT8_MAX;
+		    uint8_t max = 0;
+		    int8_t exclusiveMax = INT8_MIN;
+		    for(uint32_t j = first; j < first + size; j++)
+		    {
+			    auto b = bytes(j);
+			    if(j <= i) { sum = int8_t(sum + b[0]); }
+			    if(j < i) { exclusiveMin = std::min(exclusiveMin, b[1]); }
+			    max = std::max(max, uint8_t(b[2]));
+			    if(j < i) { exclusiveMax = std::max(exclusiveMax, b[3]); }
+		    }
+		    return pack({ sum, exclusiveMin, int8_t(max), exclusiveMax });
+	    },
+	    SPV_ENV_VULKAN_1_1);
+}
+
+TEST_P(SwiftShaderVulkanBufferToBufferComputeTest, SubgroupArithmeticInt16)
+{
+	// #version 450
+	// #extension GL_KHR_shader_subgroup_arithmetic : require
+	// #extension GL_EXT_shader_explicit_arithmetic_types_int16 : require
+	// layout(local_size_x = 1, local_size_y = 1, local_size_z = 1) in;
+	// layout(binding = 0, std430) buffer InBuffer
+	// {
+	//     u16vec2 Data[];
+	// } In;
+	// layout(binding = 1, std430) buffer OutBuffer
+	// {
+	//     u16vec2 Data[];
+	// } Out;
+	// void main()
+	// {
+	//     u16vec2 v = In.Data[gl_GlobalInvocationID.x];
+	//     Out.Data[gl_GlobalInvocationID.x] = u16vec2(subgroupMin(int16_t(v.x)),
+	//                                                 subgroupInclusiveMax(int16_t(v.y)));
+	// }
+	std::stringstream src;
+	// clang-format off
+    src <<
+        "OpCapability Shader\n"
+        "OpCapability Int16\n"
+        "OpCapability UniformAndStorageBuffer16BitAccess\n"
+        "OpCapability GroupNonUniformArithmetic\n"
+        "OpExtension \"SPV_KHR_16bit_storage\"\n"
+        "OpMemoryModel Logical GLSL450\n"
+        "OpEntryPoint GLCompute %1 \"main\" %2\n"
+        "OpExecutionMode %1 LocalSize " <<
+        GetParam().localSizeX << " " <<
+        GetParam().localSizeY << " " <<
+        GetParam().localSizeZ << "\n" <<
+        "OpDecorate %3 ArrayStride 4\n"
+        "OpMemberDecorate %4 0 Offset 0\n"
+        "OpDecorate %4 BufferBlock\n"
+        "OpDecorate %5 DescriptorSet 0\n"
+        "OpDecorate %5 Binding 1\n"
+        "OpDecorate %2 BuiltIn GlobalInvocationId\n"
+        "OpDecorate %6 DescriptorSet 0\n"
+        "OpDecorate %6 Binding 0\n"
+        "%7 = OpTypeVoid\n"
+        "%8 = OpTypeFunction %7\n"             // void()
+        "%9 = OpTypeInt 16 0\n"                // uint16
+        "%10 = OpTypeVector %9 2\n"             // vec2<uint16>
+        "%11 = OpTypeInt 32 0\n"                // uint32
+        "%3 = OpTypeRuntimeArray %10\n"        // vec2<uint16>[]
+        "%4 = OpTypeStruct %3\n"               // struct{ vec2<uint16>[] }
+        "%12 = OpTypePointer Uniform %4\n"      // struct{ vec2<uint16>[] }*
+        "%5 = OpVariable %12 Uniform\n"        // struct{ vec2<uint16>[] }* out
+        "%13 = OpConstant %11 0\n"              // uint32(0)
+        "%14 = OpTypeVector %11 3\n"            // vec3<uint32>
+        "%15 = OpTypePointer Input %14\n"       // vec3<uint32>*
+        "%2 = OpVariable %15 Input\n"          // gl_GlobalInvocationId
+        "%16 = OpTypePointer Input %11\n"       // uint32*
+        "%6 = OpVariable %12 Uniform\n"        // struct{ vec2<uint16>[] }* in
+        "%17 = OpTypePointer Uniform %10\n"     // vec2<uint16>*
+        "%18 = OpConstant %11 3\n"              // uint32(3) (Subgroup scope)
+        "%1 = OpFunction %7 None %8\n"         // -- Function begin --
+        "%19 = OpLabel\n"
+        "%20 = OpAccessChain %16 %2 %13\n"      // &gl_GlobalInvocationId.x
+        "%21 = OpLoad %11 %20\n"                // gl_GlobalInvocationId.x
+        "%22 = OpAccessChain %17 %6 %13 %21\n"  // &in.arr[gl_GlobalInvocationId.x]
+        "%23 = OpLoad %10 %22\n"                // v = in.arr[gl_GlobalInvocationId.x]
+        "%24 = OpCompositeExtract %9 %23 0\n"   // v.x
+        "%25 = OpCompositeExtract %9 %23 1\n"   // v.y
+        "%26 = OpGroupNonUniformSMin %9 %18 Reduce %24\n"         // subgroupMin(int16_t(v.x))
+        "%27 = OpGroupNonUniformSMax %9 %18 InclusiveScan %25\n"  // subgroupInclusiveMax(int16_t(v.y))
+        "%28 = OpCompositeConstruct %10 %26 %27\n"
+        "%29 = OpAccessChain %17 %5 %13 %21\n"  // &out.arr[gl_GlobalInvocationId.x]
+        "OpStore %29 %28\n"
+        "OpReturn\n"
+        "OpFunctionEnd\n";
+	// clang-format on
+
+	// The operands are unsigned, but compared as signed values.
+	auto x = [](uint32_t i) { return uint16_t(i * 5003 + 7); };
+	auto y = [](uint32_t i) { return uint16_t(i * 7919); };
+
+	test(
+	    src.str(),
+	    [&](uint32_t i) { return uint32_t(x(i)) | (uint32_t(y(i)) << 16); },
+	    [&](uint32_t i) {
+		    auto [first, size] = subgroup(i);
+		    int16_t min = INT16_MAX;
+		    int16_t inclusiveMax = INT16_MIN;
+		    for(uint32_t j = first; j < first + size; j++)
+		    {
+			    min = std::min(min, int16_t(x(j)));
+			    if(j <= i) { inclusiveMax = std::max(inclusiveMax, int16_t(y(j))); }
+		    }
+		    return uint32_t(uint16_t(min)) | (uint32_t(uint16_t(inclusiveMax)) << 16);
+	    },
+	    SPV_ENV_VULKAN_1_1);
+}
+
+TEST_P(SwiftShaderVulkanBufferToBufferComputeTest, SubgroupArithmeticFloat16)
+{
+	// #version 450
+	// #extension GL_KHR_shader_subgroup_arithmetic : require
+	// #extension GL_EXT_shader_explicit_arithmetic_types_float16 : require
+	// layout(local_size_x = 1, local_size_y = 1, local_size_z = 1) in;
+	// layout(binding = 0, std430) buffer InBuffer
+	// {
+	//     float16_t Data[];  // With a stride of 4
+	// } In;
+	// layout(binding = 1, std430) buffer OutBuffer
+	// {
+	//     float Data[];
+	// } Out;
+	// void main()
+	// {
+	//     Out.Data[gl_GlobalInvocationID.x] = float(subgroupMul(In.Data[gl_GlobalInvocationID.x]));
+	// }
+	std::stringstream src;
+	// clang-format off
+    src <<
+        "OpCapability Shader\n"
+        "OpCapability Float16\n"
+        "OpCapability UniformAndStorageBuffer16BitAccess\n"
+        "OpCapability GroupNonUniformArithmetic\n"
+        "OpExtension \"SPV_KHR_16bit_storage\"\n"
+        "OpMemoryModel Logical GLSL450\n"
+        "OpEntryPoint GLCompute %1 \"main\" %2\n"
+        "OpExecutionMode %1 LocalSize " <<
+        GetParam().localSizeX << " " <<
+        GetParam().localSizeY << " " <<
+        GetParam().localSizeZ << "\n" <<
+        "OpDecorate %3 ArrayStride 4\n"
+        "OpMemberDecorate %4 0 Offset 0\n"
+        "OpDecorate %4 BufferBlock\n"
+        "OpDecorate %5 ArrayStride 4\n"
+        "OpMemberDecorate %6 0 Offset 0\n"
+        "OpDecorate %6 BufferBlock\n"
+        "OpDecorate %7 DescriptorSet 0\n"
+        "OpDecorate %7 Binding 1\n"
+        "OpDecorate %2 BuiltIn GlobalInvocationId\n"
+        "OpDecorate %8 DescriptorSet 0\n"
+        "OpDecorate %8 Binding 0\n"
+        "%9 = OpTypeVoid\n"
+        "%10 = OpTypeFunction %9\n"             // void()
+        "%11 = OpTypeFloat 16\n"                // float16
+        "%12 = OpTypeFloat 32\n"                // float32
+        "%13 = OpTypeInt 32 0\n"                // uint32
+        "%3 = OpTypeRuntimeArray %11\n"        // float16[]
+        "%4 = OpTypeStruct %3\n"               // struct{ float16[] }
+        "%14 = OpTypePointer Uniform %4\n"      // struct{ float16[] }*
+        "%5 = OpTypeRuntimeArray %12\n"        // float32[]
+        "%6 = OpTypeStruct %5\n"               // struct{ float32[] }
+        "%15 = OpTypePointer Uniform %6\n"      // struct{ float32[] }*
+        "%7 = OpVariable %15 Uniform\n"        // struct{ float32[] }* out
+        "%16 = OpConstant %13 0\n"              // uint32(0)
+        "%17 = OpTypeVector %13 3\n"            // vec3<uint32>
+        "%18 = OpTypePointer Input %17\n"       // vec3<uint32>*
+        "%2 = OpVariable %18 Input\n"          // gl_GlobalInvocationId
+        "%19 = OpTypePointer Input %13\n"       // uint32*
+        "%8 = OpVariable %14 Uniform\n"        // struct{ float16[] }* in
+        "%20 = OpTypePointer Uniform %11\n"     // float16*
+        "%21 = OpTypePointer Uniform %12\n"     // float32*
+        "%22 = OpConstant %13 3\n"              // uint32(3) (Subgroup scope)
+        "%1 = OpFunction %9 None %10\n"        // -- Function begin --
+        "%23 = OpLabel\n"
+        "%24 = OpAccessChain %19 %2 %16\n"      // &gl_GlobalInvocationId.x
+        "%25 = OpLoad %13 %24\n"                // gl_GlobalInvocationId.x
+        "%26 = OpAccessChain %20 %8 %16 %25\n"  // &in.arr[gl_GlobalInvocationId.x]
+        "%27 = OpLoad %11 %26\n"                // in.arr[gl_GlobalInvocationId.x]
+        "%28 = OpGroupNonUniformFMul %11 %22 Reduce %27\n"  // subgroupMul(in.arr[gl_GlobalInvocationId.x])
+        "%29 = OpFConvert %12 %28\n"            // float(subgroupMul(in.arr[gl_GlobalInvocationId.x]))
+        "%30 = OpAccessChain %21 %7 %16 %25\n"  // &out.arr[gl_GlobalInvocationId.x]
+        "OpStore %30 %29\n"
+        "OpReturn\n"
+        "OpFunctionEnd\n";
+	// clang-format on
+
+	// All invocations of a subgroup multiply the same value, so the result doesn't
+	// depend on the order of the products, but each product must be rounded to
+	// half precision.
+	auto input = [](uint32_t i) { return 1.0f + float((i / 4) % 256) / 1024.0f; };
+	auto round = [](float f) { return halfToFloat(floatToHalf(f)); };
+
+	test(
+	    src.str(),
+	    [&](uint32_t i) { return uint32_t(floatToHalf(input(i))); },
+	    [&](uint32_t i) {
+		    float a = input(i);
+		    float product = a;
+		    switch(subgroup(i).second)
+		    {
+		    case 2: product = round(a * a); break;
+		    case 4: product = round(round(a * a) * round(a * a)); break;
+		    }
+		    uint32_t bits;
+		    memcpy(&bits, &product, sizeof(bits));
+		    return bits;
+	    },
+	    SPV_ENV_VULKAN_1_1);
+}
+
+// Compute test that indexes a runtime array of uniform texel buffers with a
+// non-uniform index. The array is allocated with a variable descriptor count,
+// is only partially written, and is written after the descriptor set was bound.
+class SwiftShaderVulkanDescriptorIndexingComputeTest : public ComputeTest
+{
+};
+
+INSTANTIATE_TEST_SUITE_P(ComputeParams, SwiftShaderVulkanDescriptorIndexingComputeTest, testing::Values(ComputeParams{ 64, 1, 1, 1 }, ComputeParams{ 64, 4, 1, 1 }, ComputeParams{ 64, 16, 1, 1 }));
+
+TEST_P(SwiftShaderVulkanDescriptorIndexingComputeTest, NonUniformTexelBufferArray)
+{
+	// #version 450
+	// #extension GL_EXT_nonuniform_qualifier : require
+	// layout(local_size_x = 1, local_size_y = 1, local_size_z = 1) in;
+	// layout(binding = 0, std430) buffer OutBuffer
+	// {
+	//     uint Data[];
+	// } Out;
+	// layout(binding = 1, r32ui) uniform utextureBuffer Texels[];
+	// void main()
+	// {
+	//     uint i = gl_GlobalInvocationID.x;
+	//     Out.Data[i] = texelFetch(Texels[nonuniformEXT(i % 4)], int(i)).x;
+	// }
+	std::stringstream src;
+	// clang-format off
+    src <<
+        "OpCapability Shader\n"
+        "OpCapability SampledBuffer\n"
+        "OpCapability ShaderNonUniform\n"
+        "OpCapability RuntimeDescriptorArray\n"
+        "OpCapability UniformTexelBufferArrayNonUniformIndexing\n"
+        "OpExtension \"SPV_EXT_descriptor_indexing\"\n"
+        "OpMemoryModel Logical GLSL450\n"
+        "OpEntryPoint GLCompute %1 \"main\" %2\n"
+        "OpExecutionMode %1 LocalSize " <<
+        GetParam().localSizeX << " " <<
+        GetParam().localSizeY << " " <<
+        GetParam().localSizeZ << "\n" <<
+        "OpDecorate %2 BuiltIn GlobalInvocationId\n"
+        "OpDecorate %3 ArrayStride 4\n"
+        "OpMemberDecorate %4 0 Offset 0\n"
+        "OpDecorate %4 BufferBlock\n"
+        "OpDecorate %5 DescriptorSet 0\n"
+        "OpDecorate %5 Binding 0\n"
+        "OpDecorate %6 DescriptorSet 0\n"
+        "OpDecorate %6 Binding 1\n"
+        "OpDecorate %7 NonUniform\n"
+        "OpDecorate %8 NonUniform\n"
+        "OpDecorate %9 NonUniform\n"
+        "%10 = OpTypeVoid\n"
+        "%11 = OpTypeFunction %10\n"
+        "%12 = OpTypeInt 32 0\n"
+        "%13 = OpTypeVector %12 3\n"
+        "%14 = OpTypePointer Input %13\n"
+        "%2 = OpVariable %14 Input\n"
+        "%15 = OpConstant %12 0\n"
+        "%16 = OpConstant %12 4\n"
+        "%17 = OpTypePointer Input %12\n"
+        "%3 = OpTypeRuntimeArray %12\n"
+        "%4 = OpTypeStruct %3\n"
+        "%18 = OpTypePointer Uniform %4\n"
+        "%5 = OpVariable %18 Uniform\n"
+        "%19 = OpTypePointer Uniform %12\n"
+        "%20 = OpTypeImage %12 Buffer 0 0 0 1 R32ui\n"
+        "%21 = OpTypeRuntimeArray %20\n"
+        "%22 = OpTypePointer UniformConstant %21\n"
+        "%6 = OpVariable %22 UniformConstant\n"
+        "%23 = OpTypePointer UniformConstant %20\n"
+        "%24 = OpTypeVector %12 4\n"
+        "%1 = OpFunction %10 None %11\n"
+        "%25 = OpLabel\n"
+        "%26 = OpAccessChain %17 %2 %15\n"
+        "%27 = OpLoad %12 %26\n"            // i
+        "%7 = OpUMod %12 %27 %16\n"         // i % 4
+        "%8 = OpAccessChain %23 %6 %7\n"    // &Texels[i % 4]
+        "%9 = OpLoad %20 %8\n"
+        "%28 = OpImageFetch %24 %9 %27\n"
+        "%29 = OpCompositeExtract %12 %28 0\n"
+        "%30 = OpAccessChain %19 %5 %15 %27\n"
+        "OpStore %30 %29\n"
+        "OpReturn\n"
+        "OpFunctionEnd\n";
+	// clang-format on
+
+	auto code = compileSpirv(src.str().c_str());
+
+	const VkInstanceCreateInfo createInfo = {
+		VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO,  // sType
+		nullptr,                                 // pNext
+		0,                                       // flags
+		nullptr,                                 // pApplicationInfo
+		0,                                       // enabledLayerCount
+		nullptr,                                 // ppEnabledLayerNames
+		0,                                       // enabledExtensionCount
+		nullptr,                                 // ppEnabledExtensionNames
+	};
+
+	VkInstance instance = VK_NULL_HANDLE;
+	VK_ASSERT(driver.vkCreateInstance(&createInfo, nullptr, &instance));
+
+	ASSERT_TRUE(driver.resolve(instance));
+
+	std::unique_ptr<Device> device;
+	VK_ASSERT(Device::CreateComputeDevice(&driver, instance, device));
+	ASSERT_TRUE(device->IsValid());
+
+	// The output buffer is followed by one texel buffer per array element,
+	// each aligned to 0x100 bytes. Element j of texel buffer i holds
+	// i * 1000 + j.
+	constexpr uint32_t texelBufferCount = 4;
+	constexpr uint32_t variableDescriptorCount = 8;
+	constexpr uint32_t maxDescriptorCount = 16;
+	size_t numElements = GetParam().numElements;
+	size_t regionSize = alignUp(sizeof(uint32_t) * numElements, 0x100);
+	size_t buffersSize = regionSize * (1 + texelBufferCount);
+
+	VkDeviceMemory memory;
+	VK_ASSERT(device->AllocateMemory(buffersSize,
+	                                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+	                                 &memory));
+
+	uint32_t *buffers;
+	VK_ASSERT(device->MapMemory(memory, 0, buffersSize, 0, (void **)&buffers));
+
+	memset(buffers, 0, buffersSize);
+
+	for(uint32_t i = 0; i < texelBufferCount; i++)
+	{
+		uint32_t *texels = buffers + (i + 1) * regionSize / sizeof(uint32_t);
+		for(uint32_t j = 0; j < numElements; j++)
+		{
+			texels[j] = i * 1000 + j;
+		}
+	}
+
+	device->UnmapMemory(memory);
+	buffers = nullptr;
+
+	VkBuffer bufferOut;
+	VK_ASSERT(device->CreateStorageBuffer(memory, sizeof(uint32_t) * numElements, 0, &bufferOut));
+
+	std::vector<VkBuffer> texelBuffers(texelBufferCount);
+	std::vector<VkBufferView> texelBufferViews(texelBufferCount);
+	for(uint32_t i = 0; i < texelBufferCount; i++)
+	{
+		VK_ASSERT(device->CreateBuffer(memory, sizeof(uint32_t) * numElements, (i + 1) * regionSize,
+		                               VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT, &texelBuffers[i]));
+		VK_ASSERT(device->CreateBufferView(texelBuffers[i], VK_FORMAT_R32_UINT, &texelBufferViews[i]));
+	}
+
+	VkShaderModule shaderModule;
+	VK_ASSERT(device->CreateShaderModule(code, &shaderModule));
+
+	std::vector<VkDescriptorSetLayoutBinding> descriptorSetLayoutBindings = {
+		{
+		    0,                                  // binding
+		    VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,  // descriptorType
+		    1,                                  // descriptorCount
+		    VK_SHADER_STAGE_COMPUTE_BIT,        // stageFlags
+		    0,                                  // pImmutableSamplers
+		},
+		{
+		    1,                                        // binding
+		    VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER,  // descriptorType
+		    maxDescriptorCount,                       // descriptorCount
+		    VK_SHADER_STAGE_COMPUTE_BIT,              // stageFlags
+		    0,                                        // pImmutableSamplers
+		}
+	};
+
+	std::vector<VkDescriptorBindingFlags> descriptorBindingFlags = {
+		0,
+		VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+		    VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+		    VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT,
+	};
+
+	VkDescriptorSetLayout descriptorSetLayout;
+	VK_ASSERT(device->CreateDescriptorSetLayout(descriptorSetLayoutBindings, descriptorBindingFlags, &descriptorSetLayout));
+
+	VkPipelineLayout pipelineLayout;
+	VK_ASSERT(device->CreatePipelineLayout(descriptorSetLayout, &pipelineLayout));
+
+	VkPipeline pipeline;
+	VK_ASSERT(device->CreateComputePipeline(shaderModule, pipelineLayout, &pipeline));
+
+	std::vector<VkDescriptorPoolSize> descriptorPoolSizes = {
+		{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1 },
+		{ VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER, maxDescriptorCount },
+	};
+
+	VkDescriptorPool descriptorPool;
+	VK_ASSERT(device->CreateDescriptorPool(descriptorPoolSizes, VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT, &descriptorPool));
+
+	VkDescriptorSet descriptorSet;
+	VK_ASSERT(device->AllocateDescriptorSet(descriptorPool, descriptorSetLayout, variableDescriptorCount, &descriptorSet));
+
+	std::vector<VkDescriptorBufferInfo> descriptorBufferInfos = {
+		{
+		    bufferOut,      // buffer
+		    0,              // offset
+		    VK_WHOLE_SIZE,  // range
+		}
+	};
+	device->UpdateStorageBufferDescriptorSets(descriptorSet, descriptorBufferInfos);
+
+	VkCommandPool commandPool;
+	VK_ASSERT(device->CreateCommandPool(&commandPool));
+
+	VkCommandBuffer commandBuffer;
+	VK_ASSERT(device->AllocateCommandBuffer(commandPool, &commandBuffer));
+
+	VK_ASSERT(device->BeginCommandBuffer(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, commandBuffer));
+
+	driver.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+
+	driver.vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1, &descriptorSet,
+	                               0, nullptr);
+
+	driver.vkCmdDispatch(commandBuffer, (uint32_t)(numElements / GetParam().localSizeX), 1, 1);
+
+	VK_ASSERT(driver.vkEndCommandBuffer(commandBuffer));
+
+	// Only the first texelBufferCount of the variableDescriptorCount array
+	// elements are written, after the set was bound.
+	device->UpdateUniformTexelBufferDescriptorSet(descriptorSet, 1, texelBufferViews);
+
+	VK_ASSERT(device->QueueSubmitAndWait(commandBuffer));
+
+	VK_ASSERT(device->MapMemory(memory, 0, buffersSize, 0, (void **)&buffers));
+
+	for(uint32_t i = 0; i < numElements; ++i)
+	{
+		EXPECT_EQ((i % texelBufferCount) * 1000 + i, buffers[i]) << "Unexpected output at " << i;
+	}
+
+	device->UnmapMemory(memory);
+	buffers = nullptr;
+
+	device->FreeCommandBuffer(commandPool, commandBuffer);
+	device->DestroyPipeline(pipeline);
+	device->DestroyCommandPool(commandPool);
+	device->DestroyPipelineLayout(pipelineLayout);
+	device->DestroyDescriptorSetLayout(descriptorSetLayout);
+	device->DestroyDescriptorPool(descriptorPool);
+	for(uint32_t i = 0; i < texelBufferCount; i++)
+	{
+		device->DestroyBufferView(texelBufferViews[i]);
+		device->DestroyBuffer(texelBuffers[i]);
+	}
+	device->DestroyBuffer(bufferOut);
+	device->FreeMemory(memory);
+	device->DestroyShaderModule(shaderModule);
+	device.reset(nullptr);
+	driver.vkDestroyInstance(instance, nullptr);
+}
+
+// Queries around a dispatch of an empty shader with numElements invocations.
+class SwiftShaderVulkanQueryComputeTest : public ComputeTest
+{
+protected:
+	void SetUp() override;
+	void TearDown() override;
+
+	// Binds the pipeline and records the dispatch.
+	void recordDispatch();
+
+	VkInstance instance = VK_NULL_HANDLE;
+	std::unique_ptr<Device> device;
+	VkShaderModule shaderModule = VK_NULL_HANDLE;
+	VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
+	VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+	VkPipeline pipeline = VK_NULL_HANDLE;
+	VkCommandPool commandPool = VK_NULL_HANDLE;
+	VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+};
+
+void SwiftShaderVulkanQueryComputeTest::SetUp()
+{
+	std::stringstream src;
+	// #version 450
+	// layout(local_size_x = 1, local_size_y = 1, local_size_z = 1) in;
+	// void main()
+	// {
+	// }
+	// clang-format off
+    src <<
+        "OpCapability Shader\n"
+        "OpMemoryModel Logical GLSL450\n"
+        "OpEntryPoint GLCompute %1 \"main\"\n"
+        "OpExecutionMode %1 LocalSize " <<
+        GetParam().localSizeX << " " <<
+        GetParam().localSizeY << " " <<
+        GetParam().localSizeZ << "\n" <<
+        "%2 = OpTypeVoid\n"
+        "%3 = OpTypeFunction %2\n"
+        "%1 = OpFunction %2 None %3\n"
+        "%4 = OpLabel\n"
+        "OpReturn\n"
+        "OpFunctionEnd\n";
+	// clang-format on
+
+	auto code = compileSpirv(src.str().c_str());
+
+	const VkInstanceCreateInfo createInfo = {
+		VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO,  // sType
+		nullptr,                                 // pNext
+		0,                                       // flags
+		nullptr,                                 // pApplicationInfo
+		0,                                       // enabledLayerCount
+		nullptr,                                 // ppEnabledLayerNames
+		0,                                       // enabledExtensionCount
+		nullptr,                                 // ppEnabledExtensionNames
+	};
+
+	VK_ASSERT(driver.vkCreateInstance(&createInfo, nullptr, &instance));
+
+	ASSERT_TRUE(driver.resolve(instance));
+
+	VkPhysicalDeviceFeatures features = {};
+	features.pipelineStatisticsQuery = VK_TRUE;
+
+	VK_ASSERT(Device::CreateComputeDevice(&driver, instance, device, &features));
+	ASSERT_TRUE(device->IsValid());
+
+	VK_ASSERT(device->CreateShaderModule(code, &shaderModule));
+	VK_ASSERT(device->CreateDescriptorSetLayout({}, &descriptorSetLayout));
+	VK_ASSERT(device->CreatePipelineLayout(descriptorSetLayout, &pipelineLayout));
+	VK_ASSERT(device->CreateComputePipeline(shaderModule, pipelineLayout, &pipeline));
+	VK_ASSERT(device->CreateCommandPool(&commandPool));
+	VK_ASSERT(device->AllocateCommandBuffer(commandPool, &commandBuffer));
+}
+
+void SwiftShaderVulkanQueryComputeTest::TearDown()
+{
+	if(device)
+	{
+		device->FreeCommandBuffer(commandPool, commandBuffer);
+		device->DestroyCommandPool(commandPool);
+		device->DestroyPipeline(pipeline);
+		device->DestroyPipelineLayout(pipelineLayout);
+		device->DestroyDescriptorSetLayout(descriptorSetLayout);
+		device->DestroyShaderModule(shaderModule);
+		device.reset(nullptr);
+	}
+
+	driver.vkDestroyInstance(instance, nullptr);
+}
+
+void SwiftShaderVulkanQueryComputeTest::recordDispatch()
+{
+	driver.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+	driver.vkCmdDispatch(commandBuffer, (uint32_t)(GetParam().numElements / GetParam().localSizeX), 1, 1);
+}
+
+INSTANTIATE_TEST_SUITE_P(ComputeParams, SwiftShaderVulkanQueryComputeTest, testing::Values(ComputeParams{ 512, 1, 1, 1 }, ComputeParams{ 512, 16, 1, 1 }, ComputeParams{ 3, 1, 1, 1 }));
+
+TEST_P(SwiftShaderVulkanQueryComputeTest, PipelineStatistics)
+{
+	VkQueryPool queryPool;
+	VK_ASSERT(device->CreateQueryPool(VK_QUERY_TYPE_PIPELINE_STATISTICS, 1,
+	                                  VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+	                                      VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT,
+	                                  &queryPool));
+
+	VK_ASSERT(device->BeginCommandBuffer(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, commandBuffer));
+
+	driver.vkCmdResetQueryPool(commandBuffer, queryPool, 0, 1);
+	driver.vkCmdBeginQuery(commandBuffer, queryPool, 0, 0);
+	recordDispatch();
+	driver.vkCmdEndQuery(commandBuffer, queryPool, 0);
+
+	VK_ASSERT(driver.vkEndCommandBuffer(commandBuffer));
+
+	VK_ASSERT(device->QueueSubmitAndWait(commandBuffer));
+
+	// Statistics are written in bit order: vertex, then compute shader invocations.
+	uint64_t statistics[2] = {};
+	VK_ASSERT(device->GetQueryPoolResults(queryPool, 0, 1, sizeof(statistics), statistics));
+	EXPECT_EQ(statistics[0], 0u);
+	EXPECT_EQ(statistics[1], GetParam().numElements);
+
+	device->DestroyQueryPool(queryPool);
+}
+
+TEST_P(SwiftShaderVulkanQueryComputeTest, Timestamps)
+{
+	VkQueryPool queryPool;
+	VK_ASSERT(device->CreateQueryPool(VK_QUERY_TYPE_TIMESTAMP, 2, 0, &queryPool));
+
+	VK_ASSERT(device->BeginCommandBuffer(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, commandBuffer));
+
+	driver.vkCmdResetQueryPool(commandBuffer, queryPool, 0, 2);
+	driver.vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPool, 0);
+	recordDispatch();
+	driver.vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool, 1);
+
+	VK_ASSERT(driver.vkEndCommandBuffer(commandBuffer));
+
+	VK_ASSERT(device->QueueSubmitAndWait(commandBuffer));
+
+	uint64_t timestamps[2] = {};
+	VK_ASSERT(device->GetQueryPoolResults(queryPool, 0, 2, sizeof(uint64_t), timestamps));
+	EXPECT_NE(timestamps[0], 0u);
+	EXPECT_LE(timestamps[0], timestamps[1]);
+
+	device->DestroyQueryPool(queryPool);
+}
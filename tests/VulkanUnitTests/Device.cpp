@@ -46,7 +46,8 @@ bool Device::IsValid() const
 }
 
 VkResult Device::CreateComputeDevice(
-    Driver const *driver, VkInstance instance, std::unique_ptr<Device> &out)
+    Driver const *driver, VkInstance instance, std::unique_ptr<Device> &out,
+    const VkPhysicalDeviceFeatures *enabledFeatures)
 {
 	VkResult result;
 
@@ -87,7 +88,7 @@ VkResult Device::CreateComputeDevice(
 			nullptr,                               // ppEnabledLayerNames
 			0,                                     // enabledExtensionCount
 			nullptr,                               // ppEnabledExtensionNames
-			nullptr,                               // pEnabledFeatures
+			enabledFeatures,                       // pEnabledFeatures
 		};
 
 		VkDevice device;
@@ -147,13 +148,21 @@ VkResult Device::GetPhysicalDevices(
 VkResult Device::CreateStorageBuffer(
     VkDeviceMemory memory, VkDeviceSize size,
     VkDeviceSize offset, VkBuffer *out) const
+{
+	return CreateBuffer(memory, size, offset, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, out);
+}
+
+VkResult Device::CreateBuffer(
+    VkDeviceMemory memory, VkDeviceSize size,
+    VkDeviceSize offset, VkBufferUsageFlags usage,
+    VkBuffer *out) const
 {
 	const VkBufferCreateInfo info = {
 		VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,  // sType
 		nullptr,                               // pNext
 		0,                                     // flags
 		size,                                  // size
-		VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,    // usage
+		usage,                                 // usage
 		VK_SHARING_MODE_EXCLUSIVE,             // sharingMode
 		0,                                     // queueFamilyIndexCount
 		nullptr,                               // pQueueFamilyIndices
@@ -181,6 +190,27 @@ void Device::DestroyBuffer(VkBuffer buffer) const
 	driver->vkDestroyBuffer(device, buffer, nullptr);
 }
 
+VkResult Device::CreateBufferView(
+    VkBuffer buffer, VkFormat format, VkBufferView *out) const
+{
+	const VkBufferViewCreateInfo info = {
+		VK_STRUCTURE_TYPE_BUFFER_VIEW_CREATE_INFO,  // sType
+		nullptr,                                    // pNext
+		0,                                          // flags
+		buffer,                                     // buffer
+		format,                                     // format
+		0,                                          // offset
+		VK_WHOLE_SIZE,                              // range
+	};
+
+	return driver->vkCreateBufferView(device, &info, 0, out);
+}
+
+void Device::DestroyBufferView(VkBufferView bufferView) const
+{
+	driver->vkDestroyBufferView(device, bufferView, nullptr);
+}
+
 VkResult Device::CreateShaderModule(
     const std::vector<uint32_t> &spirv, VkShaderModule *out) const
 {
@@ -214,6 +244,38 @@ VkResult Device::CreateDescriptorSetLayout(
 	return driver->vkCreateDescriptorSetLayout(device, &info, 0, out);
 }
 
+VkResult Device::CreateDescriptorSetLayout(
+    const std::vector<VkDescriptorSetLayoutBinding> &bindings,
+    const std::vector<VkDescriptorBindingFlags> &bindingFlags,
+    VkDescriptorSetLayout *out) const
+{
+	VkDescriptorSetLayoutBindingFlagsCreateInfo flagsInfo = {
+		VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,  // sType
+		nullptr,                                                            // pNext
+		(uint32_t)bindingFlags.size(),                                      // bindingCount
+		bindingFlags.data(),                                                // pBindingFlags
+	};
+
+	VkDescriptorSetLayoutCreateFlags flags = 0;
+	for(auto bindingFlag : bindingFlags)
+	{
+		if(bindingFlag & VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT)
+		{
+			flags |= VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+		}
+	}
+
+	VkDescriptorSetLayoutCreateInfo info = {
+		VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,  // sType
+		&flagsInfo,                                           // pNext
+		flags,                                                // flags
+		(uint32_t)bindings.size(),                            // bindingCount
+		bindings.data(),                                      // pBindings
+	};
+
+	return driver->vkCreateDescriptorSetLayout(device, &info, 0, out);
+}
+
 void Device::DestroyDescriptorSetLayout(VkDescriptorSetLayout descriptorSetLayout) const
 {
 	driver->vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
@@ -291,6 +353,22 @@ VkResult Device::CreateStorageBufferDescriptorPool(uint32_t descriptorCount,
 	return driver->vkCreateDescriptorPool(device, &info, 0, out);
 }
 
+VkResult Device::CreateDescriptorPool(const std::vector<VkDescriptorPoolSize> &sizes,
+                                      VkDescriptorPoolCreateFlags flags,
+                                      VkDescriptorPool *out) const
+{
+	VkDescriptorPoolCreateInfo info = {
+		VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,  // sType
+		nullptr,                                        // pNext
+		flags,                                          // flags
+		1,                                              // maxSets
+		(uint32_t)sizes.size(),                         // poolSizeCount
+		sizes.data(),                                   // pPoolSizes
+	};
+
+	return driver->vkCreateDescriptorPool(device, &info, 0, out);
+}
+
 void Device::DestroyDescriptorPool(VkDescriptorPool descriptorPool) const
 {
 	driver->vkDestroyDescriptorPool(device, descriptorPool, nullptr);
@@ -311,6 +389,28 @@ VkResult Device::AllocateDescriptorSet(
 	return driver->vkAllocateDescriptorSets(device, &info, out);
 }
 
+VkResult Device::AllocateDescriptorSet(
+    VkDescriptorPool pool, VkDescriptorSetLayout layout,
+    uint32_t variableDescriptorCount, VkDescriptorSet *out) const
+{
+	VkDescriptorSetVariableDescriptorCountAllocateInfo countInfo = {
+		VK_STRUCTURE_TYPE_DESCRIPTOR_SET_VARIABLE_DESCRIPTOR_COUNT_ALLOCATE_INFO,  // sType
+		nullptr,                                                                   // pNext
+		1,                                                                         // descriptorSetCount
+		&variableDescriptorCount,                                                  // pDescriptorCounts
+	};
+
+	VkDescriptorSetAllocateInfo info = {
+		VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,  // sType
+		&countInfo,                                      // pNext
+		pool,                                            // descriptorPool
+		1,                                               // descriptorSetCount
+		&layout,                                         // pSetLayouts
+	};
+
+	return driver->vkAllocateDescriptorSets(device, &info, out);
+}
+
 void Device::UpdateStorageBufferDescriptorSets(
     VkDescriptorSet descriptorSet,
     const std::vector<VkDescriptorBufferInfo> &bufferInfos) const
@@ -336,6 +436,26 @@ void Device::UpdateStorageBufferDescriptorSets(
 	driver->vkUpdateDescriptorSets(device, (uint32_t)writes.size(), writes.data(), 0, nullptr);
 }
 
+void Device::UpdateUniformTexelBufferDescriptorSet(
+    VkDescriptorSet descriptorSet, uint32_t binding,
+    const std::vector<VkBufferView> &bufferViews) const
+{
+	VkWriteDescriptorSet write = {
+		VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,   // sType
+		nullptr,                                  // pNext
+		descriptorSet,                            // dstSet
+		binding,                                  // dstBinding
+		0,                                        // dstArrayElement
+		(uint32_t)bufferViews.size(),             // descriptorCount
+		VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER,  // descriptorType
+		nullptr,                                  // pImageInfo
+		nullptr,                                  // pBufferInfo
+		bufferViews.data(),                       // pTexelBufferView
+	};
+
+	driver->vkUpdateDescriptorSets(device, 1, &write, 0, nullptr);
+}
+
 VkResult Device::AllocateMemory(size_t size, VkMemoryPropertyFlags flags, VkDeviceMemory *out) const
 {
 	VkPhysicalDeviceMemoryProperties properties;
@@ -454,3 +574,31 @@ VkResult Device::QueueSubmitAndWait(VkCommandBuffer commandBuffer) const
 
 	return driver->vkQueueWaitIdle(queue);
 }
+
+VkResult Device::CreateQueryPool(VkQueryType type, uint32_t count,
+                                 VkQueryPipelineStatisticFlags pipelineStatistics,
+                                 VkQueryPool *out) const
+{
+	const VkQueryPoolCreateInfo info = {
+		VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,  // sType
+		nullptr,                                   // pNext
+		0,                                         // flags
+		type,                                      // queryType
+		count,                                     // queryCount
+		pipelineStatistics,                        // pipelineStatistics
+	};
+
+	return driver->vkCreateQueryPool(device, &info, nullptr, out);
+}
+
+void Device::DestroyQueryPool(VkQueryPool queryPool) const
+{
+	driver->vkDestroyQueryPool(device, queryPool, nullptr);
+}
+
+VkResult Device::GetQueryPoolResults(VkQueryPool queryPool, uint32_t firstQuery, uint32_t queryCount,
+                                     size_t stride, void *out) const
+{
+	return driver->vkGetQueryPoolResults(device, queryPool, firstQuery, queryCount, stride * queryCount, out, stride,
+	                                     VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
+}
@@ -34,8 +34,10 @@ public:
 	// If a compatible physical device is not found, VK_SUCCESS will still be
 	// returned (as there was no Vulkan error), but calling Device::IsValid()
 	// on this device will return false.
+	// enabledFeatures may be null, to enable no features.
 	static VkResult CreateComputeDevice(
-	    Driver const *driver, VkInstance instance, std::unique_ptr<Device> &out);
+	    Driver const *driver, VkInstance instance, std::unique_ptr<Device> &out,
+	    const VkPhysicalDeviceFeatures *enabledFeatures = nullptr);
 
 	// IsValid returns true if the Device is initialized and can be used.
 	bool IsValid() const;
@@ -46,9 +48,23 @@ public:
 	VkResult CreateStorageBuffer(VkDeviceMemory memory, VkDeviceSize size,
 	                             VkDeviceSize offset, VkBuffer *out) const;
 
+	// CreateBuffer creates a new buffer with the given usage, and
+	// VK_SHARING_MODE_EXCLUSIVE sharing mode.
+	VkResult CreateBuffer(VkDeviceMemory memory, VkDeviceSize size,
+	                      VkDeviceSize offset, VkBufferUsageFlags usage,
+	                      VkBuffer *out) const;
+
 	// DestroyBuffer destroys a VkBuffer.
 	void DestroyBuffer(VkBuffer buffer) const;
 
+	// CreateBufferView creates a view of the whole buffer with the given
+	// format.
+	VkResult CreateBufferView(VkBuffer buffer, VkFormat format,
+	                          VkBufferView *out) const;
+
+	// DestroyBufferView destroys a VkBufferView.
+	void DestroyBufferView(VkBufferView bufferView) const;
+
 	// CreateShaderModule creates a new shader module with the given SPIR-V
 	// code.
 	VkResult CreateShaderModule(const std::vector<uint32_t> &spirv,
@@ -63,6 +79,15 @@ public:
 	    const std::vector<VkDescriptorSetLayoutBinding> &bindings,
 	    VkDescriptorSetLayout *out) const;
 
+	// CreateDescriptorSetLayout creates a new descriptor set layout with the
+	// given bindings and per-binding flags. The layout is created for
+	// update-after-bind pools if any binding has the
+	// VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT flag.
+	VkResult CreateDescriptorSetLayout(
+	    const std::vector<VkDescriptorSetLayoutBinding> &bindings,
+	    const std::vector<VkDescriptorBindingFlags> &bindingFlags,
+	    VkDescriptorSetLayout *out) const;
+
 	// DestroyDescriptorSetLayout destroys a VkDescriptorSetLayout.
 	void DestroyDescriptorSetLayout(VkDescriptorSetLayout descriptorSetLayout) const;
 
@@ -87,6 +112,12 @@ public:
 	VkResult CreateStorageBufferDescriptorPool(uint32_t descriptorCount,
 	                                           VkDescriptorPool *out) const;
 
+	// CreateDescriptorPool creates a new descriptor pool for a single set
+	// with the given pool sizes and flags.
+	VkResult CreateDescriptorPool(const std::vector<VkDescriptorPoolSize> &sizes,
+	                              VkDescriptorPoolCreateFlags flags,
+	                              VkDescriptorPool *out) const;
+
 	// DestroyDescriptorPool destroys the VkDescriptorPool.
 	void DestroyDescriptorPool(VkDescriptorPool descriptorPool) const;
 
@@ -96,11 +127,24 @@ public:
 	                               VkDescriptorSetLayout layout,
 	                               VkDescriptorSet *out) const;
 
+	// AllocateDescriptorSet allocates a single descriptor set with the given
+	// layout from pool, with variableDescriptorCount descriptors in its
+	// variable-sized binding.
+	VkResult AllocateDescriptorSet(VkDescriptorPool pool,
+	                               VkDescriptorSetLayout layout,
+	                               uint32_t variableDescriptorCount,
+	                               VkDescriptorSet *out) const;
+
 	// UpdateStorageBufferDescriptorSets updates the storage buffers in
 	// descriptorSet with the given list of VkDescriptorBufferInfos.
 	void UpdateStorageBufferDescriptorSets(VkDescriptorSet descriptorSet,
 	                                       const std::vector<VkDescriptorBufferInfo> &bufferInfos) const;
 
+	// UpdateUniformTexelBufferDescriptorSet writes the given buffer views to
+	// consecutive array elements of binding in descriptorSet.
+	void UpdateUniformTexelBufferDescriptorSet(VkDescriptorSet descriptorSet, uint32_t binding,
+	                                           const std::vector<VkBufferView> &bufferViews) const;
+
 	// AllocateMemory allocates size bytes from a memory heap that has all the
 	// given flag bits set.
 	// If memory could not be allocated from any heap then
@@ -136,6 +180,20 @@ public:
 	// complete.
 	VkResult QueueSubmitAndWait(VkCommandBuffer commandBuffer) const;
 
+	// CreateQueryPool creates a new query pool of the given type.
+	// pipelineStatistics is only used by pipeline statistics queries.
+	VkResult CreateQueryPool(VkQueryType type, uint32_t count,
+	                         VkQueryPipelineStatisticFlags pipelineStatistics,
+	                         VkQueryPool *out) const;
+
+	// DestroyQueryPool destroys the VkQueryPool.
+	void DestroyQueryPool(VkQueryPool queryPool) const;
+
+	// GetQueryPoolResults waits for the queries to become available and writes
+	// their 64-bit results to out, which must hold stride bytes per query.
+	VkResult GetQueryPoolResults(VkQueryPool queryPool, uint32_t firstQuery, uint32_t queryCount,
+	                             size_t stride, void *out) const;
+
 	static VkResult GetPhysicalDevices(
 	    Driver const *driver, VkInstance instance,
 	    std::vector<VkPhysicalDevice> &out);
@@ -17,6 +17,246 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace {
+
+struct ColoredVertex
+{
+	float position[3];
+	float color[3];
+};
+
+// Appends the two triangles of a rectangle of a solid color.
+void AddRectangle(std::vector<ColoredVertex> &vertices, float x0, float y0, float x1, float y1, float red, float green, float blue)
+{
+	vertices.push_back({ { x0, y0, 0.5f }, { red, green, blue } });
+	vertices.push_back({ { x1, y0, 0.5f }, { red, green, blue } });
+	vertices.push_back({ { x0, y1, 0.5f }, { red, green, blue } });
+	vertices.push_back({ { x1, y0, 0.5f }, { red, green, blue } });
+	vertices.push_back({ { x1, y1, 0.5f }, { red, green, blue } });
+	vertices.push_back({ { x0, y1, 0.5f }, { red, green, blue } });
+}
+
+void AddColoredVertexBuffer(DrawTester &tester, std::vector<ColoredVertex> &vertices)
+{
+	std::vector<vk::VertexInputAttributeDescription> inputAttributes;
+	inputAttributes.push_back(vk::VertexInputAttributeDescription(0, 0, vk::Format::eR32G32B32Sfloat, offsetof(ColoredVertex, position)));
+	inputAttributes.push_back(vk::VertexInputAttributeDescription(1, 0, vk::Format::eR32G32B32Sfloat, offsetof(ColoredVertex, color)));
+
+	tester.addVertexBuffer(vertices.data(), vertices.size() * sizeof(ColoredVertex), std::move(inputAttributes));
+}
+
+// Sets shaders which draw the vertices in their color.
+void SetColoredVertexShaders(DrawTester &tester)
+{
+	tester.onCreateVertexShader([](DrawTester &tester) {
+		const char *vertexShader = R"(#version 310 es
+			layout(location = 0) in vec3 inPos;
+			layout(location = 1) in vec3 inColor;
+
+			layout(location = 0) out vec3 outColor;
+
+			void main()
+			{
+				outColor = inColor;
+				gl_Position = vec4(inPos.xyz, 1.0);
+			})";
+
+		return tester.createShaderModule(vertexShader, EShLanguage::EShLangVertex);
+	});
+
+	tester.onCreateFragmentShader([](DrawTester &tester) {
+		const char *fragmentShader = R"(#version 310 es
+			precision highp float;
+
+			layout(location = 0) in vec3 inColor;
+
+			layout(location = 0) out vec4 outColor;
+
+			void main()
+			{
+				outColor = vec4(inColor, 1.0);
+			})";
+
+		return tester.createShaderModule(fragmentShader, EShLanguage::EShLangFragment);
+	});
+}
+
+// Draws a black background, then up to four white vertical strips with a
+// single vkCmdDrawIndirectCount or vkCmdDrawIndexedIndirectCount, whose count
+// buffer holds drawCount. Returns which strips were drawn.
+std::vector<bool> DrawStripsIndirectCount(bool indexed, uint32_t drawCount, uint32_t maxDrawCount)
+{
+	const uint32_t stripCount = 4;
+
+	DrawTester tester;
+	tester.enableFrameReadback();
+
+	// Declared after the tester, so that they are destroyed before its device.
+	std::unique_ptr<Buffer> indexBuffer;
+	std::unique_ptr<Buffer> indirectBuffer;
+	std::unique_ptr<Buffer> countBuffer;
+
+	tester.onCreateVertexBuffers([&](DrawTester &tester) {
+		std::vector<ColoredVertex> vertices;
+		AddRectangle(vertices, -1.0f, -1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f);
+
+		for(uint32_t strip = 0; strip < stripCount; strip++)
+		{
+			float x0 = -1.0f + 2.0f * strip / stripCount;
+			float x1 = -1.0f + 2.0f * (strip + 1) / stripCount;
+			AddRectangle(vertices, x0, -1.0f, x1, 1.0f, 1.0f, 1.0f, 1.0f);
+		}
+
+		AddColoredVertexBuffer(tester, vertices);
+
+		vk::Device device = tester.getDevice();
+		const vk::BufferUsageFlags indirectUsage = vk::BufferUsageFlagBits::eIndirectBuffer;
+
+		if(indexed)
+		{
+			std::vector<uint32_t> indices(vertices.size());
+			for(uint32_t i = 0; i < indices.size(); i++)
+			{
+				indices[i] = i;
+			}
+
+			indexBuffer = std::make_unique<Buffer>(device, indices.size() * sizeof(uint32_t), vk::BufferUsageFlagBits::eIndexBuffer);
+			memcpy(indexBuffer->mapMemory(), indices.data(), indices.size() * sizeof(uint32_t));
+			indexBuffer->unmapMemory();
+
+			std::vector<vk::DrawIndexedIndirectCommand> draws;
+			for(uint32_t strip = 0; strip < stripCount; strip++)
+			{
+				draws.push_back(vk::DrawIndexedIndirectCommand(6, 1, 6 * (strip + 1), 0, 0));
+			}
+
+			indirectBuffer = std::make_unique<Buffer>(device, draws.size() * sizeof(draws[0]), indirectUsage);
+			memcpy(indirectBuffer->mapMemory(), draws.data(), draws.size() * sizeof(draws[0]));
+			indirectBuffer->unmapMemory();
+		}
+		else
+		{
+			std::vector<vk::DrawIndirectCommand> draws;
+			for(uint32_t strip = 0; strip < stripCount; strip++)
+			{
+				draws.push_back(vk::DrawIndirectCommand(6, 1, 6 * (strip + 1), 0));
+			}
+
+			indirectBuffer = std::make_unique<Buffer>(device, draws.size() * sizeof(draws[0]), indirectUsage);
+			memcpy(indirectBuffer->mapMemory(), draws.data(), draws.size() * sizeof(draws[0]));
+			indirectBuffer->unmapMemory();
+		}
+
+		countBuffer = std::make_unique<Buffer>(device, sizeof(uint32_t), indirectUsage);
+		memcpy(countBuffer->mapMemory(), &drawCount, sizeof(uint32_t));
+		countBuffer->unmapMemory();
+	});
+
+	SetColoredVertexShaders(tester);
+
+	tester.onRecordDraws([&](DrawTester &tester, vk::CommandBuffer &commandBuffer) {
+		if(indexed)
+		{
+			commandBuffer.bindIndexBuffer(indexBuffer->getBuffer(), 0, vk::IndexType::eUint32);
+			commandBuffer.drawIndexed(6, 1, 0, 0, 0);
+			commandBuffer.drawIndexedIndirectCount(indirectBuffer->getBuffer(), 0, countBuffer->getBuffer(), 0, maxDrawCount, sizeof(vk::DrawIndexedIndirectCommand));
+		}
+		else
+		{
+			commandBuffer.draw(6, 1, 0, 0);
+			commandBuffer.drawIndirectCount(indirectBuffer->getBuffer(), 0, countBuffer->getBuffer(), 0, maxDrawCount, sizeof(vk::DrawIndirectCommand));
+		}
+	});
+
+	tester.initialize();
+	tester.renderFrame();
+
+	std::vector<uint32_t> pixels = tester.readFrame();
+	const uint32_t width = 1280;
+	const uint32_t height = 720;
+	EXPECT_EQ(pixels.size(), width * height);
+
+	std::vector<bool> drawn;
+	for(uint32_t strip = 0; strip < stripCount; strip++)
+	{
+		uint32_t x = (2 * strip + 1) * width / (2 * stripCount);
+		uint32_t pixel = pixels[(height / 2) * width + x];
+		EXPECT_TRUE(pixel == 0xFFFFFFFF || pixel == 0xFF000000) << std::hex << pixel;
+		drawn.push_back(pixel == 0xFFFFFFFF);
+	}
+
+	return drawn;
+}
+
+// Tiled render pass execution is selected by an environment variable, which is
+// read when the device is created.
+void SetTiledRendering(bool enable)
+{
+#if defined(_WIN32)
+	_putenv_s("SWIFTSHADER_TILED_RENDERING", enable ? "1" : "0");
+#else
+	setenv("SWIFTSHADER_TILED_RENDERING", enable ? "1" : "0", 1);
+#endif
+}
+
+// Renders overlapping triangles spread over the whole framebuffer, with a
+// draw per triangle, and returns the resulting pixels.
+std::vector<uint32_t> RenderOverlappingTriangles(Multisample multisample, bool tiled)
+{
+	const uint32_t triangleCount = 64;
+
+	SetTiledRendering(tiled);
+
+	DrawTester tester(multisample);
+	tester.enableFrameReadback();
+
+	tester.onCreateVertexBuffers([](DrawTester &tester) {
+		std::vector<ColoredVertex> vertices;
+		AddRectangle(vertices, -1.0f, -1.0f, 1.0f, 1.0f, 0.25f, 0.25f, 0.25f);
+
+		// A fixed linear congruential sequence, so that both renderings get the same scene.
+		uint32_t seed = 1;
+		auto random = [&seed]() {
+			seed = seed * 1664525u + 1013904223u;
+			return static_cast<float>(seed >> 8) / static_cast<float>(1 << 24);
+		};
+
+		for(uint32_t triangle = 0; triangle < triangleCount; triangle++)
+		{
+			float color[3] = { random(), random(), random() };
+			for(int vertex = 0; vertex < 3; vertex++)
+			{
+				vertices.push_back({ { random() * 2.4f - 1.2f, random() * 2.4f - 1.2f, 0.5f }, { color[0], color[1], color[2] } });
+			}
+		}
+
+		AddColoredVertexBuffer(tester, vertices);
+	});
+
+	SetColoredVertexShaders(tester);
+
+	tester.onRecordDraws([](DrawTester &tester, vk::CommandBuffer &commandBuffer) {
+		commandBuffer.draw(6, 1, 0, 0);
+
+		for(uint32_t triangle = 0; triangle < triangleCount; triangle++)
+		{
+			commandBuffer.draw(3, 1, 6 + 3 * triangle, 0);
+		}
+	});
+
+	tester.initialize();
+	tester.renderFrame();
+
+	return tester.readFrame();
+}
+
+}  // anonymous namespace
+
 class DrawTest : public testing::Test
 {
 };
@@ -74,3 +314,94 @@ TEST_F(DrawTest, VertexShaderNoPositionOutput)
 	tester.initialize();
 	tester.renderFrame();
 }
+
+// Test that the draw count is read from the count buffer, and clamped to maxDrawCount.
+TEST_F(DrawTest, DrawIndirectCount)
+{
+	EXPECT_EQ(DrawStripsIndirectCount(false, 2, 3), std::vector<bool>({ true, true, false, false }));
+	EXPECT_EQ(DrawStripsIndirectCount(false, 4, 3), std::vector<bool>({ true, true, true, false }));
+}
+
+TEST_F(DrawTest, DrawIndexedIndirectCount)
+{
+	EXPECT_EQ(DrawStripsIndirectCount(true, 2, 3), std::vector<bool>({ true, true, false, false }));
+	EXPECT_EQ(DrawStripsIndirectCount(true, 4, 3), std::vector<bool>({ true, true, true, false }));
+}
+
+// Test that tiled render pass execution produces the same image as immediate rasterization.
+TEST_F(DrawTest, TiledRenderingMatchesImmediate)
+{
+	for(Multisample multisample : { Multisample::False, Multisample::True })
+	{
+		std::vector<uint32_t> immediate = RenderOverlappingTriangles(multisample, false);
+		std::vector<uint32_t> tiled = RenderOverlappingTriangles(multisample, true);
+
+		ASSERT_EQ(immediate.size(), tiled.size());
+		EXPECT_TRUE(immediate == tiled) << "multisample: " << (multisample == Multisample::True);
+	}
+
+	SetTiledRendering(false);
+}
+
+// Test that a pipeline statistics query counts the primitives, vertex shader
+// invocations and fragment shader invocations of the draws it encloses.
+TEST_F(DrawTest, PipelineStatistics)
+{
+	DrawTester tester;
+
+	vk::PhysicalDeviceFeatures features;
+	features.pipelineStatisticsQuery = VK_TRUE;
+	tester.enableFeatures(features);
+
+	vk::QueryPool queryPool;  // Owning handle
+
+	tester.onCreateVertexBuffers([&](DrawTester &tester) {
+		// Covers the left half of the framebuffer.
+		std::vector<ColoredVertex> vertices;
+		AddRectangle(vertices, -1.0f, -1.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f);
+		AddColoredVertexBuffer(tester, vertices);
+
+		vk::QueryPoolCreateInfo queryPoolCreateInfo;
+		queryPoolCreateInfo.queryType = vk::QueryType::ePipelineStatistics;
+		queryPoolCreateInfo.queryCount = 1;
+		queryPoolCreateInfo.pipelineStatistics = vk::QueryPipelineStatisticFlagBits::eInputAssemblyPrimitives |
+		                                         vk::QueryPipelineStatisticFlagBits::eVertexShaderInvocations |
+		                                         vk::QueryPipelineStatisticFlagBits::eFragmentShaderInvocations;
+		queryPool = tester.getDevice().createQueryPool(queryPoolCreateInfo);
+	});
+
+	SetColoredVertexShaders(tester);
+
+	tester.onRecordDraws([&](DrawTester &tester, vk::CommandBuffer &commandBuffer) {
+		commandBuffer.beginQuery(queryPool, 0, vk::QueryControlFlags());
+		commandBuffer.draw(6, 1, 0, 0);
+		commandBuffer.endQuery(queryPool, 0);
+	});
+
+	tester.initialize();
+
+	// Queries must be reset outside of the render pass before they are used.
+	vk::Device device = tester.getDevice();
+	vk::CommandPoolCreateInfo commandPoolCreateInfo;
+	commandPoolCreateInfo.queueFamilyIndex = tester.getQueueFamilyIndex();
+	vk::CommandPool commandPool = device.createCommandPool(commandPoolCreateInfo);
+	vk::CommandBuffer commandBuffer = Util::beginSingleTimeCommands(device, commandPool);
+	commandBuffer.resetQueryPool(queryPool, 0, 1);
+	Util::endSingleTimeCommands(device, commandPool, tester.getQueue(), commandBuffer);
+	device.destroyCommandPool(commandPool);
+
+	tester.renderFrame();
+
+	// Statistics are written in bit order.
+	uint64_t statistics[3] = {};
+	vk::Result result = device.getQueryPoolResults(queryPool, 0, 1, sizeof(statistics), statistics, sizeof(statistics),
+	                                               vk::QueryResultFlagBits::e64 | vk::QueryResultFlagBits::eWait);
+	EXPECT_EQ(result, vk::Result::eSuccess);
+
+	EXPECT_EQ(statistics[0], 2u);           // Input assembly primitives
+	EXPECT_EQ(statistics[1], 6u);           // Vertex shader invocations
+	EXPECT_EQ(statistics[2], 640u * 720u);  // Fragment shader invocations
+
+	tester.getQueue().waitIdle();
+	device.destroyQueryPool(queryPool);
+}
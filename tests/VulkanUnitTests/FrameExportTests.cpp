@@ -0,0 +1,296 @@
+// Copyright 2021 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "VulkanHeaders.hpp"
+
+// The frames are exported by the headless surface.
+#if defined(__linux__) && !defined(__ANDROID__) && USE_HEADLESS_SURFACE
+
+#	include "DrawTester.hpp"
+#	include "WSI/FrameExportProtocol.hpp"
+
+#	include "gmock/gmock.h"
+#	include "gtest/gtest.h"
+
+#	include <stdlib.h>
+#	include <string.h>
+#	include <sys/mman.h>
+#	include <sys/socket.h>
+#	include <sys/un.h>
+#	include <unistd.h>
+
+#	include <chrono>
+#	include <map>
+#	include <string>
+#	include <thread>
+#	include <vector>
+
+namespace {
+
+// FrameConsumer plays the role of an encoder process: it accepts the
+// connection from the headless surface, maps the exported buffers, samples the
+// center pixel of every presented frame and releases it, after firstReleaseDelay
+// for the first frame.
+class FrameConsumer
+{
+public:
+	explicit FrameConsumer(std::chrono::milliseconds firstReleaseDelay = std::chrono::milliseconds(0))
+	    : firstReleaseDelay(firstReleaseDelay)
+	    , path("/tmp/swiftshader-frame-export-" + std::to_string(getpid()) + ".sock")
+	{
+		unlink(path.c_str());
+
+		sockaddr_un address = {};
+		address.sun_family = AF_UNIX;
+		strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+		listener = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+		EXPECT_EQ(bind(listener, reinterpret_cast<const sockaddr *>(&address), sizeof(address)), 0);
+		EXPECT_EQ(listen(listener, 1), 0);
+
+		thread = std::thread([this] { run(); });
+	}
+
+	~FrameConsumer()
+	{
+		if(thread.joinable())
+		{
+			shutdown(listener, SHUT_RDWR);  // Unblocks accept()
+			thread.join();
+		}
+
+		close(listener);
+		unlink(path.c_str());
+	}
+
+	// Returns once the producer has closed its connection.
+	void waitForDisconnect()
+	{
+		thread.join();
+	}
+
+	const std::chrono::milliseconds firstReleaseDelay;
+	const std::string path;
+
+	// Only valid after waitForDisconnect().
+	int attachCount = 0;
+	int detachCount = 0;
+	std::vector<uint32_t> centerPixels;
+
+private:
+	struct Buffer
+	{
+		sw::FrameExportMessage attach;
+		void *pixels;
+	};
+
+	void run()
+	{
+		int connection = accept(listener, nullptr, nullptr);
+		if(connection < 0)
+		{
+			return;
+		}
+
+		std::map<uint32_t, Buffer> buffers;
+
+		while(true)
+		{
+			sw::FrameExportMessage message = {};
+			int fd = -1;
+			if(!receive(connection, message, fd))
+			{
+				break;
+			}
+
+			switch(message.type)
+			{
+			case sw::FRAME_EXPORT_ATTACH:
+				attachCount++;
+				buffers[message.bufferIndex] = { message, mmap(nullptr, message.size, PROT_READ, MAP_SHARED, fd, 0) };
+				EXPECT_NE(buffers[message.bufferIndex].pixels, MAP_FAILED);
+				close(fd);
+				break;
+			case sw::FRAME_EXPORT_DETACH:
+				detachCount++;
+				munmap(buffers[message.bufferIndex].pixels, buffers[message.bufferIndex].attach.size);
+				buffers.erase(message.bufferIndex);
+				break;
+			case sw::FRAME_EXPORT_PRESENT:
+				{
+					const Buffer &buffer = buffers.at(message.bufferIndex);
+					const sw::FrameExportMessage &attach = buffer.attach;
+					auto row = reinterpret_cast<const uint8_t *>(buffer.pixels) + (attach.height / 2) * attach.rowPitch;
+					centerPixels.push_back(reinterpret_cast<const uint32_t *>(row)[attach.width / 2]);
+
+					if(message.frameNumber == 0)
+					{
+						std::this_thread::sleep_for(firstReleaseDelay);
+					}
+
+					uint64_t release = 1;
+					EXPECT_EQ(write(fd, &release, sizeof(release)), ssize_t(sizeof(release)));
+					close(fd);
+				}
+				break;
+			default:
+				ADD_FAILURE() << "Unexpected message type " << message.type;
+				break;
+			}
+		}
+
+		close(connection);
+	}
+
+	static bool receive(int connection, sw::FrameExportMessage &message, int &fd)
+	{
+		iovec iov = { &message, sizeof(message) };
+
+		union
+		{
+			cmsghdr header;
+			char buffer[CMSG_SPACE(sizeof(int))];
+		} control = {};
+
+		msghdr msg = {};
+		msg.msg_iov = &iov;
+		msg.msg_iovlen = 1;
+		msg.msg_control = control.buffer;
+		msg.msg_controllen = sizeof(control.buffer);
+
+		if(recvmsg(connection, &msg, 0) != ssize_t(sizeof(message)))
+		{
+			return false;
+		}
+
+		if(cmsghdr *cmsg = CMSG_FIRSTHDR(&msg))
+		{
+			memcpy(&fd, CMSG_DATA(cmsg), sizeof(int));
+		}
+
+		return true;
+	}
+
+	int listener = -1;
+	std::thread thread;
+};
+
+}  // anonymous namespace
+
+class FrameExportTest : public testing::Test
+{
+protected:
+	// Renders and presents frames of a white triangle to a headless surface.
+	static void renderFrames(int frameCount)
+	{
+		DrawTester tester;
+		tester.onCreateVertexBuffers([](DrawTester &tester) {
+			struct Vertex
+			{
+				float position[3];
+			};
+
+			Vertex vertexBufferData[] = {
+				{ { 1.0f, 1.0f, 0.5f } },
+				{ { -1.0f, 1.0f, 0.5f } },
+				{ { 0.0f, -1.0f, 0.5f } }
+			};
+
+			std::vector<vk::VertexInputAttributeDescription> inputAttributes;
+			inputAttributes.push_back(vk::VertexInputAttributeDescription(0, 0, vk::Format::eR32G32B32Sfloat, offsetof(Vertex, position)));
+
+			tester.addVertexBuffer(vertexBufferData, sizeof(vertexBufferData), std::move(inputAttributes));
+		});
+
+		tester.onCreateVertexShader([](DrawTester &tester) {
+			const char *vertexShader = R"(#version 310 es
+				layout(location = 0) in vec3 inPos;
+
+				void main()
+				{
+					gl_Position = vec4(inPos.xyz, 1.0);
+				})";
+
+			return tester.createShaderModule(vertexShader, EShLanguage::EShLangVertex);
+		});
+
+		tester.onCreateFragmentShader([](DrawTester &tester) {
+			const char *fragmentShader = R"(#version 310 es
+				precision highp float;
+
+				layout(location = 0) out vec4 outColor;
+
+				void main()
+				{
+					outColor = vec4(1.0, 1.0, 1.0, 1.0);
+				})";
+
+			return tester.createShaderModule(fragmentShader, EShLanguage::EShLangFragment);
+		});
+
+		tester.initialize();
+
+		for(int i = 0; i < frameCount; i++)
+		{
+			tester.renderFrame();
+		}
+
+		tester.getQueue().waitIdle();
+	}
+};
+
+// Test that frames presented to a headless surface are published, without
+// copies, to the process listening on SWIFTSHADER_FRAME_EXPORT_SOCKET.
+TEST_F(FrameExportTest, PresentedFramesReachConsumer)
+{
+	FrameConsumer consumer;
+	setenv(sw::FrameExportSocketEnvironmentVariable, consumer.path.c_str(), 1);
+
+	renderFrames(4);
+
+	unsetenv(sw::FrameExportSocketEnvironmentVariable);
+	consumer.waitForDisconnect();
+
+	EXPECT_EQ(consumer.attachCount, 2);  // DrawTester creates a double-buffered swapchain
+	EXPECT_EQ(consumer.detachCount, 2);
+	ASSERT_EQ(consumer.centerPixels.size(), 4u);
+	for(uint32_t pixel : consumer.centerPixels)
+	{
+		EXPECT_EQ(pixel, 0xFFFFFFFFu);
+	}
+}
+
+// Test that a consumer which is slow to release a frame only delays acquiring
+// that image, rather than blocking presents or disconnecting the consumer.
+TEST_F(FrameExportTest, SlowReleaseDelaysAcquire)
+{
+	// The second acquire of the first image has to wait for its release.
+	FrameConsumer consumer(std::chrono::milliseconds(1500));
+	setenv(sw::FrameExportSocketEnvironmentVariable, consumer.path.c_str(), 1);
+
+	renderFrames(4);
+
+	unsetenv(sw::FrameExportSocketEnvironmentVariable);
+	consumer.waitForDisconnect();
+
+	EXPECT_EQ(consumer.attachCount, 2);
+	EXPECT_EQ(consumer.detachCount, 2);
+	ASSERT_EQ(consumer.centerPixels.size(), 4u);
+	for(uint32_t pixel : consumer.centerPixels)
+	{
+		EXPECT_EQ(pixel, 0xFFFFFFFFu);
+	}
+}
+
+#endif  // defined(__linux__) && !defined(__ANDROID__) && USE_HEADLESS_SURFACE
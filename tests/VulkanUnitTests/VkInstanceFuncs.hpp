@@ -25,9 +25,15 @@ VK_INSTANCE(vkBeginCommandBuffer, VkResult, VkCommandBuffer, const VkCommandBuff
 VK_INSTANCE(vkBindBufferMemory, VkResult, VkDevice, VkBuffer, VkDeviceMemory, VkDeviceSize);
 VK_INSTANCE(vkCmdBindDescriptorSets, void, VkCommandBuffer, VkPipelineBindPoint, VkPipelineLayout, uint32_t, uint32_t,
             const VkDescriptorSet *, uint32_t, const uint32_t *);
+VK_INSTANCE(vkCmdBeginQuery, void, VkCommandBuffer, VkQueryPool, uint32_t, VkQueryControlFlags);
 VK_INSTANCE(vkCmdBindPipeline, void, VkCommandBuffer, VkPipelineBindPoint, VkPipeline);
 VK_INSTANCE(vkCmdDispatch, void, VkCommandBuffer, uint32_t, uint32_t, uint32_t);
+VK_INSTANCE(vkCmdEndQuery, void, VkCommandBuffer, VkQueryPool, uint32_t);
+VK_INSTANCE(vkCmdResetQueryPool, void, VkCommandBuffer, VkQueryPool, uint32_t, uint32_t);
+VK_INSTANCE(vkCmdWriteTimestamp, void, VkCommandBuffer, VkPipelineStageFlagBits, VkQueryPool, uint32_t);
 VK_INSTANCE(vkCreateBuffer, VkResult, VkDevice, const VkBufferCreateInfo *, const VkAllocationCallbacks *, VkBuffer *);
+VK_INSTANCE(vkCreateBufferView, VkResult, VkDevice, const VkBufferViewCreateInfo *, const VkAllocationCallbacks *,
+            VkBufferView *);
 VK_INSTANCE(vkCreateCommandPool, VkResult, VkDevice, const VkCommandPoolCreateInfo *, const VkAllocationCallbacks *,
             VkCommandPool *);
 VK_INSTANCE(vkCreateComputePipelines, VkResult, VkDevice, VkPipelineCache, uint32_t, const VkComputePipelineCreateInfo *,
@@ -40,9 +46,12 @@ VK_INSTANCE(vkCreateDevice, VkResult, VkPhysicalDevice, const VkDeviceCreateInfo
             VkDevice *);
 VK_INSTANCE(vkCreatePipelineLayout, VkResult, VkDevice, const VkPipelineLayoutCreateInfo *, const VkAllocationCallbacks *,
             VkPipelineLayout *);
+VK_INSTANCE(vkCreateQueryPool, VkResult, VkDevice, const VkQueryPoolCreateInfo *, const VkAllocationCallbacks *,
+            VkQueryPool *);
 VK_INSTANCE(vkCreateShaderModule, VkResult, VkDevice, const VkShaderModuleCreateInfo *, const VkAllocationCallbacks *,
             VkShaderModule *);
 VK_INSTANCE(vkDestroyBuffer, void, VkDevice, VkBuffer, const VkAllocationCallbacks *);
+VK_INSTANCE(vkDestroyBufferView, void, VkDevice, VkBufferView, const VkAllocationCallbacks *);
 VK_INSTANCE(vkDestroyCommandPool, void, VkDevice, VkCommandPool, const VkAllocationCallbacks *);
 VK_INSTANCE(vkDestroyDescriptorPool, void, VkDevice, VkDescriptorPool, const VkAllocationCallbacks *);
 VK_INSTANCE(vkDestroyDescriptorSetLayout, void, VkDevice, VkDescriptorSetLayout, const VkAllocationCallbacks *);
@@ -50,6 +59,7 @@ VK_INSTANCE(vkDestroyDevice, VkResult, VkDevice, const VkAllocationCallbacks *);
 VK_INSTANCE(vkDestroyInstance, void, VkInstance, const VkAllocationCallbacks *);
 VK_INSTANCE(vkDestroyPipeline, void, VkDevice, VkPipeline, const VkAllocationCallbacks *);
 VK_INSTANCE(vkDestroyPipelineLayout, void, VkDevice, VkPipelineLayout, const VkAllocationCallbacks *);
+VK_INSTANCE(vkDestroyQueryPool, void, VkDevice, VkQueryPool, const VkAllocationCallbacks *);
 VK_INSTANCE(vkDestroyShaderModule, void, VkDevice, VkShaderModule, const VkAllocationCallbacks *);
 VK_INSTANCE(vkEndCommandBuffer, VkResult, VkCommandBuffer);
 VK_INSTANCE(vkEnumeratePhysicalDevices, VkResult, VkInstance, uint32_t *, VkPhysicalDevice *);
@@ -60,6 +70,8 @@ VK_INSTANCE(vkGetPhysicalDeviceMemoryProperties, void, VkPhysicalDevice, VkPhysi
 VK_INSTANCE(vkGetPhysicalDeviceProperties, void, VkPhysicalDevice, VkPhysicalDeviceProperties *);
 VK_INSTANCE(vkGetPhysicalDeviceProperties2, void, VkPhysicalDevice, VkPhysicalDeviceProperties2 *);
 VK_INSTANCE(vkGetPhysicalDeviceQueueFamilyProperties, void, VkPhysicalDevice, uint32_t *, VkQueueFamilyProperties *);
+VK_INSTANCE(vkGetQueryPoolResults, VkResult, VkDevice, VkQueryPool, uint32_t, uint32_t, size_t, void *, VkDeviceSize,
+            VkQueryResultFlags);
 VK_INSTANCE(vkMapMemory, VkResult, VkDevice, VkDeviceMemory, VkDeviceSize, VkDeviceSize, VkMemoryMapFlags, void **);
 VK_INSTANCE(vkQueueSubmit, VkResult, VkQueue, uint32_t, const VkSubmitInfo *, VkFence);
 VK_INSTANCE(vkQueueWaitIdle, VkResult, VkQueue);
@@ -24,6 +24,7 @@ DrawTester::DrawTester(Multisample multisample)
 DrawTester::~DrawTester()
 {
 	device.freeCommandBuffers(commandPool, commandBuffers);
+	frameReadback.reset();
 
 	device.destroyDescriptorPool(descriptorPool);
 	for(auto &sampler : samplers)
@@ -106,6 +107,20 @@ void DrawTester::show()
 	window->show();
 }
 
+std::vector<uint32_t> DrawTester::readFrame()
+{
+	assert(frameReadback);  // enableFrameReadback() must be called before initialize()
+
+	device.waitForFences(1, &waitFences[currentFrameBuffer], VK_TRUE, UINT64_MAX);
+
+	vk::Extent2D extent = swapchain->getExtent();
+	std::vector<uint32_t> pixels(extent.width * extent.height);
+	memcpy(pixels.data(), frameReadback->mapMemory(), pixels.size() * sizeof(uint32_t));
+	frameReadback->unmapMemory();
+
+	return pixels;
+}
+
 vk::RenderPass DrawTester::createRenderPass(vk::Format colorFormat)
 {
 	std::vector<vk::AttachmentDescription> attachments(multisample ? 2 : 1);
@@ -361,6 +376,12 @@ void DrawTester::createCommandBuffers(vk::RenderPass renderPass)
 
 	commandBuffers = device.allocateCommandBuffers(commandBufferAllocateInfo);
 
+	if(frameReadbackEnabled)
+	{
+		vk::Extent2D extent = swapchain->getExtent();
+		frameReadback = std::make_unique<Buffer>(device, extent.width * extent.height * sizeof(uint32_t), vk::BufferUsageFlagBits::eTransferDst);
+	}
+
 	for(size_t i = 0; i < commandBuffers.size(); i++)
 	{
 		vk::CommandBufferBeginInfo commandBufferBeginInfo;
@@ -397,14 +418,53 @@ void DrawTester::createCommandBuffers(vk::RenderPass renderPass)
 			commandBuffers[i].bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline);
 			VULKAN_HPP_NAMESPACE::DeviceSize offset = 0;
 			commandBuffers[i].bindVertexBuffers(0, 1, &vertices.buffer, &offset);
-			commandBuffers[i].draw(vertices.numVertices, 1, 0, 0);
+			hooks.recordDraws(*this, commandBuffers[i]);
 		}
 
 		commandBuffers[i].endRenderPass();
+
+		if(frameReadback)
+		{
+			recordFrameReadback(commandBuffers[i], swapchain->getImage(i));
+		}
+
 		commandBuffers[i].end();
 	}
 }
 
+void DrawTester::recordFrameReadback(vk::CommandBuffer &commandBuffer, vk::Image image)
+{
+	vk::ImageMemoryBarrier barrier;
+	barrier.srcAccessMask = vk::AccessFlagBits::eColorAttachmentWrite;
+	barrier.dstAccessMask = vk::AccessFlagBits::eTransferRead;
+	barrier.oldLayout = vk::ImageLayout::ePresentSrcKHR;
+	barrier.newLayout = vk::ImageLayout::eTransferSrcOptimal;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.image = image;
+	barrier.subresourceRange = vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1);
+
+	commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eColorAttachmentOutput, vk::PipelineStageFlagBits::eTransfer, vk::DependencyFlags{}, 0, nullptr, 0, nullptr, 1, &barrier);
+
+	vk::Extent2D extent = swapchain->getExtent();
+	vk::BufferImageCopy region;
+	region.imageSubresource = vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, 0, 0, 1);
+	region.imageExtent = vk::Extent3D(extent.width, extent.height, 1);
+
+	commandBuffer.copyImageToBuffer(image, vk::ImageLayout::eTransferSrcOptimal, frameReadback->getBuffer(), 1, &region);
+
+	// Return the image to the layout it is presented in, and make the copy
+	// visible to the host.
+	barrier.srcAccessMask = vk::AccessFlagBits::eTransferRead;
+	barrier.dstAccessMask = {};
+	barrier.oldLayout = vk::ImageLayout::eTransferSrcOptimal;
+	barrier.newLayout = vk::ImageLayout::ePresentSrcKHR;
+
+	vk::MemoryBarrier hostBarrier(vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eHostRead);
+
+	commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eHost | vk::PipelineStageFlagBits::eBottomOfPipe, vk::DependencyFlags{}, 1, &hostBarrier, 0, nullptr, 1, &barrier);
+}
+
 void DrawTester::addVertexBuffer(void *vertexBufferData, size_t vertexBufferDataSize, size_t vertexSize, std::vector<vk::VertexInputAttributeDescription> inputAttributes)
 {
 	assert(!vertices.buffer);  // For now, only support adding once
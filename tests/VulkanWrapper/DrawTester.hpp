@@ -15,6 +15,7 @@
 #ifndef DRAW_TESTER_HPP_
 #define DRAW_TESTER_HPP_
 
+#include "Buffer.hpp"
 #include "Framebuffer.hpp"
 #include "Image.hpp"
 #include "Swapchain.hpp"
@@ -40,6 +41,14 @@ public:
 	void renderFrame();
 	void show();
 
+	// Call before initialize() to have the color attachment of every frame
+	// copied to host memory once rendered, for readFrame().
+	void enableFrameReadback();
+
+	// Waits for the last rendered frame and returns its pixels, row by row, in
+	// the swapchain's color format.
+	std::vector<uint32_t> readFrame();
+
 	/////////////////////////
 	// Hooks
 	/////////////////////////
@@ -66,6 +75,10 @@ public:
 	// call tester.device().updateDescriptorSets.
 	void onUpdateDescriptorSet(std::function<void(ThisType &tester, vk::CommandPool &commandPool, vk::DescriptorSet &descriptorSet)> callback);
 
+	// Called from createCommandBuffers, once the pipeline and vertex buffer are bound.
+	// Callback should record the draw commands. By default all vertices are drawn once.
+	void onRecordDraws(std::function<void(ThisType &tester, vk::CommandBuffer &commandBuffer)> callback);
+
 	/////////////////////////
 	// Resource Management
 	/////////////////////////
@@ -119,6 +132,7 @@ private:
 	vk::RenderPass createRenderPass(vk::Format colorFormat);
 	vk::Pipeline createGraphicsPipeline(vk::RenderPass renderPass);
 	void addVertexBuffer(void *vertexBufferData, size_t vertexBufferDataSize, size_t vertexSize, std::vector<vk::VertexInputAttributeDescription> inputAttributes);
+	void recordFrameReadback(vk::CommandBuffer &commandBuffer, vk::Image image);
 
 	struct Hook
 	{
@@ -127,6 +141,9 @@ private:
 		std::function<vk::ShaderModule(ThisType &tester)> createVertexShader = [](auto &) { return vk::ShaderModule{}; };
 		std::function<vk::ShaderModule(ThisType &tester)> createFragmentShader = [](auto &) { return vk::ShaderModule{}; };
 		std::function<void(ThisType &tester, vk::CommandPool &commandPool, vk::DescriptorSet &descriptorSet)> updateDescriptorSet = [](auto &, auto &, auto &) {};
+		std::function<void(ThisType &tester, vk::CommandBuffer &commandBuffer)> recordDraws = [](auto &tester, auto &commandBuffer) {
+			commandBuffer.draw(tester.vertices.numVertices, 1, 0, 0);
+		};
 	} hooks;
 
 	const vk::Extent2D windowSize = { 1280, 720 };
@@ -167,8 +184,16 @@ private:
 	std::vector<vk::Sampler> samplers;  // Owning handles
 
 	std::vector<vk::CommandBuffer> commandBuffers;  // Owning handles
+
+	bool frameReadbackEnabled = false;
+	std::unique_ptr<Buffer> frameReadback;
 };
 
+inline void DrawTester::enableFrameReadback()
+{
+	frameReadbackEnabled = true;
+}
+
 inline void DrawTester::onCreateVertexBuffers(std::function<void(ThisType &tester)> callback)
 {
 	hooks.createVertexBuffers = std::move(callback);
@@ -194,4 +219,9 @@ inline void DrawTester::onUpdateDescriptorSet(std::function<void(ThisType &teste
 	hooks.updateDescriptorSet = std::move(callback);
 }
 
+inline void DrawTester::onRecordDraws(std::function<void(ThisType &tester, vk::CommandBuffer &commandBuffer)> callback)
+{
+	hooks.recordDraws = std::move(callback);
+}
+
 #endif  // DRAW_TESTER_HPP_
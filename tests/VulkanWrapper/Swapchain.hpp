@@ -34,6 +34,11 @@ public:
 		return images.size();
 	}
 
+	vk::Image getImage(size_t i) const
+	{
+		return images[i];
+	}
+
 	vk::ImageView getImageView(size_t i) const
 	{
 		return imageViews[i];
@@ -19,7 +19,11 @@
 #	define USE_HEADLESS_SURFACE 0
 #endif
 
-#if !defined(_WIN32)
+#if !defined(USE_XCB_SURFACE)
+#	define USE_XCB_SURFACE 0
+#endif
+
+#if !defined(_WIN32) && !USE_XCB_SURFACE
 // @TODO: implement native Window support for current platform. For now, always use HeadlessSurface.
 #	undef USE_HEADLESS_SURFACE
 #	define USE_HEADLESS_SURFACE 1
@@ -27,6 +31,8 @@
 
 #if defined(_WIN32)
 #	define VK_USE_PLATFORM_WIN32_KHR
+#elif USE_XCB_SURFACE
+#	define VK_USE_PLATFORM_XCB_KHR
 #endif
 #define VULKAN_HPP_DISPATCH_LOADER_DYNAMIC 1
 #define VULKAN_HPP_NO_NODISCARD_WARNINGS
@@ -268,6 +268,9 @@ void VulkanTester::initialize()
 #endif
 #if defined(VK_USE_PLATFORM_WIN32_KHR)
 		    VK_KHR_WIN32_SURFACE_EXTENSION_NAME,
+#endif
+#if defined(VK_USE_PLATFORM_XCB_KHR)
+		    VK_KHR_XCB_SURFACE_EXTENSION_NAME,
 #endif
 	};
 #if ENABLE_VALIDATION_LAYERS
@@ -347,6 +350,7 @@ void VulkanTester::initialize()
 	deviceCreateInfo.pQueueCreateInfos = &queueCreateInfo;
 	deviceCreateInfo.ppEnabledExtensionNames = deviceExtensions.data();
 	deviceCreateInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
+	deviceCreateInfo.pEnabledFeatures = &enabledFeatures;
 
 	device = physicalDevice.createDevice(deviceCreateInfo, nullptr);
 
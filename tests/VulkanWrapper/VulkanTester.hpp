@@ -26,6 +26,9 @@ public:
 	// Call once after construction so that virtual functions may be called during init
 	void initialize();
 
+	// Call before initialize() to enable device features.
+	void enableFeatures(const vk::PhysicalDeviceFeatures &features) { enabledFeatures = features; }
+
 	const vk::DynamicLoader &dynamicLoader() const { return *dl; }
 	vk::PhysicalDevice &getPhysicalDevice() { return physicalDevice; }
 	vk::Device &getDevice() { return device; }
@@ -38,6 +41,7 @@ private:
 	std::unique_ptr<class ScopedSetIcdFilenames> setIcdFilenames;
 	std::unique_ptr<vk::DynamicLoader> dl;
 	vk::DebugUtilsMessengerEXT debugReport;
+	vk::PhysicalDeviceFeatures enabledFeatures;
 
 protected:
 	const uint32_t queueFamilyIndex = 0;
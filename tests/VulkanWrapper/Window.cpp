@@ -106,6 +106,52 @@ void Window::show()
 	ShowWindow(window, SW_SHOW);
 }
 
+#elif USE_XCB_SURFACE
+
+Window::Window(vk::Instance instance, vk::Extent2D windowSize)
+    : instance(instance)
+{
+	// Connects to the server named by the DISPLAY environment variable.
+	connection = xcb_connect(nullptr, nullptr);
+	assert(!xcb_connection_has_error(connection));
+
+	const xcb_setup_t *setup = xcb_get_setup(connection);
+	xcb_screen_t *screen = xcb_setup_roots_iterator(setup).data;
+
+	window = xcb_generate_id(connection);
+	uint32_t values[] = { screen->black_pixel };
+	xcb_create_window(connection, XCB_COPY_FROM_PARENT, window, screen->root,
+	                  0, 0, windowSize.width, windowSize.height, 0,
+	                  XCB_WINDOW_CLASS_INPUT_OUTPUT, screen->root_visual,
+	                  XCB_CW_BACK_PIXEL, values);
+	xcb_flush(connection);
+
+	// Create the Vulkan surface
+	vk::XcbSurfaceCreateInfoKHR surfaceCreateInfo;
+	surfaceCreateInfo.connection = connection;
+	surfaceCreateInfo.window = window;
+	surface = instance.createXcbSurfaceKHR(surfaceCreateInfo);
+	assert(surface);
+}
+
+Window::~Window()
+{
+	instance.destroySurfaceKHR(surface, nullptr);
+	xcb_destroy_window(connection, window);
+	xcb_disconnect(connection);
+}
+
+vk::SurfaceKHR Window::getSurface()
+{
+	return surface;
+}
+
+void Window::show()
+{
+	xcb_map_window(connection, window);
+	xcb_flush(connection);
+}
+
 #else
 #	error Window class unimplemented for this platform
 #endif
@@ -54,6 +54,23 @@ private:
 	vk::SurfaceKHR surface;
 };
 
+#elif USE_XCB_SURFACE
+
+class Window
+{
+public:
+	Window(vk::Instance instance, vk::Extent2D windowSize);
+	~Window();
+	vk::SurfaceKHR getSurface();
+	void show();
+
+private:
+	xcb_connection_t *connection;
+	xcb_window_t window;
+	const vk::Instance instance;
+	vk::SurfaceKHR surface;
+};
+
 #else
 #	error Window class unimplemented for this platform
 #endif
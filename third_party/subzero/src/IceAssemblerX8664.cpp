@@ -1382,6 +1382,24 @@ void AssemblerX8664::blendvps(Type /* Ty */, XmmRegister dst,
   emitOperand(gprEncoding(dst), src);
 }
 
+void AssemblerX8664::vfmadd231(Type Ty, XmmRegister dst, XmmRegister src1,
+                               XmmRegister src2) {
+  AssemblerBuffer::EnsureCapacity ensured(&Buffer);
+  assert(Ty == IceType_v4f32 || Ty == IceType_f32);
+  emitVex3_66_0F38(0, dst, src1, src2);
+  emitUint8(isVectorType(Ty) ? 0xB8 : 0xB9);
+  emitXmmRegisterOperand(dst, src2);
+}
+
+void AssemblerX8664::vfmadd231(Type Ty, XmmRegister dst, XmmRegister src1,
+                               const AsmAddress &src2) {
+  AssemblerBuffer::EnsureCapacity ensured(&Buffer);
+  assert(Ty == IceType_v4f32 || Ty == IceType_f32);
+  emitVex3_66_0F38(0, dst, src1, RexRegIrrelevant, &src2);
+  emitUint8(isVectorType(Ty) ? 0xB8 : 0xB9);
+  emitOperand(gprEncoding(dst), src2);
+}
+
 void AssemblerX8664::pblendvb(Type /* Ty */, XmmRegister dst, XmmRegister src) {
   AssemblerBuffer::EnsureCapacity ensured(&Buffer);
   emitUint8(0x66);
@@ -609,6 +609,12 @@ public:
   void pblendvb(Type Ty, XmmRegister dst, XmmRegister src);
   void pblendvb(Type Ty, XmmRegister dst, const AsmAddress &src);
 
+  // dst = src1 * src2 + dst. Requires FMA3; uses the VEX.128 encoding so the
+  // upper halves of the YMM registers are zeroed rather than preserved.
+  void vfmadd231(Type Ty, XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vfmadd231(Type Ty, XmmRegister dst, XmmRegister src1,
+                 const AsmAddress &src2);
+
   void cmpps(Type Ty, XmmRegister dst, XmmRegister src, CmppsCond CmpCondition);
   void cmpps(Type Ty, XmmRegister dst, const AsmAddress &src,
              CmppsCond CmpCondition);
@@ -993,6 +999,26 @@ private:
     assembleAndEmitRex(TyReg, Reg, TyRm, Rm);
   }
 
+  // emitVex3 emits a three-byte VEX prefix for an instruction in the 0F38 map
+  // with a 66 mandatory prefix (e.g. FMA3). Reg and Vvvv are XMM registers,
+  // and the B and X extensions come from either Rm or Addr.
+  template <typename RmType>
+  void emitVex3_66_0F38(const uint8_t W, const XmmRegister Reg,
+                        const XmmRegister Vvvv, const RmType Rm,
+                        const AsmAddress *Addr = nullptr) {
+    const bool R = (Reg & 0x08) != 0;
+    const bool X = (Addr != nullptr) && Addr->rexX() != AsmOperand::RexNone;
+    const bool B = (Addr != nullptr) ? Addr->rexB() != AsmOperand::RexNone
+                                     : (Rm & 0x08) != 0;
+    constexpr uint8_t Map0F38 = 0x02;
+    constexpr uint8_t Prefix66 = 0x01;
+    emitUint8(0xC4);
+    emitUint8((R ? 0x00 : 0x80) | (X ? 0x00 : 0x40) | (B ? 0x00 : 0x20) |
+              Map0F38);
+    emitUint8(((W & 1) << 7) | ((~static_cast<uint8_t>(Vvvv) & 0x0F) << 3) |
+              Prefix66);
+  }
+
   // emitRexB is used for emitting a Rex prefix if one is needed on encoding
   // the Reg field in an x86 instruction. It is invoked by the template when
   // Reg is the single register operand in the instruction (e.g., push Reg.)
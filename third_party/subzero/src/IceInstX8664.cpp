@@ -1070,6 +1070,51 @@ void InstX86Pblendvb::emitIAS(const Cfg *Func) const {
   emitIASVariableBlendInst(this, Func, Emitter);
 }
 
+void InstX86Vfmadd231::emit(const Cfg *Func) const {
+  if (!BuildDefs::dump())
+    return;
+  Ostream &Str = Func->getContext()->getStrEmit();
+  assert(this->getSrcSize() == 3);
+  const Type Ty = this->getDest()->getType();
+  Str << "\t" << this->Opcode << (isVectorType(Ty) ? "ps" : "ss") << "\t";
+  this->getSrc(2)->emit(Func);
+  Str << ", ";
+  this->getSrc(1)->emit(Func);
+  Str << ", ";
+  this->getDest()->emit(Func);
+}
+
+void InstX86Vfmadd231::emitIAS(const Cfg *Func) const {
+  assert(this->getSrcSize() == 3);
+  assert(getInstructionSet(Func) >= AVX2);
+  auto *Target = InstX86Base::getTarget(Func);
+  Assembler *Asm = Func->getAssembler<Assembler>();
+  const Variable *Dest = this->getDest();
+  assert(Dest == this->getSrc(0));
+  assert(Dest->hasReg());
+  const Type Ty = Dest->getType();
+  const XmmRegister DestReg = RegX8664::getEncodedXmm(Dest->getRegNum());
+  const auto *Src1Var = llvm::cast<Variable>(this->getSrc(1));
+  assert(Src1Var->hasReg());
+  const XmmRegister Src1Reg = RegX8664::getEncodedXmm(Src1Var->getRegNum());
+  const Operand *Src2 = this->getSrc(2);
+  if (const auto *Src2Var = llvm::dyn_cast<Variable>(Src2)) {
+    if (Src2Var->hasReg()) {
+      Asm->vfmadd231(Ty, DestReg, Src1Reg,
+                     RegX8664::getEncodedXmm(Src2Var->getRegNum()));
+    } else {
+      Asm->vfmadd231(Ty, DestReg, Src1Reg, AsmAddress(Src2Var, Target));
+    }
+  } else if (const auto *Mem = llvm::dyn_cast<X86OperandMem>(Src2)) {
+    assert(Mem->getSegmentRegister() == X86OperandMem::DefaultSegment);
+    Asm->vfmadd231(Ty, DestReg, Src1Reg, AsmAddress(Mem, Asm, Target));
+  } else if (const auto *Imm = llvm::dyn_cast<Constant>(Src2)) {
+    Asm->vfmadd231(Ty, DestReg, Src1Reg, AsmAddress(Imm, Asm));
+  } else {
+    llvm_unreachable("Unexpected operand type");
+  }
+}
+
 void InstX86Imul::emit(const Cfg *Func) const {
   if (!BuildDefs::dump())
     return;
@@ -242,6 +242,7 @@ public:
     Test,
     Ucomiss,
     UD2,
+    Vfmadd231,
     Xadd,
     Xchg,
     Xor,
@@ -2275,6 +2276,27 @@ private:
   }
 };
 
+/// Fused multiply-add: Dest = Source1 * Source2 + Dest. Selects the packed or
+/// scalar single-precision form based on the type of Dest.
+class InstX86Vfmadd231 : public InstX86BaseTernop<InstX86Base::Vfmadd231> {
+public:
+  static InstX86Vfmadd231 *create(Cfg *Func, Variable *Dest, Operand *Source1,
+                                  Operand *Source2) {
+    assert(getInstructionSet(Func) >= AVX2);
+    return new (Func->allocate<InstX86Vfmadd231>())
+        InstX86Vfmadd231(Func, Dest, Source1, Source2);
+  }
+
+  void emit(const Cfg *Func) const override;
+  void emitIAS(const Cfg *Func) const override;
+
+private:
+  InstX86Vfmadd231(Cfg *Func, Variable *Dest, Operand *Source1,
+                   Operand *Source2)
+      : InstX86BaseTernop<InstX86Base::Vfmadd231>(Func, Dest, Source1,
+                                                  Source2) {}
+};
+
 class InstX86Pextr : public InstX86BaseThreeAddressop<InstX86Base::Pextr> {
 public:
   static InstX86Pextr *create(Cfg *Func, Variable *Dest, Operand *Source0,
@@ -3142,6 +3164,7 @@ struct Insts {
   using Shufps = InstX86Shufps;
   using Blendvps = InstX86Blendvps;
   using Pblendvb = InstX86Pblendvb;
+  using Vfmadd231 = InstX86Vfmadd231;
   using Pextr = InstX86Pextr;
   using Pshufd = InstX86Pshufd;
   using Lockable = InstX86BaseLockable;
@@ -3269,6 +3292,8 @@ template <> constexpr const char *InstX86Shufps::Base::Opcode = "shufps";
 template <> constexpr const char *InstX86Pinsr::Base::Opcode = "pinsr";
 template <> constexpr const char *InstX86Blendvps::Base::Opcode = "blendvps";
 template <> constexpr const char *InstX86Pblendvb::Base::Opcode = "pblendvb";
+template <>
+constexpr const char *InstX86Vfmadd231::Base::Opcode = "vfmadd231";
 /* Three address ops */
 template <> constexpr const char *InstX86Pextr::Base::Opcode = "pextr";
 template <> constexpr const char *InstX86Pshufd::Base::Opcode = "pshufd";
@@ -57,6 +57,7 @@ enum IntrinsicID {
   // The intrinsics below are not part of the PNaCl specification.
   AddSaturateSigned,
   AddSaturateUnsigned,
+  FusedMultiplyAdd,
   LoadSubVector,
   MultiplyAddPairs,
   MultiplyHighSigned,
@@ -29,6 +29,8 @@ enum InstructionSetX86 {
   // SSE2 is the baseline instruction set.
   SSE2 = Begin,
   SSE4_1,
+  // AVX2 also implies FMA3 support.
+  AVX2,
   End
 };
 
@@ -3807,6 +3807,41 @@ void TargetX8664::lowerIntrinsic(const InstIntrinsic *Instr) {
     }
     return;
   }
+  case Intrinsics::FusedMultiplyAdd: {
+    // Dest = Src0 * Src1 + Src2
+    Variable *Dest = Instr->getDest();
+    const Type Ty = Dest->getType();
+    assert(Ty == IceType_v4f32 || Ty == IceType_f32);
+    Variable *Src0 = legalizeToReg(Instr->getArg(0));
+    Operand *Src1 = legalize(Instr->getArg(1), Legal_Reg | Legal_Mem);
+    Operand *Src2 = legalize(Instr->getArg(2), Legal_Reg | Legal_Mem);
+    auto *T = makeReg(Ty);
+    if (InstructionSet >= AVX2) {
+      if (isVectorType(Ty)) {
+        _movp(T, Src2);
+      } else {
+        _mov(T, Src2);
+      }
+      _vfmadd231(T, Src0, Src1);
+    } else {
+      // Without FMA3 support, fall back to an unfused multiply and add.
+      if (isVectorType(Ty)) {
+        _movp(T, Src0);
+        _mulps(T, Src1);
+        _addps(T, Src2);
+      } else {
+        _mov(T, Src0);
+        _mulss(T, Src1);
+        _addss(T, Src2);
+      }
+    }
+    if (isVectorType(Ty)) {
+      _movp(Dest, T);
+    } else {
+      _mov(Dest, T);
+    }
+    return;
+  }
   case Intrinsics::Round: {
     assert(InstructionSet >= SSE4_1);
     Variable *Dest = Instr->getDest();
@@ -547,6 +547,9 @@ protected:
   void _imul_imm(Variable *Dest, Operand *Src0, Constant *Imm) {
     Context.insert<Insts::ImulImm>(Dest, Src0, Imm);
   }
+  void _vfmadd231(Variable *Dest, Variable *Src0, Operand *Src1) {
+    Context.insert<Insts::Vfmadd231>(Dest, Src0, Src1);
+  }
   void _insertps(Variable *Dest, Operand *Src0, Operand *Src1) {
     Context.insert<Insts::Insertps>(Dest, Src0, Src1);
   }
@@ -67,6 +67,7 @@ enum TargetInstructionSet {
   X86InstructionSet_Begin,
   X86InstructionSet_SSE2 = X86InstructionSet_Begin,
   X86InstructionSet_SSE4_1,
+  X86InstructionSet_AVX2,
   X86InstructionSet_End,
   ARM32InstructionSet_Begin,
   ARM32InstructionSet_Neon = ARM32InstructionSet_Begin,